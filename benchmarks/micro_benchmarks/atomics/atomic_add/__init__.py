@@ -0,0 +1 @@
+from .atomic_add import benchmark  # type: ignore # noqa: F401
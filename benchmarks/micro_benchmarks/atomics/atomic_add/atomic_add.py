@@ -0,0 +1,60 @@
+import os
+
+import torch
+import triton
+import triton.language as tl
+
+from roofline import dram_bandwidth, peak
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def atomic_add_kernel(x_ptr, out_ptr, n_elements, n_targets, BLOCK_SIZE: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    offsets = pid * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    x = tl.load(x_ptr + offsets, mask=mask)
+    tl.atomic_add(out_ptr + offsets % n_targets, x, mask=mask, sem='relaxed')
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['n_targets'],
+        x_vals=[1, 16, 1024, 2**20, 2**24],
+        line_arg='provider',
+        line_vals=['float32', 'int32', 'roofline'],
+        line_names=['FP32', 'INT32', 'Roofline'],
+        styles=[('blue', '-'), ('green', '-'), ('black', '--')],
+        ylabel='Gatomics/s',
+        plot_name='atomic-add',
+        args={},
+    ))
+def benchmark(n_targets, provider):
+    """Throughput of relaxed atomic adds of 2**24 values spread over n_targets addresses."""
+    if provider == 'roofline':
+        # Each atomic reads and writes its 4-byte target.
+        return peak(dram_bandwidth() / 8)
+
+    n_elements = 2**24
+    quantiles = [0.5, 0.2, 0.8]
+    if provider == 'float32':
+        x = torch.rand(n_elements, dtype=torch.float32, device='xpu')
+    elif provider == 'int32':
+        x = torch.randint(0, 16, (n_elements, ), dtype=torch.int32, device='xpu')
+    else:
+        raise NotImplementedError(f'Provider {provider} is not supported')
+    out = torch.zeros(n_targets, dtype=x.dtype, device='xpu')
+    grid = lambda meta: (triton.cdiv(n_elements, meta['BLOCK_SIZE']), )
+
+    fwd = lambda: atomic_add_kernel[grid](x, out, n_elements, n_targets, BLOCK_SIZE=1024)
+
+    ms, min_ms, max_ms = triton.testing.do_bench(fwd, quantiles=quantiles)
+    gatomics = lambda ms: (n_elements * 1e-9) / (ms * 1e-3)
+
+    return gatomics(ms), gatomics(max_ms), gatomics(min_ms)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
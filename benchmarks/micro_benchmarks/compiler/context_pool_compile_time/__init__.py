@@ -0,0 +1 @@
+from .context_pool_compile_time import benchmark  # type: ignore # noqa: F401
@@ -0,0 +1,68 @@
+import os
+import time
+
+import torch
+import triton
+import triton.language as tl
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def add_kernel(X, Y, Out, n_elements, BLOCK_SIZE: tl.constexpr):
+    # A small kernel, whose compile time is dominated by the setup of the
+    # compilation rather than by its passes.
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    tl.store(Out + offsets, tl.load(X + offsets, mask=mask) + tl.load(Y + offsets, mask=mask), mask=mask)
+
+
+def compile_time_ms(kernel, args, n_repeat, **kwargs):
+    # Compile from scratch each time, the on-disk cache is bypassed.
+    times = []
+    for _ in range(n_repeat):
+        kernel.cache.clear()
+        start = time.perf_counter()
+        kernel.warmup(*args, grid=(1, ), **kwargs)
+        times.append((time.perf_counter() - start) * 1e3)
+    times.sort()
+    return times[len(times) // 2], times[0], times[-1]
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['BLOCK_SIZE'],
+        x_vals=[256, 1024],
+        line_arg='provider',
+        line_vals=['pooled', 'unpooled'],
+        line_names=['Context pool', 'No context pool'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel='ms',
+        plot_name='context-pool-compile-time',
+        args={},
+    ))
+def benchmark(BLOCK_SIZE, provider):
+    """Compile time of a small kernel with and without reusing the MLIR contexts of the previous compilations."""
+    if provider not in ('pooled', 'unpooled'):
+        raise NotImplementedError(f'Provider {provider} is not supported')
+
+    n_elements = 1 << 16
+    x, y, out = (torch.empty(n_elements, dtype=torch.float32, device='xpu') for _ in range(3))
+    args = (x, y, out, n_elements)
+
+    saved_env = {name: os.environ.get(name) for name in ('TRITON_ALWAYS_COMPILE', 'TRITON_CONTEXT_POOL')}
+    os.environ['TRITON_ALWAYS_COMPILE'] = '1'
+    os.environ['TRITON_CONTEXT_POOL'] = '1' if provider == 'pooled' else '0'
+    try:
+        return compile_time_ms(add_kernel, args, n_repeat=20, BLOCK_SIZE=BLOCK_SIZE)
+    finally:
+        for name, value in saved_env.items():
+            if value is None:
+                os.environ.pop(name)
+            else:
+                os.environ[name] = value
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1 @@
+from .layout_compile_time import benchmark  # type: ignore # noqa: F401
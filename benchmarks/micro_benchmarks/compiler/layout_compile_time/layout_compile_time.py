@@ -0,0 +1,89 @@
+import os
+import time
+
+import torch
+import triton
+import triton.language as tl
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def attention_kernel(Q, K, V, Out, sm_scale, N_CTX, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr,
+                     HEAD_DIM: tl.constexpr):
+    # The dots, the softmax reductions and their broadcasts convert between the
+    # DPAS, dot operand and blocked layouts in each iteration.
+    start_m = tl.program_id(0)
+    off_hz = tl.program_id(1)
+    offset = off_hz * N_CTX * HEAD_DIM
+    offs_m = start_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    offs_d = tl.arange(0, HEAD_DIM)
+    q = tl.load(Q + offset + offs_m[:, None] * HEAD_DIM + offs_d[None, :])
+    m_i = tl.zeros([BLOCK_M], dtype=tl.float32) - float('inf')
+    l_i = tl.zeros([BLOCK_M], dtype=tl.float32) + 1.0
+    acc = tl.zeros([BLOCK_M, HEAD_DIM], dtype=tl.float32)
+    for start_n in range(0, N_CTX, BLOCK_N):
+        k = tl.load(K + offset + (start_n + offs_n)[None, :] * HEAD_DIM + offs_d[:, None])
+        qk = tl.dot(q, k) * sm_scale
+        m_ij = tl.maximum(m_i, tl.max(qk, 1))
+        p = tl.math.exp2(qk - m_ij[:, None])
+        alpha = tl.math.exp2(m_i - m_ij)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        v = tl.load(V + offset + (start_n + offs_n)[:, None] * HEAD_DIM + offs_d[None, :])
+        acc = acc * alpha[:, None] + tl.dot(p.to(tl.float16), v)
+        m_i = m_ij
+    acc = acc / l_i[:, None]
+    tl.store(Out + offset + offs_m[:, None] * HEAD_DIM + offs_d[None, :], acc.to(Out.type.element_ty))
+
+
+def compile_time_ms(kernel, args, n_repeat, **kwargs):
+    # Compile from scratch each time, the on-disk cache is bypassed.
+    times = []
+    for _ in range(n_repeat):
+        kernel.cache.clear()
+        start = time.perf_counter()
+        kernel.warmup(*args, grid=(1, ), **kwargs)
+        times.append((time.perf_counter() - start) * 1e3)
+    times.sort()
+    return times[len(times) // 2], times[0], times[-1]
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['HEAD_DIM'],
+        x_vals=[64, 128],
+        line_arg='provider',
+        line_vals=['cached', 'uncached'],
+        line_names=['Layout cache', 'No layout cache'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel='ms',
+        plot_name='layout-compile-time',
+        args={},
+    ))
+def benchmark(HEAD_DIM, provider):
+    """Compile time of an attention kernel with and without the cache of the linear layouts."""
+    if provider not in ('cached', 'uncached'):
+        raise NotImplementedError(f'Provider {provider} is not supported')
+
+    N_CTX = 1024
+    q, k, v, out = (torch.empty((1, N_CTX, HEAD_DIM), dtype=torch.float16, device='xpu') for _ in range(4))
+    args = (q, k, v, out, 0.5, N_CTX)
+
+    saved_env = {name: os.environ.get(name) for name in ('TRITON_ALWAYS_COMPILE', 'TRITON_DISABLE_LINEAR_LAYOUT_CACHE')}
+    os.environ['TRITON_ALWAYS_COMPILE'] = '1'
+    os.environ['TRITON_DISABLE_LINEAR_LAYOUT_CACHE'] = '1' if provider == 'uncached' else '0'
+    try:
+        return compile_time_ms(attention_kernel, args, n_repeat=5, BLOCK_M=128, BLOCK_N=64, HEAD_DIM=HEAD_DIM,
+                               num_warps=8)
+    finally:
+        for name, value in saved_env.items():
+            if value is None:
+                os.environ.pop(name)
+            else:
+                os.environ[name] = value
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
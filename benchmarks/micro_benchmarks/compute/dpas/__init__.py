@@ -0,0 +1 @@
+from .dpas import benchmark  # type: ignore # noqa: F401
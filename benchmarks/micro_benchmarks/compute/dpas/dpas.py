@@ -0,0 +1,75 @@
+import os
+
+import torch
+import triton
+import triton.language as tl
+
+from roofline import device_properties, dpas_ops, peak
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def dpas_kernel(a_ptr, b_ptr, c_ptr, n_iters, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+                INPUT_PRECISION: tl.constexpr, ACC_TYPE: tl.constexpr):
+    # The operands stay in registers, the dots only depend on the previous
+    # accumulator.
+    pid = tl.program_id(axis=0)
+    offs_m = tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    offs_k = tl.arange(0, BLOCK_K)
+    a = tl.load(a_ptr + offs_m[:, None] * BLOCK_K + offs_k[None, :])
+    b = tl.load(b_ptr + offs_k[:, None] * BLOCK_N + offs_n[None, :])
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=ACC_TYPE)
+    for _ in range(n_iters):
+        acc = tl.dot(a, b, acc, input_precision=INPUT_PRECISION, out_dtype=ACC_TYPE)
+    tl.store(c_ptr + pid * BLOCK_M * BLOCK_N + offs_m[:, None] * BLOCK_N + offs_n[None, :], acc)
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['dtype'],
+        x_vals=['float16', 'bfloat16', 'int8', 'tf32'],
+        line_arg='provider',
+        line_vals=['triton', 'roofline'],
+        line_names=['Triton', 'Roofline'],
+        styles=[('blue', '-'), ('black', '--')],
+        ylabel='TFlops',
+        plot_name='dpas-throughput',
+        args={},
+    ))
+def benchmark(dtype, provider):
+    """Throughput of back to back DPAS instructions on operands of each type (TOPS for int8)."""
+    if provider == 'roofline':
+        return peak(dpas_ops(dtype))
+
+    BLOCK_M, BLOCK_N, BLOCK_K = 128, 128, 32
+    n_iters = 1024
+    quantiles = [0.5, 0.2, 0.8]
+    torch_dtype = torch.float32 if dtype == 'tf32' else getattr(torch, dtype)
+    if torch_dtype.is_floating_point:
+        a = torch.rand((BLOCK_M, BLOCK_K), dtype=torch_dtype, device='xpu')
+        b = torch.rand((BLOCK_K, BLOCK_N), dtype=torch_dtype, device='xpu')
+        acc_type = tl.float32
+    else:
+        a = torch.randint(-4, 4, (BLOCK_M, BLOCK_K), dtype=torch_dtype, device='xpu')
+        b = torch.randint(-4, 4, (BLOCK_K, BLOCK_N), dtype=torch_dtype, device='xpu')
+        acc_type = tl.int32
+    # Enough work-groups to keep all the Xe-cores busy for several waves.
+    num_programs = device_properties()['multiprocessor_count'] * 8
+    c = torch.empty((num_programs, BLOCK_M, BLOCK_N), dtype=torch.float32 if acc_type == tl.float32 else torch.int32,
+                    device='xpu')
+    input_precision = 'tf32' if dtype == 'tf32' else 'ieee'
+
+    fwd = lambda: dpas_kernel[(num_programs, )](a, b, c, n_iters, BLOCK_M, BLOCK_N, BLOCK_K, input_precision, acc_type,
+                                                num_warps=32)
+
+    ms, min_ms, max_ms = triton.testing.do_bench(fwd, quantiles=quantiles)
+    tflops = lambda ms: (2 * BLOCK_M * BLOCK_N * BLOCK_K * n_iters * num_programs * 1e-12) / (ms * 1e-3)
+
+    return tflops(ms), tflops(max_ms), tflops(min_ms)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1 @@
+from .launch_latency import benchmark  # type: ignore # noqa: F401
@@ -0,0 +1,69 @@
+import os
+import time
+
+import torch
+import triton
+import triton.language as tl
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def nop_kernel(x_ptr, y_ptr, z_ptr, n_elements, BLOCK_SIZE: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    offsets = pid * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    x = tl.load(x_ptr + offsets, mask=mask)
+    y = tl.load(y_ptr + offsets, mask=mask)
+    tl.store(z_ptr + offsets, x + y, mask=mask)
+
+
+def host_latency_us(fn, n_repeat):
+    # Warm up, then measure the host time spent submitting the launches only.
+    for _ in range(10):
+        fn()
+    torch.xpu.synchronize()
+    start = time.perf_counter()
+    for _ in range(n_repeat):
+        fn()
+    end = time.perf_counter()
+    torch.xpu.synchronize()
+    return (end - start) * 1e6 / n_repeat
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['n_repeat'],
+        x_vals=[1000, 10000],
+        line_arg='provider',
+        line_vals=['jit', 'launcher', 'packed'],
+        line_names=['JITFunction', 'Launcher', 'Packed launcher'],
+        styles=[('blue', '-'), ('green', '-'), ('orange', '-')],
+        ylabel='us',
+        plot_name='launch-latency',
+        args={},
+    ))
+def benchmark(n_repeat, provider):
+    n_elements = 128
+    x, y, z = (torch.rand(n_elements, dtype=torch.float32, device='xpu') for _ in range(3))
+    grid = (1, 1, 1)
+    kernel = nop_kernel[grid](x, y, z, n_elements, BLOCK_SIZE=n_elements)
+    stream = triton.runtime.driver.active.get_current_stream(x.device.index)
+    args = (x, y, z, n_elements)
+
+    if provider == 'jit':
+        fn = lambda: nop_kernel[grid](*args, BLOCK_SIZE=n_elements)
+    elif provider == 'launcher':
+        fn = lambda: kernel.run(*grid, stream, kernel.function, kernel.packed_metadata, None, None, None, *args)
+    elif provider == 'packed':
+        packed = kernel.run.pack_args(*args)
+        fn = lambda: kernel.run.launch_packed(*grid, stream, kernel.function, kernel.packed_metadata, packed)
+    else:
+        raise NotImplementedError(f'Provider {provider} is not supported')
+
+    return host_latency_us(fn, n_repeat)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1 @@
+from .convert_layout import benchmark  # type: ignore # noqa: F401
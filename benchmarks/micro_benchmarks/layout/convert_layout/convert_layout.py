@@ -0,0 +1,68 @@
+import os
+
+import torch
+import triton
+import triton.language as tl
+
+from roofline import dram_bandwidth, peak, slm_bandwidth
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def copy_kernel(x_ptr, y_ptr, N, BLOCK: tl.constexpr, TRANSPOSE: tl.constexpr):
+    # Storing the transpose of the tile makes the layouts of the load and the
+    # store differ, the values are exchanged through the SLM.
+    pid_m = tl.program_id(axis=0)
+    pid_n = tl.program_id(axis=1)
+    offs_m = pid_m * BLOCK + tl.arange(0, BLOCK)
+    offs_n = pid_n * BLOCK + tl.arange(0, BLOCK)
+    x = tl.load(x_ptr + offs_m[:, None] * N + offs_n[None, :])
+    if TRANSPOSE:
+        tl.store(y_ptr + offs_n[None, :] * N + offs_m[:, None], x)
+    else:
+        tl.store(y_ptr + offs_m[:, None] * N + offs_n[None, :], x)
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['BLOCK'],
+        x_vals=[16, 32, 64, 128],
+        line_arg='provider',
+        line_vals=['copy', 'transpose', 'roofline', 'slm-roofline'],
+        line_names=['Copy', 'Transpose', 'Roofline', 'SLM roofline'],
+        styles=[('blue', '-'), ('green', '-'), ('black', '--'), ('grey', '--')],
+        ylabel='GB/s',
+        plot_name='convert-layout',
+        args={},
+    ))
+def benchmark(BLOCK, provider):
+    """
+    Bandwidth of a float32 copy with and without a transpose of the tiles: the
+    gap between the two is the cost of the layout conversion through the SLM.
+    """
+    if provider == 'roofline':
+        return peak(dram_bandwidth())
+    if provider == 'slm-roofline':
+        # The conversion writes and reads each tile once.
+        return peak(slm_bandwidth() / 2)
+
+    N = 8192
+    quantiles = [0.5, 0.2, 0.8]
+    x = torch.rand((N, N), dtype=torch.float32, device='xpu')
+    y = torch.empty_like(x)
+    grid = (N // BLOCK, N // BLOCK)
+
+    if provider not in ('copy', 'transpose'):
+        raise NotImplementedError(f'Provider {provider} is not supported')
+    fwd = lambda: copy_kernel[grid](x, y, N, BLOCK, provider == 'transpose')
+
+    ms, min_ms, max_ms = triton.testing.do_bench(fwd, quantiles=quantiles)
+    gbps = lambda ms: (2 * x.numel() * x.element_size() * 1e-9) / (ms * 1e-3)
+
+    return gbps(ms), gbps(max_ms), gbps(min_ms)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1 @@
+from .block_io import benchmark  # type: ignore # noqa: F401
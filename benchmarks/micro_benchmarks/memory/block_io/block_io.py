@@ -0,0 +1,80 @@
+import os
+
+import torch
+import triton
+import triton.language as tl
+
+from roofline import dram_bandwidth, peak
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def block_load_kernel(a_ptr, out_ptr, M, K, BLOCK_M: tl.constexpr, BLOCK_K: tl.constexpr):
+    # A streams through the 2D block loads of a DPAS operand, which are
+    # prefetched ahead of their use by the pipeliner when num_stages > 1.
+    pid = tl.program_id(axis=0)
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(K, 1), offsets=(pid * BLOCK_M, 0),
+                                    block_shape=(BLOCK_M, BLOCK_K), order=(1, 0))
+    ones = tl.full((BLOCK_K, 16), 1, dtype=tl.bfloat16)
+    acc = tl.zeros((BLOCK_M, 16), dtype=tl.float32)
+    for _ in range(0, K, BLOCK_K):
+        acc = tl.dot(tl.load(a_block_ptr), ones, acc)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K))
+    out_block_ptr = tl.make_block_ptr(base=out_ptr, shape=(M, 16), strides=(16, 1), offsets=(pid * BLOCK_M, 0),
+                                      block_shape=(BLOCK_M, 16), order=(1, 0))
+    tl.store(out_block_ptr, acc)
+
+
+@triton.jit
+def block_store_kernel(a_ptr, M, K, BLOCK_M: tl.constexpr, BLOCK_K: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(K, 1), offsets=(pid * BLOCK_M, 0),
+                                    block_shape=(BLOCK_M, BLOCK_K), order=(1, 0))
+    tile = tl.full((BLOCK_M, BLOCK_K), 1, dtype=tl.bfloat16)
+    for _ in range(0, K, BLOCK_K):
+        tl.store(a_block_ptr, tile)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K))
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['BLOCK_M', 'BLOCK_K'],
+        x_vals=[(8, 32), (16, 32), (32, 32), (32, 64), (64, 32), (128, 32)],
+        line_arg='provider',
+        line_vals=['load', 'prefetch', 'store', 'roofline'],
+        line_names=['Load', 'Load+Prefetch', 'Store', 'Roofline'],
+        styles=[('blue', '-'), ('green', '-'), ('orange', '-'), ('black', '--')],
+        ylabel='GB/s',
+        plot_name='block-io',
+        args={},
+    ))
+def benchmark(BLOCK_M, BLOCK_K, provider):
+    """Bandwidth of the 2D block loads, prefetches and stores of bf16 tiles of each shape."""
+    if provider == 'roofline':
+        return peak(dram_bandwidth())
+
+    M, K = 8192, 8192
+    quantiles = [0.5, 0.2, 0.8]
+    a = torch.rand((M, K), dtype=torch.bfloat16, device='xpu')
+    out = torch.empty((M, 16), dtype=torch.float32, device='xpu')
+    grid = (M // BLOCK_M, )
+
+    if provider == 'load':
+        fwd = lambda: block_load_kernel[grid](a, out, M, K, BLOCK_M, BLOCK_K, num_stages=1)
+    elif provider == 'prefetch':
+        fwd = lambda: block_load_kernel[grid](a, out, M, K, BLOCK_M, BLOCK_K, num_stages=3)
+    elif provider == 'store':
+        fwd = lambda: block_store_kernel[grid](a, M, K, BLOCK_M, BLOCK_K)
+    else:
+        raise NotImplementedError(f'Provider {provider} is not supported')
+
+    ms, min_ms, max_ms = triton.testing.do_bench(fwd, quantiles=quantiles)
+    gbps = lambda ms: (a.numel() * a.element_size() * 1e-9) / (ms * 1e-3)
+
+    return gbps(ms), gbps(max_ms), gbps(min_ms)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1 @@
+from .subgroup import benchmark  # type: ignore # noqa: F401
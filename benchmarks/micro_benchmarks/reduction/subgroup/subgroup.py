@@ -0,0 +1,63 @@
+import os
+
+import torch
+import triton
+import triton.language as tl
+
+from roofline import dram_bandwidth, peak
+
+if os.getenv('USE_IPEX', '1') == '1':
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def reduce_kernel(x_ptr, out_ptr, BLOCK_M: tl.constexpr, N: tl.constexpr, OP: tl.constexpr):
+    # Rows of N <= 32 elements are reduced across the work-items of a sub-group.
+    pid = tl.program_id(axis=0)
+    offs_m = pid * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, N)
+    x = tl.load(x_ptr + offs_m[:, None] * N + offs_n[None, :])
+    if OP == 'sum':
+        tl.store(out_ptr + offs_m, tl.sum(x, axis=1))
+    elif OP == 'max':
+        tl.store(out_ptr + offs_m, tl.max(x, axis=1))
+    else:
+        tl.store(out_ptr + offs_m[:, None] * N + offs_n[None, :], tl.cumsum(x, axis=1))
+
+
+@triton.testing.perf_report(
+    triton.testing.Benchmark(
+        x_names=['N'],
+        x_vals=[8, 16, 32, 64, 128],
+        line_arg='provider',
+        line_vals=['sum', 'max', 'cumsum', 'roofline'],
+        line_names=['Sum', 'Max', 'Cumsum', 'Roofline'],
+        styles=[('blue', '-'), ('green', '-'), ('orange', '-'), ('black', '--')],
+        ylabel='GB/s',
+        plot_name='subgroup-reduce-scan',
+        args={},
+    ))
+def benchmark(N, provider):
+    """Bandwidth of the reductions and scans of float32 rows of N elements."""
+    if provider == 'roofline':
+        return peak(dram_bandwidth())
+
+    M = 2**26 // N
+    BLOCK_M = 2048 // N
+    quantiles = [0.5, 0.2, 0.8]
+    x = torch.rand((M, N), dtype=torch.float32, device='xpu')
+    out = torch.empty_like(x) if provider == 'cumsum' else torch.empty(M, dtype=torch.float32, device='xpu')
+    grid = (M // BLOCK_M, )
+
+    if provider not in ('sum', 'max', 'cumsum'):
+        raise NotImplementedError(f'Provider {provider} is not supported')
+    fwd = lambda: reduce_kernel[grid](x, out, BLOCK_M, N, provider)
+
+    ms, min_ms, max_ms = triton.testing.do_bench(fwd, quantiles=quantiles)
+    gbps = lambda ms: ((x.numel() + out.numel()) * x.element_size() * 1e-9) / (ms * 1e-3)
+
+    return gbps(ms), gbps(max_ms), gbps(min_ms)
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
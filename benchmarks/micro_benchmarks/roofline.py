@@ -0,0 +1,69 @@
+"""
+Peak throughputs of the current XPU device, derived from the device properties
+reported by the driver, that the micro-benchmarks report as their `roofline`
+line. They are upper bounds from the clocks and widths of the hardware units,
+so a regression of a primitive shows up as a drop of its fraction of the peak.
+"""
+
+import functools
+
+import torch
+
+# Bytes transferred per clock by the shared local memory of an Xe-core.
+SLM_BYTES_PER_CLOCK = 128
+# FP32 multiply-adds per clock of an EU.
+FP32_MACS_PER_CLOCK = 16
+# The systolic depth of DPAS instructions.
+DPAS_SYSTOLIC_DEPTH = 8
+
+
+@functools.lru_cache
+def device_properties():
+    from triton.runtime import driver
+    props = dict(driver.active.utils.get_device_properties(torch.xpu.current_device()))
+    arch = driver.active.get_current_target().arch
+    props['dpas_execution_size'] = 8 if min(props['sub_group_sizes']) == 8 else 16
+    props['has_dpas'] = arch.get('has_subgroup_matrix_multiply_accumulate', False)
+    props['has_tf32_dpas'] = arch.get('has_subgroup_matrix_multiply_accumulate_tensor_float32', False)
+    return props
+
+
+def _clock_hz(props):
+    return props['sm_clock_rate'] * 1e6
+
+
+def _num_eus(props):
+    return props['multiprocessor_count'] * props['num_eus_per_xe_core']
+
+
+def dram_bandwidth():
+    """Peak DRAM bandwidth, in GB/s."""
+    props = device_properties()
+    return props['mem_clock_rate'] * 1e6 * props['mem_bus_width'] / 8 * 2 * 1e-9
+
+
+def slm_bandwidth():
+    """Peak bandwidth of the shared local memory of all the Xe-cores, in GB/s."""
+    props = device_properties()
+    return props['multiprocessor_count'] * SLM_BYTES_PER_CLOCK * _clock_hz(props) * 1e-9
+
+
+def fp32_ops():
+    """Peak FP32 throughput of the EUs (without DPAS), in TFLOPS."""
+    props = device_properties()
+    return 2 * _num_eus(props) * FP32_MACS_PER_CLOCK * _clock_hz(props) * 1e-12
+
+
+def dpas_ops(dtype):
+    """Peak DPAS throughput for operands of `dtype` (or 'tf32'), in TFLOPS (TOPS for integers)."""
+    props = device_properties()
+    ops_per_channel = {'float16': 2, 'bfloat16': 2, 'int8': 4, 'tf32': 1}[dtype]
+    if not props['has_dpas'] or (dtype == 'tf32' and not props['has_tf32_dpas']):
+        return fp32_ops()
+    macs_per_clock = DPAS_SYSTOLIC_DEPTH * props['dpas_execution_size'] * ops_per_channel
+    return 2 * _num_eus(props) * macs_per_clock * _clock_hz(props) * 1e-12
+
+
+def peak(value):
+    """Return `value` as a benchmark result, for the `roofline` line."""
+    return value, value, value
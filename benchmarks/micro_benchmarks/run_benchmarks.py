@@ -1,6 +1,13 @@
 import argparse
 
+from atomics import atomic_add
+from compiler import context_pool_compile_time, layout_compile_time
+from compute import dpas
 from conversion import float_conversion
+from launch import launch_latency
+from layout import convert_layout
+from memory import block_io
+from reduction import subgroup
 
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
@@ -11,4 +18,6 @@ if __name__ == '__main__':
         help='directory to save reports',
     )
     args = parser.parse_args()
-    float_conversion.benchmark.run(print_data=True, save_path=args.reports)
+    for module in (float_conversion, launch_latency, block_io, dpas, subgroup, convert_layout, atomic_add,
+                   layout_compile_time, context_pool_compile_time):
+        module.benchmark.run(print_data=True, save_path=args.reports)
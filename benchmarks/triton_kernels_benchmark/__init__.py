@@ -1,4 +1,4 @@
-from .benchmark_testing import do_bench, assert_close, perf_report, Benchmark, USE_IPEX_OPTION  # type: ignore # noqa: F401
+from .benchmark_testing import do_bench, assert_close, perf_report, Benchmark, ResultStore, bootstrap_ratio, BACKEND, DEVICE, USE_IPEX_OPTION, USE_PROTON_OPTION, pop_kernel_stats, pop_bench_times  # type: ignore # noqa: F401
 
 if USE_IPEX_OPTION:
     from triton.runtime import driver
@@ -1,21 +1,52 @@
 import argparse
 import itertools
+import json
 import os
-from typing import Any, Dict, List
+import subprocess
+import tempfile
+from typing import Any, Dict, List, Optional
 
-USE_IPEX_OPTION = os.getenv("USE_IPEX", "1") == "1"
 
+def _get_backend():
+    from triton.runtime import driver
+    return driver.active.get_current_target().backend
 
-def synchronize():
+
+# The backend of the active driver: "xpu", "cuda" or "hip", and the PyTorch
+# device type of its tensors, which is "cuda" for HIP too.
+BACKEND = _get_backend()
+DEVICE = "xpu" if BACKEND == "xpu" else "cuda"
+
+USE_IPEX_OPTION = BACKEND == "xpu" and os.getenv("USE_IPEX", "1") == "1"
+USE_PROTON_OPTION = os.getenv("USE_PROTON", "0") == "1"
+
+
+def _device_module(device):
     import torch
-    if torch.cuda.is_available():
-        torch.cuda.synchronize()
-    elif torch.xpu.is_available():
-        torch.xpu.synchronize()
+    return getattr(torch, device)
+
+
+def synchronize():
+    _device_module(DEVICE).synchronize()
+
+
+# The times (in ms) summarized by the `do_bench` calls since the last
+# `pop_bench_times` call.
+_bench_times = []
+
+
+def pop_bench_times():
+    """
+    Returns the times (in ms) of the iterations measured by each `do_bench` call since the last call.
+    """
+    global _bench_times
+    times, _bench_times = _bench_times, []
+    return times
 
 
 def _summarize_statistics(times, quantiles, return_mode):
     import torch
+    _bench_times.append(times.tolist())
     if quantiles is not None:
         ret = torch.quantile(times, torch.tensor(quantiles, dtype=torch.float)).tolist()
         if times.numel() > 2:
@@ -123,7 +154,7 @@ def do_bench_ipex(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fas
 
 
 def do_bench_no_ipex(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean",
-                     device="xpu"):
+                     device=DEVICE):
     """
     Benchmark the runtime of the provided function. By default, return the median runtime of :code:`fn` along with
     the 20-th and 80-th performance percentile.
@@ -151,9 +182,136 @@ def do_bench_no_ipex(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None,
     return _summarize_statistics(times, quantiles, return_mode)
 
 
+_PROTON_ITERATION_SCOPE = "__profile_iteration_"
+_FLOPS_METRICS = ["flops", "flops8", "flops16", "flops32", "flops64"]
+
+# Per-kernel statistics of the `do_bench_proton` calls since the last
+# `pop_kernel_stats` call, by kernel name.
+_kernel_stats = {}
+
+
+def _collect_kernel_stats(node, stats, work=None):
+    metrics = node["metrics"]
+    # The Triton hook of Proton attaches the work reported by the `launch_metadata` of a kernel to the scope enclosing
+    # its launch.
+    flops = sum(metrics.get(name, 0) for name in _FLOPS_METRICS)
+    if flops or "bytes" in metrics:
+        work = (flops, metrics.get("bytes", 0))
+    if "Time (ns)" in metrics:
+        kernel = stats.setdefault(node["frame"]["name"], {"calls": 0, "time_ns": 0, "flops": 0, "bytes": 0})
+        kernel["calls"] += metrics.get("Count", 0)
+        kernel["time_ns"] += metrics["Time (ns)"]
+        if work is not None:
+            kernel["flops"] += work[0]
+            kernel["bytes"] += work[1]
+    for child in node["children"]:
+        _collect_kernel_stats(child, stats, work)
+
+
+def pop_kernel_stats():
+    """
+    Returns the per-kernel statistics recorded by the `do_bench_proton` calls since the last call.
+
+    Maps each kernel name to its number of calls, device time (in ms), and the flops and bytes reported by its
+    `launch_metadata`, per iteration of the benchmarked function.
+    """
+    global _kernel_stats
+    stats, _kernel_stats = _kernel_stats, {}
+    return stats
+
+
+def do_bench_proton(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean",
+                    device=DEVICE):
+    """
+    Benchmark the runtime of the provided function with Proton. By default, return the median runtime of :code:`fn`
+    along with the 20-th and 80-th performance percentile.
+
+    The device time of every kernel launched by :code:`fn`, Triton or not (e.g. XeTLA), is read from the Level Zero,
+    CUPTI or roctracer timestamps recorded by Proton, so no profiler events have to be matched by name. The per-kernel
+    statistics are available from :code:`pop_kernel_stats`.
+
+    :param fn: Function to benchmark
+    :type fn: Callable
+    :param warmup: Warmup time (in ms)
+    :type warmup: int
+    :param rep: Repetition time (in ms)
+    :type rep: int
+    :param grad_to_none: Reset the gradient of the provided tensor to None
+    :type grad_to_none: torch.tensor, optional
+    :param quantiles: Performance percentile to return in addition to the median.
+    :type quantiles: list[float]
+    :param fast_flush: Use faster kernel to flush L2 between measurements
+    :type fast_flush: bool
+    """
+    assert return_mode in ["min", "max", "mean", "median"]
+    import torch
+    import triton.profiler as proton
+
+    fn()
+    synchronize()
+
+    cache_size = 256 * 1024 * 1024
+    if fast_flush:
+        cache = torch.empty(int(cache_size // 4), dtype=torch.int, device=device)
+    else:
+        cache = torch.empty(int(cache_size), dtype=torch.int8, device=device)
+
+    # Estimate the runtime of the function
+    start_event = _device_module(device).Event(enable_timing=True)
+    end_event = _device_module(device).Event(enable_timing=True)
+    start_event.record()
+    for _ in range(5):
+        cache.zero_()
+        fn()
+    end_event.record()
+    synchronize()
+    estimate_ms = start_event.elapsed_time(end_event) / 5
+
+    n_warmup = max(1, int(warmup / estimate_ms))
+    n_repeat = max(1, int(rep / estimate_ms))
+    for _ in range(n_warmup):
+        fn()
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        name = os.path.join(tmpdir, "bench")
+        session = proton.start(name, hook="triton")
+        for i in range(n_repeat):
+            if grad_to_none is not None:
+                for x in grad_to_none:
+                    x.grad = None
+            # The kernel clearing the L2 cache is launched outside of the
+            # iteration scopes, so that its time is not counted.
+            cache.zero_()
+            with proton.scope(f"{_PROTON_ITERATION_SCOPE}{i}"):
+                fn()
+        synchronize()
+        proton.finalize(session, "hatchet")
+        with open(f"{name}.hatchet", encoding="utf-8") as f:
+            root = json.load(f)[0]
+
+    iterations = [node for node in root["children"] if node["frame"]["name"].startswith(_PROTON_ITERATION_SCOPE)]
+    assert len(iterations) == n_repeat, "the profiling number not match"
+    times = []
+    for iteration in iterations:
+        stats = {}
+        _collect_kernel_stats(iteration, stats)
+        times.append(sum(kernel["time_ns"] for kernel in stats.values()) * 1e-6)
+        for kernel_name, kernel in stats.items():
+            total = _kernel_stats.setdefault(kernel_name, {"calls": 0, "time_ms": 0, "flops": 0, "bytes": 0})
+            total["calls"] += kernel["calls"] / n_repeat
+            total["time_ms"] += kernel["time_ns"] * 1e-6 / n_repeat
+            total["flops"] += kernel["flops"] / n_repeat
+            total["bytes"] += kernel["bytes"] / n_repeat
+    times = torch.tensor(times, dtype=torch.float)
+    return _summarize_statistics(times, quantiles, return_mode)
+
+
 do_bench = do_bench_no_ipex
+# The profiler of IPEX only records XPU kernels.
 if USE_IPEX_OPTION:
     do_bench = do_bench_ipex
+if USE_PROTON_OPTION:
+    do_bench = do_bench_proton
 
 
 def assert_close(x, y, atol=None, rtol=None, err_msg=""):
@@ -225,6 +383,7 @@ class Benchmark:
         y_log: bool = False,
         color=None,  # pylint: disable=unused-argument
         styles=None,
+        backends=None,
     ):
         """
         Constructor.
@@ -255,6 +414,9 @@ class Benchmark:
         :type x_log: bool, optional
         :param y_log: Whether the y axis should be log scale.
         :type y_log: bool, optional
+        :param backends: Backends ("xpu", "cuda" or "hip") each value of :code:`line_vals` runs on. The values
+            missing from it run on every backend.
+        :type backends: Dict[Any, List[str]], optional
         """
         self.x_names = x_names
         self.x_vals = x_vals
@@ -269,6 +431,84 @@ class Benchmark:
         self.ylabel = ylabel
         self.plot_name = plot_name
         self.args = args
+        self.backends = backends or {}
+
+    def lines(self):
+        """Returns the indices, names and values of the lines running on the current backend."""
+        return [(i, name, val)
+                for i, (name, val) in enumerate(zip(self.line_names, self.line_vals))
+                if BACKEND in self.backends.get(val, [BACKEND])]
+
+
+def bootstrap_ratio(baseline, current, confidence=0.95, num_resamples=1000, seed=0):
+    """
+    Returns the ratio of the median times of :code:`current` and :code:`baseline`, with its bootstrap confidence
+    interval: the quantiles of the ratios of the medians of the samples drawn with replacement from both.
+
+    :param baseline: Times (in ms) of the iterations of the baseline.
+    :type baseline: List[float]
+    :param current: Times (in ms) of the iterations of the current run.
+    :type current: List[float]
+    :param confidence: Confidence level of the interval.
+    :type confidence: float
+    """
+    import torch
+    generator = torch.Generator().manual_seed(seed)
+    baseline = torch.tensor(baseline, dtype=torch.float)
+    current = torch.tensor(current, dtype=torch.float)
+
+    def resampled_medians(times):
+        indices = torch.randint(0, times.numel(), (num_resamples, times.numel()), generator=generator)
+        return times[indices].median(dim=1).values
+
+    ratios = resampled_medians(current) / resampled_medians(baseline)
+    alpha = (1 - confidence) / 2
+    low, high = torch.quantile(ratios, torch.tensor([alpha, 1 - alpha])).tolist()
+    return (current.median() / baseline.median()).item(), low, high
+
+
+class ResultStore:
+    """
+    Stores the times of the iterations of the benchmark runs, under a label for each run, e.g. the backend and the
+    commit, so that runs on different commits or backends are compared with the same statistics.
+
+    The times of a run are saved in :code:`<path>/<label>/<plot_name>.json`, as a list of records with the x values,
+    the line name and the times (in ms) of the benchmark.
+    """
+
+    def __init__(self, path: str):
+        self.path = path
+
+    def save(self, label: str, plot_name: str, records: List[Dict[str, Any]]):
+        os.makedirs(os.path.join(self.path, label), exist_ok=True)
+        with open(os.path.join(self.path, label, f"{plot_name}.json"), "w", encoding="utf-8") as f:
+            json.dump(records, f)
+
+    def load(self, label: str, plot_name: str) -> Optional[List[Dict[str, Any]]]:
+        file_name = os.path.join(self.path, label, f"{plot_name}.json")
+        if not os.path.exists(file_name):
+            return None
+        with open(file_name, encoding="utf-8") as f:
+            return json.load(f)
+
+    @staticmethod
+    def compare(baseline: List[Dict[str, Any]], current: List[Dict[str, Any]], threshold=0.02, confidence=0.95):
+        """
+        Returns the comparison rows of the records of both runs with the same x values and line name.
+
+        A record regressed (or improved) when the whole confidence interval of its time ratio is above
+        :code:`1 + threshold` (or below :code:`1 - threshold`).
+        """
+        baseline_times = {(json.dumps(r["x"], sort_keys=True), r["line"]): r["times_ms"] for r in baseline}
+        rows = []
+        for record in current:
+            times = baseline_times.get((json.dumps(record["x"], sort_keys=True), record["line"]))
+            if times is None:
+                continue
+            ratio, low, high = bootstrap_ratio(times, record["times_ms"], confidence)
+            status = "regression" if low > 1 + threshold else "improvement" if high < 1 - threshold else ""
+            rows.append(list(record["x"].values()) + [record["line"], ratio, low, high, status])
+        return rows
 
 
 class Mark:
@@ -279,18 +519,22 @@ class Mark:
 
     # pylint: disable=too-many-branches
     def _run(self, bench: Benchmark, save_path: str, show_plots: bool, print_data: bool, diff_col=False,
-             save_precision=6, **kwrags):
+             save_precision=6, results_path="", **kwrags):
         import matplotlib.pyplot as plt
         import pandas as pd
+        lines = bench.lines()
+        line_names = [line_name for _, line_name, _ in lines]
         y_vals = []
         for label in bench.ylabel:
-            y_mean = [f"{x}-{label}" for x in bench.line_names]
-            y_min = [f"{x}-{label}-min" for x in bench.line_names]
-            y_max = [f"{x}-{label}-max" for x in bench.line_names]
+            y_mean = [f"{x}-{label}" for x in line_names]
+            y_min = [f"{x}-{label}-min" for x in line_names]
+            y_max = [f"{x}-{label}-max" for x in line_names]
             y_vals += y_mean + y_min + y_max
-        y_vals += [f"{x}-CV" for x in bench.line_names]
+        y_vals += [f"{x}-CV" for x in line_names]
         x_names = list(bench.x_names)
         df = pd.DataFrame(columns=x_names + y_vals)
+        kernel_rows = []
+        records = []
         for x in bench.x_vals:
             # x can be a single value or a sequence of values.
             if not isinstance(x, (list, tuple)):
@@ -303,8 +547,15 @@ class Mark:
             row_vals = {}
             for label in itertools.chain(bench.ylabel, ["CV"]):
                 row_vals[label] = ([], [], [])
-            for y in bench.line_vals:
+            for _, line_name, y in lines:
+                pop_kernel_stats()
+                pop_bench_times()
                 ret = self.fn(**x_args, **{bench.line_arg: y}, **bench.args, **kwrags)
+                kernel_rows += self._kernel_rows(bench, x, line_name, ret, pop_kernel_stats())
+                bench_times = pop_bench_times()
+                if bench_times:
+                    # The times of the last `do_bench` call, which measures the returned results.
+                    records.append({"x": x_args, "line": line_name, "times_ms": bench_times[-1]})
                 for i, label in enumerate(itertools.chain(bench.ylabel, ["CV"])):
                     try:
                         y_mean, y_min, y_max = ret[i]
@@ -330,7 +581,7 @@ class Mark:
             # Plot first x value on x axis if there are multiple.
             first_x = x_names[0]
             for label in bench.ylabel:
-                for i, y in enumerate(bench.line_names):
+                for i, y, _ in lines:
                     y = f"{y}-{label}"
                     y_min, y_max = df[y + "-min"], df[y + "-max"]
                     col = bench.styles[i][0] if bench.styles else None
@@ -361,16 +612,77 @@ class Mark:
         if save_path:
             df.to_csv(os.path.join(save_path, f"{bench.plot_name}.csv"), float_format=f"%.{save_precision}f",
                       index=False)
+        if kernel_rows:
+            kernels_df = pd.DataFrame(kernel_rows,
+                                      columns=x_names + ["provider", "kernel", "calls", "time_ms", "TFlops", "GB/s"])
+            if print_data:
+                print(bench.plot_name + " kernels:")
+                print(kernels_df.to_string())
+            if save_path:
+                kernels_df.to_csv(os.path.join(save_path, f"{bench.plot_name}-kernels.csv"),
+                                  float_format=f"%.{save_precision}f", index=False)
+        if results_path and records:
+            self._save_and_compare(bench, records, results_path, save_path, print_data, save_precision)
         return df
 
-    def run(self, show_plots=False, print_data=False, save_path="", return_df=False, **kwargs):
+    @staticmethod
+    def _save_and_compare(bench: Benchmark, records, results_path, save_path, print_data, save_precision):
+        """
+        Saves the times of the benchmark in the result store under the label of the run, and compares them with the
+        ones of the baseline label, if any.
+        """
+        import pandas as pd
+        args = result_args_from_args()
+        store = ResultStore(results_path)
+        store.save(args.label, bench.plot_name, records)
+        if not args.baseline:
+            return
+        baseline = store.load(args.baseline, bench.plot_name)
+        if baseline is None:
+            print(f"{bench.plot_name}: no results for the baseline {args.baseline}")
+            return
+        columns = list(bench.x_names) + ["provider", "ratio", "ratio-low", "ratio-high", "status"]
+        compare_df = pd.DataFrame(ResultStore.compare(baseline, records, args.threshold), columns=columns)
+        if print_data:
+            print(f"{bench.plot_name} ({args.label} / {args.baseline} time ratios):")
+            print(compare_df.to_string())
+        if save_path:
+            compare_df.to_csv(os.path.join(save_path, f"{bench.plot_name}-compare.csv"),
+                              float_format=f"%.{save_precision}f", index=False)
+
+    @staticmethod
+    def _kernel_rows(bench: Benchmark, x, line_name, ret, kernel_stats):
+        """
+        Returns the per-kernel rows of a benchmark run with `do_bench_proton`.
+
+        The throughput of a kernel is computed from the flops and bytes reported by its `launch_metadata`. When the
+        benchmarked function runs a single kernel, which does not report them, it is the mean throughput returned by
+        the benchmark, as the time of the kernel is the time of the function.
+        """
+
+        def reported(label):
+            if label not in bench.ylabel or len(kernel_stats) != 1:
+                return None
+            value = ret[bench.ylabel.index(label)]
+            return value[0] if isinstance(value, (list, tuple)) else value
+
+        rows = []
+        for name, kernel in kernel_stats.items():
+            seconds = kernel["time_ms"] * 1e-3
+            tflops = kernel["flops"] * 1e-12 / seconds if kernel["flops"] else reported("TFlops")
+            gbps = kernel["bytes"] * 1e-9 / seconds if kernel["bytes"] else reported("GB/s")
+            rows.append(list(x) + [line_name, name, kernel["calls"], kernel["time_ms"], tflops, gbps])
+        return rows
+
+    def run(self, show_plots=False, print_data=False, save_path="", return_df=False, results_path="", **kwargs):
         save_path = save_path_from_args(save_path)
+        results_path = results_path or result_args_from_args().results
         has_single_bench = isinstance(self.benchmarks, Benchmark)
         benchmarks = [self.benchmarks] if has_single_bench else self.benchmarks
         result_dfs = []
 
         for bench in benchmarks:
-            result_dfs.append(self._run(bench, save_path, show_plots, print_data, **kwargs))
+            result_dfs.append(self._run(bench, save_path, show_plots, print_data, results_path=results_path, **kwargs))
 
         if save_path:
             # Create directory if it doesn't exist
@@ -398,5 +710,51 @@ def save_path_from_args(save_path: str):
         default="",
         help="directory to save reports",
     )
-    args = parser.parse_args()
+    # The benchmark may be run by a script with its own options.
+    args, _ = parser.parse_known_args()
     return args.reports
+
+
+def _default_label():
+    try:
+        commit = subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], stderr=subprocess.DEVNULL,
+                                         cwd=os.path.dirname(__file__), text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        commit = "unknown"
+    return f"{BACKEND}-{commit}"
+
+
+def result_args_from_args():
+    """
+    Returns the result store options specified via the --results, --label, --baseline and --threshold command line
+    options.
+    """
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--results",
+        type=str,
+        default="",
+        help="directory of the result store to save the times of the iterations to",
+    )
+    parser.add_argument(
+        "--label",
+        type=str,
+        default="",
+        help="label of the run in the result store, the backend and the commit by default",
+    )
+    parser.add_argument(
+        "--baseline",
+        type=str,
+        default="",
+        help="label of the run in the result store to compare with",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.02,
+        help="relative change of the time ratio confidence interval reported as a regression or improvement",
+    )
+    # The benchmark may be run by a script with its own options.
+    args, _ = parser.parse_known_args()
+    args.label = args.label or _default_label()
+    return args
@@ -0,0 +1,76 @@
+"""
+Convolution
+===========
+
+The 2D convolutions of the ResNet-50 layers on NHWC activations, computed as implicit GEMMs by
+`triton.language.extra.intel.conv`: the im2col windows of the filter taps are read with 2D block loads straight from
+the activations, without materializing the im2col matrix. To compare the performance to the channels last
+`torch.nn.functional.conv2d`.
+
+"""
+
+import torch
+from triton.language.extra.intel import conv
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=['N', 'H', 'W', 'C', 'K', 'R', 'S', 'stride', 'padding'],
+        x_vals=[[n, *shape]  #
+                for n in [1, 32]  #
+                for shape in [
+                    [56, 56, 64, 64, 3, 3, 1, 1],
+                    [56, 56, 64, 256, 1, 1, 1, 0],
+                    [56, 56, 128, 128, 3, 3, 2, 1],
+                    [28, 28, 128, 128, 3, 3, 1, 1],
+                    [14, 14, 256, 256, 3, 3, 1, 1],
+                    [14, 14, 1024, 256, 1, 1, 1, 0],
+                    [7, 7, 512, 512, 3, 3, 1, 1],
+                ]],
+        line_arg='provider',
+        line_vals=['triton', 'onednn'],
+        line_names=['Triton', 'OneDNN'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],
+        plot_name='conv-performance',
+        args={},
+    ))
+def benchmark(N, H, W, C, K, R, S, stride, padding, provider):
+    torch.manual_seed(0)
+    x = torch.randn((N, C, H, W), device='xpu', dtype=torch.float16).to(memory_format=torch.channels_last)
+    w = torch.randn((K, C, R, S), device='xpu', dtype=torch.float16).to(memory_format=torch.channels_last)
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        # The channels last tensors are the NHWC tensors, the filter is transposed to RSCK once.
+        x_nhwc = x.permute(0, 2, 3, 1)
+        w_rsck = w.permute(2, 3, 1, 0).contiguous()
+        triton_fn = lambda: conv.conv2d(x_nhwc, w_rsck, stride=stride, padding=padding)
+        torch_fn = lambda: torch.nn.functional.conv2d(x, w, stride=stride, padding=padding)
+        benchmark_suit.assert_close(triton_fn().permute(0, 3, 1, 2), torch_fn(), atol=1e-1, rtol=1e-2,
+                                    err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    elif provider == 'onednn':
+        onednn_fn = lambda: torch.nn.functional.conv2d(x, w, stride=stride, padding=padding)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(onednn_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    OH = (H + 2 * padding - R) // stride + 1
+    OW = (W + 2 * padding - S) // stride + 1
+    tflops = lambda ms: 2 * N * OH * OW * K * C * R * S * 1e-12 / (ms * 1e-3)
+    # The activations and the filter read once, the output written once.
+    num_bytes = (N * H * W * C + R * S * C * K + N * OH * OW * K) * x.element_size()
+    gbps = lambda ms: num_bytes * 1e-9 / (ms * 1e-3)
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
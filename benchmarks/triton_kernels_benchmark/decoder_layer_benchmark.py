@@ -0,0 +1,379 @@
+"""
+Decoder layer benchmark
+=======================
+
+A whole Llama-style decoder layer, RMSNorm, QKV projection, RoPE, attention, output projection, RMSNorm and SwiGLU
+MLP, run with Triton kernels for the prefill of a batch of prompts and for a decode step over a paged KV cache.
+Besides the device time of the layer, it reports what the kernel benchmarks don't:
+
+- the host time spent launching the kernels of the layer, per token, when the layers are launched back to back;
+- the cold start of the layer: compiling and loading its kernels with an empty cache, and loading them from the cache;
+- the memory of the weights, of the KV cache and of the activations of the layer.
+
+The prefill attention is the causal flash attention of `flash_attention_causal_benchmark`, the decode attention the
+paged attention of `paged_attention_decode_benchmark`.
+
+"""
+
+import os
+import tempfile
+import time
+
+import torch
+import triton
+import triton.language as tl
+from triton.language.extra.intel import attention, streamk
+
+import triton_kernels_benchmark as benchmark_suit
+import flash_attention_causal_benchmark
+import paged_attention_decode_benchmark
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+PAGE_SIZE = paged_attention_decode_benchmark.PAGE_SIZE
+
+
+@triton.jit
+def rms_norm_kernel(x_ptr, w_ptr, y_ptr, N, eps, BLOCK_N: tl.constexpr):
+    row = tl.program_id(0).to(tl.int64)
+    offs = tl.arange(0, BLOCK_N)
+    mask = offs < N
+    x = tl.load(x_ptr + row * N + offs, mask=mask, other=0.0).to(tl.float32)
+    rstd = 1 / tl.sqrt(tl.sum(x * x, 0) / N + eps)
+    w = tl.load(w_ptr + offs, mask=mask)
+    tl.store(y_ptr + row * N + offs, (x * rstd * w).to(y_ptr.dtype.element_ty), mask=mask)
+
+
+@triton.jit
+def _rotate(ptr, cos, sin, HALF: tl.constexpr):
+    offs = tl.arange(0, HALF)
+    x1 = tl.load(ptr + offs).to(tl.float32)
+    x2 = tl.load(ptr + HALF + offs).to(tl.float32)
+    y1 = (x1 * cos - x2 * sin).to(ptr.dtype.element_ty)
+    y2 = (x2 * cos + x1 * sin).to(ptr.dtype.element_ty)
+    tl.store(ptr + offs, y1)
+    tl.store(ptr + HALF + offs, y2)
+    return y1, y2
+
+
+@triton.jit
+def rope_kernel(qkv_ptr, cos_ptr, sin_ptr, positions_ptr, k_cache_ptr, v_cache_ptr, slots_ptr, stride_t,
+                stride_cache_h, NUM_HEADS: tl.constexpr, HEAD_DIM: tl.constexpr, WRITE_CACHE: tl.constexpr):
+    # Rotates the query and the key of a head of a token in place, in the (3, NUM_HEADS, HEAD_DIM) row of the token,
+    # and appends its key and value to the KV cache for decode.
+    token = tl.program_id(0)
+    head = tl.program_id(1)
+    HALF: tl.constexpr = HEAD_DIM // 2
+    pos = tl.load(positions_ptr + token)
+    cos = tl.load(cos_ptr + pos * HALF + tl.arange(0, HALF))
+    sin = tl.load(sin_ptr + pos * HALF + tl.arange(0, HALF))
+    row = qkv_ptr + token.to(tl.int64) * stride_t + head * HEAD_DIM
+    _rotate(row, cos, sin, HALF)
+    k1, k2 = _rotate(row + NUM_HEADS * HEAD_DIM, cos, sin, HALF)
+    if WRITE_CACHE:
+        slot = tl.load(slots_ptr + token) + head * stride_cache_h
+        tl.store(k_cache_ptr + slot + tl.arange(0, HALF), k1)
+        tl.store(k_cache_ptr + slot + HALF + tl.arange(0, HALF), k2)
+        offs = tl.arange(0, HEAD_DIM)
+        tl.store(v_cache_ptr + slot + offs, tl.load(row + 2 * NUM_HEADS * HEAD_DIM + offs))
+
+
+@triton.jit
+def silu_mul_kernel(gate_up_ptr, y_ptr, n_elements, INTER, BLOCK_SIZE: tl.constexpr):
+    offs = tl.program_id(0).to(tl.int64) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offs < n_elements
+    # The gate and up projections are the two halves of the rows of `gate_up`.
+    gate_offs = (offs // INTER) * 2 * INTER + offs % INTER
+    gate = tl.load(gate_up_ptr + gate_offs, mask=mask).to(tl.float32)
+    up = tl.load(gate_up_ptr + gate_offs + INTER, mask=mask).to(tl.float32)
+    tl.store(y_ptr + offs, (gate / (1 + tl.exp(-gate)) * up).to(y_ptr.dtype.element_ty), mask=mask)
+
+
+@triton.autotune(
+    configs=[
+        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 256, 'BLOCK_K': 32, 'GROUP_M': 4, 'grf_mode': 'large'},
+                      num_stages=3, num_warps=32),
+        triton.Config({'BLOCK_M': 64, 'BLOCK_N': 256, 'BLOCK_K': 32, 'GROUP_M': 4, 'grf_mode': 'large'},
+                      num_stages=3, num_warps=8),
+        triton.Config({'BLOCK_M': 16, 'BLOCK_N': 64, 'BLOCK_K': 64, 'GROUP_M': 1, 'grf_mode': 'large'}, num_stages=3,
+                      num_warps=4),
+    ],
+    key=['M', 'N', 'K'],
+)
+@triton.jit
+def linear_kernel(a_ptr, w_ptr, c_ptr, r_ptr, M, N, K, stride_am, stride_wk, stride_cm,  #
+                  RESIDUAL: tl.constexpr, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+                  GROUP_M: tl.constexpr):
+    pid = tl.program_id(0)
+    num_pid_m = tl.cdiv(M, BLOCK_M)
+    num_pid_n = tl.cdiv(N, BLOCK_N)
+    num_pid_in_group = GROUP_M * num_pid_n
+    group_id = pid // num_pid_in_group
+    first_pid_m = group_id * GROUP_M
+    group_size_m = min(num_pid_m - first_pid_m, GROUP_M)
+    pid_m = first_pid_m + ((pid % num_pid_in_group) % group_size_m)
+    pid_n = (pid % num_pid_in_group) // group_size_m
+
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, 1), offsets=(pid_m * BLOCK_M, 0),
+                                    block_shape=(BLOCK_M, BLOCK_K), order=(1, 0))
+    w_block_ptr = tl.make_block_ptr(base=w_ptr, shape=(K, N), strides=(stride_wk, 1), offsets=(0, pid_n * BLOCK_N),
+                                    block_shape=(BLOCK_K, BLOCK_N), order=(1, 0))
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    for _ in range(0, K, BLOCK_K):
+        # The float32 output of the attention is converted to the type of the weights.
+        a = tl.load(a_block_ptr, boundary_check=(0, 1)).to(w_ptr.dtype.element_ty)
+        w = tl.load(w_block_ptr, boundary_check=(0, 1))
+        acc += tl.dot(a, w)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K))
+        w_block_ptr = tl.advance(w_block_ptr, (BLOCK_K, 0))
+    c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, 1),
+                                    offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
+                                    order=(1, 0))
+    if RESIDUAL:
+        r_block_ptr = tl.make_block_ptr(base=r_ptr, shape=(M, N), strides=(stride_cm, 1),
+                                        offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
+                                        order=(1, 0))
+        acc += tl.load(r_block_ptr, boundary_check=(0, 1)).to(tl.float32)
+    tl.store(c_block_ptr, acc.to(c_ptr.dtype.element_ty), boundary_check=(0, 1))
+
+
+def linear(a, w, residual=None):
+    M, K = a.shape
+    _, N = w.shape
+    c = torch.empty((M, N), device=a.device, dtype=w.dtype)
+    grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), )
+    linear_kernel[grid](a, w, c, c if residual is None else residual, M, N, K, a.stride(0), w.stride(0), c.stride(0),
+                        RESIDUAL=residual is not None)
+    return c
+
+
+def rms_norm(x, weight, eps=1e-6):
+    M, N = x.shape
+    y = torch.empty_like(x)
+    rms_norm_kernel[(M, )](x, weight, y, N, eps, BLOCK_N=triton.next_power_of_2(N), num_warps=8)
+    return y
+
+
+def silu_mul(gate_up):
+    M, N = gate_up.shape
+    y = torch.empty((M, N // 2), device=gate_up.device, dtype=gate_up.dtype)
+    BLOCK_SIZE = 1024
+    silu_mul_kernel[(triton.cdiv(y.numel(), BLOCK_SIZE), )](gate_up, y, y.numel(), N // 2, BLOCK_SIZE=BLOCK_SIZE)
+    return y
+
+
+class DecoderLayer:
+    """
+    The weights and the state of a decoder layer with `H` heads of `HIDDEN // H` channels, for the prefill of `B`
+    prompts of `S` tokens (`MODE='prefill'`), or for a decode step of `B` sequences at position `S - 1` whose previous
+    keys and values are in a paged KV cache (`MODE='decode'`).
+    """
+
+    def __init__(self, MODE, B, S, HIDDEN, H, INTER, dtype=torch.float16, device='xpu'):
+        self.mode = MODE
+        self.num_heads = H
+        self.head_dim = HIDDEN // H
+        self.sm_scale = self.head_dim**-0.5
+        self.num_tokens = B * S if MODE == 'prefill' else B
+        self.context_len = S
+        weight = lambda K, N: torch.randn((K, N), device=device, dtype=dtype) * K**-0.5
+        self.w_qkv = weight(HIDDEN, 3 * HIDDEN)
+        self.w_out = weight(HIDDEN, HIDDEN)
+        self.w_gate_up = weight(HIDDEN, 2 * INTER)
+        self.w_down = weight(INTER, HIDDEN)
+        self.norm1 = 1 + 0.1 * torch.randn(HIDDEN, device=device, dtype=dtype)
+        self.norm2 = 1 + 0.1 * torch.randn(HIDDEN, device=device, dtype=dtype)
+        self.weights = [self.w_qkv, self.w_out, self.w_gate_up, self.w_down, self.norm1, self.norm2]
+
+        inv_freq = 1.0 / (10000**(torch.arange(0, self.head_dim, 2, device=device, dtype=torch.float32) /
+                                  self.head_dim))
+        angles = torch.arange(S, device=device, dtype=torch.float32)[:, None] * inv_freq[None, :]
+        self.cos, self.sin = angles.cos().contiguous(), angles.sin().contiguous()
+        self.x = torch.randn((self.num_tokens, HIDDEN), device=device, dtype=dtype)
+
+        if MODE == 'prefill':
+            self.seqlens = [S] * B
+            self.positions = torch.arange(S, device=device, dtype=torch.int32).repeat(B)
+            block_n = 64 if self.head_dim <= 64 else 32
+            self.schedule = attention.attention_schedule(
+                self.seqlens, H, 128, block_n, True,
+                num_programs=streamk.num_xe_cores() * flash_attention_causal_benchmark.PROGRAMS_PER_XE_CORE,
+                device=device)
+            self.k_cache = self.v_cache = None
+            self.slots = self.positions
+        else:
+            max_pages = triton.cdiv(S, PAGE_SIZE)
+            self.positions = torch.full((B, ), S - 1, device=device, dtype=torch.int32)
+            self.context_lens = torch.full((B, ), S, device=device, dtype=torch.int32)
+            self.block_tables = torch.randperm(B * max_pages, device=device, dtype=torch.int32).view(B, max_pages)
+            self.k_cache = torch.randn((B * max_pages, H, PAGE_SIZE, self.head_dim), device=device, dtype=dtype)
+            self.v_cache = torch.randn_like(self.k_cache)
+            # The offsets in the caches of the keys and values of the decoded tokens.
+            pages = self.block_tables[:, (S - 1) // PAGE_SIZE].long()
+            self.slots = pages * self.k_cache.stride(0) + (S - 1) % PAGE_SIZE * self.k_cache.stride(2)
+
+    def forward(self, x):
+        T, H, D = self.num_tokens, self.num_heads, self.head_dim
+        qkv = linear(rms_norm(x, self.norm1), self.w_qkv)
+        decode = self.mode == 'decode'
+        rope_kernel[(T, H)](qkv, self.cos, self.sin, self.positions, self.k_cache if decode else qkv,
+                            self.v_cache if decode else qkv, self.slots, qkv.stride(0),
+                            self.k_cache.stride(1) if decode else 0, NUM_HEADS=H, HEAD_DIM=D, WRITE_CACHE=decode)
+        q, k, v = qkv.view(T, 3, H, D).unbind(1)
+        if decode:
+            attn = paged_attention_decode_benchmark.paged_attention_decode(q, self.k_cache, self.v_cache,
+                                                                          self.block_tables, self.context_lens,
+                                                                          self.sm_scale)
+        else:
+            attn = flash_attention_causal_benchmark.forward(q, k, v, self.seqlens, True, self.sm_scale, self.schedule)
+        h = linear(attn.reshape(T, H * D), self.w_out, residual=x)
+        gate_up = linear(rms_norm(h, self.norm2), self.w_gate_up)
+        return linear(silu_mul(gate_up), self.w_down, residual=h)
+
+    def flops(self):
+        HIDDEN = self.num_heads * self.head_dim
+        INTER = self.w_down.shape[0]
+        linear_flops = 2 * self.num_tokens * (HIDDEN * (3 * HIDDEN + HIDDEN + 2 * INTER) + INTER * HIDDEN)
+        if self.mode == 'decode':
+            attended = self.num_tokens * self.context_len
+        else:
+            # Under the causal mask, the i-th token of a prompt attends to i + 1 keys.
+            attended = len(self.seqlens) * self.context_len * (self.context_len + 1) // 2
+        return linear_flops + 2 * 2 * attended * HIDDEN
+
+
+def torch_layer(layer, x, eps=1e-6):
+    """The decoder layer in float32, with the KV cache of decode copied."""
+    T, H, D = layer.num_tokens, layer.num_heads, layer.head_dim
+
+    def norm(x, weight):
+        return x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + eps) * weight.float()
+
+    def rope(x):
+        cos, sin = layer.cos[layer.positions.long()][:, None], layer.sin[layer.positions.long()][:, None]
+        x1, x2 = x[..., :D // 2], x[..., D // 2:]
+        return torch.cat([x1 * cos - x2 * sin, x2 * cos + x1 * sin], dim=-1)
+
+    x = x.float()
+    q, k, v = (norm(x, layer.norm1) @ layer.w_qkv.float()).view(T, 3, H, D).unbind(1)
+    q, k = rope(q), rope(k)
+    if layer.mode == 'decode':
+        k_cache, v_cache = layer.k_cache.clone(), layer.v_cache.clone()
+        pages = layer.block_tables[:, (layer.context_len - 1) // PAGE_SIZE].long()
+        k_cache[pages, :, (layer.context_len - 1) % PAGE_SIZE] = k.to(k_cache.dtype)
+        v_cache[pages, :, (layer.context_len - 1) % PAGE_SIZE] = v.to(v_cache.dtype)
+        attn = paged_attention_decode_benchmark.paged_attention_decode_ref(q, k_cache, v_cache, layer.block_tables,
+                                                                          layer.context_lens, layer.sm_scale)
+    else:
+        attn = flash_attention_causal_benchmark.torch_attention(q, k, v, layer.seqlens, layer.sm_scale)
+    h = attn.reshape(T, H * D) @ layer.w_out.float() + x
+    gate, up = (norm(h, layer.norm2) @ layer.w_gate_up.float()).chunk(2, dim=-1)
+    return (torch.nn.functional.silu(gate) * up) @ layer.w_down.float() + h
+
+
+def _jit_functions():
+    kernels = [
+        rms_norm_kernel, rope_kernel, silu_mul_kernel, linear_kernel, flash_attention_causal_benchmark._attn_fwd,
+        paged_attention_decode_benchmark.paged_attention_decode_kernel
+    ]
+    return [kernel.fn if isinstance(kernel, triton.runtime.Autotuner) else kernel for kernel in kernels]
+
+
+def _call_ms(fn):
+    torch.xpu.synchronize()
+    start = time.perf_counter()
+    fn()
+    torch.xpu.synchronize()
+    return (time.perf_counter() - start) * 1e3
+
+
+def _first_call_ms(fn):
+    # Runs `fn` with the kernels compiled or loaded again, keeping the configs selected by the autotuners.
+    for kernel in _jit_functions():
+        kernel.cache[torch.xpu.current_device()].clear()
+    return _call_ms(fn)
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['MODE', 'B', 'S', 'HIDDEN', 'H', 'INTER'],
+        # different possible values for `x_name`
+        x_vals=[  #
+            ['prefill', 1, 2048, 4096, 32, 11008],  #
+            ['prefill', 4, 1024, 4096, 32, 11008],  #
+            ['decode', 1, 1024, 4096, 32, 11008],  #
+            ['decode', 16, 2048, 4096, 32, 11008],  #
+            ['decode', 64, 1024, 4096, 32, 11008],  #
+        ],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton'],
+        # label name for the lines
+        line_names=['Triton'],
+        # line styles
+        styles=[('green', '-')],
+        ylabel=[
+            'TFlops', 'ms', 'host-us/token', 'compile-ms', 'load-ms', 'weights-MB', 'kv-cache-MB', 'activations-MB'
+        ],
+        plot_name='decoder-layer-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(MODE, B, S, HIDDEN, H, INTER, provider):
+    if provider != 'triton':
+        raise NotImplementedError(f'Unsupported provider {provider}')
+    torch.manual_seed(0)
+    layer = DecoderLayer(MODE, B, S, HIDDEN, H, INTER)
+    x = layer.x
+    triton_fn = lambda: layer.forward(x)
+    benchmark_suit.assert_close(triton_fn().float(), torch_layer(layer, x), atol=5e-2, rtol=1e-2,
+                                err_msg='triton to torch')
+
+    # Cold start, once the autotuners selected their configs: the kernels are compiled and loaded with an empty
+    # cache, then loaded from the cache. The time of the layer itself is subtracted.
+    warm_ms = min(_call_ms(triton_fn) for _ in range(3))
+    saved_cache_dir = os.environ.get('TRITON_CACHE_DIR')
+    with tempfile.TemporaryDirectory() as cache_dir:
+        os.environ['TRITON_CACHE_DIR'] = cache_dir
+        try:
+            compile_ms = _first_call_ms(triton_fn) - warm_ms
+            load_ms = _first_call_ms(triton_fn) - warm_ms
+        finally:
+            if saved_cache_dir is None:
+                os.environ.pop('TRITON_CACHE_DIR')
+            else:
+                os.environ['TRITON_CACHE_DIR'] = saved_cache_dir
+    # Reload the kernels from the cache of the benchmarks.
+    _first_call_ms(triton_fn)
+
+    quantiles = [0.5, 0.0, 1.0]
+    _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                             fast_flush=False)
+
+    # The host time of the launches of back to back layers, the device catching up afterwards.
+    num_layers = 20
+    torch.xpu.synchronize()
+    start = time.perf_counter()
+    for _ in range(num_layers):
+        triton_fn()
+    host_us = (time.perf_counter() - start) * 1e6 / num_layers
+    torch.xpu.synchronize()
+
+    torch.xpu.reset_peak_memory_stats()
+    allocated = torch.xpu.memory_allocated()
+    triton_fn()
+    torch.xpu.synchronize()
+    activations_mb = (torch.xpu.max_memory_allocated() - allocated) / 2**20
+    weights_mb = sum(w.numel() * w.element_size() for w in layer.weights) / 2**20
+    kv_cache_mb = 0.0 if MODE == 'prefill' else 2 * layer.k_cache.numel() * layer.k_cache.element_size() / 2**20
+
+    tflops = lambda ms: layer.flops() * (1e-12) / (ms * 1e-3)
+    return ((tflops(mean_ms), tflops(max_ms), tflops(min_ms)), (mean_ms, min_ms, max_ms), host_us / layer.num_tokens,
+            compile_ms, load_ms, weights_mb, kv_cache_mb, activations_mb, cv)
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
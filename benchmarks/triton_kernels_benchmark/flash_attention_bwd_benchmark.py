@@ -0,0 +1,268 @@
+import torch
+import triton
+import triton.language as tl
+
+import triton_kernels_benchmark as benchmark_suit
+from flash_attention_fwd_benchmark import forward
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def _attn_bwd_preprocess(O, DO, Delta,  #
+                         N_CTX: tl.constexpr,  #
+                         BLOCK_M: tl.constexpr, BLOCK_DMODEL: tl.constexpr  #
+                         ):
+    off_m = tl.program_id(0) * BLOCK_M + tl.arange(0, BLOCK_M)
+    off_hz = tl.program_id(1)
+    off_n = tl.arange(0, BLOCK_DMODEL)
+    # load
+    o = tl.load(O + off_hz * BLOCK_DMODEL * N_CTX + off_m[:, None] * BLOCK_DMODEL + off_n[None, :])
+    do = tl.load(DO + off_hz * BLOCK_DMODEL * N_CTX + off_m[:, None] * BLOCK_DMODEL + off_n[None, :]).to(tl.float32)
+    delta = tl.sum(o * do, axis=1)
+    # write-back
+    tl.store(Delta + off_hz * N_CTX + off_m, delta)
+
+
+# The key/value gradients and the query gradients are computed by two separate kernels, each program owning the rows
+# of the gradient it produces. This avoids accumulating dQ across programs with atomics. Operands needed in transposed
+# form are read through column-major block pointers rather than with `tl.trans`, so they are loaded with the
+# transposing 2D block read of the B operand of the DPAS instruction.
+@triton.jit
+def _attn_bwd_dkdv(Q, K, V, sm_scale, DO, DK, DV, M, D,  #
+                   stride_z: tl.constexpr, stride_h: tl.constexpr, stride_tok: tl.constexpr, stride_d: tl.constexpr,  #
+                   H: tl.constexpr, N_CTX: tl.constexpr,  #
+                   BLOCK_M: tl.constexpr,  #
+                   BLOCK_N: tl.constexpr,  #
+                   BLOCK_DMODEL: tl.constexpr  #
+                   ):
+    start_n = tl.program_id(0)
+    off_hz = tl.program_id(2)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    qkv_offset = off_z.to(tl.int64) * stride_z + off_h.to(tl.int64) * stride_h
+
+    K_block_ptr = tl.make_block_ptr(base=K + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                    offsets=(start_n * BLOCK_N, 0), block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+    V_block_ptr = tl.make_block_ptr(base=V + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                    offsets=(start_n * BLOCK_N, 0), block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+    Q_block_ptr = tl.make_block_ptr(base=Q + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                    offsets=(0, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    QT_block_ptr = tl.make_block_ptr(base=Q + qkv_offset, shape=(BLOCK_DMODEL, N_CTX), strides=(stride_d, stride_tok),
+                                     offsets=(0, 0), block_shape=(BLOCK_DMODEL, BLOCK_M), order=(0, 1))
+    DO_block_ptr = tl.make_block_ptr(base=DO + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                     offsets=(0, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    DOT_block_ptr = tl.make_block_ptr(base=DO + qkv_offset, shape=(BLOCK_DMODEL, N_CTX),
+                                      strides=(stride_d, stride_tok), offsets=(0, 0),
+                                      block_shape=(BLOCK_DMODEL, BLOCK_M), order=(0, 1))
+    DK_block_ptr = tl.make_block_ptr(base=DK + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                     offsets=(start_n * BLOCK_N, 0), block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+    DV_block_ptr = tl.make_block_ptr(base=DV + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                     offsets=(start_n * BLOCK_N, 0), block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+
+    offs_m = tl.arange(0, BLOCK_M)
+    M += off_hz * N_CTX
+    D += off_hz * N_CTX
+    qk_scale = sm_scale
+    qk_scale *= 1.44269504  # 1/log(2)
+
+    k = tl.load(K_block_ptr)
+    v = tl.load(V_block_ptr)
+    dk = tl.zeros([BLOCK_N, BLOCK_DMODEL], dtype=tl.float32)
+    dv = tl.zeros([BLOCK_N, BLOCK_DMODEL], dtype=tl.float32)
+    for start_m in range(0, N_CTX, BLOCK_M):
+        start_m = tl.multiple_of(start_m, BLOCK_M)
+        qT = tl.load(QT_block_ptr)
+        m = tl.load(M + start_m + offs_m)
+        # -- recompute pT = softmax(qk^T) ----
+        qkT = tl.dot(k, qT) * qk_scale
+        pT = tl.math.exp2(qkT - m[None, :])
+        # -- compute dv ----
+        do = tl.load(DO_block_ptr)
+        dv += tl.dot(pT.to(tl.float16), do)
+        # -- compute dk ----
+        doT = tl.load(DOT_block_ptr)
+        Di = tl.load(D + start_m + offs_m)
+        dpT = tl.dot(v, doT)
+        dsT = pT * (dpT - Di[None, :])
+        q = tl.load(Q_block_ptr)
+        dk += tl.dot(dsT.to(tl.float16), q)
+        Q_block_ptr = tl.advance(Q_block_ptr, (BLOCK_M, 0))
+        QT_block_ptr = tl.advance(QT_block_ptr, (0, BLOCK_M))
+        DO_block_ptr = tl.advance(DO_block_ptr, (BLOCK_M, 0))
+        DOT_block_ptr = tl.advance(DOT_block_ptr, (0, BLOCK_M))
+    dk *= sm_scale
+    tl.store(DV_block_ptr, dv.to(DV.type.element_ty))
+    tl.store(DK_block_ptr, dk.to(DK.type.element_ty))
+
+
+@triton.jit
+def _attn_bwd_dq(Q, K, V, sm_scale, DO, DQ, M, D,  #
+                 stride_z: tl.constexpr, stride_h: tl.constexpr, stride_tok: tl.constexpr, stride_d: tl.constexpr,  #
+                 H: tl.constexpr, N_CTX: tl.constexpr,  #
+                 BLOCK_M: tl.constexpr,  #
+                 BLOCK_N: tl.constexpr,  #
+                 BLOCK_DMODEL: tl.constexpr  #
+                 ):
+    start_m = tl.program_id(0)
+    off_hz = tl.program_id(2)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    qkv_offset = off_z.to(tl.int64) * stride_z + off_h.to(tl.int64) * stride_h
+
+    Q_block_ptr = tl.make_block_ptr(base=Q + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                    offsets=(start_m * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    DO_block_ptr = tl.make_block_ptr(base=DO + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                     offsets=(start_m * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    K_block_ptr = tl.make_block_ptr(base=K + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                    offsets=(0, 0), block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+    KT_block_ptr = tl.make_block_ptr(base=K + qkv_offset, shape=(BLOCK_DMODEL, N_CTX), strides=(stride_d, stride_tok),
+                                     offsets=(0, 0), block_shape=(BLOCK_DMODEL, BLOCK_N), order=(0, 1))
+    VT_block_ptr = tl.make_block_ptr(base=V + qkv_offset, shape=(BLOCK_DMODEL, N_CTX), strides=(stride_d, stride_tok),
+                                     offsets=(0, 0), block_shape=(BLOCK_DMODEL, BLOCK_N), order=(0, 1))
+    DQ_block_ptr = tl.make_block_ptr(base=DQ + qkv_offset, shape=(N_CTX, BLOCK_DMODEL), strides=(stride_tok, stride_d),
+                                     offsets=(start_m * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+
+    offs_m = start_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    qk_scale = sm_scale
+    qk_scale *= 1.44269504  # 1/log(2)
+
+    q = tl.load(Q_block_ptr)
+    do = tl.load(DO_block_ptr)
+    m = tl.load(M + off_hz * N_CTX + offs_m)
+    Di = tl.load(D + off_hz * N_CTX + offs_m)
+    dq = tl.zeros([BLOCK_M, BLOCK_DMODEL], dtype=tl.float32)
+    for _ in range(0, N_CTX, BLOCK_N):
+        # -- recompute p = softmax(qk) ----
+        kT = tl.load(KT_block_ptr)
+        qk = tl.dot(q, kT) * qk_scale
+        p = tl.math.exp2(qk - m[:, None])
+        # -- compute dp and ds ----
+        vT = tl.load(VT_block_ptr)
+        dp = tl.dot(do, vT)
+        ds = p * (dp - Di[:, None])
+        # -- compute dq ----
+        k = tl.load(K_block_ptr)
+        dq += tl.dot(ds.to(tl.float16), k)
+        K_block_ptr = tl.advance(K_block_ptr, (BLOCK_N, 0))
+        KT_block_ptr = tl.advance(KT_block_ptr, (0, BLOCK_N))
+        VT_block_ptr = tl.advance(VT_block_ptr, (0, BLOCK_N))
+    dq *= sm_scale
+    tl.store(DQ_block_ptr, dq.to(DQ.type.element_ty))
+
+
+def backward(q, k, v, o, M, do, sm_scale):
+    assert do.is_contiguous()
+    assert q.stride() == k.stride() == v.stride() == o.stride() == do.stride()
+    Z, H, N_CTX, Lk = q.shape
+    dq = torch.empty_like(q)
+    dk = torch.empty_like(k)
+    dv = torch.empty_like(v)
+    BLOCK_M = 64
+    BLOCK_N = 64
+    PRE_BLOCK = 128
+    num_warps = 8
+    num_stages = 2
+    assert N_CTX % PRE_BLOCK == 0 and N_CTX % BLOCK_M == 0 and N_CTX % BLOCK_N == 0
+    delta = torch.empty_like(M)
+    pre_grid = (N_CTX // PRE_BLOCK, Z * H)
+    _attn_bwd_preprocess[pre_grid](
+        o, do, delta,  #
+        N_CTX=N_CTX,  #
+        BLOCK_M=PRE_BLOCK, BLOCK_DMODEL=Lk  #
+    )
+    grid = (N_CTX // BLOCK_N, 1, Z * H)
+    _attn_bwd_dkdv[grid](
+        q, k, v, sm_scale, do, dk, dv, M, delta,  #
+        q.stride(0), q.stride(1), q.stride(2), q.stride(3),  #
+        H=H, N_CTX=N_CTX,  #
+        BLOCK_M=BLOCK_M,  #
+        BLOCK_N=BLOCK_N,  #
+        BLOCK_DMODEL=Lk,  #
+        num_warps=num_warps,  #
+        num_stages=num_stages  #
+    )
+    grid = (N_CTX // BLOCK_M, 1, Z * H)
+    _attn_bwd_dq[grid](
+        q, k, v, sm_scale, do, dq, M, delta,  #
+        q.stride(0), q.stride(1), q.stride(2), q.stride(3),  #
+        H=H, N_CTX=N_CTX,  #
+        BLOCK_M=BLOCK_M,  #
+        BLOCK_N=BLOCK_N,  #
+        BLOCK_DMODEL=Lk,  #
+        num_warps=num_warps,  #
+        num_stages=num_stages  #
+    )
+    return dq, dk, dv
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['Z', 'H', 'N_CTX', 'D_HEAD'],
+        x_vals=[  #
+            [1, 32, 16384, 64],  #
+            [2, 32, 8192, 64],  #
+            [4, 32, 4096, 64],  #
+            [4, 48, 1024, 64],  #
+            [8, 32, 2048, 64],  #
+            [16, 32, 1024, 64],  #
+            [32, 32, 512, 64]  #
+        ],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton', 'onednn'],
+        # label name for the lines
+        line_names=['Triton', 'OneDNN'],
+        # line styles
+        styles=[('green', '-'), ('green', '--'), ('blue', '-'), ('blue', '--')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='attn-bwd-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(Z, H, N_CTX, D_HEAD, provider):
+    causal = False
+    dtype = torch.float16
+    q = torch.randn((Z, H, N_CTX, D_HEAD), device='xpu', dtype=dtype, requires_grad=True)
+    k = torch.randn((Z, H, N_CTX, D_HEAD), device='xpu', dtype=dtype, requires_grad=True)
+    v = torch.randn((Z, H, N_CTX, D_HEAD), device='xpu', dtype=dtype, requires_grad=True)
+    do = torch.randn((Z, H, N_CTX, D_HEAD), device='xpu', dtype=dtype)
+    sm_scale = 0.125
+    quantiles = [0.5, 0.0, 1.0]
+    if provider == 'onednn':
+        o = torch.nn.functional.scaled_dot_product_attention(q, k, v, attn_mask=None, dropout_p=0.0, is_causal=False,
+                                                             scale=sm_scale)
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(lambda: o.backward(do, retain_graph=True), warmup=10,
+                                                              rep=10, quantiles=quantiles, fast_flush=False)
+
+    elif provider == 'triton':
+        with torch.no_grad():
+            o, M = forward(q, k, v, causal, sm_scale, return_m=True)
+        triton_fn = lambda: backward(q, k, v, o, M, do, sm_scale)
+        if benchmark_suit.USE_IPEX_OPTION:
+            torch_o = torch.nn.functional.scaled_dot_product_attention(q, k, v, attn_mask=None, dropout_p=0.0,
+                                                                       is_causal=False, scale=sm_scale)
+            torch_o.backward(do)
+            atol = 1e-1 if N_CTX == 16384 else 1e-2
+            for triton_grad, torch_grad, name in zip(triton_fn(), (q.grad, k.grad, v.grad), ('dq', 'dk', 'dv')):
+                benchmark_suit.assert_close(triton_grad, torch_grad, atol=atol, rtol=1e-3,
+                                            err_msg=f'triton to torch ({name})')
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                              fast_flush=False)
+
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    # As usual, the backward pass is counted as 2.5 times the flops of the forward pass (recomputation excluded).
+    tflops = lambda mean: 2.5 * 2 * 2 * Z * H * N_CTX * N_CTX * D_HEAD * (1e-12) / (mean * 1e-3)
+    # Reads q, k, v, o and do, and writes dq, dk and dv.
+    gbps = lambda mean: Z * H * N_CTX * D_HEAD * 8 * 2 * (1e-9) / (mean * 1e-3)
+
+    return (gbps(mean), gbps(max_ms), gbps(min_ms)), (tflops(mean), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
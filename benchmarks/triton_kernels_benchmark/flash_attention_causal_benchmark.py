@@ -0,0 +1,209 @@
+"""
+Causal and Variable-Length Flash Attention
+==========================================
+
+Flash attention forward with a causal mask, over batches of sequences of the same length (causal) or of sequences of
+different lengths packed along the tokens (varlen). A persistent grid walks the work items of
+`triton.language.extra.intel.attention`: pairs of a heavy and a light query block, heaviest first, whose key loops
+skip the key blocks masked out entirely and only mask the ones crossing the diagonal.
+To compare the performance to the scaled dot product attention of PyTorch, one call per sequence for varlen.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+from triton.language.extra.intel import attention, streamk
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+# Programs of the persistent grid per Xe-core: at least two work-groups of the kernel fit in an Xe-core.
+PROGRAMS_PER_XE_CORE = 2
+
+
+@triton.jit
+def _attn_fwd_block(Q, K, V, Out, stride_t, q_block, seq_len, qk_scale,  #
+                    BLOCK_M: tl.constexpr, BLOCK_DMODEL: tl.constexpr, BLOCK_N: tl.constexpr,  #
+                    CAUSAL: tl.constexpr):
+    Q_block_ptr = tl.make_block_ptr(base=Q, shape=(seq_len, BLOCK_DMODEL), strides=(stride_t, 1),
+                                    offsets=(q_block * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    K_block_ptr = tl.make_block_ptr(base=K, shape=(BLOCK_DMODEL, seq_len), strides=(1, stride_t), offsets=(0, 0),
+                                    block_shape=(BLOCK_DMODEL, BLOCK_N), order=(0, 1))
+    V_block_ptr = tl.make_block_ptr(base=V, shape=(seq_len, BLOCK_DMODEL), strides=(stride_t, 1), offsets=(0, 0),
+                                    block_shape=(BLOCK_N, BLOCK_DMODEL), order=(1, 0))
+    O_block_ptr = tl.make_block_ptr(base=Out, shape=(seq_len, BLOCK_DMODEL), strides=(stride_t, 1),
+                                    offsets=(q_block * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_DMODEL), order=(1, 0))
+    offs_m = q_block * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    m_i = tl.zeros([BLOCK_M], dtype=tl.float32) - float('inf')
+    l_i = tl.zeros([BLOCK_M], dtype=tl.float32) + 1.0
+    acc = tl.zeros([BLOCK_M, BLOCK_DMODEL], dtype=tl.float32)
+    q = tl.load(Q_block_ptr, boundary_check=(0, ), padding_option='zero')
+    num_full, num_blocks = attention.kv_block_range(q_block, seq_len, BLOCK_M, BLOCK_N, CAUSAL)
+    # The key blocks visible to all the queries of the block, without mask.
+    for _ in range(0, num_full):
+        k = tl.load(K_block_ptr)
+        qk = tl.dot(q, k)
+        m_ij = tl.maximum(m_i, tl.max(qk, 1) * qk_scale)
+        qk = qk * qk_scale - m_ij[:, None]
+        p = tl.math.exp2(qk)
+        alpha = tl.math.exp2(m_i - m_ij)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        acc = acc * alpha[:, None]
+        v = tl.load(V_block_ptr)
+        acc += tl.dot(p.to(tl.float16), v)
+        m_i = m_ij
+        V_block_ptr = tl.advance(V_block_ptr, (BLOCK_N, 0))
+        K_block_ptr = tl.advance(K_block_ptr, (0, BLOCK_N))
+    # The key blocks crossing the diagonal or the end of the sequence.
+    for start_n in range(num_full * BLOCK_N, num_blocks * BLOCK_N, BLOCK_N):
+        k = tl.load(K_block_ptr, boundary_check=(1, ), padding_option='zero')
+        qk = tl.dot(q, k)
+        mask = (start_n + offs_n[None, :]) < seq_len
+        if CAUSAL:
+            mask = mask & (offs_m[:, None] >= (start_n + offs_n[None, :]))
+        qk = qk * qk_scale + tl.where(mask, 0, -1.0e6)
+        m_ij = tl.maximum(m_i, tl.max(qk, 1))
+        qk -= m_ij[:, None]
+        p = tl.math.exp2(qk)
+        alpha = tl.math.exp2(m_i - m_ij)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        acc = acc * alpha[:, None]
+        v = tl.load(V_block_ptr, boundary_check=(0, ), padding_option='zero')
+        acc += tl.dot(p.to(tl.float16), v)
+        m_i = m_ij
+        V_block_ptr = tl.advance(V_block_ptr, (BLOCK_N, 0))
+        K_block_ptr = tl.advance(K_block_ptr, (0, BLOCK_N))
+    acc = acc / l_i[:, None]
+    tl.store(O_block_ptr, acc.to(Out.type.element_ty), boundary_check=(0, ))
+
+
+@triton.jit
+def _attn_fwd(Q, K, V, sm_scale, Out, items_ptr, num_items,  #
+              stride_t, stride_h,  #
+              NUM_HEADS: tl.constexpr,  #
+              BLOCK_M: tl.constexpr, BLOCK_DMODEL: tl.constexpr, BLOCK_N: tl.constexpr,  #
+              CAUSAL: tl.constexpr):
+    # 1/log(2), to compute the softmax with exp2
+    qk_scale = sm_scale * 1.44269504
+    for item_id in range(tl.program_id(0), num_items, tl.num_programs(0)):
+        head, row_offset, seq_len, q_block_0, q_block_1 = attention.work_item(items_ptr, item_id, NUM_HEADS)
+        offset = row_offset.to(tl.int64) * stride_t + head * stride_h
+        _attn_fwd_block(Q + offset, K + offset, V + offset, Out + offset, stride_t, q_block_0, seq_len, qk_scale,
+                        BLOCK_M, BLOCK_DMODEL, BLOCK_N, CAUSAL)
+        if q_block_1 >= 0:
+            _attn_fwd_block(Q + offset, K + offset, V + offset, Out + offset, stride_t, q_block_1, seq_len, qk_scale,
+                            BLOCK_M, BLOCK_DMODEL, BLOCK_N, CAUSAL)
+
+
+def forward(q, k, v, seqlens, causal, sm_scale, schedule=None):
+    """
+    Attention of the sequences of `seqlens[i]` tokens each, packed into (total_tokens, num_heads, head_dim) `q`, `k`
+    and `v`. The schedule only depends on the lengths of the sequences, so that it can be built once and reused.
+    """
+    total_tokens, num_heads, Lk = q.shape
+    assert q.shape == k.shape and k.shape == v.shape and total_tokens == sum(seqlens)
+    assert q.stride() == k.stride() and k.stride() == v.stride() and q.stride(2) == 1
+    assert Lk in {16, 32, 64, 128}
+    o = torch.empty_like(q, dtype=torch.float32)
+    BLOCK_M = 128
+    BLOCK_N = 64 if Lk <= 64 else 32
+    num_stages = 4 if Lk <= 64 else 3
+    num_warps = 8 if Lk == 64 else 16
+    if schedule is None:
+        schedule = attention.attention_schedule(seqlens, num_heads, BLOCK_M, BLOCK_N, causal,
+                                                num_programs=streamk.num_xe_cores() * PROGRAMS_PER_XE_CORE,
+                                                device=q.device)
+    _attn_fwd[(schedule.num_programs, )](
+        q, k, v, sm_scale, o, schedule.items, schedule.num_items,  #
+        q.stride(0), q.stride(1),  #
+        NUM_HEADS=num_heads,  #
+        BLOCK_M=BLOCK_M,  #
+        BLOCK_DMODEL=Lk,  #
+        BLOCK_N=BLOCK_N,  #
+        CAUSAL=causal,  #
+        num_warps=num_warps,  #
+        num_stages=num_stages  #
+    )
+    return o
+
+
+def sequence_lengths(Z, N_CTX, varlen):
+    if not varlen:
+        return [N_CTX] * Z
+    # Lengths uniformly distributed in [N_CTX / 4, N_CTX], as in a batch of prompts.
+    generator = torch.Generator().manual_seed(0)
+    return torch.randint(N_CTX // 4, N_CTX + 1, (Z, ), generator=generator).tolist()
+
+
+def torch_attention(q, k, v, seqlens, sm_scale):
+    return torch.cat([
+        torch.nn.functional.scaled_dot_product_attention(q_i.transpose(0, 1), k_i.transpose(0, 1),
+                                                         v_i.transpose(0, 1), attn_mask=None, dropout_p=0.0,
+                                                         is_causal=True, scale=sm_scale).transpose(0, 1)
+        for q_i, k_i, v_i in zip(torch.split(q, seqlens), torch.split(k, seqlens), torch.split(v, seqlens))
+    ])
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['Z', 'H', 'N_CTX', 'D_HEAD', 'MODE'],
+        x_vals=[[z, h, n_ctx, 64, mode]
+                for mode in ['causal', 'varlen']
+                for z, h, n_ctx in [(1, 32, 16384), (4, 32, 4096), (8, 32, 2048), (16, 32, 1024), (32, 32, 512)]],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton', 'onednn'],
+        # label name for the lines
+        line_names=['Triton', 'OneDNN'],
+        # line styles
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='attn-causal-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(Z, H, N_CTX, D_HEAD, MODE, provider):
+    torch.manual_seed(0)
+    dtype = torch.float16
+    seqlens = sequence_lengths(Z, N_CTX, MODE == 'varlen')
+    total_tokens = sum(seqlens)
+    q = torch.randn((total_tokens, H, D_HEAD), device='xpu', dtype=dtype)
+    k = torch.randn((total_tokens, H, D_HEAD), device='xpu', dtype=dtype)
+    v = torch.randn((total_tokens, H, D_HEAD), device='xpu', dtype=dtype)
+    sm_scale = 0.125
+    quantiles = [0.5, 0.0, 1.0]
+    if provider == 'onednn':
+        onednn_fn = lambda: torch_attention(q, k, v, seqlens, sm_scale)
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(onednn_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                              fast_flush=False)
+
+    elif provider == 'triton':
+        BLOCK_N = 64 if D_HEAD <= 64 else 32
+        schedule = attention.attention_schedule(seqlens, H, 128, BLOCK_N,
+                                                num_programs=streamk.num_xe_cores() * PROGRAMS_PER_XE_CORE,
+                                                device=q.device)
+        triton_fn = lambda: forward(q, k, v, seqlens, True, sm_scale, schedule)
+        benchmark_suit.assert_close(triton_fn(), torch_attention(q, k, v, seqlens, sm_scale).to(torch.float32),
+                                    atol=1e-2, rtol=1e-3, err_msg='triton to torch')
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                              fast_flush=False)
+
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    # Under the causal mask, the i-th query of a sequence attends to i + 1 keys.
+    num_scores = sum(seq_len * (seq_len + 1) // 2 for seq_len in seqlens)
+    tflops = lambda mean: 2 * 2 * H * num_scores * D_HEAD * (1e-12) / (mean * 1e-3)
+    gbps = lambda mean: H * (total_tokens * D_HEAD + total_tokens * D_HEAD) * 2 * 2 * (1e-9) / (mean * 1e-3)
+
+    return (gbps(mean), gbps(max_ms), gbps(min_ms)), (tflops(mean), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
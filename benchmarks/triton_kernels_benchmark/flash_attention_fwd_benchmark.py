@@ -146,12 +146,13 @@ def _attn_fwd(Q, K, V, sm_scale, M, Out,  #
     # epilogue
     m_i += tl.math.log2(l_i)
     acc = acc / l_i[:, None]
-    # m_ptrs = M + off_hz * N_CTX + offs_m
-    # tl.store(m_ptrs, m_i)
+    # the log2 based logsumexp of each row is used by the backward pass
+    m_ptrs = M + (off_z * H + off_h) * N_CTX + offs_m
+    tl.store(m_ptrs, m_i)
     tl.store(O_block_ptr, acc.to(Out.type.element_ty))
 
 
-def forward(q, k, v, causal, sm_scale):
+def forward(q, k, v, causal, sm_scale, return_m=False):
     # shape constraints
     Lq, Lk, Lv = q.shape[-1], k.shape[-1], v.shape[-1]
     assert Lq == Lk and Lk == Lv
@@ -180,6 +181,8 @@ def forward(q, k, v, causal, sm_scale):
         num_warps=num_warps,  #
         num_stages=num_stages  #
     )
+    if return_m:
+        return o, M
     return o
 
 
@@ -0,0 +1,147 @@
+"""
+Fused Norm + Quantize
+=====================
+
+RMSNorm or LayerNorm of bf16 tokens, followed by the dynamic per-token quantization of the normalized tokens to int8 or
+fp8, as in front of a quantized GEMM. Each program normalizes and quantizes one row in registers, so the tokens are
+read once and only the quantized tokens and their scales are written.
+To compare the performance to the separate norm and quantization kernels of oneDNN and PyTorch.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+from triton.language.extra.intel import libdevice
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+EPS = 1e-6
+
+QUANT_DTYPES = {
+    'int8': torch.int8,
+    'fp8': torch.float8_e4m3fn,
+}
+
+
+@triton.autotune(
+    configs=[triton.Config({'threads_per_warp': 16}, num_warps=w) for w in [4, 8, 16, 32]] +
+    [triton.Config({'threads_per_warp': 32}, num_warps=w) for w in [4, 8, 16]],
+    key=['BLOCK_SIZE_N', 'IS_RMS_NORM'],
+)
+@triton.jit
+def norm_quant_kernel(x_ptr, w_ptr, b_ptr, y_ptr, scale_ptr, stride_x, stride_y, N, eps, QMAX: tl.constexpr,
+                      ROUND: tl.constexpr, IS_RMS_NORM: tl.constexpr, BLOCK_SIZE_N: tl.constexpr):
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK_SIZE_N)
+    mask = cols < N
+    x = tl.load(x_ptr + row * stride_x + cols, mask=mask, other=0.0).to(tl.float32)
+    w = tl.load(w_ptr + cols, mask=mask, other=0.0).to(tl.float32)
+    if IS_RMS_NORM:
+        var = tl.sum(x * x, axis=0) / N
+        y = x * tl.math.rsqrt(var + eps) * w
+    else:
+        mean = tl.sum(x, axis=0) / N
+        x = tl.where(mask, x - mean, 0.0)
+        var = tl.sum(x * x, axis=0) / N
+        b = tl.load(b_ptr + cols, mask=mask, other=0.0).to(tl.float32)
+        y = x * tl.math.rsqrt(var + eps) * w + b
+    # The scale maps the largest magnitude of the token to the largest value of the quantized type.
+    amax = tl.max(tl.where(mask, tl.abs(y), 0.0), axis=0)
+    scale = tl.maximum(amax, 1e-12) / QMAX
+    q = y / scale
+    if ROUND:
+        q = libdevice.rint(q)
+    q = tl.minimum(tl.maximum(q, -QMAX), QMAX)
+    tl.store(y_ptr + row * stride_y + cols, q.to(y_ptr.dtype.element_ty), mask=mask)
+    tl.store(scale_ptr + row, scale)
+
+
+def qmax(dtype):
+    return torch.iinfo(dtype).max if not dtype.is_floating_point else torch.finfo(dtype).max
+
+
+def norm_quant(x, weight, bias, dtype):
+    M, N = x.shape
+    y = torch.empty((M, N), device=x.device, dtype=dtype)
+    scales = torch.empty((M, ), device=x.device, dtype=torch.float32)
+    norm_quant_kernel[(M, )](x, weight, bias if bias is not None else weight, y, scales, x.stride(0), y.stride(0), N,
+                             EPS, QMAX=qmax(dtype), ROUND=not dtype.is_floating_point, IS_RMS_NORM=bias is None,
+                             BLOCK_SIZE_N=triton.next_power_of_2(N))
+    return y, scales
+
+
+def torch_norm(x, weight, bias):
+    if bias is None:
+        x32 = x.float()
+        return (x32 * torch.rsqrt(x32.pow(2).mean(dim=-1, keepdim=True) + EPS) * weight.float()).to(x.dtype)
+    return torch.nn.functional.layer_norm(x, (x.shape[-1], ), weight, bias, EPS)
+
+
+def torch_quant(y, dtype):
+    y = y.float()
+    scales = y.abs().amax(dim=-1).clamp(min=1e-12) / qmax(dtype)
+    q = y / scales[:, None]
+    if not dtype.is_floating_point:
+        q = q.round()
+    return q.clamp(-qmax(dtype), qmax(dtype)).to(dtype), scales
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=['M', 'N', 'norm', 'dtype'],
+        x_vals=[[4096, n, norm, dtype]
+                for norm in ['rms', 'layer']
+                for dtype in ['int8', 'fp8']
+                for n in [1024, 2048, 4096, 5120, 8192]],
+        line_arg='provider',
+        line_vals=['triton', 'onednn'],
+        line_names=['Triton', 'OneDNN'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],
+        plot_name='norm-quant-performance',
+        args={},
+    ))
+def benchmark(M, N, norm, dtype, provider):
+    torch.manual_seed(0)
+    x = torch.randn((M, N), device='xpu', dtype=torch.bfloat16)
+    weight = torch.rand((N, ), device='xpu', dtype=torch.bfloat16) + 0.5
+    bias = torch.randn((N, ), device='xpu', dtype=torch.bfloat16) if norm == 'layer' else None
+    quant_dtype = QUANT_DTYPES[dtype]
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        triton_fn = lambda: norm_quant(x, weight, bias, quant_dtype)
+        q, scales = triton_fn()
+        q_ref, scales_ref = torch_quant(
+            torch_norm(x.float(), weight.float(), bias.float() if bias is not None else None), quant_dtype)
+        benchmark_suit.assert_close(scales, scales_ref, atol=1e-3, rtol=1e-2, err_msg='triton to torch scales')
+        # The quantized values may differ by one step of the quantized type, where the reference rounds differently.
+        benchmark_suit.assert_close(q.float() * scales[:, None], q_ref.float() * scales_ref[:, None],
+                                    atol=scales_ref.max().item(), rtol=0.07, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    elif provider == 'onednn':
+        # Reference: the norm and the quantization as separate kernels, through HBM.
+        onednn_fn = lambda: torch_quant(torch_norm(x, weight, bias), quant_dtype)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(onednn_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    # The minimal traffic of the fused kernel: the bf16 tokens and parameters read once, the quantized tokens and their
+    # fp32 scales written once.
+    num_params = 2 if norm == 'layer' else 1
+    num_bytes = M * N * x.element_size() + num_params * N * x.element_size() + M * N * 1 + M * 4
+    gbps = lambda ms: num_bytes * 1e-9 / (ms * 1e-3)
+    # Square and sum (twice for the mean of LayerNorm), scale, affine, abs-max and quantize.
+    flops_per_element = 8 if norm == 'layer' else 6
+    tflops = lambda ms: flops_per_element * M * N * 1e-12 / (ms * 1e-3)
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
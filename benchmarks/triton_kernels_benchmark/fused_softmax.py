@@ -10,6 +10,7 @@ To compare the performance to XeTLA kernel.
 import torch
 import triton
 import triton.language as tl
+from triton.language.extra.intel import softmax as online_softmax
 from triton.runtime import driver
 
 import triton_kernels_benchmark as benchmark_suit
@@ -158,5 +159,49 @@ def benchmark(M, N, provider):
     return (gbps(mean), gbps(max_ms), gbps(min_ms)), (tflops(mean), tflops(max_ms), tflops(min_ms)), cv
 
 
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=["N"],
+        x_vals=[1024 * 32, 1024 * 64, 1024 * 128, 1024 * 256],
+        line_arg="provider",
+        line_vals=["triton", "triton-cross-entropy", "torch"],
+        line_names=["Triton", "Triton-Cross-Entropy", "Torch"],
+        styles=[("blue", "-"), ("orange", "-"), ("green", "-")],
+        ylabel=["GB/s", "TFlops"],
+        plot_name="long-row-softmax-performance",
+        args={"M": 256},
+    ))
+def benchmark_long_rows(M, N, provider):
+    # Rows of vocabulary size, which do not fit in the registers of a program.
+    x = torch.randn(M, N, device="xpu", dtype=torch.bfloat16)
+    quantiles = [0.5, 0.0, 1.0]
+    # The online softmax reads each row twice, and writes it once.
+    num_accesses = 3
+    if provider == "triton":
+        out = torch.empty_like(x, device="xpu")
+        triton_fn = lambda: online_softmax.softmax(x, out)
+        torch_fn = lambda: torch.softmax(x, axis=-1)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), err_msg="triton to torch")
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(triton_fn, quantiles=quantiles, warmup=10, rep=10)
+    elif provider == "triton-cross-entropy":
+        # The cross-entropy only reads the logits once.
+        num_accesses = 1
+        target = torch.randint(0, N, (M, ), device="xpu")
+        triton_fn = lambda: online_softmax.cross_entropy(x, target)
+        torch_fn = lambda: torch.nn.functional.cross_entropy(x.float(), target, reduction="none")
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-3, rtol=1e-3, err_msg="triton to torch")
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(triton_fn, quantiles=quantiles, warmup=10, rep=10)
+    elif provider == "torch":
+        _, min_ms, max_ms, mean, cv = benchmark_suit.do_bench(lambda: torch.softmax(x, axis=-1), quantiles=quantiles,
+                                                              warmup=10, rep=10)
+    else:
+        raise NotImplementedError(f"Unsupported provider {provider}")
+
+    gbps = lambda mean: num_accesses * x.nelement() * x.element_size() * 1e-9 / (mean * 1e-3)
+    tflops = lambda mean: 4 * x.nelement() * 1e-12 / (mean * 1e-3)
+    return (gbps(mean), gbps(max_ms), gbps(min_ms)), (tflops(mean), tflops(max_ms), tflops(min_ms)), cv
+
+
 if __name__ == "__main__":
     benchmark.run(show_plots=False, print_data=True)
+    benchmark_long_rows.run(show_plots=False, print_data=True)
@@ -0,0 +1,153 @@
+"""
+Block sparse GEMM benchmark
+===========================
+
+The GEMM of a block sparse (BSR) matrix A, e.g. the weights of a model pruned by blocks of 32x32 or 64x64 elements,
+by a dense matrix B. The K loop of a program only visits the nonzero blocks of its row of blocks of A, whose columns
+are read from the block table: the block pointers are rebased on each iteration, and the number of iterations differs
+between rows. To compare the performance to the dense GEMM of `gemm_benchmark` at several densities.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+
+import triton_kernels_benchmark as benchmark_suit
+import gemm_benchmark
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.autotune(
+    configs=[
+        triton.Config({'BLOCK_SIZE_N': n, 'grf_mode': 'large'}, num_stages=s, num_warps=w)
+        for n, w in [(256, 16), (256, 32), (512, 32)]
+        for s in [2, 3]
+    ],
+    key=['N', 'K', 'BLOCK_SIZE'],
+)
+@triton.jit
+def bsr_matmul_kernel(
+        # The nonzero blocks of A, their columns and the first block of each row of blocks, as `torch.sparse_bsr`.
+        a_values_ptr, a_col_ptr, a_crow_ptr,
+        # Pointers to the dense matrices
+        b_ptr, c_ptr,
+        # Matrix dimensions
+        M, N: tl.constexpr, K: tl.constexpr,
+        # Stride variables
+        stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
+        stride_cm: tl.constexpr, stride_cn: tl.constexpr,
+        # Meta-parameters
+        BLOCK_SIZE: tl.constexpr, BLOCK_SIZE_N: tl.constexpr):
+    pid_m = tl.program_id(axis=0)
+    pid_n = tl.program_id(axis=1)
+    start = tl.load(a_crow_ptr + pid_m)
+    end = tl.load(a_crow_ptr + pid_m + 1)
+
+    accumulator = tl.zeros((BLOCK_SIZE, BLOCK_SIZE_N), dtype=tl.float32)
+    for i in range(start, end):
+        col = tl.load(a_col_ptr + i)
+        a_block_ptr = tl.make_block_ptr(base=a_values_ptr + i * BLOCK_SIZE * BLOCK_SIZE,
+                                        shape=(BLOCK_SIZE, BLOCK_SIZE), strides=(BLOCK_SIZE, 1), offsets=(0, 0),
+                                        block_shape=(BLOCK_SIZE, BLOCK_SIZE), order=(1, 0))
+        b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                        offsets=(col * BLOCK_SIZE, pid_n * BLOCK_SIZE_N),
+                                        block_shape=(BLOCK_SIZE, BLOCK_SIZE_N), order=(1, 0))
+        a = tl.load(a_block_ptr)
+        b = tl.load(b_block_ptr, boundary_check=(1, ))
+        accumulator += tl.dot(a, b)
+
+    c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, stride_cn),
+                                    offsets=(pid_m * BLOCK_SIZE, pid_n * BLOCK_SIZE_N),
+                                    block_shape=(BLOCK_SIZE, BLOCK_SIZE_N), order=(1, 0))
+    tl.store(c_block_ptr, accumulator, boundary_check=(0, 1))
+
+
+def bsr_matmul(a_values, a_col, a_crow, b, M, block_size):
+    K, N = b.shape
+    assert b.is_contiguous(), 'Matrix B must be contiguous'
+    assert M % block_size == 0 and K % block_size == 0, 'Expecting whole blocks of A'
+    c = torch.empty((M, N), device=b.device, dtype=torch.float32)
+    grid = lambda META: (M // block_size, triton.cdiv(N, META['BLOCK_SIZE_N']))
+    bsr_matmul_kernel[grid](
+        a_values, a_col, a_crow,  #
+        b, c,  #
+        M, N, K,  #
+        b.stride(0), b.stride(1),  #
+        c.stride(0), c.stride(1),  #
+        BLOCK_SIZE=block_size)
+    return c
+
+
+def random_bsr(M, K, block_size, density, dtype):
+    """
+    Return a random (M, K) matrix whose blocks of `block_size` x `block_size` elements are nonzero with probability
+    `density`, dense and as the nonzero blocks, their columns and the first block of each row of blocks.
+    """
+    mask = torch.rand((M // block_size, K // block_size), device='xpu') < density
+    dense = torch.zeros((M, K), device='xpu', dtype=dtype)
+    blocks = dense.view(M // block_size, block_size, K // block_size, block_size).permute(0, 2, 1, 3)
+    blocks[mask] = torch.randn((int(mask.sum()), block_size, block_size), device='xpu', dtype=dtype)
+    a_values = blocks[mask].contiguous()
+    a_col = mask.nonzero()[:, 1].to(torch.int32)
+    a_crow = torch.zeros((M // block_size + 1, ), device='xpu', dtype=torch.int32)
+    a_crow[1:] = torch.cumsum(mask.sum(dim=1), dim=0)
+    return dense, a_values, a_col, a_crow
+
+
+# Benchmark Performance
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['M', 'K', 'N', 'BS', 'density'],
+        x_vals=[[size, size, size, block_size, density]  #
+                for size in [4096, 8192]  #
+                for block_size in [32, 64]  #
+                for density in [0.5, 0.25, 0.1]],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton', 'triton-dense'],
+        # label name for the lines
+        line_names=['Triton', 'Triton-Dense'],
+        # line styles
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='matmul-bsr-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(M, K, N, BS, density, provider):
+    torch.manual_seed(0)
+    a, a_values, a_col, a_crow = random_bsr(M, K, BS, density, torch.bfloat16)
+    b = torch.rand((K, N), device='xpu', dtype=torch.bfloat16)
+    nnz_blocks = a_values.shape[0]
+
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        triton_fn = lambda: bsr_matmul(a_values, a_col, a_crow, b, M, BS)
+        torch_fn = lambda: torch.matmul(a, b).to(torch.float32)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-1, rtol=1e-2, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+        a_bytes = nnz_blocks * BS * BS * 2 + (a_col.numel() + a_crow.numel()) * 4
+    elif provider == 'triton-dense':
+        triton_fn = lambda: gemm_benchmark.matmul(a, b)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+        a_bytes = M * K * 2
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    # The throughput of the dense GEMM the block sparse one replaces, so that both providers compare by time.
+    tflops = lambda ms: 2 * M * N * K * (1e-12) / (ms * 1e-3)
+    gbps = lambda ms: (a_bytes + 2 * K * N + 4.0 * M * N) * (1e-9) / (ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
@@ -0,0 +1,170 @@
+"""
+Grouped GEMM benchmark
+======================
+The experts of a mixture-of-experts layer compute independent GEMMs with a
+different number of tokens (rows) each. This benchmark compares a grouped GEMM,
+which walks the output tiles of all the experts with a single persistent grid,
+with one GEMM launch per expert and with a batched GEMM of the experts padded
+to the largest number of rows.
+"""
+
+import torch
+import triton
+import triton.language as tl
+from triton.language.extra.intel import grouped, streamk
+
+import triton_kernels_benchmark as benchmark_suit
+from gemm_benchmark import matmul as gemm
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def grouped_matmul_kernel(
+        # Pointers to matrices
+        a_ptr, b_ptr, c_ptr,
+        # Problem table
+        problems_ptr, num_tiles,
+        # Matrix dimensions
+        N: tl.constexpr, K: tl.constexpr,  #
+        stride_am: tl.constexpr, stride_ak: tl.constexpr,  #
+        stride_be: tl.constexpr, stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
+        stride_cm: tl.constexpr, stride_cn: tl.constexpr,
+        # Meta-parameters
+        BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr, BLOCK_SIZE_K: tl.constexpr,
+        MAX_PROBLEMS: tl.constexpr):
+    for tile_id in range(tl.program_id(axis=0), num_tiles, tl.num_programs(axis=0)):
+        expert, row_offset, M, pid_m, pid_n = grouped.problem_tile(problems_ptr, tile_id, N, BLOCK_SIZE_M,
+                                                                   BLOCK_SIZE_N, MAX_PROBLEMS)
+        a_expert_ptr = a_ptr + row_offset.to(tl.int64) * stride_am
+        b_expert_ptr = b_ptr + expert.to(tl.int64) * stride_be
+        c_expert_ptr = c_ptr + row_offset.to(tl.int64) * stride_cm
+        acc = streamk.mac_loop(a_expert_ptr, b_expert_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m,
+                               pid_n, 0, tl.cdiv(K, BLOCK_SIZE_K), BLOCK_SIZE_M, BLOCK_SIZE_N, BLOCK_SIZE_K)
+        streamk.store_tile(c_expert_ptr, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, True, BLOCK_SIZE_M,
+                           BLOCK_SIZE_N)
+
+
+# ---------------------------------------------------------------------------
+# Wrapper
+# ---------------------------------------------------------------------------
+
+
+def grouped_matmul(a: torch.Tensor, b: torch.Tensor, group_m, schedule=None):
+    """
+    Multiply the rows of `a` of each expert, `group_m[i]` rows for expert `i`,
+    by the (K, N) matrix `b[i]` of the expert.
+    """
+    BLOCK_SIZE_M = 128
+    BLOCK_SIZE_N = 256
+    BLOCK_SIZE_K = 32
+
+    # Check constraints.
+    assert a.shape[0] == sum(group_m), 'Incompatible number of rows'
+    assert a.shape[1] == b.shape[1], 'Incompatible dimensions'
+    assert b.shape[0] == len(group_m), 'Incompatible number of experts'
+    assert a.is_contiguous(), 'Matrix A must be contiguous'
+    assert b.is_contiguous(), 'Matrix B must be contiguous'
+    _, K = a.shape
+    _, _, N = b.shape
+
+    if schedule is None:
+        schedule = grouped.grouped_gemm_schedule(group_m, N, BLOCK_SIZE_M, BLOCK_SIZE_N, device=a.device)
+    c = torch.empty((a.shape[0], N), device=a.device, dtype=torch.float32)
+    grouped_matmul_kernel[(schedule.num_programs, )](
+        a, b, c,  #
+        schedule.problems, schedule.num_tiles,  #
+        N, K,  #
+        a.stride(0), a.stride(1),  #
+        b.stride(0), b.stride(1), b.stride(2),  #
+        c.stride(0), c.stride(1),  #
+        BLOCK_SIZE_M, BLOCK_SIZE_N, BLOCK_SIZE_K, schedule.max_problems,  #
+        num_warps=32, num_stages=2, grf_mode='large')
+    return c
+
+
+def per_expert_matmul(a: torch.Tensor, b: torch.Tensor, group_m):
+    """Launch one GEMM per expert."""
+    return torch.cat([gemm(a_expert, b_expert) for a_expert, b_expert in zip(torch.split(a, group_m), b)])
+
+
+def padded_matmul(a: torch.Tensor, b: torch.Tensor, group_m):
+    """Launch a batched GEMM of the experts padded to the largest number of rows."""
+    a_padded = torch.zeros((len(group_m), max(group_m), a.shape[1]), device=a.device, dtype=a.dtype)
+    for expert, a_expert in enumerate(torch.split(a, group_m)):
+        a_padded[expert, :a_expert.shape[0]] = a_expert
+    c_padded = gemm(a_padded, b)
+    return torch.cat([c_padded[expert, :m] for expert, m in enumerate(group_m)])
+
+
+def expert_rows(E, T, skew):
+    """
+    Distribute `T` tokens over `E` experts, the number of tokens of the experts
+    decreasing geometrically by `skew`, as for the imbalanced routing of a
+    mixture-of-experts layer.
+    """
+    weights = [skew**expert for expert in range(E)]
+    group_m = [int(T * weight / sum(weights)) for weight in weights]
+    group_m[0] += T - sum(group_m)
+    return group_m
+
+
+# Benchmark Performance
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['E', 'T', 'K', 'N', 'skew'],
+        # different possible values for `x_name`
+        x_vals=[[8, 4096, 4096, 14336, skew] for skew in [1.0, 0.8, 0.5]] +  #
+        [[8, 512, 4096, 14336, skew] for skew in [1.0, 0.5]] +  #
+        [[64, 8192, 2048, 1408, skew] for skew in [1.0, 0.9]] +  #
+        [[128, 16384, 4096, 1536, 0.97]],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton', 'triton-per-expert', 'triton-padded'],
+        # label name for the lines
+        line_names=['Triton', 'Triton-per-expert', 'Triton-padded'],
+        # line styles
+        styles=[('green', '-'), ('blue', '-'), ('red', '-')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='matmul-grouped-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(E, T, K, N, skew, provider):
+    torch.manual_seed(0)
+    group_m = expert_rows(E, T, skew)
+    a = torch.rand((T, K), device='xpu', dtype=torch.bfloat16)
+    b = torch.rand((E, K, N), device='xpu', dtype=torch.bfloat16)
+
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        # The problem table only depends on the routing, which is known before the experts run.
+        schedule = grouped.grouped_gemm_schedule(group_m, N, 128, 256, device=a.device)
+        triton_fn = lambda: grouped_matmul(a, b, group_m, schedule)
+    elif provider == 'triton-per-expert':
+        triton_fn = lambda: per_expert_matmul(a, b, group_m)
+    elif provider == 'triton-padded':
+        triton_fn = lambda: padded_matmul(a, b, group_m)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    torch_fn = lambda: torch.cat([
+        torch.matmul(a_expert, b_expert).to(torch.float32) for a_expert, b_expert in zip(torch.split(a, group_m), b)
+    ])
+    benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-4, rtol=1e-2, err_msg='triton to torch')
+    _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                             fast_flush=False)
+
+    # Only the rows of the experts are useful work.
+    tflops = lambda ms: 2 * T * N * K * (1e-12) / (ms * 1e-3)
+    gbps = lambda ms: (2 * (T * K + E * K * N) + 4.0 * (T * N)) * (1e-9) / (ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
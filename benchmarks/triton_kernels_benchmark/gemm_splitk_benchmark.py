@@ -1,6 +1,7 @@
 import torch
 import triton
 import triton.language as tl
+from triton.language.extra.intel import streamk
 
 import triton_kernels_benchmark as benchmark_suit
 
@@ -16,7 +17,7 @@ if benchmark_suit.USE_IPEX_OPTION:
     key=['M', 'N', 'K'],
 )
 @triton.jit
-def _kernel(A, B, C,  #
+def _kernel(A, B, C, workspace, counters,  #
             M: tl.constexpr, N: tl.constexpr, K: tl.constexpr, stride_am: tl.constexpr, stride_ak: tl.constexpr,  #
             stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
             stride_cm: tl.constexpr, stride_cn: tl.constexpr,  #
@@ -50,24 +51,34 @@ def _kernel(A, B, C,  #
         acc += tl.dot(a, b, out_dtype=acc_dtype)
         a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K * SPLIT_K))
         b_block_ptr = tl.advance(b_block_ptr, (BLOCK_K * SPLIT_K, 0))
-    acc = acc.to(C.dtype.element_ty)
-    # handles write-back with reduction-splitting
-    if SPLIT_K == 1:
+    # handles write-back with reduction-splitting: the last split to finish a
+    # tile sums the partial tiles of all the splits in order and stores it
+    store = True
+    if SPLIT_K > 1:
+        acc, store = streamk.splitk_reduce(acc.to(tl.float32), workspace, counters, pid, pid_z, SPLIT_K)
+    if store:
         c_block_ptr = tl.make_block_ptr(base=C, shape=(M, N), strides=(stride_cm, stride_cn),
                                         offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
                                         order=(1, 0))
-        tl.store(c_block_ptr, acc, boundary_check=(0, 1))
-    else:
-        # rematerialize rm and rn to save registers
-        rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
-        rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
-        C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
-        mask = (rm < M)[:, None] & (rn < N)[None, :]
-        tl.atomic_add(C, acc, mask=mask)
+        tl.store(c_block_ptr, acc.to(C.dtype.element_ty), boundary_check=(0, 1))
 
 
 class _matmul(torch.autograd.Function):
     kernel = _kernel
+    workspaces = {}
+
+    @staticmethod
+    def _workspace(M, N, device):
+        # The workspace of the partial tiles fits all the autotuned configs.
+        # Its counters are reset by the kernel, so it is reused by the launches.
+        if (M, N, device) not in _matmul.workspaces:
+            tiles = [(triton.cdiv(M, c.kwargs['BLOCK_M']) * triton.cdiv(N, c.kwargs['BLOCK_N']), c.kwargs)
+                     for c in _kernel.configs]
+            workspace = torch.empty(max(n * kw['SPLIT_K'] * kw['BLOCK_M'] * kw['BLOCK_N'] for n, kw in tiles),
+                                    device=device, dtype=torch.float32)
+            counters = torch.zeros(max(n for n, _ in tiles), device=device, dtype=torch.int32)
+            _matmul.workspaces[(M, N, device)] = (workspace, counters)
+        return _matmul.workspaces[(M, N, device)]
 
     @staticmethod
     def _call(a, b, acc_dtype, output_dtype):
@@ -109,8 +120,9 @@ class _matmul(torch.autograd.Function):
 
         # launch kernel
         grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
+        workspace, counters = _matmul._workspace(M, N, device)
         _kernel[grid](
-            a, b, c, M, N, K,  #
+            a, b, c, workspace, counters, M, N, K,  #
             a.stride(0), a.stride(1),  #
             b.stride(0), b.stride(1),  #
             c.stride(0), c.stride(1),  #
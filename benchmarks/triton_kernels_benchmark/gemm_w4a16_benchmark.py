@@ -0,0 +1,202 @@
+"""
+Gemm W4A16 benchmark
+============================
+
+Weight-only quantized GEMM: fp16 activations times uint4 weights packed two per byte along K,
+with one fp16 scale and zero point per group of `GROUP_SIZE` rows of K.
+The weights are dequantized in registers right before the dot.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+GROUP_SIZE = 128
+
+
+@triton.autotune(
+    configs=[
+        triton.Config(
+            {'BLOCK_SIZE_M': 256, 'BLOCK_SIZE_N': 256, 'BLOCK_SIZE_K': 32, 'GROUP_SIZE_M': 4, 'grf_mode': 'large'},
+            num_stages=s, num_warps=32) for s in [2, 3]
+    ] + [
+        triton.Config(
+            {'BLOCK_SIZE_M': 64, 'BLOCK_SIZE_N': 128, 'BLOCK_SIZE_K': 32, 'GROUP_SIZE_M': 4, 'grf_mode': 'large'},
+            num_stages=s, num_warps=16) for s in [2]
+    ] + [
+        triton.Config(
+            {'BLOCK_SIZE_M': 8, 'BLOCK_SIZE_N': 512, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 1, 'grf_mode': 'large'},
+            num_stages=s, num_warps=32) for s in [2, 3]
+    ] + [
+        triton.Config(
+            {'BLOCK_SIZE_M': 8, 'BLOCK_SIZE_N': 128, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 1, 'grf_mode': 'large'},
+            num_stages=s, num_warps=4) for s in [2]
+    ],
+    key=['M', 'N', 'K'],
+)
+@triton.jit
+def matmul_kernel_w4a16(
+        # Pointers to matrices
+        a_ptr, b_ptr, scales_ptr, zeros_ptr, c_ptr,
+        # Matrix dimensions
+        M: tl.constexpr, N: tl.constexpr, K: tl.constexpr,
+        # Stride variables
+        stride_am: tl.constexpr, stride_ak: tl.constexpr,  #
+        stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
+        stride_sg: tl.constexpr, stride_sn: tl.constexpr,  #
+        stride_cm: tl.constexpr, stride_cn: tl.constexpr,
+        # Quantization group size along K
+        QGROUP_SIZE: tl.constexpr,
+        # Meta-parameters
+        BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr, BLOCK_SIZE_K: tl.constexpr, GROUP_SIZE_M: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    num_pid_m = tl.cdiv(M, BLOCK_SIZE_M)
+    num_pid_n = tl.cdiv(N, BLOCK_SIZE_N)
+    num_pid_in_group = GROUP_SIZE_M * num_pid_n
+    group_id = pid // num_pid_in_group
+    first_pid_m = group_id * GROUP_SIZE_M
+    group_size_m = min(num_pid_m - first_pid_m, GROUP_SIZE_M)
+    pid_m = first_pid_m + (pid % group_size_m)
+    pid_n = (pid % num_pid_in_group) // group_size_m
+
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                    offsets=(pid_m * BLOCK_SIZE_M, 0), block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_K),
+                                    order=(1, 0))
+
+    offs_k = tl.arange(0, BLOCK_SIZE_K)
+    offs_n = pid_n * BLOCK_SIZE_N + tl.arange(0, BLOCK_SIZE_N)
+    # Two consecutive rows of K share one byte: the even row is in the low nibble.
+    b_ptrs = b_ptr + (offs_k[:, None] // 2) * stride_bk + offs_n[None, :] * stride_bn
+    b_shift = ((offs_k % 2) * 4).to(tl.int8)[:, None]
+    mask_n = offs_n < N
+
+    accumulator = tl.zeros((BLOCK_SIZE_M, BLOCK_SIZE_N), dtype=tl.float32)
+    for k in range(0, K, BLOCK_SIZE_K):
+        a = tl.load(a_block_ptr, boundary_check=(0, 1))
+        b_packed = tl.load(b_ptrs, mask=mask_n[None, :], other=0)
+        g = k // QGROUP_SIZE
+        scales = tl.load(scales_ptr + g * stride_sg + offs_n * stride_sn, mask=mask_n, other=0.0)
+        zeros = tl.load(zeros_ptr + g * stride_sg + offs_n * stride_sn, mask=mask_n, other=0.0)
+        b = ((b_packed >> b_shift) & 0xF).to(tl.float16)
+        b = (b - zeros[None, :]) * scales[None, :]
+        accumulator += tl.dot(a, b)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_SIZE_K))
+        b_ptrs += (BLOCK_SIZE_K // 2) * stride_bk
+    c = accumulator.to(tl.float32)
+
+    c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, stride_cn),
+                                    offsets=(pid_m * BLOCK_SIZE_M, pid_n * BLOCK_SIZE_N),
+                                    block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_N), order=(1, 0))
+    tl.store(c_block_ptr, c, boundary_check=(0, 1))
+
+
+def pack_int4(q):
+    """Packs a (K, N) tensor of values in [0, 16) into a (K // 2, N) uint8 tensor along K."""
+    q = q.to(torch.uint8)
+    return (q[0::2, :] | (q[1::2, :] << 4)).contiguous()
+
+
+def dequantize(b_packed, scales, zeros, group_size):
+    K = b_packed.shape[0] * 2
+    q = torch.empty((K, b_packed.shape[1]), device=b_packed.device, dtype=torch.float16)
+    q[0::2, :] = (b_packed & 0xF).to(torch.float16)
+    q[1::2, :] = (b_packed >> 4).to(torch.float16)
+    scales = scales.repeat_interleave(group_size, dim=0)
+    zeros = zeros.repeat_interleave(group_size, dim=0)
+    return (q - zeros) * scales
+
+
+# We can now create a convenience wrapper function that only takes the input tensors,
+# and (1) checks any shape constraint; (2) allocates the output; (3) launches the above kernel.
+def matmul(a, b_packed, scales, zeros, group_size=GROUP_SIZE):
+    # Check constraints.
+    assert a.shape[1] == 2 * b_packed.shape[0], 'Incompatible dimensions'
+    assert a.is_contiguous(), 'Matrix A must be contiguous'
+    assert scales.shape == zeros.shape, 'Scales and zero points must have the same shape'
+    M, K = a.shape
+    N = b_packed.shape[1]
+    assert K % group_size == 0, 'K must be a multiple of the quantization group size'
+    # Allocates output.
+    c = torch.empty((M, N), device=a.device, dtype=torch.float32)
+    grid = lambda META: (triton.cdiv(M, META['BLOCK_SIZE_M']) * triton.cdiv(N, META['BLOCK_SIZE_N']), )
+    matmul_kernel_w4a16[grid](
+        a, b_packed.view(torch.int8), scales, zeros, c,  #
+        M, N, K,  #
+        a.stride(0), a.stride(1),  #
+        b_packed.stride(0), b_packed.stride(1),  #
+        scales.stride(0), scales.stride(1),  #
+        c.stride(0), c.stride(1),  #
+        group_size)
+    return c
+
+
+# Benchmark Performance
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['M', 'K', 'N'],
+        # different possible values for `x_name`
+        x_vals=[  #
+            [1, 4096, 4096],  #
+            [1, 4096, 11008],  #
+            [1, 5120, 13824],  #
+            [1, 8192, 28672],  #
+            [4, 4096, 12288],  #
+            [16, 4096, 4096],  #
+            [32, 8192, 8192],  #
+            [64, 4096, 11008],  #
+            [512, 8192, 8192],  #
+            [1024, 4096, 4096],  #
+        ],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton', 'onednn'],
+        # label name for the lines
+        line_names=['Triton', 'OneDNN'],
+        # line styles
+        styles=[('green', '-'), ('green', '--'), ('blue', '-'), ('blue', '--')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='matmul-w4a16-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(M, N, K, provider):
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device='xpu', dtype=torch.float16)
+    q = torch.randint(0, 16, (K, N), device='xpu', dtype=torch.uint8)
+    b_packed = pack_int4(q)
+    scales = torch.rand((K // GROUP_SIZE, N), device='xpu', dtype=torch.float16) * 0.02
+    zeros = torch.full((K // GROUP_SIZE, N), 8.0, device='xpu', dtype=torch.float16)
+    b = dequantize(b_packed, scales, zeros, GROUP_SIZE)
+
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'onednn':
+        # Reference: dequantize ahead of time and run the dense fp16 GEMM.
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(lambda: torch.matmul(a, b), warmup=10, rep=10,
+                                                                 quantiles=quantiles, fast_flush=False)
+    elif provider == 'triton':
+        triton_fn = lambda: matmul(a, b_packed, scales, zeros)
+        torch_fn = lambda: torch.matmul(a, b).to(torch.float32)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-2, rtol=1e-2, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    tflops = lambda ms: 2 * M * N * K * (1e-12) / (ms * 1e-3)
+    # Packed weights read by the kernel: half a byte per element plus the per-group scales and zero points.
+    gbps = lambda ms: (2 * M * K + K * N // 2 + 2 * 2 * (K // GROUP_SIZE) * N + 4.0 * M * N) * (1e-9) / (ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
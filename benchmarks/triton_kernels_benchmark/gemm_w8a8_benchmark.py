@@ -0,0 +1,243 @@
+"""
+Gemm W8A8 / W8A16 benchmark
+============================
+
+Int8 weight quantized GEMMs: bf16 activations times int8 weights, with one fp32 scale per output channel.
+W8A8 quantizes the activations to int8 in the kernel, with one dynamic scale per token, and runs the int8 DPAS with
+int32 accumulation. W8A16 converts the weights to bf16 in registers right before the bf16 DPAS.
+Both dequantize the accumulator in the epilogue.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+from triton.language.extra.intel import libdevice
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+CONFIGS = [
+    triton.Config(
+        {'BLOCK_SIZE_M': 256, 'BLOCK_SIZE_N': 256, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 4, 'grf_mode': 'large'},
+        num_stages=s, num_warps=32) for s in [2, 3]
+] + [
+    triton.Config(
+        {'BLOCK_SIZE_M': 64, 'BLOCK_SIZE_N': 128, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 4, 'grf_mode': 'large'},
+        num_stages=s, num_warps=16) for s in [2]
+] + [
+    triton.Config(
+        {'BLOCK_SIZE_M': 8, 'BLOCK_SIZE_N': 512, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 1, 'grf_mode': 'large'},
+        num_stages=s, num_warps=32) for s in [2, 3]
+] + [
+    triton.Config(
+        {'BLOCK_SIZE_M': 8, 'BLOCK_SIZE_N': 128, 'BLOCK_SIZE_K': 64, 'GROUP_SIZE_M': 1, 'grf_mode': 'large'},
+        num_stages=s, num_warps=4) for s in [2]
+]
+
+
+@triton.jit
+def tile_ids(M, N, BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr, GROUP_SIZE_M: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    num_pid_m = tl.cdiv(M, BLOCK_SIZE_M)
+    num_pid_n = tl.cdiv(N, BLOCK_SIZE_N)
+    num_pid_in_group = GROUP_SIZE_M * num_pid_n
+    group_id = pid // num_pid_in_group
+    first_pid_m = group_id * GROUP_SIZE_M
+    group_size_m = min(num_pid_m - first_pid_m, GROUP_SIZE_M)
+    pid_m = first_pid_m + (pid % group_size_m)
+    pid_n = (pid % num_pid_in_group) // group_size_m
+    return pid_m, pid_n
+
+
+@triton.autotune(configs=CONFIGS, key=['M', 'N', 'K'])
+@triton.jit
+def matmul_kernel_w8a8(
+        # Pointers to matrices
+        a_ptr, b_ptr, b_scales_ptr, c_ptr,
+        # Matrix dimensions
+        M: tl.constexpr, N: tl.constexpr, K: tl.constexpr,
+        # Stride variables
+        stride_am: tl.constexpr, stride_ak: tl.constexpr,  #
+        stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
+        stride_cm: tl.constexpr, stride_cn: tl.constexpr,
+        # Meta-parameters
+        BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr, BLOCK_SIZE_K: tl.constexpr, GROUP_SIZE_M: tl.constexpr):
+    pid_m, pid_n = tile_ids(M, N, BLOCK_SIZE_M, BLOCK_SIZE_N, GROUP_SIZE_M)
+
+    # The scale of each token maps the largest magnitude of its row of A to 127. The rows are read once more for it,
+    # which is cheap as A is much smaller than B in the memory bound shapes.
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                    offsets=(pid_m * BLOCK_SIZE_M, 0), block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_K),
+                                    order=(1, 0))
+    a_amax = tl.zeros((BLOCK_SIZE_M, ), dtype=tl.float32)
+    for _ in range(0, K, BLOCK_SIZE_K):
+        a = tl.load(a_block_ptr, boundary_check=(0, 1))
+        a_amax = tl.maximum(a_amax, tl.max(tl.abs(a.to(tl.float32)), axis=1))
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_SIZE_K))
+    a_scales = tl.maximum(a_amax, 1e-12) / 127
+
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                    offsets=(pid_m * BLOCK_SIZE_M, 0), block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_K),
+                                    order=(1, 0))
+    b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                    offsets=(0, pid_n * BLOCK_SIZE_N), block_shape=(BLOCK_SIZE_K, BLOCK_SIZE_N),
+                                    order=(1, 0))
+    accumulator = tl.zeros((BLOCK_SIZE_M, BLOCK_SIZE_N), dtype=tl.int32)
+    for _ in range(0, K, BLOCK_SIZE_K):
+        a = tl.load(a_block_ptr, boundary_check=(0, 1))
+        a = libdevice.rint(a.to(tl.float32) / a_scales[:, None]).to(tl.int8)
+        b = tl.load(b_block_ptr, boundary_check=(0, 1))
+        accumulator += tl.dot(a, b)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_SIZE_K))
+        b_block_ptr = tl.advance(b_block_ptr, (BLOCK_SIZE_K, 0))
+
+    offs_n = pid_n * BLOCK_SIZE_N + tl.arange(0, BLOCK_SIZE_N)
+    b_scales = tl.load(b_scales_ptr + offs_n, mask=offs_n < N, other=0.0)
+    c = accumulator.to(tl.float32) * a_scales[:, None] * b_scales[None, :]
+
+    c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, stride_cn),
+                                    offsets=(pid_m * BLOCK_SIZE_M, pid_n * BLOCK_SIZE_N),
+                                    block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_N), order=(1, 0))
+    tl.store(c_block_ptr, c, boundary_check=(0, 1))
+
+
+@triton.autotune(configs=CONFIGS, key=['M', 'N', 'K'])
+@triton.jit
+def matmul_kernel_w8a16(
+        # Pointers to matrices
+        a_ptr, b_ptr, b_scales_ptr, c_ptr,
+        # Matrix dimensions
+        M: tl.constexpr, N: tl.constexpr, K: tl.constexpr,
+        # Stride variables
+        stride_am: tl.constexpr, stride_ak: tl.constexpr,  #
+        stride_bk: tl.constexpr, stride_bn: tl.constexpr,  #
+        stride_cm: tl.constexpr, stride_cn: tl.constexpr,
+        # Meta-parameters
+        BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr, BLOCK_SIZE_K: tl.constexpr, GROUP_SIZE_M: tl.constexpr):
+    pid_m, pid_n = tile_ids(M, N, BLOCK_SIZE_M, BLOCK_SIZE_N, GROUP_SIZE_M)
+
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                    offsets=(pid_m * BLOCK_SIZE_M, 0), block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_K),
+                                    order=(1, 0))
+    b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                    offsets=(0, pid_n * BLOCK_SIZE_N), block_shape=(BLOCK_SIZE_K, BLOCK_SIZE_N),
+                                    order=(1, 0))
+    accumulator = tl.zeros((BLOCK_SIZE_M, BLOCK_SIZE_N), dtype=tl.float32)
+    for _ in range(0, K, BLOCK_SIZE_K):
+        a = tl.load(a_block_ptr, boundary_check=(0, 1))
+        # The int8 weights are exact in bf16, the per-channel scales are applied to the accumulator.
+        b = tl.load(b_block_ptr, boundary_check=(0, 1)).to(tl.bfloat16)
+        accumulator += tl.dot(a, b)
+        a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_SIZE_K))
+        b_block_ptr = tl.advance(b_block_ptr, (BLOCK_SIZE_K, 0))
+
+    offs_n = pid_n * BLOCK_SIZE_N + tl.arange(0, BLOCK_SIZE_N)
+    b_scales = tl.load(b_scales_ptr + offs_n, mask=offs_n < N, other=0.0)
+    c = accumulator * b_scales[None, :]
+
+    c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, stride_cn),
+                                    offsets=(pid_m * BLOCK_SIZE_M, pid_n * BLOCK_SIZE_N),
+                                    block_shape=(BLOCK_SIZE_M, BLOCK_SIZE_N), order=(1, 0))
+    tl.store(c_block_ptr, c, boundary_check=(0, 1))
+
+
+# We can now create a convenience wrapper function that only takes the input tensors,
+# and (1) checks any shape constraint; (2) allocates the output; (3) launches the above kernel.
+def matmul(a, b, b_scales, kernel):
+    # Check constraints.
+    assert a.shape[1] == b.shape[0], 'Incompatible dimensions'
+    assert a.is_contiguous(), 'Matrix A must be contiguous'
+    assert b_scales.shape == (b.shape[1], ), 'The weights must have one scale per output channel'
+    M, K = a.shape
+    N = b.shape[1]
+    # Allocates output.
+    c = torch.empty((M, N), device=a.device, dtype=torch.float32)
+    grid = lambda META: (triton.cdiv(M, META['BLOCK_SIZE_M']) * triton.cdiv(N, META['BLOCK_SIZE_N']), )
+    kernel[grid](
+        a, b, b_scales, c,  #
+        M, N, K,  #
+        a.stride(0), a.stride(1),  #
+        b.stride(0), b.stride(1),  #
+        c.stride(0), c.stride(1))
+    return c
+
+
+def quantize_per_token(a):
+    """Returns the int8 values, as floats, and the per-token scales of `a`, as quantized by `matmul_kernel_w8a8`."""
+    a = a.float()
+    scales = a.abs().amax(dim=1).clamp(min=1e-12) / 127
+    return torch.round(a / scales[:, None]), scales
+
+
+# Benchmark Performance
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['M', 'K', 'N'],
+        # different possible values for `x_name`
+        x_vals=[  #
+            [1, 4096, 4096],  #
+            [1, 4096, 11008],  #
+            [1, 8192, 28672],  #
+            [16, 4096, 4096],  #
+            [32, 8192, 8192],  #
+            [64, 4096, 11008],  #
+            [512, 8192, 8192],  #
+            [1024, 4096, 4096],  #
+            [4096, 4096, 4096],  #
+        ],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton-w8a8', 'triton-w8a16', 'onednn'],
+        # label name for the lines
+        line_names=['Triton-W8A8', 'Triton-W8A16', 'OneDNN'],
+        # line styles
+        styles=[('green', '-'), ('green', '--'), ('blue', '-')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='matmul-w8a8-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(M, N, K, provider):
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device='xpu', dtype=torch.bfloat16)
+    b = torch.randint(-127, 128, (K, N), device='xpu', dtype=torch.int8)
+    b_scales = torch.rand((N, ), device='xpu', dtype=torch.float32) * 0.002
+    b_dequantized = b.float() * b_scales[None, :]
+
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'onednn':
+        # Reference: dequantize ahead of time and run the dense bf16 GEMM.
+        b_bf16 = b_dequantized.to(torch.bfloat16)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(lambda: torch.matmul(a, b_bf16), warmup=10, rep=10,
+                                                                 quantiles=quantiles, fast_flush=False)
+    elif provider == 'triton-w8a8':
+        triton_fn = lambda: matmul(a, b, b_scales, matmul_kernel_w8a8)
+        a_q, a_scales = quantize_per_token(a)
+        torch_fn = lambda: torch.matmul(a_q * a_scales[:, None], b_dequantized)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-2, rtol=1e-2, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    elif provider == 'triton-w8a16':
+        triton_fn = lambda: matmul(a, b, b_scales, matmul_kernel_w8a16)
+        torch_fn = lambda: torch.matmul(a.float(), b_dequantized)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-2, rtol=1e-2, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    tflops = lambda ms: 2 * M * N * K * (1e-12) / (ms * 1e-3)
+    # The bf16 activations, the int8 weights and their scales, and the fp32 output.
+    gbps = lambda ms: (2 * M * K + K * N + 4 * N + 4.0 * M * N) * (1e-9) / (ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
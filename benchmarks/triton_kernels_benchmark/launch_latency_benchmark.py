@@ -0,0 +1,64 @@
+import os
+import time
+
+import torch
+import triton
+import triton.language as tl
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@triton.jit
+def increment_kernel(x_ptr, value, BLOCK_SIZE: tl.constexpr):
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    tl.store(x_ptr + offsets, tl.load(x_ptr + offsets) + value)
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=['num_programs'],
+        x_vals=[1, 64],
+        line_arg='provider',
+        line_vals=['sycl', 'level-zero'],
+        line_names=['SYCL', 'Level-Zero'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['us'],
+        plot_name='launch-latency',
+        args={},
+    ))
+def benchmark(num_programs, provider):
+    """
+    Host time per launch of a kernel running for about a microsecond, launched
+    back to back, with the launcher submitting through SYCL or appending to the
+    Level Zero immediate command list of the queue (TRITON_INTEL_DIRECT_LAUNCH).
+    """
+    BLOCK_SIZE = 128
+    x = torch.zeros(num_programs * BLOCK_SIZE, device='xpu', dtype=torch.float32)
+    os.environ['TRITON_INTEL_DIRECT_LAUNCH'] = '1' if provider == 'level-zero' else '0'
+    # The launcher is created with the compiled kernel.
+    increment_kernel.cache[torch.xpu.current_device()].clear()
+    grid = (num_programs, )
+    increment_kernel[grid](x, 1, BLOCK_SIZE=BLOCK_SIZE)
+    torch.xpu.synchronize()
+
+    num_launches, num_reps = 1000, 10
+    times = []
+    for _ in range(num_reps):
+        start = time.perf_counter()
+        for _ in range(num_launches):
+            increment_kernel[grid](x, 1, BLOCK_SIZE=BLOCK_SIZE)
+        torch.xpu.synchronize()
+        times.append((time.perf_counter() - start) * 1e6 / num_launches)
+    os.environ.pop('TRITON_INTEL_DIRECT_LAUNCH')
+    benchmark_suit.assert_close(x, torch.full_like(x, 1 + num_launches * num_reps), err_msg='launches to expected')
+
+    times = torch.tensor(times)
+    cv = (times.std() / times.mean()).item()
+    return (times.median().item(), times.min().item(), times.max().item()), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(print_data=True)
@@ -0,0 +1,178 @@
+"""
+Paged attention decode benchmark
+============================
+
+vLLM-style decode attention: one query token per sequence attends to a KV cache split in pages of `PAGE_SIZE`
+tokens, scattered in a pool and indexed through a per-sequence block table.
+Each program handles the query heads sharing one KV head, padded to the minimum DPAS M dimension, so the K and V
+pages are read through block pointers whose base is loaded from the block table.
+
+"""
+
+import torch
+import triton
+import triton.language as tl
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+PAGE_SIZE = 32
+
+
+@triton.autotune(
+    configs=[triton.Config({'grf_mode': 'large'}, num_stages=s, num_warps=w) for s in [2, 3] for w in [4, 8]],
+    key=['QUERY_GROUP', 'HEAD_DIM', 'PAGE_SIZE'],
+)
+@triton.jit
+def paged_attention_decode_kernel(
+        Q, K_cache, V_cache, Out, block_tables, context_lens, sm_scale,  #
+        stride_qb: tl.constexpr, stride_qh: tl.constexpr, stride_qd: tl.constexpr,  #
+        stride_kb: tl.constexpr, stride_kh: tl.constexpr, stride_kn: tl.constexpr, stride_kd: tl.constexpr,  #
+        stride_ob: tl.constexpr, stride_oh: tl.constexpr, stride_od: tl.constexpr,  #
+        stride_bt: tl.constexpr,  #
+        QUERY_GROUP: tl.constexpr, HEAD_DIM: tl.constexpr, PAGE_SIZE: tl.constexpr, BLOCK_M: tl.constexpr):
+    seq = tl.program_id(0)
+    kv_head = tl.program_id(1)
+    context_len = tl.load(context_lens + seq)
+
+    # The query heads of the group are padded with zeros to BLOCK_M rows.
+    q_block_ptr = tl.make_block_ptr(base=Q + seq.to(tl.int64) * stride_qb + kv_head * QUERY_GROUP * stride_qh,
+                                    shape=(QUERY_GROUP, HEAD_DIM), strides=(stride_qh, stride_qd), offsets=(0, 0),
+                                    block_shape=(BLOCK_M, HEAD_DIM), order=(1, 0))
+    q = tl.load(q_block_ptr, boundary_check=(0, ))
+
+    m_i = tl.zeros([BLOCK_M], dtype=tl.float32) - float('inf')
+    l_i = tl.zeros([BLOCK_M], dtype=tl.float32)
+    acc = tl.zeros([BLOCK_M, HEAD_DIM], dtype=tl.float32)
+    qk_scale = sm_scale * 1.44269504
+    offs_n = tl.arange(0, PAGE_SIZE)
+
+    for page in range(0, tl.cdiv(context_len, PAGE_SIZE)):
+        block_id = tl.load(block_tables + seq * stride_bt + page).to(tl.int64)
+        kv_offset = block_id * stride_kb + kv_head * stride_kh
+        k_block_ptr = tl.make_block_ptr(base=K_cache + kv_offset, shape=(HEAD_DIM, PAGE_SIZE),
+                                        strides=(stride_kd, stride_kn), offsets=(0, 0),
+                                        block_shape=(HEAD_DIM, PAGE_SIZE), order=(0, 1))
+        v_block_ptr = tl.make_block_ptr(base=V_cache + kv_offset, shape=(PAGE_SIZE, HEAD_DIM),
+                                        strides=(stride_kn, stride_kd), offsets=(0, 0),
+                                        block_shape=(PAGE_SIZE, HEAD_DIM), order=(1, 0))
+        k = tl.load(k_block_ptr)
+        qk = tl.dot(q, k) * qk_scale
+        # The last page is only partially filled.
+        qk = tl.where((page * PAGE_SIZE + offs_n)[None, :] < context_len, qk, float('-inf'))
+        m_ij = tl.maximum(m_i, tl.max(qk, 1))
+        p = tl.math.exp2(qk - m_ij[:, None])
+        alpha = tl.math.exp2(m_i - m_ij)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        acc = acc * alpha[:, None]
+        v = tl.load(v_block_ptr)
+        acc += tl.dot(p.to(tl.float16), v)
+        m_i = m_ij
+
+    acc = acc / l_i[:, None]
+    o_block_ptr = tl.make_block_ptr(base=Out + seq.to(tl.int64) * stride_ob + kv_head * QUERY_GROUP * stride_oh,
+                                    shape=(QUERY_GROUP, HEAD_DIM), strides=(stride_oh, stride_od), offsets=(0, 0),
+                                    block_shape=(BLOCK_M, HEAD_DIM), order=(1, 0))
+    tl.store(o_block_ptr, acc.to(Out.type.element_ty), boundary_check=(0, ))
+
+
+def paged_attention_decode(q, k_cache, v_cache, block_tables, context_lens, sm_scale):
+    # Check constraints.
+    B, H_Q, D = q.shape
+    _, H_KV, page_size, _ = k_cache.shape
+    assert k_cache.shape == v_cache.shape, 'K and V caches must have the same shape'
+    assert k_cache.stride() == v_cache.stride(), 'K and V caches must have the same layout'
+    assert H_Q % H_KV == 0, 'The number of query heads must be a multiple of the number of KV heads'
+    query_group = H_Q // H_KV
+    # The M dimension of DPAS is at least 8 rows.
+    block_m = max(16, triton.next_power_of_2(query_group))
+    out = torch.empty_like(q)
+    paged_attention_decode_kernel[(B, H_KV)](
+        q, k_cache, v_cache, out, block_tables, context_lens, sm_scale,  #
+        q.stride(0), q.stride(1), q.stride(2),  #
+        k_cache.stride(0), k_cache.stride(1), k_cache.stride(2), k_cache.stride(3),  #
+        out.stride(0), out.stride(1), out.stride(2),  #
+        block_tables.stride(0),  #
+        QUERY_GROUP=query_group, HEAD_DIM=D, PAGE_SIZE=page_size, BLOCK_M=block_m)
+    return out
+
+
+def paged_attention_decode_ref(q, k_cache, v_cache, block_tables, context_lens, sm_scale):
+    """Gathers the pages of each sequence and computes the attention in float32."""
+    H_Q = q.shape[1]
+    _, H_KV, page_size, D = k_cache.shape
+    out = torch.empty_like(q)
+    for b, context_len in enumerate(context_lens.tolist()):
+        pages = block_tables[b, :triton.cdiv(context_len, page_size)].long()
+        k = k_cache[pages].transpose(0, 1).reshape(H_KV, -1, D)[:, :context_len]
+        v = v_cache[pages].transpose(0, 1).reshape(H_KV, -1, D)[:, :context_len]
+        k = k.repeat_interleave(H_Q // H_KV, dim=0).float()
+        v = v.repeat_interleave(H_Q // H_KV, dim=0).float()
+        scores = torch.einsum('hd,hnd->hn', q[b].float(), k) * sm_scale
+        out[b] = torch.einsum('hn,hnd->hd', torch.softmax(scores, dim=-1), v).to(q.dtype)
+    return out
+
+
+# Benchmark Performance
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        # argument names to use as an x-axis for the plot
+        x_names=['B', 'H_Q', 'H_KV', 'CTX', 'D_HEAD'],
+        # different possible values for `x_name`
+        x_vals=[  #
+            [1, 32, 8, 1024, 128],  #
+            [8, 32, 8, 2048, 128],  #
+            [16, 32, 32, 1024, 128],  #
+            [32, 32, 8, 4096, 128],  #
+            [64, 64, 8, 512, 128],  #
+            [64, 32, 8, 1024, 64],  #
+        ],
+        line_arg='provider',
+        # argument name whose value corresponds to a different line in the plot
+        # possible values for `line_arg``
+        line_vals=['triton'],
+        # label name for the lines
+        line_names=['Triton'],
+        # line styles
+        styles=[('green', '-'), ('green', '--')],
+        ylabel=['GB/s', 'TFlops'],  # label name for the y-axis
+        plot_name='paged-attn-decode-performance',
+        # name for the plot. Used also as a file name for saving the plot.
+        args={},
+    ))
+def benchmark(B, H_Q, H_KV, CTX, D_HEAD, provider):
+    torch.manual_seed(0)
+    dtype = torch.float16
+    max_pages = triton.cdiv(CTX, PAGE_SIZE)
+    # Sequences of different lengths, with their pages shuffled in the pool.
+    context_lens = torch.randint(CTX // 2, CTX + 1, (B, ), device='xpu', dtype=torch.int32)
+    block_tables = torch.randperm(B * max_pages, device='xpu', dtype=torch.int32).view(B, max_pages)
+    q = torch.randn((B, H_Q, D_HEAD), device='xpu', dtype=dtype)
+    k_cache = torch.randn((B * max_pages, H_KV, PAGE_SIZE, D_HEAD), device='xpu', dtype=dtype)
+    v_cache = torch.randn((B * max_pages, H_KV, PAGE_SIZE, D_HEAD), device='xpu', dtype=dtype)
+    sm_scale = D_HEAD**-0.5
+
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        triton_fn = lambda: paged_attention_decode(q, k_cache, v_cache, block_tables, context_lens, sm_scale)
+        torch_fn = lambda: paged_attention_decode_ref(q, k_cache, v_cache, block_tables, context_lens, sm_scale)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-2, rtol=1e-3, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    num_tokens = context_lens.sum().item()
+    tflops = lambda ms: 2 * 2 * num_tokens * H_Q * D_HEAD * (1e-12) / (ms * 1e-3)
+    # The K and V pages are read once per KV head, the queries and outputs once.
+    gbps = lambda ms: (2 * 2 * num_tokens * H_KV * D_HEAD + 2 * 2 * B * H_Q * D_HEAD + 4 * B * max_pages) * (1e-9) / (
+        ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
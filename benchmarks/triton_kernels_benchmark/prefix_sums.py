@@ -1,6 +1,7 @@
 import torch
 import triton
 import triton.language as tl
+from triton.language.extra.intel import scan
 
 import triton_kernels_benchmark as benchmark_suit
 
@@ -54,5 +55,41 @@ def benchmark(M, N, AXIS, provider):
     return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
 
 
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=['N'],
+        x_vals=[2**i for i in range(16, 29, 2)],
+        line_arg='provider',
+        line_vals=['triton', 'torch'],
+        line_names=['Triton', 'Torch'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],
+        plot_name='device-prefix-sums',
+        args={},
+    ))
+def benchmark_device_scan(N, provider):
+    quantiles = [0.5, 0.0, 1.0]
+    x = torch.rand(N, device='xpu', dtype=torch.float32)
+    out = torch.empty_like(x)
+
+    if provider == 'triton':
+        # Single pass scan of the whole tensor, using decoupled lookback across programs.
+        triton_fn = lambda: scan.cumsum(x, out)
+        torch_fn = lambda: torch.cumsum(x, 0)
+        benchmark_suit.assert_close(triton_fn(), torch_fn(), atol=1e-2, rtol=1e-3, err_msg='triton to torch')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, quantiles=quantiles, fast_flush=False)
+    elif provider == 'torch':
+        torch_fn = lambda: torch.cumsum(x, 0, out=out)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(torch_fn, quantiles=quantiles, fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    tflops = lambda ms: (x.numel() * 1e-12) / (ms * 1e-3)
+    gbps = lambda ms: (2 * x.numel() * x.element_size() * 1e-9) / (ms * 1e-3)
+
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
 if __name__ == '__main__':
     benchmark.run(print_data=True)
+    benchmark_device_scan.run(print_data=True)
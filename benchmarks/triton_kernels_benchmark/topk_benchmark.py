@@ -0,0 +1,66 @@
+"""
+Top-k
+=====
+
+The k largest logits of the rows of a batch of decode steps, as in top-k/top-p sampling, computed by the bitonic top-k
+of `triton.language.extra.intel.topk`: the rows are split across the Xe-cores, each program keeping the running top-k
+of its chunks of the row, and a second kernel merges the top-k of the splits of each row.
+To compare the performance to `torch.topk`.
+
+"""
+
+import torch
+from triton.language.extra.intel import topk
+
+import triton_kernels_benchmark as benchmark_suit
+
+if benchmark_suit.USE_IPEX_OPTION:
+    import intel_extension_for_pytorch  # type: ignore # noqa: F401
+
+
+@benchmark_suit.perf_report(
+    benchmark_suit.Benchmark(
+        x_names=['B', 'V', 'K'],
+        x_vals=[[b, v, k]  #
+                for b in [1, 16, 64]  #
+                for v in [32000, 128256]  #
+                for k in [1, 50, 256]],
+        line_arg='provider',
+        line_vals=['triton', 'onednn'],
+        line_names=['Triton', 'OneDNN'],
+        styles=[('blue', '-'), ('green', '-')],
+        ylabel=['GB/s', 'TFlops'],
+        plot_name='topk-performance',
+        args={},
+    ))
+def benchmark(B, V, K, provider):
+    torch.manual_seed(0)
+    x = torch.randn((B, V), device='xpu', dtype=torch.float32)
+    quantiles = [0.5, 0.0, 1.0]
+
+    if provider == 'triton':
+        triton_fn = lambda: topk.topk(x, K)
+        values, indices = triton_fn()
+        ref_values, _ = torch.topk(x, K)
+        benchmark_suit.assert_close(values, ref_values, atol=0, rtol=0, err_msg='triton to torch')
+        benchmark_suit.assert_close(torch.gather(x, 1, indices), values, atol=0, rtol=0,
+                                    err_msg='triton indices to values')
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(triton_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    elif provider == 'onednn':
+        onednn_fn = lambda: torch.topk(x, K)
+        _, min_ms, max_ms, mean_ms, cv = benchmark_suit.do_bench(onednn_fn, warmup=10, rep=10, quantiles=quantiles,
+                                                                 fast_flush=False)
+    else:
+        raise NotImplementedError(f'Unsupported provider {provider}')
+
+    # The logits read once, the values and indices written once.
+    num_bytes = B * V * x.element_size() + B * K * (x.element_size() + 8)
+    gbps = lambda ms: num_bytes * 1e-9 / (ms * 1e-3)
+    # One comparison per logit, the minimum of any top-k.
+    tflops = lambda ms: B * V * 1e-12 / (ms * 1e-3)
+    return (gbps(mean_ms), gbps(max_ms), gbps(min_ms)), (tflops(mean_ms), tflops(max_ms), tflops(min_ms)), cv
+
+
+if __name__ == '__main__':
+    benchmark.run(show_plots=False, print_data=True)
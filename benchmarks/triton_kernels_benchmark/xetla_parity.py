@@ -0,0 +1,155 @@
+"""
+XeTLA Parity
+============
+Runs the Triton kernels next to their XeTLA counterparts over the shapes of
+their benchmarks, and reports the Triton/XeTLA throughput ratio per shape as
+JSON, together with a fingerprint of the hardware and software stack.
+
+    python xetla_parity.py --output parity.json --baseline previous.json
+
+With `--baseline`, the shapes whose ratio dropped by more than `--tolerance`
+compared to the baseline are reported and the script exits with status 1.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import sys
+from datetime import datetime, timezone
+
+import torch
+import triton
+from triton.runtime import driver
+
+import triton_kernels_benchmark as benchmark_suit
+
+import fused_softmax
+import flash_attention_fwd_benchmark
+import gemm_benchmark
+import gemm_streamk_benchmark
+
+# Shape families, compared on the throughput most relevant to them.
+FAMILIES = {
+    "gemm": (gemm_benchmark, "TFlops"),
+    "gemm-streamk": (gemm_streamk_benchmark, "TFlops"),
+    "softmax": (fused_softmax, "GB/s"),
+    "flash-attention-fwd": (flash_attention_fwd_benchmark, "TFlops"),
+}
+
+
+def fingerprint():
+    """Returns the hardware and software versions the results depend on."""
+    device = torch.xpu.current_device()
+    props = torch.xpu.get_device_properties(device)
+    xpu_props = dict(driver.active.utils.get_device_properties(device))
+    result = {
+        "device": props.name,
+        "driver_version": getattr(props, "driver_version", None),
+        "eu_count": xpu_props.get("gpu_eu_count"),
+        "max_work_group_size": xpu_props.get("max_work_group_size"),
+        "triton": triton.__version__,
+        "torch": torch.__version__,
+        "python": platform.python_version(),
+        "os": platform.platform(),
+        "host": platform.node(),
+    }
+    if benchmark_suit.USE_IPEX_OPTION:
+        import intel_extension_for_pytorch  # type: ignore
+        result["ipex"] = intel_extension_for_pytorch.__version__
+    return result
+
+
+def run_family(module, metric, save_path):
+    """Returns the Triton and XeTLA throughput of each shape of the benchmark of `module`."""
+    bench = module.benchmark.benchmarks
+    bench.line_vals, bench.line_names = ["triton", "xetla"], ["Triton", "XeTLA"]
+    df = module.benchmark.run(print_data=True, save_path=save_path, return_df=True)
+    results = []
+    for _, row in df.iterrows():
+        shape = {name: int(row[name]) for name in bench.x_names}
+        triton_value, xetla_value = float(row[f"Triton-{metric}"]), float(row[f"XeTLA-{metric}"])
+        results.append({
+            "shape": shape,
+            "metric": metric,
+            "triton": triton_value,
+            "xetla": xetla_value,
+            "ratio": triton_value / xetla_value if xetla_value > 0 else None,
+        })
+    return results
+
+
+def summarize(families):
+    """Returns the geometric mean of the ratios of each shape family."""
+    summary = {}
+    for family, results in families.items():
+        ratios = [result["ratio"] for result in results if result["ratio"]]
+        summary[family] = math.exp(sum(map(math.log, ratios)) / len(ratios)) if ratios else None
+    return summary
+
+
+def find_regressions(families, baseline, tolerance):
+    """Returns the shapes whose ratio dropped by more than `tolerance` compared to `baseline`."""
+    regressions = []
+    for family, results in families.items():
+        previous = {json.dumps(result["shape"], sort_keys=True): result for result in baseline.get(family, [])}
+        for result in results:
+            base = previous.get(json.dumps(result["shape"], sort_keys=True))
+            if not base or not base["ratio"] or not result["ratio"]:
+                continue
+            if result["ratio"] < base["ratio"] * (1 - tolerance):
+                regressions.append({
+                    "family": family,
+                    "shape": result["shape"],
+                    "ratio": result["ratio"],
+                    "baseline_ratio": base["ratio"],
+                })
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--output", type=str, default="xetla-parity.json", help="path of the JSON results")
+    parser.add_argument("--baseline", type=str, default="", help="JSON results to compare the ratios to")
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="relative drop of the Triton/XeTLA ratio reported as a regression")
+    parser.add_argument("--families", type=str, nargs="+", choices=list(FAMILIES), default=list(FAMILIES),
+                        help="shape families to run")
+    parser.add_argument("--reports", type=str, default="", help="directory to save the reports of the benchmarks")
+    args = parser.parse_args()
+
+    families = {}
+    for family in args.families:
+        module, metric = FAMILIES[family]
+        families[family] = run_family(module, metric, args.reports)
+
+    report = {
+        "date": datetime.now(timezone.utc).isoformat(),
+        "fingerprint": fingerprint(),
+        "summary": summarize(families),
+        "results": families,
+    }
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)
+        if baseline.get("fingerprint", {}).get("device") != report["fingerprint"]["device"]:
+            print(f"warning: the baseline was measured on {baseline.get('fingerprint', {}).get('device')}",
+                  file=sys.stderr)
+        report["baseline"] = os.path.abspath(args.baseline)
+        report["regressions"] = find_regressions(families, baseline["results"], args.tolerance)
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        json.dump(report, f, indent=2)
+
+    print("Triton/XeTLA ratio (geometric mean):")
+    for family, ratio in report["summary"].items():
+        print(f"  {family}: {ratio:.3f}" if ratio else f"  {family}: n/a")
+    for regression in report.get("regressions", []):
+        print(f"regression: {regression['family']} {regression['shape']}: {regression['ratio']:.3f} "
+              f"(baseline {regression['baseline_ratio']:.3f})")
+    return 1 if report.get("regressions") else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
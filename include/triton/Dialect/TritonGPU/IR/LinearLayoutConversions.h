@@ -44,6 +44,10 @@ std::optional<LinearLayout>
 toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
                std::optional<int32_t> elemBitWidth = std::nullopt);
 
+// Returns the cache of the linear layouts built in `ctx`, see
+// LinearLayoutCache.  The TritonGPU dialect must be loaded.
+LinearLayoutCache &getLinearLayoutCache(MLIRContext *ctx);
+
 // Given a linear layout with input dims and output dims containing a "block"
 // dimension, determines if the layout moves data across block boundaries.
 bool isCrossCTAConversion(const LinearLayout &layout);
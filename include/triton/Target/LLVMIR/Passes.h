@@ -6,7 +6,7 @@
 namespace mlir {
 
 /// Create a pass to add DIScope
-std::unique_ptr<Pass> createLLVMDIScopePass();
+std::unique_ptr<Pass> createLLVMDIScopePass(bool lineTablesOnly = false);
 
 /// Generate the code for registering conversion passes.
 #define GEN_PASS_REGISTRATION
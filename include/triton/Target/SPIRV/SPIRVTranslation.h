@@ -9,8 +9,11 @@ class Module;
 
 namespace triton {
 
-// Translate TritonGPU IR to SPIRV code.
-std::string translateLLVMIRToSPIRV(llvm::Module &module);
+// Translate TritonGPU IR to SPIRV code. With \p useBackend, LLVM's SPIR-V
+// backend emits the SPIR-V if it is built and supports the module, otherwise
+// the SPIRV-LLVM-Translator does.
+std::string translateLLVMIRToSPIRV(llvm::Module &module,
+                                   bool useBackend = false);
 
 } // namespace triton
 
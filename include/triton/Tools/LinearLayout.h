@@ -2,13 +2,17 @@
 #define TRITON_TOOLS_LINEARLAYOUT_H
 
 #include <cstdint>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "mlir/IR/BuiltinAttributes.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
@@ -712,6 +716,83 @@ private:
   checkInvariants(bool requireSurjective);
 };
 
+// Hashes the dimensions and the bases of the layout, consistently with
+// operator==.
+llvm::hash_code hash_value(const LinearLayout &layout);
+
+// Memoizes the layouts computed from other layouts.
+//
+// The compiler builds the same few layouts and asks for the conversions between
+// them over and over, e.g. in each iteration of the layout propagation and then
+// again during the lowering.  invertAndCompose in particular runs a Gaussian
+// elimination every time.  This cache interns the layouts converted from the
+// encoding attributes and the results of compose, invertAndCompose and
+// operator*.
+//
+// The layouts refer to the StringAttrs of their MLIRContext, so a cache must
+// not outlive the context it is used with: TritonGPUDialect owns one per
+// context.  The cache is thread-safe and is emptied when it becomes too large.
+// Setting TRITON_DISABLE_LINEAR_LAYOUT_CACHE=1 recomputes everything.
+class LinearLayoutCache {
+public:
+  LinearLayoutCache();
+
+  LinearLayout compose(const LinearLayout &inner, const LinearLayout &outer);
+  LinearLayout invertAndCompose(const LinearLayout &inner,
+                                const LinearLayout &outer);
+  LinearLayout product(const LinearLayout &inner, const LinearLayout &outer);
+
+  // Returns the layout of the tensors of shape `shape` with the encoding
+  // `layout`, computed by `convert` on a cache miss.
+  std::optional<LinearLayout> getOrConvert(
+      ArrayRef<int64_t> shape, Attribute layout,
+      std::optional<int32_t> elemBitWidth,
+      llvm::function_ref<std::optional<LinearLayout>()> convert);
+
+  size_t getNumHits() const;
+  size_t getNumMisses() const;
+  void clear();
+
+private:
+  enum class Operation { Compose, InvertAndCompose, Product };
+
+  struct OperationKey {
+    Operation op;
+    LinearLayout lhs;
+    LinearLayout rhs;
+
+    bool operator==(const OperationKey &other) const;
+  };
+
+  struct ConversionKey {
+    SmallVector<int64_t> shape;
+    Attribute layout;
+    std::optional<int32_t> elemBitWidth;
+
+    bool operator==(const ConversionKey &other) const {
+      return shape == other.shape && layout == other.layout &&
+             elemBitWidth == other.elemBitWidth;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const OperationKey &key) const;
+    size_t operator()(const ConversionKey &key) const;
+  };
+
+  LinearLayout
+  getOrCompute(Operation op, const LinearLayout &lhs, const LinearLayout &rhs,
+               llvm::function_ref<LinearLayout()> compute);
+
+  const bool enabled;
+  mutable std::mutex mutex;
+  std::unordered_map<OperationKey, LinearLayout, KeyHash> operations;
+  std::unordered_map<ConversionKey, std::optional<LinearLayout>, KeyHash>
+      conversions;
+  size_t numHits = 0;
+  size_t numMisses = 0;
+};
+
 inline llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
                                      const LinearLayout &layout) {
   os << layout.toString();
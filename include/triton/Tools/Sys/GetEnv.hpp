@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <cstdlib>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -13,6 +14,7 @@ namespace mlir::triton {
 inline const std::set<std::string> CACHE_INVALIDATING_ENV_VARS = {
     // clang-format off
     "AMDGCN_ENABLE_DUMP",
+    "AMDGCN_USE_BUFFER_OPS",
     "DISABLE_FAST_REDUCTION",
     "DISABLE_LLVM_OPT",
     "DISABLE_MMA_V3",
@@ -36,6 +38,14 @@ inline const std::set<std::string> CACHE_INVALIDATING_ENV_VARS = {
     "TRITON_INTEL_ENABLE_INSTR_SCHED",
     "TRITON_INTEL_DO_NOT_SINK_INSTR_ACROSS_RGN",
     "TRITON_INTEL_ENABLE_FAST_PREFETCH",
+    "TRITON_INTEL_ENABLE_SLM_SWIZZLE",
+    "TRITON_INTEL_EXPLICIT_SCALING",
+    "TRITON_INTEL_ENABLE_SHUFFLE_CONVERT_LAYOUT",
+    "TRITON_INTEL_KEEP_LLIR",
+    "TRITON_INTEL_PRINT_BUFFER_SIZE",
+    "TRITON_INTEL_LINE_TABLES_ONLY",
+    "TRITON_INTEL_SPIRV_BACKEND",
+    "TRITON_LINK_KERNELS",
     "TRITONGEN_FORCE_GENISA",
     "TRITON_INTEL_REDUCE_TRANSPOSE"
     // clang-format on
@@ -44,7 +54,8 @@ inline const std::set<std::string> CACHE_INVALIDATING_ENV_VARS = {
 inline const std::set<std::string> CACHE_NEUTRAL_ENV_VARS = {
     // clang-format off
     "TRITON_REPRODUCER_PATH",
-    "TRITON_ENABLE_PYTHON_STACKTRACE"
+    "TRITON_ENABLE_PYTHON_STACKTRACE",
+    "TRITON_DISABLE_LINEAR_LAYOUT_CACHE"
     // clang-format on
 };
 
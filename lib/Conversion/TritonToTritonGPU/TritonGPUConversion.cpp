@@ -91,6 +91,10 @@ TritonGPUConversionTarget::TritonGPUConversionTarget(
     : ConversionTarget(context) {
   // TODO: we should also verify ops of TritonGPUDialect
   addLegalDialect<triton::gpu::TritonGPUDialect>();
+  // Except for the local memory accesses of the frontend, whose tensors have
+  // no encoding yet.
+  addDynamicallyLegalOp<triton::gpu::LocalLoadOp, triton::gpu::LocalStoreOp>(
+      [&](Operation *op) { return typeConverter.isLegal(op); });
 
   // Some ops from SCF are illegal
   addIllegalOp<scf::ExecuteRegionOp, scf::ParallelOp, scf::ReduceOp,
@@ -716,9 +716,16 @@ DotOperandEncodingAttr::toLinearLayout(ArrayRef<int64_t> shape) const {
   return std::nullopt;
 }
 
+LinearLayoutCache &getLinearLayoutCache(MLIRContext *ctx) {
+  auto *dialect = ctx->getLoadedDialect<TritonGPUDialect>();
+  assert(dialect && "TritonGPU dialect is not loaded");
+  return dialect->getLinearLayoutCache();
+}
+
+namespace {
 std::optional<LinearLayout>
-toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
-               std::optional<int32_t> elemBitWidth /*= std::nullopt*/) {
+convertToLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
+                      std::optional<int32_t> elemBitWidth) {
   if (auto distributed = dyn_cast<DistributedEncodingTrait>(layout)) {
     return distributed.toLinearLayout(shape);
   }
@@ -734,6 +741,20 @@ toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
   // TODO(jlebar): Other layouts
   return std::nullopt;
 }
+} // anonymous namespace
+
+std::optional<LinearLayout>
+toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
+               std::optional<int32_t> elemBitWidth /*= std::nullopt*/) {
+  // Only the elemBitWidth of the shared layouts with a leading offset matters.
+  auto shared = dyn_cast<SharedEncodingAttr>(layout);
+  if (!shared || !shared.getHasLeadingOffset())
+    elemBitWidth = std::nullopt;
+  return getLinearLayoutCache(layout.getContext())
+      .getOrConvert(shape, layout, elemBitWidth, [&] {
+        return convertToLinearLayout(shape, layout, elemBitWidth);
+      });
+}
 
 bool isCrossCTAConversion(const LinearLayout &layout) {
   assert(!layout.getInDimNames().empty());
@@ -0,0 +1,122 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
+
+//===----------------------------------------------------------------------===//
+//
+// This pass makes the kernel persistent: its body becomes a loop over the
+// tiles of the launch grid, with one program per SM striding over the tiles,
+// so that the kernel pays its launch and prologue once per SM instead of once
+// per tile.
+//
+//===----------------------------------------------------------------------===//
+
+using namespace mlir;
+namespace tt = ::mlir::triton;
+namespace ttg = ::mlir::triton::gpu;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+// Name of the module attribute telling the launcher to pass the grid of tiles
+// after the kernel arguments and to launch one program per SM.
+constexpr StringLiteral persistentAttrName = "triton_nvidia_gpu.persistent";
+
+bool readsProgramIds(tt::FuncOp funcOp) {
+  return funcOp
+      .walk([](Operation *op) {
+        return isa<tt::GetProgramIdOp, tt::GetNumProgramsOp>(op)
+                   ? WalkResult::interrupt()
+                   : WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+void makePersistent(tt::FuncOp funcOp) {
+  MLIRContext *ctx = funcOp.getContext();
+  Location loc = funcOp.getLoc();
+  Type i32Ty = IntegerType::get(ctx, 32);
+
+  // The launcher passes the grid of tiles after the kernel arguments.
+  unsigned numArgs = funcOp.getNumArguments();
+  Value grid[3];
+  for (unsigned i = 0; i < 3; ++i) {
+    funcOp.insertArgument(numArgs + i, i32Ty, DictionaryAttr::get(ctx), loc);
+    grid[i] = funcOp.getArgument(numArgs + i);
+  }
+
+  Block &body = funcOp.getBody().front();
+  SmallVector<Operation *> ops;
+  for (Operation &op : body.without_terminator())
+    ops.push_back(&op);
+  SmallVector<tt::GetProgramIdOp> pidOps;
+  SmallVector<tt::GetNumProgramsOp> numProgramsOps;
+  funcOp.walk([&](tt::GetProgramIdOp op) { pidOps.push_back(op); });
+  funcOp.walk([&](tt::GetNumProgramsOp op) { numProgramsOps.push_back(op); });
+
+  // for (tile = pid; tile < gridX * gridY * gridZ; tile += numPrograms)
+  OpBuilder b(&body, body.begin());
+  Value numTiles = b.create<arith::MulIOp>(
+      loc, b.create<arith::MulIOp>(loc, grid[0], grid[1]), grid[2]);
+  Value start = b.create<tt::GetProgramIdOp>(loc, i32Ty, tt::ProgramIDDim::X);
+  Value step =
+      b.create<tt::GetNumProgramsOp>(loc, i32Ty, tt::ProgramIDDim::X);
+  auto forOp = b.create<scf::ForOp>(loc, start, numTiles, step);
+  Block *loopBody = forOp.getBody();
+  for (Operation *op : ops)
+    op->moveBefore(loopBody->getTerminator());
+
+  // The tiles are walked in the dispatch order of the programs of the grid:
+  //   tile = (pidZ * gridY + pidY) * gridX + pidX
+  b.setInsertionPointToStart(loopBody);
+  Value tile = forOp.getInductionVar();
+  Value tileYZ = b.create<arith::DivSIOp>(loc, tile, grid[0]);
+  Value pids[3] = {b.create<arith::RemSIOp>(loc, tile, grid[0]),
+                   b.create<arith::RemSIOp>(loc, tileYZ, grid[1]),
+                   b.create<arith::DivSIOp>(loc, tileYZ, grid[1])};
+  for (tt::GetProgramIdOp op : pidOps) {
+    op.replaceAllUsesWith(pids[op.getAxisAsInt()]);
+    op.erase();
+  }
+  for (tt::GetNumProgramsOp op : numProgramsOps) {
+    op.replaceAllUsesWith(grid[op.getAxisAsInt()]);
+    op.erase();
+  }
+}
+
+class TritonNvidiaGPUPersistentKernelPass
+    : public TritonNvidiaGPUPersistentKernelPassBase<
+          TritonNvidiaGPUPersistentKernelPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    // The program ids of the CTAs of a cluster cannot be remapped one by one.
+    if (ttg::TritonGPUDialect::getNumCTAs(mod) != 1)
+      return;
+
+    SmallVector<tt::FuncOp> kernels;
+    for (auto funcOp : mod.getOps<tt::FuncOp>()) {
+      if (funcOp.isPublic())
+        kernels.push_back(funcOp);
+      else if (readsProgramIds(funcOp))
+        return;
+    }
+    if (kernels.size() != 1 || !kernels.front().getBody().hasOneBlock())
+      return;
+
+    makePersistent(kernels.front());
+    mod->setAttr(persistentAttrName,
+                 IntegerAttr::get(IntegerType::get(mod.getContext(), 32), 1));
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> mlir::createTritonNvidiaGPUPersistentKernelPass() {
+  return std::make_unique<TritonNvidiaGPUPersistentKernelPass>();
+}
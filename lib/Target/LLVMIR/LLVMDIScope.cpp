@@ -39,6 +39,7 @@ FileLineColLoc extractFileLoc(Location loc) {
 /// Add a debug info scope to LLVMFuncOp that are missing it.
 struct LLVMDIScopePass : public LLVMDIScopeBase<LLVMDIScopePass> {
   LLVMDIScopePass() = default;
+  LLVMDIScopePass(bool lineTablesOnly) { this->lineTablesOnly = lineTablesOnly; }
 
   void setSubprogramAttr(LLVM::LLVMFuncOp funcOp) {
     Location loc = funcOp.getLoc();
@@ -131,6 +132,15 @@ struct LLVMDIScopePass : public LLVMDIScopeBase<LLVMDIScopePass> {
     if (auto callSiteLoc = dyn_cast<CallSiteLoc>(opLoc)) {
       auto callerLoc = callSiteLoc.getCaller();
       auto calleeLoc = callSiteLoc.getCallee();
+      // Only keep the line of the kernel the inlined code is called from, which
+      // is enough to correlate the instructions with the source of the kernel
+      // when profiling.
+      if (lineTablesOnly) {
+        while (auto nestedCallerLoc = dyn_cast<CallSiteLoc>(callerLoc))
+          callerLoc = nestedCallerLoc.getCaller();
+        op->setLoc(callerLoc);
+        return;
+      }
       LLVM::DIScopeAttr scopeAttr;
       // We assemble the full inline stack so the parent of this loc must be a
       // function
@@ -155,6 +165,6 @@ struct LLVMDIScopePass : public LLVMDIScopeBase<LLVMDIScopePass> {
 
 } // end anonymous namespace
 
-std::unique_ptr<Pass> mlir::createLLVMDIScopePass() {
-  return std::make_unique<LLVMDIScopePass>();
+std::unique_ptr<Pass> mlir::createLLVMDIScopePass(bool lineTablesOnly) {
+  return std::make_unique<LLVMDIScopePass>(lineTablesOnly);
 }
@@ -1,7 +1,9 @@
 #include "triton/Target/SPIRV/SPIRVTranslation.h"
+#include <mutex>
 #include <optional>
 
 #include "LLVMSPIRVLib.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -32,8 +34,66 @@ public:
   SmallVectorBuffer(llvm::SmallVectorImpl<char> &O) : OS(O) {}
 };
 
-std::string translateLLVMIRToSPIRV(llvm::Module &module) {
-  // initLLVM();
+#ifdef TRITON_HAS_LLVM_SPIRV_BACKEND
+// Translates \p module to SPIR-V with LLVM's SPIR-V backend. Returns
+// std::nullopt if the module cannot be translated by the backend, e.g. because
+// it calls GenISA intrinsics, which only the translator passes through to IGC.
+static std::optional<std::string> translateWithBackend(llvm::Module &module) {
+  if (llvm::any_of(module.functions(), [](const llvm::Function &function) {
+        return function.isDeclaration() &&
+               function.getName().starts_with("llvm.genx.GenISA.");
+      }))
+    return std::nullopt;
+
+  static std::once_flag initFlag;
+  static bool allExtensions = false;
+  std::call_once(initFlag, []() {
+    LLVMInitializeSPIRVTargetInfo();
+    LLVMInitializeSPIRVTarget();
+    LLVMInitializeSPIRVTargetMC();
+    LLVMInitializeSPIRVAsmPrinter();
+    // Allow all the SPIR-V extensions, like the translator. The backend only
+    // takes them from the command line.
+    const char *args[] = {"triton", "--spirv-ext=all"};
+    allExtensions =
+        llvm::cl::getRegisteredOptions().count("spirv-ext") &&
+        llvm::cl::ParseCommandLineOptions(2, args, "", &llvm::errs());
+  });
+  if (!allExtensions)
+    return std::nullopt;
+
+  const std::string triple = "spirv64-unknown-unknown";
+  std::string error;
+  const llvm::Target *target =
+      llvm::TargetRegistry::lookupTarget(triple, error);
+  if (!target)
+    return std::nullopt;
+  llvm::TargetOptions opt;
+  std::unique_ptr<llvm::TargetMachine> machine{target->createTargetMachine(
+      triple, "", "", opt, std::nullopt, std::nullopt,
+      llvm::CodeGenOptLevel::Aggressive)};
+  module.setTargetTriple(triple);
+  module.setDataLayout(machine->createDataLayout());
+
+  llvm::SmallVector<char, 0> buffer;
+  llvm::raw_svector_ostream stream(buffer);
+  llvm::legacy::PassManager pm;
+  pm.add(llvm::createVerifierPass());
+  if (machine->addPassesToEmitFile(pm, stream, nullptr,
+                                   llvm::CodeGenFileType::ObjectFile))
+    return std::nullopt;
+  pm.run(module);
+  return std::string(buffer.begin(), buffer.end());
+}
+#endif
+
+std::string translateLLVMIRToSPIRV(llvm::Module &module, bool useBackend) {
+#ifdef TRITON_HAS_LLVM_SPIRV_BACKEND
+  if (useBackend) {
+    if (std::optional<std::string> spirv = translateWithBackend(module))
+      return *spirv;
+  }
+#endif
 
   llvm::SmallVector<char, 0> buffer;
 
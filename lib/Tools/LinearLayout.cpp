@@ -7,6 +7,7 @@
 #include "mlir/IR/BuiltinAttributes.h"
 #include "third_party/f2reduce/f2reduce.h"
 #include "triton/Tools/StrUtil.h"
+#include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetOperations.h"
 #include "llvm/Support/Debug.h"
@@ -1121,4 +1122,133 @@ std::string LinearLayout::toString() const {
   return ret;
 }
 
+llvm::hash_code hash_value(const LinearLayout &layout) {
+  llvm::hash_code hash = llvm::hash_value(layout.getNumOutDims());
+  for (const auto &[inDim, inDimBases] : layout.getBases()) {
+    hash = llvm::hash_combine(hash, inDim);
+    for (const std::vector<int32_t> &basis : inDimBases)
+      hash = llvm::hash_combine(
+          hash, llvm::hash_combine_range(basis.begin(), basis.end()));
+  }
+  for (StringAttr outDim : layout.getOutDimNames())
+    hash = llvm::hash_combine(hash, outDim, layout.getOutDimSize(outDim));
+  return hash;
+}
+
+namespace {
+// Bounds the memory used by the cache of a long running process.
+constexpr size_t maxCachedLayouts = 1 << 14;
+} // namespace
+
+LinearLayoutCache::LinearLayoutCache()
+    : enabled(!tools::getBoolEnv("TRITON_DISABLE_LINEAR_LAYOUT_CACHE")) {}
+
+bool LinearLayoutCache::OperationKey::operator==(
+    const OperationKey &other) const {
+  // operator== ignores whether the layouts are known to be surjective, but
+  // the results of compose depend on it.
+  return op == other.op && lhs.isSurjective() == other.lhs.isSurjective() &&
+         rhs.isSurjective() == other.rhs.isSurjective() && lhs == other.lhs &&
+         rhs == other.rhs;
+}
+
+size_t LinearLayoutCache::KeyHash::operator()(const OperationKey &key) const {
+  return llvm::hash_combine(static_cast<int>(key.op), key.lhs, key.rhs);
+}
+
+size_t LinearLayoutCache::KeyHash::operator()(const ConversionKey &key) const {
+  return llvm::hash_combine(
+      llvm::hash_combine_range(key.shape.begin(), key.shape.end()), key.layout,
+      key.elemBitWidth.value_or(0));
+}
+
+LinearLayout
+LinearLayoutCache::getOrCompute(Operation op, const LinearLayout &lhs,
+                                const LinearLayout &rhs,
+                                llvm::function_ref<LinearLayout()> compute) {
+  if (!enabled)
+    return compute();
+
+  OperationKey key{op, lhs, rhs};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = operations.find(key);
+    if (it != operations.end()) {
+      ++numHits;
+      return it->second;
+    }
+    ++numMisses;
+  }
+
+  // Compute without holding the lock, another thread may insert the same
+  // result meanwhile.
+  LinearLayout result = compute();
+  std::lock_guard<std::mutex> lock(mutex);
+  if (operations.size() >= maxCachedLayouts)
+    operations.clear();
+  operations.try_emplace(std::move(key), result);
+  return result;
+}
+
+LinearLayout LinearLayoutCache::compose(const LinearLayout &inner,
+                                        const LinearLayout &outer) {
+  return getOrCompute(Operation::Compose, inner, outer,
+                      [&] { return inner.compose(outer); });
+}
+
+LinearLayout LinearLayoutCache::invertAndCompose(const LinearLayout &inner,
+                                                 const LinearLayout &outer) {
+  return getOrCompute(Operation::InvertAndCompose, inner, outer,
+                      [&] { return inner.invertAndCompose(outer); });
+}
+
+LinearLayout LinearLayoutCache::product(const LinearLayout &inner,
+                                        const LinearLayout &outer) {
+  return getOrCompute(Operation::Product, inner, outer,
+                      [&] { return inner * outer; });
+}
+
+std::optional<LinearLayout> LinearLayoutCache::getOrConvert(
+    ArrayRef<int64_t> shape, Attribute layout,
+    std::optional<int32_t> elemBitWidth,
+    llvm::function_ref<std::optional<LinearLayout>()> convert) {
+  if (!enabled)
+    return convert();
+
+  ConversionKey key{llvm::to_vector(shape), layout, elemBitWidth};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = conversions.find(key);
+    if (it != conversions.end()) {
+      ++numHits;
+      return it->second;
+    }
+    ++numMisses;
+  }
+
+  std::optional<LinearLayout> result = convert();
+  std::lock_guard<std::mutex> lock(mutex);
+  if (conversions.size() >= maxCachedLayouts)
+    conversions.clear();
+  conversions.try_emplace(std::move(key), result);
+  return result;
+}
+
+size_t LinearLayoutCache::getNumHits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numHits;
+}
+
+size_t LinearLayoutCache::getNumMisses() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numMisses;
+}
+
+void LinearLayoutCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  operations.clear();
+  conversions.clear();
+  numHits = numMisses = 0;
+}
+
 } // namespace mlir::triton
@@ -383,6 +383,10 @@ class CMakeBuild(build_ext):
         if roctracer_include_dir == "":
             roctracer_include_dir = os.path.join(get_base_dir(), "third_party", "amd", "backend", "include")
         cmake_args += ["-DROCTRACER_INCLUDE_DIR=" + roctracer_include_dir]
+        level_zero_include_dir = get_env_with_keys(["LEVEL_ZERO_INCLUDE_PATH"])
+        if level_zero_include_dir == "":
+            level_zero_include_dir = os.path.join(os.getenv("ZE_PATH", default="/usr/local"), "include")
+        cmake_args += ["-DLEVEL_ZERO_INCLUDE_DIR=" + level_zero_include_dir]
         return cmake_args
 
     def build_extension(self, ext):
@@ -602,7 +606,7 @@ class plugin_egginfo(egg_info):
 
 
 package_data = {
-    "triton/tools": ["compile.h", "compile.c"],
+    "triton/tools": ["compile.h", "compile.c", "compile_xpu.h", "compile_xpu.c"],
     **{f"triton/backends/{b.name}": b.package_data
        for b in backends},
 }
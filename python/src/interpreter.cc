@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -302,6 +303,82 @@ makeAtomicRMWOp(pybind11::dtype dtype, const uint64_t *ptr, const void *val,
   return atomic_op;
 }
 
+// Gathers and scatters elements of `Size` bytes, or of `itemsize` bytes when
+// `Size` is 0. Runs of unmasked elements at consecutive addresses, which are
+// the common case of block accesses, are copied with a single memcpy, and so
+// are runs of masked elements taken from `other`.
+template <size_t Size>
+void maskedLoad(const uint64_t *ptr, const bool *mask, const char *other,
+                char *ret, size_t numel, size_t itemsize) {
+  const size_t size = Size != 0 ? Size : itemsize;
+  size_t i = 0;
+  while (i < numel) {
+    size_t end = i + 1;
+    if (mask[i]) {
+      while (end < numel && mask[end] && ptr[end] == ptr[end - 1] + size)
+        ++end;
+      std::memcpy(ret + i * size, reinterpret_cast<const void *>(ptr[i]),
+                  (end - i) * size);
+    } else {
+      while (end < numel && !mask[end])
+        ++end;
+      std::memcpy(ret + i * size, other + i * size, (end - i) * size);
+    }
+    i = end;
+  }
+}
+
+template <size_t Size>
+void maskedStore(const uint64_t *ptr, const char *value, const bool *mask,
+                 size_t numel, size_t itemsize) {
+  const size_t size = Size != 0 ? Size : itemsize;
+  size_t i = 0;
+  while (i < numel) {
+    if (!mask[i]) {
+      ++i;
+      continue;
+    }
+    size_t end = i + 1;
+    while (end < numel && mask[end] && ptr[end] == ptr[end - 1] + size)
+      ++end;
+    std::memcpy(reinterpret_cast<void *>(ptr[i]), value + i * size,
+                (end - i) * size);
+    i = end;
+  }
+}
+
+void maskedLoad(const uint64_t *ptr, const bool *mask, const char *other,
+                char *ret, size_t numel, size_t itemsize) {
+  switch (itemsize) {
+  case 1:
+    return maskedLoad<1>(ptr, mask, other, ret, numel, itemsize);
+  case 2:
+    return maskedLoad<2>(ptr, mask, other, ret, numel, itemsize);
+  case 4:
+    return maskedLoad<4>(ptr, mask, other, ret, numel, itemsize);
+  case 8:
+    return maskedLoad<8>(ptr, mask, other, ret, numel, itemsize);
+  default:
+    return maskedLoad<0>(ptr, mask, other, ret, numel, itemsize);
+  }
+}
+
+void maskedStore(const uint64_t *ptr, const char *value, const bool *mask,
+                 size_t numel, size_t itemsize) {
+  switch (itemsize) {
+  case 1:
+    return maskedStore<1>(ptr, value, mask, numel, itemsize);
+  case 2:
+    return maskedStore<2>(ptr, value, mask, numel, itemsize);
+  case 4:
+    return maskedStore<4>(ptr, value, mask, numel, itemsize);
+  case 8:
+    return maskedStore<8>(ptr, value, mask, numel, itemsize);
+  default:
+    return maskedStore<0>(ptr, value, mask, numel, itemsize);
+  }
+}
+
 } // namespace
 
 void init_triton_interpreter(py::module &&m) {
@@ -327,40 +404,44 @@ void init_triton_interpreter(py::module &&m) {
       .value("UMAX", RMWOp::UMAX)
       .export_values();
 
+  // The memory accesses release the GIL, so that program instances run by the
+  // parallel grid executor of the interpreter overlap.
   m.def("load",
-        [](py::array_t<uint64_t> ptr, py::array_t<bool> mask, py::array other,
-           py::dtype ret_dtype) -> py::array {
-          int numel = ptr.size();
+        [](py::array_t<uint64_t, py::array::c_style | py::array::forcecast> ptr,
+           py::array_t<bool, py::array::c_style | py::array::forcecast> mask,
+           py::array other, py::dtype ret_dtype) -> py::array {
+          size_t numel = ptr.size();
           auto shape =
               std::vector<ptrdiff_t>(ptr.shape(), ptr.shape() + ptr.ndim());
           py::array ret(ret_dtype, py::array::ShapeContainer{numel});
-          py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
-          py::array_t<bool> reshaped_mask = mask.reshape({numel});
-          py::array reshaped_others = other.reshape({numel});
-          for (size_t i = 0; i < ptr.size(); ++i) {
-            if (reshaped_mask.at(i))
-              memcpy(ret.mutable_data(i),
-                     reinterpret_cast<void *>(reshaped_ptr.at(i)),
-                     ret_dtype.itemsize());
-            else
-              memcpy(ret.mutable_data(i), reshaped_others.data(i),
-                     ret_dtype.itemsize());
+          py::array reshaped_others =
+              py::array::ensure(other.reshape({numel}), py::array::c_style);
+          auto *ptr_data = ptr.data();
+          auto *mask_data = mask.data();
+          auto *other_data = static_cast<const char *>(reshaped_others.data());
+          auto *ret_data = static_cast<char *>(ret.mutable_data());
+          auto itemsize = ret_dtype.itemsize();
+          {
+            py::gil_scoped_release release;
+            maskedLoad(ptr_data, mask_data, other_data, ret_data, numel,
+                       itemsize);
           }
           return ret.reshape(shape);
         });
 
   m.def("store",
-        [](py::array_t<uint64_t> ptr, py::array value, py::array_t<bool> mask) {
-          int numel = ptr.size();
-          py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
-          py::array_t<int8_t> reshaped_mask = mask.reshape({numel});
-          py::array reshaped_value = value.reshape({numel});
-          for (size_t i = 0; i < ptr.size(); ++i) {
-            if (reshaped_mask.at(i)) {
-              memcpy(reinterpret_cast<void *>(reshaped_ptr.mutable_at(i)),
-                     reshaped_value.data(i), value.dtype().itemsize());
-            }
-          }
+        [](py::array_t<uint64_t, py::array::c_style | py::array::forcecast> ptr,
+           py::array value,
+           py::array_t<bool, py::array::c_style | py::array::forcecast> mask) {
+          size_t numel = ptr.size();
+          py::array reshaped_value =
+              py::array::ensure(value.reshape({numel}), py::array::c_style);
+          auto *ptr_data = ptr.data();
+          auto *mask_data = mask.data();
+          auto *value_data = static_cast<const char *>(reshaped_value.data());
+          auto itemsize = value.dtype().itemsize();
+          py::gil_scoped_release release;
+          maskedStore(ptr_data, value_data, mask_data, numel, itemsize);
         });
 
   m.def("atomic_rmw",
@@ -406,7 +487,10 @@ void init_triton_interpreter(py::module &&m) {
 
 #undef MAKE_ATOMIC_RMW_OP
 
-          atomic_op->apply();
+          {
+            py::gil_scoped_release release;
+            atomic_op->apply();
+          }
           return ret.reshape(shape);
         });
 
@@ -426,10 +510,13 @@ void init_triton_interpreter(py::module &&m) {
           memcpy(static_cast<void *>(ret.mutable_data()),
                  static_cast<const void *>(reshaped_cmp.data()),
                  itemsize * numel);
-          AtomicCASOp(reshaped_ptr.data(), ret.mutable_data(),
-                      static_cast<const void *>(reshaped_val.data()), itemsize,
-                      numel, order)
-              .apply();
+          AtomicCASOp atomic_op(reshaped_ptr.data(), ret.mutable_data(),
+                                static_cast<const void *>(reshaped_val.data()),
+                                itemsize, numel, order);
+          {
+            py::gil_scoped_release release;
+            atomic_op.apply();
+          }
           return ret.reshape(shape);
         });
 }
@@ -28,6 +28,7 @@
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/IR/Types.h"
 #include "triton/Dialect/Triton/IR/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/Support/SourceMgr.h"
 
@@ -218,6 +219,7 @@ void init_triton_ir(py::module &&m) {
       .value("TF32", InputPrecision::TF32)
       .value("TF32x3", InputPrecision::TF32x3)
       .value("IEEE", InputPrecision::IEEE)
+      .value("BF16x3", InputPrecision::BF16x3)
       .export_values();
 
   py::class_<MLIRContext>(m, "context", py::module_local())
@@ -229,7 +231,9 @@ void init_triton_ir(py::module &&m) {
              self.printStackTraceOnDiagnostic(v);
            })
       .def("disable_multithreading",
-           [](MLIRContext &self) { self.disableMultithreading(); });
+           [](MLIRContext &self) { self.disableMultithreading(); })
+      .def("enable_multithreading",
+           [](MLIRContext &self) { self.enableMultithreading(); });
 
   py::class_<SourceMgrDiagnosticHandler>(m, "source_mgr_diag",
                                          py::module_local())
@@ -492,6 +496,14 @@ void init_triton_ir(py::module &&m) {
              self.print(os, printingFlags);
              return str;
            })
+      .def("bytecode",
+           [](ModuleOp &self) -> py::bytes {
+             std::string str;
+             llvm::raw_string_ostream os(str);
+             if (failed(writeBytecodeToFile(self, os)))
+               throw std::runtime_error("Failed to write MLIR bytecode");
+             return py::bytes(os.str());
+           })
       .def("push_back",
            [](ModuleOp &self, FuncOp &funcOp) -> void {
              self.push_back(funcOp);
@@ -813,6 +825,24 @@ void init_triton_ir(py::module &&m) {
               std::vector<int64_t> &shape) -> Type {
              return RankedTensorType::get(shape, elementType);
            })
+      // Type of an unswizzled buffer in local (shared) memory
+      .def("get_local_buffer_ty",
+           [](TritonOpBuilder &self, Type &elementType,
+              std::vector<int64_t> &shape) -> Type {
+             MLIRContext *ctx = elementType.getContext();
+             SmallVector<unsigned> order;
+             for (unsigned i = shape.size(); i > 0; --i)
+               order.push_back(i - 1);
+             auto CTALayout =
+                 ::mlir::triton::gpu::CTALayoutAttr::getDefault(ctx,
+                                                                shape.size());
+             auto encoding = ::mlir::triton::gpu::SharedEncodingAttr::get(
+                 ctx, 1, 1, 1, order, CTALayout);
+             return MemDescType::get(
+                 shape, elementType, encoding,
+                 ::mlir::triton::gpu::SharedMemorySpaceAttr::get(ctx),
+                 /*mutableMemory=*/true);
+           })
       .def("get_function_ty",
            [](TritonOpBuilder &self, std::vector<Type> inTypes,
               std::vector<Type> outTypes) -> Type {
@@ -1598,6 +1628,20 @@ void init_triton_ir(py::module &&m) {
       // Force GPU barrier
       .def("create_barrier",
            [](TritonOpBuilder &self) { self.create<mlir::gpu::BarrierOp>(); })
+      // Local (shared) memory buffers, see `get_local_buffer_ty`. The
+      // barriers between their accesses are inserted by the membar analysis.
+      .def("create_local_alloc",
+           [](TritonOpBuilder &self, Type &type) -> Value {
+             return self.create<::mlir::triton::gpu::LocalAllocOp>(type);
+           })
+      .def("create_local_store",
+           [](TritonOpBuilder &self, Value &buffer, Value &value) {
+             self.create<::mlir::triton::gpu::LocalStoreOp>(value, buffer);
+           })
+      .def("create_local_load",
+           [](TritonOpBuilder &self, Value &buffer, Type &type) -> Value {
+             return self.create<::mlir::triton::gpu::LocalLoadOp>(type, buffer);
+           })
       // Make a block pointer (tensor pointer in Triton IR)
       .def("create_make_block_ptr",
            [](TritonOpBuilder &self, Value &base, std::vector<Value> &shape,
@@ -1708,6 +1752,9 @@ void init_triton_ir(py::module &&m) {
           self.enableTiming();
         }
 
+        // Passes don't call back into Python, so kernels can be compiled
+        // concurrently from several threads.
+        py::gil_scoped_release allow_threads;
         if (failed(self.run(mod.getOperation())))
           throw std::runtime_error("PassManager::run failed");
       });
@@ -2,7 +2,9 @@
 #include "mlir/Target/LLVMIR/LLVMTranslationInterface.h"
 #include "mlir/Target/LLVMIR/ModuleTranslation.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -17,6 +19,7 @@
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
@@ -25,6 +28,7 @@
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include <csignal>
 #include <memory>
+#include <mutex>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <stdexcept>
@@ -159,6 +163,34 @@ std::string translateLLVMIRToASM(llvm::Module &module,
 
 using ret = py::return_value_policy;
 
+// Loads the library at \p path in \p ctx. The library is read once per
+// process, and loaded lazily: the body of a function is only parsed when the
+// linker pulls it into a kernel.
+static std::unique_ptr<llvm::Module> loadExternLib(const std::string &path,
+                                                   llvm::SMDiagnostic &err,
+                                                   LLVMContext &ctx) {
+  static std::mutex mutex;
+  static llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> buffers;
+
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<llvm::MemoryBuffer> &cached = buffers[path];
+    if (!cached) {
+      llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> file =
+          llvm::MemoryBuffer::getFile(path);
+      if (!file) {
+        buffers.erase(path);
+        return nullptr;
+      }
+      cached = std::move(*file);
+    }
+    // The modules reference the cached contents, which are never released.
+    buffer = llvm::MemoryBuffer::getMemBuffer(cached->getMemBufferRef());
+  }
+  return llvm::getLazyIRModule(std::move(buffer), err, ctx);
+}
+
 void init_triton_llvm(py::module &&m) {
 
   py::class_<llvm::LLVMContext>(m, "context", py::module_local())
@@ -436,12 +468,20 @@ void init_triton_llvm(py::module &&m) {
                                const std::vector<std::string> &paths) {
     if (paths.empty())
       return;
+    // Nothing can be linked into a module without external references, e.g.
+    // a kernel using no library function.
+    auto isExternal = [](const llvm::GlobalValue &gv) {
+      return gv.isDeclaration() && !gv.getName().starts_with("llvm.");
+    };
+    if (llvm::none_of(dstMod->functions(), isExternal) &&
+        llvm::none_of(dstMod->globals(), isExternal))
+      return;
 
     LLVMContext &ctx = dstMod->getContext();
     llvm::Linker linker(*dstMod);
     for (const std::string &path : paths) {
       llvm::SMDiagnostic err;
-      std::unique_ptr<llvm::Module> libMod = llvm::parseIRFile(path, err, ctx);
+      std::unique_ptr<llvm::Module> libMod = loadExternLib(path, err, ctx);
       if (!libMod) {
         std::string message = "Failed to parse library at " + path;
         throw std::invalid_argument(message);
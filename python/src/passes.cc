@@ -81,6 +81,7 @@ void init_triton_passes_convert(py::module &&m) {
 void init_triton_passes_llvmir(py::module &&m) {
   using namespace mlir;
   ADD_PASS_WRAPPER_0("add_di_scope", createLLVMDIScopePass);
+  ADD_PASS_WRAPPER_1("add_di_scope_options", createLLVMDIScopePass, bool);
 }
 
 void init_triton_passes(py::module &&m) {
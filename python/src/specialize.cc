@@ -0,0 +1,221 @@
+#include <climits>
+#include <cstdint>
+#include <pybind11/pybind11.h>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+struct KernelParam {
+  py::str name;
+  // Null if the parameter has no default value.
+  py::object defaultValue;
+  bool isConstexpr;
+  bool specialize;
+  bool specializeOnAlignment;
+  bool isConst;
+  // The type of the parameter if it is annotated, e.g. "i32".
+  std::string annotationType;
+};
+
+// Native counterpart of the function generated by
+// `create_function_from_signature` in runtime/jit.py: binds the arguments of a
+// call to the parameters of the kernel, computes the same kernel cache key and
+// looks it up, without building the intermediate Python objects.
+//
+// Calls it cannot bind (missing or duplicated arguments) are left to the
+// Python binder, which raises the appropriate error.
+class Binder {
+public:
+  Binder(const py::list &params, py::object mangleType)
+      : mangleType(std::move(mangleType)) {
+    for (const auto &param : params) {
+      auto p = param.cast<py::tuple>();
+      KernelParam kp{p[0].cast<py::str>(),
+                     p[1].cast<bool>() ? py::object(p[2]) : py::object(),
+                     p[3].cast<bool>(),
+                     p[4].cast<bool>(),
+                     p[5].cast<bool>(),
+                     p[6].cast<bool>(),
+                     p[7].cast<std::string>()};
+      (kp.isConstexpr ? numConstexprs : numNonConstexprs)++;
+      this->params.push_back(std::move(kp));
+    }
+  }
+
+  // Return (kernel, key, bound_args, non_constexpr_vals), where kernel is
+  // `cache[key]` or None, or None if the call must be bound in Python.
+  py::object bind(const py::dict &cache, const py::tuple &args,
+                  const py::dict &kwargs, const std::string &keySuffix) {
+    size_t numArgs = args.size();
+    if (numArgs > params.size())
+      return py::none();
+
+    py::dict boundArgs;
+    py::tuple constexprVals(numConstexprs);
+    py::tuple nonConstexprVals(numNonConstexprs);
+    std::string sigKey, specKey;
+    size_t numBoundKwargs = 0, c = 0, n = 0;
+    for (size_t i = 0; i < params.size(); ++i) {
+      const KernelParam &param = params[i];
+      PyObject *kwarg = PyDict_GetItemWithError(kwargs.ptr(), param.name.ptr());
+      if (!kwarg && PyErr_Occurred())
+        throw py::error_already_set();
+      py::handle value;
+      if (i < numArgs) {
+        if (kwarg)
+          return py::none();
+        value = PyTuple_GET_ITEM(args.ptr(), i);
+      } else if (kwarg) {
+        value = kwarg;
+        numBoundKwargs++;
+      } else if (param.defaultValue) {
+        value = param.defaultValue;
+      } else {
+        return py::none();
+      }
+      boundArgs[param.name] = value;
+      if (param.isConstexpr) {
+        constexprVals[c++] = value;
+        continue;
+      }
+      nonConstexprVals[n++] = value;
+      if (param.annotationType.empty())
+        appendTypeKey(sigKey, value, param.isConst);
+      else
+        sigKey += param.annotationType;
+      if (param.specialize)
+        appendSpecKey(specKey, value, param.specializeOnAlignment);
+    }
+
+    py::dict excessKwargs;
+    if (numBoundKwargs < kwargs.size()) {
+      for (auto item : kwargs)
+        if (!boundArgs.contains(item.first))
+          excessKwargs[item.first] = item.second;
+    }
+
+    // Same as `''.join(sig_and_spec) + str((constexpr_vals, excess_kwargs))`.
+    std::string key = sigKey + specKey +
+                      py::str(py::make_tuple(constexprVals, excessKwargs))
+                          .cast<std::string>() +
+                      keySuffix;
+    py::str pyKey(key);
+    PyObject *kernel = PyDict_GetItemWithError(cache.ptr(), pyKey.ptr());
+    if (!kernel && PyErr_Occurred())
+      throw py::error_already_set();
+    py::object cached =
+        kernel ? py::reinterpret_borrow<py::object>(kernel) : py::none();
+    return py::make_tuple(cached, pyKey, boundArgs, nonConstexprVals);
+  }
+
+private:
+  // Same as `mangle_type`.
+  void appendTypeKey(std::string &key, py::handle arg, bool isConst) {
+    PyObject *obj = arg.ptr();
+    if (obj == Py_None) {
+      key += "none";
+    } else if (PyBool_Check(obj)) {
+      key += "i1";
+    } else if (PyLong_Check(obj)) {
+      int overflow;
+      long long value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+      if (overflow == 0) {
+        key += value >= INT32_MIN && value <= INT32_MAX ? "i32" : "i64";
+      } else if (overflow > 0) {
+        PyLong_AsUnsignedLongLong(obj);
+        // Larger than UINT64_MAX if this overflows too.
+        key += PyErr_Occurred() ? "i64" : "u64";
+        PyErr_Clear();
+      } else {
+        key += "i64";
+      }
+    } else if (PyFloat_Check(obj)) {
+      key += "fp32";
+    } else if (py::hasattr(arg, "tma_desc_cpu_ptr") ||
+               !py::hasattr(arg, "dtype")) {
+      key += mangleType(arg, isConst).cast<std::string>();
+    } else {
+      // dtypes are hashable, the type of the tensors of a dtype is memoized.
+      py::dict &types = isConst ? constTensorTypes : tensorTypes;
+      py::object dtype = arg.attr("dtype");
+      PyObject *type = PyDict_GetItemWithError(types.ptr(), dtype.ptr());
+      if (!type && PyErr_Occurred())
+        throw py::error_already_set();
+      if (!type) {
+        py::object mangled = mangleType(arg, isConst);
+        types[dtype] = mangled;
+        type = mangled.ptr();
+      }
+      key += py::reinterpret_borrow<py::str>(type).cast<std::string>();
+    }
+  }
+
+  // Same as `compute_spec_key`.
+  static void appendSpecKey(std::string &key, py::handle arg, bool align) {
+    PyObject *obj = arg.ptr();
+    if (PyLong_Check(obj)) {
+      // The low bits of the two's complement give the residues mod 16 and 8.
+      unsigned long long bits = PyLong_AsUnsignedLongLongMask(obj);
+      if (align && (bits & 15) == 0) {
+        key += 'D';
+        return;
+      }
+      if (align && (bits & 7) == 0) {
+        key += 'E';
+        return;
+      }
+      int overflow;
+      if (PyLong_AsLongLongAndOverflow(obj, &overflow) == 1 && !overflow) {
+        key += '1';
+        return;
+      }
+    } else if (py::hasattr(arg, "data_ptr")) {
+      char spec = 'N';
+      if (align) {
+        py::object ptr = arg.attr("data_ptr")();
+        unsigned long long address = PyLong_AsUnsignedLongLongMask(ptr.ptr());
+        if (PyErr_Occurred())
+          throw py::error_already_set();
+        if ((address & 63) == 0)
+          spec = 'A';
+        else if ((address & 15) == 0)
+          spec = 'D';
+      }
+      key += spec;
+      if (hasPointerRange32(arg))
+        key += 'S';
+      return;
+    }
+    key += 'N';
+  }
+
+  // Same as `has_pointer_range_32`.
+  static bool hasPointerRange32(py::handle arg) {
+    py::object storage = py::getattr(arg, "untyped_storage", py::none());
+    if (storage.is_none())
+      return false;
+    py::object nbytes = storage().attr("nbytes")();
+    long long size = PyLong_AsLongLong(nbytes.ptr());
+    if (size == -1 && PyErr_Occurred())
+      throw py::error_already_set();
+    return size < (1LL << 31);
+  }
+
+  std::vector<KernelParam> params;
+  size_t numConstexprs = 0;
+  size_t numNonConstexprs = 0;
+  py::object mangleType;
+  py::dict tensorTypes;
+  py::dict constTensorTypes;
+};
+
+} // namespace
+
+void init_triton_specialize(py::module &&m) {
+  py::class_<Binder>(m, "Binder", py::module_local())
+      .def(py::init<py::list, py::object>())
+      .def("bind", &Binder::bind);
+}
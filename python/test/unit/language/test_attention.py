@@ -0,0 +1,218 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import attention
+
+
+def num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal):
+    return triton.cdiv(min((q_block + 1) * BLOCK_M, seq_len) if causal else seq_len, BLOCK_N)
+
+
+@pytest.mark.parametrize("seqlens", [[256], [100, 512, 1, 300]])
+@pytest.mark.parametrize("causal", [True, False])
+@pytest.mark.parametrize("num_programs", [2, 64])
+def test_attention_schedule(seqlens, causal, num_programs):
+    num_heads, BLOCK_M, BLOCK_N = 3, 32, 16
+    schedule = attention.attention_schedule(seqlens, num_heads, BLOCK_M, BLOCK_N, causal, num_programs=num_programs)
+    items = schedule.items.tolist()
+    assert schedule.num_items == len(items) * num_heads
+    assert schedule.num_programs == min(num_programs, schedule.num_items)
+    # Every query block of every sequence is in exactly one work item.
+    seen = []
+    works = []
+    for row_offset, seq_len, q_block_0, q_block_1 in items:
+        i = seqlens.index(seq_len)
+        assert row_offset == sum(seqlens[:i])
+        q_blocks = [q_block_0] + ([q_block_1] if q_block_1 >= 0 else [])
+        seen += [(row_offset, q_block) for q_block in q_blocks]
+        works.append(sum(num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal) for q_block in q_blocks))
+    expected = [(sum(seqlens[:i]), q_block) for i, seq_len in enumerate(seqlens)
+                for q_block in range(triton.cdiv(seq_len, BLOCK_M))]
+    assert sorted(seen) == sorted(expected)
+    assert works == sorted(works, reverse=True)
+    paired = sum(q_block_1 >= 0 for *_, q_block_1 in items) > 0
+    assert paired == (len(expected) * num_heads >= 2 * num_programs)
+    if paired and causal:
+        # The pairs of the full blocks of a sequence have the same work.
+        seq_len = max(seqlens)
+        pairs = [sum(num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal) for q_block in item[2:] if q_block >= 0)
+                 for item in items
+                 if item[1] == seq_len and item[3] >= 0]
+        assert max(pairs) - min(pairs) <= 1
+
+
+def test_block_mask_indices():
+    block_mask = torch.tensor([[1, 0, 1, 1], [0, 0, 0, 0], [0, 1, 0, 0]], dtype=torch.bool)
+    counts, indices = attention.block_mask_indices(block_mask)
+    assert counts.tolist() == [3, 0, 1]
+    assert indices.tolist() == [[0, 2, 3, 0], [0, 0, 0, 0], [1, 0, 0, 0]]
+    schedule = attention.attention_schedule([96], 1, 32, 32, block_counts=counts, num_programs=1)
+    # The heaviest query block is paired with the lightest one.
+    assert schedule.items.tolist() == [[0, 96, 0, 1], [0, 96, 2, -1]]
+
+
+@pytest.mark.parametrize("causal", [True, False])
+def test_kv_block_range(causal, device):
+    BLOCK_M, BLOCK_N = 32, 16
+
+    @triton.jit
+    def kernel(out_ptr, seq_len, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, CAUSAL: tl.constexpr):
+        q_block = tl.program_id(0)
+        num_full, num_blocks = attention.kv_block_range(q_block, seq_len, BLOCK_M, BLOCK_N, CAUSAL)
+        tl.store(out_ptr + q_block * 2, num_full)
+        tl.store(out_ptr + q_block * 2 + 1, num_blocks)
+
+    seq_len = 200
+    num_q_blocks = triton.cdiv(seq_len, BLOCK_M)
+    out = torch.empty((num_q_blocks, 2), dtype=torch.int32, device=device)
+    kernel[(num_q_blocks, )](out, seq_len, BLOCK_M, BLOCK_N, causal)
+    for q_block, (num_full, num_blocks) in enumerate(out.tolist()):
+        rows = range(q_block * BLOCK_M, min((q_block + 1) * BLOCK_M, seq_len))
+        visible = [[col < seq_len and (not causal or col <= row) for col in range(num_blocks * BLOCK_N)] for row in rows]
+        assert num_blocks == num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal)
+        # The key blocks past the range are not visible to any query.
+        assert all(col >= seq_len or (causal and col > rows[-1]) for col in range(num_blocks * BLOCK_N, seq_len))
+        # The full key blocks are visible to every query of the block.
+        assert all(all(visible_row[:num_full * BLOCK_N]) for visible_row in visible)
+
+
+@triton.jit
+def attend(q_ptr, k_ptr, v_ptr, o_ptr, stride_t, q_block, seq_len, sm_scale, BLOCK_M: tl.constexpr,
+           BLOCK_N: tl.constexpr, HEAD_DIM: tl.constexpr, CAUSAL: tl.constexpr):
+    offs_m = q_block * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_d = tl.arange(0, HEAD_DIM)
+    q = tl.load(q_ptr + offs_m[:, None] * stride_t + offs_d[None, :], mask=offs_m[:, None] < seq_len, other=0.0)
+    m_i = tl.zeros([BLOCK_M], dtype=tl.float32) - float("inf")
+    l_i = tl.zeros([BLOCK_M], dtype=tl.float32)
+    acc = tl.zeros([BLOCK_M, HEAD_DIM], dtype=tl.float32)
+    num_full, num_blocks = attention.kv_block_range(q_block, seq_len, BLOCK_M, BLOCK_N, CAUSAL)
+    for kv_block in range(0, num_blocks):
+        offs_n = kv_block * BLOCK_N + tl.arange(0, BLOCK_N)
+        k = tl.load(k_ptr + offs_n[:, None] * stride_t + offs_d[None, :], mask=offs_n[:, None] < seq_len,
+                    other=0.0)
+        v = tl.load(v_ptr + offs_n[:, None] * stride_t + offs_d[None, :], mask=offs_n[:, None] < seq_len,
+                    other=0.0)
+        qk = tl.dot(q, tl.trans(k)) * sm_scale
+        if kv_block >= num_full:
+            mask = offs_n[None, :] < seq_len
+            if CAUSAL:
+                mask = mask & (offs_m[:, None] >= offs_n[None, :])
+            qk = tl.where(mask, qk, -1.0e6)
+        m_new = tl.maximum(m_i, tl.max(qk, 1))
+        p = tl.exp(qk - m_new[:, None])
+        alpha = tl.exp(m_i - m_new)
+        l_i = l_i * alpha + tl.sum(p, 1)
+        acc = acc * alpha[:, None] + tl.dot(p.to(v.dtype), v)
+        m_i = m_new
+    tl.store(o_ptr + offs_m[:, None] * stride_t + offs_d[None, :], acc / l_i[:, None],
+             mask=offs_m[:, None] < seq_len)
+
+
+def torch_attention(q, k, v, seqlens, causal, sm_scale):
+    return torch.cat([
+        torch.nn.functional.scaled_dot_product_attention(q_i.transpose(0, 1).float(),
+                                                         k_i.transpose(0, 1).float(), v_i.transpose(0, 1).float(),
+                                                         is_causal=causal, scale=sm_scale).transpose(0, 1)
+        for q_i, k_i, v_i in zip(torch.split(q, seqlens), torch.split(k, seqlens), torch.split(v, seqlens))
+    ])
+
+
+@pytest.mark.parametrize("seqlens", [[128, 128], [70, 300, 1]])
+@pytest.mark.parametrize("causal", [True, False])
+def test_persistent_attention(seqlens, causal, device):
+    num_heads, head_dim, BLOCK_M, BLOCK_N = 2, 32, 32, 16
+
+    @triton.jit
+    def kernel(q_ptr, k_ptr, v_ptr, o_ptr, items_ptr, num_items, stride_t, stride_h, sm_scale, NUM_HEADS: tl.constexpr,
+               BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, HEAD_DIM: tl.constexpr, CAUSAL: tl.constexpr):
+        for item_id in range(tl.program_id(0), num_items, tl.num_programs(0)):
+            head, row_offset, seq_len, q_block_0, q_block_1 = attention.work_item(items_ptr, item_id, NUM_HEADS)
+            offset = row_offset * stride_t + head * stride_h
+            attend(q_ptr + offset, k_ptr + offset, v_ptr + offset, o_ptr + offset, stride_t, q_block_0, seq_len,
+                   sm_scale, BLOCK_M, BLOCK_N, HEAD_DIM, CAUSAL)
+            if q_block_1 >= 0:
+                attend(q_ptr + offset, k_ptr + offset, v_ptr + offset, o_ptr + offset, stride_t, q_block_1, seq_len,
+                       sm_scale, BLOCK_M, BLOCK_N, HEAD_DIM, CAUSAL)
+
+    torch.manual_seed(0)
+    q, k, v = (torch.randn((sum(seqlens), num_heads, head_dim), device=device, dtype=torch.float16) for _ in range(3))
+    o = torch.empty((sum(seqlens), num_heads, head_dim), device=device, dtype=torch.float32)
+    sm_scale = head_dim**-0.5
+    # Use few programs so that each program walks items of several sequences.
+    schedule = attention.attention_schedule(seqlens, num_heads, BLOCK_M, BLOCK_N, causal, num_programs=3,
+                                            device=device)
+    kernel[(schedule.num_programs, )](q, k, v, o, schedule.items, schedule.num_items, q.stride(0), q.stride(1),
+                                      sm_scale, num_heads, BLOCK_M, BLOCK_N, head_dim, causal)
+    ref = torch_attention(q, k, v, seqlens, causal, sm_scale)
+    torch.testing.assert_close(o, ref, atol=1e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize("seqlens", [[256], [100, 0, 512, 1, 300]])
+def test_attention_schedule_from_offsets(seqlens, device):
+    num_heads, BLOCK_M = 3, 32
+
+    @triton.jit
+    def kernel(sequences_ptr, num_items_ptr, out_ptr, BLOCK_M: tl.constexpr, NUM_HEADS: tl.constexpr,
+               MAX_SEQUENCES: tl.constexpr):
+        for item_id in range(tl.program_id(0), tl.load(num_items_ptr), tl.num_programs(0)):
+            head, row_offset, seq_len, q_block_0, q_block_1 = attention.ragged_work_item(
+                sequences_ptr, item_id, BLOCK_M, NUM_HEADS, MAX_SEQUENCES)
+            tl.store(out_ptr + item_id * 5, head)
+            tl.store(out_ptr + item_id * 5 + 1, row_offset)
+            tl.store(out_ptr + item_id * 5 + 2, seq_len)
+            tl.store(out_ptr + item_id * 5 + 3, q_block_0)
+            tl.store(out_ptr + item_id * 5 + 4, q_block_1)
+
+    cu_seqlens = torch.tensor([0] + seqlens, dtype=torch.int32, device=device).cumsum(0).to(torch.int32)
+    schedule = attention.attention_schedule_from_offsets(cu_seqlens, num_heads, BLOCK_M, num_programs=4)
+    assert schedule.max_sequences >= len(seqlens)
+    assert schedule.num_programs == 4
+    num_items = schedule.num_items.item()
+    assert num_items == sum(triton.cdiv(triton.cdiv(seq_len, BLOCK_M), 2) for seq_len in seqlens) * num_heads
+    out = torch.empty((num_items, 5), dtype=torch.int32, device=device)
+    kernel[(schedule.num_programs, )](schedule.sequences, schedule.num_items, out, BLOCK_M, num_heads,
+                                      schedule.max_sequences)
+    # Every query block of every sequence is in exactly one work item per head, paired with its mirror.
+    seen = []
+    for head, row_offset, seq_len, q_block_0, q_block_1 in out.tolist():
+        num_blocks = triton.cdiv(seq_len, BLOCK_M)
+        assert q_block_1 == (num_blocks - 1 - q_block_0 if q_block_1 >= 0 else -1)
+        seen += [(head, row_offset, q_block) for q_block in (q_block_0, q_block_1) if q_block >= 0]
+    expected = [(head, sum(seqlens[:i]), q_block)
+                for i, seq_len in enumerate(seqlens)
+                for q_block in range(triton.cdiv(seq_len, BLOCK_M))
+                for head in range(num_heads)]
+    assert sorted(seen) == sorted(expected)
+
+
+def test_ragged_attention(device):
+    seqlens = [70, 300, 0, 1, 128]
+    num_heads, head_dim, BLOCK_M, BLOCK_N = 2, 32, 32, 16
+
+    @triton.jit
+    def kernel(q_ptr, k_ptr, v_ptr, o_ptr, sequences_ptr, num_items_ptr, stride_t, stride_h, sm_scale,
+               NUM_HEADS: tl.constexpr, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, HEAD_DIM: tl.constexpr,
+               MAX_SEQUENCES: tl.constexpr):
+        for item_id in range(tl.program_id(0), tl.load(num_items_ptr), tl.num_programs(0)):
+            head, row_offset, seq_len, q_block_0, q_block_1 = attention.ragged_work_item(
+                sequences_ptr, item_id, BLOCK_M, NUM_HEADS, MAX_SEQUENCES)
+            offset = row_offset * stride_t + head * stride_h
+            attend(q_ptr + offset, k_ptr + offset, v_ptr + offset, o_ptr + offset, stride_t, q_block_0, seq_len,
+                   sm_scale, BLOCK_M, BLOCK_N, HEAD_DIM, True)
+            if q_block_1 >= 0:
+                attend(q_ptr + offset, k_ptr + offset, v_ptr + offset, o_ptr + offset, stride_t, q_block_1, seq_len,
+                       sm_scale, BLOCK_M, BLOCK_N, HEAD_DIM, True)
+
+    torch.manual_seed(0)
+    q, k, v = (torch.randn((sum(seqlens), num_heads, head_dim), device=device, dtype=torch.float16) for _ in range(3))
+    o = torch.empty((sum(seqlens), num_heads, head_dim), device=device, dtype=torch.float32)
+    sm_scale = head_dim**-0.5
+    cu_seqlens = torch.tensor([0] + seqlens, dtype=torch.int32, device=device).cumsum(0).to(torch.int32)
+    # Use few programs so that each program walks items of several sequences.
+    schedule = attention.attention_schedule_from_offsets(cu_seqlens, num_heads, BLOCK_M, num_programs=3)
+    kernel[(schedule.num_programs, )](q, k, v, o, schedule.sequences, schedule.num_items, q.stride(0), q.stride(1),
+                                      sm_scale, num_heads, BLOCK_M, BLOCK_N, head_dim, schedule.max_sequences)
+    ref = torch_attention(q, k, v, [seq_len for seq_len in seqlens if seq_len > 0], True, sm_scale)
+    torch.testing.assert_close(o, ref, atol=1e-2, rtol=1e-2)
@@ -4,6 +4,7 @@ import torch
 import triton
 import triton.language as tl
 from test_core import check_type_supported
+from triton._internal_testing import is_xpu
 
 
 @triton.jit
@@ -105,3 +106,50 @@ def test_block_ptr_matmul_no_scf(shape, num_warps, device):
         num_warps=num_warps)
     golden = torch.matmul(a, b)
     torch.testing.assert_close(c, golden, check_dtype=False)
+
+
+@pytest.mark.skipif(not is_xpu(), reason="The address payload lowering is specific to XPU")
+@pytest.mark.parametrize("address_payload", ["0", "1"])
+@pytest.mark.parametrize("dtype_str", ["float16", "bfloat16"])
+@pytest.mark.parametrize("M, N, K", [(128, 128, 128), (96, 80, 112)])
+@pytest.mark.parametrize("trans_b", [False, True])
+def test_block_ptr_matmul_address_payload(address_payload, dtype_str, M, N, K, trans_b, device, monkeypatch):
+    # The 2D block loads reuse their address payload across the loop iterations by default.
+    monkeypatch.setenv("TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT", address_payload)
+
+    # A fresh kernel for each configuration, so that it is compiled with the environment above.
+    @triton.jit
+    def kernel(a_ptr, b_ptr, c_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn,  #
+               BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr, TRANS_B: tl.constexpr):
+        pid_m = tl.program_id(0)
+        # The nested loops check that the payloads hoisted out of the K loop are not reused across the N tiles.
+        for n in range(0, N, BLOCK_N):
+            a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                            offsets=(pid_m * BLOCK_M, 0), block_shape=(BLOCK_M, BLOCK_K), order=(1, 0))
+            if TRANS_B:
+                b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                                offsets=(0, n), block_shape=(BLOCK_K, BLOCK_N), order=(0, 1))
+            else:
+                b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                                offsets=(0, n), block_shape=(BLOCK_K, BLOCK_N), order=(1, 0))
+            acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+            for _ in range(0, K, BLOCK_K):
+                a = tl.load(a_block_ptr, boundary_check=(0, 1), padding_option="zero")
+                b = tl.load(b_block_ptr, boundary_check=(0, 1), padding_option="zero")
+                acc += tl.dot(a, b)
+                a_block_ptr = tl.advance(a_block_ptr, (0, BLOCK_K))
+                b_block_ptr = tl.advance(b_block_ptr, (BLOCK_K, 0))
+            c_block_ptr = tl.make_block_ptr(base=c_ptr, shape=(M, N), strides=(N, 1), offsets=(pid_m * BLOCK_M, n),
+                                            block_shape=(BLOCK_M, BLOCK_N), order=(1, 0))
+            tl.store(c_block_ptr, acc, boundary_check=(0, 1))
+
+    dtype = getattr(torch, dtype_str)
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device=device, dtype=dtype)
+    b = torch.randn((N, K), device=device, dtype=dtype).T if trans_b else torch.randn((K, N), device=device, dtype=dtype)
+    c = torch.empty((M, N), device=device, dtype=torch.float32)
+
+    BLOCK_M, BLOCK_N, BLOCK_K = 32, 32, 32
+    kernel[(triton.cdiv(M, BLOCK_M), )](a, b, c, M, N, K, a.stride(0), a.stride(1), b.stride(0), b.stride(1),  #
+                                        BLOCK_M, BLOCK_N, BLOCK_K, trans_b)
+    torch.testing.assert_close(c, torch.matmul(a.float(), b.float()), atol=1e-2, rtol=1e-2)
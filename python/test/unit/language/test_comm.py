@@ -0,0 +1,56 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel.comm import peer_pointers, remote_ptr, signal, wait
+
+
+@triton.jit
+def _ring_kernel(data_ptrs, flag_ptrs, num_ranks, epoch, BLOCK: tl.constexpr):
+    # Program `rank` plays the part of a rank, its buffer is `data_ptrs[rank]`.
+    rank = tl.program_id(0)
+    data_ptr = tl.load(data_ptrs + rank).to(tl.pointer_type(tl.float32))
+    flag_ptr = tl.load(flag_ptrs + rank).to(tl.pointer_type(tl.int32))
+    peer = (rank + 1) % num_ranks
+    offsets = tl.arange(0, BLOCK)
+    # Send the first half of the buffer to the second half of the next rank.
+    tl.store(remote_ptr(data_ptr + BLOCK + offsets, data_ptrs, rank, peer), tl.load(data_ptr + offsets))
+    signal(remote_ptr(flag_ptr, flag_ptrs, rank, peer), epoch)
+    wait(flag_ptr, epoch)
+    received = tl.load(data_ptr + BLOCK + offsets)
+    tl.store(data_ptr + offsets, received * 2)
+
+
+def _ring(data, flags, device):
+    BLOCK = data[0].numel() // 2
+    data_ptrs = peer_pointers(data, device)
+    flag_ptrs = peer_pointers(flags, device)
+    for epoch in range(1, 3):
+        expected = torch.roll(torch.stack([x[:BLOCK].to(device) for x in data]), 1, 0) * 2
+        _ring_kernel[(len(data), )](data_ptrs, flag_ptrs, len(data), epoch, BLOCK=BLOCK, launch_cooperative_grid=True)
+        torch.xpu.synchronize()
+        result = torch.stack([x[:BLOCK].to(device) for x in data])
+        torch.testing.assert_close(result, expected, atol=0, rtol=0)
+
+
+@pytest.mark.parametrize("num_ranks", [2, 4])
+def test_ring_same_device(num_ranks, device):
+    BLOCK = 1024
+    data = [torch.randn(2 * BLOCK, device=device) for _ in range(num_ranks)]
+    flags = [torch.zeros(1, dtype=torch.int32, device=device) for _ in range(num_ranks)]
+    _ring(data, flags, device)
+
+
+def test_ring_peer_devices(device):
+    if torch.xpu.device_count() < 2:
+        pytest.skip("requires two XPU devices")
+    from triton.runtime import driver
+    devices = [torch.device("xpu", i) for i in range(2)]
+    if not driver.active.utils.can_access_peer(0, 1):
+        pytest.skip("the devices cannot access each other's memory")
+    BLOCK = 1024
+    data = [torch.randn(2 * BLOCK, device=d) for d in devices]
+    flags = [torch.zeros(1, dtype=torch.int32, device=d) for d in devices]
+    _ring(data, flags, devices[0])
+
@@ -0,0 +1,24 @@
+import pytest
+import torch
+
+from triton.language.extra.intel import conv
+
+
+@pytest.mark.parametrize("N, H, W, C, K, R, S, stride, padding", [
+    (2, 14, 14, 64, 64, 3, 3, 1, 1),
+    (1, 15, 17, 32, 48, 3, 3, 2, 1),
+    (2, 8, 8, 16, 128, 1, 1, 1, 0),
+    (1, 9, 20, 3, 16, 5, 3, (1, 2), (2, 0)),
+])
+@pytest.mark.parametrize("dtype_str", ["float16", "bfloat16"])
+def test_conv2d(N, H, W, C, K, R, S, stride, padding, dtype_str, device):
+    torch.manual_seed(0)
+    dtype = getattr(torch, dtype_str)
+    x = torch.randn((N, C, H, W), device=device, dtype=dtype)
+    w = torch.randn((K, C, R, S), device=device, dtype=dtype)
+    # Pixels narrower than a block, so that the windows of the taps start
+    # before and end after the tiles.
+    y = conv.conv2d(x.permute(0, 2, 3, 1).contiguous(), w.permute(2, 3, 1, 0).contiguous(), stride=stride,
+                    padding=padding, BLOCK_M=16)
+    ref = torch.nn.functional.conv2d(x.float(), w.float(), stride=stride, padding=padding)
+    torch.testing.assert_close(y.permute(0, 3, 1, 2).float(), ref, atol=1e-1, rtol=1e-2)
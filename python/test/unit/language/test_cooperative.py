@@ -0,0 +1,52 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import grid_barrier
+
+
+@triton.jit
+def _rotate_kernel(x_ptr, tmp_ptr, out_ptr, num_programs_ptr, n_elements, barrier_ptr, BLOCK_SIZE: tl.constexpr):
+    pid = tl.program_id(0)
+    num_programs = tl.num_programs(0)
+    for start in range(pid * BLOCK_SIZE, n_elements, num_programs * BLOCK_SIZE):
+        offsets = start + tl.arange(0, BLOCK_SIZE)
+        mask = offsets < n_elements
+        tl.store(tmp_ptr + offsets, tl.load(x_ptr + offsets, mask=mask) * 2, mask=mask)
+    grid_barrier(barrier_ptr)
+    # Read the elements written by other programs before the barrier.
+    for start in range(pid * BLOCK_SIZE, n_elements, num_programs * BLOCK_SIZE):
+        offsets = start + tl.arange(0, BLOCK_SIZE)
+        mask = offsets < n_elements
+        tl.store(out_ptr + offsets, tl.load(tmp_ptr + (offsets + BLOCK_SIZE) % n_elements, mask=mask), mask=mask)
+    if pid == 0:
+        tl.store(num_programs_ptr, num_programs)
+
+
+@pytest.mark.parametrize("num_warps", [4, 32])
+def test_grid_barrier(num_warps, device):
+    n_elements, BLOCK_SIZE = 1 << 20, 256
+    x = torch.randn(n_elements, device=device)
+    tmp = torch.empty_like(x)
+    num_programs = torch.zeros(1, dtype=torch.int32, device=device)
+    barrier = torch.zeros(1, dtype=torch.int32, device=device)
+    # The grid is clamped to the programs resident on the device.
+    grid = (triton.cdiv(n_elements, BLOCK_SIZE), )
+    ref = torch.roll(x * 2, -BLOCK_SIZE)
+    # The barrier counter is reused by successive launches.
+    for _ in range(3):
+        out = torch.empty_like(x)
+        _rotate_kernel[grid](x, tmp, out, num_programs, n_elements, barrier, BLOCK_SIZE=BLOCK_SIZE,
+                             num_warps=num_warps, launch_cooperative_grid=True)
+        torch.testing.assert_close(out, ref, atol=0, rtol=0)
+    assert 1 <= num_programs.item() <= grid[0]
+    assert barrier.item() == 3 * num_programs.item()
+
+
+def test_cooperative_grid_too_large(device):
+    x = torch.zeros(1, device=device)
+    barrier = torch.zeros(1, dtype=torch.int32, device=device)
+    with pytest.raises(RuntimeError, match="cooperative grid"):
+        _rotate_kernel[(1, 1 << 16, 1 << 10)](x, x, x, barrier, 1, barrier, BLOCK_SIZE=16,
+                                              launch_cooperative_grid=True)
@@ -1077,6 +1077,28 @@ def test_precise_math(expr_prec, expr_ref, num_ctas, device):
     assert torch.all(out == out_ref)  # bitwise exact
 
 
+@pytest.mark.parametrize("expr", ['tl.exp(x)', 'tl.log(x)', 'tl.sin(x)', 'tl.rsqrt(x)', 'tl.sigmoid(x)', 'tl.math.erf(x)',
+                                  'libdevice.tanh(x)'])
+@pytest.mark.parametrize("math_precision, tol", [('approx', 1e-5), ('fast', 1e-3)])
+def test_math_precision(expr, math_precision, tol, device):
+    if not is_xpu():
+        pytest.skip("math_precision is only supported on XPU")
+
+    @triton.jit
+    def kernel(X, OUT, BLOCK: tl.constexpr):
+        x = tl.load(X + tl.arange(0, BLOCK))
+        tl.store(OUT + tl.arange(0, BLOCK), GENERATE_TEST_HERE)
+
+    x = torch.rand(1024, dtype=torch.float32, device=device) * 4 + 0.1
+    kernel = patch_kernel(kernel, {'GENERATE_TEST_HERE': expr})
+    out_ieee = torch.empty_like(x)
+    out = torch.empty_like(x)
+    kernel[(1, )](x, out_ieee, BLOCK=x.numel())
+    h = kernel[(1, )](x, out, BLOCK=x.numel(), math_precision=math_precision)
+    assert "__spirv_ocl_" in h.asm["llir"]
+    torch.testing.assert_close(out, out_ieee, rtol=tol, atol=tol)
+
+
 # ----------------
 # test abs
 # ----------------
@@ -1545,6 +1567,33 @@ def test_tensor_atomic_rmw_block(num_ctas, device):
     assert torch.min(x).item() == 0.0
 
 
+@pytest.mark.parametrize("dtype_x_str", ['float16', 'bfloat16'])
+@pytest.mark.parametrize("scope", ['cta', 'gpu', 'sys'])
+def test_tensor_atomic_add_16bit(dtype_x_str, scope, device):
+    if not is_xpu():
+        pytest.skip("16-bit atomic adds are only emulated on XPU")
+    n_elements, n_programs, BLOCK = 1021, 8, 1024
+
+    @triton.jit
+    def kernel(Z, X, n_elements, SCOPE: tl.constexpr, BLOCK: tl.constexpr):
+        # Contiguous pairs of elements are added at once, except at the odd end of the mask.
+        offsets = tl.arange(0, BLOCK)
+        mask = offsets < n_elements
+        x = tl.load(X + tl.program_id(0) * BLOCK + offsets, mask=mask)
+        tl.atomic_add(Z + offsets, x, mask=mask, scope=SCOPE)
+
+    dtype = getattr(torch, dtype_x_str)
+    # Small integers are added exactly in any order.
+    x = torch.randint(-4, 5, (n_programs, BLOCK), device=device).to(dtype)
+    z = torch.zeros(BLOCK, device=device, dtype=dtype)
+    z[n_elements:] = 7
+    kernel[(n_programs, )](z, x, n_elements, SCOPE=scope, BLOCK=BLOCK, num_warps=4)
+    ref = x[:, :n_elements].float().sum(0)
+    torch.testing.assert_close(z[:n_elements].float(), ref, atol=0, rtol=0)
+    # The elements outside of the mask are left unchanged.
+    assert torch.all(z[n_elements:] == 7)
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("sem", [None, 'acquire', 'release', 'acq_rel', 'relaxed'])
 @pytest.mark.parametrize("num_ctas", num_ctas_list)
@@ -1586,6 +1635,28 @@ def test_atomic_cas(sem, num_ctas, device):
     assert f"atom.global.{sem_str}" in h.asm["ptx"]
 
 
+@pytest.mark.interpreter
+@pytest.mark.skipif(not is_interpreter(), reason="The parallel grid executor is specific to the interpreter")
+@pytest.mark.parametrize("workers", ["TRITON_INTERPRET_NUM_THREADS", "TRITON_INTERPRET_NUM_PROCESSES"])
+def test_interpreter_parallel_grid(workers, device, monkeypatch):
+    monkeypatch.setenv(workers, "4")
+
+    @triton.jit
+    def kernel(X, Y, Count, BLOCK: tl.constexpr):
+        pid = tl.program_id(0) * tl.num_programs(1) + tl.program_id(1)
+        offs = pid * BLOCK + tl.arange(0, BLOCK)
+        tl.store(Y + offs, tl.load(X + offs) * 2)
+        tl.atomic_add(Count, 1)
+
+    BLOCK = 32
+    x = torch.randn((64 * BLOCK, ), device=device)
+    y = torch.empty_like(x)
+    count = torch.zeros((1, ), device=device, dtype=torch.int32)
+    kernel[(16, 4)](x, y, count, BLOCK=BLOCK)
+    torch.testing.assert_close(y, x * 2)
+    assert count.item() == 64
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("sem", [None, 'acquire', 'release', 'acq_rel', 'relaxed'])
 @pytest.mark.parametrize("num_ctas", num_ctas_list)
@@ -3118,7 +3189,7 @@ def convert_fp8_to_fp32(x, device, dtype_str):
     [(*shape, 4, False, False, epilogue, input_precision, in_dtype, out_dtype, 1)
      for shape in [(64, 64, 64), (32, 32, 32), (16, 16, 16)]
      for epilogue in ['none', 'trans', 'add-matrix', 'add-rows', 'add-cols', 'softmax', 'chain-dot']
-     for input_precision in ['tf32', 'tf32x3', 'ieee']
+     for input_precision in ['tf32', 'tf32x3', 'ieee'] + (['bf16x3'] if is_xpu() else [])
      for in_dtype, out_dtype in [('float16', 'float16'), ('float16', 'float32'), ('float32', 'float32')]
      if not (input_precision != 'ieee' and (in_dtype in ['float16']))] +
     [(*shape_nw, col_a, col_b, 'none', input_precision, in_dtype, out_dtype, kpack)
@@ -3922,7 +3993,9 @@ def test_vectorization_hints(has_hints, device):
 
 
 @pytest.mark.interpreter
-def test_assume(device):
+def test_assume(device, monkeypatch):
+    # The XPU backend only keeps the text of the LLVM IR on request.
+    monkeypatch.setenv("TRITON_INTEL_KEEP_LLIR", "1")
 
     @triton.jit
     def _kernel(out_ptr, N: tl.constexpr, BLOCK_N: tl.constexpr):
@@ -4943,6 +5016,26 @@ def test_globaltimer(device):
     assert h.asm["ptx"].count("%globaltimer") == 2
 
 
+@pytest.mark.skipif(not is_xpu(), reason="tl.extra.intel.clock requires SPIR-V")
+def test_clock(device, monkeypatch):
+    monkeypatch.setenv("TRITON_INTEL_KEEP_LLIR", "1")
+
+    @triton.jit
+    def kernel(Out1, Out2):
+        start = tl.extra.intel.clock()
+        off = tl.arange(0, 128)
+        for i in range(10000):
+            tl.store(Out1 + off, tl.load(Out1 + off) + 1)
+        end = tl.extra.intel.clock()
+        tl.store(Out2, end - start)
+
+    out1 = to_triton(np.zeros((128, ), dtype=np.int64), device=device)
+    out2 = to_triton(np.zeros((1, ), dtype=np.int64), device=device)
+    h = kernel[(1, )](out1, out2)
+    assert out2[0] > 0
+    assert h.asm["llir"].count("__spirv_ReadClockKHR") >= 2
+
+
 def test_smid(device):
     if is_hip():
         pytest.skip("test_smid is not supported in HIP")
@@ -5636,6 +5729,52 @@ def test_num_programs(device):
     assert torch.all(input == torch.tensor(grid, device=device))
 
 
+@pytest.mark.parametrize("num_warps", [1, 4])
+def test_explicit_scaling_program_id(num_warps, device, monkeypatch):
+    if not is_xpu():
+        pytest.skip("explicit scaling is only supported on XPU")
+    monkeypatch.setenv("TRITON_INTEL_EXPLICIT_SCALING", "1")
+    grid = (37, 3, 2)
+    out = torch.empty(grid[::-1], dtype=torch.int32, device=device)
+
+    @triton.jit
+    def kernel(out):
+        pid_0 = tl.program_id(0)
+        pid_1 = tl.program_id(1)
+        pid_2 = tl.program_id(2)
+        offset = (pid_2 * tl.num_programs(1) + pid_1) * tl.num_programs(0) + pid_0
+        tl.store(out + offset, pid_0 + pid_1 * 100 + pid_2 * 10000)
+
+    pgm = kernel[grid](out, num_warps=num_warps)
+    assert pgm.metadata.explicit_scaling
+    z, y, x = torch.meshgrid(*(torch.arange(n, device=device) for n in grid[::-1]), indexing="ij")
+    assert torch.all(out == (x + y * 100 + z * 10000).to(torch.int32))
+
+
+@pytest.mark.parametrize("grid_swizzle", [-1, 1, 4, 64])
+def test_grid_swizzle_program_id(grid_swizzle, device):
+    if not is_xpu():
+        pytest.skip("grid_swizzle is only supported on XPU")
+    grid = (37, 5)
+    counts = torch.zeros(grid, dtype=torch.int32, device=device)
+    order = torch.full(grid, -1, dtype=torch.int32, device=device)
+
+    @triton.jit
+    def kernel(counts, order):
+        pid_0 = tl.program_id(0)
+        pid_1 = tl.program_id(1)
+        offset = pid_0 * tl.num_programs(1) + pid_1
+        tl.atomic_add(counts + offset, 1)
+        tl.store(order + offset, pid_0 + pid_1 * 100)
+
+    pgm = kernel[grid](counts, order, grid_swizzle=grid_swizzle)
+    # The programs still cover each tile of the grid once.
+    assert torch.all(counts == 1)
+    x, y = torch.meshgrid(*(torch.arange(n, device=device) for n in grid), indexing="ij")
+    assert torch.all(order == (x + y * 100).to(torch.int32))
+    assert "tt.get_num_programs x" in pgm.asm["ttgir"]
+
+
 # -----------------------
 # test extern functions
 # -----------------------
@@ -0,0 +1,47 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel.dependent import DependencyFlag, wait_dependency
+
+
+@triton.jit
+def _producer_kernel(x_ptr, n_elements, BLOCK_SIZE: tl.constexpr):
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    tl.store(x_ptr + offsets, tl.load(x_ptr + offsets, mask=mask) + 1, mask=mask)
+
+
+@triton.jit
+def _consumer_kernel(x_ptr, w_ptr, y_ptr, n_elements, flag_ptr, epoch, BLOCK_SIZE: tl.constexpr):
+    offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    # The weights do not depend on the producer.
+    w = tl.load(w_ptr + offsets, mask=mask)
+    wait_dependency(flag_ptr, epoch)
+    tl.store(y_ptr + offsets, tl.load(x_ptr + offsets, mask=mask) * w, mask=mask)
+
+
+def test_dependent_launch(device):
+    n_elements, BLOCK_SIZE = 1 << 16, 1024
+    x = torch.zeros(n_elements, device=device)
+    w = torch.randn(n_elements, device=device)
+    flag = DependencyFlag(device)
+    grid = (triton.cdiv(n_elements, BLOCK_SIZE), )
+    # The consumer of each iteration reads the output of the producer before
+    # it, and the producer after it waits for the consumer.
+    for i in range(1, 6):
+        y = torch.empty_like(x)
+        _producer_kernel[grid](x, n_elements, BLOCK_SIZE=BLOCK_SIZE)
+        epoch = flag.signal()
+        _consumer_kernel[grid](x, w, y, n_elements, flag.flag, epoch, BLOCK_SIZE=BLOCK_SIZE, launch_pdl=True)
+        torch.testing.assert_close(y, w * i, atol=0, rtol=0)
+    assert flag.flag.item() == 5
+
+
+def test_dependent_grid_too_large(device):
+    x = torch.zeros(1, device=device)
+    flag = DependencyFlag(device)
+    with pytest.raises(RuntimeError, match="dependent launch"):
+        _consumer_kernel[(1, 1 << 16, 1 << 10)](x, x, x, 1, flag.flag, 0, BLOCK_SIZE=16, launch_pdl=True)
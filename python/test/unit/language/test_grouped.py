@@ -0,0 +1,96 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import grouped, streamk
+
+
+@pytest.mark.parametrize("group_m", [[64], [0, 96, 32, 0, 200], [17, 1, 130]])
+def test_grouped_gemm_schedule(group_m):
+    N, BLOCK_M, BLOCK_N = 96, 32, 32
+    schedule = grouped.grouped_gemm_schedule(group_m, N, BLOCK_M, BLOCK_N, num_programs=4)
+    assert schedule.max_problems >= len(group_m)
+    assert schedule.max_problems & (schedule.max_problems - 1) == 0
+    assert schedule.num_tiles == sum(triton.cdiv(m, BLOCK_M) for m in group_m) * triton.cdiv(N, BLOCK_N)
+    assert schedule.num_programs == min(4, schedule.num_tiles)
+    problems = schedule.problems.tolist()
+    tiles = [triton.cdiv(m, BLOCK_M) * triton.cdiv(N, BLOCK_N) for m in group_m]
+    for i, m in enumerate(group_m):
+        assert problems[i] == [sum(group_m[:i]), m, sum(tiles[:i])]
+    assert all(row[1] == 0 and row[2] == schedule.num_tiles for row in problems[len(group_m):])
+
+
+@pytest.mark.parametrize("group_m", [[64, 96, 32], [0, 100, 0, 7, 33]])
+def test_grouped_matmul(group_m, device):
+    N, K = 72, 128
+    BLOCK_M, BLOCK_N, BLOCK_K = 32, 32, 32
+
+    @triton.jit
+    def kernel(a_ptr, b_ptr, c_ptr, problems_ptr, num_tiles, N, K, stride_am, stride_ak, stride_be, stride_bk,
+               stride_bn, stride_cm, stride_cn, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+               MAX_PROBLEMS: tl.constexpr):
+        for tile_id in range(tl.program_id(0), num_tiles, tl.num_programs(0)):
+            problem, row_offset, M, pid_m, pid_n = grouped.problem_tile(problems_ptr, tile_id, N, BLOCK_M, BLOCK_N,
+                                                                        MAX_PROBLEMS)
+            acc = streamk.mac_loop(a_ptr + row_offset * stride_am, b_ptr + problem * stride_be, M, N, K, stride_am,
+                                   stride_ak, stride_bk, stride_bn, pid_m, pid_n, 0, tl.cdiv(K, BLOCK_K), BLOCK_M,
+                                   BLOCK_N, BLOCK_K)
+            streamk.store_tile(c_ptr + row_offset * stride_cm, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, True,
+                               BLOCK_M, BLOCK_N)
+
+    torch.manual_seed(0)
+    a = torch.randn((sum(group_m), K), device=device, dtype=torch.float16)
+    b = torch.randn((len(group_m), K, N), device=device, dtype=torch.float16)
+    c = torch.empty((sum(group_m), N), device=device, dtype=torch.float32)
+    # Use few programs so that each program walks tiles of several problems.
+    schedule = grouped.grouped_gemm_schedule(group_m, N, BLOCK_M, BLOCK_N, num_programs=3, device=device)
+    kernel[(schedule.num_programs, )](a, b, c, schedule.problems, schedule.num_tiles, N, K, a.stride(0), a.stride(1),
+                                      b.stride(0), b.stride(1), b.stride(2), c.stride(0), c.stride(1), BLOCK_M,
+                                      BLOCK_N, BLOCK_K, schedule.max_problems)
+    ref = torch.cat([a_i.float() @ b_i.float() for a_i, b_i in zip(torch.split(a, group_m), b)])
+    torch.testing.assert_close(c, ref, atol=1e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize("group_m", [[64], [0, 96, 32, 0, 200], [17, 1, 130]])
+def test_grouped_gemm_schedule_from_offsets(group_m, device):
+    N, BLOCK_M, BLOCK_N = 96, 32, 32
+    offsets = torch.tensor([0] + group_m, dtype=torch.int32, device=device).cumsum(0).to(torch.int32)
+    schedule = grouped.grouped_gemm_schedule_from_offsets(offsets, N, BLOCK_M, BLOCK_N, num_programs=4)
+    ref = grouped.grouped_gemm_schedule(group_m, N, BLOCK_M, BLOCK_N, num_programs=4)
+    assert schedule.max_problems == ref.max_problems
+    assert schedule.num_programs == 4
+    assert schedule.num_tiles.item() == ref.num_tiles
+    assert schedule.problems.tolist() == ref.problems.tolist()
+
+
+def test_grouped_matmul_from_offsets(device):
+    group_m = [0, 100, 0, 7, 33]
+    N, K = 72, 128
+    BLOCK_M, BLOCK_N, BLOCK_K = 32, 32, 32
+
+    @triton.jit
+    def kernel(a_ptr, b_ptr, c_ptr, problems_ptr, num_tiles_ptr, N, K, stride_am, stride_ak, stride_be, stride_bk,
+               stride_bn, stride_cm, stride_cn, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+               MAX_PROBLEMS: tl.constexpr):
+        num_tiles = tl.load(num_tiles_ptr)
+        for tile_id in range(tl.program_id(0), num_tiles, tl.num_programs(0)):
+            problem, row_offset, M, pid_m, pid_n = grouped.problem_tile(problems_ptr, tile_id, N, BLOCK_M, BLOCK_N,
+                                                                        MAX_PROBLEMS)
+            acc = streamk.mac_loop(a_ptr + row_offset * stride_am, b_ptr + problem * stride_be, M, N, K, stride_am,
+                                   stride_ak, stride_bk, stride_bn, pid_m, pid_n, 0, tl.cdiv(K, BLOCK_K), BLOCK_M,
+                                   BLOCK_N, BLOCK_K)
+            streamk.store_tile(c_ptr + row_offset * stride_cm, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, True,
+                               BLOCK_M, BLOCK_N)
+
+    torch.manual_seed(0)
+    a = torch.randn((sum(group_m), K), device=device, dtype=torch.float16)
+    b = torch.randn((len(group_m), K, N), device=device, dtype=torch.float16)
+    c = torch.empty((sum(group_m), N), device=device, dtype=torch.float32)
+    offsets = torch.tensor([0] + group_m, dtype=torch.int32, device=device).cumsum(0).to(torch.int32)
+    schedule = grouped.grouped_gemm_schedule_from_offsets(offsets, N, BLOCK_M, BLOCK_N, num_programs=3)
+    kernel[(schedule.num_programs, )](a, b, c, schedule.problems, schedule.num_tiles, N, K, a.stride(0), a.stride(1),
+                                      b.stride(0), b.stride(1), b.stride(2), c.stride(0), c.stride(1), BLOCK_M,
+                                      BLOCK_N, BLOCK_K, schedule.max_problems)
+    ref = torch.cat([a_i.float() @ b_i.float() for a_i, b_i in zip(torch.split(a, group_m), b)])
+    torch.testing.assert_close(c, ref, atol=1e-2, rtol=1e-2)
@@ -0,0 +1,43 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel.local import local_alloc, local_load, local_store
+
+
+@triton.jit
+def _sum_tiles_kernel(x_ptr, out_ptr, n_tiles, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr):
+    offsets = tl.arange(0, BLOCK_M)[:, None] * BLOCK_N + tl.arange(0, BLOCK_N)[None, :]
+    tile = local_alloc((BLOCK_M, BLOCK_N), tl.float32)
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    # The buffer is reused by every iteration.
+    for i in range(n_tiles):
+        local_store(tile, tl.load(x_ptr + i * BLOCK_M * BLOCK_N + offsets))
+        acc += local_load(tile)
+    tl.store(out_ptr + offsets, acc)
+
+
+@pytest.mark.parametrize("num_warps", [1, 4])
+def test_local_memory(num_warps, device):
+    BLOCK_M, BLOCK_N, n_tiles = 32, 64, 5
+    x = torch.randn((n_tiles, BLOCK_M, BLOCK_N), device=device)
+    out = torch.empty((BLOCK_M, BLOCK_N), device=device)
+    compiled = _sum_tiles_kernel[(1, )](x, out, n_tiles, BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N, num_warps=num_warps)
+    torch.testing.assert_close(out, x.sum(0))
+    assert "local_alloc" in compiled.asm["ttgir"]
+    assert compiled.metadata.shared >= BLOCK_M * BLOCK_N * 4
+
+
+@triton.jit
+def _broadcast_kernel(out_ptr, BLOCK: tl.constexpr):
+    buffer = local_alloc((BLOCK, ), tl.float16)
+    # Scalars are broadcast and cast to the buffer.
+    local_store(buffer, 3)
+    tl.store(out_ptr + tl.arange(0, BLOCK), local_load(buffer))
+
+
+def test_local_store_broadcast(device):
+    out = torch.empty(128, dtype=torch.float16, device=device)
+    _broadcast_kernel[(1, )](out, BLOCK=128)
+    torch.testing.assert_close(out, torch.full_like(out, 3))
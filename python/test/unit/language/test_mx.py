@@ -0,0 +1,57 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import mx
+
+
+@pytest.mark.parametrize("format", ["e4m3", "e5m2", "e2m1"])
+@pytest.mark.parametrize("M, N, K", [(1, 256, 512), (100, 130, 192), (256, 256, 1024)])
+def test_mx_matmul(format, M, N, K, device):
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device=device, dtype=torch.bfloat16)
+    w = torch.randn((K, N), device=device) * torch.logspace(-3, 3, N, device=device)
+    b, b_scale = mx.quantize_mx(w, format)
+    c = mx.mx_matmul(a, b, b_scale, format)
+    # The rescaled weights are exact in BF16, only the accumulation differs.
+    ref = (a.float() @ mx.dequantize_mx(b, b_scale, format)).to(torch.bfloat16)
+    torch.testing.assert_close(c, ref, atol=1e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize("format", ["e4m3", "e2m1"])
+def test_quantize_mx(format, device):
+    torch.manual_seed(0)
+    w = torch.randn((128, 64), device=device)
+    b, b_scale = mx.quantize_mx(w, format)
+    # The error is bounded by the clamping of the largest magnitude of each
+    # block to the largest magnitude of the format.
+    error = (mx.dequantize_mx(b, b_scale, format) - w).abs().max()
+    assert error <= w.abs().max() * (0.25 if format == "e2m1" else 2**-3)
+
+
+@triton.jit
+def _dot_scaled_kernel(a_ptr, a_scale_ptr, b_ptr, b_scale_ptr, c_ptr, M: tl.constexpr, N: tl.constexpr,
+                       K: tl.constexpr):
+    offs_m = tl.arange(0, M)
+    offs_n = tl.arange(0, N)
+    offs_k = tl.arange(0, K)
+    offs_s = tl.arange(0, K // 32)
+    a = tl.load(a_ptr + offs_m[:, None] * K + offs_k[None, :])
+    a_scale = tl.load(a_scale_ptr + offs_m[:, None] * (K // 32) + offs_s[None, :])
+    b = tl.load(b_ptr + offs_k[:, None] * N + offs_n[None, :])
+    b_scale = tl.load(b_scale_ptr + offs_n[:, None] * (K // 32) + offs_s[None, :])
+    c = mx.dot_scaled(a, a_scale, "e4m3", b, b_scale, "e5m2")
+    tl.store(c_ptr + offs_m[:, None] * N + offs_n[None, :], c)
+
+
+def test_dot_scaled(device):
+    torch.manual_seed(0)
+    M, N, K = 32, 32, 64
+    a, a_scale = mx.quantize_mx(torch.randn((M, K), device=device).t(), "e4m3")
+    b, b_scale = mx.quantize_mx(torch.randn((K, N), device=device), "e5m2")
+    a = a.t().contiguous()
+    c = torch.empty((M, N), device=device)
+    _dot_scaled_kernel[(1, )](a, a_scale, b, b_scale, c, M=M, N=N, K=K)
+    ref = mx.dequantize_mx(a.t(), a_scale, "e4m3").t() @ mx.dequantize_mx(b, b_scale, "e5m2")
+    torch.testing.assert_close(c, ref, atol=1e-3, rtol=1e-3)
@@ -0,0 +1,66 @@
+import numpy as np
+import pytest
+import scipy.stats
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import philox
+
+from test_random import PHILOX_32, PHILOX_64, CustomPhilox
+
+
+@pytest.mark.parametrize("seed", [0, 42, 0x0000000fcafeb0ba])
+@pytest.mark.parametrize("dtype", ["int32", "int64"])
+def test_randint_interleaved(seed, dtype, device):
+    BLOCK = 256
+
+    @triton.jit
+    def kernel(X, seed, BLOCK: tl.constexpr):
+        pid = tl.program_id(0).to(X.dtype.element_ty)
+        counter = pid * (BLOCK // 4) + tl.arange(0, BLOCK // 4)
+        rand = philox.randint_interleaved(seed, counter)
+        tl.store(X + pid * BLOCK + tl.arange(0, BLOCK), rand)
+
+    x = torch.empty((4 * BLOCK, ), dtype=getattr(torch, dtype), device=device)
+    kernel[(4, )](x, seed, BLOCK)
+    out_tri = x.cpu().numpy().astype(getattr(np, f"u{dtype}")).tolist()
+    # The interleaved stream is the stream of all the outputs of the successive Philox rounds.
+    gen = CustomPhilox(seed, config={"int32": PHILOX_32, "int64": PHILOX_64}[dtype])
+    out_ref = [gen.random_raw() for _ in out_tri]
+    assert out_tri == out_ref
+
+
+def test_rand_interleaved(device):
+    BLOCK_M, BLOCK_N = 32, 64
+
+    @triton.jit
+    def kernel(X, seed, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr):
+        offs_m = tl.program_id(0) * BLOCK_M + tl.arange(0, BLOCK_M)
+        counter = offs_m[:, None] * (BLOCK_N // 4) + tl.arange(0, BLOCK_N // 4)[None, :]
+        rand = philox.rand_interleaved(seed, counter)
+        tl.store(X + offs_m[:, None] * BLOCK_N + tl.arange(0, BLOCK_N)[None, :], rand)
+
+    x = torch.empty((1024, BLOCK_N), dtype=torch.float32, device=device)
+    kernel[(1024 // BLOCK_M, )](x, 42, BLOCK_M, BLOCK_N)
+    assert torch.all((x >= 0) & (x < 1))
+    assert scipy.stats.kstest(x.flatten().tolist(), 'uniform', args=(0, 1)).statistic < 0.01
+
+
+@pytest.mark.parametrize("p", [0.1, 0.5])
+def test_dropout(p, device):
+    BLOCK = 1024
+
+    @triton.jit
+    def kernel(X, Y, p, seed, BLOCK: tl.constexpr):
+        pid = tl.program_id(0)
+        offsets = pid * BLOCK + tl.arange(0, BLOCK)
+        counter = pid * (BLOCK // 4) + tl.arange(0, BLOCK // 4)
+        tl.store(Y + offsets, philox.dropout(tl.load(X + offsets), p, seed, counter))
+
+    x = torch.rand((64 * BLOCK, ), dtype=torch.float32, device=device) + 1
+    y = torch.empty_like(x)
+    kernel[(64, )](x, y, p, 123, BLOCK)
+    kept = y != 0
+    assert abs(kept.float().mean().item() - (1 - p)) < 1e-2
+    torch.testing.assert_close(y[kept], x[kept] / (1 - p))
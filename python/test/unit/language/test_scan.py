@@ -0,0 +1,22 @@
+import pytest
+import torch
+
+from triton.language.extra.intel import scan
+
+
+@pytest.mark.parametrize("n_elements", [1, 1000, 4096, 100003, 1 << 22])
+@pytest.mark.parametrize("dtype_str", ["float32", "int32"])
+def test_device_cumsum(n_elements, dtype_str, device):
+    torch.manual_seed(0)
+    if dtype_str == "int32":
+        x = torch.randint(-8, 8, (n_elements, ), device=device, dtype=torch.int32)
+        ref = torch.cumsum(x, 0, dtype=torch.int32)
+    else:
+        x = torch.rand((n_elements, ), device=device, dtype=torch.float32)
+        ref = torch.cumsum(x.double(), 0).float()
+    # Use small tiles so that most tiles look back over several predecessors.
+    out = scan.cumsum(x, BLOCK_SIZE=1024, num_warps=4)
+    if dtype_str == "int32":
+        torch.testing.assert_close(out, ref, atol=0, rtol=0)
+    else:
+        torch.testing.assert_close(out, ref, atol=1e-2, rtol=1e-4)
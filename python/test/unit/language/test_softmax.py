@@ -0,0 +1,48 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import softmax
+
+
+@pytest.mark.parametrize("n_cols", [1, 1000, 4096, 100003])
+@pytest.mark.parametrize("dtype_str", ["float32", "bfloat16"])
+def test_online_softmax(n_cols, dtype_str, device):
+    torch.manual_seed(0)
+    x = torch.randn((4, n_cols), device=device, dtype=getattr(torch, dtype_str)) * 10
+    # Use small chunks so that the running maximum is rescaled several times.
+    out = softmax.softmax(x, BLOCK_SIZE=1024, num_warps=4)
+    ref = torch.softmax(x.float(), dim=-1).to(x.dtype)
+    torch.testing.assert_close(out, ref, atol=1e-2 if dtype_str == "bfloat16" else 1e-6, rtol=1e-2)
+
+
+@pytest.mark.parametrize("n_cols", [1, 1000, 131072])
+def test_online_cross_entropy(n_cols, device):
+    torch.manual_seed(0)
+    logits = torch.randn((8, n_cols), device=device) * 10
+    target = torch.randint(0, n_cols, (8, ), device=device)
+    loss = softmax.cross_entropy(logits, target, BLOCK_SIZE=1024, num_warps=4)
+    ref = torch.nn.functional.cross_entropy(logits, target, reduction="none")
+    torch.testing.assert_close(loss, ref, atol=1e-4, rtol=1e-4)
+
+
+@triton.jit
+def _stats_kernel(x_ptr, m_ptr, s_ptr, N: tl.constexpr):
+    offsets = tl.arange(0, N)
+    x = tl.load(x_ptr + offsets, mask=offsets < N // 2, other=float("-inf"))
+    m, s = softmax.online_softmax_stats(x, 0)
+    tl.store(m_ptr, m)
+    tl.store(s_ptr, s)
+
+
+def test_online_softmax_stats(device):
+    N = 256
+    x = torch.randn(N, device=device)
+    m = torch.empty(1, device=device)
+    s = torch.empty(1, device=device)
+    _stats_kernel[(1, )](x, m, s, N=N)
+    # The masked out elements are ignored.
+    ref = x[:N // 2]
+    torch.testing.assert_close(m, ref.max().reshape(1))
+    torch.testing.assert_close(s, torch.exp(ref - ref.max()).sum().reshape(1))
@@ -0,0 +1,105 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import streamk
+
+
+@pytest.mark.parametrize("M, N, K, num_programs", [(64, 64, 64, 4), (96, 160, 256, 7), (512, 64, 32, 5),
+                                                   (1024, 1024, 512, 64)])
+def test_streamk_schedule(M, N, K, num_programs):
+    BLOCK_M, BLOCK_N, BLOCK_K = 32, 32, 32
+    schedule = streamk.streamk_schedule(M, N, K, BLOCK_M, BLOCK_N, BLOCK_K, num_programs=num_programs)
+    total_tiles = triton.cdiv(M, BLOCK_M) * triton.cdiv(N, BLOCK_N)
+    assert schedule.streamk_tiles + schedule.blocking_tiles == total_tiles
+    assert schedule.blocking_tiles % num_programs == 0
+    assert schedule.streamk_programs <= num_programs
+    # Every K loop iteration of the Stream-K tiles is processed exactly once.
+    iters = schedule.streamk_programs * schedule.full_iters + schedule.partial_iters
+    assert iters == schedule.streamk_tiles * schedule.iters_per_tile
+    assert schedule.partial_iters < max(schedule.streamk_programs, 1)
+
+
+@pytest.mark.parametrize("M, N, K", [(64, 96, 128), (200, 72, 320)])
+def test_streamk_matmul(M, N, K, device):
+    BLOCK_M, BLOCK_N, BLOCK_K, GROUP_M = 32, 32, 32, 2
+
+    @triton.jit
+    def kernel(a_ptr, b_ptr, c_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, stride_cm, stride_cn,
+               streamk_programs, full_iters, partial_iters, iters_per_tile, streamk_tiles, blocking_tiles,
+               BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr, GROUP_M: tl.constexpr):
+        pid = tl.program_id(0)
+        if tl.program_id(1) == 0 and pid < streamk_programs:
+            start_iter, last_iter = streamk.iter_range(pid, full_iters, partial_iters)
+            while start_iter < last_iter:
+                end_iter = streamk.tile_end(start_iter, last_iter, iters_per_tile)
+                pid_m, pid_n = streamk.tile_coords(start_iter // iters_per_tile, M, N, BLOCK_M, BLOCK_N, GROUP_M)
+                remain_iters = start_iter % iters_per_tile
+                acc = streamk.mac_loop(a_ptr, b_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m,
+                                       pid_n, remain_iters, remain_iters + end_iter - start_iter, BLOCK_M, BLOCK_N,
+                                       BLOCK_K)
+                full_tile = remain_iters == 0 and end_iter % iters_per_tile == 0
+                streamk.store_tile(c_ptr, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, full_tile, BLOCK_M, BLOCK_N)
+                start_iter = end_iter
+        elif tl.program_id(1) == 1 and pid < blocking_tiles:
+            pid_m, pid_n = streamk.tile_coords(pid + streamk_tiles, M, N, BLOCK_M, BLOCK_N, GROUP_M)
+            acc = streamk.mac_loop(a_ptr, b_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m, pid_n, 0,
+                                   iters_per_tile, BLOCK_M, BLOCK_N, BLOCK_K)
+            streamk.store_tile(c_ptr, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, True, BLOCK_M, BLOCK_N)
+
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device=device, dtype=torch.float16)
+    b = torch.randn((K, N), device=device, dtype=torch.float16)
+    c = torch.zeros((M, N), device=device, dtype=torch.float32)
+    # Use few programs so that some tiles are split across programs.
+    schedule = streamk.streamk_schedule(M, N, K, BLOCK_M, BLOCK_N, BLOCK_K, num_programs=4)
+    assert schedule.full_iters % schedule.iters_per_tile != 0
+
+    # Stream-K programs on the first row of the grid, data-parallel programs on the second.
+    grid = (max(schedule.streamk_programs, schedule.blocking_tiles), 2)
+    kernel[grid](a, b, c, M, N, K, a.stride(0), a.stride(1), b.stride(0), b.stride(1), c.stride(0), c.stride(1),
+                 schedule.streamk_programs, schedule.full_iters, schedule.partial_iters, schedule.iters_per_tile,
+                 schedule.streamk_tiles, schedule.blocking_tiles, BLOCK_M, BLOCK_N, BLOCK_K, GROUP_M)
+    torch.testing.assert_close(c, torch.matmul(a.float(), b.float()), atol=1e-2, rtol=1e-2)
+
+
+@pytest.mark.parametrize("SPLIT_K", [2, 5])
+@pytest.mark.parametrize("out_dtype", [torch.float32, torch.bfloat16])
+def test_splitk_reduce(SPLIT_K, out_dtype, device):
+    M, N, K = 96, 160, 1000
+    BLOCK_M, BLOCK_N, BLOCK_K = 32, 32, 32
+
+    @triton.jit
+    def kernel(a_ptr, b_ptr, c_ptr, workspace_ptr, counters_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn,
+               stride_cm, stride_cn, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr, BLOCK_K: tl.constexpr,
+               SPLIT_K: tl.constexpr):
+        tile_id = tl.program_id(0)
+        split_id = tl.program_id(1)
+        pid_m, pid_n = streamk.tile_coords(tile_id, M, N, BLOCK_M, BLOCK_N, 0)
+        iters_per_split = tl.cdiv(tl.cdiv(K, BLOCK_K), SPLIT_K)
+        start_iter = split_id * iters_per_split
+        end_iter = tl.minimum(start_iter + iters_per_split, tl.cdiv(K, BLOCK_K))
+        acc = streamk.mac_loop(a_ptr, b_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m, pid_n,
+                               start_iter, end_iter, BLOCK_M, BLOCK_N, BLOCK_K)
+        acc, last = streamk.splitk_reduce(acc, workspace_ptr, counters_ptr, tile_id, split_id, SPLIT_K)
+        if last:
+            streamk.store_tile(c_ptr, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, True, BLOCK_M, BLOCK_N)
+
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device=device, dtype=torch.float16)
+    b = torch.randn((K, N), device=device, dtype=torch.float16)
+    num_tiles = triton.cdiv(M, BLOCK_M) * triton.cdiv(N, BLOCK_N)
+    workspace, counters = streamk.splitk_workspace(num_tiles, SPLIT_K, BLOCK_M, BLOCK_N, device)
+    results = []
+    # The counters are reset by each launch, and the reduction order is fixed.
+    for _ in range(3):
+        c = torch.empty((M, N), device=device, dtype=out_dtype)
+        kernel[(num_tiles, SPLIT_K)](a, b, c, workspace, counters, M, N, K, a.stride(0), a.stride(1), b.stride(0),
+                                     b.stride(1), c.stride(0), c.stride(1), BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K)
+        results.append(c)
+    assert torch.all(counters == 0)
+    ref = torch.matmul(a.float(), b.float()).to(out_dtype)
+    torch.testing.assert_close(results[0], ref, atol=1e-2, rtol=1e-2)
+    for c in results[1:]:
+        assert torch.equal(c, results[0])
@@ -126,6 +126,34 @@ def test_print(func_type: str, data_type: str, device: str):
     assert all(delta == 0 for delta in diff.values())
 
 
+@pytest.mark.parametrize("func_type, data_type", [
+    ("device_print", "int32"),
+    ("device_print", "float16"),
+    ("device_print_scalar", "int8"),
+    ("print_no_arg", "int32"),
+    ("device_print_large", "int32"),
+    ("device_print_multiple_args", "int32"),
+    ("device_print_hex", "int64"),
+    ("device_print_negative", "int32"),
+    ("device_print_uint", "uint32"),
+])
+def test_print_buffer(func_type: str, data_type: str, device: str):
+    if device != "xpu" or is_interpreter():
+        pytest.skip("print buffers are only implemented for XPU")
+
+    def run(env):
+        proc = subprocess.run(
+            [sys.executable, print_path, "test_print", func_type, data_type, device],
+            capture_output=True,
+            env={**os.environ, **env},
+        )
+        assert proc.returncode == 0
+        return Counter(line for line in proc.stdout.decode("UTF-8").split("\n") if line)
+
+    # The records decoded from the print buffer print the same lines as printf.
+    assert run({"TRITON_INTEL_PRINT_BUFFER_SIZE": str(1 << 20)}) == run({})
+
+
 @pytest.mark.parametrize("func_type", assert_types)
 def test_assert(func_type: str, device: str):
     # The total number of elements in the 1-D tensor to assert on.
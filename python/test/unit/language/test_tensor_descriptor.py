@@ -0,0 +1,59 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton._internal_testing import is_xpu
+from triton.tools.experimental_descriptor import create_2d_tma_descriptor
+
+
+@pytest.mark.skipif(not is_xpu(), reason="Requires XPU tensor descriptors")
+@pytest.mark.parametrize("M, N", [(128, 64), (100, 48)])
+def test_tensor_descriptor_matmul(M, N, device):
+
+    @triton.jit
+    def kernel(a_desc, b_desc, c_ptr, M, N, K: tl.constexpr, BLOCK_M: tl.constexpr, BLOCK_N: tl.constexpr):
+        pid_m = tl.program_id(0)
+        pid_n = tl.program_id(1)
+        acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+        for k in range(0, K, 32):
+            a = tl._experimental_descriptor_load(a_desc, [pid_m * BLOCK_M, k], [BLOCK_M, 32], tl.float16)
+            b = tl._experimental_descriptor_load(b_desc, [k, pid_n * BLOCK_N], [32, BLOCK_N], tl.float16)
+            acc += tl.dot(a, b)
+        offs_m = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+        offs_n = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+        mask = (offs_m[:, None] < M) & (offs_n[None, :] < N)
+        tl.store(c_ptr + offs_m[:, None] * N + offs_n[None, :], acc, mask=mask)
+
+    K = 64
+    BLOCK_M, BLOCK_N = 64, 32
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device=device, dtype=torch.float16)
+    b = torch.randn((K, N), device=device, dtype=torch.float16)
+    c = torch.empty((M, N), device=device, dtype=torch.float32)
+    a_desc = create_2d_tma_descriptor(a.data_ptr(), M, K, BLOCK_M, 32, a.element_size())
+    b_desc = create_2d_tma_descriptor(b.data_ptr(), K, N, 32, BLOCK_N, b.element_size())
+    grid = (triton.cdiv(M, BLOCK_M), triton.cdiv(N, BLOCK_N))
+    compiled = kernel[grid](a_desc, b_desc, c, M, N, K, BLOCK_M, BLOCK_N)
+    torch.testing.assert_close(c, torch.matmul(a.float(), b.float()), atol=1e-2, rtol=1e-2)
+    # The accesses through the descriptors are lowered to block pointers.
+    assert "tt.make_tensor_ptr" in compiled.asm["ttir"]
+    assert "experimental_descriptor_load" not in compiled.asm["ttir"]
+
+
+@pytest.mark.skipif(not is_xpu(), reason="Requires XPU tensor descriptors")
+def test_tensor_descriptor_store(device):
+
+    @triton.jit
+    def kernel(x_ptr, y_desc, BLOCK: tl.constexpr):
+        pid = tl.program_id(0)
+        offs = pid * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(x_ptr + offs[:, None] * BLOCK + tl.arange(0, BLOCK)[None, :])
+        tl._experimental_descriptor_store(y_desc, x + 1, [pid * BLOCK, 0])
+
+    BLOCK = 32
+    x = torch.randn((4 * BLOCK, BLOCK), device=device, dtype=torch.float32)
+    y = torch.empty_like(x)
+    y_desc = create_2d_tma_descriptor(y.data_ptr(), 4 * BLOCK, BLOCK, BLOCK, BLOCK, y.element_size())
+    kernel[(4, )](x, y_desc, BLOCK)
+    torch.testing.assert_close(y, x + 1)
@@ -0,0 +1,39 @@
+import pytest
+import torch
+
+import triton
+import triton.language as tl
+from triton.language.extra.intel import topk
+
+
+@pytest.mark.parametrize("N, K", [(64, 64), (256, 8), (1024, 32)])
+def test_sorted_topk(N, K, device):
+
+    @triton.jit
+    def kernel(x_ptr, out_ptr, N: tl.constexpr, K: tl.constexpr):
+        row = tl.program_id(0)
+        x = tl.load(x_ptr + row * N + tl.arange(0, N))
+        tl.store(out_ptr + row * K + tl.arange(0, K), topk.sorted_topk(x, K))
+
+    torch.manual_seed(0)
+    x = torch.randn((4, N), device=device)
+    out = torch.empty((4, K), device=device)
+    kernel[(4, )](x, out, N, K)
+    torch.testing.assert_close(out, torch.topk(x, K).values, atol=0, rtol=0)
+
+
+@pytest.mark.parametrize("n_rows, n_cols, k", [(1, 32000, 50), (4, 128256, 1), (16, 1000, 40), (3, 5, 5)])
+@pytest.mark.parametrize("dtype_str", ["float32", "bfloat16"])
+def test_topk(n_rows, n_cols, k, dtype_str, device):
+    torch.manual_seed(0)
+    # Distinct values, so that the indices are unique.
+    x = torch.randperm(n_rows * n_cols, device=device).reshape(n_rows, n_cols).to(getattr(torch, dtype_str))
+    if dtype_str == "float32":
+        x -= n_rows * n_cols // 2
+    # Use small chunks so that the running top-k of a split is merged several times.
+    values, indices = topk.topk(x, k, BLOCK_SIZE=256)
+    ref_values, ref_indices = torch.topk(x, k)
+    torch.testing.assert_close(values, ref_values, atol=0, rtol=0)
+    torch.testing.assert_close(torch.gather(x, 1, indices), values, atol=0, rtol=0)
+    if dtype_str == "float32":
+        torch.testing.assert_close(indices, ref_indices)
@@ -25,6 +25,170 @@ def test_kwargs(use_cuda_graph: bool, device: str):
     _kernel[grid](dst=dst, src=src, N=N)
 
 
+def test_parallel_compile(device, monkeypatch):
+    monkeypatch.setenv("TRITON_COMPILE_WORKERS", "4")
+    # Run the passes of the configs concurrently in the shared context rather
+    # than loading them from the cache.
+    monkeypatch.setenv("TRITON_ALWAYS_COMPILE", "1")
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 10)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    assert len(_kernel.fn.cache[triton.runtime.driver.active.get_current_device()]) == len(configs)
+    torch.testing.assert_close(dst, src)
+
+
+@pytest.mark.parametrize("strategy", ["halving", "model"])
+def test_search_strategy(strategy, device):
+    from triton.runtime.autotune_search import ModelBasedSearch, SuccessiveHalving
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 10)]
+    search_strategy = SuccessiveHalving(eta=2) if strategy == "halving" else ModelBasedSearch(budget=2, num_initial=1)
+    reps = []
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=8, search_strategy=search_strategy)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    bench = _kernel._bench
+
+    def record_bench(*args, num_reps=None, **kwargs):
+        reps.append(num_reps)
+        return bench(*args, num_reps=num_reps, **kwargs)
+
+    _kernel._bench = record_bench
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(dst, src)
+    if strategy == "halving":
+        # 5 configs for 2ms, the 3 fastest for 4ms and the 2 fastest for 8ms.
+        assert reps == [2] * 5 + [4] * 3 + [8] * 2
+    else:
+        assert reps == [8, 8]
+    assert _kernel.best_config in _kernel.configs_timings
+
+
+def test_tuning_db(device, monkeypatch, tmp_path):
+    monkeypatch.setenv("TRITON_AUTOTUNE_DB", str(tmp_path / "tuning.db"))
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    tuned = triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)(_kernel)
+    tuned[grid](dst, src, N)
+
+    # Another process starts from the config stored in the database.
+    restarted = triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)(_kernel)
+    restarted._bench = lambda *args, **kwargs: pytest.fail("the stored config should not be benchmarked")
+    dst.zero_()
+    restarted[grid](dst, src, N)
+    assert restarted.best_config is next(c for c in configs if c.kwargs == tuned.best_config.kwargs)
+    torch.testing.assert_close(dst, src)
+
+    from triton.runtime.tuning_db import TuningDatabase
+    exported = tmp_path / "tuning.jsonl"
+    assert TuningDatabase(tmp_path / "tuning.db").export_records(exported) == 1
+    assert TuningDatabase(tmp_path / "imported.db").import_records(exported) == 1
+
+
+def test_link_kernels(device, monkeypatch):
+    if not hasattr(triton.runtime.driver.active.utils, "load_kernels"):
+        pytest.skip("Linking kernels is not supported by the backend")
+    monkeypatch.setenv("TRITON_LINK_KERNELS", "1")
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 10)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    kernels = list(_kernel.fn.cache[triton.runtime.driver.active.get_current_device()].values())
+    assert len(kernels) == len(configs)
+    # All the configs are loaded from a single module.
+    assert len({id(kernel.module) for kernel in kernels}) == 1
+    torch.testing.assert_close(dst, src)
+
+
+def test_async_compile(device):
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 2**i}) for i in range(5, 10)]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=1, async_compile=True)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    # The first call runs the fallback config while the configs are compiled.
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(dst, src)
+    assert not _kernel.cache
+    _kernel.compiling[(N, str(dst.dtype), str(src.dtype))].result()
+    # The next call tunes the compiled configs.
+    dst.zero_()
+    _kernel[grid](dst, src, N)
+    torch.testing.assert_close(dst, src)
+    assert len(_kernel.cache) == 1 and not _kernel.compiling
+
+
+def test_early_stop(device):
+    N = 1024 * 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 1024}), triton.Config(kwargs={'BLOCK_SIZE': 32})]
+
+    @triton.autotune(configs=configs, key=['N'], warmup=1, rep=10, early_stop=1.5)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N)
+    assert _kernel.best_config in configs
+    torch.testing.assert_close(dst, src)
+
+
 def test_restore(device):
     N = 1024
     src = torch.zeros(N, device=device)
@@ -130,3 +294,85 @@ def test_prune_configs(with_perf_model: bool, device: str):
         assert records['run_early_config_prune']
         assert records['capture_kwargs']
         assert records['capture_named_args']
+
+
+def test_matmul_perf_model(device):
+    if device != "xpu":
+        pytest.skip("The matmul performance model is only implemented for XPU")
+    from triton.backends.intel.matmul_perf_model import early_config_prune, estimate_matmul_time
+
+    M = N = K = 4096
+    a = torch.empty((M, K), device=device, dtype=torch.float16)
+    b = torch.empty((K, N), device=device, dtype=torch.float16)
+    c = torch.empty((M, N), device=device, dtype=torch.float32)
+    named_args = {"a_ptr": a, "b_ptr": b, "c_ptr": c, "M": M, "N": N, "K": K}
+
+    def config(block_m, block_n, block_k, num_warps, **kwargs):
+        return triton.Config({'BLOCK_SIZE_M': block_m, 'BLOCK_SIZE_N': block_n, 'BLOCK_SIZE_K': block_k, **kwargs},
+                             num_stages=2, num_warps=num_warps)
+
+    large = config(256, 256, 32, 32, grf_mode='large')
+    small = config(32, 32, 32, 4)
+    too_many_warps = config(256, 256, 32, 128)
+    # The accumulator of a 512x512 tile exceeds the GRF of 4 warps.
+    too_many_registers = config(512, 512, 32, 4, grf_mode='large')
+    assert early_config_prune([large, small, too_many_warps, too_many_registers], named_args) == [large, small]
+
+    def estimate(config):
+        return estimate_matmul_time(**named_args, **config.all_kwargs())
+
+    assert 0 < estimate(large) < estimate(small)
+
+
+def test_kernel_prune(device):
+    N = 1024
+    src = torch.randn(N, device=device)
+    dst = torch.empty(N, device=device)
+    records = {}
+
+    def kernel_prune(configs, kernels, named_args, **kwargs):
+        records['configs'] = configs
+        records['n_spills'] = [kernels[config].n_spills for config in configs]
+        return [configs[-1]]
+
+    configs = [triton.Config(kwargs={'BLOCK_SIZE': 32}), triton.Config(kwargs={'BLOCK_SIZE': 128})]
+
+    @triton.autotune(configs=configs, key=['N'], prune_configs_by={'kernel_prune': kernel_prune}, warmup=1, rep=1)
+    @triton.jit
+    def _kernel(dst, src, N, BLOCK_SIZE: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK_SIZE + tl.arange(0, BLOCK_SIZE)
+        x = tl.load(src + offsets, mask=offsets < N)
+        tl.store(dst + offsets, x, mask=offsets < N)
+
+    grid = lambda META: (triton.cdiv(N, META['BLOCK_SIZE']), )
+    _kernel[grid](dst, src, N=N)
+    torch.testing.assert_close(src, dst)
+    assert records['configs'] == configs
+    assert all(n_spills is not None for n_spills in records['n_spills'])
+    assert list(_kernel.configs_timings) == [configs[-1]]
+
+
+def test_resource_prune(device):
+    if device != "xpu":
+        pytest.skip("The resource prune is only implemented for XPU")
+    from collections import namedtuple
+    from types import SimpleNamespace
+    from triton.backends.intel.resource_prune import resource_prune
+
+    Metadata = namedtuple("Metadata", ["spill_size", "max_workgroups_per_xe_core"])
+
+    def kernel(spills, workgroups):
+        return SimpleNamespace(metadata=Metadata(spills, workgroups), n_spills=spills)
+
+    def config(block_size, num_stages=2, **kwargs):
+        return triton.Config({'BLOCK_SIZE': block_size, **kwargs}, num_stages=num_stages)
+
+    # The large GRF mode removes the spills of the first config, at the cost
+    # of half its occupancy.
+    spilling, large, deep, shallow = config(128), config(128, grf_mode='large'), config(64, 4), config(64, 1)
+    kernels = {spilling: kernel(256, 8), large: kernel(0, 4), deep: kernel(0, 1), shallow: kernel(0, 4)}
+    prune = resource_prune(max_spills=0, min_workgroups=2)
+    assert prune(list(kernels), kernels, {}) == [large, shallow]
+    # Without a config meeting the limits, only the dominated configs are dropped.
+    prune = resource_prune(max_spills=0, min_workgroups=16)
+    assert prune(list(kernels), kernels, {}) == [spilling, large, shallow]
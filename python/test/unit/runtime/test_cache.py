@@ -1,7 +1,11 @@
 import importlib.util
 import itertools
+import json
+import pathlib
+import re
 import shutil
 import tempfile
+import time
 
 import pytest
 import torch
@@ -9,6 +13,7 @@ import torch
 import triton
 import triton.language as tl
 from triton.runtime.jit import JITFunction
+from triton._internal_testing import is_xpu
 
 
 @triton.jit
@@ -168,6 +173,370 @@ def test_reuse(device, fresh_triton_cache):
     assert counter == 1
 
 
+def test_ir_bytecode_cache(device, fresh_triton_cache):
+    from triton.compiler.compiler import MLIR_BYTECODE_MAGIC
+
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    compiled = kernel[(1, )](x, 1, BLOCK=1024)
+    ttgir_files = list(pathlib.Path(fresh_triton_cache).rglob("*.ttgir"))
+    assert len(ttgir_files) == 1
+    assert ttgir_files[0].read_bytes().startswith(MLIR_BYTECODE_MAGIC)
+    # The stages are printed when they are accessed.
+    assert "tt.func" in compiled.asm["ttgir"]
+
+    # Compiling again from the cached stage parses its bytecode.
+    target = triton.runtime.driver.active.get_current_target()
+    recompiled = triton.compile(str(ttgir_files[0]), target=target)
+    assert recompiled.name == compiled.name
+
+
+def test_native_binary_cache(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("native binary caching is only implemented for XPU")
+
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    kernel[(1, )](x, 1, BLOCK=1024)
+    assert len(list(pathlib.Path(fresh_triton_cache).rglob("*.zebin"))) == 1
+
+    # Reload the kernel from the native binary.
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    y = torch.empty(1, dtype=torch.int32, device=device)
+    kernel[(1, )](y, 1, BLOCK=1024)
+    assert len(list(pathlib.Path(fresh_triton_cache).rglob("*.zebin"))) == 1
+    assert torch.equal(x, y)
+
+
+def test_shared_native_binaries(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("native binary caching is only implemented for XPU")
+    import os
+    import subprocess
+    import sys
+    from textwrap import dedent
+
+    # Workers starting together with the same cache directory.
+    code = dedent("""
+        import torch
+        import triton
+        import triton.language as tl
+
+        @triton.jit
+        def kernel(X, i, BLOCK: tl.constexpr):
+            tl.store(X + tl.arange(0, BLOCK), i)
+
+        x = torch.zeros(1024, dtype=torch.int32, device="xpu")
+        kernel[(1, )](x, 7, BLOCK=1024)
+        assert torch.all(x == 7).item()
+    """)
+    env = dict(os.environ, TRITON_CACHE_DIR=fresh_triton_cache, TRITON_INTEL_SHARED_NATIVE_BINARIES="1")
+    workers = [subprocess.Popen([sys.executable, "-c", code], env=env) for _ in range(4)]
+    assert [worker.wait() for worker in workers] == [0] * 4
+    assert len(list(pathlib.Path(fresh_triton_cache).rglob("*.zebin"))) == 1
+
+
+def test_kernel_resources(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("kernel resources are only reported for XPU")
+
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    compiled_kernel = kernel[(1, )](x, 1, BLOCK=1024)
+    metadata = compiled_kernel.metadata
+    assert metadata.grf_per_thread == compiled_kernel.n_regs
+    assert metadata.grf_per_thread in (0, 128, 256)
+    assert metadata.slm_size >= metadata.shared
+    assert metadata.spill_size == compiled_kernel.n_spills
+    assert metadata.simd_width == metadata.threads_per_warp
+    assert metadata.max_workgroups_per_xe_core >= 1
+
+
+def test_layout_conversions_report(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("layout conversions are only reported for XPU")
+
+    @triton.jit
+    def transpose(X, Y, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        x = tl.load(X + offs[:, None] * BLOCK + offs[None, :])
+        tl.store(Y + offs[:, None] * BLOCK + offs[None, :], tl.trans(x))
+
+    x = torch.randn((64, 64), device=device)
+    y = torch.empty_like(x)
+    compiled_kernel = transpose[(1, )](x, y, BLOCK=64)
+    torch.testing.assert_close(y, x.t())
+    for cvt in compiled_kernel.metadata.layout_conversions:
+        assert cvt["loc"] and tuple(cvt["shape"]) == (64, 64)
+        if cvt["register_local"]:
+            assert cvt["slm_bytes"] == cvt["barriers"] == 0
+        else:
+            assert cvt["slm_bytes"] > 0 and cvt["barriers"] >= 1
+
+
+def test_compile_times(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("compile times are only reported for XPU")
+
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    compile_times = kernel[(1, )](x, 1, BLOCK=1024).metadata.compile_times
+    assert set(compile_times) == {"frontend", "ttir", "ttgir", "llir", "spv", "load_binary"}
+    assert all(t >= 0 for t in compile_times.values())
+
+
+def test_stage_checkpoints(device, fresh_triton_cache, monkeypatch):
+    if not is_xpu():
+        pytest.skip("stage checkpoints are only implemented for XPU")
+
+    from triton.backends.intel.compiler import XPUBackend
+    make_llir = XPUBackend.make_llir
+    calls = []
+
+    def counting_make_llir(*args, **kwargs):
+        calls.append(1)
+        return make_llir(*args, **kwargs)
+
+    monkeypatch.setattr(XPUBackend, "make_llir", staticmethod(counting_make_llir))
+    ast_to_ttir = triton.compiler.compiler.ast_to_ttir
+    traces = []
+
+    def counting_ast_to_ttir(*args, **kwargs):
+        traces.append(1)
+        return ast_to_ttir(*args, **kwargs)
+
+    monkeypatch.setattr(triton.compiler.compiler, "ast_to_ttir", counting_ast_to_ttir)
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    small = kernel[(1, )](x, 1, BLOCK=1024, grf_mode='small')
+    assert len(calls) == 1
+    # The GRF mode is applied when the SPIR-V is loaded, which is reused.
+    large = kernel[(1, )](x, 1, BLOCK=1024, grf_mode='large')
+    assert len(calls) == 1
+    assert large.hash != small.hash
+    assert large.kernel == small.kernel
+    assert (small.metadata.build_flags, large.metadata.build_flags) == ("-cl-intel-128-GRF-per-thread",
+                                                                      "-cl-intel-256-GRF-per-thread")
+    # The LLVM pipeline only reuses the TTGIR.
+    kernel[(1, )](x, 1, BLOCK=1024, grf_mode='small', llvm_pipeline='fast')
+    assert len(calls) == 2
+    # The number of stages only reuses the TTIR, without tracing the kernel.
+    kernel[(1, )](x, 1, BLOCK=1024, grf_mode='small', num_stages=3)
+    assert len(calls) == 3
+    assert len(traces) == 1
+    # The number of warps too, as long as the kernel doesn't read it.
+    kernel[(1, )](x, 1, BLOCK=1024, grf_mode='small', num_warps=8)
+    assert len(calls) == 4
+    assert len(traces) == 1
+
+    @triton.jit
+    def warps_kernel(X):
+        tl.store(X, tl.extra.intel.num_warps())
+
+    warps_kernel[(1, )](x, num_warps=4)
+    warps_kernel[(1, )](x, num_warps=8)
+    assert len(traces) == 3
+    assert x.item() == 8
+
+
+def test_large_grf_fallback(device, fresh_triton_cache):
+    if not is_xpu():
+        pytest.skip("GRF modes are only implemented for XPU")
+
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    large = kernel[(1, )](x, 1, BLOCK=1024, grf_mode='large', num_warps=32, threads_per_warp=16)
+    assert (large.metadata.grf_mode, large.metadata.grf_mode_fallback) == ('large', False)
+    # A work-group of 64 sub-groups does not fit in the large GRF mode, whose selection is left to IGC.
+    fallback = kernel[(1, )](x, 1, BLOCK=1024, grf_mode='large', num_warps=64, threads_per_warp=16)
+    assert (fallback.metadata.grf_mode, fallback.metadata.grf_mode_fallback) == ('auto', True)
+    assert fallback.metadata.build_flags == "-cl-intel-enable-auto-large-GRF-mode"
+
+
+def test_llvm_pipeline(device, fresh_triton_cache, monkeypatch):
+    if not is_xpu():
+        pytest.skip("LLVM pipelines are only selectable for XPU")
+
+    monkeypatch.setenv("LLVM_ENABLE_TIMING", "1")
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    y = torch.empty(1, dtype=torch.int32, device=device)
+    full = kernel[(1, )](x, 1, BLOCK=1024)
+    fast = kernel[(1, )](y, 1, BLOCK=1024, llvm_pipeline='fast')
+    assert full is not fast
+    assert torch.equal(x, y)
+    for compiled_kernel in (full, fast):
+        assert "Pass execution timing report" in compiled_kernel.metadata.llvm_pass_timing
+        assert "LICM" in compiled_kernel.metadata.llvm_pass_timing
+    assert "SLPVectorizer" in full.metadata.llvm_pass_timing
+    assert "SLPVectorizer" not in fast.metadata.llvm_pass_timing
+    assert fast.metadata.slp_vectorization == {"trees": 0, "scalars": 0}
+
+
+def test_file_system_remote_cache(fresh_triton_cache, monkeypatch, tmp_path):
+    from triton.runtime.cache import RemoteCacheManager
+    monkeypatch.setenv("TRITON_REMOTE_CACHE_BACKEND", "triton.runtime.cache:FileSystemRemoteCacheBackend")
+    monkeypatch.setenv("TRITON_REMOTE_CACHE_DIR", str(tmp_path))
+
+    manager = RemoteCacheManager("key")
+    path = manager.put(b"spirv", "kernel.spv")
+    manager.put_group("kernel.json", {"kernel.spv": path})
+    assert list(tmp_path.rglob("kernel.spv"))
+
+    # Another node, with an empty local cache, materializes the entries from the shared directory.
+    shutil.rmtree(fresh_triton_cache)
+    manager = RemoteCacheManager("key")
+    assert pathlib.Path(manager.get_file("kernel.spv")).read_bytes() == b"spirv"
+    assert list(manager.get_group("kernel.json").keys()) == ["kernel.spv"]
+    assert manager.get_file("missing.spv") is None
+
+
+def test_remote_compile(device, fresh_triton_cache, monkeypatch):
+    import threading
+    import urllib.request
+    from triton.tools.compile_server import CompileServer
+
+    with CompileServer(("127.0.0.1", 0)) as server:
+        thread = threading.Thread(target=server.serve_forever, daemon=True)
+        thread.start()
+        address = f"127.0.0.1:{server.server_address[1]}"
+        # The unreachable servers are skipped.
+        monkeypatch.setenv("TRITON_COMPILE_SERVERS", f"127.0.0.1:1,{address}")
+        x = torch.empty(1024, dtype=torch.int32, device=device)
+        compiled = kernel[(1, )](x, 7, BLOCK=1024)
+        assert torch.all(x == 7).item()
+        assert server.stats["requests"] == 1
+        assert compiled.asm["spv"]
+        with urllib.request.urlopen(f"http://{address}/stats") as response:
+            assert json.loads(response.read())["requests"] == 1
+        server.shutdown()
+        thread.join()
+
+    # Without a reachable server, the kernel is compiled locally.
+    monkeypatch.setenv("TRITON_COMPILE_SERVERS", address)
+    y = torch.empty(512, dtype=torch.int32, device=device)
+    kernel[(1, )](y, 3, BLOCK=512)
+    assert torch.all(y == 3).item()
+
+
+def test_context_pool(device, fresh_triton_cache, monkeypatch):
+    from triton.compiler import compiler
+    pool = compiler.ContextPool()
+    monkeypatch.setattr(compiler, "_context_pool", pool)
+    monkeypatch.setenv("TRITON_CONTEXT_POOL_RECYCLE", "2")
+
+    x = torch.empty(1024, dtype=torch.int32, device=device)
+    for i, block in enumerate([128, 256, 512, 1024]):
+        kernel.cache[getattr(torch, device).current_device()].clear()
+        kernel[(1, )](x, i, BLOCK=block)
+        assert torch.all(x[:block] == i).item()
+    # Each context compiles two kernels before it is recycled.
+    assert (pool.created, pool.reused) == (2, 2)
+
+    monkeypatch.setenv("TRITON_CONTEXT_POOL", "0")
+    kernel.cache[getattr(torch, device).current_device()].clear()
+    kernel[(1, )](x, 4, BLOCK=64)
+    assert (pool.created, pool.reused) == (3, 2)
+
+
+def test_cache_eviction(fresh_triton_cache, monkeypatch):
+    from triton.runtime import cache
+    monkeypatch.setenv("TRITON_CACHE_MAX_SIZE", "4K")
+    monkeypatch.setattr(cache, "_bytes_since_eviction", None)
+    cache.reset_cache_stats()
+
+    def put_entry(key):
+        manager = cache.FileCacheManager(key)
+        path = manager.put(b"x" * 1024, "kernel.spv")
+        manager.put_group("kernel.json", {"kernel.spv": path})
+        return manager
+
+    managers = [put_entry(f"key{i}") for i in range(3)]
+    # Use the first entry, so that the second one is the least recently used.
+    time.sleep(0.01)
+    assert managers[0].get_group("kernel.json")
+    # Walk the cache on the next compilation.
+    monkeypatch.setattr(cache, "_bytes_since_eviction", None)
+    put_entry("key3")
+    assert managers[0].get_group("kernel.json")
+    assert managers[1].get_group("kernel.json") is None
+    stats = cache.get_cache_stats(with_size=True)
+    assert stats["evictions"] >= 1 and stats["bytes_evicted"] >= 1024
+    assert stats["bytes_written"] >= 4 * 1024
+    assert stats["size"] <= 4 * 1024
+
+
+def test_triton_key_cache(fresh_triton_cache, monkeypatch):
+    from triton.compiler.compiler import triton_key
+    triton_key.cache_clear()
+    try:
+        key = triton_key()
+        [cached] = pathlib.Path(fresh_triton_cache).rglob("triton_key.txt")
+        assert cached.read_text() == key
+
+        # The next processes read the key cached for the unchanged files.
+        cached.write_text(triton.__version__ + "-cached")
+        triton_key.cache_clear()
+        assert triton_key() == triton.__version__ + "-cached"
+
+        # Verifying the key hashes the files again.
+        monkeypatch.setenv("TRITON_VERIFY_KEY", "1")
+        triton_key.cache_clear()
+        assert triton_key() == key
+        assert cached.read_text() == key
+    finally:
+        triton_key.cache_clear()
+
+
+def test_kernel_manifest_prewarm(device, fresh_triton_cache, monkeypatch, tmp_path):
+    if not is_xpu():
+        pytest.skip("kernel manifests are only implemented for XPU")
+    from triton.backends.intel.prewarm import prewarm, read_manifest
+
+    manifest = tmp_path / "kernels.jsonl"
+    monkeypatch.setenv("TRITON_INTEL_KERNEL_MANIFEST", str(manifest))
+    x = torch.empty(1, dtype=torch.int32, device=device)
+    kernel[(1, )](x, 1, BLOCK=1024)
+    kernel[(1, )](x, 1, BLOCK=1024)
+    assert len(read_manifest(manifest)) == 1
+
+    # Drop the native binaries: prewarming rebuilds them from the recorded SPIR-V.
+    for path in pathlib.Path(fresh_triton_cache).rglob("*.zebin*"):
+        path.unlink()
+    loaded, missing = prewarm(manifest)
+    assert loaded == 1 and not missing
+    assert len(list(pathlib.Path(fresh_triton_cache).rglob("*.zebin"))) == 1
+
+
+def test_launch_capture(device, fresh_triton_cache, monkeypatch, tmp_path):
+    if not is_xpu():
+        pytest.skip("launch capture is only implemented for XPU")
+    from triton.backends.intel.driver import LaunchCapture
+
+    monkeypatch.setenv("TRITON_INTEL_CAPTURE_DIR", str(tmp_path))
+
+    @triton.jit
+    def add_one(x_ptr, n, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        mask = offs < n
+        tl.store(x_ptr + offs, tl.load(x_ptr + offs, mask=mask) + 1, mask=mask)
+
+    x = torch.zeros(16, dtype=torch.float32, device=device)
+    for _ in range(3):
+        add_one[(1, )](x, 16, BLOCK=16)
+    add_one[(1, )](x[:8], 8, BLOCK=16)
+    LaunchCapture._writer.submit(lambda: None).result()
+
+    # The first launch for each shape is captured, with the inputs of the launch.
+    manifests = sorted(tmp_path.glob("*/add_one.manifest"))
+    assert [path.parent.name for path in manifests] == ["add_one-0", "add_one-3"]
+    lines = manifests[1].read_text().splitlines()
+    assert "grid 1 1 1" in lines
+    assert "arg x_ptr tensor x_ptr.pt" in lines
+    assert "arg n i32 8" in lines
+    spirv = next(line.split(" ", 1)[1] for line in lines if line.startswith("spirv "))
+    assert pathlib.Path(spirv).is_file()
+    torch.testing.assert_close(torch.load(manifests[0].parent / "x_ptr.pt"), torch.zeros(16))
+    torch.testing.assert_close(torch.load(manifests[1].parent / "x_ptr.pt"), torch.full((8, ), 3.0))
+
+
 @pytest.mark.parametrize('mode', ['enable', 'disable', 'disable_on_alignment'])
 def test_specialize(mode, device, fresh_triton_cache):
     counter = 0
@@ -179,12 +548,67 @@ def test_specialize(mode, device, fresh_triton_cache):
     JITFunction.cache_hook = inc_counter
     x = torch.empty(1, dtype=torch.int32, device=device)
     function = {'enable': kernel, 'disable': kernel_nospec, 'disable_on_alignment': kernel_nospec_on_alignment}[mode]
-    target = {'enable': 3, 'disable': 1, 'disable_on_alignment': 2}[mode]
+    target = {'enable': 4, 'disable': 1, 'disable_on_alignment': 2}[mode]
     for i in [1, 2, 4, 8, 16, 32]:
         function[(1, )](x, i, BLOCK=512)
     assert counter == target
 
 
+def test_pointer_range_specialization(device):
+
+    @triton.jit
+    def kernel(X, Y):
+        offsets = tl.arange(0, 16)
+        tl.store(Y + offsets, tl.load(X + offsets))
+
+    x = torch.arange(16, dtype=torch.int32, device=device)
+    y = torch.empty_like(x)
+    # The offsets of the pointers to tensors smaller than 2GB are 32-bit wide.
+    pgm = kernel[(1, )](x, y)
+    assert pgm.asm["ttir"].count("tt.pointer_range = 32") == 2
+    # The size of the storage of a wrapped tensor is unknown.
+    pgm = kernel[(1, )](x, triton.reinterpret(y, tl.int32))
+    assert pgm.asm["ttir"].count("tt.pointer_range = 32") == 1
+    torch.testing.assert_close(y, x)
+
+    device = getattr(torch, device).current_device()
+    assert len(kernel.cache[device]) == 2
+
+
+def test_alignment_specialization(device):
+
+    @triton.jit
+    def kernel(X, stride):
+        tl.store(X + stride, 1)
+
+    x = torch.zeros(64, dtype=torch.int32, device=device)
+    # The base addresses and pitches of 2D block loads must be multiples of 64 and 16 bytes.
+    for args, divisibility in [((x, 24), [64, 8]), ((x[4:], 16), [16, 16]), ((x[1:], 8), [8])]:
+        pgm = kernel[(1, )](*args)
+        assert [int(d) for d in re.findall(r"tt.divisibility = (\d+)", pgm.asm["ttir"])] == divisibility
+
+
+def test_buckets(device):
+
+    @triton.jit(buckets={"n": [16, 64]})
+    def kernel(X, n, n_BUCKET: tl.constexpr = None):
+        tl.static_assert(n_BUCKET is None or n_BUCKET >= 16)
+        offsets = tl.arange(0, 128)
+        tl.store(X + offsets, offsets, mask=offsets < n)
+
+    x = torch.zeros(128, dtype=torch.int32, device=device)
+    for n in [1, 8, 16, 17, 32, 64, 100]:
+        kernel[(1, )](x, n)
+        assert x[n - 1] == n - 1 and (n == 128 or x[n] == 0)
+        x.zero_()
+
+    device = getattr(torch, device).current_device()
+    assert len(kernel.cache[device]) == 3
+    assert dict(kernel.cache_stats) == {
+        (0, ): {"hits": 2, "misses": 1}, (1, ): {"hits": 2, "misses": 1}, (2, ): {"hits": 0, "misses": 1}
+    }
+
+
 def test_annotation(device):
 
     @triton.jit
@@ -198,7 +622,32 @@ def test_annotation(device):
     kernel[(1, )](x, 8)
     kernel[(1, )](x, 16)
     kernel[(1, )](x, 17)
-    assert len(kernel.cache[device]) == 3
+    assert len(kernel.cache[device]) == 4
+
+
+@pytest.mark.parametrize("value", [None, True, False, 1, 8, 16, 17, -32, -24, 2**31, 2**63, 2**64, -2**63 - 1, 1.5])
+def test_native_binder(value, device):
+
+    @triton.jit(do_not_specialize=["j"], do_not_specialize_on_alignment=["k"])
+    def kernel(X, Y: tl.const, i, j, k, m: tl.int64, BLOCK: tl.constexpr, flag: tl.constexpr = False):
+        pass
+
+    kernel.create_binder()
+    x = torch.empty(1, dtype=torch.float16, device=device)
+    # The address of `y` is not a multiple of 16.
+    y = torch.empty(2, dtype=torch.float32, device=device)[1:]
+    for args, kwargs in [((x, y, value, value, value, value, 4), {"num_warps": 8}),
+                         ((x, ), {"Y": x, "i": value, "j": 1, "k": 16, "m": value, "BLOCK": value, "flag": True})]:
+        bound_args, sig_and_spec, constexpr_vals, non_constexpr_vals, excess_kwargs = kernel.binder(*args, **kwargs)
+        key = ''.join(sig_and_spec) + str((constexpr_vals, excess_kwargs))
+        # The native binder computes the same key and finds the kernel cached under it.
+        cache = {key + "(1, )": kernel}
+        assert kernel.native_binder.bind(cache, args, kwargs, "(1, )") == (kernel, key + "(1, )", bound_args,
+                                                                           non_constexpr_vals)
+    # Calls that cannot be bound natively are left to the Python binder.
+    assert kernel.native_binder.bind({}, (x, ), {}, "") is None
+    assert kernel.native_binder.bind({}, (x, y, 1, 1, 1, 1, 4, True, 1), {}, "") is None
+    assert kernel.native_binder.bind({}, (x, y, 1, 1, 1, 1, 4), {"X": x}, "") is None
 
 
 GLOBAL_DEFAULT_ARG = 1
@@ -424,6 +873,51 @@ def test_jit_warmup_cache(device) -> None:
     assert len(kernel_add.cache[device]) == 1
 
 
+def test_lazy_kernel_loading(device, fresh_triton_cache) -> None:
+
+    @triton.jit
+    def kernel_add(a, b, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    # Neither the IR nor the binary are read nor loaded until the kernel is launched.
+    compiled_kernel = kernel_add.warmup(torch.float32, torch.float32, torch.float32, 32, grid=(1, ))
+    assert compiled_kernel.module is None
+    assert not compiled_kernel.asm.data
+
+    a, b, o = (torch.randn(32, dtype=torch.float32, device=device) for _ in range(3))
+    assert kernel_add[(1, )](a, b, o, 32) is compiled_kernel
+    assert compiled_kernel.module is not None
+    assert set(compiled_kernel.asm.data) == {compiled_kernel.binary_ext}
+    torch.testing.assert_close(o, a + b)
+
+    # The IR stages are read again on each access rather than kept in memory.
+    assert "tt.func" in compiled_kernel.asm["ttir"]
+    assert set(compiled_kernel.asm.data) == {compiled_kernel.binary_ext}
+
+
+def test_kernel_handles_per_device(device, fresh_triton_cache) -> None:
+    if torch.xpu.device_count() < 2:
+        pytest.skip("requires two XPU devices")
+
+    @triton.jit
+    def kernel_add(a, b, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    # A compiled kernel launched on several devices is loaded once on each.
+    compiled_kernel = kernel_add.warmup(torch.float32, torch.float32, torch.float32, 32, grid=(1, ))
+    for _ in range(2):
+        for i in range(2):
+            with torch.xpu.device(i):
+                a, b, o = (torch.randn(32, dtype=torch.float32, device=f"xpu:{i}") for _ in range(3))
+                compiled_kernel[(1, )](a, b, o)
+                assert compiled_kernel.device == i
+                torch.testing.assert_close(o, a + b)
+    assert set(compiled_kernel.handles) == {0, 1}
+    assert compiled_kernel.handles[0][1] != compiled_kernel.handles[1][1]
+
+
 def test_jit_debug(device) -> None:
 
     @triton.jit
@@ -0,0 +1,58 @@
+import torch
+
+import triton
+import triton.language as tl
+from triton.runtime.fusion import FusedLaunch
+
+
+@triton.jit
+def add_kernel(x_ptr, y_ptr, out_ptr, n, BLOCK: tl.constexpr):
+    offs = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+    mask = offs < n
+    tl.store(out_ptr + offs, tl.load(x_ptr + offs, mask=mask) + tl.load(y_ptr + offs, mask=mask), mask=mask)
+
+
+@triton.jit
+def relu_kernel(x_ptr, out_ptr, n, BLOCK: tl.constexpr):
+    offs = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+    mask = offs < n
+    tl.store(out_ptr + offs, tl.maximum(tl.load(x_ptr + offs, mask=mask), 0.0), mask=mask)
+
+
+@triton.jit
+def shift_kernel(x_ptr, out_ptr, n, BLOCK: tl.constexpr):
+    # Loads the elements stored by the next program.
+    offs = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+    mask = offs + 1 < n
+    tl.store(out_ptr + offs, tl.load(x_ptr + offs + 1, mask=mask), mask=mask)
+
+
+def test_fused_launch(device):
+    n = 1000
+    y = torch.randn(n, device=device)
+    tmp, out = torch.empty_like(y), torch.empty_like(y)
+    grid = (triton.cdiv(n, 128), )
+    fused = FusedLaunch()
+    for _ in range(3):
+        x = torch.randn(n, device=device)
+        with fused:
+            add_kernel[grid](x, y, tmp, n, BLOCK=128)
+            relu_kernel[grid](tmp, out, n, BLOCK=128)
+        torch.testing.assert_close(out, torch.relu(x + y))
+        torch.testing.assert_close(tmp, x + y)
+    assert fused.is_fused
+    assert fused.num_fused_launches == 2
+
+
+def test_fused_launch_not_elementwise(device):
+    n = 1000
+    x = torch.randn(n, device=device)
+    tmp, out = torch.empty_like(x), torch.empty_like(x)
+    grid = (triton.cdiv(n, 128), )
+    fused = FusedLaunch()
+    for _ in range(2):
+        with fused:
+            relu_kernel[grid](x, tmp, n, BLOCK=128)
+            shift_kernel[grid](tmp, out, n, BLOCK=128)
+        torch.testing.assert_close(out[:-1], torch.relu(x)[1:])
+    assert not fused.is_fused
@@ -9,8 +9,10 @@ import tracemalloc
 
 import torch
 
+import pytest
 import triton
 import triton.language as tl
+from triton._internal_testing import is_cuda, is_xpu
 
 # from typing import Tuple
 
@@ -43,6 +45,72 @@ def test_metadata() -> None:
     assert used_hook
 
 
+def test_launch_without_hooks(device) -> None:
+    if not is_xpu():
+        pytest.skip("Launches without hooks are only supported on XPU")
+
+    calls = []
+
+    def _launch_metadata(grid, kernel, args):
+        calls.append("metadata")
+        return {}
+
+    @triton.jit(launch_metadata=_launch_metadata)
+    def kernel(x_ptr, value):
+        tl.store(x_ptr, value)
+
+    x = torch.zeros(1, dtype=torch.int32, device=device)
+    compiled = kernel[(1, )](x, 1)
+    assert compiled.launcher is not None
+    kernel[(1, )](x, 2)
+    assert x.item() == 2
+    assert calls == []
+
+    # Setting a hook is detected by the next launch, which builds the launch metadata again.
+    version = triton.compiler.CompiledKernel.launch_hooks_version
+    triton.compiler.CompiledKernel.launch_enter_hook = lambda metadata: calls.append(metadata.get())
+    try:
+        assert triton.compiler.CompiledKernel.launch_hooks_version == version + 1
+        kernel[(1, )](x, 3)
+        assert compiled.launcher is None
+    finally:
+        triton.compiler.CompiledKernel.launch_enter_hook = None
+    assert x.item() == 3
+    assert calls[0] == "metadata" and calls[1]["name"] == "kernel"
+
+    kernel[(1, )](x, 4)
+    assert compiled.launcher is not None
+    assert x.item() == 4
+    assert len(calls) == 2
+
+
+def test_direct_launch(device, monkeypatch) -> None:
+    if not is_xpu():
+        pytest.skip("Direct launches are only supported on XPU")
+    monkeypatch.setenv("TRITON_INTEL_DIRECT_LAUNCH", "1")
+
+    @triton.jit
+    def kernel(x_ptr, y_ptr, n, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        mask = offsets < n
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets, mask=mask) + 1, mask=mask)
+
+    n = 10000
+    x = torch.arange(n, dtype=torch.float32, device=device)
+    y = torch.empty_like(x)
+    # The launches are ordered with the operations of the queue before and
+    # after them, also once the events of the launches are reused.
+    for _ in range(100):
+        x += 1
+        kernel[(triton.cdiv(n, 128), )](x, y, n, BLOCK=128)
+        x.copy_(y)
+    torch.testing.assert_close(x, torch.arange(n, dtype=torch.float32, device=device) + 200)
+    # Kernels launched last are waited for by the synchronization of the queue.
+    kernel[(triton.cdiv(n, 128), )](x, y, n, BLOCK=128)
+    torch.xpu.synchronize()
+    torch.testing.assert_close(y.cpu(), torch.arange(n, dtype=torch.float32) + 201)
+
+
 def test_memory_leak(device) -> None:
 
     @triton.jit
@@ -71,6 +139,265 @@ def test_memory_leak(device) -> None:
         tracemalloc.stop()
 
 
+def test_launch_packed(device) -> None:
+    if not is_xpu():
+        pytest.skip("Packed launches are only supported on XPU")
+
+    @triton.jit
+    def kernel(in_ptr0, out_ptr0, scale, xnumel, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tmp0 = tl.load(in_ptr0 + xindex, xmask)
+        tl.store(out_ptr0 + xindex, tmp0 * scale, xmask)
+
+    inp = torch.randn(100, device=device)
+    out = torch.zeros(100, device=device)
+    compiled = kernel[(7, )](inp, out, 2.0, 100, XBLOCK=16)
+
+    out.zero_()
+    stream = triton.runtime.driver.active.get_current_stream(inp.device.index)
+    packed = compiled.run.pack_args(inp, out, 3.0, 100)
+    compiled.run.launch_packed(7, 1, 1, stream, compiled.function, compiled.packed_metadata, packed)
+    torch.testing.assert_close(out, inp * 3.0)
+
+
+@pytest.mark.parametrize("direct", [False, True])
+def test_concurrent_launches(device, direct, monkeypatch) -> None:
+    if not is_xpu():
+        pytest.skip("Launches without the GIL are only supported on XPU")
+    import threading
+    monkeypatch.setenv("TRITON_INTEL_DIRECT_LAUNCH", "1" if direct else "0")
+
+    @triton.jit
+    def kernel(x_ptr, y_ptr, n, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        mask = offsets < n
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets, mask=mask) + 1, mask=mask)
+
+    n, num_threads, num_launches = 4096, 4, 100
+    xs = [torch.full((n, ), i, dtype=torch.float32, device=device) for i in range(num_threads)]
+    ys = [torch.empty_like(x) for x in xs]
+    kernel[(n // 128, )](xs[0], ys[0], n, BLOCK=128)
+    errors = []
+
+    # Each thread launches on its own queue, while the others submit theirs.
+    def launch(i):
+        try:
+            with torch.xpu.stream(torch.xpu.Stream()):
+                for _ in range(num_launches):
+                    kernel[(n // 128, )](xs[i], ys[i], n, BLOCK=128)
+                    xs[i].copy_(ys[i])
+                torch.xpu.current_stream().synchronize()
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=launch, args=(i, )) for i in range(num_threads)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert not errors
+    for i, x in enumerate(xs):
+        torch.testing.assert_close(x, torch.full((n, ), i + num_launches, dtype=torch.float32, device=device))
+
+
+def test_task_queue(device) -> None:
+    if not is_xpu():
+        pytest.skip("Task queues are only supported on XPU")
+
+    @triton.jit
+    def add_kernel(x_ptr, y_ptr, out_ptr, n, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        mask = offsets < n
+        x = tl.load(x_ptr + offsets, mask=mask)
+        y = tl.load(y_ptr + offsets, mask=mask)
+        tl.store(out_ptr + offsets, x + y, mask=mask)
+
+    n = 4096
+    grid = (n // 128, )
+    x = torch.ones(n, device=device)
+    a, b, c = (torch.empty_like(x) for _ in range(3))
+    tasks = triton.runtime.driver.active.create_task_queue(num_queues=2)
+    # A diamond: `a` and `b` only depend on `x`, and `c` on both.
+    ready = tasks.current_stream_event()
+    event_a = tasks.launch(add_kernel[grid], x, x, a, n, BLOCK=128, deps=[ready])
+    event_b = tasks.launch(add_kernel[grid], x, x, b, n, BLOCK=128, deps=[ready])
+    event_c = tasks.launch(add_kernel[grid], a, b, c, n, BLOCK=128, deps=[event_a, event_b])
+    event_c.synchronize()
+    assert event_a.query() and event_b.query() and event_c.query()
+    tasks.join()
+    torch.testing.assert_close(c, torch.full_like(c, 4))
+    # The current stream is ordered after the launches.
+    c.add_(1)
+    torch.testing.assert_close(c, torch.full_like(c, 5))
+
+
+def test_dead_args(device) -> None:
+    if not is_xpu():
+        pytest.skip("Dead kernel arguments are only removed on XPU")
+
+    @triton.jit
+    def kernel(in_ptr0, unused_ptr, out_ptr0, unused_scalar, xnumel, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tl.store(out_ptr0 + xindex, tl.load(in_ptr0 + xindex, xmask), xmask)
+
+    inp = torch.randn(100, device=device)
+    out = torch.zeros(100, device=device)
+    # The dead arguments are neither validated nor set: the CPU tensor would
+    # not pass the pointer validation.
+    compiled = kernel[(7, )](inp, torch.zeros(1), out, 3.0, 100, XBLOCK=16)
+    assert compiled.metadata.dead_args == [1, 3]
+    torch.testing.assert_close(out, inp)
+
+    out.zero_()
+    stream = triton.runtime.driver.active.get_current_stream(inp.device.index)
+    packed = compiled.run.pack_args(inp, None, out, 3.0, 100)
+    compiled.run.launch_packed(7, 1, 1, stream, compiled.function, compiled.packed_metadata, packed)
+    torch.testing.assert_close(out, inp)
+
+
+@pytest.mark.parametrize("specialized", [False, True])
+def test_launcher_signatures(device, specialized, monkeypatch) -> None:
+    if not is_xpu():
+        pytest.skip("The generic launcher is only used on XPU")
+    monkeypatch.setenv("TRITON_INTEL_SPECIALIZED_LAUNCHER", "1" if specialized else "0")
+
+    @triton.jit
+    def kernel(in_ptr0, out_ptr0, scale, xnumel, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tmp0 = tl.load(in_ptr0 + xindex, xmask)
+        tl.store(out_ptr0 + xindex, (tmp0 * scale).to(out_ptr0.dtype.element_ty), xmask)
+
+    launchers = []
+    for dtype, scale in [(torch.float32, 2.0), (torch.float16, 3), (torch.int8, 4)]:
+        inp = (torch.arange(100, device=device) % 16).to(dtype)
+        out = torch.zeros(100, dtype=dtype, device=device)
+        compiled = kernel[(7, )](inp, out, scale, 100, XBLOCK=16)
+        torch.testing.assert_close(out, (inp * scale).to(dtype))
+        launchers.append(compiled.run)
+
+        out.zero_()
+        stream = triton.runtime.driver.active.get_current_stream(inp.device.index)
+        packed = compiled.run.pack_args(inp, out, scale, 100)
+        compiled.run.launch_packed(7, 1, 1, stream, compiled.function, compiled.packed_metadata, packed)
+        torch.testing.assert_close(out, (inp * scale).to(dtype))
+
+    if not specialized:
+        # The kernels of all the signatures share the generic launcher.
+        assert len({launcher.launch.func for launcher in launchers}) == 1
+
+
+def test_scratch_pool(device) -> None:
+    if not is_xpu():
+        pytest.skip("The scratch pool is only supported on XPU")
+
+    utils = triton.runtime.driver.active.utils
+    stream = triton.runtime.driver.active.get_current_stream(torch.device(device).index)
+    utils.scratch_pool_empty()
+    ptr = utils.scratch_alloc(1000, stream)
+    # Blocks are rounded up to a size class.
+    assert utils.scratch_pool_stats() == {"allocated": 4096, "used": 4096}
+    utils.scratch_free(ptr, stream)
+    assert utils.scratch_pool_stats() == {"allocated": 4096, "used": 0}
+    # The block is reused by the next allocation of its size class on the queue.
+    assert utils.scratch_alloc(4096, stream) == ptr
+    utils.scratch_free(ptr, stream)
+    with pytest.raises(ValueError):
+        utils.scratch_free(ptr, stream)
+    utils.scratch_pool_empty()
+    assert utils.scratch_pool_stats()["allocated"] == 0
+
+
+def test_graph_capture(device) -> None:
+    if not (is_cuda() or is_xpu()):
+        pytest.skip("Graphs are only supported on CUDA and XPU")
+
+    @triton.jit
+    def kernel(in_ptr0, out_ptr0, xnumel, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tmp0 = tl.load(in_ptr0 + xindex, xmask)
+        tl.store(out_ptr0 + xindex, tmp0 + 1, xmask)
+
+    bufs = [torch.zeros(100, device=device) for _ in range(4)]
+    # Compile the kernel outside of the capture.
+    kernel[(7, )](bufs[0], bufs[1], 100, XBLOCK=16)
+
+    graph = triton.runtime.driver.active.create_graph()
+    with graph.capture():
+        for i in range(3):
+            kernel[(7, )](bufs[i], bufs[i + 1], 100, XBLOCK=16)
+    bufs[0].fill_(1)
+    graph.replay()
+    torch.testing.assert_close(bufs[3], torch.full_like(bufs[3], 4))
+
+    # Capture the same launch sequence with different arguments.
+    with graph.capture():
+        for i in range(3):
+            kernel[(7, )](bufs[i], bufs[i + 1], 50, XBLOCK=16)
+    bufs[0].fill_(2)
+    graph.replay()
+    torch.testing.assert_close(bufs[3][:50], torch.full_like(bufs[3][:50], 5))
+    torch.testing.assert_close(bufs[3][50:], torch.full_like(bufs[3][50:], 4))
+
+
+def test_dispatcher(device) -> None:
+    if not is_xpu():
+        pytest.skip("The native dispatcher is only supported on XPU")
+
+    @triton.jit
+    def kernel(in_ptr0, out_ptr0, xnumel, value, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tl.store(out_ptr0 + xindex, tl.load(in_ptr0 + xindex, xmask) + value, xmask)
+
+    inp = torch.zeros(1000, device=device)
+    out = torch.zeros(1000, device=device)
+    large = kernel.warmup(inp, out, 1000, 1.0, XBLOCK=256, grid=(1, ))
+    small = kernel.warmup(inp, out, 1000, 1.0, XBLOCK=32, grid=(1, ))
+    dispatcher = triton.runtime.driver.active.create_dispatcher([
+        (large, {"xnumel": (512, None)}, [("xnumel", 256)]),
+        (small, {"xnumel": 8}, [("xnumel", 32)]),
+    ])
+    assert dispatcher.select(inp, out, 1000, 1.0) == (0, (4, 1, 1))
+    assert dispatcher.select(inp, out, 200, 1.0) == (1, (7, 1, 1))
+    with pytest.raises(ValueError):
+        dispatcher.select(inp, out, 100, 1.0)
+
+    dispatcher(inp, out, 1000, 1.0)
+    torch.testing.assert_close(out, torch.ones_like(out))
+    dispatcher(inp, out, 200, 2.0)
+    torch.testing.assert_close(out[:200], torch.full_like(out[:200], 2))
+    torch.testing.assert_close(out[200:], torch.ones_like(out[200:]))
+
+
+@pytest.mark.parametrize("trusted", [False, True])
+def test_pointer_validation(device, trusted, monkeypatch) -> None:
+    if not is_xpu():
+        pytest.skip("USM pointer validation is only done on XPU")
+    monkeypatch.setenv("TRITON_INTEL_TRUSTED_POINTERS", "1" if trusted else "0")
+
+    @triton.jit
+    def kernel(in_ptr0, out_ptr0, xnumel, XBLOCK: tl.constexpr):
+        xindex = tl.program_id(0) * XBLOCK + tl.arange(0, XBLOCK)
+        xmask = xindex < xnumel
+        tl.store(out_ptr0 + xindex, tl.load(in_ptr0 + xindex, xmask), xmask)
+
+    inp = torch.randn(100, device=device)
+    out = torch.zeros(100, device=device)
+    for _ in range(2):
+        # The second launch hits the cached allocation checks.
+        out.zero_()
+        kernel[(7, )](inp, out, 100, XBLOCK=16)
+        torch.testing.assert_close(out, inp)
+
+    if not trusted:
+        with pytest.raises(ValueError, match="doesn't reference XPU device memory"):
+            kernel[(7, )](inp.cpu(), out, 100, XBLOCK=16)
+
+
 # LATENCY_THRESHOLD_US = 46
 
 # def test_kernel_launch_latency() -> None:
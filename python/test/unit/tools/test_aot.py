@@ -5,8 +5,10 @@ import sys
 import tempfile
 
 import numpy as np
+import pytest
 
 import triton
+from triton._internal_testing import is_xpu
 from triton.backends.compiler import GPUTarget
 from triton.backends.nvidia.driver import include_dir, library_dirs
 
@@ -258,12 +260,13 @@ def compile_aot_kernels(dir, kernel_path, dtype, BM, BN, BK, ha_hb_hints):
             )
 
 
-def link_aot_kernels(dir):
+def link_aot_kernels(dir, target="cuda"):
     linker_path = os.path.join(triton.tools.__path__[0], "link.py")
 
     # link all desired configs
     h_files = glob.glob(os.path.join(dir, "*.h"))
-    subprocess.run([sys.executable, linker_path] + h_files + ["-o", "kernel"], check=True, cwd=dir)
+    subprocess.run([sys.executable, linker_path] + h_files + ["-o", "kernel", "--target", target], check=True,
+                   cwd=dir)
 
 
 def generate_matmul_test_data(dir, M, N, K):
@@ -424,6 +427,33 @@ def test_compile_link_autotune_matmul():
             np.testing.assert_allclose(c_tri, c_ref * c_ref, atol=1e-4, rtol=1e-4)
 
 
+def test_compile_link_xpu_sources():
+    if not is_xpu():
+        pytest.skip("the Level Zero launcher is only generated for XPU")
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        dtype = "fp16"
+        BM, BN, BK = 16, 16, 16
+
+        kernel_path = write_triton_kernels(tmp_dir, kernel_src, kernel_utils_src)
+        compile_aot_kernels(tmp_dir, kernel_path, dtype, BM, BN, BK, ha_hb_hints=["", ":16"])
+        link_aot_kernels(tmp_dir, target="xpu")
+
+        c_files = glob.glob(os.path.join(tmp_dir, "matmul_fp16.*.c"))
+        assert len(c_files) == 4
+        for c_file in c_files:
+            with open(c_file) as fp:
+                src = fp.read()
+            assert "ZE_MODULE_FORMAT_IL_SPIRV" in src
+            assert "zeCommandListAppendLaunchKernel" in src
+
+        with open(os.path.join(tmp_dir, "kernel.h")) as fp:
+            header = fp.read()
+        assert "#include <level_zero/ze_api.h>" in header
+        assert "void load_matmul_fp16(ze_context_handle_t context, ze_device_handle_t device);" in header
+        assert "ze_result_t matmul_fp16_default(ze_command_list_handle_t cmd_list," in header
+
+
 def test_ttgir_to_ptx():
     src = """
 module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32, "triton_gpu.num-ctas" = 1 : i32} {
@@ -14,6 +14,13 @@ class DriverBase(metaclass=ABCMeta):
     def __init__(self) -> None:
         pass
 
+    def create_graph(self):
+        """
+        Returns a graph recording the kernels launched in its `capture()`
+        context, and launching all of them again with `replay()`.
+        """
+        raise NotImplementedError(f"{type(self).__name__} does not support graphs")
+
 
 class GPUDriver(DriverBase):
 
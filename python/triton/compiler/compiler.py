@@ -6,35 +6,55 @@ from ..backends import backends
 from ..backends.compiler import GPUTarget
 from .. import __version__
 from ..runtime.autotuner import OutOfResources
-from ..runtime.cache import get_cache_manager, get_dump_manager, get_override_manager
+from ..runtime.cache import (FileCacheManager, compress_cache_entry, get_cache_manager, get_dump_manager,
+                             get_override_manager, read_cache_entry, record_kernel_lookup)
 from ..runtime.driver import driver
 # TODO: this shouldn't be here
 from dataclasses import dataclass
 from .code_generator import ast_to_ttir
+from .remote import get_compile_backend, make_compile_request
 from pathlib import Path
 import re
+import contextlib
 import functools
 import os
+import threading
+from collections.abc import Mapping
 
 
 @dataclass
 class AttrsDescriptor:
     divisible_by_16: set = None
     equal_to_1: set = None
+    # The pointers to less than 2GB, whose offsets fit in 32 bits.
+    pointer_range_32: set = None
+    # The pointers aligned to 64 bytes, e.g. the base addresses of 2D block loads, a subset of `divisible_by_16`.
+    divisible_by_64: set = None
+    # The integers divisible by 8, e.g. the strides of 2D block loads of 16-bit elements, a superset of the integers of
+    # `divisible_by_16`.
+    divisible_by_8: set = None
 
     def __post_init__(self):
-        if self.divisible_by_16 is None:
-            self.divisible_by_16 = set()
-        if self.equal_to_1 is None:
-            self.equal_to_1 = set()
+        for name in self.__dataclass_fields__:
+            if getattr(self, name) is None:
+                setattr(self, name, set())
 
     def to_dict(self):
-        return {'divisible_by_16': list(self.divisible_by_16), 'equal_to_1': list(self.equal_to_1)}
+        return {name: list(value) for name, value in self.__dict__.items()}
 
     @staticmethod
     def from_dict(data):
-        return AttrsDescriptor(divisible_by_16=set(data.get('divisible_by_16', [])),
-                               equal_to_1=set(data.get('equal_to_1', [])))
+        return AttrsDescriptor(**{name: set(data.get(name, [])) for name in AttrsDescriptor.__dataclass_fields__})
+
+    def get_divisibility(self, i):
+        """
+        The largest power of 2 the argument `i` is known to be divisible by
+        (in bytes for pointers), or None.
+        """
+        for divisibility, args in ((64, self.divisible_by_64), (16, self.divisible_by_16), (8, self.divisible_by_8)):
+            if i in args:
+                return divisibility
+        return None
 
     def hash(self):
         key = str([sorted(x) for x in self.__dict__.values()])
@@ -125,13 +145,137 @@ class ASTSource:
         return dict()
 
 
+# Magic number of the files holding MLIR bytecode.
+MLIR_BYTECODE_MAGIC = b"ML\xefR"
+
+
+def read_ir_text(path, load_dialects):
+    """
+    Returns the text of the IR in `path`. MLIR bytecode is printed in a new
+    context, in which `load_dialects(context)` loads the dialects it uses.
+    """
+    data = Path(path).read_bytes()
+    if not data.startswith(MLIR_BYTECODE_MAGIC):
+        return data.decode("utf-8")
+    context = ir.context()
+    ir.load_dialects(context)
+    load_dialects(context)
+    text = str(ir.parse_mlir_module(str(path), context))
+    context.disable_multithreading()
+    return text
+
+
+def serialize_ir(module, text):
+    """
+    MLIR stages are cached as bytecode, which is smaller and parsed faster
+    than their text when compiling again from an intermediate stage.
+    """
+    if isinstance(module, ir.module) and not text:
+        return module.bytecode()
+    return module
+
+
+class StageCheckpoints:
+    """
+    The output of the stages of a compilation, with the metadata after them,
+    keyed by the options the stages depend on. A kernel compiled again with
+    only the options of later stages changed resumes from the last stage they
+    don't affect, e.g. from its SPIR-V when only its GRF mode changed.
+
+    Backends opt in with `get_option_stages(options)`, which returns the
+    earliest stage each option affects if it isn't the first stage, or None
+    for the options only used by `finalize_metadata(metadata, options)`.
+
+    The frontend may still read the options of later stages while tracing the
+    kernel, e.g. `num_warps()`: the snapshots record the `traced_options`, and
+    only the stages traced with the same values of those are resumed.
+    """
+
+    def __init__(self, backend, stage_names, options, key, file_name):
+        option_stages = backend.get_option_stages(options)
+        self.values = json.loads(json.dumps(options.__dict__, default=vars))
+        self.metadata_filename = f"{file_name}.json"
+        self.keys = {}
+        self.options = {}
+        for i, ext in enumerate(stage_names):
+            names = {name for name in options.__dict__ if option_stages.get(name, stage_names[0]) in stage_names[:i + 1]}
+            stage_key = f"{key}-{ext}-" + '_'.join(f'{name}-{getattr(options, name)}' for name in sorted(names))
+            self.keys[ext] = hashlib.sha256(stage_key.encode("utf-8")).hexdigest()
+            self.options[ext] = names
+        # The stages followed by a stage depending on more options.
+        self.stages = [
+            ext for ext, next_ext in zip(stage_names, stage_names[1:] + [None])
+            if next_ext is None or self.options[ext] != self.options[next_ext]
+        ]
+
+    def save(self, ext, metadata_group, metadata):
+        if ext not in self.stages:
+            return
+        cache_manager = get_cache_manager(self.keys[ext])
+        group = dict(metadata_group)
+        group[self.metadata_filename] = cache_manager.put(json.dumps(metadata, default=vars), self.metadata_filename,
+                                                          binary=False)
+        cache_manager.put_group(self.metadata_filename, group)
+
+    def load(self, stage_names, first_stage, file_name):
+        """
+        Returns the index of the last checkpointed stage from `first_stage`
+        on, the files of the stages up to it and the metadata after it.
+        """
+        for i in reversed(range(first_stage, len(stage_names))):
+            ext = stage_names[i]
+            if ext not in self.stages:
+                continue
+            group = get_cache_manager(self.keys[ext]).get_group(self.metadata_filename) or {}
+            if self.metadata_filename not in group or f"{file_name}.{ext}" not in group:
+                continue
+            snapshot = json.loads(Path(group[self.metadata_filename]).read_text())
+            if any(snapshot.get(name) != self.values.get(name)
+                   for name in snapshot.get("traced_options", ())
+                   if name not in self.options[ext]):
+                continue
+            files = {name: path for name, path in group.items() if name != self.metadata_filename}
+            return i, files, snapshot
+        return None
+
+    def resume_metadata(self, ext, snapshot, metadata):
+        # The options of the later stages, and the hash and target of the
+        # kernel, replace those of the compilation the checkpoint comes from.
+        return {**snapshot, **{name: value for name, value in metadata.items() if name not in self.options[ext]}}
+
+
+def load_stage(path, ext, context, binary_ext):
+    data = Path(path).read_bytes()
+    if data.startswith(MLIR_BYTECODE_MAGIC) or ext in ("ttir", "ttgir"):
+        module = ir.parse_mlir_module(str(path), context)
+        module.context = context
+        return module
+    return data if ext == binary_ext else data.decode("utf-8")
+
+
+class TracedOptions:
+    """
+    The options of a compilation as seen by the frontend, recording the names
+    it reads while tracing the kernel.
+    """
+
+    def __init__(self, options):
+        self.options = options
+        self.names = set()
+
+    def __getattr__(self, name):
+        self.names.add(name)
+        return getattr(self.options, name)
+
+
 class IRSource:
 
-    def __init__(self, path):
+    def __init__(self, path, backend):
         self.path = path
         path = Path(path)
         self.ext = path.suffix[1:]
-        self.src = path.read_text()
+        self.data = path.read_bytes()
+        self.src = read_ir_text(path, backend.load_dialects)
         match = re.search(prototype_pattern[self.ext], self.src, re.MULTILINE)
         self.name = match.group(1)
         signature = match.group(2)
@@ -139,7 +283,7 @@ class IRSource:
         self.signature = {k: convert_type_repr(ty) for k, ty in enumerate(types)}
 
     def hash(self):
-        return hashlib.sha256(self.src.encode("utf-8")).hexdigest()
+        return hashlib.sha256(self.data).hexdigest()
 
     def make_ir(self, options, codegen_fns, module_map, context):
         module = ir.parse_mlir_module(self.path, context)
@@ -152,14 +296,11 @@ class IRSource:
         return dict()
 
 
-@functools.lru_cache()
-def triton_key():
+def _triton_key_files():
     import pkgutil
     TRITON_PATH = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
-    contents = []
     # frontend
-    with open(__file__, "rb") as f:
-        contents += [hashlib.sha256(f.read()).hexdigest()]
+    files = [__file__]
     # compiler
     path_prefixes = [
         (os.path.join(TRITON_PATH, "compiler"), "triton.compiler."),
@@ -167,24 +308,49 @@ def triton_key():
     ]
     for path, prefix in path_prefixes:
         for lib in pkgutil.walk_packages([path], prefix=prefix):
-            with open(lib.module_finder.find_spec(lib.name).origin, "rb") as f:
-                contents += [hashlib.sha256(f.read()).hexdigest()]
-
+            files.append(lib.module_finder.find_spec(lib.name).origin)
     # backend
-    libtriton_hash = hashlib.sha256()
-    with open(os.path.join(TRITON_PATH, "_C/libtriton.so"), "rb") as f:
-        while True:
-            chunk = f.read(1024**2)
-            if not chunk:
-                break
-            libtriton_hash.update(chunk)
-    contents.append(libtriton_hash.hexdigest())
+    files.append(os.path.join(TRITON_PATH, "_C/libtriton.so"))
     # language
     language_path = os.path.join(TRITON_PATH, 'language')
     for lib in pkgutil.walk_packages([language_path], prefix="triton.language."):
-        with open(lib.module_finder.find_spec(lib.name).origin, "rb") as f:
-            contents += [hashlib.sha256(f.read()).hexdigest()]
-    return f'{__version__}' + '-'.join(contents)
+        files.append(lib.module_finder.find_spec(lib.name).origin)
+    return files
+
+
+def _hash_file(path):
+    file_hash = hashlib.sha256()
+    with open(path, "rb") as f:
+        while chunk := f.read(1024**2):
+            file_hash.update(chunk)
+    return file_hash.hexdigest()
+
+
+@functools.lru_cache()
+def triton_key():
+    files = _triton_key_files()
+    # Hashing the files, libtriton.so above all, is slow. The key is cached
+    # under the status of the files (modification time, size and inode), and
+    # recomputed when any of them changes. TRITON_VERIFY_KEY=1 always hashes
+    # the files and refreshes the cached key.
+    stats = [(path, st.st_mtime_ns, st.st_size, st.st_ino) for path in files for st in [os.stat(path)]]
+    stats_key = hashlib.sha256(f"{__version__}-{stats}".encode("utf-8")).hexdigest()
+    verify = os.getenv("TRITON_VERIFY_KEY", "0") == "1"
+    try:
+        cache = FileCacheManager(stats_key)
+        path = cache.get_file("triton_key.txt")
+        if path is not None and not verify:
+            key = Path(path).read_text()
+            if key.startswith(__version__):
+                return key
+    except OSError:
+        cache = None
+    key = f'{__version__}' + '-'.join(_hash_file(path) for path in files)
+    if cache is not None:
+        # The cache is only an optimization, e.g. on a read-only file system.
+        with contextlib.suppress(OSError):
+            cache.put(key, "triton_key.txt", binary=False)
+    return key
 
 
 def parse(full_name, ext, context):
@@ -235,6 +401,133 @@ def filter_traceback(e: BaseException):
         e.__traceback__ = frames[0]
 
 
+class _PooledContext:
+
+    def __init__(self, context):
+        self.context = context
+        self.uses = 0
+
+
+class ContextPool:
+    """
+    The MLIR contexts of the kernels compiled without a shared context, reused
+    by the next kernels of the same backend so that they don't load the
+    dialects again, e.g. the configs of an autotuner compiled one by one.
+
+    Only the contexts of successful compilations are reused. A context is
+    dropped after `TRITON_CONTEXT_POOL_RECYCLE` compilations (64 by default),
+    which bounds the attributes and types uniqued in it, and at most
+    `TRITON_CONTEXT_POOL_SIZE` idle contexts (8 by default) are kept per
+    backend. `TRITON_CONTEXT_POOL=0`, `MLIR_ENABLE_DUMP` or
+    `MLIR_ENABLE_DIAGNOSTICS` compile each kernel in a new context.
+    """
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._idle = {}
+        self.created = 0
+        self.reused = 0
+        if hasattr(os, "register_at_fork"):
+            os.register_at_fork(before=self._before_fork, after_in_parent=self._after_fork,
+                                after_in_child=self._after_fork)
+
+    @staticmethod
+    def _enabled():
+        debug = any(os.environ.get(var, "0") not in ("", "0") for var in ("MLIR_ENABLE_DUMP", "MLIR_ENABLE_DIAGNOSTICS"))
+        return not debug and os.environ.get("TRITON_CONTEXT_POOL", "1") != "0"
+
+    def acquire(self, backend):
+        with self._lock:
+            idle = self._idle.get(type(backend))
+            if idle and self._enabled():
+                self.reused += 1
+                return idle.pop()
+            self.created += 1
+        context = ir.context()
+        ir.load_dialects(context)
+        backend.load_dialects(context)
+        return _PooledContext(context)
+
+    def release(self, backend, pooled):
+        pooled.uses += 1
+        recycle = int(os.environ.get("TRITON_CONTEXT_POOL_RECYCLE", "64"))
+        size = int(os.environ.get("TRITON_CONTEXT_POOL_SIZE", "8"))
+        if self._enabled() and pooled.uses < recycle:
+            with self._lock:
+                idle = self._idle.setdefault(type(backend), [])
+                if len(idle) < size:
+                    idle.append(pooled)
+                    return
+        # The thread pool of a dropped context must be finalized before the
+        # process forks: if it forks before the context is collected, the
+        # thread pool is invalid in the child, which could crash or hang.
+        pooled.context.disable_multithreading()
+
+    def _before_fork(self):
+        # The idle contexts stop their thread pool for the same reason, and
+        # start a new one after the fork.
+        self._lock.acquire()
+        for idle in self._idle.values():
+            for pooled in idle:
+                pooled.context.disable_multithreading()
+
+    def _after_fork(self):
+        for idle in self._idle.values():
+            for pooled in idle:
+                pooled.context.enable_multithreading()
+        self._lock.release()
+
+
+_context_pool = ContextPool()
+
+_shared_context = threading.local()
+
+
+@contextlib.contextmanager
+def use_context(context):
+    """
+    Compiles the kernels of the calling thread in `context`, as created by
+    `shared_context`. Does nothing if `context` is None.
+    """
+    previous = getattr(_shared_context, "context", None)
+    if context is not None:
+        _shared_context.context = context
+    try:
+        yield context
+    finally:
+        _shared_context.context = previous
+
+
+@contextlib.contextmanager
+def shared_context(target=None):
+    """
+    Creates a single MLIR context for a batch of kernels, e.g. the configs of
+    an autotuner compiled by a thread pool whose workers enter
+    `use_context(context)`. The dialects are loaded up front as loading them
+    is not thread-safe, while the passes run concurrently on distinct modules.
+    Yields None, so that each kernel keeps its own context, when the calling
+    thread already uses a shared context or when MLIR_ENABLE_DUMP or
+    MLIR_ENABLE_DIAGNOSTICS, which disable the multithreading of the context,
+    are set.
+    """
+    debug = any(os.environ.get(var, "0") not in ("", "0") for var in ("MLIR_ENABLE_DUMP", "MLIR_ENABLE_DIAGNOSTICS"))
+    if debug or getattr(_shared_context, "context", None) is not None:
+        yield None
+        return
+    if target is None:
+        target = driver.active.get_current_target()
+    context = ir.context()
+    ir.load_dialects(context)
+    make_backend(target).load_dialects(context)
+    try:
+        with use_context(context):
+            yield context
+    finally:
+        # See compile(): the thread pool of the context must be finalized
+        # before the process forks.
+        context.disable_multithreading()
+
+
 def compile(src, target=None, options=None):
     if target is None:
         target = driver.active.get_current_target()
@@ -244,7 +537,7 @@ def compile(src, target=None, options=None):
     # create backend
     if ir_source:
         assert isinstance(src, str), "source must be either AST or a filepath"
-        src = IRSource(src)
+        src = IRSource(src, backend)
     extra_options = src.parse_options()
     options = backend.parse_options(dict(options or dict(), **extra_options))
     # create cache manager
@@ -270,7 +563,9 @@ def compile(src, target=None, options=None):
     if not always_compile and metadata_path is not None:
         # cache hit!
         metadata = json.loads(Path(metadata_path).read_text())
+        record_kernel_lookup(metadata)
         return CompiledKernel(src, metadata_group, hash)
+    record_kernel_lookup(None)
     # initialize metadata
     metadata = {
         "hash": hash,
@@ -281,28 +576,63 @@ def compile(src, target=None, options=None):
     # run compilation pipeline  and populate metadata
     stages = dict()
     backend.add_stages(stages, options)
-    first_stage = list(stages.keys()).index(src.ext)
+    stage_names = list(stages.keys())
+    first_stage = stage_names.index(src.ext)
     # when the source is an IR file, don't apply the passes related to this stage. This makes it easier to write IR level tests.
     if ir_source:
         first_stage += 1
-    context = ir.context()
-    ir.load_dialects(context)
-    backend.load_dialects(context)
+    use_ir_loc = os.environ.get("USE_IR_LOC", None)
+    checkpoints = None
+    if (hasattr(backend, "get_option_stages") and fn_override_manager is None and fn_dump_manager is None
+            and use_ir_loc is None):
+        stage_key = f"{triton_key()}-{src.hash()}-{backend.hash()}-{str(sorted(env_vars.items()))}"
+        checkpoints = StageCheckpoints(backend, stage_names, options, stage_key, file_name)
+    # The stages after the Triton IR of the kernels traced from their source
+    # may be compiled remotely.
+    compile_backend = None
+    if not ir_source and fn_override_manager is None and fn_dump_manager is None and use_ir_loc is None:
+        compile_backend = get_compile_backend()
+    remote_compiled = False
+    context = getattr(_shared_context, "context", None)
+    pooled = None
+    if context is None:
+        pooled = _context_pool.acquire(backend)
+        context = pooled.context
     codegen_fns = backend.get_codegen_implementation()
     module_map = backend.get_module_map()
-    try:
-        module = src.make_ir(options, codegen_fns, module_map, context)
-    except Exception as e:
-        filter_traceback(e)
-        raise
-    use_ir_loc = os.environ.get("USE_IR_LOC", None)
+    checkpoint = None
+    if checkpoints is not None and not always_compile:
+        checkpoint = checkpoints.load(stage_names, first_stage, file_name)
+    if checkpoint is not None:
+        last_stage, files, snapshot = checkpoint
+        ext = stage_names[last_stage]
+        metadata = checkpoints.resume_metadata(ext, snapshot, metadata)
+        for name, path in files.items():
+            metadata_group[name] = fn_cache_manager.put(Path(path).read_bytes(), name)
+        module = load_stage(files[f"{file_name}.{ext}"], ext, context, backend.binary_ext)
+        first_stage = last_stage + 1
+    else:
+        traced_options = TracedOptions(options)
+        make_ir = lambda src, metadata: src.make_ir(traced_options, codegen_fns, module_map, context)
+        if hasattr(backend, "timed_stage"):
+            make_ir = backend.timed_stage("frontend", make_ir)
+        try:
+            module = make_ir(src, metadata)
+            metadata["traced_options"] = sorted(traced_options.names)
+        except Exception as e:
+            filter_traceback(e)
+            raise
     for ext, compile_ir in list(stages.items())[first_stage:]:
         next_module = compile_ir(module, metadata)
         ir_filename = f"{file_name}.{ext}"
         if (fn_override_manager is not None and (full_name := fn_override_manager.get_file(ir_filename)) is not None):
             print(f"\nOverriding kernel with file {full_name}")
             next_module = parse(full_name, ext, context)
-        metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
+        # The locations created from the IR refer to the lines of its text.
+        cache_entry = serialize_ir(next_module, use_ir_loc == ext)
+        if ext == backend.binary_ext:
+            cache_entry = compress_cache_entry(cache_entry)
+        metadata_group[ir_filename] = fn_cache_manager.put(cache_entry, ir_filename)
         if fn_dump_manager is not None:
             fn_dump_manager.put(next_module, ir_filename)
         # use an env variable to parse ir from file
@@ -310,16 +640,31 @@ def compile(src, target=None, options=None):
             ir_full_name = fn_cache_manager.get_file(ir_filename)
             next_module.create_location_snapshot(ir_full_name)
             print(f"Creating new locations for {ir_full_name}")
+        if checkpoints is not None:
+            checkpoints.save(ext, metadata_group, metadata)
         module = next_module
+        if compile_backend is not None and ext == stage_names[0]:
+            request = make_compile_request(hash, triton_key(), target, options, env_vars, ext, file_name, module)
+            result = compile_backend.compile(request)
+            if result is not None:
+                files, remote_metadata = result
+                for remote_ext, data in files.items():
+                    ir_filename = f"{file_name}.{remote_ext}"
+                    if remote_ext == backend.binary_ext:
+                        data = compress_cache_entry(data)
+                    metadata_group[ir_filename] = fn_cache_manager.put(data, ir_filename)
+                # The hash, options and traced options of the kernel are those of this compilation.
+                metadata = {**remote_metadata, **metadata}
+                remote_compiled = True
+                break
+    if hasattr(backend, "finalize_metadata") and not remote_compiled:
+        backend.finalize_metadata(metadata, options)
     # write-back metadata
     metadata_group[metadata_filename] = fn_cache_manager.put(json.dumps(metadata, default=vars), metadata_filename,
                                                              binary=False)
     fn_cache_manager.put_group(metadata_filename, metadata_group)
-    # Compilation completed, disabling multithreading in context.
-    # This is needed to safely finalize threads pool inside context: if current process forks before
-    # python GC deletes context object, thread pool in child process will be invalid, which could
-    # lead to child crash or hang.
-    context.disable_multithreading()
+    if pooled is not None:
+        _context_pool.release(backend, pooled)
     # return handle to compiled kernel
     return CompiledKernel(src, metadata_group, hash)
 
@@ -348,12 +693,55 @@ class LazyDict:
         self.extras.append((func, args))
 
 
-class CompiledKernel:
+class LazyAsm(Mapping):
+    """
+    The text (or binary) of each level of IR generated during compilation,
+    read from the cache when it is accessed, so that kernels which are
+    compiled or preloaded but never launched don't pay for reading them.
+    Only the binary is kept once read, the IR stages are read again on each
+    access, so that a process holding many kernels doesn't keep the text of
+    their IR in memory. MLIR stages cached as bytecode are printed when they
+    are accessed.
+    """
+
+    def __init__(self, files, binary_ext, backend):
+        self.files = {file.suffix[1:]: file for file in files}
+        self.binary_ext = binary_ext
+        self.backend = backend
+        self.data = {}
+
+    def __getitem__(self, ext):
+        if ext in self.data:
+            return self.data[ext]
+        file = self.files[ext]
+        if ext != self.binary_ext:
+            return read_ir_text(file, self.backend.load_dialects)
+        self.data[ext] = read_cache_entry(file)
+        return self.data[ext]
+
+    def __iter__(self):
+        return iter(self.files)
+
+    def __len__(self):
+        return len(self.files)
+
+
+class LaunchHooksVersion(type):
+    """Counts the changes of the launch hooks of a class in its `launch_hooks_version`."""
+
+    def __setattr__(cls, name, value):
+        if name in ("launch_enter_hook", "launch_exit_hook"):
+            super().__setattr__("launch_hooks_version", cls.launch_hooks_version + 1)
+        super().__setattr__(name, value)
+
+
+class CompiledKernel(metaclass=LaunchHooksVersion):
 
     # Hooks for external tools to monitor the execution of triton kernels
     # TODO: move out of this namespace since it's a runtime thing
     launch_enter_hook = None
     launch_exit_hook = None
+    launch_hooks_version = 0
 
     def __init__(self, src, metadata_group, hash):
         from collections import namedtuple
@@ -372,37 +760,93 @@ class CompiledKernel:
         self.name = self.metadata.name
         # stores the text of each level of IR that was generated during compilation
         asm_files = [Path(p) for c, p in metadata_group.items() if not c.endswith(".json")]
-        binary_ext = backend.binary_ext
-        self.asm = {
-            file.suffix[1:]: file.read_bytes() if file.suffix[1:] == binary_ext else file.read_text()
-            for file in asm_files
-        }
-        self.kernel = self.asm[binary_ext]
+        self.binary_ext = backend.binary_ext
+        self.asm = LazyAsm(asm_files, self.binary_ext, backend)
         # binaries are lazily initialized
         # because it involves doing runtime things
         # (e.g., checking amount of shared memory on current device)
         self.module = None
         self.function = None
-
-    def _init_handles(self):
-        if self.module is not None:
+        # The handles of the kernel on each device it was loaded on, and the
+        # device of `module` and `function`. See `_init_handles`.
+        self.handles = {}
+        self.device = None
+        # See `update_launcher`.
+        self.launcher = None
+        self.launcher_hooks_version = -1
+
+    @property
+    def kernel(self):
+        # The binary is only read from the cache when the kernel is first launched.
+        return self.asm[self.binary_ext]
+
+    def _init_handles(self, device=None):
+        """
+        Load the kernel on `device`, by default the device it was first loaded
+        on, or else the current device, and make `module`, `function`,
+        `n_regs`, `n_spills` and `metadata` those of `device`. The kernel is
+        loaded once per device, the handles of the devices it was loaded on
+        are kept in `handles`, so that a kernel launched on several devices
+        switches between them without loading it again.
+        """
+        if device is None:
+            if self.module is not None:
+                return
+            device = driver.active.get_current_device()
+        if device == self.device:
             return
-        device = driver.active.get_current_device()
-        # create launcher
-        self.run = driver.active.launcher_cls(self.src, self.metadata)
+        if device not in self.handles:
+            self.handles[device] = self._load_handles(device)
+        self.module, self.function, self.n_regs, self.n_spills, self.metadata = self.handles[device]
+        self.device = device
+        # The launcher is bound to the function of the previous device.
+        self.launcher_hooks_version = -1
+
+    def _load_handles(self, device):
+        if self.module is None:
+            # create launcher
+            self.run = driver.active.launcher_cls(self.src, self.metadata)
         # not enough shared memory to run the kernel
         max_shared = driver.active.utils.get_device_properties(device)["max_shared_mem"]
         if self.metadata.shared > max_shared:
             raise OutOfResources(self.metadata.shared, max_shared, "shared memory")
         # TODO: n_regs, n_spills should be metadata generated when calling `ptxas`
-        self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
-            self.name, self.kernel, self.metadata.shared, self.metadata.build_flags, device)
+        # The Intel backend loads the kernel on an identical device from the
+        # native binary it cached, without running the finalizer again.
+        module, function, n_regs, n_spills = driver.active.utils.load_binary(
+            self.name, self.kernel, self.metadata.shared, self.metadata.build_flags, device,
+            self.metadata.max_reg_spill)
+        metadata = self.metadata
+        # Backends may report more resources used by the loaded kernel.
+        if hasattr(driver.active.utils, "get_kernel_resources"):
+            from collections import namedtuple
+            resources = metadata._asdict() | driver.active.utils.get_kernel_resources(
+                function, n_regs, metadata, device)
+            KernelMetadata = namedtuple('KernelMetadata', sorted(list(resources.keys())))
+            metadata = KernelMetadata(**resources)
+        return module, function, n_regs, n_spills, metadata
 
     def __getattribute__(self, name):
         if name == 'run':
             self._init_handles()
         return super().__getattribute__(name)
 
+    def update_launcher(self):
+        """
+        Set `launcher` to a function launching the kernel with
+        `(grid_0, grid_1, grid_2, stream, *args)` if no launch hook is set and
+        the backend has a launch entry point without hooks, or to None if the
+        launch has to go through `run`. Must be called again when
+        `launch_hooks_version` changes.
+        """
+        run = self.run
+        self.launcher = None
+        if CompiledKernel.launch_enter_hook is None and CompiledKernel.launch_exit_hook is None:
+            launch_without_hooks = getattr(run, "launch_without_hooks", None)
+            if launch_without_hooks is not None:
+                self.launcher = functools.partial(launch_without_hooks, self.function, self.packed_metadata)
+        self.launcher_hooks_version = CompiledKernel.launch_hooks_version
+
     def launch_metadata(self, grid, stream, *args):
         if CompiledKernel.launch_enter_hook is None:
             return None
@@ -424,9 +868,16 @@ class CompiledKernel:
         self._init_handles()
 
         def runner(*args, stream=None):
+            # The kernel is launched on the current device.
+            device = driver.active.get_current_device()
+            self._init_handles(device)
             if stream is None:
-                device = driver.active.get_current_device()
                 stream = driver.active.get_current_stream(device)
+            if self.launcher_hooks_version != CompiledKernel.launch_hooks_version:
+                self.update_launcher()
+            if self.launcher is not None:
+                self.launcher(grid[0], grid[1], grid[2], stream, *args)
+                return
             launch_metadata = self.launch_metadata(grid, stream, *args)
             self.run(grid[0], grid[1], grid[2], stream, self.function, self.packed_metadata, launch_metadata,
                      CompiledKernel.launch_enter_hook, CompiledKernel.launch_exit_hook, *args)
@@ -0,0 +1,107 @@
+"""
+Compilation of the kernels by remote compile servers.
+
+The frontend and the Triton IR passes run locally, the later stages (the
+TritonGPU passes, LLVM and the translation to the binary) are sent to a
+`CompileBackend`, e.g. a pool of `python -m triton.tools.compile_server`
+servers listed in `TRITON_COMPILE_SERVERS`, or a backend pointed to by
+`TRITON_COMPILE_BACKEND=<module>:<class>`. The kernels are compiled locally
+when the backend fails or rejects the request, e.g. a server running another
+version of Triton.
+"""
+
+import base64
+import hashlib
+import importlib
+import json
+import os
+import urllib.error
+import urllib.request
+from abc import abstractmethod
+from typing import Any, Dict, Optional, Tuple
+
+
+class CompileBackend:
+    """
+    A backend compiling the stages of a kernel after its Triton IR.
+    """
+
+    @abstractmethod
+    def compile(self, request: Dict[str, Any]) -> Optional[Tuple[Dict[str, bytes], Dict[str, Any]]]:
+        """
+        Compiles the IR `request["ir"]` of the stage `request["ext"]` for
+        `request["target"]` with `request["options"]`. Returns the output of
+        each later stage by extension and the metadata of the kernel, or None
+        to compile it locally.
+        """
+        pass
+
+
+class HTTPCompileBackend(CompileBackend):
+    """
+    Sends the kernels to the compile servers `host:port` listed in
+    `TRITON_COMPILE_SERVERS`. Each kernel is sent to the same server from all
+    the clients (rendezvous hashing on its key), which compiles it once, and
+    to the next server if it is unreachable. `TRITON_COMPILE_TIMEOUT` bounds
+    the seconds a request waits for its server (600 by default).
+    """
+
+    def __init__(self):
+        servers = os.environ.get("TRITON_COMPILE_SERVERS", "")
+        self.servers = [server.strip() for server in servers.split(",") if server.strip()]
+        self.timeout = float(os.environ.get("TRITON_COMPILE_TIMEOUT", "600"))
+
+    def _ranked_servers(self, key):
+        return sorted(self.servers, key=lambda server: hashlib.sha256(f"{server}-{key}".encode("utf-8")).digest())
+
+    def compile(self, request):
+        body = json.dumps(request).encode("utf-8")
+        for server in self._ranked_servers(request["key"]):
+            http_request = urllib.request.Request(f"http://{server}/compile", data=body,
+                                                  headers={"Content-Type": "application/json"})
+            try:
+                with urllib.request.urlopen(http_request, timeout=self.timeout) as response:
+                    result = json.loads(response.read())
+            except urllib.error.HTTPError as e:
+                # The kernel doesn't compile: the local compilation reports why.
+                if e.code == 422:
+                    return None
+                continue
+            except (OSError, ValueError):
+                continue
+            files = {ext: base64.b64decode(data) for ext, data in result["files"].items()}
+            return files, result["metadata"]
+        return None
+
+
+def get_compile_backend() -> Optional[CompileBackend]:
+    """
+    The backend set by `TRITON_COMPILE_BACKEND` or `TRITON_COMPILE_SERVERS`,
+    or None to compile the kernels locally.
+    """
+    compile_backend = os.environ.get("TRITON_COMPILE_BACKEND", "").strip()
+    if compile_backend:
+        module_path, clz_nme = compile_backend.split(":")
+        module = importlib.import_module(module_path)
+        return getattr(module, clz_nme)()
+    if os.environ.get("TRITON_COMPILE_SERVERS", "").strip():
+        return HTTPCompileBackend()
+    return None
+
+
+def make_compile_request(key, triton_key, target, options, env_vars, ext, name, module):
+    """
+    The request to compile the stages after `ext` of the kernel `name`, whose
+    IR at stage `ext` is `module`. The servers only compile the requests of
+    the same `triton_key` and cache invalidating environment variables.
+    """
+    return {
+        "key": key,
+        "triton_key": triton_key,
+        "target": {"backend": target.backend, "arch": target.arch, "warp_size": target.warp_size},
+        "options": json.loads(json.dumps(options.__dict__, default=vars)),
+        "env_vars": env_vars,
+        "ext": ext,
+        "name": name,
+        "ir": str(module),
+    }
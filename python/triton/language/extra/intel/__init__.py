@@ -1,5 +1,21 @@
+from . import attention
+from . import comm
+from . import conv
+from . import dependent
+from . import grouped
 from . import libdevice
+from . import local
+from . import mx
+from . import philox
+from . import scan
+from . import softmax
+from . import streamk
+from . import topk
 
-from .utils import (globaltimer, num_threads, num_warps, smid, convert_custom_float8)
+from .cooperative import grid_barrier
+from .utils import (clock, globaltimer, num_threads, num_warps, smid, convert_custom_float8)
 
-__all__ = ["libdevice", "globaltimer", "num_threads", "num_warps", "smid", "convert_custom_float8"]
+__all__ = [
+    "attention", "comm", "conv", "dependent", "grouped", "libdevice", "local", "mx", "philox", "scan", "softmax",
+    "streamk", "topk", "grid_barrier", "clock", "globaltimer", "num_threads", "num_warps", "smid", "convert_custom_float8"
+]
@@ -0,0 +1,211 @@
+"""
+Causal, variable-length and block-sparse attention schedules.
+
+With a causal (or block-sparse) mask, the query blocks of an attention forward
+do not have the same work: under the causal mask, the first query block of a
+sequence only attends to the first key block, while the last one attends to
+the whole sequence. One program per query block visits the key blocks which
+are masked out entirely, unless the kernel bounds its loop, and even then the
+Xe-cores running the light blocks go idle while the heavy ones finish, all
+the more with sequences of different lengths. Instead, the query blocks are
+paired and walked by a single persistent grid, sized to the number of
+Xe-cores of the device:
+
+- `attention_schedule` builds, on the host, the work table of the sequences:
+  the query blocks of each sequence are paired, the heaviest with the
+  lightest, so that the pairs of a sequence have about the same work, and the
+  pairs of all the sequences are sorted heaviest first.
+- `attention_schedule_from_offsets` builds instead, on the device, the table
+  of the sequences from their token offsets in a device tensor (the
+  `cu_seqlens` of a ragged batch), so that serving a batch needs neither
+  padding to the longest sequence nor a synchronization with the device.
+  The work items of a sequence pair its i-th query block from the end with
+  its i-th one from the start, the heaviest pair first, and
+  `ragged_work_item` maps an item to its head, sequence and query blocks.
+- `block_mask_indices` compresses a block mask into the key blocks each query
+  block attends to, for block-sparse attention. Their counts give the work of
+  the query blocks to `attention_schedule`.
+- `work_item` is used by the kernel to map a work item to its head, its
+  sequence and its query blocks, and `kv_block_range` to bound the key blocks
+  of a query block under the causal mask: the ones to visit, and the first
+  ones among them which need no mask.
+
+The sequences are packed along the tokens into (total_tokens, num_heads,
+head_dim) tensors, the keys and values of a sequence being the tokens of its
+queries (self-attention).
+"""
+
+from typing import NamedTuple, Optional, Sequence
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+from .grouped import _problem_table
+from .streamk import _cdiv, num_xe_cores
+
+
+class AttentionSchedule(NamedTuple):
+    # Device side (num_items // num_heads, 4) int32 table of the first token
+    # of the sequence, the number of tokens of the sequence and the two query
+    # blocks of each work item of a head, the second one -1 if none, sorted
+    # heaviest first.
+    items: object
+    # Number of work items of all the heads.
+    num_items: int
+    # Number of programs of the persistent grid.
+    num_programs: int
+
+
+def _num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal):
+    end = min((q_block + 1) * BLOCK_M, seq_len) if causal else seq_len
+    return _cdiv(end, BLOCK_N)
+
+
+def attention_schedule(seqlens: Sequence[int], num_heads: int, BLOCK_M: int, BLOCK_N: int, causal: bool = True,
+                       block_counts=None, num_programs: Optional[int] = None, device=None) -> AttentionSchedule:
+    """
+    Build the work table of the sequences of `seqlens[i]` tokens each, for
+    `num_heads` heads, and size the persistent grid to `num_programs`
+    programs, which defaults to the number of Xe-cores of `device`.
+    The work of a query block is its number of key blocks under the causal
+    mask, or `block_counts[q_block]` for a block-sparse mask shared by all
+    the sequences. The query blocks are only paired when there are enough of
+    them to fill the grid twice, as pairing halves the number of work items.
+    """
+    import torch
+    if num_programs is None:
+        num_programs = num_xe_cores(device.index if isinstance(device, torch.device) else device)
+    if block_counts is not None:
+        block_counts = [int(count) for count in block_counts]
+    pair = sum(_cdiv(seq_len, BLOCK_M) for seq_len in seqlens) * num_heads >= 2 * num_programs
+    items = []
+    row_offset = 0
+    for seq_len in seqlens:
+        num_blocks = _cdiv(seq_len, BLOCK_M)
+        if block_counts is not None:
+            work = block_counts[:num_blocks]
+        else:
+            work = [_num_kv_blocks(q_block, seq_len, BLOCK_M, BLOCK_N, causal) for q_block in range(num_blocks)]
+        order = sorted(range(num_blocks), key=lambda q_block: work[q_block])
+        if pair:
+            for i in range(num_blocks // 2):
+                light, heavy = order[i], order[num_blocks - 1 - i]
+                items.append((work[heavy] + work[light], row_offset, seq_len, heavy, light))
+            if num_blocks % 2:
+                middle = order[num_blocks // 2]
+                items.append((work[middle], row_offset, seq_len, middle, -1))
+        else:
+            items += [(work[q_block], row_offset, seq_len, q_block, -1) for q_block in order]
+        row_offset += seq_len
+    items.sort(key=lambda item: -item[0])
+    table = torch.tensor([item[1:] for item in items], dtype=torch.int32, device=device).reshape(len(items), 4)
+    num_items = len(items) * num_heads
+    return AttentionSchedule(table, num_items, max(min(num_programs, num_items), 1))
+
+
+class RaggedAttentionSchedule(NamedTuple):
+    # Device side (max_sequences, 3) int32 table of the first token, the
+    # number of tokens and the first work item of each sequence, padded with
+    # empty sequences starting at item `num_items`.
+    sequences: object
+    # Number of rows of the sequence table, a power of two.
+    max_sequences: int
+    # Device side int32 tensor of one element, the number of work items of all
+    # the sequences and heads.
+    num_items: object
+    # Number of programs of the persistent grid.
+    num_programs: int
+
+
+def attention_schedule_from_offsets(cu_seqlens, num_heads: int, BLOCK_M: int,
+                                    num_programs: Optional[int] = None) -> RaggedAttentionSchedule:
+    """
+    Build, on the device, the sequence table of the sequences with the tokens
+    [cu_seqlens[i], cu_seqlens[i + 1]) each, from the contiguous 1D integer
+    device tensor `cu_seqlens`, for `num_heads` heads, and size the persistent
+    grid to `num_programs` programs, which defaults to the number of Xe-cores
+    of the device. The programs left without items exit immediately.
+    """
+    assert cu_seqlens.dim() == 1 and cu_seqlens.is_contiguous() and cu_seqlens.numel() >= 2, \
+        "Expecting a contiguous 1D tensor of at least two offsets"
+    if num_programs is None:
+        num_programs = num_xe_cores(cu_seqlens.device.index)
+    sequences, max_sequences, num_items = _problem_table(cu_seqlens, num_heads, BLOCK_M, pair=True)
+    return RaggedAttentionSchedule(sequences, max_sequences, num_items, num_programs)
+
+
+def block_mask_indices(block_mask):
+    """
+    Compress the boolean (num_q_blocks, num_kv_blocks) `block_mask` into the
+    number of key blocks each query block attends to, and their indices in
+    increasing order, padded with zeros: int32 tensors of shapes
+    (num_q_blocks, ) and (num_q_blocks, num_kv_blocks).
+    """
+    import torch
+    counts = block_mask.sum(dim=1, dtype=torch.int32)
+    # The stable sort moves the attended key blocks first, in order.
+    indices = torch.argsort((~block_mask).to(torch.int8), dim=1, stable=True).to(torch.int32)
+    kv_blocks = torch.arange(block_mask.shape[1], device=block_mask.device)
+    indices = torch.where(kv_blocks[None, :] < counts[:, None], indices, 0)
+    return counts, indices
+
+
+@jit
+def work_item(items_ptr, item_id, NUM_HEADS: core.constexpr):
+    """
+    Map `item_id` to its head, the first token and the number of tokens of
+    its sequence, and its two query blocks, the second one -1 if none.
+    """
+    # The heads of an item are adjacent, so that the heaviest items of all the
+    # heads come first.
+    entry = item_id // NUM_HEADS
+    head = item_id % NUM_HEADS
+    row_offset = core.load(items_ptr + entry * 4)
+    seq_len = core.load(items_ptr + entry * 4 + 1)
+    q_block_0 = core.load(items_ptr + entry * 4 + 2)
+    q_block_1 = core.load(items_ptr + entry * 4 + 3)
+    return head, row_offset, seq_len, q_block_0, q_block_1
+
+
+@jit
+def ragged_work_item(sequences_ptr, item_id, BLOCK_M: core.constexpr, NUM_HEADS: core.constexpr,
+                     MAX_SEQUENCES: core.constexpr):
+    """
+    Map `item_id` of a `RaggedAttentionSchedule` to its head, the first token
+    and the number of tokens of its sequence, and its two query blocks, the
+    second one -1 if none.
+    """
+    first_items = core.load(sequences_ptr + core.arange(0, MAX_SEQUENCES) * 3 + 2)
+    # The sequences are sorted by first item, the sequence of the item is the
+    # last one starting at or before it.
+    sequence = core.sum((first_items <= item_id).to(core.int32), axis=0) - 1
+    row_offset = core.load(sequences_ptr + sequence * 3)
+    seq_len = core.load(sequences_ptr + sequence * 3 + 1)
+    item_in_sequence = item_id - core.load(sequences_ptr + sequence * 3 + 2)
+    head = item_in_sequence % NUM_HEADS
+    # The i-th pair of the sequence is its i-th query block from the end, with
+    # the i-th one from the start unless they are the same block.
+    pair = item_in_sequence // NUM_HEADS
+    q_block_0 = standard.cdiv(seq_len, BLOCK_M) - 1 - pair
+    q_block_1 = core.where(pair < q_block_0, pair, -1)
+    return head, row_offset, seq_len, q_block_0, q_block_1
+
+
+@jit
+def kv_block_range(q_block, seq_len, BLOCK_M: core.constexpr, BLOCK_N: core.constexpr, CAUSAL: core.constexpr):
+    """
+    Return the number of the first key blocks query block `q_block` of a
+    sequence of `seq_len` tokens attends to entirely, which need no mask, and
+    the number of key blocks it attends to. The key blocks in between cross
+    the diagonal or the end of the sequence and need a mask.
+    """
+    if CAUSAL:
+        end = core.minimum((q_block + 1) * BLOCK_M, seq_len)
+        # The keys before the first query of the block are visible to all of
+        # its queries.
+        full_end = core.minimum(q_block * BLOCK_M, seq_len)
+    else:
+        end = seq_len
+        full_end = seq_len
+    return full_end // BLOCK_N, standard.cdiv(end, BLOCK_N)
@@ -0,0 +1,121 @@
+"""
+Communication between the XPU devices of a node from inside a kernel.
+
+Kernels on a device can load and store the memory of its peers, e.g. over Xe
+Link, so that a tensor-parallel GEMM can all-reduce or reduce-scatter its
+output tiles while computing the next ones, instead of leaving the reduction
+to a separate collective kernel. Every rank allocates a buffer with the same
+layout (a symmetric buffer) and the kernels receive an `int64` tensor of the
+base addresses of the buffers of all the ranks, built on the host with:
+
+- `peer_pointers` when the devices are driven by the same process;
+- `export_ipc_handle` and `IpcMapping` when each device has its own process.
+  The handles are exchanged by the caller, e.g. with `torch.distributed`.
+
+In the kernel, `remote_ptr` translates a pointer into the local buffer to the
+buffer of another rank, for `tl.load`, `tl.store` or the atomics. `signal` and
+`wait` order the accesses through flags in the symmetric buffer:
+
+    @triton.jit
+    def kernel(data_ptr, flag_ptr, peer_ptrs, rank, num_ranks, epoch, BLOCK: tl.constexpr):
+        offsets = tl.arange(0, BLOCK)
+        peer = (rank + 1) % num_ranks
+        tl.store(remote_ptr(data_ptr + offsets, peer_ptrs, rank, peer), tl.load(data_ptr + BLOCK + offsets))
+        signal(remote_ptr(flag_ptr, peer_ptrs, rank, peer), epoch)
+        wait(flag_ptr, epoch)  # the data of the previous rank is there
+
+Waiting on another program only terminates if that program runs, so the
+programs signaling each other must be resident at once, e.g. by launching the
+kernel with `launch_cooperative_grid=True`.
+"""
+
+from triton.language import core
+from triton.runtime.jit import jit
+
+
+def _utils():
+    from triton.runtime import driver
+    return driver.active.utils
+
+
+def peer_pointers(tensors, device=None):
+    """
+    Return an `int64` tensor on `device` (the device of the first tensor by
+    default) holding the addresses of `tensors`, the buffers of all the ranks
+    on devices of this process. Raises if one of the buffers is on a device
+    whose memory `device` cannot access.
+    """
+    import torch
+    device = torch.device(device) if device is not None else tensors[0].device
+    if device.index is None:
+        device = torch.device(device.type, torch.xpu.current_device())
+    for tensor in tensors:
+        if tensor.device != device and not _utils().can_access_peer(device.index, tensor.device.index):
+            raise RuntimeError(f"{device} cannot access the memory of {tensor.device}")
+    return torch.tensor([tensor.data_ptr() for tensor in tensors], dtype=torch.int64, device=device)
+
+
+def export_ipc_handle(tensor):
+    """Return the IPC handle (bytes) of the allocation of `tensor` and the offset of its data in the allocation."""
+    return _utils().get_ipc_handle(tensor.device.index, tensor.data_ptr())
+
+
+class IpcMapping:
+    """
+    The buffer of another process mapped on `device` from its IPC handle and
+    offset, as returned by `export_ipc_handle`. `ptr` is the address of the
+    buffer, for `peer_pointers`-like tables, until `close` is called. The
+    exporting process must keep its tensor alive while it is mapped.
+    """
+
+    def __init__(self, handle, offset, device):
+        self.device = device
+        self._base = _utils().open_ipc_handle(device, handle)
+        self.ptr = self._base + offset
+
+    def close(self):
+        if self._base is not None:
+            _utils().close_ipc_handle(self.device, self._base)
+            self._base = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+@jit
+def remote_ptr(ptr, peer_ptrs, rank, peer):
+    """
+    Translate `ptr`, a pointer or block of pointers into the symmetric buffer
+    of `rank`, to the buffer of `peer`. `peer_ptrs` points to the base
+    addresses of the buffers of all the ranks.
+    """
+    local_base = core.load(peer_ptrs + rank)
+    peer_base = core.load(peer_ptrs + peer)
+    return (ptr.to(core.int64) - local_base + peer_base).to(ptr.dtype)
+
+
+@jit
+def signal(flag_ptr, value):
+    """
+    Set the `int32` flag at `flag_ptr` (local or remote) to `value`, after the
+    preceding stores of the program are visible to the other devices.
+    """
+    # All the work-items of the program are done before the flag is set.
+    core.debug_barrier()
+    core.atomic_xchg(flag_ptr, value, sem="release", scope="sys")
+
+
+@jit
+def wait(flag_ptr, value):
+    """
+    Wait until the `int32` flag at `flag_ptr` is at least `value`, then read
+    what the signaling program stored before setting it. Flags set to an
+    increasing epoch need no reset between launches.
+    """
+    flag = core.atomic_add(flag_ptr, 0, sem="acquire", scope="sys")
+    while flag < value:
+        flag = core.atomic_add(flag_ptr, 0, sem="acquire", scope="sys")
+    core.debug_barrier()
@@ -0,0 +1,100 @@
+"""
+Implicit GEMM 2D convolutions of NHWC activations.
+
+The convolution of an input `x` of shape (N, H, W, C) by a filter `w` of
+shape (R, S, C, K) is the GEMM of the im2col matrix of `x`, with a row per
+output pixel and a column per filter tap (r, s) and channel c, by `w` seen as
+a (R * S * C, K) matrix. The im2col matrix is never materialized: each
+program computes `BLOCK_M` consecutive pixels of an output row by `BLOCK_N`
+output channels, and for each tap the rows of the im2col matrix are a 2D
+window of the input row `ih = oh * stride_h + r - pad_h`, of a pixel every
+`stride_w * C` elements by `C` contiguous channels. The window is loaded with
+a block pointer, lowered to 2D block loads feeding DPAS:
+
+- The base of the window, offset by the tap, is not known to be 64-byte
+  aligned, so it is aligned at runtime by the load.
+- The padding columns are out of the bounds of the window, which only spans
+  the pixels of the input row, so they are read as zeros by the boundary
+  check. The taps of the padding rows are skipped.
+"""
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+from .streamk import _cdiv
+from .topk import _next_power_of_2
+
+
+@jit
+def _conv2d_kernel(x_ptr, w_ptr, y_ptr, H, W, C, K, OH, OW, stride_h, stride_w, pad_h, pad_w, R: core.constexpr,
+                   S: core.constexpr, BLOCK_M: core.constexpr, BLOCK_N: core.constexpr, BLOCK_K: core.constexpr):
+    pid_row = core.program_id(0)
+    pid_m = core.program_id(1)
+    pid_n = core.program_id(2)
+    n = pid_row // OH
+    oh = pid_row % OH
+    acc = core.zeros((BLOCK_M, BLOCK_N), dtype=core.float32)
+    for r in range(R):
+        ih = oh * stride_h + r - pad_h
+        if (ih >= 0) & (ih < H):
+            for s in range(S):
+                # The window starts at the first output pixel whose input
+                # column is in the row, and ends after the last one.
+                iw0 = s - pad_w
+                first = standard.cdiv(core.maximum(-iw0, 0), stride_w)
+                num_pixels = standard.cdiv(W - iw0, stride_w) - first
+                window_ptr = x_ptr + ((n * H + ih) * W + iw0 + first * stride_w) * C
+                a_block_ptr = core.make_block_ptr(base=window_ptr, shape=(num_pixels, C), strides=(stride_w * C, 1),
+                                                  offsets=(pid_m * BLOCK_M - first, 0), block_shape=(BLOCK_M, BLOCK_K),
+                                                  order=(1, 0))
+                b_block_ptr = core.make_block_ptr(base=w_ptr + (r * S + s) * C * K, shape=(C, K), strides=(K, 1),
+                                                  offsets=(0, pid_n * BLOCK_N), block_shape=(BLOCK_K, BLOCK_N),
+                                                  order=(1, 0))
+                for _ in range(0, C, BLOCK_K):
+                    a = core.load(a_block_ptr, boundary_check=(0, 1))
+                    b = core.load(b_block_ptr, boundary_check=(0, 1))
+                    acc += core.dot(a, b)
+                    a_block_ptr = core.advance(a_block_ptr, (0, BLOCK_K))
+                    b_block_ptr = core.advance(b_block_ptr, (BLOCK_K, 0))
+    y_block_ptr = core.make_block_ptr(base=y_ptr + pid_row * OW * K, shape=(OW, K), strides=(K, 1),
+                                      offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
+                                      order=(1, 0))
+    core.store(y_block_ptr, acc.to(y_ptr.dtype.element_ty), boundary_check=(0, 1))
+
+
+def _pair(value):
+    return (value, value) if isinstance(value, int) else tuple(value)
+
+
+def conv2d(x, w, stride=1, padding=0, BLOCK_M=None, BLOCK_N=None, BLOCK_K: int = 32, num_warps=None):
+    """
+    Return the 2D convolution, without dilation nor groups, of the contiguous
+    NHWC input `x` by the contiguous RSCK filter `w`, as a contiguous NHWC
+    tensor of the type of `x`. `stride` and `padding` are an int or a
+    (height, width) pair, as in `torch.nn.functional.conv2d`. The 2D block
+    loads of the windows need a number of channels `C` multiple of 16, the
+    windows of the other inputs are gathered.
+    """
+    import torch
+    assert x.dim() == 4 and w.dim() == 4 and x.is_contiguous() and w.is_contiguous(), \
+        "Expecting a contiguous NHWC input and a contiguous RSCK filter"
+    N, H, W, C = x.shape
+    R, S, C_w, K = w.shape
+    assert C == C_w, "Expecting as many input channels in the filter as in the input"
+    stride_h, stride_w = _pair(stride)
+    pad_h, pad_w = _pair(padding)
+    OH = (H + 2 * pad_h - R) // stride_h + 1
+    OW = (W + 2 * pad_w - S) // stride_w + 1
+    assert OH > 0 and OW > 0, "Expecting a filter no larger than the padded input"
+    y = torch.empty((N, OH, OW, K), dtype=x.dtype, device=x.device)
+    if BLOCK_M is None:
+        BLOCK_M = min(max(_next_power_of_2(OW), 16), 64)
+    if BLOCK_N is None:
+        BLOCK_N = min(max(_next_power_of_2(K), 16), 128)
+    if num_warps is None:
+        num_warps = 8 if BLOCK_M * BLOCK_N >= 64 * 128 else 4
+    grid = (N * OH, _cdiv(OW, BLOCK_M), _cdiv(K, BLOCK_N))
+    _conv2d_kernel[grid](x, w, y, H, W, C, K, OH, OW, stride_h, stride_w, pad_h, pad_w, R=R, S=S, BLOCK_M=BLOCK_M,
+                         BLOCK_N=BLOCK_N, BLOCK_K=BLOCK_K, num_warps=num_warps)
+    return y
@@ -0,0 +1,48 @@
+"""
+Grid-wide synchronization of persistent kernels.
+
+A kernel launched with `launch_cooperative_grid=True` has all its programs
+resident on the device at once: the launcher clamps the X dimension of the grid
+to the number of work-groups the device can run concurrently (accounting for
+the sub-group size, the GRF mode and the shared memory of the kernel). Such a
+kernel strides over its work by `tl.num_programs(0)` and can wait for all its
+programs with `grid_barrier`:
+
+    @triton.jit
+    def kernel(x_ptr, n_tiles, barrier_ptr):
+        for tile in range(tl.program_id(0), n_tiles, tl.num_programs(0)):
+            ...  # first phase
+        grid_barrier(barrier_ptr)
+        for tile in range(tl.program_id(0), n_tiles, tl.num_programs(0)):
+            ...  # second phase, reading the results of the first one
+
+    barrier = torch.zeros(1, dtype=torch.int32, device="xpu")
+    kernel[(n_tiles, )](x, n_tiles, barrier, launch_cooperative_grid=True)
+
+Waiting on programs that are not resident would hang, so `grid_barrier` must
+only be used by cooperative kernels.
+"""
+
+from triton.language import core
+from triton.runtime.jit import jit
+
+
+@jit
+def grid_barrier(barrier_ptr):
+    """
+    Wait until all the programs of the grid reach the barrier. The stores of a
+    program before the barrier are visible to all the programs after it.
+
+    `barrier_ptr` points to an `int32` counter, zero before the first launch.
+    Each barrier adds the number of programs to the counter, so it can be
+    reused by successive launches with the same grid.
+    """
+    num_programs = core.num_programs(0) * core.num_programs(1) * core.num_programs(2)
+    # All the work-items of the program are done before it arrives.
+    core.debug_barrier()
+    count = core.atomic_add(barrier_ptr, 1, sem="acq_rel") + 1
+    # The counter is a multiple of the grid size before each barrier.
+    target = ((count - 1) // num_programs + 1) * num_programs
+    while count < target:
+        count = core.atomic_add(barrier_ptr, 0, sem="acquire")
+    core.debug_barrier()
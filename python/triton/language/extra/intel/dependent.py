@@ -0,0 +1,66 @@
+"""
+Overlap of a kernel with the kernels launched before it on the same stream.
+
+A kernel launched with `launch_pdl=True` does not wait for the commands before
+it on the stream to start: its programs run their prologue, e.g. loading the
+weights or other inputs which are not produced by the previous kernels, while
+the tail of the previous kernel drains, then wait for the data of the previous
+kernels with `wait_dependency`. The commands after it on the stream still wait
+for it. The previous kernels mark their completion through a
+`DependencyFlag`, set on the stream after them:
+
+    @triton.jit
+    def kernel(x_ptr, w_ptr, y_ptr, flag_ptr, epoch, BLOCK: tl.constexpr):
+        offsets = tl.program_id(0) * BLOCK + tl.arange(0, BLOCK)
+        w = tl.load(w_ptr + offsets)  # not written by the previous kernels
+        wait_dependency(flag_ptr, epoch)
+        tl.store(y_ptr + offsets, tl.load(x_ptr + offsets) * w)
+
+    producer[grid](x)
+    epoch = flag.signal()
+    kernel[grid](x, w, y, flag.flag, epoch, BLOCK=BLOCK, launch_pdl=True)
+
+The programs spin until the previous kernels are done, which only terminates
+if these kernels can run alongside them: the grid of the dependent kernel must
+fit in the work-groups resident at once, as for a cooperative grid, and the
+launch fails otherwise.
+"""
+
+from triton.language import core
+from triton.runtime.jit import jit
+
+
+@jit
+def wait_dependency(flag_ptr, epoch):
+    """
+    Wait until the `int32` flag at `flag_ptr` of a `DependencyFlag` reaches the
+    `epoch` returned by its `signal`, then read what the kernels launched
+    before the signal stored.
+    """
+    flag = core.atomic_add(flag_ptr, 0, sem="acquire", scope="gpu")
+    while flag < epoch:
+        flag = core.atomic_add(flag_ptr, 0, sem="acquire", scope="gpu")
+    # All the work-items of the program wait for the flag.
+    core.debug_barrier()
+
+
+class DependencyFlag:
+    """
+    A device flag set to an increasing epoch on the current stream once the
+    kernels launched before are done, so that it needs no reset between
+    launches.
+    """
+
+    def __init__(self, device=None):
+        import torch
+        self.flag = torch.zeros(1, dtype=torch.int32, device=device)
+        self.epoch = 0
+
+    def signal(self):
+        """
+        Set the flag after the commands launched on the current stream, and
+        return the epoch the dependent kernel waits for.
+        """
+        self.epoch += 1
+        self.flag.fill_(self.epoch)
+        return self.epoch
@@ -0,0 +1,155 @@
+"""
+Grouped GEMM schedules, e.g. for the experts of mixture-of-experts layers.
+
+A grouped GEMM computes independent GEMMs C_i = A_i x B_i with a different
+number of rows M_i per problem, and the same N and K. Launching one kernel per
+problem pays a launch per problem and leaves most Xe-cores idle at the tail of
+every launch, while padding every problem to the largest M_i wastes the work
+of the padded rows. Instead, the output tiles of all the problems are walked
+by a single persistent grid, sized to the number of Xe-cores of the device:
+
+- `grouped_gemm_schedule` builds, on the host, the problem table of the
+  problems: the first row of each A_i and C_i in the concatenated A and C,
+  its number of rows and the index of its first output tile.
+- `grouped_gemm_schedule_from_offsets` builds the same problem table on the
+  device, from the row offsets of the problems in a device tensor (e.g. the
+  `cu_seqlens` of a ragged batch), with a single program prefix sum kernel.
+  The host never reads the number of rows of the problems, so the schedule
+  is built without synchronizing with the device: the number of tiles stays
+  on the device, where the persistent kernel loads it.
+- `problem_tile` is used by the kernel to map a tile index to its problem and
+  its coordinates in the problem. The tiles can then be computed with
+  `streamk.mac_loop` and `streamk.store_tile`.
+
+The A_i (resp. C_i) are concatenated along the rows into a single A (resp. C),
+and the B_i are stacked into a single (num_problems, K, N) B.
+"""
+
+from typing import NamedTuple, Optional, Sequence
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+from .streamk import _cdiv, num_xe_cores
+
+
+class GroupedGemmSchedule(NamedTuple):
+    # Device side (max_problems, 3) int32 table of the first row, the number of
+    # rows and the first tile of each problem, padded with empty problems
+    # starting at tile `num_tiles`.
+    problems: object
+    # Number of rows of the problem table, a power of two.
+    max_problems: int
+    # Number of output tiles of all the problems.
+    num_tiles: int
+    # Number of programs of the persistent grid.
+    num_programs: int
+
+
+def grouped_gemm_schedule(group_m: Sequence[int], N: int, BLOCK_M: int, BLOCK_N: int,
+                          num_programs: Optional[int] = None, device=None) -> GroupedGemmSchedule:
+    """
+    Build the problem table of the problems with `group_m[i]` rows each, and
+    size the persistent grid to `num_programs` programs, which defaults to
+    the number of Xe-cores of `device`. Problems without rows have no tiles.
+    """
+    import torch
+    if num_programs is None:
+        num_programs = num_xe_cores(device.index if isinstance(device, torch.device) else device)
+    max_problems = 1
+    while max_problems < len(group_m):
+        max_problems *= 2
+    grid_n = _cdiv(N, BLOCK_N)
+    rows = []
+    row_offset = num_tiles = 0
+    for m in group_m:
+        rows.append((row_offset, m, num_tiles))
+        row_offset += m
+        num_tiles += _cdiv(m, BLOCK_M) * grid_n
+    rows += [(row_offset, 0, num_tiles)] * (max_problems - len(group_m))
+    problems = torch.tensor(rows, dtype=torch.int32, device=device)
+    return GroupedGemmSchedule(problems, max_problems, num_tiles, max(min(num_programs, num_tiles), 1))
+
+
+class DeviceGroupedGemmSchedule(NamedTuple):
+    # Device side (max_problems, 3) int32 problem table, as in
+    # `GroupedGemmSchedule`.
+    problems: object
+    # Number of rows of the problem table, a power of two.
+    max_problems: int
+    # Device side int32 tensor of one element, the number of output tiles of
+    # all the problems.
+    num_tiles: object
+    # Number of programs of the persistent grid.
+    num_programs: int
+
+
+@jit
+def _problem_table_kernel(offsets_ptr, problems_ptr, num_units_ptr, num_problems, units_per_block,
+                          BLOCK_M: core.constexpr, PAIR: core.constexpr, MAX_PROBLEMS: core.constexpr):
+    # Problem `i` has the rows [offsets[i], offsets[i + 1]), the padding
+    # problems start and end at the last offset.
+    problem = core.arange(0, MAX_PROBLEMS)
+    start = core.load(offsets_ptr + core.minimum(problem, num_problems)).to(core.int32)
+    end = core.load(offsets_ptr + core.minimum(problem + 1, num_problems)).to(core.int32)
+    blocks = standard.cdiv(end - start, BLOCK_M)
+    if PAIR:
+        blocks = (blocks + 1) // 2
+    units = blocks * units_per_block
+    core.store(problems_ptr + problem * 3, start)
+    core.store(problems_ptr + problem * 3 + 1, end - start)
+    core.store(problems_ptr + problem * 3 + 2, standard.cumsum(units, 0) - units)
+    core.store(num_units_ptr, standard.sum(units, 0))
+
+
+def _problem_table(offsets, units_per_block, BLOCK_M, pair=False):
+    # Build the (max_problems, 3) table of the first row, the number of rows
+    # and the first unit of work of the problems delimited by `offsets`, with
+    # `units_per_block` units per block of `BLOCK_M` rows (per pair of blocks
+    # if `pair`), and the number of units of all the problems.
+    import torch
+    num_problems = offsets.numel() - 1
+    max_problems = 1
+    while max_problems < num_problems:
+        max_problems *= 2
+    problems = torch.empty((max_problems, 3), dtype=torch.int32, device=offsets.device)
+    num_units = torch.empty((1, ), dtype=torch.int32, device=offsets.device)
+    _problem_table_kernel[(1, )](offsets, problems, num_units, num_problems, units_per_block, BLOCK_M=BLOCK_M,
+                                 PAIR=pair, MAX_PROBLEMS=max_problems, num_warps=4)
+    return problems, max_problems, num_units
+
+
+def grouped_gemm_schedule_from_offsets(offsets, N: int, BLOCK_M: int, BLOCK_N: int,
+                                       num_programs: Optional[int] = None) -> DeviceGroupedGemmSchedule:
+    """
+    Build, on the device, the problem table of the problems with the rows
+    [offsets[i], offsets[i + 1]) of the concatenated A and C each, from the
+    contiguous 1D integer device tensor `offsets`, and size the persistent
+    grid to `num_programs` programs, which defaults to the number of Xe-cores
+    of the device. The programs left without tiles exit immediately.
+    """
+    assert offsets.dim() == 1 and offsets.is_contiguous() and offsets.numel() >= 2, \
+        "Expecting a contiguous 1D tensor of at least two offsets"
+    if num_programs is None:
+        num_programs = num_xe_cores(offsets.device.index)
+    problems, max_problems, num_tiles = _problem_table(offsets, _cdiv(N, BLOCK_N), BLOCK_M)
+    return DeviceGroupedGemmSchedule(problems, max_problems, num_tiles, num_programs)
+
+
+@jit
+def problem_tile(problems_ptr, tile_id, N, BLOCK_M: core.constexpr, BLOCK_N: core.constexpr,
+                 MAX_PROBLEMS: core.constexpr):
+    """
+    Map `tile_id` to its problem, the first row and the number of rows of the
+    problem, and the (row, column) coordinates of the tile in the problem.
+    """
+    first_tiles = core.load(problems_ptr + core.arange(0, MAX_PROBLEMS) * 3 + 2)
+    # The problems are sorted by first tile, the problem of the tile is the
+    # last one starting at or before it.
+    problem = core.sum((first_tiles <= tile_id).to(core.int32), axis=0) - 1
+    row_offset = core.load(problems_ptr + problem * 3)
+    M = core.load(problems_ptr + problem * 3 + 1)
+    tile_in_problem = tile_id - core.load(problems_ptr + problem * 3 + 2)
+    grid_n = standard.cdiv(N, BLOCK_N)
+    return problem, row_offset, M, tile_in_problem // grid_n, tile_in_problem % grid_n
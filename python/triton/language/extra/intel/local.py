@@ -0,0 +1,90 @@
+"""
+Tensors staged explicitly in the shared local memory (SLM) of a work-group.
+
+A buffer allocated with `local_alloc` lives in SLM for the whole kernel: the
+values stored in it by all the sub-groups are read back with `local_load`, in
+the layout the compiler picks for the loaded tensor. Storing into the same
+buffer again reuses it, e.g. for the K tiles of successive iterations:
+
+    @triton.jit
+    def kernel(k_ptr, ...):
+        k_tile = local_alloc((BLOCK_N, HEAD_DIM), tl.float16)
+        for start_n in range(0, N_CTX, BLOCK_N):
+            local_store(k_tile, tl.load(k_ptrs))
+            k = local_load(k_tile)
+            ...
+
+The buffers are allocated with the shared memory of the compiler, which
+reuses SLM across buffers whose accesses do not overlap, and the barriers
+between the stores and loads of different sub-groups are inserted by the
+membar analysis.
+"""
+
+from triton.language import core, semantic
+
+
+class local_buffer_type(core.dtype):
+
+    def __init__(self, element_ty: core.dtype, shape):
+        self.element_ty = element_ty
+        self.shape = [core._unwrap_if_constexpr(s) for s in shape]
+        self.name = f'local_buffer<{self.shape}, {element_ty}>'
+
+    def to_ir(self, builder):
+        return builder.get_local_buffer_ty(self.element_ty.to_ir(builder), self.shape)
+
+    def __str__(self):
+        return self.name
+
+    def __repr__(self):
+        return self.__str__()
+
+    def __eq__(self, other) -> bool:
+        if not isinstance(other, local_buffer_type):
+            return False
+        return self.element_ty == other.element_ty and self.shape == other.shape
+
+    def __ne__(self, other) -> bool:
+        return not self.__eq__(other)
+
+    @property
+    def scalar(self):
+        return self
+
+
+@core.builtin
+def local_alloc(shape, dtype, _builder=None):
+    """
+    Allocates an uninitialized buffer of `shape` and `dtype` in SLM.
+    """
+    shape = core._shape_check_impl(shape)
+    dtype = core._unwrap_if_constexpr(dtype)
+    ty = local_buffer_type(dtype, shape)
+    return core.tensor(_builder.create_local_alloc(ty.to_ir(_builder)), ty)
+
+
+@core.builtin
+def local_store(buffer, value, _builder=None):
+    """
+    Stores `value`, broadcast to the shape and cast to the type of `buffer`,
+    into `buffer`.
+    """
+    ty = buffer.type
+    if not isinstance(ty, local_buffer_type):
+        raise TypeError(f"local_store expects a local buffer, got {ty}")
+    value = semantic.to_tensor(value, _builder)
+    value = semantic.broadcast_impl_shape(value, ty.shape, _builder)
+    value = semantic.cast(value, ty.element_ty, _builder)
+    _builder.create_local_store(buffer.handle, value.handle)
+
+
+@core.builtin
+def local_load(buffer, _builder=None):
+    """
+    Returns the tensor stored in `buffer`.
+    """
+    ty = buffer.type
+    if not isinstance(ty, local_buffer_type):
+        raise TypeError(f"local_load expects a local buffer, got {ty}")
+    ret_ty = core.block_type(ty.element_ty, ty.shape)
+    return core.tensor(_builder.create_local_load(buffer.handle, ret_ty.to_ir(_builder)), ret_ty)
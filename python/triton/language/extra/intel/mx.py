@@ -0,0 +1,199 @@
+"""
+Block-scaled (microscaling, MX) dots.
+
+The MX formats of the OCP Microscaling specification store the elements of a
+tensor in a narrow format, FP8 (`e4m3`, `e5m2`) or FP4 (`e2m1`), with a shared
+power-of-two scale (`e8m0`) per block of 32 consecutive elements along K. This
+halves (FP8) or quarters (FP4) the memory traffic of the weights of a GEMM
+compared to BF16, which is what limits the throughput of the large models.
+
+The DPAS instructions of current Xe GPUs do not read MX operands, so
+`dot_scaled` upcasts them in registers to BF16, applying their scales, and
+computes the dot with BF16 DPAS instructions. Since the scales are powers of
+two and BF16 has the exponent range of FP32, the rescaled operands are exact.
+
+- `dot_scaled(a, a_scale, a_format, b, b_scale, b_format, acc)` is used by
+  kernels. The `e2m1` operands are packed by two along K, the first element in
+  the low nibble of each byte. The scales of `a` are a (M, K // 32) tensor and
+  the scales of `b` a (N, K // 32) tensor of `uint8` exponents.
+- `quantize_mx` and `dequantize_mx` convert weights to and from an MX format
+  on the host, and `mx_matmul` computes the product of a BF16 activation
+  with MX weights.
+"""
+
+from triton.language import core
+from triton.runtime.jit import jit
+
+from .streamk import _cdiv
+
+# Number of consecutive elements along K sharing a scale.
+MX_BLOCK_SIZE: core.constexpr = 32
+
+# Largest exponent of the normal numbers of the element formats.
+_MAX_EXPONENT = {"e4m3": 8, "e5m2": 15, "e2m1": 2}
+
+# Magnitudes of the `e2m1` values, indexed by their 3 low bits.
+_E2M1_VALUES = (0.0, 0.5, 1.0, 1.5, 2.0, 3.0, 4.0, 6.0)
+
+
+@jit
+def _e8m0_to_bf16(scale):
+    # The exponent 0xFF encodes a NaN, and 0 the subnormal 2^-127.
+    bits = scale.to(core.int32) << 7
+    bits = core.where(scale == 255, 0x7FC0, bits)
+    return bits.to(core.int16).to(core.bfloat16, bitcast=True)
+
+
+@jit
+def _e2m1_to_bf16(x):
+    x = x.to(core.int32)
+    mag = x & 7
+    # The normal values have an exponent mag >> 1 with a bias of 1, and the
+    # subnormal value 1 is 0.5.
+    bits = core.where(mag >= 2, (((mag >> 1) + 126) << 7) | ((mag & 1) << 6), core.where(mag == 1, 0x3F00, 0))
+    bits |= (x & 8) << 12
+    return bits.to(core.int16).to(core.bfloat16, bitcast=True)
+
+
+@jit
+def _unpack_e2m1(x, axis: core.constexpr):
+    x = x.to(core.uint8, bitcast=True)
+    values = core.join(x & 0xF, x >> 4)
+    if axis == 0:
+        values = core.permute(values, (0, 2, 1))
+        return core.reshape(values, (x.shape[0] * 2, x.shape[1]))
+    return core.reshape(values, (x.shape[0], x.shape[1] * 2))
+
+
+@jit
+def _expand_scale(scale, axis: core.constexpr):
+    # Repeat each scale over its block along K.
+    scale = core.expand_dims(_e8m0_to_bf16(scale), 2)
+    scale = core.broadcast_to(scale, (scale.shape[0], scale.shape[1], MX_BLOCK_SIZE))
+    scale = core.reshape(scale, (scale.shape[0], scale.shape[1] * MX_BLOCK_SIZE))
+    if axis == 0:
+        scale = core.permute(scale, (1, 0))
+    return scale
+
+
+@jit
+def upcast_mx(x, scale, format: core.constexpr, axis: core.constexpr):
+    """
+    Return the operand `x` in the MX `format` ("e4m3", "e5m2" or "e2m1") with
+    its K dimension along `axis` as BF16, multiplied by its `scale` if not None.
+    `format` can also be "bf16" for operands that are not block-scaled.
+    """
+    if format == "e2m1":
+        x = _e2m1_to_bf16(_unpack_e2m1(x, axis))
+    elif format == "e4m3":
+        x = x.to(core.float8e4nv, bitcast=True).to(core.bfloat16)
+    elif format == "e5m2":
+        x = x.to(core.float8e5, bitcast=True).to(core.bfloat16)
+    else:
+        core.static_assert(format == "bf16", "Expecting an operand format of e4m3, e5m2, e2m1 or bf16")
+        x = x.to(core.bfloat16)
+    if scale is not None:
+        x = x * _expand_scale(scale, axis)
+    return x
+
+
+@jit
+def dot_scaled(a, a_scale, a_format: core.constexpr, b, b_scale, b_format: core.constexpr, acc=None,
+               out_dtype: core.constexpr = core.float32):
+    """
+    Return the dot of the block-scaled operands `a` (M, K) and `b` (K, N) in
+    their MX formats, accumulated into `acc` if not None.
+    """
+    a = upcast_mx(a, a_scale, a_format, 1)
+    b = upcast_mx(b, b_scale, b_format, 0)
+    return core.dot(a, b, acc, out_dtype=out_dtype)
+
+
+@jit
+def _mx_matmul_kernel(a_ptr, b_ptr, b_scale_ptr, c_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn,
+                      stride_cm, stride_cn, B_FORMAT: core.constexpr, BLOCK_M: core.constexpr,
+                      BLOCK_N: core.constexpr, BLOCK_K: core.constexpr):
+    PACK: core.constexpr = 2 if B_FORMAT == "e2m1" else 1
+    pid_m = core.program_id(0)
+    pid_n = core.program_id(1)
+    offs_m = pid_m * BLOCK_M + core.arange(0, BLOCK_M)
+    offs_n = pid_n * BLOCK_N + core.arange(0, BLOCK_N)
+    offs_k = core.arange(0, BLOCK_K)
+    offs_bk = core.arange(0, BLOCK_K // PACK)
+    offs_sk = core.arange(0, BLOCK_K // MX_BLOCK_SIZE)
+    mask_m = offs_m[:, None] < M
+    mask_n = offs_n[None, :] < N
+    a_ptrs = a_ptr + offs_m[:, None] * stride_am + offs_k[None, :] * stride_ak
+    b_ptrs = b_ptr + offs_bk[:, None] * stride_bk + offs_n[None, :] * stride_bn
+    # The scales are contiguous along K.
+    s_ptrs = b_scale_ptr + offs_n[:, None] * (K // MX_BLOCK_SIZE) + offs_sk[None, :]
+    acc = core.zeros((BLOCK_M, BLOCK_N), dtype=core.float32)
+    for _ in range(0, K, BLOCK_K):
+        a = core.load(a_ptrs, mask=mask_m, other=0.0)
+        b = core.load(b_ptrs, mask=mask_n, other=0)
+        b_scale = core.load(s_ptrs, mask=offs_n[:, None] < N, other=0)
+        acc = dot_scaled(a, None, "bf16", b, b_scale, B_FORMAT, acc)
+        a_ptrs += BLOCK_K * stride_ak
+        b_ptrs += BLOCK_K // PACK * stride_bk
+        s_ptrs += BLOCK_K // MX_BLOCK_SIZE
+    c_ptrs = c_ptr + offs_m[:, None] * stride_cm + offs_n[None, :] * stride_cn
+    core.store(c_ptrs, acc.to(c_ptr.dtype.element_ty), mask=mask_m & mask_n)
+
+
+def quantize_mx(w, format: str):
+    """
+    Quantize the (K, N) tensor `w` to the MX `format` along K. Return its
+    values, a (K, N) FP8 tensor or a (K // 2, N) `uint8` tensor packing the
+    `e2m1` values, and its (N, K // 32) `uint8` scales.
+
+    The shared exponent of a block is the exponent of its largest magnitude
+    minus the largest exponent of the format. The scaled values are rounded to
+    the nearest value of the format, and clamped to its largest magnitude.
+    """
+    import torch
+    assert format in _MAX_EXPONENT, "Expecting an MX format of e4m3, e5m2 or e2m1"
+    K, N = w.shape
+    assert K % (2 * MX_BLOCK_SIZE) == 0, "Expecting K to be a multiple of 64"
+    blocks = w.float().t().reshape(N, K // MX_BLOCK_SIZE, MX_BLOCK_SIZE)
+    amax = blocks.abs().amax(dim=-1, keepdim=True)
+    exponent = torch.floor(torch.log2(amax)) - _MAX_EXPONENT[format]
+    scales = torch.where(amax == 0, 0, exponent + 127).clamp(0, 254)
+    scaled = (blocks / torch.exp2(scales - 127)).reshape(N, K).t()
+    scales = scales.reshape(N, K // MX_BLOCK_SIZE).to(torch.uint8)
+    if format == "e4m3":
+        return scaled.clamp(-448, 448).to(torch.float8_e4m3fn).contiguous(), scales
+    if format == "e5m2":
+        return scaled.clamp(-57344, 57344).to(torch.float8_e5m2).contiguous(), scales
+    table = torch.tensor(_E2M1_VALUES, device=w.device)
+    nibbles = (scaled.abs().unsqueeze(-1) - table).abs().argmin(dim=-1).to(torch.uint8)
+    nibbles |= (scaled < 0).to(torch.uint8) << 3
+    return (nibbles[0::2] | (nibbles[1::2] << 4)).contiguous(), scales
+
+
+def dequantize_mx(values, scales, format: str):
+    """Return the float32 (K, N) tensor of the MX `values` and `scales` of `quantize_mx`."""
+    import torch
+    if format == "e2m1":
+        nibbles = torch.stack((values & 0xF, values >> 4), dim=1).reshape(-1, values.shape[1])
+        table = torch.tensor(_E2M1_VALUES, device=values.device)
+        values = table[(nibbles & 7).long()] * torch.where(nibbles >= 8, -1.0, 1.0)
+    factors = torch.exp2(scales.float() - 127).repeat_interleave(MX_BLOCK_SIZE, dim=1)
+    return values.float() * factors.t()
+
+
+def mx_matmul(a, b, b_scale, b_format: str, BLOCK_M: int = 64, BLOCK_N: int = 64, num_warps: int = 4):
+    """
+    Return the BF16 product of the BF16 (M, K) activation `a` with the weights
+    `b` and `b_scale` quantized to `b_format` by `quantize_mx`.
+    """
+    import torch
+    M, K = a.shape
+    N = b.shape[1]
+    assert K % (2 * MX_BLOCK_SIZE) == 0, "Expecting K to be a multiple of 64"
+    assert b_scale.shape == (N, K // MX_BLOCK_SIZE) and b_scale.is_contiguous(), "Expecting (N, K // 32) scales"
+    c = torch.empty((M, N), dtype=torch.bfloat16, device=a.device)
+    grid = (_cdiv(M, BLOCK_M), _cdiv(N, BLOCK_N))
+    _mx_matmul_kernel[grid](a, b, b_scale, c, M, N, K, a.stride(0), a.stride(1), b.stride(0), b.stride(1),
+                            c.stride(0), c.stride(1), B_FORMAT=b_format, BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N,
+                            BLOCK_K=2 * MX_BLOCK_SIZE, num_warps=num_warps)
+    return c
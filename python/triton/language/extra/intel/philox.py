@@ -0,0 +1,51 @@
+"""
+Interleaved Philox random numbers, e.g. for dropout.
+
+A Philox round produces four random numbers, but `tl.rand` and `tl.randint`
+keep only the first one, so a kernel drawing one random number per element
+(e.g. a dropout mask) runs four times more rounds than needed. The functions
+of this module consume all the outputs of each round instead: the Philox
+round of counter `offset[..., i]` yields the elements `4 * i` to `4 * i + 3`
+along the last dimension of the result, so a block of `4 * N` random numbers
+costs `N` rounds. Drawing the counters `c + tl.arange(0, N)` yields the random
+numbers of stream positions `4 * c` to `4 * c + 4 * N - 1`, the same as
+`tl.randint4x` would in the same positions.
+"""
+
+from triton.language import core
+from triton.language import random
+from triton.language import standard
+from triton.runtime.jit import jit
+
+
+@jit
+def randint_interleaved(seed, offset, n_rounds: core.constexpr = random.N_ROUNDS_DEFAULT):
+    """
+    Given a `seed` scalar and an `offset` block of shape [..., N], return a
+    block of random `int32` of shape [..., 4 * N], whose element `4 * i + j`
+    along the last dimension is the `j`-th output of the Philox round of
+    `offset[..., i]`.
+    """
+    r0, r1, r2, r3 = random.randint4x(seed, offset, n_rounds)
+    return standard.interleave(standard.interleave(r0, r2), standard.interleave(r1, r3))
+
+
+@jit
+def rand_interleaved(seed, offset, n_rounds: core.constexpr = random.N_ROUNDS_DEFAULT):
+    """
+    Given a `seed` scalar and an `offset` block of shape [..., N], return a
+    block of random `float32` in U(0, 1) of shape [..., 4 * N], interleaved
+    as in `randint_interleaved`.
+    """
+    return random.uint_to_uniform_float(randint_interleaved(seed, offset, n_rounds))
+
+
+@jit
+def dropout(x, p, seed, offset, n_rounds: core.constexpr = random.N_ROUNDS_DEFAULT):
+    """
+    Zero the elements of the block `x` of shape [..., 4 * N] with probability
+    `p` and scale the others by 1 / (1 - p), drawing the mask with
+    `rand_interleaved` from the `offset` block of shape [..., N].
+    """
+    keep = rand_interleaved(seed, offset, n_rounds) >= p
+    return core.where(keep, x / (1 - p), 0.0)
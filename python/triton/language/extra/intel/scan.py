@@ -0,0 +1,84 @@
+"""
+Single-pass device-wide scan.
+
+`tl.cumsum` scans the elements held by one program. Scanning a longer sequence
+otherwise needs a scan kernel followed by a kernel propagating the prefix of
+each block, which reads the data twice. `cumsum` computes the inclusive prefix
+sum of a 1D tensor of any length in a single pass, using decoupled lookback:
+
+- Tiles are assigned in launch order by an atomic counter, so a program only
+  waits on tiles that are already being processed, which guarantees forward
+  progress.
+- Each program publishes the sum of its tile (its aggregate), then walks back
+  over the status of the preceding tiles, accumulating their aggregates until
+  it finds a tile whose inclusive prefix is known, and finally publishes its own
+  inclusive prefix.
+
+The status of a tile is a 64-bit word packing the 32-bit value with its flag,
+so a single atomic publishes both. The supported element types are therefore
+`float32` and `int32`.
+"""
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+# Flags of the status of a tile.
+_STATUS_INVALID = core.constexpr(0)
+_STATUS_AGGREGATE = core.constexpr(1)
+_STATUS_PREFIX = core.constexpr(2)
+
+
+@jit
+def _pack_status(value, flag):
+    bits = value.to(core.int32, bitcast=True).to(core.uint32).to(core.int64)
+    return (bits << 32) | flag
+
+
+@jit
+def _unpack_status_value(status, dtype: core.constexpr):
+    return (status >> 32).to(core.int32).to(dtype, bitcast=True)
+
+
+@jit
+def _cumsum_kernel(x_ptr, out_ptr, status_ptr, n_elements, BLOCK_SIZE: core.constexpr):
+    # `status_ptr[0]` is the tile counter, `status_ptr[1 + i]` the status of tile `i`.
+    tile = core.atomic_add(status_ptr, 1).to(core.int32)
+    offsets = tile.to(core.int64) * BLOCK_SIZE + core.arange(0, BLOCK_SIZE)
+    mask = offsets < n_elements
+    x = core.load(x_ptr + offsets, mask=mask, other=0)
+    aggregate = standard.sum(x, 0)
+    core.atomic_xchg(status_ptr + 1 + tile, _pack_status(aggregate, _STATUS_AGGREGATE), sem="release")
+
+    # Look back until a tile with a known inclusive prefix is found.
+    exclusive = core.zeros([], aggregate.dtype)
+    pred = tile - 1
+    while pred >= 0:
+        status = core.atomic_add(status_ptr + 1 + pred, 0, sem="acquire")
+        flag = status & 3
+        ready = flag != _STATUS_INVALID
+        exclusive = core.where(ready, exclusive + _unpack_status_value(status, aggregate.dtype), exclusive)
+        pred = core.where(flag == _STATUS_PREFIX, -1, core.where(ready, pred - 1, pred))
+    core.atomic_xchg(status_ptr + 1 + tile, _pack_status(exclusive + aggregate, _STATUS_PREFIX), sem="release")
+
+    x = standard.cumsum(x, 0) + exclusive
+    core.store(out_ptr + offsets, x.to(out_ptr.dtype.element_ty), mask=mask)
+
+
+def cumsum(x, out=None, BLOCK_SIZE: int = 4096, num_warps: int = 16):
+    """
+    Return the inclusive prefix sum of the contiguous 1D `float32` or `int32`
+    tensor `x`, computed in a single pass over the data. The result is written
+    to `out` if given.
+    """
+    import torch
+    assert x.dim() == 1 and x.is_contiguous(), "Expecting a contiguous 1D tensor"
+    assert x.dtype in (torch.float32, torch.int32), "Only float32 and int32 tensors are supported"
+    if out is None:
+        out = torch.empty_like(x)
+    num_tiles = (x.numel() + BLOCK_SIZE - 1) // BLOCK_SIZE
+    if num_tiles == 0:
+        return out
+    status = torch.zeros(num_tiles + 1, dtype=torch.int64, device=x.device)
+    _cumsum_kernel[(num_tiles, )](x, out, status, x.numel(), BLOCK_SIZE=BLOCK_SIZE, num_warps=num_warps)
+    return out
@@ -0,0 +1,124 @@
+"""
+Online softmax over rows of any length.
+
+A softmax holding a whole row in the registers of one program does not scale to
+rows of vocabulary size, and splitting it into a max kernel, a sum kernel and a
+normalization kernel reads the row three times. The online softmax carries the
+running maximum `m` and the running sum `s` of `exp(x - m)` across the chunks
+of a row, rescaling the sum whenever the maximum grows:
+
+- `online_softmax_stats(x, axis)` reduces a block to its `(m, s)` in a single
+  reduction, combining the partial statistics of the lanes and sub-groups.
+- `online_softmax_update(m, s, x, axis)` folds the statistics of the block `x`
+  into the running `(m, s)` of a loop.
+
+`softmax` reads each row twice, once for its statistics and once to normalize
+it, and `cross_entropy` reads the logits once, since the loss of a row
+`m + log(s) - x[target]` only needs its statistics.
+"""
+
+from triton.language import core
+from triton.language import math
+from triton.runtime.jit import jit
+
+
+@jit
+def _rescale(s, m, new_m):
+    # Rows of -inf only have -inf maxima, whose difference is not a number.
+    return core.where(m == new_m, s, s * math.exp(m - new_m))
+
+
+@jit
+def _combine_stats(m1, s1, m2, s2):
+    m = core.maximum(m1, m2)
+    return m, _rescale(s1, m1, m) + _rescale(s2, m2, m)
+
+
+@jit
+def online_softmax_stats(x, axis: core.constexpr):
+    """
+    Return the maximum `m` of `x` along `axis` and the sum of `exp(x - m)`,
+    in `float32`. The elements equal to -inf, e.g. masked out, are ignored.
+    """
+    x = x.to(core.float32)
+    s = core.where(x == float("-inf"), 0.0, 1.0)
+    return core.reduce((x, s), axis, _combine_stats)
+
+
+@jit
+def online_softmax_update(m, s, x, axis: core.constexpr):
+    """
+    Return the running maximum `m` and sum `s` of a loop updated with the
+    block `x` reduced along `axis`.
+    """
+    block_m, block_s = online_softmax_stats(x, axis)
+    return _combine_stats(m, s, block_m, block_s)
+
+
+@jit
+def _row_stats(x_ptr, n_cols, BLOCK_SIZE: core.constexpr):
+    m = core.full([], float("-inf"), core.float32)
+    s = core.zeros([], core.float32)
+    for start in range(0, n_cols, BLOCK_SIZE):
+        offsets = start + core.arange(0, BLOCK_SIZE)
+        x = core.load(x_ptr + offsets, mask=offsets < n_cols, other=float("-inf"))
+        m, s = online_softmax_update(m, s, x, 0)
+    return m, s
+
+
+@jit
+def _softmax_kernel(x_ptr, out_ptr, x_row_stride, out_row_stride, n_cols, BLOCK_SIZE: core.constexpr):
+    row = core.program_id(0).to(core.int64)
+    x_ptr += row * x_row_stride
+    out_ptr += row * out_row_stride
+    m, s = _row_stats(x_ptr, n_cols, BLOCK_SIZE)
+    for start in range(0, n_cols, BLOCK_SIZE):
+        offsets = start + core.arange(0, BLOCK_SIZE)
+        mask = offsets < n_cols
+        x = core.load(x_ptr + offsets, mask=mask, other=float("-inf")).to(core.float32)
+        y = math.exp(x - m) / s
+        core.store(out_ptr + offsets, y.to(out_ptr.dtype.element_ty), mask=mask)
+
+
+@jit
+def _cross_entropy_kernel(logits_ptr, target_ptr, loss_ptr, row_stride, n_cols, BLOCK_SIZE: core.constexpr):
+    row = core.program_id(0).to(core.int64)
+    logits_ptr += row * row_stride
+    m, s = _row_stats(logits_ptr, n_cols, BLOCK_SIZE)
+    target = core.load(target_ptr + row)
+    x = core.load(logits_ptr + target).to(core.float32)
+    core.store(loss_ptr + row, m + math.log(s) - x)
+
+
+def softmax(x, out=None, BLOCK_SIZE: int = 4096, num_warps: int = 16):
+    """
+    Return the softmax of the rows of the 2D tensor `x`, whose rows are
+    contiguous and of any length. The result is written to `out` if given.
+    """
+    import torch
+    assert x.dim() == 2 and x.stride(1) == 1, "Expecting a 2D tensor with contiguous rows"
+    if out is None:
+        out = torch.empty_like(x)
+    n_rows, n_cols = x.shape
+    if n_rows == 0:
+        return out
+    _softmax_kernel[(n_rows, )](x, out, x.stride(0), out.stride(0), n_cols, BLOCK_SIZE=BLOCK_SIZE,
+                                num_warps=num_warps)
+    return out
+
+
+def cross_entropy(logits, target, BLOCK_SIZE: int = 4096, num_warps: int = 16):
+    """
+    Return the `float32` cross-entropy losses of the rows of the 2D tensor
+    `logits` for the class indices `target`, reading the logits once.
+    """
+    import torch
+    assert logits.dim() == 2 and logits.stride(1) == 1, "Expecting a 2D tensor with contiguous rows"
+    assert target.shape == (logits.shape[0], ), "Expecting a target class per row"
+    n_rows, n_cols = logits.shape
+    loss = torch.empty(n_rows, dtype=torch.float32, device=logits.device)
+    if n_rows == 0:
+        return loss
+    _cross_entropy_kernel[(n_rows, )](logits, target, loss, logits.stride(0), n_cols, BLOCK_SIZE=BLOCK_SIZE,
+                                      num_warps=num_warps)
+    return loss
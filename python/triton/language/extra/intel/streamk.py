@@ -0,0 +1,212 @@
+"""
+Stream-K and split-K schedules for GEMM kernels.
+
+Data-parallel GEMM kernels assign one output tile per program, which leaves most
+Xe-cores idle when the number of tiles is small (e.g. skinny-M problems). The
+helpers in this module decompose the iterations of the K loop of all output tiles
+across a persistent grid sized to the number of Xe-cores of the device:
+
+- `streamk_schedule` computes, on the host, the two-tile Stream-K + data-parallel
+  decomposition of a problem.
+- `iter_range`, `tile_end`, `tile_coords`, `mac_loop` and `store_tile` are used by
+  the kernel to walk its share of the iteration space and fix up partial tiles.
+
+Partial tiles are accumulated with atomic adds, so the output has to be zero
+initialized and use a data type supported by `tl.atomic_add`.
+
+Split-K kernels can instead reduce their partial tiles with `splitk_reduce`:
+each split writes its partial tile to a workspace allocated by
+`splitk_workspace`, and the last split to arrive at a tile (found with a
+counter per tile) sums the partial tiles in split order and runs the epilogue.
+The output is bit-reproducible, needs no initialization and can have any data
+type.
+"""
+
+from typing import NamedTuple, Optional
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+
+def num_xe_cores(device: Optional[int] = None) -> int:
+    """Return the number of Xe-cores of the XPU `device` (the current device by default)."""
+    from triton.runtime import driver
+    if device is None:
+        device = driver.active.get_current_device()
+    return driver.active.utils.get_device_properties(device)["multiprocessor_count"]
+
+
+def _cdiv(x: int, y: int) -> int:
+    return (x + y - 1) // y
+
+
+class StreamKSchedule(NamedTuple):
+    # Number of programs of the persistent Stream-K grid.
+    streamk_programs: int
+    # Number of tiles processed by the persistent Stream-K grid.
+    streamk_tiles: int
+    # Number of tiles left to a regular data-parallel grid, starting at tile `streamk_tiles`.
+    blocking_tiles: int
+    # Number of K loop iterations needed to compute one tile.
+    iters_per_tile: int
+    # Every Stream-K program processes `full_iters` iterations, the first
+    # `partial_iters` programs process one more.
+    full_iters: int
+    partial_iters: int
+
+
+def streamk_schedule(M: int, N: int, K: int, BLOCK_M: int, BLOCK_N: int, BLOCK_K: int,
+                     num_programs: Optional[int] = None, device: Optional[int] = None) -> StreamKSchedule:
+    """
+    Compute a two-tile Stream-K + data-parallel decomposition of a MxNxK GEMM.
+
+    Whole waves of tiles are processed by a data-parallel grid; the remaining
+    tiles (plus one wave, if there is more than one) are spread evenly, by K loop
+    iteration, over `num_programs` programs, which defaults to the number of
+    Xe-cores of `device`.
+    """
+    if num_programs is None:
+        num_programs = num_xe_cores(device)
+    total_tiles = _cdiv(M, BLOCK_M) * _cdiv(N, BLOCK_N)
+    iters_per_tile = _cdiv(K, BLOCK_K)
+
+    streamk_tiles = total_tiles % num_programs
+    if total_tiles - streamk_tiles > num_programs:
+        streamk_tiles += num_programs
+    streamk_iters = streamk_tiles * iters_per_tile
+    # Don't launch programs without any work.
+    streamk_programs = min(num_programs, streamk_iters)
+    if streamk_programs == 0:
+        return StreamKSchedule(0, 0, total_tiles, iters_per_tile, 0, 0)
+    return StreamKSchedule(streamk_programs, streamk_tiles, total_tiles - streamk_tiles, iters_per_tile,
+                           streamk_iters // streamk_programs, streamk_iters % streamk_programs)
+
+
+def splitk_factor(M: int, N: int, K: int, BLOCK_M: int, BLOCK_N: int, BLOCK_K: int,
+                  num_programs: Optional[int] = None, device: Optional[int] = None, max_split: int = 16) -> int:
+    """
+    Return the smallest power of two split-K factor that fills all `num_programs`
+    programs (the number of Xe-cores of `device` by default), without splitting
+    the K loop into chunks of less than one iteration.
+    """
+    if num_programs is None:
+        num_programs = num_xe_cores(device)
+    tiles = _cdiv(M, BLOCK_M) * _cdiv(N, BLOCK_N)
+    iters = _cdiv(K, BLOCK_K)
+    split = 1
+    while tiles * split < num_programs and split * 2 <= min(iters, max_split):
+        split *= 2
+    return split
+
+
+def splitk_workspace(num_tiles: int, split_k: int, BLOCK_M: int, BLOCK_N: int, device=None):
+    """
+    Allocate the workspace of the `float32` partial tiles of `num_tiles` output
+    tiles split `split_k` ways, and their zero initialized arrival counters,
+    for `splitk_reduce`. The counters are reset by the kernel, so the
+    workspace can be reused by successive launches on the same stream.
+    """
+    import torch
+    workspace = torch.empty((num_tiles * split_k * BLOCK_M * BLOCK_N, ), dtype=torch.float32, device=device)
+    counters = torch.zeros((num_tiles, ), dtype=torch.int32, device=device)
+    return workspace, counters
+
+
+@jit
+def splitk_reduce(acc, workspace_ptr, counters_ptr, tile_id, split_id, SPLIT_K: core.constexpr):
+    """
+    Reduce the `float32` partial tiles `acc` of the `SPLIT_K` splits of output
+    tile `tile_id`. Return the sum of the partial tiles, in split order, and
+    whether this program is the last split to arrive, which must store it.
+    """
+    BLOCK_M: core.constexpr = acc.shape[0]
+    BLOCK_N: core.constexpr = acc.shape[1]
+    offsets = core.arange(0, BLOCK_M)[:, None] * BLOCK_N + core.arange(0, BLOCK_N)[None, :]
+    tile_ptr = workspace_ptr + tile_id.to(core.int64) * SPLIT_K * BLOCK_M * BLOCK_N
+    core.store(tile_ptr + split_id * BLOCK_M * BLOCK_N + offsets, acc)
+    # All the work-items of the program have written their part of the tile
+    # before the program arrives.
+    core.debug_barrier()
+    arrived = core.atomic_add(counters_ptr + tile_id, 1, sem="acq_rel")
+    last = arrived == SPLIT_K - 1
+    if last:
+        # Sum in a fixed order, whatever the order of arrival.
+        acc = core.load(tile_ptr + offsets)
+        for split in core.static_range(1, SPLIT_K):
+            acc += core.load(tile_ptr + split * BLOCK_M * BLOCK_N + offsets)
+        core.atomic_xchg(counters_ptr + tile_id, 0, sem="relaxed")
+    return acc, last
+
+
+@jit
+def iter_range(pid, full_iters, partial_iters):
+    """Return the [start, end) range of K loop iterations processed by Stream-K program `pid`."""
+    start_iter = pid * full_iters + core.minimum(pid, partial_iters)
+    last_iter = (pid + 1) * full_iters + core.minimum(pid + 1, partial_iters)
+    return start_iter, last_iter
+
+
+@jit
+def tile_end(start_iter, last_iter, iters_per_tile):
+    """Return the end of the range of iterations, starting at `start_iter`, that belong to the same tile."""
+    end_iter = start_iter + (iters_per_tile - start_iter % iters_per_tile)
+    return core.minimum(end_iter, last_iter)
+
+
+@jit
+def tile_coords(tile_id, M, N, BLOCK_M: core.constexpr, BLOCK_N: core.constexpr, GROUP_M: core.constexpr):
+    """Map `tile_id` to the (row, column) coordinates of the tile; swizzled by groups of `GROUP_M` rows if `GROUP_M > 0`."""
+    grid_m = standard.cdiv(M, BLOCK_M)
+    grid_n = standard.cdiv(N, BLOCK_N)
+    if GROUP_M > 0:
+        width = GROUP_M * grid_n
+        group_id = tile_id // width
+        group_size = core.minimum(GROUP_M, grid_m - group_id * GROUP_M)
+        pid_m = group_id * GROUP_M + (tile_id % group_size)
+        pid_n = (tile_id % width) // group_size
+    else:
+        pid_m = tile_id // grid_n
+        pid_n = tile_id % grid_n
+    return pid_m, pid_n
+
+
+@jit
+def mac_loop(a_ptr, b_ptr, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m, pid_n, start_iter, end_iter,
+             BLOCK_M: core.constexpr, BLOCK_N: core.constexpr, BLOCK_K: core.constexpr,
+             acc_dtype: core.constexpr = core.float32):
+    """Accumulate A[pid_m, k] * B[k, pid_n] for the K loop iterations in [start_iter, end_iter)."""
+    a_block_ptr = core.make_block_ptr(base=a_ptr, shape=(M, K), strides=(stride_am, stride_ak),
+                                      offsets=(pid_m * BLOCK_M, start_iter * BLOCK_K), block_shape=(BLOCK_M, BLOCK_K),
+                                      order=(1, 0))
+    b_block_ptr = core.make_block_ptr(base=b_ptr, shape=(K, N), strides=(stride_bk, stride_bn),
+                                      offsets=(start_iter * BLOCK_K, pid_n * BLOCK_N), block_shape=(BLOCK_K, BLOCK_N),
+                                      order=(1, 0))
+    acc = core.zeros((BLOCK_M, BLOCK_N), dtype=acc_dtype)
+    for _ in range(start_iter, end_iter):
+        a = core.load(a_block_ptr, boundary_check=(0, 1))
+        b = core.load(b_block_ptr, boundary_check=(0, 1))
+        acc += core.dot(a, b, out_dtype=acc_dtype)
+        a_block_ptr = core.advance(a_block_ptr, (0, BLOCK_K))
+        b_block_ptr = core.advance(b_block_ptr, (BLOCK_K, 0))
+    return acc
+
+
+@jit
+def store_tile(c_ptr, acc, M, N, stride_cm, stride_cn, pid_m, pid_n, full_tile, BLOCK_M: core.constexpr,
+               BLOCK_N: core.constexpr):
+    """
+    Write back the (pid_m, pid_n) tile. A `full_tile` is stored directly, partial
+    results are accumulated atomically into the zero initialized output.
+    """
+    if full_tile:
+        c_block_ptr = core.make_block_ptr(base=c_ptr, shape=(M, N), strides=(stride_cm, stride_cn),
+                                          offsets=(pid_m * BLOCK_M, pid_n * BLOCK_N), block_shape=(BLOCK_M, BLOCK_N),
+                                          order=(1, 0))
+        core.store(c_block_ptr, acc.to(c_ptr.dtype.element_ty), boundary_check=(0, 1))
+    else:
+        rm = pid_m * BLOCK_M + core.arange(0, BLOCK_M)
+        rn = pid_n * BLOCK_N + core.arange(0, BLOCK_N)
+        c_ptrs = c_ptr + rm[:, None] * stride_cm + rn[None, :] * stride_cn
+        mask = (rm < M)[:, None] & (rn < N)[None, :]
+        core.atomic_add(c_ptrs, acc.to(c_ptr.dtype.element_ty), mask=mask)
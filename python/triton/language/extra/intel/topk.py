@@ -0,0 +1,148 @@
+"""
+Bitonic top-k, e.g. for the top-k/top-p sampling of LLM decode.
+
+`tl.sort` sorts a whole block, but the sampling of a decode step only needs
+the k largest logits of rows of vocabulary size. The top-k of a block is
+computed by a bitonic network which stops sorting at runs of k elements:
+
+- The runs of `K` elements of the block are sorted, alternately in
+  ascending and descending order, by the first stages of a bitonic sort.
+- The elementwise maximum of an ascending run and the following descending
+  one is a bitonic sequence holding the `K` largest elements of both, which a
+  single bitonic merge sorts again. Each such step halves the block, until a
+  single run of the `K` largest elements is left, sorted in descending order.
+
+The compare-and-swap steps are the reshapes and reductions of `tl.sort`, so
+the exchanges within a sub-group go through sub-group shuffles and the ones
+across sub-groups through shared local memory. The values are sorted along
+with their indices, packed into 64-bit keys which order by value, then by
+index.
+
+`topk` computes the top-k of the rows of a 2D tensor, like `torch.topk`, in
+two kernels: the rows are split across programs until the grid fills the
+device, each program keeping the running top-k of the chunks of its split,
+and a second kernel merges the top-k of the splits of each row.
+"""
+
+from triton.language import core
+from triton.language import standard
+from triton.runtime.jit import jit
+
+from .streamk import _cdiv, num_xe_cores
+
+# Key of the padding elements, lower than the key of any value.
+_MIN_KEY = core.constexpr(-2**63)
+
+
+@jit
+def _to_key(x, index):
+    # Flip the magnitude bits of the negative values, so that the order of
+    # the integers is the order of the floats.
+    bits = x.to(core.float32).to(core.int32, bitcast=True)
+    ordered = bits ^ ((bits >> 31) & 0x7fffffff)
+    return (ordered.to(core.int64) << 32) | index.to(core.int64)
+
+
+@jit
+def _from_key(key):
+    ordered = (key >> 32).to(core.int32)
+    bits = ordered ^ ((ordered >> 31) & 0x7fffffff)
+    return bits.to(core.float32, bitcast=True), key.to(core.int32)
+
+
+@jit
+def sorted_topk(x, K: core.constexpr):
+    """
+    Return the `K` largest elements of `x` along its last dimension, sorted in
+    descending order. `K` and the size of the last dimension are powers of two.
+    """
+    n_dims: core.constexpr = standard._log2(x.shape[-1])
+    k_dims: core.constexpr = standard._log2(K)
+    core.static_assert(k_dims <= n_dims, "K must not exceed the size of the last dimension")
+    # Sort the runs of K elements, alternately in ascending and descending order.
+    for i in core.static_range(1, k_dims + 1):
+        x = standard._bitonic_merge(x, i, 2 if i < n_dims else 1, n_dims)
+    for i in core.static_range(n_dims - k_dims):
+        # The maximum of an ascending and a descending run is a bitonic
+        # sequence of the K largest elements of both.
+        y = core.max(core.reshape(x, [x.numel // (2 * K), 2, K]), axis=1)
+        x = core.reshape(y, x.shape[:-1] + [x.shape[-1] // 2])
+        x = standard._bitonic_merge(x, k_dims, 2 if i < n_dims - k_dims - 1 else 1, n_dims - 1 - i)
+    return x
+
+
+@jit
+def merge_topk(a, b):
+    """
+    Return the largest half of the elements of `a` and `b`, both sorted in
+    descending order along their last dimension, sorted in descending order.
+    """
+    k_dims: core.constexpr = standard._log2(a.shape[-1])
+    return standard._bitonic_merge(core.maximum(a, standard.flip(b)), k_dims, 1, k_dims)
+
+
+@jit
+def _topk_kernel(x_ptr, keys_ptr, row_stride, n_cols, cols_per_split, K: core.constexpr,
+                 BLOCK_SIZE: core.constexpr):
+    row = core.program_id(0).to(core.int64)
+    split = core.program_id(1)
+    x_ptr += row * row_stride
+    start = split * cols_per_split
+    end = core.minimum(start + cols_per_split, n_cols)
+    top = core.full([K], _MIN_KEY, core.int64)
+    for chunk in range(start, end, BLOCK_SIZE):
+        offsets = chunk + core.arange(0, BLOCK_SIZE)
+        mask = offsets < end
+        x = core.load(x_ptr + offsets, mask=mask, other=float("-inf"))
+        keys = core.where(mask, _to_key(x, offsets), _MIN_KEY)
+        top = merge_topk(top, sorted_topk(keys, K))
+    keys_ptr += (row * core.num_programs(1) + split) * K
+    core.store(keys_ptr + core.arange(0, K), top)
+
+
+@jit
+def _topk_merge_kernel(keys_ptr, values_ptr, indices_ptr, k, K: core.constexpr, NUM_SPLITS: core.constexpr):
+    row = core.program_id(0).to(core.int64)
+    keys = core.load(keys_ptr + row * NUM_SPLITS * K + core.arange(0, NUM_SPLITS * K))
+    values, indices = _from_key(sorted_topk(keys, K))
+    offsets = core.arange(0, K)
+    mask = offsets < k
+    core.store(values_ptr + row * k + offsets, values.to(values_ptr.dtype.element_ty), mask=mask)
+    core.store(indices_ptr + row * k + offsets, indices.to(core.int64), mask=mask)
+
+
+def _next_power_of_2(n: int) -> int:
+    power = 1
+    while power < n:
+        power *= 2
+    return power
+
+
+def topk(x, k: int, BLOCK_SIZE: int = 1024, num_splits=None, num_warps: int = 8):
+    """
+    Return the `k` largest elements of the rows of the 2D tensor `x`, whose
+    rows are contiguous, sorted in descending order, and their `int64`
+    indices, like `torch.topk(x, k)`. The rows are split `num_splits` ways,
+    a power of two which by default fills the device twice, without splitting
+    a row into less than a chunk of `BLOCK_SIZE` elements per split.
+    """
+    import torch
+    assert x.dim() == 2 and x.stride(1) == 1, "Expecting a 2D tensor with contiguous rows"
+    n_rows, n_cols = x.shape
+    assert 0 < k <= n_cols, "Expecting 0 < k <= number of columns"
+    values = torch.empty((n_rows, k), dtype=x.dtype, device=x.device)
+    indices = torch.empty((n_rows, k), dtype=torch.int64, device=x.device)
+    if n_rows == 0:
+        return values, indices
+    K = max(_next_power_of_2(k), 2)
+    BLOCK_SIZE = max(BLOCK_SIZE, K)
+    if num_splits is None:
+        num_splits = 1
+        while n_rows * num_splits < 2 * num_xe_cores(x.device.index) and num_splits * 2 <= _cdiv(n_cols, BLOCK_SIZE):
+            num_splits *= 2
+    cols_per_split = _cdiv(_cdiv(n_cols, num_splits), BLOCK_SIZE) * BLOCK_SIZE
+    keys = torch.empty((n_rows, num_splits, K), dtype=torch.int64, device=x.device)
+    _topk_kernel[(n_rows, num_splits)](x, keys, x.stride(0), n_cols, cols_per_split, K=K, BLOCK_SIZE=BLOCK_SIZE,
+                                       num_warps=num_warps)
+    _topk_merge_kernel[(n_rows, )](keys, values, indices, k, K=K, NUM_SPLITS=num_splits, num_warps=num_warps)
+    return values, indices
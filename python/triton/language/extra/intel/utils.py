@@ -7,6 +7,19 @@ def globaltimer(_builder=None):
                                        _builder=_builder)
 
 
+@core.extern
+def clock(_builder=None):
+    """
+    Returns the cycle counter of the subgroup, read with the SPIR-V
+    `OpReadClockKHR` instruction (SPV_KHR_shader_clock).
+    The counter is only meaningful for differences taken within a subgroup.
+    """
+    # 3 is the SPIR-V Subgroup scope
+    return core.extern_elementwise("", "", [3],
+                                   {(core.int32, ): ("_Z20__spirv_ReadClockKHRi", core.int64)}, is_pure=False,
+                                   _builder=_builder)
+
+
 @core.extern
 def smid(_builder=None):
     return core.inline_asm_elementwise("mov.u32 $0, %smid;", "=r", [], dtype=core.int32, is_pure=True, pack=1,
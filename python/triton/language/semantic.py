@@ -922,6 +922,8 @@ def _str_to_load_cache_modifier(cache_modifier):
             cache = ir.CACHE_MODIFIER.CA
         elif cache_modifier == ".cg":
             cache = ir.CACHE_MODIFIER.CG
+        elif cache_modifier == ".cs":
+            cache = ir.CACHE_MODIFIER.CS
         else:
             raise ValueError(f"Cache modifier {cache_modifier} not supported")
     return cache
@@ -1272,7 +1274,9 @@ def atom_red_typechecking_impl(ptr: tl.tensor, val: tl.tensor, mask: tl.tensor,
     element_ty = ptr.type.scalar.element_ty
     if element_ty is tl.float16 and op != 'add':
         raise ValueError("atomic_" + op + " does not support fp16")
-    if element_ty in [tl.int1, tl.int8, tl.int16, tl.bfloat16]:
+    # The Intel backend emulates bf16 additions like fp16 ones.
+    bf16_add = element_ty is tl.bfloat16 and op == 'add' and builder.options.backend_name == 'intel'
+    if element_ty in [tl.int1, tl.int8, tl.int16, tl.bfloat16] and not bf16_add:
         raise ValueError("atomic_" + op + " does not support " + str(element_ty))
     if ptr.type.is_block():
         if mask is not None:
@@ -1421,6 +1425,8 @@ def _str_to_dot_input_precision(input_precision, builder):
     input_precision = input_precision.upper()
     if input_precision == "TF32X3":
         input_precision = "TF32x3"
+    if input_precision == "BF16X3":
+        input_precision = "BF16x3"
     return getattr(ir.INPUT_PRECISION, input_precision)
 
 
@@ -3,12 +3,14 @@ from .cache import RedisRemoteCacheBackend, RemoteCacheBackend
 from .driver import driver
 from .jit import JITFunction, KernelInterface, MockTensor, TensorWrapper, reinterpret
 from .errors import OutOfResources, InterpreterError
+from .fusion import FusedLaunch
 
 __all__ = [
     "autotune",
     "Autotuner",
     "Config",
     "driver",
+    "FusedLaunch",
     "Heuristics",
     "heuristics",
     "InterpreterError",
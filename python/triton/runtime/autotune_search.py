@@ -0,0 +1,164 @@
+"""
+Strategies searching the configs of an autotuned kernel for the fastest one,
+passed as `search_strategy` to `triton.autotune`:
+
+- `ExhaustiveSearch` benchmarks every config for the full repetition time.
+- `SuccessiveHalving` benchmarks every config briefly, then only the fastest
+  ones for longer, until the full repetition time.
+- `ModelBasedSearch` benchmarks a sample of the configs, then the ones a model
+  fitted on the measured timings predicts to be the fastest.
+"""
+
+import builtins
+import math
+import random
+
+
+class SearchStrategy:
+    """
+    Base class of the autotuning search strategies. Configs spilling more than
+    `max_spills` bytes (per the metadata of their compiled kernel) are skipped
+    without being benchmarked, unless `max_spills` is None.
+    """
+
+    max_spills = None
+
+    def search(self, configs, bench, rep):
+        """
+        Returns the best of `configs` and the timings of the benchmarked
+        configs. `bench(config, rep, stop_if_slower_than=None)` returns the
+        [median, p20, p80] times in ms of `config` benchmarked for `rep` ms, the
+        repetition time of the autotuner.
+        """
+        raise NotImplementedError
+
+
+def _best(timings):
+    return builtins.min(timings, key=timings.get)
+
+
+class ExhaustiveSearch(SearchStrategy):
+    """
+    Benchmarks all the configs. With `early_stop`, a config is no longer
+    benchmarked once its median time exceeds `early_stop` times the best one so
+    far.
+    """
+
+    def __init__(self, early_stop=None):
+        self.early_stop = early_stop
+
+    def search(self, configs, bench, rep):
+        timings = {}
+        best = float("inf")
+        for config in configs:
+            stop_if_slower_than = None
+            if self.early_stop is not None and best != float("inf"):
+                stop_if_slower_than = best * self.early_stop
+            timings[config] = bench(config, rep, stop_if_slower_than=stop_if_slower_than)
+            best = builtins.min(best, timings[config][0])
+        return _best(timings), timings
+
+
+class SuccessiveHalving(SearchStrategy):
+    """
+    Benchmarks the configs in rounds, keeping the fastest `1 / eta` of them
+    for the next round, which benchmarks them `eta` times longer. The last
+    round benchmarks the remaining configs for the full repetition time, and
+    the first one for at least `min_rep` ms.
+    """
+
+    def __init__(self, eta=3, min_rep=1, max_spills=0):
+        assert eta > 1, "eta must be greater than 1"
+        self.eta = eta
+        self.min_rep = min_rep
+        self.max_spills = max_spills
+
+    def search(self, configs, bench, rep):
+        timings = {}
+        candidates = list(configs)
+        num_rounds = builtins.max(1, math.ceil(math.log(builtins.max(len(candidates), 1), self.eta)))
+        for i in range(num_rounds):
+            round_rep = builtins.max(rep / self.eta**(num_rounds - 1 - i), builtins.min(self.min_rep, rep))
+            round_timings = {config: bench(config, round_rep) for config in candidates}
+            timings.update(round_timings)
+            if i == num_rounds - 1:
+                break
+            candidates.sort(key=lambda config: round_timings[config][0])
+            candidates = candidates[:builtins.max(1, math.ceil(len(candidates) / self.eta))]
+        # The timings of the last round are the only ones measured with the full
+        # repetition time.
+        return _best({config: timings[config] for config in candidates}), timings
+
+
+class ModelBasedSearch(SearchStrategy):
+    """
+    Benchmarks `num_initial` random configs, then, until `budget` configs (or
+    this fraction of the configs) are benchmarked, the config minimizing a
+    lower confidence bound of its predicted time. The log time of a config is
+    predicted by inverse distance weighting of the benchmarked configs, with
+    a distance between the log2 of the numeric parameters that counts the
+    other parameters (e.g. `grf_mode`) as 1 when they differ. The bound
+    favors configs far from the benchmarked ones by `exploration` times that
+    distance.
+    """
+
+    def __init__(self, budget=0.25, num_initial=4, exploration=0.5, seed=0, max_spills=0):
+        self.budget = budget
+        self.num_initial = num_initial
+        self.exploration = exploration
+        self.seed = seed
+        self.max_spills = max_spills
+
+    @staticmethod
+    def _features(config):
+        return {
+            name: math.log2(value) if isinstance(value, (int, float)) and not isinstance(value, bool) and value > 0 else
+            value
+            for name, value in config.all_kwargs().items()
+        }
+
+    @staticmethod
+    def _distance(a, b):
+        distance = 0.0
+        for name in a.keys() | b.keys():
+            x, y = a.get(name), b.get(name)
+            if isinstance(x, float) and isinstance(y, float):
+                distance += abs(x - y)
+            elif x != y:
+                distance += 1.0
+        return distance
+
+    def search(self, configs, bench, rep):
+        budget = self.budget
+        if isinstance(budget, float) and budget <= 1.0:
+            budget = math.ceil(len(configs) * budget)
+        budget = builtins.min(builtins.max(budget, 1), len(configs))
+        features = {config: self._features(config) for config in configs}
+        remaining = list(configs)
+        random.Random(self.seed).shuffle(remaining)
+
+        timings = {}
+        for config in remaining[:builtins.min(self.num_initial, budget)]:
+            timings[config] = bench(config, rep)
+        remaining = remaining[len(timings):]
+
+        while len(timings) < budget and remaining:
+            finite = [math.log(t[0]) for t in timings.values() if math.isfinite(t[0]) and t[0] > 0]
+            # Failed configs count as slower than the slowest one.
+            worst = builtins.max(finite) + 1.0 if finite else 0.0
+
+            def lower_bound(config):
+                weights, total, nearest = 0.0, 0.0, float("inf")
+                for measured, timing in timings.items():
+                    distance = self._distance(features[config], features[measured])
+                    value = math.log(timing[0]) if math.isfinite(timing[0]) and timing[0] > 0 else worst
+                    weight = 1.0 / (distance * distance + 1e-6)
+                    weights += weight
+                    total += weight * value
+                    nearest = builtins.min(nearest, distance)
+                return total / weights - self.exploration * nearest
+
+            config = builtins.min(remaining, key=lower_bound)
+            remaining.remove(config)
+            timings[config] = bench(config, rep)
+        return _best(timings), timings
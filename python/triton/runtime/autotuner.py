@@ -1,14 +1,24 @@
 from __future__ import annotations
 
 import builtins
+import contextlib
+import functools
+import math
 import os
 import time
 import inspect
+from concurrent.futures import ThreadPoolExecutor
 from typing import Dict
 
 from ..testing import do_bench, do_bench_cudagraph
+from .autotune_search import ExhaustiveSearch, ModelBasedSearch, SuccessiveHalving
 from .jit import KernelInterface
 from .errors import OutOfResources
+from .driver import driver
+
+
+# The search strategies selected by `TRITON_AUTOTUNE_SEARCH`.
+_SEARCH_STRATEGIES = {"exhaustive": ExhaustiveSearch, "halving": SuccessiveHalving, "model": ModelBasedSearch}
 
 
 class Autotuner(KernelInterface):
@@ -27,12 +37,20 @@ class Autotuner(KernelInterface):
         warmup=25,
         rep=100,
         use_cuda_graph=False,
+        early_stop=None,
+        async_compile=False,
+        search_strategy=None,
     ):
         """
         :param prune_configs_by: a dict of functions that are used to prune configs, fields:
             'perf_model': performance model used to predicate running time with different configs, returns running time
             'top_k': number of configs to bench
             'prune_num_stages_by'(optional): a function used to prune num_stages. It takes configs:List[Config] as its input, and returns pruned configs.
+            'kernel_prune'(optional): a function pruning the configs from their compiled kernels, see `autotune`.
+        :param early_stop: stop benchmarking a config once its median runtime exceeds `early_stop` times the best one so far.
+        :param async_compile: compile the configs for a new key in the background, running the config tuned for the
+            nearest key until they are ready.
+        :param search_strategy: the `SearchStrategy` selecting the configs to benchmark.
         """
         if not configs:
             self.configs = [Config({}, num_warps=4, num_stages=2, num_ctas=1)]
@@ -79,10 +97,12 @@ class Autotuner(KernelInterface):
         self.perf_model = None
         self.configs_top_k = 1.0
         self.early_config_prune = None
+        self.kernel_prune = None
         if prune_configs_by:
             self.perf_model = prune_configs_by.get("perf_model", self.perf_model)
             self.configs_top_k = prune_configs_by.get("top_k", self.configs_top_k)
             self.early_config_prune = prune_configs_by.get("early_config_prune", self.early_config_prune)
+            self.kernel_prune = prune_configs_by.get("kernel_prune", self.kernel_prune)
 
         self.fn = fn
         self.base_fn = fn
@@ -90,10 +110,22 @@ class Autotuner(KernelInterface):
             self.base_fn = self.base_fn.fn
         self.num_warmups = warmup
         self.num_reps = rep
+        self.early_stop = early_stop
+        if search_strategy is None:
+            search_strategy = _SEARCH_STRATEGIES.get(os.getenv("TRITON_AUTOTUNE_SEARCH", ""), ExhaustiveSearch)()
+            if isinstance(search_strategy, ExhaustiveSearch):
+                search_strategy.early_stop = early_stop
+        self.search_strategy = search_strategy
+        self.async_compile = async_compile or os.getenv("TRITON_ASYNC_COMPILE", "0") == "1"
+        # Background compilations of the configs for the keys being tuned.
+        self.compiling = {}
+        # Persistent database of the tuned configs (see `TRITON_AUTOTUNE_DB`).
+        self.tuning_db = None
+        self.tuning_db_path = None
         import torch
         self.use_cuda_graph = use_cuda_graph and torch.cuda.is_available()
 
-    def _bench(self, *args, config, **meta):
+    def _bench(self, *args, config, num_reps=None, stop_if_slower_than=None, **meta):
         from ..compiler.errors import CompileTimeAssertionFailure
 
         # check for conflicts, i.e. meta-parameters both provided
@@ -125,12 +157,156 @@ class Autotuner(KernelInterface):
             self.post_hook(args, exception=None)
 
         try:
+            rep = num_reps or self.num_reps
             if self.use_cuda_graph:
-                return do_bench_cudagraph(kernel_call, rep=self.num_reps, quantiles=(0.5, 0.2, 0.8))
-            return do_bench(kernel_call, warmup=self.num_warmups, rep=self.num_reps, quantiles=(0.5, 0.2, 0.8))
+                return do_bench_cudagraph(kernel_call, rep=rep, quantiles=(0.5, 0.2, 0.8))
+            return do_bench(kernel_call, warmup=self.num_warmups, rep=rep, quantiles=(0.5, 0.2, 0.8),
+                            stop_if_slower_than=stop_if_slower_than)
         except (OutOfResources, CompileTimeAssertionFailure):
             return [float("inf"), float("inf"), float("inf")]
 
+    def _spills(self, config, *args, **kwargs):
+        """
+        Returns whether `config` fails to compile or spills more than the
+        search strategy allows, per the metadata of its compiled kernel.
+        """
+        from ..compiler.errors import CompileTimeAssertionFailure
+        max_spills = self.search_strategy.max_spills
+        if max_spills is None:
+            return False
+        try:
+            kernel = self.fn.run(*args, **{**kwargs, **config.all_kwargs(), "warmup": True})
+            kernel._init_handles()
+        except (OutOfResources, CompileTimeAssertionFailure):
+            return True
+        return (kernel.n_spills or 0) > max_spills
+
+    def _compile_configs(self, configs, *args, **kwargs):
+        """
+        Compiles `configs` concurrently with `TRITON_COMPILE_WORKERS` threads,
+        so that benchmarking them only hits the kernel cache.
+
+        With `TRITON_LINK_KERNELS=1`, backends supporting it load the compiled
+        configs together, building the device binaries of all of them at once.
+        """
+        num_workers = int(os.getenv("TRITON_COMPILE_WORKERS", "1"))
+        link_kernels = os.getenv("TRITON_LINK_KERNELS", "0") == "1" and hasattr(driver.active.utils, "load_kernels")
+        if (num_workers <= 1 and not link_kernels) or len(configs) <= 1:
+            return
+        self._compile_all(configs, args, kwargs)
+
+    def _prune_compiled(self, configs, *args, **kwargs):
+        """
+        Compiles and loads all `configs`, and returns the ones selected by the
+        `kernel_prune` hook from their kernels. The configs failing to compile
+        or to load are dropped, unless all of them do, so that the errors are
+        reported when they are benchmarked.
+        """
+        from ..compiler.errors import CompileTimeAssertionFailure
+        kernels = {}
+        for config, kernel in zip(configs, self._compile_all(configs, args, kwargs)):
+            if kernel is None:
+                continue
+            try:
+                # Load the kernel to get the resources reported by the driver.
+                kernel._init_handles()
+            except (OutOfResources, CompileTimeAssertionFailure):
+                continue
+            kernels[config] = kernel
+        if not kernels:
+            return configs
+        return self.kernel_prune([config for config in configs if config in kernels], kernels, self.nargs, **kwargs)
+
+    def _compile_all(self, configs, args, kwargs):
+        from ..compiler.compiler import shared_context, use_context
+        num_workers = int(os.getenv("TRITON_COMPILE_WORKERS", "1"))
+        link_kernels = os.getenv("TRITON_LINK_KERNELS", "0") == "1" and hasattr(driver.active.utils, "load_kernels")
+
+        def compile_config(context, config):
+            try:
+                with use_context(context):
+                    kernel = self.fn.run(*args, **{**kwargs, **config.all_kwargs(), "warmup": True})
+                # Also build the device binary.
+                if not link_kernels:
+                    kernel._init_handles()
+                return kernel
+            except Exception:
+                # Compilation errors are reported when the config is benchmarked.
+                return None
+
+        # The workers compile the configs in a single MLIR context.
+        with shared_context() if num_workers > 1 else contextlib.nullcontext() as context:
+            with ThreadPoolExecutor(max_workers=max(num_workers, 1)) as executor:
+                kernels = list(executor.map(functools.partial(compile_config, context), configs))
+        if link_kernels:
+            driver.active.utils.load_kernels([k for k in kernels if k is not None], driver.active.get_current_device())
+        return kernels
+
+    def _nearest_config(self, key):
+        """
+        Returns the config tuned for the key closest to `key`, comparing numeric
+        entries in log scale while the other entries (e.g. dtypes) must match,
+        or the first config if there is none.
+        """
+        best_config, best_distance = self.configs[0], float("inf")
+        for tuned_key, config in self.cache.items():
+            if len(tuned_key) != len(key):
+                continue
+            distance = 0.0
+            for a, b in zip(key, tuned_key):
+                if isinstance(a, (int, float)) and isinstance(b, (int, float)):
+                    distance += abs(math.log2(builtins.max(abs(a), 1)) - math.log2(builtins.max(abs(b), 1)))
+                elif a != b:
+                    distance = float("inf")
+                    break
+            if distance < best_distance:
+                best_config, best_distance = config, distance
+        return best_config
+
+    def _async_config(self, key, *args, **kwargs):
+        """
+        Returns the config to run for the untuned `key` in async-compile mode.
+        The configs are compiled by a background thread, meanwhile the config
+        tuned for the nearest key is used. Once they are compiled, the configs
+        are benchmarked and the best one is used from then on. Returns `None`
+        when the key has just been tuned.
+        """
+        future = self.compiling.get(key)
+        if future is None:
+            self.compiling[key] = _get_async_compile_executor().submit(self._compile_all, self.prune_configs(kwargs),
+                                                                      args, kwargs)
+            return self._nearest_config(key)
+        if not future.done():
+            return self._nearest_config(key)
+        del self.compiling[key]
+        return None
+
+    def _kernel_hash(self):
+        fn = self.fn
+        while not hasattr(fn, "cache_key"):
+            fn = fn.fn
+        return fn.cache_key
+
+    def _get_tuning_db(self):
+        """
+        Returns the tuning database at `TRITON_AUTOTUNE_DB`, if set. When it is
+        first opened, the configs it holds for this kernel and target are added
+        to the cache, unless they are no longer among the tuned configs.
+        """
+        path = os.getenv("TRITON_AUTOTUNE_DB", "").strip()
+        if not path:
+            return None
+        if self.tuning_db is None or self.tuning_db_path != path:
+            from .tuning_db import TuningDatabase
+            self.tuning_db, self.tuning_db_path = TuningDatabase(path), path
+            configs = {str(sorted(config.all_kwargs().items())): config for config in self.configs}
+            stored = self.tuning_db.load(self._kernel_hash(), driver.active.get_current_target())
+            for key, config in stored.items():
+                config = configs.get(str(sorted(config.all_kwargs().items())))
+                if config is not None:
+                    self.cache.setdefault(key, config)
+        return self.tuning_db
+
     def run(self, *args, **kwargs):
         self.nargs = dict(zip(self.arg_names, args))
         used_cached_result = True
@@ -145,18 +321,36 @@ class Autotuner(KernelInterface):
                 if hasattr(arg, "dtype"):
                     key.append(str(arg.dtype))
             key = tuple(key)
-            if key not in self.cache:
+            tuning_db = self._get_tuning_db()
+            fallback_config = None
+            if key not in self.cache and self.async_compile:
+                fallback_config = self._async_config(key, *args, **kwargs)
+            if fallback_config is None and key not in self.cache:
                 # prune configs
                 used_cached_result = False
                 pruned_configs = self.prune_configs(kwargs)
                 bench_start = time.time()
-                timings = {config: self._bench(*args, config=config, **kwargs) for config in pruned_configs}
+                if self.kernel_prune is not None and len(pruned_configs) > 1:
+                    pruned_configs = self._prune_compiled(pruned_configs, *args, **kwargs)
+                else:
+                    self._compile_configs(pruned_configs, *args, **kwargs)
+
+                def bench(config, rep, stop_if_slower_than=None):
+                    if self._spills(config, *args, **kwargs):
+                        return [float("inf"), float("inf"), float("inf")]
+                    return self._bench(*args, config=config, num_reps=rep, stop_if_slower_than=stop_if_slower_than,
+                                       **kwargs)
+
+                best_config, timings = self.search_strategy.search(pruned_configs, bench, self.num_reps)
                 bench_end = time.time()
                 self.bench_time = bench_end - bench_start
-                self.cache[key] = builtins.min(timings, key=timings.get)
+                self.cache[key] = best_config
+                if tuning_db is not None:
+                    tuning_db.store(self._kernel_hash(), driver.active.get_current_target(), key, self.cache[key],
+                                    timings[self.cache[key]][0])
                 self.pre_hook(args, reset_only=True)
                 self.configs_timings = timings
-            config = self.cache[key]
+            config = self.cache[key] if fallback_config is None else fallback_config
         else:
             config = self.configs[0]
         self.best_config = config
@@ -259,8 +453,18 @@ class Config:
         return ", ".join(res)
 
 
+_async_compile_executor = None
+
+
+def _get_async_compile_executor():
+    global _async_compile_executor
+    if _async_compile_executor is None:
+        _async_compile_executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="triton-compile")
+    return _async_compile_executor
+
+
 def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_value=None, pre_hook=None, post_hook=None,
-             warmup=25, rep=100, use_cuda_graph=False):
+             warmup=25, rep=100, use_cuda_graph=False, early_stop=None, async_compile=False, search_strategy=None):
     """
     Decorator for auto-tuning a :code:`triton.jit`'d function.
 
@@ -286,6 +490,20 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
     :code:`"1"`, Triton will print a message to stdout after autotuning each
     kernel, including the time spent autotuning and the best configuration.
 
+    If the environment variable :code:`TRITON_COMPILE_WORKERS` is set to a
+    number greater than 1, the configurations are compiled concurrently by that
+    many threads before they are benchmarked.
+
+    If the environment variable :code:`TRITON_AUTOTUNE_DB` is set to a path,
+    the best config of each key is stored in the SQLite database at that path,
+    shared by the processes tuning the kernels. An autotuned kernel starts from
+    the configs stored for its source and the current target, and only
+    benchmarks the other keys (see :code:`triton.runtime.tuning_db`).
+
+    If the environment variable :code:`TRITON_ASYNC_COMPILE` is set to
+    :code:`"1"`, all autotuned kernels use the async-compile mode (see
+    :code:`async_compile`).
+
     :param configs: a list of :code:`triton.Config` objects
     :type configs: list[triton.Config]
     :param key: a list of argument names whose change in value will trigger the evaluation of all provided configs.
@@ -294,6 +512,10 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
         'perf_model': performance model used to predicate running time with different configs, returns running time
         'top_k': number of configs to bench
         'early_config_prune'(optional): a function used to do early prune (eg, num_stages). It takes configs:List[Config] as its input, and returns pruned configs.
+        'kernel_prune'(optional): a function pruning the configs from their compiled kernels, e.g. from the spills or the
+        occupancy in their metadata. The configs are all compiled (with :code:`TRITON_COMPILE_WORKERS` threads) and loaded
+        first, then it takes the configs that compiled, a dict of their kernels, the named arguments and the keyword
+        arguments, and returns the configs to benchmark. See :code:`triton.backends.intel.resource_prune` for XPU.
     :param reset_to_zero: a list of argument names whose value will be reset to zero before evaluating any configs.
     :type reset_to_zero: list[str]
     :param restore_value: a list of argument names whose value will be restored after evaluating any configs.
@@ -312,12 +534,28 @@ def autotune(configs, key, prune_configs_by=None, reset_to_zero=None, restore_va
     :type warmup: int
     :param rep: Repetition time (in ms) to pass to benchmarking, defaults to 100.
     :type rep: int
+    :param early_stop: Stop benchmarking a config once its median runtime exceeds :code:`early_stop` times the
+        median runtime of the best config so far, e.g. 1.5. Disabled by default.
+    :type early_stop: float, optional
+    :param async_compile: Don't block on compilation when a new key is seen. The configs are compiled in a background
+        thread, and meanwhile the kernel runs with the config tuned for the nearest key (comparing numeric key
+        entries in log scale), or the first config. The first call after the compilation is done benchmarks the
+        configs, and the best one is used for the key from then on. Disabled by default.
+    :type async_compile: bool
+    :param search_strategy: How the configs are searched for the fastest one, a
+        :code:`triton.runtime.autotune_search.SearchStrategy`: :code:`ExhaustiveSearch` (the default) benchmarks all of
+        them, :code:`SuccessiveHalving` benchmarks them briefly and only the fastest ones for longer, and
+        :code:`ModelBasedSearch` only benchmarks the configs a model of the measured timings predicts to be the
+        fastest. Both skip the configs that fail to compile or spill. The environment variable
+        :code:`TRITON_AUTOTUNE_SEARCH` (:code:`exhaustive`, :code:`halving` or :code:`model`) selects the default one.
+    :type search_strategy: SearchStrategy, optional
     """
 
     def decorator(fn):
         return Autotuner(fn, fn.arg_names, configs, key, reset_to_zero, restore_value, pre_hook=pre_hook,
                          post_hook=post_hook, prune_configs_by=prune_configs_by, warmup=warmup, rep=rep,
-                         use_cuda_graph=use_cuda_graph)
+                         use_cuda_graph=use_cuda_graph, early_stop=early_stop, async_compile=async_compile,
+                         search_strategy=search_strategy)
 
     return decorator
 
@@ -1,8 +1,12 @@
+import functools
 import importlib
 import json
 import os
+import shutil
+import threading
 import uuid
 from abc import ABC, abstractmethod
+from dataclasses import asdict, dataclass
 from pathlib import Path
 from typing import Dict, List, Optional
 import base64
@@ -25,6 +29,230 @@ def default_dump_dir():
     return os.path.join(get_home_dir(), ".triton", "dump")
 
 
+# Magic number of zstd frames.
+ZSTD_MAGIC = b"\x28\xb5\x2f\xfd"
+
+
+@functools.lru_cache()
+def _zstd_dictionary(path):
+    import zstandard
+    return zstandard.ZstdCompressionDict(Path(path).read_bytes())
+
+
+def _zstd_options():
+    # A dictionary trained on a family of kernels (see
+    # `triton.tools.train_cache_dictionary`) compresses its small entries
+    # better. The entries compressed with it can only be read with it.
+    dict_path = os.getenv("TRITON_CACHE_ZSTD_DICT", "").strip()
+    return {"dict_data": _zstd_dictionary(dict_path)} if dict_path else {}
+
+
+def compress_cache_entry(data):
+    """
+    Compresses the binary cache entry `data` (e.g. SPIR-V or a native binary)
+    with zstd if `TRITON_CACHE_COMPRESSION=zstd` and the `zstandard` package
+    is installed.
+    """
+    if os.getenv("TRITON_CACHE_COMPRESSION", "").strip() != "zstd":
+        return data
+    try:
+        import zstandard
+    except ImportError:
+        return data
+    level = int(os.getenv("TRITON_CACHE_ZSTD_LEVEL", "3"))
+    return zstandard.ZstdCompressor(level=level, **_zstd_options()).compress(data)
+
+
+def read_cache_entry(path):
+    """
+    Reads the binary cache entry at `path`, which is decompressed if it was
+    compressed by `compress_cache_entry`. The frames are decompressed from the
+    file straight into a buffer of their size.
+    """
+    with open(path, "rb") as f:
+        header = f.read(18)
+        f.seek(0)
+        if not header.startswith(ZSTD_MAGIC):
+            return f.read()
+        import zstandard
+        size = zstandard.frame_content_size(header)
+        if size < 0:
+            raise ValueError(f"{path}: zstd frame without content size")
+        buffer = bytearray(size)
+        view = memoryview(buffer)
+        offset = 0
+        with zstandard.ZstdDecompressor(**_zstd_options()).stream_reader(f) as reader:
+            while offset < size:
+                read = reader.readinto(view[offset:])
+                if read == 0:
+                    raise ValueError(f"{path}: truncated zstd frame")
+                offset += read
+        return buffer
+
+
+def _parse_size(size):
+    # A size in bytes, with an optional K, M or G suffix.
+    size = size.strip().upper().rstrip("B")
+    for power, suffix in enumerate("KMG", start=1):
+        if size.endswith(suffix):
+            return int(float(size[:-1]) * 1024**power)
+    return int(size)
+
+
+def cache_max_size():
+    """
+    Returns the size (in bytes) the entries of the cache are bounded to with
+    `TRITON_CACHE_MAX_SIZE` (e.g. `20G`), or None if the cache is unbounded.
+    """
+    size = os.getenv("TRITON_CACHE_MAX_SIZE", "").strip()
+    return _parse_size(size) if size else None
+
+
+@dataclass
+class CacheStats:
+    """
+    The use of the file cache by this process: the lookups of the kernels in
+    the cache, the bytes written to it, the entries evicted from it, and the
+    compile time (in seconds) of the kernels found in it.
+    """
+    hits: int = 0
+    misses: int = 0
+    bytes_written: int = 0
+    evictions: int = 0
+    bytes_evicted: int = 0
+    compile_time_saved: float = 0.0
+
+
+_cache_stats = CacheStats()
+_cache_stats_lock = threading.Lock()
+
+
+def _update_cache_stats(**deltas):
+    with _cache_stats_lock:
+        for name, delta in deltas.items():
+            setattr(_cache_stats, name, getattr(_cache_stats, name) + delta)
+
+
+def get_cache_stats(with_size=False) -> Dict[str, float]:
+    """
+    Returns the `CacheStats` of this process as a dict, with the current size
+    (in bytes) of the cache shared by all the processes as `size` if
+    `with_size` is set, which walks the whole cache directory.
+    """
+    with _cache_stats_lock:
+        stats = asdict(_cache_stats)
+    if with_size:
+        cache_dir = os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
+        stats["size"] = sum(entry.size for entry in _scan_cache_entries(cache_dir))
+    return stats
+
+
+def record_kernel_lookup(metadata):
+    """
+    Records the lookup of a kernel in the cache, which missed if `metadata` is
+    None, and saved the compile times of its `metadata` otherwise.
+    """
+    if metadata is None:
+        _update_cache_stats(misses=1)
+        return
+    compile_times = metadata.get("compile_times", {})
+    saved = sum(t for stage, t in compile_times.items() if stage != "load_binary")
+    _update_cache_stats(hits=1, compile_time_saved=saved)
+
+
+def reset_cache_stats():
+    global _cache_stats
+    with _cache_stats_lock:
+        _cache_stats = CacheStats()
+
+
+# Each hit appends a byte to this file of the entry, with a single write which
+# is atomic across processes: its size counts the uses of the entry and its
+# modification time is the last use.
+_USES_FILENAME = "__uses__"
+_MAX_USES = 1 << 16
+
+
+@dataclass
+class _CacheEntry:
+    path: str
+    size: int
+    last_use: float
+    uses: int
+
+
+def _scan_cache_entries(cache_dir):
+    entries = []
+    try:
+        dirs = list(os.scandir(cache_dir))
+    except FileNotFoundError:
+        return entries
+    for d in dirs:
+        if not d.is_dir(follow_symlinks=False) or d.name.startswith("tmp."):
+            continue
+        size, last_use, uses = 0, None, 0
+        try:
+            for f in os.scandir(d.path):
+                st = f.stat(follow_symlinks=False)
+                size += st.st_size
+                if f.name == _USES_FILENAME:
+                    last_use, uses = st.st_mtime, st.st_size
+            if last_use is None:
+                last_use = d.stat(follow_symlinks=False).st_mtime
+        except FileNotFoundError:
+            # Evicted by another process.
+            continue
+        entries.append(_CacheEntry(d.path, size, last_use, uses))
+    return entries
+
+
+# The bytes written to the cache by this process since the last eviction.
+_bytes_since_eviction = None
+
+
+def _evict_cache_entries(cache_dir, max_size, keep):
+    """
+    Evicts the least recently used entries of the cache at `cache_dir`, or the
+    least frequently used ones with `TRITON_CACHE_EVICTION=lfu`, until their
+    size is below 90% of `max_size`. The entry `keep`, being written, is kept.
+    """
+    try:
+        import fcntl
+    except ImportError:
+        return
+    os.makedirs(cache_dir, exist_ok=True)
+    with open(os.path.join(cache_dir, "evict.lock"), "a") as lock:
+        # Another process is already evicting.
+        try:
+            fcntl.flock(lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except BlockingIOError:
+            return
+        entries = _scan_cache_entries(cache_dir)
+        size = sum(entry.size for entry in entries)
+        if size <= max_size:
+            return
+        if os.getenv("TRITON_CACHE_EVICTION", "lru").strip().lower() == "lfu":
+            entries.sort(key=lambda entry: (entry.uses, entry.last_use))
+        else:
+            entries.sort(key=lambda entry: entry.last_use)
+        target = max_size * 9 // 10
+        for entry in entries:
+            if size <= target:
+                break
+            if entry.path == keep:
+                continue
+            # The rename is atomic: the other processes either find the whole
+            # entry or miss it.
+            evicted = os.path.join(cache_dir, f"tmp.evict_{uuid.uuid4()}")
+            try:
+                os.rename(entry.path, evicted)
+            except OSError:
+                continue
+            shutil.rmtree(evicted, ignore_errors=True)
+            size -= entry.size
+            _update_cache_stats(evictions=1, bytes_evicted=entry.size)
+
+
 class CacheManager(ABC):
 
     def __init__(self, key):
@@ -52,6 +280,8 @@ class FileCacheManager(CacheManager):
     def __init__(self, key, override=False, dump=False):
         self.key = key
         self.lock_path = None
+        # Only the entries of the cache are bounded by `TRITON_CACHE_MAX_SIZE`.
+        self.bounded = not dump and not override
         if dump:
             self.cache_dir = os.getenv("TRITON_DUMP_DIR", "").strip() or default_dump_dir()
             self.cache_dir = os.path.join(self.cache_dir, self.key)
@@ -99,15 +329,51 @@ class FileCacheManager(CacheManager):
         for c, p in child_paths.items():
             if os.path.exists(p):
                 result[c] = p
+        if self.bounded:
+            self._record_use()
         return result
 
+    def _record_use(self):
+        if cache_max_size() is None:
+            return
+        uses_path = self._make_path(_USES_FILENAME)
+        try:
+            if os.path.getsize(uses_path) >= _MAX_USES:
+                os.utime(uses_path)
+                return
+        except FileNotFoundError:
+            pass
+        try:
+            fd = os.open(uses_path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+        except FileNotFoundError:
+            # Evicted by another process.
+            return
+        try:
+            os.write(fd, b"\0")
+        finally:
+            os.close(fd)
+
     # Note a group of pushed files as being part of a group
     def put_group(self, filename: str, group: Dict[str, str]) -> str:
         if not self.cache_dir:
             raise RuntimeError("Could not create or locate cache dir")
         grp_contents = json.dumps({"child_paths": group})
         grp_filename = f"__grp__{filename}"
-        return self.put(grp_contents, grp_filename, binary=False)
+        filepath = self.put(grp_contents, grp_filename, binary=False)
+        self._maybe_evict()
+        return filepath
+
+    def _maybe_evict(self):
+        global _bytes_since_eviction
+        max_size = cache_max_size()
+        if max_size is None or not self.bounded:
+            return
+        # Walking the cache on each compilation would be slow for large caches:
+        # it is only walked once a 16th of its size was written since.
+        if _bytes_since_eviction is not None and _bytes_since_eviction < max_size // 16:
+            return
+        _bytes_since_eviction = 0
+        _evict_cache_entries(os.path.dirname(self.cache_dir), max_size, keep=self.cache_dir)
 
     def put(self, data, filename, binary=True) -> str:
         if not self.cache_dir:
@@ -129,6 +395,11 @@ class FileCacheManager(CacheManager):
         mode = "wb" if binary else "w"
         with open(temp_path, mode) as f:
             f.write(data)
+        size = os.path.getsize(temp_path)
+        _update_cache_stats(bytes_written=size)
+        global _bytes_since_eviction
+        if _bytes_since_eviction is not None:
+            _bytes_since_eviction += size
         # Replace is guaranteed to be atomic on POSIX systems if it succeeds
         # so filepath cannot see a partial write
         os.replace(temp_path, filepath)
@@ -175,6 +446,38 @@ class RedisRemoteCacheBackend(RemoteCacheBackend):
         self._redis.set(self._get_key(filename), data)
 
 
+class FileSystemRemoteCacheBackend(RemoteCacheBackend):
+    """
+    A remote cache backend storing the entries in a directory shared by several
+    nodes (e.g. on NFS), pointed to by `TRITON_REMOTE_CACHE_DIR`.
+    """
+
+    def __init__(self, key):
+        remote_cache_dir = os.environ.get("TRITON_REMOTE_CACHE_DIR", "").strip()
+        if not remote_cache_dir:
+            raise RuntimeError("TRITON_REMOTE_CACHE_DIR must be set to use the file system remote cache backend")
+        self._cache_dir = os.path.join(remote_cache_dir, key)
+        os.makedirs(self._cache_dir, exist_ok=True)
+
+    def get(self, filenames: List[str]) -> Dict[str, bytes]:
+        results = {}
+        for filename in filenames:
+            try:
+                with open(os.path.join(self._cache_dir, filename), "rb") as f:
+                    results[filename] = f.read()
+            except FileNotFoundError:
+                pass
+        return results
+
+    def put(self, filename: str, data: bytes):
+        # Write to a temporary file in the same directory so that the final
+        # rename is atomic and other nodes never read a partial entry.
+        temp_path = os.path.join(self._cache_dir, f"tmp.pid_{os.getpid()}_{uuid.uuid4()}_{filename}")
+        with open(temp_path, "wb") as f:
+            f.write(data)
+        os.replace(temp_path, os.path.join(self._cache_dir, filename))
+
+
 class RemoteCacheManager(CacheManager):
 
     def __init__(self, key, override=False, dump=False):
@@ -0,0 +1,268 @@
+import hashlib
+import importlib.util
+import re
+
+from .cache import get_cache_manager
+from .jit import JITFunction, jit
+
+# Operations of a kernel that only computes elementwise on the values it loads.
+_ELEMENTWISE_OPS = {
+    "tt.func", "tt.return", "tt.get_program_id", "tt.make_range", "tt.splat", "tt.addptr", "tt.load", "tt.store",
+    "tt.fp_to_fp", "tt.bitcast", "tt.precise_sqrt", "tt.precise_divf", "tt.clampf", "tt.mulhiui",
+    "tt.extern_elementwise"
+}
+_TTIR_OP = re.compile(r"^(?:(%\w+) = )?([a-z_]+\.[\w.]+)(.*)$")
+# The launch options the fused kernel inherits from the chain.
+_LAUNCH_OPTIONS = ("num_warps", "num_ctas", "threads_per_warp")
+
+
+def elementwise_block_size(ttir):
+    """
+    Returns `BLOCK` if the kernel of `ttir` is elementwise: it only loads and
+    stores `ptr + pid * BLOCK + tl.arange(0, BLOCK)` of its pointer arguments,
+    `pid` being the program id along the first axis, and only computes
+    elementwise on the loaded values. Returns `None` otherwise.
+    """
+    defs = {}
+    pointers = []
+    for line in ttir.splitlines():
+        line = line.split(" loc(")[0].strip()
+        if not line or line[0] in "#}" or line.startswith("module"):
+            continue
+        match = _TTIR_OP.match(line)
+        if match is None:
+            # Generic operations, blocks and multiple results.
+            return None
+        result, op, rest = match.groups()
+        if op not in _ELEMENTWISE_OPS and not op.startswith(("arith.", "math.")):
+            return None
+        operands = re.findall(r"%\w+", rest.split(" : ")[0])
+        if result is not None:
+            defs[result] = (op, operands, rest)
+        if op in ("tt.load", "tt.store"):
+            pointers.append(operands[0])
+
+    def get(value):
+        return defs.get(value, (None, [], ""))
+
+    def get_constant(value):
+        op, _, rest = get(value)
+        match = re.match(r"^ (-?\d+) : i\d+$", rest)
+        return int(match.group(1)) if op == "arith.constant" and match else None
+
+    def get_block_size(offsets):
+        # pid * BLOCK + tl.arange(0, BLOCK)
+        op, operands, _ = get(offsets)
+        if op != "arith.addi":
+            return None
+        for rng, base in (operands, reversed(operands)):
+            op, _, rest = get(rng)
+            match = re.search(r"end = (\d+) : i32, start = 0 : i32", rest)
+            if op != "tt.make_range" or match is None:
+                continue
+            block = int(match.group(1))
+            op, operands, _ = get(base)
+            if op != "tt.splat" or get(operands[0])[0] != "arith.muli":
+                continue
+            factors = get(operands[0])[1]
+            for pid, size in (factors, reversed(factors)):
+                op, _, rest = get(pid)
+                if op == "tt.get_program_id" and rest.startswith(" x :") and get_constant(size) == block:
+                    return block
+        return None
+
+    blocks = set()
+    for ptr in pointers:
+        op, operands, _ = get(ptr)
+        if op != "tt.addptr" or get(operands[0])[0] != "tt.splat" or not get(operands[0])[1][0].startswith("%arg"):
+            return None
+        blocks.add(get_block_size(operands[1]))
+    return blocks.pop() if len(blocks) == 1 else None
+
+
+def _extent(tensor):
+    """Returns the range of addresses accessed through the tensor, or `None`."""
+    if not all(hasattr(tensor, attr) for attr in ("shape", "stride", "element_size")):
+        return None
+    start = tensor.data_ptr()
+    span = 1 + sum((size - 1) * stride for size, stride in zip(tensor.shape, tensor.stride()))
+    return start, start + (span if all(tensor.shape) else 0) * tensor.element_size()
+
+
+class _Launch(object):
+
+    def __init__(self, fn, kernel, grid, stream, args, non_constexpr_vals):
+        self.fn = fn
+        self.kernel = kernel
+        self.grid = grid
+        self.stream = stream
+        self.args = args
+        self.non_constexpr_vals = non_constexpr_vals
+
+    def options(self):
+        return tuple(getattr(self.kernel.metadata, name, None) for name in _LAUNCH_OPTIONS)
+
+    def run(self):
+        self.kernel[self.grid](*self.non_constexpr_vals, stream=self.stream)
+
+
+def _bind_chain(launches):
+    """
+    Returns the key of the chain of launches, which determines the fused
+    kernel, and the pointer, scalar and constexpr arguments of the fused
+    kernel. The tensors are deduplicated by address.
+    """
+    key = []
+    ptrs, scalars, constexprs = {}, [], {}
+    for i, launch in enumerate(launches):
+        params = []
+        for param in launch.fn.params:
+            value = launch.args[param.name]
+            if param.is_constexpr:
+                constexprs[f"k{i}_{param.name}"] = value
+                params.append(("constexpr", value))
+            elif hasattr(value, "data_ptr"):
+                params.append(("ptr", ptrs.setdefault((value.data_ptr(), str(value.dtype)), (len(ptrs), value))[0]))
+            else:
+                scalars.append(value)
+                params.append(("scalar", type(value)))
+        key.append((launch.fn, tuple(params)))
+    return key, [value for _, value in ptrs.values()], scalars, constexprs
+
+
+def _fused_source(name, launches):
+    key, ptrs, scalars, constexprs = _bind_chain(launches)
+    params = [f"ptr{i}" for i in range(len(ptrs))] + [f"arg{i}" for i in range(len(scalars))]
+    params += [f"{cst}: tl.constexpr" for cst in constexprs]
+    lines = ["import triton.language as tl", "", "", f"def {name}({', '.join(params)}):"]
+    num_scalars = 0
+    for i, (_, kernel_params) in enumerate(key):
+        args = []
+        for param, (kind, value) in zip(launches[i].fn.params, kernel_params):
+            if kind == "ptr":
+                args.append(f"ptr{value}")
+            elif kind == "scalar":
+                args.append(f"arg{num_scalars}")
+                num_scalars += 1
+            else:
+                args.append(f"k{i}_{param.name}")
+        if i > 0:
+            # The layouts of the kernels may differ, the values stored by a
+            # kernel are loaded by other threads of the program.
+            lines.append("    tl.debug_barrier()")
+        lines.append(f"    _k{i}({', '.join(args)})")
+    return "\n".join(lines) + "\n"
+
+
+class FusedLaunch(object):
+    """
+    Fuses a chain of elementwise kernels launched back to back on the same
+    stream into a single kernel, which saves the launches and lets each
+    program reload the intermediate tensors it stored from the cache.
+
+        fused = triton.runtime.fusion.FusedLaunch()
+        for x in inputs:
+            with fused:
+                add_kernel[grid](x, y, tmp, n, BLOCK=1024)
+                relu_kernel[grid](tmp, out, n, BLOCK=1024)
+
+    The launches of the first iteration run as usual and are recorded. They
+    can be fused if they have the same one-dimensional grid and launch
+    options, each kernel is elementwise (see `elementwise_block_size`) with
+    the same `BLOCK`, and the tensors with different addresses do not
+    overlap: each program then only loads the elements of the intermediate
+    tensors that the same program stored. The launches of the later
+    iterations are deferred to the end of the block and replaced by a launch
+    of the fused kernel, as long as they follow the same chain, otherwise
+    they are launched one by one and recorded again. The outputs of the
+    kernels must therefore not be read on the host within the block.
+    """
+
+    def __init__(self):
+        self._key = None
+        self._fused = None
+        self._options = None
+        self._launches = []
+        # Block sizes of the compiled kernels, `None` if not elementwise.
+        self._blocks = {}
+        self.num_fused_launches = 0
+
+    @property
+    def is_fused(self):
+        return self._fused is not None
+
+    def __enter__(self):
+        if JITFunction.launch_recorder is not None:
+            raise RuntimeError("FusedLaunch blocks cannot be nested")
+        self._launches = []
+        JITFunction.launch_recorder = self._record
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        JITFunction.launch_recorder = None
+        launches, self._launches = self._launches, []
+        if not self.is_fused:
+            if exc_type is None:
+                self._fuse(launches)
+            return
+        if exc_type is None and self._matches(launches):
+            _, ptrs, scalars, constexprs = _bind_chain(launches)
+            self._fused[launches[0].grid](*ptrs, *scalars, **constexprs, **self._options)
+            self.num_fused_launches += 1
+            return
+        for launch in launches:
+            launch.run()
+        self._key = self._fused = None
+        if exc_type is None:
+            self._fuse(launches)
+
+    def _record(self, fn, kernel, grid, stream, args, non_constexpr_vals):
+        self._launches.append(_Launch(fn, kernel, grid, stream, dict(args), tuple(non_constexpr_vals)))
+        # The launches are deferred once the chain is fused.
+        return self.is_fused
+
+    def _is_fusable(self, launches):
+        if len(launches) < 2 or launches[0].grid[1:] != (1, 1):
+            return False
+        first = launches[0]
+        if any(launch.grid != first.grid or launch.stream != first.stream or launch.options() != first.options()
+               for launch in launches):
+            return False
+        for launch in launches:
+            if launch.kernel not in self._blocks:
+                self._blocks[launch.kernel] = elementwise_block_size(launch.kernel.asm["ttir"])
+        blocks = {self._blocks[launch.kernel] for launch in launches}
+        if len(blocks) != 1 or None in blocks:
+            return False
+        extents = []
+        for tensor in _bind_chain(launches)[1]:
+            extent = _extent(tensor)
+            if extent is None:
+                return False
+            extents.append(extent)
+        extents.sort()
+        return all(end <= start for (_, end), (start, _) in zip(extents, extents[1:]))
+
+    def _matches(self, launches):
+        return len(launches) > 0 and _bind_chain(launches)[0] == self._key and self._is_fusable(launches)
+
+    def _fuse(self, launches):
+        if not self._is_fusable(launches):
+            return
+        name = "fused_" + "_".join(launch.fn.__name__ for launch in launches)
+        src = _fused_source(name, launches)
+        kernels = {f"_k{i}": launch.fn for i, launch in enumerate(launches)}
+        cache_key = hashlib.sha256((src + "".join(fn.cache_key for fn in kernels.values())).encode()).hexdigest()
+        path = get_cache_manager(cache_key).put(src, f"{name}.py", binary=False)
+        # The fused kernel needs a source file, which `JITFunction` parses.
+        spec = importlib.util.spec_from_file_location(name, path)
+        module = importlib.util.module_from_spec(spec)
+        module.__dict__.update(kernels)
+        spec.loader.exec_module(module)
+        self._key = _bind_chain(launches)[0]
+        self._fused = jit(getattr(module, name))
+        self._options = {
+            option: value
+            for option, value in zip(_LAUNCH_OPTIONS, launches[0].options())
+            if value is not None
+        }
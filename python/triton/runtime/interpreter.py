@@ -1,6 +1,11 @@
 import ast
+import itertools
+import os
 import textwrap
+import threading
 import inspect
+import multiprocessing
+from concurrent.futures import ProcessPoolExecutor, ThreadPoolExecutor
 from typing import Tuple
 
 import math
@@ -242,6 +247,16 @@ class InterpreterBuilder:
         self.codegen_fns = {}
         self.codegen_fns["convert_custom_types"] = ExtraFunctions._convert_custom_types
         self.codegen_fns["min_dot_size"] = lambda lhsType, rhsType: (16, 16, 16)
+        # The program instances of a grid may run on several threads
+        self._local = threading.local()
+
+    @property
+    def grid_idx(self):
+        return getattr(self._local, "grid_idx", None)
+
+    @grid_idx.setter
+    def grid_idx(self, grid_idx):
+        self._local.grid_idx = grid_idx
 
     def set_grid_idx(self, x, y, z):
         if not x < self.grid_dim[0]:
@@ -1037,6 +1052,34 @@ interpreter_builder = InterpreterBuilder()
 RESERVED_KWS = ["num_warps", "num_stages", "num_ctas", "enable_fp_fusion", "grid", "maxnreg"]
 
 
+def _get_num_threads():
+    # The program instances are independent, except through atomics which the interpreter
+    # implements with native atomics, so they can run concurrently
+    return max(int(os.getenv("TRITON_INTERPRET_NUM_THREADS", "1")), 1)
+
+
+def _get_num_processes():
+    # The program instances run by forked processes don't contend for the GIL. The tensors are moved to shared memory
+    # and the atomics are native atomics on it, so that the instances see each other's stores as on the device
+    return max(int(os.getenv("TRITON_INTERPRET_NUM_PROCESSES", "1")), 1)
+
+
+# The program, arguments and grid run by the processes forked by `GridExecutor._run_programs_in_processes`
+_process_grid = None
+
+
+def _run_program_range(start, stop):
+    fn, args, grid = _process_grid
+    try:
+        for index in range(start, stop):
+            x, yz = divmod(index, grid[1] * grid[2])
+            interpreter_builder.set_grid_idx(x, *divmod(yz, grid[2]))
+            fn(**args)
+    except Exception as e:
+        # The exceptions of the program instances may not be picklable
+        raise RuntimeError(repr(e)) from None
+
+
 class GridExecutor:
 
     def __init__(self, fn, arg_names, grid):
@@ -1075,6 +1118,33 @@ class GridExecutor:
             if hasattr(kwarg_dev, "data_ptr"):
                 kwarg_dev.data.copy_(kwarg_hst.to(kwarg_dev.device).data)
 
+    def _run_programs_in_parallel(self, args, grid, num_threads):
+
+        def run_program(grid_idx):
+            interpreter_builder.set_grid_idx(*grid_idx)
+            self.fn(**args)
+
+        grid_indices = itertools.product(range(grid[0]), range(grid[1]), range(grid[2]))
+        with ThreadPoolExecutor(max_workers=num_threads) as executor:
+            # Raises the first exception of the program instances
+            for _ in executor.map(run_program, grid_indices):
+                pass
+
+    def _run_programs_in_processes(self, args, grid, num_processes):
+        global _process_grid
+        num_programs = grid[0] * grid[1] * grid[2]
+        # Each process runs a contiguous range of program instances
+        bounds = [num_programs * i // num_processes for i in range(num_processes + 1)]
+        _process_grid = (self.fn, args, grid)
+        try:
+            context = multiprocessing.get_context("fork")
+            with ProcessPoolExecutor(max_workers=num_processes, mp_context=context) as executor:
+                # Raises the first exception of the program instances
+                for _ in executor.map(_run_program_range, bounds[:-1], bounds[1:]):
+                    pass
+        finally:
+            _process_grid = None
+
     def __call__(self, *args_dev, **kwargs):
         # removes reserved keywords from kwargs
         kwargs = {k: v for k, v in kwargs.items() if k not in RESERVED_KWS}
@@ -1082,6 +1152,12 @@ class GridExecutor:
             return
         # copy arguments to the host
         args_hst, kwargs_hst = self._init_args_hst(args_dev, kwargs)
+        num_processes = _get_num_processes()
+        if num_processes > 1:
+            # The processes store to the host tensors in place
+            for arg in itertools.chain(args_hst, kwargs_hst.values()):
+                if hasattr(arg, "share_memory_"):
+                    arg.share_memory_()
         # remaps core language functions to interpreted ones
         _patch_lang(self.fn)
         # we need to copy arguments to the host for the interpreter
@@ -1093,12 +1169,19 @@ class GridExecutor:
         assert len(grid) <= 3, "grid must have at most 3 dimensions"
         grid = grid + (1, ) * (3 - len(grid))
         interpreter_builder.set_grid_dim(*grid)
+        num_processes = min(num_processes, grid[0] * grid[1] * grid[2])
+        num_threads = min(_get_num_threads(), grid[0] * grid[1] * grid[2])
         try:
-            for x in range(grid[0]):
-                for y in range(grid[1]):
-                    for z in range(grid[2]):
-                        interpreter_builder.set_grid_idx(x, y, z)
-                        self.fn(**args)
+            if num_processes > 1:
+                self._run_programs_in_processes(args, grid, num_processes)
+            elif num_threads > 1:
+                self._run_programs_in_parallel(args, grid, num_threads)
+            else:
+                for x in range(grid[0]):
+                    for y in range(grid[1]):
+                        for z in range(grid[2]):
+                            interpreter_builder.set_grid_idx(x, y, z)
+                            self.fn(**args)
         except Exception as e:
             raise InterpreterError(repr(e)) from e
         # copy arguments back to propagate side-effects
@@ -1,5 +1,6 @@
 from __future__ import annotations, division
 import ast
+import bisect
 import hashlib
 import inspect
 import itertools
@@ -275,14 +276,31 @@ class KernelParam:
         return self._param.default != inspect.Parameter.empty
 
 
+def has_pointer_range_32(v):
+    """
+    Whether the storage of the tensor `v` is smaller than 2GB, so that the
+    offsets (in bytes) of the pointers to it fit in 32 bits.
+    """
+    storage = getattr(v, "untyped_storage", None)
+    return storage is not None and storage().nbytes() < 2**31
+
+
 def compute_spec_key(v, align):
 
-    if align and hasattr(v, "data_ptr") and (v.data_ptr() % 16 == 0):
-        return "D"
+    if hasattr(v, "data_ptr"):
+        key = "N"
+        if align:
+            # 2D block loads need 64-byte aligned base addresses.
+            ptr = v.data_ptr()
+            key = "A" if ptr % 64 == 0 else "D" if ptr % 16 == 0 else "N"
+        return key + "S" if has_pointer_range_32(v) else key
     elif isinstance(v, int):
         # bool is a subclass of int, so we don't check explicitly above.
         if align and (v % 16 == 0):
             return "D"
+        # 2D block loads of 16-bit elements need pitches multiple of 16 bytes.
+        elif align and (v % 8 == 0):
+            return "E"
         elif v == 1:
             return "1"
     return "N"
@@ -445,6 +463,8 @@ class JITFunction(KernelInterface[T]):
     # Hook to signal that a kernel is done compiling and inspect compiled function.
     # cache_hook will always be called before compilation and compiled_hook after.
     compiled_hook = None
+    # Hook recording the launches, which skips a launch if it returns True.
+    launch_recorder = None
     divisibility = 16
 
     @staticmethod
@@ -497,9 +517,28 @@ class JITFunction(KernelInterface[T]):
             for param, arg in zip(self.params, args)
             if isinstance(arg, int) and not isinstance(arg, bool) and arg == 1 and not param.do_not_specialize
         }
+        pointer_range_32 = {
+            param.num
+            for param, arg in zip(self.params, args)
+            if hasattr(arg, "data_ptr") and has_pointer_range_32(arg) and not param.do_not_specialize
+        }
+        # The alignment and pitch constraints of the 2D block loads.
+        divisible_by_64 = {
+            param.num
+            for param, arg in zip(self.params, args)
+            if hasattr(arg, "data_ptr") and arg.data_ptr() % 64 == 0 and not param.do_not_specialize
+            and not param.do_not_specialize_on_alignment
+        }
+        divisible_by_8 = {
+            param.num
+            for param, arg in zip(self.params, args)
+            if isinstance(arg, int) and arg % 8 == 0 and not param.do_not_specialize
+            and not param.do_not_specialize_on_alignment
+        }
         # folded equal_to_1 and None
         # TODO: method to collect all folded args
-        return AttrsDescriptor(tuple(divisible_by_16), tuple(equal_to_1))
+        return AttrsDescriptor(tuple(divisible_by_16), tuple(equal_to_1), tuple(pointer_range_32),
+                               tuple(divisible_by_64), tuple(divisible_by_8))
         # return _triton.code_gen.instance_descriptor(divisible_by_16,
         # equal_to_1)
 
@@ -591,6 +630,10 @@ class JITFunction(KernelInterface[T]):
         self.ASTSource = ASTSource
         self.make_backend = make_backend
         self.binder = create_function_from_signature(self.signature, self.params)
+        from .._C.libtriton import specialize
+        self.native_binder = specialize.Binder([(p.name, p.has_default, p.default, p.is_constexpr,
+                                                 not p.do_not_specialize, not p.do_not_specialize_on_alignment,
+                                                 p.is_const, p.annotation_type) for p in self.params], mangle_type)
         self.constexpr_indices = [i for (i, p) in enumerate(self.params) if p.is_constexpr]
         self.non_constexpr_indices = [i for (i, p) in enumerate(self.params) if not p.is_constexpr]
         self.specialised_indices = [
@@ -610,11 +653,26 @@ class JITFunction(KernelInterface[T]):
         if self.binder is None:
             self.create_binder()
 
-        bound_args, sig_and_spec, constexpr_vals, non_constexpr_vals, excess_kwargs = self.binder(*args, **kwargs)
+        if self.buckets:
+            buckets = self._get_buckets(args, kwargs)
 
-        # compute cache key
-        key = ''.join(sig_and_spec) + str((constexpr_vals, excess_kwargs))
-        kernel = self.cache[device].get(key, None)
+        # The native binder computes the cache key and looks up the kernel in
+        # one call. The Python binder handles the misses and the calls it
+        # cannot bind, e.g. to raise the appropriate error.
+        bound = self.native_binder.bind(self.cache[device], args, kwargs, str(buckets) if self.buckets else "")
+        kernel = None
+        if bound is not None:
+            kernel, key, bound_args, non_constexpr_vals = bound
+        if kernel is None:
+            bound_args, sig_and_spec, constexpr_vals, non_constexpr_vals, excess_kwargs = self.binder(*args, **kwargs)
+
+            # compute cache key
+            key = ''.join(sig_and_spec) + str((constexpr_vals, excess_kwargs))
+            if self.buckets:
+                key += str(buckets)
+            kernel = self.cache[device].get(key, None)
+        if self.buckets:
+            self.cache_stats[buckets]["misses" if kernel is None else "hits"] += 1
 
         if kernel is None:
             # Kernel is not cached; we have to compile.
@@ -682,14 +740,44 @@ class JITFunction(KernelInterface[T]):
             grid_1 = grid[1] if grid_size > 1 else 1
             grid_2 = grid[2] if grid_size > 2 else 1
 
-            # launch kernel
+            # launches within a `triton.runtime.fusion.FusedLaunch` block are
+            # recorded, and deferred once they are fused
+            if JITFunction.launch_recorder is not None and JITFunction.launch_recorder(
+                    self, kernel, (grid_0, grid_1, grid_2), stream, bound_args, non_constexpr_vals):
+                return kernel
+
+            # launch kernel, without building the launch metadata unless a
+            # launch hook is set
+            if kernel.launcher_hooks_version != self.CompiledKernel.launch_hooks_version:
+                kernel.update_launcher()
+            if kernel.launcher is not None:
+                kernel.launcher(grid_0, grid_1, grid_2, stream, *non_constexpr_vals)
+                return kernel
             launch_metadata = kernel.launch_metadata(grid, stream, *non_constexpr_vals)
             kernel.run(grid_0, grid_1, grid_2, stream, kernel.function, kernel.packed_metadata, launch_metadata,
                        self.CompiledKernel.launch_enter_hook, self.CompiledKernel.launch_exit_hook, *non_constexpr_vals)
         return kernel
 
+    def _get_buckets(self, args, kwargs):
+        """
+        Returns the index of the bucket of each bucketed argument, and passes
+        the upper boundary of the bucket to the `<arg>_BUCKET` constexpr
+        parameter of the kernel, if any.
+        """
+        buckets = []
+        for name, boundaries in self.buckets.items():
+            param = self.params[self.arg_names.index(name)]
+            value = args[param.num] if param.num < len(args) else kwargs.get(name, param.default)
+            bucket = bisect.bisect_left(boundaries, value)
+            buckets.append(bucket)
+            bound_name = f"{name}_BUCKET"
+            if bound_name in self.arg_names and bound_name not in kwargs and self.arg_names.index(bound_name) >= len(
+                    args):
+                kwargs[bound_name] = boundaries[bucket] if bucket < len(boundaries) else None
+        return tuple(buckets)
+
     def __init__(self, fn, version=None, do_not_specialize=None, do_not_specialize_on_alignment=None, debug=None,
-                 noinline=None, repr=None, launch_metadata=None):
+                 noinline=None, repr=None, launch_metadata=None, buckets=None):
         do_not_specialize = do_not_specialize if do_not_specialize else []
         do_not_specialize_on_alignment = do_not_specialize_on_alignment if do_not_specialize_on_alignment else []
 
@@ -702,12 +790,20 @@ class JITFunction(KernelInterface[T]):
         self.starting_line_number = inspect.getsourcelines(fn)[1]
         self.repr = lambda _: fn.__name__ if repr is None else repr(_)
         self.launch_metadata = launch_metadata
+        # Boundaries of the buckets of the dynamic integer arguments.
+        self.buckets = {name: tuple(sorted(boundaries)) for name, boundaries in (buckets or {}).items()}
+        for name in self.buckets:
+            if name not in self.signature.parameters:
+                raise ValueError(f"Bucketed argument {name} is not a parameter of {fn.__name__}")
+        # Number of kernel cache hits and misses of each combination of buckets.
+        self.cache_stats = defaultdict(lambda: {"hits": 0, "misses": 0})
 
         self.binder = None
 
         self.params = []
         for i, param in enumerate(self.signature.parameters.values()):
-            dns = i in do_not_specialize or param.name in do_not_specialize
+            # A kernel is compiled per bucket instead of per specialization.
+            dns = i in do_not_specialize or param.name in do_not_specialize or param.name in self.buckets
             dns_oa = i in do_not_specialize_on_alignment or param.name in do_not_specialize_on_alignment
             self.params.append(KernelParam(i, param, dns, dns_oa))
 
@@ -830,6 +926,7 @@ def jit(
     do_not_specialize_on_alignment: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    buckets: Optional[Dict[str, Iterable[int]]] = None,
 ) -> Callable[[T], JITFunction[T]]:
     ...
 
@@ -844,6 +941,7 @@ def jit(
     do_not_specialize_on_alignment: Optional[Iterable[int]] = None,
     debug: Optional[bool] = None,
     noinline: Optional[bool] = None,
+    buckets: Optional[Dict[str, Iterable[int]]] = None,
 ) -> Union[JITFunction[T], Callable[[T], JITFunction[T]]]:
     """
     Decorator for JIT-compiling a function using the Triton compiler.
@@ -861,6 +959,16 @@ def jit(
 
     :param fn: the function to be jit-compiled
     :type fn: Callable
+    :param buckets: a dict mapping the names of dynamic integer arguments (e.g.
+        sequence lengths) to sorted bucket boundaries. These arguments are not
+        specialized: one kernel is compiled per bucket, a value `v` falling in
+        the first bucket whose boundary `b` satisfies `v <= b` (or in a last
+        unbounded bucket), and the kernel masks with the runtime value. The
+        boundary is passed to the `<arg>_BUCKET` constexpr parameter if the
+        kernel has one, e.g. `seq_len_BUCKET: tl.constexpr = None` (`None` for
+        the unbounded bucket). The kernel cache hits and misses of each
+        combination of bucket indices are counted in `cache_stats`.
+    :type buckets: dict[str, list[int]], optional
     """
 
     def decorator(fn: T) -> JITFunction[T]:
@@ -880,6 +988,7 @@ def jit(
                 noinline=noinline,
                 repr=repr,
                 launch_metadata=launch_metadata,
+                buckets=buckets,
             )
 
     if fn is not None:
@@ -0,0 +1,126 @@
+"""
+Persistent database of the configs selected by the autotuner, shared by the
+processes tuning the same kernels.
+
+Set `TRITON_AUTOTUNE_DB=<path>` to store the best config of every tuned key in
+the SQLite database at `path`. An autotuned kernel starts from the configs the
+database holds for its source and the current target, and only benchmarks the
+keys missing from it. SQLite locks the database, so concurrent processes can
+tune and write to it.
+
+The records are exported to and imported from JSON lines with:
+
+    python -m triton.runtime.tuning_db export <db> <file>
+    python -m triton.runtime.tuning_db import <db> <file>
+"""
+
+import argparse
+import json
+import sqlite3
+from contextlib import closing
+from pathlib import Path
+
+from .autotuner import Config
+
+# Seconds to wait for the lock held by another writer.
+LOCK_TIMEOUT = 60
+
+_SCHEMA = """
+CREATE TABLE IF NOT EXISTS configs (
+    kernel TEXT NOT NULL,
+    target TEXT NOT NULL,
+    key TEXT NOT NULL,
+    config TEXT NOT NULL,
+    timing REAL,
+    PRIMARY KEY (kernel, target, key)
+)
+"""
+
+_CONFIG_FIELDS = ("num_warps", "num_ctas", "num_stages", "maxnreg")
+
+
+def target_key(target):
+    """Serialize a `GPUTarget` into the key of its records."""
+    return json.dumps([target.backend, target.arch, target.warp_size], sort_keys=True, default=str)
+
+
+def encode_key(key):
+    return json.dumps(list(key), default=str)
+
+
+def decode_key(key):
+    return tuple(json.loads(key))
+
+
+def encode_config(config):
+    fields = {name: getattr(config, name) for name in _CONFIG_FIELDS}
+    return json.dumps({"kwargs": config.kwargs, **fields}, sort_keys=True)
+
+
+def decode_config(config):
+    fields = json.loads(config)
+    return Config(fields.pop("kwargs"), **fields)
+
+
+class TuningDatabase:
+
+    def __init__(self, path):
+        self.path = Path(path)
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        with self._connect() as conn:
+            conn.execute(_SCHEMA)
+
+    def _connect(self):
+        # A connection per operation, as the autotuner may run in several
+        # threads of the process.
+        return closing(sqlite3.connect(self.path, timeout=LOCK_TIMEOUT, isolation_level=None))
+
+    def load(self, kernel, target):
+        """Return the configs stored for `kernel` on `target`, by key."""
+        with self._connect() as conn:
+            rows = conn.execute("SELECT key, config FROM configs WHERE kernel = ? AND target = ?",
+                                (kernel, target_key(target))).fetchall()
+        return {decode_key(key): decode_config(config) for key, config in rows}
+
+    def store(self, kernel, target, key, config, timing=None):
+        """Record `config` as the best config of `kernel` for `key` on `target`."""
+        with self._connect() as conn:
+            conn.execute("INSERT OR REPLACE INTO configs VALUES (?, ?, ?, ?, ?)",
+                         (kernel, target_key(target), encode_key(key), encode_config(config), timing))
+
+    def export_records(self, path):
+        """Write all the records to `path` as JSON lines. Returns the number of records."""
+        with self._connect() as conn:
+            rows = conn.execute("SELECT kernel, target, key, config, timing FROM configs").fetchall()
+        with open(path, "w") as f:
+            for kernel, target, key, config, timing in rows:
+                record = {"kernel": kernel, "target": target, "key": key, "config": config, "timing": timing}
+                f.write(json.dumps(record) + "\n")
+        return len(rows)
+
+    def import_records(self, path):
+        """Add the records of the JSON lines at `path`, replacing the existing ones. Returns the number of records."""
+        records = [json.loads(line) for line in Path(path).read_text().splitlines() if line.strip()]
+        with self._connect() as conn:
+            conn.execute("BEGIN IMMEDIATE")
+            conn.executemany("INSERT OR REPLACE INTO configs VALUES (?, ?, ?, ?, ?)",
+                             [(r["kernel"], r["target"], r["key"], r["config"], r.get("timing")) for r in records])
+            conn.execute("COMMIT")
+        return len(records)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export or import the records of an autotuning database")
+    parser.add_argument("command", choices=("export", "import"))
+    parser.add_argument("db", help="path of the SQLite database (TRITON_AUTOTUNE_DB)")
+    parser.add_argument("file", help="JSON lines file to write or read")
+    args = parser.parse_args()
+    db = TuningDatabase(args.db)
+    if args.command == "export":
+        print(f"Exported {db.export_records(args.file)} records to {args.file}")
+    else:
+        print(f"Imported {db.import_records(args.file)} records from {args.file}")
+
+
+if __name__ == "__main__":
+    main()
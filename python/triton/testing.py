@@ -45,7 +45,40 @@ class WallEvent():
         return end.timestamp - self.timestamp
 
 
+@functools.cache
+def _support_device_timestamps():
+    from triton.runtime import driver
+    utils = driver.active.utils
+    if not hasattr(utils, "supports_profiling_tag"):
+        return False
+    try:
+        return utils.supports_profiling_tag(utils.get_sycl_queue())
+    except RuntimeError:
+        return False
+
+
+class DeviceTimestampEvent():
+    """
+    Device timestamp recorded on the current SYCL queue once all the commands
+    submitted before it completed. Unlike `torch.xpu.Event`, it doesn't need a
+    profiling queue or the profiler.
+    """
+
+    def __init__(self, **kwargs):
+        from triton.runtime import driver
+        self.utils = driver.active.utils
+        self.tag = None
+
+    def record(self):
+        self.tag = self.utils.submit_profiling_tag(self.utils.get_sycl_queue())
+
+    def elapsed_time(self, end):
+        return self.utils.elapsed_time(self.tag, end.tag)
+
+
 def Event(**kwargs):
+    if _support_device_timestamps():
+        return DeviceTimestampEvent(**kwargs)
     if _support_elapsed_time():
         import torch
 
@@ -139,7 +172,7 @@ def do_bench_cudagraph(fn, rep=20, grad_to_none=None, quantiles=None, return_mod
 
 
 def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flush=True, return_mode="mean",
-             device_type="xpu"):
+             device_type="xpu", stop_if_slower_than=None):
     """
     Benchmark the runtime of the provided function. By default, return the median runtime of :code:`fn` along with
     the 20-th and 80-th performance percentile.
@@ -157,6 +190,8 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
     :param fast_flush: Use faster kernel to flush L2 cache between measurements
     :type fast_flush: bool, default is True
     :param return_mode: The statistical measure to return. Options are "min", "max", "mean", "median", or "all" Default is "mean".    :type return_mode: str
+    :param stop_if_slower_than: Stop benchmarking once the median runtime (in ms) of the runs so far exceeds this value.
+    :type stop_if_slower_than: float, optional
     """
     assert return_mode in ["min", "max", "mean", "median", "all"]
     import torch
@@ -200,25 +235,38 @@ def do_bench(fn, warmup=25, rep=100, grad_to_none=None, quantiles=None, fast_flu
     for _ in range(n_warmup):
         fn()
     # Benchmark
-    for i in range(n_repeat):
-        # we don't want `fn` to accumulate gradient values
-        # if it contains a backward pass. So we clear the
-        # provided gradients
-        if grad_to_none is not None:
-            for x in grad_to_none:
-                x.grad = None
-        # we clear the L2 cache before each run
-        cache.zero_()
-        # record time of `fn`
-        start_event[i].record()
-        fn()
-        if USE_WALL_TIME:
+    # With early stopping, the runs are done in chunks and the median runtime is
+    # checked after each of them.
+    chunk_size = n_repeat if stop_if_slower_than is None else max(1, n_repeat // 10)
+    n_runs = 0
+    while n_runs < n_repeat:
+        for i in range(n_runs, min(n_runs + chunk_size, n_repeat)):
+            # we don't want `fn` to accumulate gradient values
+            # if it contains a backward pass. So we clear the
+            # provided gradients
+            if grad_to_none is not None:
+                for x in grad_to_none:
+                    x.grad = None
+            # we clear the L2 cache before each run
+            cache.zero_()
+            # record time of `fn`
+            start_event[i].record()
+            fn()
+            if USE_WALL_TIME:
+                di.synchronize()
+            end_event[i].record()
+        n_runs = min(n_runs + chunk_size, n_repeat)
+        if stop_if_slower_than is not None and n_runs < n_repeat:
             di.synchronize()
-        end_event[i].record()
+            times = torch.tensor([s.elapsed_time(e) for s, e in zip(start_event[:n_runs], end_event[:n_runs])],
+                                 dtype=torch.float)
+            if torch.median(times).item() > stop_if_slower_than:
+                break
     # Record clocks
     if not USE_WALL_TIME:
         di.synchronize()
-    times = torch.tensor([s.elapsed_time(e) for s, e in zip(start_event, end_event)], dtype=torch.float)
+    times = torch.tensor([s.elapsed_time(e) for s, e in zip(start_event[:n_runs], end_event[:n_runs])],
+                         dtype=torch.float)
     return _summarize_statistics(times, quantiles, return_mode)
 
 
@@ -1,21 +1,23 @@
 import binascii
 import hashlib
 import importlib.util
+import subprocess
 import sys
+import tempfile
 from argparse import ArgumentParser
 from pathlib import Path
 from typing import List
 
 import triton
 from triton.compiler.code_generator import kernel_suffix
-from triton.backends.nvidia.driver import ty_to_cpp
 
 desc = """
 Triton ahead-of-time compiler:
 
 This program compiles the kernel with name `kernel-name` in the file at the
 provided `path` into self-contained C source-code that embeds the `cubin`
-data along with utilities to load, unload and launch the kernel.
+data (or, on XPU, the SPIR-V or native device binary) along with utilities to
+load, unload and launch the kernel.
 
 signature is provided as a list of (optionally divisibility-hinted) types
 or constexpr values, e.g.
@@ -30,6 +32,14 @@ The resulting entry point will have signature
 
 CUresult kernel_{specialization_suffix}(CUstream stream, unsigned gX, unsigned gY, unsigned gZ, float* arg0, int32_t arg1, int32_t arg2)
 
+When compiled for XPU, the entry point appends the launch to a Level Zero command list instead:
+
+ze_result_t kernel_{specialization_suffix}(ze_command_list_handle_t cmd_list, float* arg0, int32_t arg1, int32_t arg2)
+
+and the kernel must be loaded with `load_kernel_{specialization_suffix}(context, device)` first. With
+`--ocloc-device`, the SPIR-V is compiled by `ocloc` into a native binary for the given device, so that
+no JIT compilation happens when the kernel is loaded.
+
 Different such specialized entry points can be combined using the `linker.py` script.
 
 NOTE: when resolving the scope of /path/to/kernel.py, the file will be executed from within its parent directory with the python interpreter
@@ -51,6 +61,8 @@ if __name__ == "__main__":
     parser.add_argument("--out-path", "-o", type=Path, default=None, help="Out filename")
     parser.add_argument("--signature", "-s", type=str, help="Signature of the kernel", required=True)
     parser.add_argument("--grid", "-g", type=str, help="Launch grid of the kernel", required=True)
+    parser.add_argument("--ocloc-device", type=str, default=None,
+                        help="XPU only: device (e.g. `pvc`) to compile the kernel to a native binary for")
     args = parser.parse_args()
 
     out_name = args.out_name if args.out_name else args.kernel_name
@@ -105,15 +117,23 @@ if __name__ == "__main__":
 
     # compile ast into cubin
     for h in hints.values():
-        assert h in [1, 16], f"Only 1 and 16 are valid hints, got {h}"
-    divisible_by_16 = [i for i, h in hints.items() if h == 16]
+        assert h in [1, 8, 16, 64], f"Only 1, 8, 16 and 64 are valid hints, got {h}"
+    divisible_by_16 = [i for i, h in hints.items() if h in (16, 64)]
     equal_to_1 = [i for i, h in hints.items() if h == 1]
-    attrs = triton.compiler.AttrsDescriptor(divisible_by_16=divisible_by_16, equal_to_1=equal_to_1)
+    divisible_by_64 = [i for i, h in hints.items() if h == 64]
+    divisible_by_8 = [i for i, h in hints.items() if h in (8, 16, 64)]
+    attrs = triton.compiler.AttrsDescriptor(divisible_by_16=divisible_by_16, equal_to_1=equal_to_1,
+                                            divisible_by_64=divisible_by_64, divisible_by_8=divisible_by_8)
     for i in equal_to_1:
         constants.update({kernel.arg_names[i]: 1})
     src = triton.compiler.ASTSource(fn=kernel, constants=constants, signature=signature, attrs=attrs)
     opts = {"num_warps": args.num_warps, "num_stages": args.num_stages}
     ccinfo = triton.compile(src, options=opts)
+    is_xpu = ccinfo.metadata.target.backend == "xpu"
+    if is_xpu:
+        from triton.backends.intel.driver import ty_to_cpp
+    else:
+        from triton.backends.nvidia.driver import ty_to_cpp
     arg_names = []
     arg_types = []
     arg_names_not_1 = []
@@ -131,7 +151,23 @@ if __name__ == "__main__":
     # dump C stub code
     suffix = kernel_suffix(signature.values(), attrs)
     func_name = '_'.join([out_name, sig_hash, suffix])
-    hex_ = str(binascii.hexlify(ccinfo.asm["cubin"]))[2:-1]
+    if not is_xpu:
+        binary = ccinfo.asm["cubin"]
+    elif args.ocloc_device is None:
+        binary = ccinfo.asm["spv"]
+    else:
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            spv_path = Path(tmp_dir) / "kernel.spv"
+            spv_path.write_bytes(ccinfo.asm["spv"])
+            ocloc_cmd = [
+                "ocloc", "compile", "-spirv_input", "-file", spv_path, "-device", args.ocloc_device, "-output",
+                "kernel", "-output_no_suffix", "-out_dir", tmp_dir
+            ]
+            if ccinfo.metadata.build_flags:
+                ocloc_cmd += ["-options", ccinfo.metadata.build_flags]
+            subprocess.run(ocloc_cmd, check=True, stdout=subprocess.DEVNULL)
+            binary = (Path(tmp_dir) / "kernel.bin").read_bytes()
+    hex_ = str(binascii.hexlify(binary))[2:-1]
     params = {
         "kernel_name": func_name,
         "triton_kernel_name": args.kernel_name,
@@ -150,7 +186,20 @@ if __name__ == "__main__":
         "gridZ": grid[2],
         "_placeholder": "",
     }
+    template_name = "compile"
+    if is_xpu:
+        template_name = "compile_xpu"
+        params["threads_per_warp"] = ccinfo.metadata.threads_per_warp
+        params["bin_format"] = "ZE_MODULE_FORMAT_NATIVE" if args.ocloc_device else "ZE_MODULE_FORMAT_IL_SPIRV"
+        # A native binary is already built with the flags of the kernel.
+        params["build_flags"] = "" if args.ocloc_device else ccinfo.metadata.build_flags
+        # The parameters the kernel never reads were removed from it.
+        kernel_args = [arg for i, arg in enumerate(arg_names_not_1) if i not in ccinfo.metadata.dead_args]
+        params["num_args"] = len(kernel_args)
+        params["set_args"] = "\n".join(
+            f"    ZE_RETURN_IF_ERROR(zeKernelSetArgumentValue({func_name}_func, {i}, sizeof({arg}), &{arg}));"
+            for i, arg in enumerate(kernel_args))
     for ext in ['h', 'c']:
-        template_path = Path(__file__).parent / f"compile.{ext}"
+        template_path = Path(__file__).parent / f"{template_name}.{ext}"
         with out_path.with_suffix(f".{sig_hash}_{suffix}.{ext}").open("w") as fp:
             fp.write(Path(template_path).read_text().format(**params))
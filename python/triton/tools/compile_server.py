@@ -0,0 +1,154 @@
+"""
+Compile server for the kernels compiled remotely (see `triton.compiler.remote`):
+
+    python -m triton.tools.compile_server --host 0.0.0.0 --port 8471
+
+The server compiles the Triton IR the clients send to `POST /compile` with
+`triton.compile`, and caches the stages in its Triton cache, so that each
+kernel is compiled once for all the clients. The concurrent requests of the
+same kernel wait for a single compilation. The native binaries are still
+built by the clients when they load the kernels, on their devices; share
+them with a remote cache (`TRITON_REMOTE_CACHE_BACKEND`).
+
+The server only compiles the requests of clients running the same version of
+Triton with the same cache invalidating environment variables, the others
+are rejected and compile their kernels locally. `GET /stats` returns the
+requests served by the server.
+"""
+
+import argparse
+import base64
+import collections
+import concurrent.futures
+import hashlib
+import json
+import tempfile
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+
+from triton._C.libtriton import get_cache_invalidating_env_vars
+from triton.backends.compiler import GPUTarget
+from triton.compiler.compiler import compile, triton_key
+from triton.runtime.cache import read_cache_entry
+
+
+class RejectedRequest(Exception):
+
+    def __init__(self, code, message):
+        super().__init__(message)
+        self.code = code
+
+
+def _to_tuples(value):
+    # The tuples of the options are sent as JSON arrays.
+    if isinstance(value, list):
+        return tuple(_to_tuples(item) for item in value)
+    return value
+
+
+class CompileServer(ThreadingHTTPServer):
+    """
+    An HTTP server compiling the kernels of the remote clients, with the
+    number of requests, of requests deduplicated with a concurrent one, and
+    of failed compilations in `stats`.
+    """
+
+    daemon_threads = True
+
+    def __init__(self, address, verbose=False):
+        super().__init__(address, CompileRequestHandler)
+        self.verbose = verbose
+        self.stats = collections.Counter()
+        self._lock = threading.Lock()
+        self._pending = {}
+
+    def compile(self, request):
+        key = hashlib.sha256(json.dumps(request, sort_keys=True).encode("utf-8")).hexdigest()
+        with self._lock:
+            self.stats["requests"] += 1
+            future = self._pending.get(key)
+            owner = future is None
+            if owner:
+                future = self._pending[key] = concurrent.futures.Future()
+            else:
+                self.stats["deduplicated"] += 1
+        if not owner:
+            return future.result()
+        try:
+            future.set_result(self._compile(request))
+        except Exception as e:
+            with self._lock:
+                self.stats["failed"] += 1
+            future.set_exception(e)
+        finally:
+            with self._lock:
+                del self._pending[key]
+        return future.result()
+
+    def _compile(self, request):
+        if request["triton_key"] != triton_key():
+            raise RejectedRequest(409, "the server runs another version of Triton")
+        if request["env_vars"] != get_cache_invalidating_env_vars():
+            raise RejectedRequest(409, "the server runs with other cache invalidating environment variables")
+        target = GPUTarget(**request["target"])
+        options = {name: _to_tuples(value) for name, value in request["options"].items()}
+        with tempfile.TemporaryDirectory() as tmp:
+            path = Path(tmp) / f"{request['name']}.{request['ext']}"
+            path.write_text(request["ir"])
+            kernel = compile(str(path), target=target, options=options)
+        files = {
+            ext: base64.b64encode(read_cache_entry(path)).decode("ascii")
+            for ext, path in kernel.asm.files.items()
+            if ext != request["ext"]
+        }
+        metadata = json.loads(json.dumps(kernel.metadata._asdict(), default=vars))
+        return {"files": files, "metadata": metadata}
+
+
+class CompileRequestHandler(BaseHTTPRequestHandler):
+
+    def _reply(self, code, body):
+        data = json.dumps(body).encode("utf-8")
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_POST(self):
+        if self.path != "/compile":
+            self._reply(404, {"error": f"unknown path {self.path}"})
+            return
+        try:
+            request = json.loads(self.rfile.read(int(self.headers["Content-Length"])))
+            self._reply(200, self.server.compile(request))
+        except RejectedRequest as e:
+            self._reply(e.code, {"error": str(e)})
+        except Exception as e:
+            self._reply(422, {"error": str(e)})
+
+    def do_GET(self):
+        if self.path != "/stats":
+            self._reply(404, {"error": f"unknown path {self.path}"})
+            return
+        with self.server._lock:
+            self._reply(200, dict(self.server.stats))
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            super().log_message(format, *args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile the Triton kernels of remote clients.")
+    parser.add_argument("--host", default="127.0.0.1", help="address to listen on")
+    parser.add_argument("--port", type=int, default=8471, help="port to listen on")
+    parser.add_argument("--verbose", action="store_true", help="log the requests")
+    args = parser.parse_args()
+    with CompileServer((args.host, args.port), verbose=args.verbose) as server:
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+/* clang-format off */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <level_zero/ze_api.h>
+
+
+// helpers to check for level zero errors
+#define ZE_CHECK(ans) {{\
+    zeAssert((ans), __FILE__, __LINE__);\
+  }}\
+
+#define ZE_RETURN_IF_ERROR(ans) {{\
+    ze_result_t res = (ans);\
+    if (res != ZE_RESULT_SUCCESS)\
+      return res;\
+  }}\
+
+static inline void zeAssert(ze_result_t code, const char *file, int line) {{
+  if (code != ZE_RESULT_SUCCESS) {{
+    fprintf(stderr, "Triton Error [ZE]: 0x%x at %s:%d\\n", code, file, line);
+    exit(code);
+  }}
+}}
+
+// globals
+#define BIN_NAME {kernel_name}_bin
+ze_module_handle_t {kernel_name}_mod = NULL;
+ze_kernel_handle_t {kernel_name}_func = NULL;
+unsigned char BIN_NAME[{bin_size}] = {{ {bin_data} }};
+
+
+void unload_{kernel_name}(void) {{
+    if ({kernel_name}_func == NULL)
+      return;
+    ZE_CHECK(zeKernelDestroy({kernel_name}_func));
+    ZE_CHECK(zeModuleDestroy({kernel_name}_mod));
+    {kernel_name}_func = NULL;
+    {kernel_name}_mod = NULL;
+}}
+
+// TODO: some code duplication with `backend/include/sycl_functions.h`
+void load_{kernel_name}(ze_context_handle_t context, ze_device_handle_t device) {{
+    ze_module_desc_t module_desc = {{0}};
+    module_desc.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+    module_desc.format = {bin_format};
+    module_desc.inputSize = sizeof(BIN_NAME);
+    module_desc.pInputModule = BIN_NAME;
+    module_desc.pBuildFlags = "{build_flags}";
+    ZE_CHECK(zeModuleCreate(context, device, &module_desc, &{kernel_name}_mod, NULL));
+    ze_kernel_desc_t kernel_desc = {{0}};
+    kernel_desc.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+    kernel_desc.flags = ZE_KERNEL_FLAG_FORCE_RESIDENCY;
+    kernel_desc.pKernelName = "{triton_kernel_name}";
+    ZE_CHECK(zeKernelCreate({kernel_name}_mod, &kernel_desc, &{kernel_name}_func));
+    ZE_CHECK(zeKernelSetGroupSize({kernel_name}_func, {num_warps} * {threads_per_warp}, 1, 1));
+}}
+
+/*
+{kernel_docstring}
+*/
+// The arguments are set on the kernel shared by all the launches: launches
+// from several threads must be serialized by the caller.
+ze_result_t {kernel_name}(ze_command_list_handle_t cmd_list, {signature}) {{
+    if ({kernel_name}_func == NULL)
+      return ZE_RESULT_ERROR_UNINITIALIZED;
+    uint32_t gX = {gridX};
+    uint32_t gY = {gridY};
+    uint32_t gZ = {gridZ};
+    if (gX * gY * gZ == 0)
+      return ZE_RESULT_SUCCESS;
+{set_args}
+    // shared local memory is passed as an extra argument
+    if ({shared} > 0)
+      ZE_RETURN_IF_ERROR(zeKernelSetArgumentValue({kernel_name}_func, {num_args}, {shared}, NULL));
+    ze_group_count_t group_count = {{gX, gY, gZ}};
+    return zeCommandListAppendLaunchKernel(cmd_list, {kernel_name}_func, &group_count, NULL, 0, NULL);
+}}
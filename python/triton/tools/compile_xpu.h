@@ -0,0 +1,14 @@
+#ifndef TT_KERNEL_INCLUDES
+#define TT_KERNEL_INCLUDES
+
+#include <inttypes.h>
+#include <level_zero/ze_api.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#endif
+
+void unload_{kernel_name}(void);
+void load_{kernel_name}(ze_context_handle_t context, ze_device_handle_t device);
+// tt-linker: {kernel_name}:{full_signature}:{algo_info}
+ze_result_t{_placeholder} {kernel_name}(ze_command_list_handle_t cmd_list, {signature});
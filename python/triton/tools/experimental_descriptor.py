@@ -1,3 +1,5 @@
+import functools
+
 import torch
 
 import triton
@@ -24,9 +26,21 @@ class TmaDescKernelParam:
         return self.desc.data_ptr()
 
 
+# A descriptor only encodes its global address, shapes and element size, so the
+# descriptors of the tensors launched again and again with the same shapes are
+# only filled once.
+@functools.lru_cache(maxsize=1024)
+def _get_tma_descriptor(ptr, dims, block_dims, element_size):
+    return TmaDescKernelParam(ptr, list(dims), list(block_dims), element_size)
+
+
+def clear_tma_descriptor_cache():
+    _get_tma_descriptor.cache_clear()
+
+
 def create_1d_tma_descriptor(ptr, dim, block_dim, element_size):
-    return TmaDescKernelParam(ptr, [dim], [block_dim], element_size)
+    return _get_tma_descriptor(ptr, (dim, ), (block_dim, ), element_size)
 
 
 def create_2d_tma_descriptor(ptr, dim1, dim0, block_dim1, block_dim0, element_size):
-    return TmaDescKernelParam(ptr, [dim1, dim0], [block_dim1, block_dim0], element_size)
+    return _get_tma_descriptor(ptr, (dim1, dim0), (block_dim1, block_dim0), element_size)
@@ -26,6 +26,31 @@ class KernelLinkerMeta:
     """ number of specialized arguments """
 
 
+@dataclass
+class LinkerTarget:
+    include: str
+    result_type: str
+    stream_type: str
+    stream_name: str
+    invalid_value: str
+    """ returned when no kernel matches the arguments """
+    load_params: str
+    """ parameters of the `load_*` functions, beyond CUDA's implicit current context """
+    load_args: str
+
+
+targets = {
+    "cuda":
+    LinkerTarget(include="#include <cuda.h>", result_type="CUresult", stream_type="CUstream", stream_name="stream",
+                 invalid_value="CUDA_ERROR_INVALID_VALUE", load_params="", load_args=""),
+    "xpu":
+    LinkerTarget(include="#include <level_zero/ze_api.h>", result_type="ze_result_t",
+                 stream_type="ze_command_list_handle_t", stream_name="cmd_list",
+                 invalid_value="ZE_RESULT_ERROR_INVALID_ARGUMENT",
+                 load_params="ze_context_handle_t context, ze_device_handle_t device", load_args="context, device"),
+}
+
+
 class HeaderParser:
 
     def __init__(self) -> None:
@@ -131,40 +156,40 @@ def gen_signature(m):
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_algo_decls(name: str, metas: Sequence[KernelLinkerMeta], t: LinkerTarget) -> str:
     return f"""
-CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])});
-void load_{name}();
+{t.result_type} {name}({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(metas[-1])});
+void load_{name}({t.load_params});
 void unload_{name}();
     """
 
 
 # generate declarations of kernels with meta-parameter and constant values
-def make_global_decl(meta: KernelLinkerMeta) -> str:
+def make_global_decl(meta: KernelLinkerMeta, t: LinkerTarget) -> str:
     return f"""
-CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)});
-CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id);
-void load_{meta.orig_kernel_name}();
+{t.result_type} {meta.orig_kernel_name}_default({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(meta)});
+{t.result_type} {meta.orig_kernel_name}({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(meta)}, int algo_id);
+void load_{meta.orig_kernel_name}({t.load_params});
 void unload_{meta.orig_kernel_name}();
     """
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_default_algo_kernel(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}_default(CUstream stream, {gen_signature_with_full_args(meta)}){{\n"
-    src += (f"  return {meta.orig_kernel_name}(stream, {', '.join(meta.arg_names)}, 0);\n")
+def make_default_algo_kernel(meta: KernelLinkerMeta, t: LinkerTarget) -> str:
+    src = f"{t.result_type} {meta.orig_kernel_name}_default({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(meta)}){{\n"
+    src += (f"  return {meta.orig_kernel_name}({t.stream_name}, {', '.join(meta.arg_names)}, 0);\n")
     src += "}\n"
     return src
 
 
 # generate dispatcher function for kernels with different integer value hints
-def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -> str:
+def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta], t: LinkerTarget) -> str:
     src = f"// launcher for: {name}\n"
     for meta in sorted(metas, key=lambda m: -m.num_specs):
-        src += f"CUresult {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(CUstream stream, {gen_signature(meta)});\n"
+        src += f"{t.result_type} {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}({t.stream_type} {t.stream_name}, {gen_signature(meta)});\n"
     src += "\n"
 
-    src += (f"CUresult {name}(CUstream stream, {gen_signature_with_full_args(metas[-1])}){{")
+    src += (f"{t.result_type} {name}({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(metas[-1])}){{")
     src += "\n"
     for meta in sorted(metas, key=lambda m: -m.num_specs):
         cond_fn = (  #
@@ -181,36 +206,37 @@ def make_kernel_hints_dispatcher(name: str, metas: Sequence[KernelLinkerMeta]) -
         src += (f"  if ({conds})\n" if any(meta.sizes) else "if (1)\n"
                 )  # Edge case where no specializations hence no dispatching required
         arg_names = [arg for arg, hint in zip(meta.arg_names, meta.sizes) if hint != 1]
-        src += f"    return {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}(stream, {', '.join(arg_names)});\n"
+        src += f"    return {meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}({t.stream_name}, {', '.join(arg_names)});\n"
     src += "\n"
-    src += "  return CUDA_ERROR_INVALID_VALUE;\n"
+    src += f"  return {t.invalid_value};\n"
     src += "}\n"
 
     for mode in ["load", "unload"]:
+        params, args = (t.load_params, t.load_args) if mode == "load" else ("", "")
         src += f"\n// {mode} for: {name}\n"
         for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += f"void {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n"
-        src += f"void {mode}_{name}() {{"
+            src += f"void {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}({params});\n"
+        src += f"void {mode}_{name}({params}) {{"
         src += "\n"
         for meta in sorted(metas, key=lambda m: -m.num_specs):
-            src += (f"  {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}();\n")
+            src += (f"  {mode}_{meta.orig_kernel_name}_{meta.sig_hash}_{meta.suffix}({args});\n")
         src += "}\n"
     return src
 
 
 # generate dispatcher function for kernels with different meta-parameter and constant values
-def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta) -> str:
-    src = f"CUresult {meta.orig_kernel_name}(CUstream stream, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
+def make_kernel_meta_const_dispatcher(meta: KernelLinkerMeta, t: LinkerTarget) -> str:
+    src = f"{t.result_type} {meta.orig_kernel_name}({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(meta)}, int algo_id){{\n"
     src += f"  assert (algo_id < (int)sizeof({meta.orig_kernel_name}_kernels));\n"
-    src += f"  return {meta.orig_kernel_name}_kernels[algo_id](stream, {', '.join(meta.arg_names)});\n"
+    src += f"  return {meta.orig_kernel_name}_kernels[algo_id]({t.stream_name}, {', '.join(meta.arg_names)});\n"
     src += "}\n"
     return src
 
 
 # generate definition of function pointers of kernel dispatchers based on meta-parameter and constant values
-def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
+def make_func_pointers(names: str, meta: KernelLinkerMeta, t: LinkerTarget) -> str:
     # the table of hint dispatchers
-    src = f"typedef CUresult (*kernel_func_t)(CUstream stream, {gen_signature_with_full_args(meta)});\n"
+    src = f"typedef {t.result_type} (*kernel_func_t)({t.stream_type} {t.stream_name}, {gen_signature_with_full_args(meta)});\n"
     src += f"kernel_func_t {meta.orig_kernel_name}_kernels[] = {{\n"
     for name in names:
         src += f"  {name},\n"
@@ -219,12 +245,13 @@ def make_func_pointers(names: str, meta: KernelLinkerMeta) -> str:
 
 
 # generate definition for load/unload functions for kernels with different meta-parameter and constant values
-def make_kernel_load_def(names: str, meta: KernelLinkerMeta) -> str:
+def make_kernel_load_def(names: str, meta: KernelLinkerMeta, t: LinkerTarget) -> str:
     src = ""
     for mode in ["load", "unload"]:
-        src += f"void {mode}_{meta.orig_kernel_name}(void){{\n"
+        params, args = (t.load_params, t.load_args) if mode == "load" else ("", "")
+        src += f"void {mode}_{meta.orig_kernel_name}({params or 'void'}){{\n"
         for name in names:
-            src += f"  {mode}_{name}();\n"
+            src += f"  {mode}_{name}({args});\n"
         src += "}\n\n"
     return src
 
@@ -250,6 +277,9 @@ kernel given the specializations that were compiled.
 
 Example usage:
 python link.py /path/to/headers/*.h -o kernel_name
+
+Headers generated for XPU are linked with `--target xpu`: the dispatchers then
+take a Level Zero command list and the `load_*` functions a context and device.
 """
 
 if __name__ == "__main__":
@@ -268,7 +298,10 @@ if __name__ == "__main__":
         default="",
         help="String to prefix kernel dispatcher names",
     )
+    parser.add_argument("--target", type=str, default="cuda", choices=targets.keys(),
+                        help="Target the headers were compiled for")
     args = parser.parse_args()
+    target = targets[args.target]
 
     # metadata
     parser = HeaderParser()
@@ -280,13 +313,13 @@ if __name__ == "__main__":
         parser.extract_linker_meta(h_str)
 
     # generate headers
-    algo_decls = [make_algo_decls(name, meta) for name, meta in parser.kernels.items()]
+    algo_decls = [make_algo_decls(name, meta, target) for name, meta in parser.kernels.items()]
     meta_lists = [meta for name, meta in parser.kernels.items()]
     meta = meta_lists[0][0]
     get_num_algos_decl = make_get_num_algos_decl(meta)
-    global_decl = make_global_decl(meta)
+    global_decl = make_global_decl(meta, target)
     with args.out.with_suffix(".h").open("w") as fp:
-        out = "#include <cuda.h>\n"
+        out = f"{target.include}\n"
         out += "\n".join(algo_decls)
         out += "\n"
         out += get_num_algos_decl
@@ -295,16 +328,16 @@ if __name__ == "__main__":
         fp.write(out)
 
     # generate source
-    defs = [make_kernel_hints_dispatcher(name, meta) for name, meta in parser.kernels.items()]
+    defs = [make_kernel_hints_dispatcher(name, meta, target) for name, meta in parser.kernels.items()]
     names = [name for name in parser.kernels.keys()]
-    func_pointers_def = make_func_pointers(names, meta)
-    meta_const_def = make_kernel_meta_const_dispatcher(meta)
-    load_unload_def = make_kernel_load_def(names, meta)
+    func_pointers_def = make_func_pointers(names, meta, target)
+    meta_const_def = make_kernel_meta_const_dispatcher(meta, target)
+    load_unload_def = make_kernel_load_def(names, meta, target)
     get_num_algos_def = make_get_num_algos_def(meta)
-    default_algo_kernel = make_default_algo_kernel(meta)
+    default_algo_kernel = make_default_algo_kernel(meta, target)
     with args.out.with_suffix(".c").open("w") as fp:
         out = ""
-        out += "#include <cuda.h>\n"
+        out += f"{target.include}\n"
         out += "#include <stdint.h>\n"
         out += "#include <assert.h>\n"
         out += "\n"
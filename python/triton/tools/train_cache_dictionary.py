@@ -0,0 +1,61 @@
+"""
+Train a zstd dictionary on the binary entries of the Triton cache.
+
+The SPIR-V and native binaries of the variants of a kernel family (e.g. the
+configurations of an autotuned kernel) share most of their content, so that
+a dictionary trained on them compresses each entry much better than zstd
+alone. Train the dictionary on the entries of the family:
+
+    python -m triton.tools.train_cache_dictionary --output family.dict \\
+        --pattern "matmul_kernel*.spv" --pattern "matmul_kernel*.zebin"
+
+then compress the cache entries with it:
+
+    TRITON_CACHE_COMPRESSION=zstd TRITON_CACHE_ZSTD_DICT=family.dict ...
+
+The entries compressed with a dictionary can only be read with the same
+`TRITON_CACHE_ZSTD_DICT`.
+"""
+
+import argparse
+from pathlib import Path
+
+from triton.runtime.cache import ZSTD_MAGIC, default_cache_dir, read_cache_entry
+
+
+def collect_samples(cache_dir, patterns):
+    """Return the (decompressed) content of the cache entries matching `patterns`."""
+    samples = []
+    for pattern in patterns:
+        for path in sorted(Path(cache_dir).rglob(pattern)):
+            with open(path, "rb") as f:
+                compressed = f.read(len(ZSTD_MAGIC)) == ZSTD_MAGIC
+            # Entries compressed with another dictionary cannot be read.
+            try:
+                samples.append(bytes(read_cache_entry(path)) if compressed else path.read_bytes())
+            except Exception:
+                continue
+    return samples
+
+
+def train_dictionary(samples, dict_size):
+    import zstandard
+    return zstandard.train_dictionary(dict_size, samples).as_bytes()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cache-dir", default=None, help="cache to sample (default: the Triton cache)")
+    parser.add_argument("--pattern", action="append", required=True, help="glob of the entries to train on")
+    parser.add_argument("--dict-size", type=int, default=112640, help="size of the dictionary in bytes")
+    parser.add_argument("--output", "-o", required=True, help="path of the dictionary")
+    args = parser.parse_args()
+    samples = collect_samples(args.cache_dir or default_cache_dir(), args.pattern)
+    if not samples:
+        parser.error("no cache entry matches the patterns")
+    Path(args.output).write_bytes(train_dictionary(samples, args.dict_size))
+    print(f"Trained a {args.dict_size}-byte dictionary on {len(samples)} entries")
+
+
+if __name__ == "__main__":
+    main()
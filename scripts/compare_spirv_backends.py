@@ -0,0 +1,80 @@
+"""
+Compares the SPIR-V emitted for the kernels of a Triton cache by the
+SPIRV-LLVM-Translator and by LLVM's SPIR-V backend (`TRITON_INTEL_SPIRV_BACKEND`):
+the translation time, the size of the SPIR-V and, with `--load`, the registers
+and spills of the native binary built by the driver.
+
+The cache must hold the text of the LLVM IR, i.e. be populated with
+`TRITON_INTEL_KEEP_LLIR=1`:
+
+    TRITON_INTEL_KEEP_LLIR=1 TRITON_CACHE_DIR=/tmp/cache python -m pytest ...
+    python scripts/compare_spirv_backends.py /tmp/cache --load
+"""
+
+import argparse
+import json
+import time
+from pathlib import Path
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Compare the SPIR-V translator with LLVM's SPIR-V backend")
+    parser.add_argument("cache_dir", help="Triton cache directory holding the .llir files of the kernels")
+    parser.add_argument("--repeat", type=int, default=3, help="Number of translations to time, the fastest is kept")
+    parser.add_argument("--load", action="store_true", help="Also build the SPIR-V with the driver")
+    return parser.parse_args()
+
+
+def translate(llir, use_backend, repeat):
+    from triton._C.libtriton import intel
+    best = float("inf")
+    for _ in range(repeat):
+        start = time.perf_counter()
+        spirv, name = intel.translate_to_spirv(llir, use_backend)
+        best = min(best, time.perf_counter() - start)
+    return spirv, name, best
+
+
+def load(name, spirv, metadata):
+    from triton.runtime.driver import driver
+    device = driver.active.get_current_device()
+    _, _, n_regs, n_spills = driver.active.utils.load_binary(name, spirv, metadata.get("shared", 0),
+                                                             metadata.get("build_flags", ""), device)
+    return n_regs, n_spills
+
+
+def main():
+    from triton.backends.intel.compiler import LLIR_NOT_KEPT
+    args = parse_args()
+    rows = []
+    for path in sorted(Path(args.cache_dir).rglob("*.llir")):
+        llir = path.read_text()
+        if llir == LLIR_NOT_KEPT:
+            continue
+        metadata_path = path.with_suffix(".json")
+        metadata = json.loads(metadata_path.read_text()) if metadata_path.exists() else {}
+        translator, name, translator_s = translate(llir, False, args.repeat)
+        backend, _, backend_s = translate(llir, True, args.repeat)
+        # The translator is used when the backend does not support the kernel.
+        row = {"kernel": name, "fallback": backend == translator, "translator_ms": translator_s * 1e3,
+               "backend_ms": backend_s * 1e3, "translator_bytes": len(translator), "backend_bytes": len(backend)}
+        if args.load:
+            row["translator_regs"], row["translator_spills"] = load(name, translator, metadata)
+            if not row["fallback"]:
+                row["backend_regs"], row["backend_spills"] = load(name, backend, metadata)
+        rows.append(row)
+        print(json.dumps(row))
+
+    compared = [row for row in rows if not row["fallback"]]
+    print(f"{len(rows)} kernels, {len(rows) - len(compared)} not supported by the backend")
+    if compared:
+        translator_ms = sum(row["translator_ms"] for row in compared)
+        backend_ms = sum(row["backend_ms"] for row in compared)
+        print(f"translation time: translator {translator_ms:.1f} ms, backend {backend_ms:.1f} ms")
+        if args.load:
+            spills = [(row["translator_spills"], row["backend_spills"]) for row in compared]
+            print(f"spills: translator {sum(s for s, _ in spills)} bytes, backend {sum(s for _, s in spills)} bytes")
+
+
+if __name__ == "__main__":
+    main()
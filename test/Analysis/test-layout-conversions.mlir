@@ -0,0 +1,38 @@
+// RUN: triton-opt %s --mlir-disable-threading --test-layout-conversions --split-input-file 2>&1 | FileCheck %s
+
+// Both layouts assign the same elements to each work-item.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @register_local(%arg0: tensor<4x16xf32, #blocked>) -> tensor<4x16xf32, #blocked1> {
+    // CHECK: :[[@LINE+1]]:{{[0-9]+}}): register-local
+    %0 = triton_gpu.convert_layout %arg0 : tensor<4x16xf32, #blocked> -> tensor<4x16xf32, #blocked1>
+    tt.return %0 : tensor<4x16xf32, #blocked1>
+  }
+}
+
+// -----
+
+// The rows held by each work-item are transposed within the sub-group.
+#blocked = #triton_gpu.blocked<{sizePerThread = [16, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 1], order = [0, 1]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 16], threadsPerWarp = [16, 1], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @warp_local(%arg0: tensor<16x16xf32, #blocked>) -> tensor<16x16xf32, #blocked1> {
+    // CHECK: :[[@LINE+1]]:{{[0-9]+}}): warp-local, 2048 SLM bytes, 2048 bytes moved, 1 barriers
+    %0 = triton_gpu.convert_layout %arg0 : tensor<16x16xf32, #blocked> -> tensor<16x16xf32, #blocked1>
+    tt.return %0 : tensor<16x16xf32, #blocked1>
+  }
+}
+
+// -----
+
+// The tensor is exchanged between the warps through SLM in 4 replicas.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [8, 1], threadsPerWarp = [4, 4], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @cross_warp(%arg0: tensor<64x64xf16, #blocked>) -> tensor<64x64xf16, #blocked1> {
+    // CHECK: :[[@LINE+1]]:{{[0-9]+}}): cross-warp, 2112 SLM bytes, 16384 bytes moved, 7 barriers
+    %0 = triton_gpu.convert_layout %arg0 : tensor<64x64xf16, #blocked> -> tensor<64x64xf16, #blocked1>
+    tt.return %0 : tensor<64x64xf16, #blocked1>
+  }
+}
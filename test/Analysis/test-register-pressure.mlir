@@ -0,0 +1,30 @@
+// RUN: triton-opt %s --mlir-disable-threading --test-register-pressure --split-input-file 2>&1 | FileCheck %s
+
+// Tensors without a layout are distributed across the sub-group.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: no_layout: 104 bytes
+  tt.func public @no_layout(%arg0: !tt.ptr<f32>) {
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<8x16x!tt.ptr<f32>>
+    tt.store %0, %cst : tensor<8x16x!tt.ptr<f32>>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [8, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Values live across the loop count towards the pressure inside the loop.
+  // CHECK-LABEL: loop: 96 bytes
+  tt.func public @loop(%arg0: !tt.ptr<f32>, %lb: i32, %ub: i32, %step: i32) {
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x64xf32, #blocked>
+    %ptrs = tt.splat %arg0 : !tt.ptr<f32> -> tensor<8x64x!tt.ptr<f32>, #blocked>
+    %res = scf.for %iv = %lb to %ub step %step iter_args(%acc = %cst) -> (tensor<8x64xf32, #blocked>) : i32 {
+      %0 = arith.addf %acc, %acc : tensor<8x64xf32, #blocked>
+      scf.yield %0 : tensor<8x64xf32, #blocked>
+    }
+    tt.store %ptrs, %res : tensor<8x64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
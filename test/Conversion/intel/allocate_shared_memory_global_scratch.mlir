@@ -0,0 +1,37 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], hasLeadingOffset = false}>
+// COM: The global scratch of the launch is passed before the SLM buffer.
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, triton_intel_gpu.global_scratch_size = 1024 : i32} {
+  // CHECK-LABEL: tt.func @scratch_and_slm(
+  // CHECK-SAME:    %{{.*}}: tensor<64x64xf16, #{{.*}}>, %{{.*}}: !llvm.ptr<1>, %{{.*}}: !llvm.ptr<3>)
+  tt.func @scratch_and_slm(%arg0: tensor<64x64xf16, #blocked>) {
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<64x64xf16, #blocked>) -> !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory> -> tensor<64x64xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, triton_intel_gpu.global_scratch_size = 1024 : i32} {
+  // CHECK-LABEL: tt.func @scratch_only(
+  // CHECK-SAME:    %{{.*}}: tensor<64x64xf16, #{{.*}}>, %{{.*}}: !llvm.ptr<1>)
+  tt.func @scratch_only(%arg0: tensor<64x64xf16, #blocked>) {
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+// COM: Kernels without global scratch keep their arguments.
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func @no_scratch(
+  // CHECK-SAME:    %{{.*}}: tensor<64x64xf16, #{{.*}}>)
+  tt.func @no_scratch(%arg0: tensor<64x64xf16, #blocked>) {
+    tt.return
+  }
+}
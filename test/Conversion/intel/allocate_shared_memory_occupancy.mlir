@@ -0,0 +1,25 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory="slm-size-per-xe-core=16384 threads-per-xe-core=64 target-workgroups-per-xe-core=4" -verify-diagnostics | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], hasLeadingOffset = false}>
+// COM: 8KB of SLM per workgroup lets 2 workgroups share an Xe-core, 16 would fit the hardware threads.
+// CHECK: module attributes {{{.*}}triton_gpu.shared = 8192 : i32{{.*}}triton_intel_gpu.workgroups_per_xe_core = 2 : i32
+// expected-warning @below {{SLM footprint of 8192 bytes limits occupancy to 2 workgroup(s) per Xe-core (expected 4)}}
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func @slm_limited(%arg0: tensor<64x64xf16, #blocked>) {
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<64x64xf16, #blocked>) -> !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory> -> tensor<64x64xf16, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [32, 1], order = [1, 0]}>
+// COM: Without SLM the occupancy is bounded by the hardware threads: 64 / 32 sub-groups.
+// CHECK: module attributes {{{.*}}triton_intel_gpu.workgroups_per_xe_core = 2 : i32
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func @thread_limited(%arg0: tensor<128x64xf16, #blocked>) {
+    tt.return
+  }
+}
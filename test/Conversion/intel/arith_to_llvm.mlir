@@ -61,3 +61,40 @@ module attributes {"triton_intel_gpu.support_sg_2d_block", "triton_intel_gpu.sup
     tt.return %1: tensor<512xf32, #blocked>
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+
+// CHECK-LABEL:   llvm.func spir_kernelcc @packed_half_arithmetic(
+module attributes {"triton_intel_gpu.support_bf16_conversion", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  tt.func @packed_half_arithmetic(%arg0 : tensor<256xf16, #blocked>, %arg1 : tensor<256xbf16, #blocked>) -> (tensor<256xf16, #blocked>, tensor<256xbf16, #blocked>) {
+// CHECK:           llvm.fadd {{.*}} : vector<2xf16>
+// CHECK-NOT:       llvm.fadd {{.*}} : f16
+    %0 = arith.addf %arg0, %arg0 : tensor<256xf16, #blocked>
+// CHECK:           llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELDv2_s({{.*}}) : (vector<2xi16>) -> vector<2xf32>
+// CHECK:           llvm.call spir_funccc @_Z27__spirv_ConvertBF16ToFINTELDv2_s({{.*}}) : (vector<2xi16>) -> vector<2xf32>
+// CHECK:           llvm.fmul {{.*}} : vector<2xf32>
+// CHECK:           llvm.call spir_funccc @_Z27__spirv_ConvertFToBF16INTELDv2_f({{.*}}) : (vector<2xf32>) -> vector<2xi16>
+    %1 = arith.mulf %arg1, %arg1 : tensor<256xbf16, #blocked>
+    tt.return %0, %1 : tensor<256xf16, #blocked>, tensor<256xbf16, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+
+// CHECK-LABEL:   llvm.func spir_kernelcc @umulhi(
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  tt.func @umulhi(%arg0 : tensor<128xi32, #blocked>, %arg1 : tensor<128xi32, #blocked>) -> tensor<128xi32, #blocked> {
+// CHECK-DAG:       [[A:%.*]] = llvm.zext {{.*}} : i32 to i64
+// CHECK-DAG:       [[B:%.*]] = llvm.zext {{.*}} : i32 to i64
+// CHECK:           [[PRODUCT:%.*]] = llvm.mul [[A]], [[B]] : i64
+// CHECK:           [[HI:%.*]] = llvm.lshr [[PRODUCT]], {{.*}} : i64
+// CHECK:           llvm.trunc [[HI]] : i64 to i32
+// CHECK-NOT:       __imf_umulhi
+    %0 = tt.mulhiui %arg0, %arg1 : tensor<128xi32, #blocked>
+    tt.return %0 : tensor<128xi32, #blocked>
+  }
+}
@@ -0,0 +1,18 @@
+// RUN: triton-opt %s --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+// COM: The result of a dot feeds the A operand of a chained dot with a different repCluster along N in registers.
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 1], repCluster = [4, 2], A = [32, 16], B = [16, 32], C = [32, 32]}>
+#dpas1 = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 1], repCluster = [4, 1], A = [32, 16], B = [16, 16], C = [32, 16]}>
+#dot_operand_a = #triton_gpu.dot_op<{opIdx=0, parent=#dpas1, kWidth=2}>
+// CHECK: module attributes {{.*}}triton_gpu.shared = 0 : i32
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @convert_dpas_to_dot_a
+  // CHECK-NOT:     llvm.store
+  // CHECK-NOT:     llvm.call spir_funccc @_Z7barrierj
+  // CHECK:         llvm.return
+  tt.func public @convert_dpas_to_dot_a(%arg0: tensor<128x64xf16, #dpas>) {
+    %0 = triton_gpu.convert_layout %arg0 : tensor<128x64xf16, #dpas> -> tensor<128x64xf16, #dot_operand_a>
+    tt.return
+  }
+}
+
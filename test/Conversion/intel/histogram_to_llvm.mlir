@@ -0,0 +1,34 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+// COM: Checks that histograms with few bins per thread are computed with vote ballots.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @histogram_warp_ballot
+  // CHECK:         llvm.call spir_funccc @_Z21sub_group_shuffle_xor
+  // CHECK:         llvm.intr.ctpop
+  // CHECK:         llvm.atomicrmw add {{.*}} monotonic : !llvm.ptr<3>, i32
+  tt.func public @histogram_warp_ballot(%arg0: tensor<64xi32, #blocked>) -> tensor<64xi32, #blocked> {
+    %0 = tt.histogram %arg0 : tensor<64xi32, #blocked> -> tensor<64xi32, #blocked>
+    tt.return %0 : tensor<64xi32, #blocked>
+  }
+}
+
+// -----
+
+// COM: Checks that histograms with many bins accumulate each element directly into shared memory.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @histogram_shared_memory
+  // CHECK-NOT:     sub_group_shuffle
+  // CHECK-NOT:     llvm.intr.ctpop
+  // CHECK:         llvm.call spir_funccc @_Z7barrierj
+  // CHECK:         [[MASK:%.*]] = llvm.mlir.constant(1023 : i32) : i32
+  // CHECK:         [[BIN:%.*]] = llvm.and {{.*}}, [[MASK]]  : i32
+  // CHECK:         [[PTR:%.*]] = llvm.getelementptr {{.*}}[[[BIN]]] : (!llvm.ptr<3>, i32) -> !llvm.ptr<3>, i32
+  // CHECK:         llvm.atomicrmw add [[PTR]], {{.*}} monotonic : !llvm.ptr<3>, i32
+  // CHECK:         llvm.call spir_funccc @_Z7barrierj
+  tt.func public @histogram_shared_memory(%arg0: tensor<64xi32, #blocked>) -> tensor<1024xi32, #blocked> {
+    %0 = tt.histogram %arg0 : tensor<64xi32, #blocked> -> tensor<1024xi32, #blocked>
+    tt.return %0 : tensor<1024xi32, #blocked>
+  }
+}
@@ -0,0 +1,58 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+
+// CHECK-LABEL: llvm.func spir_kernelcc @ieee
+// CHECK-NOT: __spirv_ocl_
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @ieee(%arg0: tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked> {
+    %0 = math.log %arg0 : tensor<128xf32, #blocked>
+    %1 = tt.extern_elementwise %0 {libname = "libdevice", libpath = "", pure = true, symbol = "__imf_tanhf"} : (tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked>
+    tt.return %1 : tensor<128xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+
+// CHECK-LABEL: llvm.func spir_kernelcc @approx
+module attributes {"triton_intel_gpu.math_precision" = "approx", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @approx(%arg0: tensor<128xf32, #blocked>, %arg1: tensor<128xf16, #blocked>) -> (tensor<128xf32, #blocked>, tensor<128xf16, #blocked>) {
+    // CHECK: llvm.call spir_funccc @_Z15__spirv_ocl_logf({{.*}}) : (f32) -> f32
+    %0 = math.log %arg0 : tensor<128xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z16__spirv_ocl_tanhf({{.*}}) : (f32) -> f32
+    %1 = tt.extern_elementwise %0 {libname = "libdevice", libpath = "", pure = true, symbol = "__imf_tanhf"} : (tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked>
+    // The precise functions are left to the library.
+    // CHECK: llvm.call spir_funccc @__imf_sqrtf({{.*}}) : (f32) -> f32
+    %2 = tt.extern_elementwise %1 {libname = "libdevice", libpath = "", pure = true, symbol = "__imf_sqrtf"} : (tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked>
+    // Only FP32 is lowered to the builtins.
+    // CHECK-NOT: __spirv_ocl_
+    %3 = math.log %arg1 : tensor<128xf16, #blocked>
+    tt.return %2, %3 : tensor<128xf32, #blocked>, tensor<128xf16, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+
+// CHECK-LABEL: llvm.func spir_kernelcc @fast
+module attributes {"triton_intel_gpu.math_precision" = "fast", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @fast(%arg0: tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked> {
+    // CHECK: llvm.call spir_funccc @_Z22__spirv_ocl_native_expf({{.*}}) : (f32) -> f32
+    %0 = math.exp %arg0 : tensor<128xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z24__spirv_ocl_native_rsqrtf({{.*}}) : (f32) -> f32
+    %1 = math.rsqrt %0 : tensor<128xf32, #blocked>
+    // CHECK: llvm.call spir_funccc @_Z15__spirv_ocl_erff({{.*}}) : (f32) -> f32
+    %2 = math.erf %1 : tensor<128xf32, #blocked>
+    // CHECK: [[X2:%.*]] = llvm.fmul {{.*}}, {{.*}} : f32
+    // CHECK: [[E:%.*]] = llvm.call spir_funccc @_Z23__spirv_ocl_native_exp2f([[X2]]) : (f32) -> f32
+    // CHECK: [[D:%.*]] = llvm.fadd [[E]], {{.*}} : f32
+    // CHECK: [[R:%.*]] = llvm.call spir_funccc @_Z24__spirv_ocl_native_recipf([[D]]) : (f32) -> f32
+    // CHECK: [[R2:%.*]] = llvm.fmul [[R]], {{.*}} : f32
+    // CHECK: llvm.fsub {{.*}}, [[R2]] : f32
+    %3 = tt.extern_elementwise %2 {libname = "libdevice", libpath = "", pure = true, symbol = "__imf_tanhf"} : (tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked>
+    tt.return %3 : tensor<128xf32, #blocked>
+  }
+}
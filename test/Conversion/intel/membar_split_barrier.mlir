@@ -0,0 +1,38 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: split_barrier
+  tt.func @split_barrier(%arg0: tensor<16x16xf16, #blocked>, %arg1: tensor<16x16x!tt.ptr<f16>, #blocked>) -> (tensor<16x16xf16, #blocked>, tensor<16x16xf16, #blocked>) {
+    // COM: The global load hides the latency of the barrier between the SLM store and load.
+    // CHECK:     llvm.store {{.*}} !llvm.ptr<3>
+    // CHECK:     llvm.call spir_funccc @_Z31intel_work_group_barrier_arriveii
+    // CHECK-NOT: _Z7barrierj
+    // CHECK:     llvm.load {{.*}} !llvm.ptr<1>
+    // CHECK:     llvm.call spir_funccc @_Z29intel_work_group_barrier_waitii
+    // CHECK:     llvm.load {{.*}} !llvm.ptr<3>
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<16x16xf16, #blocked>) -> !tt.memdesc<16x16xf16, #shared, #triton_gpu.shared_memory>
+    %1 = tt.load %arg1 : tensor<16x16x!tt.ptr<f16>, #blocked>
+    %2 = triton_gpu.local_load %0 : !tt.memdesc<16x16xf16, #shared, #triton_gpu.shared_memory> -> tensor<16x16xf16, #blocked>
+    tt.return %1, %2 : tensor<16x16xf16, #blocked>, tensor<16x16xf16, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: full_barrier
+  tt.func @full_barrier(%arg0: tensor<16x16xf16, #blocked>) -> tensor<16x16xf16, #blocked> {
+    // COM: Nothing hides the latency of the barrier, it is kept.
+    // CHECK:     llvm.store {{.*}} !llvm.ptr<3>
+    // CHECK-NOT: _Z31intel_work_group_barrier_arriveii
+    // CHECK:     llvm.call spir_funccc @_Z7barrierj
+    // CHECK:     llvm.load {{.*}} !llvm.ptr<3>
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<16x16xf16, #blocked>) -> !tt.memdesc<16x16xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<16x16xf16, #shared, #triton_gpu.shared_memory> -> tensor<16x16xf16, #blocked>
+    tt.return %1 : tensor<16x16xf16, #blocked>
+  }
+}
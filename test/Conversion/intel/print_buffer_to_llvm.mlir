@@ -0,0 +1,23 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+// COM: With a print buffer, the records of the prints are appended to the
+// COM: buffer instead of calling printf: the first lane of the sub-group
+// COM: reserves the records of the sub-group, each lane writes its record of
+// COM: 5 header words, followed by the index and the value of its element.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.print_buffer_size" = 1024 : i32} {
+  // CHECK: llvm.mlir.global external @__triton_print_buffer(){{.*}}addr_space = 1 : i32{{.*}} : !llvm.array<256 x i32>
+  // CHECK:   llvm.mlir.zero : !llvm.array<256 x i32>
+  // CHECK-NOT: __spirv_ocl_printf
+  // CHECK-LABEL: print_buffer
+  tt.func @print_buffer(%arg0 : tensor<64xi32, #blocked>) {
+    // CHECK: [[BUFFER:%.*]] = llvm.mlir.addressof @__triton_print_buffer : !llvm.ptr<1>
+    // CHECK: llvm.cond_br
+    // CHECK: [[RECORDS:%.*]] = llvm.mlir.constant(112 : i32) : i32
+    // CHECK: llvm.atomicrmw add [[BUFFER]], [[RECORDS]] monotonic : !llvm.ptr<1>, i32
+    // CHECK: llvm.cond_br
+    // CHECK-COUNT-7: llvm.store {{.*}} : i32, !llvm.ptr<1>
+    tt.print "x: " {hex = false, isSigned = array<i32: 1>, "triton_intel_gpu.print_id" = 0 : i32} : %arg0 : tensor<64xi32, #blocked>
+    tt.return
+  }
+}
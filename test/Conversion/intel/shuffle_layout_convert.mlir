@@ -0,0 +1,18 @@
+// RUN: env TRITON_INTEL_ENABLE_SHUFFLE_CONVERT_LAYOUT=1 \
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [1, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [16, 2], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // COM: The conversion only moves values within the sub-group: no SLM access nor barrier.
+  // CHECK-LABEL: convert_layout_blocked_blocked_shuffle
+  tt.func @convert_layout_blocked_blocked_shuffle(%arg0: tensor<16x16xf32, #blocked0>) {
+    // CHECK-NOT: llvm.store {{.*}} !llvm.ptr<3>
+    // CHECK-NOT: llvm.call spir_funccc @_Z7barrierj
+    // CHECK:     llvm.call spir_funccc @_Z17sub_group_shufflefj
+    // CHECK-NOT: llvm.load {{.*}} !llvm.ptr<3>
+    // CHECK:     llvm.return
+    %0 = triton_gpu.convert_layout %arg0 : tensor<16x16xf32, #blocked0> -> tensor<16x16xf32, #blocked1>
+    tt.return
+  }
+}
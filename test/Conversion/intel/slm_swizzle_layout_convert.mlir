@@ -0,0 +1,22 @@
+// RUN: env TRITON_INTEL_ENABLE_SLM_SWIZZLE=1 \
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm --cse -canonicalize | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [1, 16], warpsPerCTA = [16, 2], order = [1, 0]}>
+#mma = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 8], repCluster = [4, 2], A = [32, 16], B = [16, 32], C = [32, 32]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @convert_dpas_swizzled
+  tt.func public @convert_dpas_swizzled(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}) {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x256xf16, #mma>
+    // COM: The SLM offsets come from the (swizzled) linear layouts: rows are not padded.
+    // CHECK-NOT:   llvm.mlir.constant(264 : i32) : i32
+    // CHECK:       llvm.xor
+    // CHECK:       llvm.store {{.*}} : vector<1xf16>, !llvm.ptr<3>
+    // CHECK:       llvm.call spir_funccc @_Z7barrierj
+    // CHECK:       llvm.load {{.*}} : !llvm.ptr<3> -> vector<8xf16>
+    %0 = triton_gpu.convert_layout %cst : tensor<128x256xf16, #mma> -> tensor<128x256xf16, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<128x1x!tt.ptr<f16>, #blocked>
+    %2 = tt.broadcast %1 : tensor<128x1x!tt.ptr<f16>, #blocked> -> tensor<128x256x!tt.ptr<f16>, #blocked>
+    tt.store %2, %0 : tensor<128x256x!tt.ptr<f16>, #blocked>
+    tt.return
+  }
+}
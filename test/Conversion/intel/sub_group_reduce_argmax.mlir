@@ -0,0 +1,53 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+// COM: Checks that argmax reductions within a sub-group are lowered to sub-group reductions rather than shuffles.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @argmax
+  // CHECK-NOT:     sub_group_shuffle
+  // CHECK:         [[MAX:%.*]] = llvm.call spir_funccc @_Z32sub_group_non_uniform_reduce_maxf([[VAL:%.*]]) {{.*}} : (f32) -> f32
+  // CHECK-DAG:     [[EQ:%.*]] = llvm.fcmp "oeq" [[VAL]], [[MAX]] : f32
+  // CHECK-DAG:     [[NAN:%.*]] = llvm.fcmp "uno" [[MAX]], [[MAX]] : f32
+  // CHECK:         [[CAND:%.*]] = llvm.or [[EQ]], [[NAN]]  : i1
+  // CHECK:         [[IDX:%.*]] = llvm.select [[CAND]], {{.*}} : i1, i32
+  // CHECK:         llvm.call spir_funccc @_Z32sub_group_non_uniform_reduce_mini([[IDX]]) {{.*}} : (i32) -> i32
+  // CHECK-NOT:     sub_group_shuffle
+  tt.func public @argmax(%arg0: tensor<16xf32, #blocked>, %arg1: tensor<16xi32, #blocked>) -> (f32, i32) {
+    %0:2 = "tt.reduce"(%arg0, %arg1) <{axis = 0 : i32}> ({
+    ^bb0(%v1: f32, %i1: i32, %v2: f32, %i2: i32):
+      %eq = arith.cmpf oeq, %v1, %v2 : f32
+      %lt = arith.cmpi slt, %i1, %i2 : i32
+      %tie = arith.andi %eq, %lt : i1
+      %gt = arith.cmpf ogt, %v1, %v2 : f32
+      %cond = arith.ori %gt, %tie : i1
+      %v = arith.select %cond, %v1, %v2 : f32
+      %i = arith.select %cond, %i1, %i2 : i32
+      tt.reduce.return %v, %i : f32, i32
+    }) : (tensor<16xf32, #blocked>, tensor<16xi32, #blocked>) -> (f32, i32)
+    tt.return %0#0, %0#1 : f32, i32
+  }
+}
+
+// -----
+
+// COM: Checks that unsigned argmin reductions compare the values in the signed domain.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: llvm.func spir_kernelcc @argmin_unsigned
+  // CHECK:         [[SIGN:%.*]] = llvm.mlir.constant(-2147483648 : i32) : i32
+  // CHECK:         [[VAL:%.*]] = llvm.xor {{.*}}, [[SIGN]]  : i32
+  // CHECK:         [[MIN:%.*]] = llvm.call spir_funccc @_Z32sub_group_non_uniform_reduce_mini([[VAL]]) {{.*}} : (i32) -> i32
+  // CHECK:         llvm.icmp "eq" [[VAL]], [[MIN]] : i32
+  // CHECK:         llvm.call spir_funccc @_Z32sub_group_non_uniform_reduce_mini
+  // CHECK-NOT:     sub_group_shuffle
+  tt.func public @argmin_unsigned(%arg0: tensor<16xi32, #blocked>, %arg1: tensor<16xi32, #blocked>) -> (i32, i32) {
+    %0:2 = "tt.reduce"(%arg0, %arg1) <{axis = 0 : i32}> ({
+    ^bb0(%v1: i32, %i1: i32, %v2: i32, %i2: i32):
+      %lt = arith.cmpi ult, %v1, %v2 : i32
+      %v = arith.select %lt, %v1, %v2 : i32
+      %i = arith.select %lt, %i1, %i2 : i32
+      tt.reduce.return %v, %i : i32, i32
+    }) : (tensor<16xi32, #blocked>, tensor<16xi32, #blocked>) -> (i32, i32)
+    tt.return %0#0, %0#1 : i32, i32
+  }
+}
@@ -0,0 +1,52 @@
+// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm --canonicalize | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The scale is the same for all the elements: it is loaded and squared once per thread.
+  // CHECK-LABEL: llvm.func spir_kernelcc @uniform_scale
+  // CHECK:       llvm.load {{.*}} : !llvm.ptr<1> -> i32
+  // CHECK-NOT:   llvm.load
+  // CHECK:       llvm.fmul
+  // CHECK-NOT:   llvm.fmul
+  // CHECK:       llvm.return
+  tt.func public @uniform_scale(%arg0: !tt.ptr<f32>, %arg1: !tt.ptr<f32>) {
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %1 = tt.load %0 : tensor<256x!tt.ptr<f32>, #blocked>
+    %2 = arith.mulf %1, %1 : tensor<256xf32, #blocked>
+    %3 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %4 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %5 = tt.addptr %4, %3 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    tt.store %5, %2 : tensor<256x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Each sub-group holds a single row, so the scale of the row broadcast along the columns is loaded once per thread.
+  // CHECK-LABEL: llvm.func spir_kernelcc @row_scales
+  // CHECK:       llvm.load {{.*}} : !llvm.ptr<1> -> i32
+  // CHECK-NOT:   llvm.load
+  // CHECK:       llvm.return
+  tt.func public @row_scales(%arg0: !tt.ptr<f32>, %arg1: !tt.ptr<f32>) {
+    %cst = arith.constant dense<64> : tensor<4x1xi32, #blocked>
+    %0 = tt.make_range {end = 4 : i32, start = 0 : i32} : tensor<4xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : tensor<4xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> -> tensor<4x1xi32, #blocked>
+    %2 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<4x1x!tt.ptr<f32>, #blocked>
+    %3 = tt.addptr %2, %1 : tensor<4x1x!tt.ptr<f32>, #blocked>, tensor<4x1xi32, #blocked>
+    %4 = tt.broadcast %3 : tensor<4x1x!tt.ptr<f32>, #blocked> -> tensor<4x64x!tt.ptr<f32>, #blocked>
+    %5 = tt.load %4 : tensor<4x64x!tt.ptr<f32>, #blocked>
+    %6 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %7 = tt.expand_dims %6 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %8 = arith.muli %1, %cst : tensor<4x1xi32, #blocked>
+    %9 = tt.broadcast %8 : tensor<4x1xi32, #blocked> -> tensor<4x64xi32, #blocked>
+    %10 = tt.broadcast %7 : tensor<1x64xi32, #blocked> -> tensor<4x64xi32, #blocked>
+    %11 = arith.addi %9, %10 : tensor<4x64xi32, #blocked>
+    %12 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<4x64x!tt.ptr<f32>, #blocked>
+    %13 = tt.addptr %12, %11 : tensor<4x64x!tt.ptr<f32>, #blocked>, tensor<4x64xi32, #blocked>
+    tt.store %13, %5 : tensor<4x64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
@@ -95,3 +95,25 @@ tt.func public @select_op(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg
   tt.return
 }
 }
+
+// -----
+
+// The local memory accesses of the frontend get the encoding of their tensors.
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [0], hasLeadingOffset = false}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 2 : i32} {
+tt.func public @local_memory(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+  // CHECK-LABEL: local_memory
+  %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  %3 = tt.load %2 : tensor<128x!tt.ptr<f32>>
+  // CHECK: %[[BUF:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable>
+  %4 = triton_gpu.local_alloc : () -> !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable>
+  // CHECK: triton_gpu.local_store %{{.*}}, %[[BUF]] : tensor<128xf32, #blocked> -> !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable>
+  triton_gpu.local_store %3, %4 : tensor<128xf32> -> !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable>
+  // CHECK: triton_gpu.local_load %[[BUF]] : !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable> -> tensor<128xf32, #blocked>
+  %5 = triton_gpu.local_load %4 : !tt.memdesc<128xf32, #shared, #triton_gpu.shared_memory, mutable> -> tensor<128xf32>
+  tt.store %2, %5 : tensor<128x!tt.ptr<f32>>
+  tt.return
+}
+}
@@ -241,3 +241,15 @@ module attributes {"triton_gpu.target" = "cuda:90", "triton_gpu.num-ctas" = 1 :
     tt.return
   }
 }
+
+// -----
+
+module attributes {"triton_gpu.target" = "cuda:90", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: @prefetch_tma_desc
+  // CHECK-SAME: nvvm.grid_constant
+  // CHECK: prefetch.tensormap [ $0 + 0 ];
+  // CHECK-NOT: prefetch.tensormap
+  tt.func public @prefetch_tma_desc(%desc: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %arg1: !tt.ptr<f16>) {
+    tt.return
+  }
+}
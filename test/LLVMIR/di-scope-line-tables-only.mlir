@@ -0,0 +1,19 @@
+// RUN: triton-opt %s --enable-line-info --mlir-print-debuginfo | FileCheck %s --check-prefix=FULL
+// RUN: triton-opt %s --enable-line-info=line-tables-only=true --mlir-print-debuginfo | FileCheck %s --check-prefix=LINES
+
+// COM: The code inlined from helper.py keeps the scope of the helper, unless
+// COM: only the lines of the kernel are kept.
+// FULL: #di_lexical_block_file
+// FULL: callsite
+// LINES: #di_subprogram
+// LINES-NOT: di_lexical_block_file
+// LINES-NOT: callsite
+#loc = loc("kernel.py":10:5)
+#loc1 = loc("helper.py":3:7)
+#loc2 = loc(callsite(#loc1 at #loc))
+module {
+  llvm.func @kernel(%arg0: f32) -> f32 {
+    %0 = llvm.fadd %arg0, %arg0 : f32 loc(#loc2)
+    llvm.return %0 : f32 loc(#loc)
+  } loc(#loc)
+} loc(#loc)
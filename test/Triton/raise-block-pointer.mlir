@@ -31,6 +31,44 @@ tt.func @test_addptr_load_with_mask(%arg0 : !tt.ptr<f32>, %arg1: i32, %arg2: ten
   tt.return %3 : tensor<128xf32>
 }
 
+// CHECK-LABEL:   tt.func @test_addptr_load_store_with_mask_2d(
+// CHECK-SAME:                                                 [[PARAM_0_:%.+]]: !tt.ptr<f16>, [[PARAM_1_:%.+]]: !tt.ptr<f16>, [[PARAM_2_:%.+]]: i32, [[PARAM_3_:%.+]]: i32, [[PARAM_4_:%.+]]: i32, [[PARAM_5_:%.+]]: i32) {
+// CHECK-NOT:       tt.addptr
+// CHECK:           [[VAR_0_:%.+]] = tt.make_tensor_ptr [[PARAM_0_]], {{.*}} {order = array<i32>} : <tensor<64x32xf16>>
+// CHECK:           [[VAR_1_:%.+]] = tt.load [[VAR_0_]] {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16>>
+// CHECK:           [[VAR_2_:%.+]] = tt.make_tensor_ptr [[PARAM_1_]], {{.*}} {order = array<i32>} : <tensor<64x32xf16>>
+// CHECK:           tt.store [[VAR_2_]], [[VAR_1_]] {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x32xf16>>
+// CHECK-NOT:       tt.addptr
+// CHECK:           tt.return
+tt.func @test_addptr_load_store_with_mask_2d(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<f16>, %arg2: i32, %arg3: i32, %arg4: i32, %arg5: i32) {
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x32xf16>
+  %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+  %1 = tt.splat %arg2 : i32 -> tensor<64xi32>
+  %2 = arith.addi %1, %0 : tensor<64xi32>
+  %3 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %4 = tt.expand_dims %2 {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+  %5 = tt.splat %arg5 : i32 -> tensor<64x1xi32>
+  %6 = arith.muli %4, %5 : tensor<64x1xi32>
+  %7 = tt.expand_dims %3 {axis = 0 : i32} : tensor<32xi32> -> tensor<1x32xi32>
+  %8 = tt.broadcast %6 : tensor<64x1xi32> -> tensor<64x32xi32>
+  %9 = tt.broadcast %7 : tensor<1x32xi32> -> tensor<64x32xi32>
+  %10 = arith.addi %8, %9 : tensor<64x32xi32>
+  %11 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<64x32x!tt.ptr<f16>>
+  %12 = tt.addptr %11, %10 : tensor<64x32x!tt.ptr<f16>>, tensor<64x32xi32>
+  %13 = tt.splat %arg3 : i32 -> tensor<64x1xi32>
+  %14 = arith.cmpi slt, %4, %13 : tensor<64x1xi32>
+  %15 = tt.broadcast %14 : tensor<64x1xi1> -> tensor<64x32xi1>
+  %16 = tt.splat %arg4 : i32 -> tensor<1x32xi32>
+  %17 = arith.cmpi slt, %7, %16 : tensor<1x32xi32>
+  %18 = tt.broadcast %17 : tensor<1x32xi1> -> tensor<64x32xi1>
+  %19 = arith.andi %15, %18 : tensor<64x32xi1>
+  %20 = tt.load %12, %19, %cst : tensor<64x32x!tt.ptr<f16>>
+  %21 = tt.splat %arg1 : !tt.ptr<f16> -> tensor<64x32x!tt.ptr<f16>>
+  %22 = tt.addptr %21, %10 : tensor<64x32x!tt.ptr<f16>>, tensor<64x32xi32>
+  tt.store %22, %20, %19 : tensor<64x32x!tt.ptr<f16>>
+  tt.return
+}
+
 // CHECK-LABEL:   tt.func @test_addptr_splat_splat_i32(
 // CHECK-SAME:                                         %[[VAL_0:.*]]: !tt.ptr<f32>,
 // CHECK-SAME:                                         %[[VAL_1:.*]]: i32) -> tensor<128xf32> {
@@ -274,7 +312,8 @@ tt.func @test_addptr_broadcast_rank_3(%arg0 : !tt.ptr<f32>) -> tensor<128x2x128x
 // CHECK:       [[VAR_11_:%.+]] = arith.divui [[VAR_3_]], [[VAR_10_]] : i32
 // CHECK:       [[VAR_12_:%.+]] = arith.trunci [[VAR_6_]] : i64 to i32
 // CHECK:       [[VAR_13_:%.+]] = arith.divui [[VAR_7_]], [[VAR_12_]] : i32
-// CHECK:       [[VAR_14_:%.+]] = tt.make_tensor_ptr [[PARAM_0_]], {{\[}}[[CST_0_i64]], [[VAR_9_]]], {{\[}}[[VAR_2_]], [[VAR_6_]]], {{\[}}[[VAR_11_]], [[VAR_13_]]] {order = array<i32>} : <tensor<4x4xf32>>
+// CHECK:       [[SHAPE_:%.+]] = arith.divui [[VAR_9_]], [[VAR_6_]] : i64
+// CHECK:       [[VAR_14_:%.+]] = tt.make_tensor_ptr [[PARAM_0_]], {{\[}}[[CST_0_i64]], [[SHAPE_]]], {{\[}}[[VAR_2_]], [[VAR_6_]]], {{\[}}[[VAR_11_]], [[VAR_13_]]] {order = array<i32>} : <tensor<4x4xf32>>
 // CHECK:       [[VAR_15_:%.+]] = arith.index_cast [[PARAM_5_]] : i32 to index
 // CHECK:       [[VAR_16_:%.+]] = arith.index_cast [[VAR_15_]] : index to i64
 // CHECK:       [[VAR_17_:%.+]] = arith.index_cast [[PARAM_6_]] : i32 to index
@@ -438,9 +477,10 @@ module {
 // CHECK:       [[VAR_8_:%.+]] = arith.muli [[PARAM_4_]], [[CST_3_i32]] : i32
 // CHECK:       [[VAR_9_:%.+]] = arith.trunci [[VAR_2_]] : i64 to i32
 // CHECK:       [[VAR_10_:%.+]] = arith.divui [[VAR_3_]], [[VAR_9_]] : i32
+// CHECK:       [[SHAPE_:%.+]] = arith.divui [[VAR_5_]], [[VAR_2_]] : i64
 // CHECK:       [[VAR_11_:%.+]] = arith.trunci [[VAR_7_]] : i64 to i32
 // CHECK:       [[VAR_12_:%.+]] = arith.divui [[VAR_8_]], [[VAR_11_]] : i32
-// CHECK:       [[VAR_13:%.+]] = tt.make_tensor_ptr [[PARAM_0_]], {{\[}}[[VAR_5_]], [[CST_0_i64]]], {{\[}}[[VAR_2_]], [[VAR_7_]]], {{\[}}[[VAR_10_]], [[VAR_12_]]] {order = array<i32>} : <tensor<4x4xf32>>
+// CHECK:       [[VAR_13:%.+]] = tt.make_tensor_ptr [[PARAM_0_]], {{\[}}[[SHAPE_]], [[CST_0_i64]]], {{\[}}[[VAR_2_]], [[VAR_7_]]], {{\[}}[[VAR_10_]], [[VAR_12_]]] {order = array<i32>} : <tensor<4x4xf32>>
 // CHECK:       [[VAR_14_:%.+]] = arith.index_cast [[PARAM_5_]] : i32 to index
 // CHECK:       [[VAR_15_:%.+]] = arith.index_cast [[VAR_14_]] : index to i64
 // CHECK:       [[VAR_16_:%.+]] = arith.index_cast [[PARAM_6_]] : i32 to index
@@ -648,6 +688,8 @@ module {
 // CHECK:       tt.func @matmul_kernel
 // CHECK: tt.make_tensor_ptr %arg0
 // CHECK: tt.make_tensor_ptr %arg1
+// CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 1>, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16>>
+// CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<32x128xf16>>
 // CHECK: tt.dot
 // CHECK: %[[VAL_1:.*]] = arith.addi
 // CHECK: %[[VAL_2:.*]] = arith.divui
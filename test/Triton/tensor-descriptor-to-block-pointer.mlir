@@ -0,0 +1,53 @@
+// RUN: triton-opt %s -split-input-file -triton-tensor-descriptor-to-block-pointer -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   tt.func public @descriptor_load_store(
+// CHECK-SAME:                                          %[[DESC_A:.*]]: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %[[DESC_B:.*]]: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %[[X:.*]]: i32, %[[Y:.*]]: i32) {
+// CHECK:           %[[FIELDS_B:.*]] = tt.bitcast %[[DESC_B]] : !tt.ptr<i8, 0> -> !tt.ptr<i64, 0>
+// CHECK:           %[[FIELDS_A:.*]] = tt.bitcast %[[DESC_A]] : !tt.ptr<i8, 0> -> !tt.ptr<i64, 0>
+// CHECK:           %[[BASE_PTR_A:.*]] = tt.addptr %[[FIELDS_A]], %{{.*}} : !tt.ptr<i64, 0>, i32
+// CHECK:           %[[BASE_A:.*]] = tt.load %[[BASE_PTR_A]] : !tt.ptr<i64, 0>
+// CHECK:           %[[WIDTH_A:.*]] = tt.load %{{.*}} : !tt.ptr<i64, 0>
+// CHECK:           %[[HEIGHT_A:.*]] = tt.load %{{.*}} : !tt.ptr<i64, 0>
+// CHECK:           %[[PITCH_A:.*]] = tt.load %{{.*}} : !tt.ptr<i64, 0>
+// CHECK:           scf.for
+// CHECK:             %[[PTR_A:.*]] = tt.int_to_ptr %[[BASE_A]] : i64 -> !tt.ptr<f16>
+// CHECK:             %[[ONE:.*]] = arith.constant 1 : i64
+// CHECK:             %[[BLOCK_PTR_A:.*]] = tt.make_tensor_ptr %[[PTR_A]], {{\[}}%[[HEIGHT_A]], %[[WIDTH_A]]], {{\[}}%[[PITCH_A]], %[[ONE]]], {{\[}}%[[X]], %{{.*}}] {order = array<i32: 1, 0>} : <tensor<64x32xf16>>
+// CHECK:             tt.load %[[BLOCK_PTR_A]] {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16>>
+// CHECK:           %[[BLOCK_PTR_B:.*]] = tt.make_tensor_ptr {{.*}} {order = array<i32: 1, 0>} : <tensor<64x32xf16>>
+// CHECK:           tt.store %[[BLOCK_PTR_B]], %{{.*}} {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x32xf16>>
+// CHECK-NOT:       tt.experimental_descriptor
+tt.func public @descriptor_load_store(%arg0: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %arg1: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %arg2: i32, %arg3: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %c32_i32 = arith.constant 32 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<64x32xf16>
+  %0 = scf.for %arg4 = %c0_i32 to %arg3 step %c32_i32 iter_args(%arg5 = %cst) -> (tensor<64x32xf16>) : i32 {
+    %1 = tt.experimental_descriptor_load %arg0[%arg2, %arg4] : !tt.ptr<i8, 0> -> tensor<64x32xf16>
+    %2 = arith.addf %arg5, %1 : tensor<64x32xf16>
+    scf.yield %2 : tensor<64x32xf16>
+  }
+  tt.experimental_descriptor_store %arg1[%arg2, %c0_i32], %0 : !tt.ptr<i8, 0>, tensor<64x32xf16>
+  tt.return
+}
+
+// -----
+
+// CHECK-LABEL:   tt.func public @descriptor_load_1d(
+// CHECK:           %[[FIELDS:.*]] = tt.bitcast %{{.*}} : !tt.ptr<i8, 0> -> !tt.ptr<i64, 0>
+// CHECK:           %[[BASE:.*]] = tt.load %{{.*}} : !tt.ptr<i64, 0>
+// CHECK:           %[[WIDTH:.*]] = tt.load %{{.*}} : !tt.ptr<i64, 0>
+// CHECK:           %[[PTR:.*]] = tt.int_to_ptr %[[BASE]] : i64 -> !tt.ptr<f32>
+// CHECK:           %[[BLOCK_PTR:.*]] = tt.make_tensor_ptr %[[PTR]], {{\[}}%[[WIDTH]]], {{.*}} {order = array<i32: 0>} : <tensor<128xf32>>
+// CHECK:           tt.load %[[BLOCK_PTR]] {boundaryCheck = array<i32: 0>, padding = 1 : i32} : !tt.ptr<tensor<128xf32>>
+tt.func public @descriptor_load_1d(%arg0: !tt.ptr<i8, 0> {tt.nv_tma_desc = 1 : i32}, %arg1: i32) -> tensor<128xf32> {
+  %0 = tt.experimental_descriptor_load %arg0[%arg1] : !tt.ptr<i8, 0> -> tensor<128xf32>
+  tt.return %0 : tensor<128xf32>
+}
+
+// -----
+
+tt.func public @descriptor_in_global_memory(%arg0: !tt.ptr<i8>, %arg1: i32) -> tensor<128xf32> {
+  // expected-error @+1 {{expecting a tensor descriptor passed as a kernel argument}}
+  %0 = tt.experimental_descriptor_load %arg0[%arg1] : !tt.ptr<i8> -> tensor<128xf32>
+  tt.return %0 : tensor<128xf32>
+}
@@ -1,4 +1,4 @@
-// RUN: triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s
+// RUN: TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=0 triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s
 
 // CHECK: llvm.func spir_funccc @_Z40intel_sub_group_2d_block_read_8b_8r32x1cPU3AS1viiiDv2_iPt(!llvm.ptr<1> {llvm.nonnull, llvm.readonly}, i32, i32, i32, vector<2xi32>, !llvm.ptr {llvm.nonnull, llvm.writeonly}) attributes {no_unwind, will_return}
 
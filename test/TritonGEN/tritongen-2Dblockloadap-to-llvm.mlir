@@ -1,5 +1,6 @@
-// RUN: TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=1 triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s --check-prefixes=CHECK,CHECK-COMMON
+// RUN: triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s --check-prefixes=CHECK,CHECK-COMMON
 // RUN: TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=1 TRITONGEN_FORCE_GENISA=1 triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s --check-prefixes=CHECK-GENISA,CHECK-COMMON
+// RUN: TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=0 triton-opt -convert-tritongen-to-llvm -split-input-file %s | FileCheck %s --check-prefix=CHECK-DISABLED --implicit-check-not=__builtin_IB_subgroup_createBlock2DAddressPayload
 
 // CHECK: llvm.func spir_funccc @__builtin_IB_subgroup_block_read_ap_u8_m8k32v1(!llvm.ptr {llvm.nonnull}, i32, i32, i32) -> vector<8xi16> attributes {memory_effects = #llvm.memory_effects<other = none, argMem = read, inaccessibleMem = none>, no_unwind, will_return}
 // CHECK-GENISA:  llvm.func spir_funccc @llvm.genx.GenISA.LSC2DBlockReadAddrPayload.v8i16.p0i8(!llvm.ptr {llvm.nonnull}, i32, i32, i32, i32, i32, i32, i1, i1, i32) -> vector<8xi16> attributes {memory_effects = #llvm.memory_effects<other = none, argMem = read, inaccessibleMem = none>, no_unwind}
@@ -24,6 +25,7 @@ llvm.func @triton_gen.2Dblockload(%ptr : !llvm.ptr<1>, %base_width : i32, %base_
   // CHECK-COMMON:      [[ZERO:%.*]] = llvm.mlir.constant(0 : i32) : i32
   // CHECK:             llvm.call spir_funccc @__builtin_IB_subgroup_block_read_ap_u8_m8k32v1([[AP]], [[ZERO]], [[ZERO]], [[ZERO]]) {{.*}} : (!llvm.ptr, i32, i32, i32) -> vector<8xi16>
   // CHECK-GENISA:      llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockReadAddrPayload.v8i16.p0i8([[AP]], [[ZERO]], [[ZERO]], {{.*}}) {{.*}} : (!llvm.ptr, i32, i32, i32, i32, i32, i32, i1, i1, i32) -> vector<8xi16>
+  // CHECK-DISABLED:    llvm.call spir_funccc @_Z40intel_sub_group_2d_block_read_8b_8r32x1cPU3AS1viiiDv2_iPt(%arg0, %arg1, %arg2, %arg3, {{.*}})
   %0 = triton_gen.2Dblockload %ptr, %base_width, %base_height, %base_pitch, %x, %y {elem_size_in_bits=8, tile_width=32, tile_height=8, v_blocks=1, transpose=false, vnni_transform=false, cache_control=Default} : (!llvm.ptr<1>, i32, i32, i32, i32, i32) -> vector<8xi16>
   llvm.return
 }
@@ -49,3 +51,28 @@ llvm.func @triton_gen.2Dblockload(%ptr : !llvm.ptr<1>, %base_width : i32, %base_
   %0 = triton_gen.2Dblockload %ptr, %base_width, %base_height, %base_pitch, %x, %y {elem_size_in_bits=8, tile_width=16, tile_height=32, v_blocks=1, transpose=false, vnni_transform=true, cache_control=Default} : (!llvm.ptr<1>, i32, i32, i32, i32, i32) -> vector<8xi32>
   llvm.return
 }
+
+// -----
+
+// COM: The address payload reads have no cache control, loads requesting one use the regular lowering.
+llvm.func @triton_gen.2Dblockload(%ptr : !llvm.ptr<1>, %base_width : i32, %base_height : i32, %base_pitch : i32, %x : i32, %y : i32) {
+  // CHECK-COMMON-NOT:  __builtin_IB_subgroup_createBlock2DAddressPayload
+  // CHECK:             llvm.call spir_funccc @_Z40intel_sub_group_2d_block_read_8b_8r32x1cPU3AS1viiiDv2_iPt(%arg0, %arg1, %arg2, %arg3, {{.*}}) {{.*}}triton_gen.DecorationCacheControlINTEL
+  // CHECK-GENISA:      llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v8i16
+  // CHECK-DISABLED:    llvm.call spir_funccc @_Z40intel_sub_group_2d_block_read_8b_8r32x1cPU3AS1viiiDv2_iPt(%arg0, %arg1, %arg2, %arg3, {{.*}})
+  %0 = triton_gen.2Dblockload %ptr, %base_width, %base_height, %base_pitch, %x, %y {elem_size_in_bits=8, tile_width=32, tile_height=8, v_blocks=1, transpose=false, vnni_transform=false, cache_control=L1C_L3C} : (!llvm.ptr<1>, i32, i32, i32, i32, i32) -> vector<8xi16>
+  llvm.return
+}
+
+// -----
+
+// COM: Without an OpenCL builtin for the shape, the payload read is only used with GenISA.
+llvm.func @triton_gen.2Dblockload(%ptr : !llvm.ptr<1>, %base_width : i32, %base_height : i32, %base_pitch : i32, %x : i32, %y : i32) {
+  // CHECK-NOT:         __builtin_IB_subgroup_createBlock2DAddressPayload
+  // CHECK:             llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v16i16
+  // CHECK-GENISA:      llvm.call spir_funccc @__builtin_IB_subgroup_createBlock2DAddressPayload
+  // CHECK-GENISA:      llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockReadAddrPayload.v16i16.p0i8
+  // CHECK-DISABLED:    llvm.call spir_funccc @llvm.genx.GenISA.LSC2DBlockRead.v16i16
+  %0 = triton_gen.2Dblockload %ptr, %base_width, %base_height, %base_pitch, %x, %y {elem_size_in_bits=16, tile_width=32, tile_height=8, v_blocks=1, transpose=false, vnni_transform=false, cache_control=Default} : (!llvm.ptr<1>, i32, i32, i32, i32, i32) -> vector<16xi16>
+  llvm.return
+}
@@ -64,6 +64,19 @@ module attributes {
 
 // -----
 
+module attributes {
+  spirv.target_env = #spirv.target_env<#spirv.vce<v1.4, [Kernel, Addresses, GroupNonUniformShuffle, Int64], []>, #spirv.resource_limits<subgroup_size = 16>>
+} {
+  llvm.func @triton_gen.sub_group_reduce() {
+    // expected-error @+2 {{'triton_gen.sub_group_reduce' op expecting interleave to be a power of 2 and size * interleave to not exceed subgroup size}}
+    %0 = llvm.mlir.constant(0 : i32) : i32
+    %1 = triton_gen.sub_group_reduce add %0 {size = 8, interleave = 4} : i32
+    llvm.return
+  }
+}
+
+// -----
+
 llvm.func @triton_gen.dpas(%c : vector<8xi32>, %a : vector<8xi16>, %b : vector<8xi32>) {
   // expected-error @+1 {{'triton_gen.dpas' op expecting repeat count to be 1, 2, 4, or 8}}
   %0 = triton_gen.dpas %c, %a, %b {pa=i8, pb=i8, rc=16} : (vector<8xi32>, vector<8xi16>, vector<8xi32>) -> vector<8xi32>
@@ -186,7 +199,7 @@ llvm.func @triton_gen.dpas(%c : vector<8xf32>, %a : vector<8xi16>, %b : vector<8
 // -----
 
 llvm.func @triton_gen.dpas(%c : vector<8xf32>, %a : vector<8xi16>, %b : vector<8xi32>) {
-  // expected-error @+1 {{'triton_gen.dpas' op expecting precision type to be tf32, bf16, fp16, u8, or s8}}
+  // expected-error @+1 {{'triton_gen.dpas' op expecting precision type to be tf32, bf16, fp16, bf8, hf8, u8, or s8}}
   %0 = triton_gen.dpas %c, %a, %b {pa=i4, pb=i4, rc=8} : (vector<8xf32>, vector<8xi16>, vector<8xi32>) -> vector<8xf32>
   llvm.return
 }
@@ -138,6 +138,34 @@ module attributes {
 
 // -----
 
+// COM: The interleaved reductions have no builtin, they are lowered to the
+// COM: GenISA intrinsics.
+
+// CHECK-DAG: llvm.func spir_funccc @llvm.genx.GenISA.WaveInterleave.f32(f32, i8, i32, i32) -> f32 attributes {convergent
+// CHECK-DAG: llvm.func spir_funccc @llvm.genx.GenISA.WaveClusteredInterleave.f32(f32, i8, i32, i32, i32) -> f32 attributes {convergent
+
+module attributes {
+  spirv.target_env = #spirv.target_env<#spirv.vce<v1.4, [Kernel, Addresses, GroupNonUniformShuffle, Int64], []>, #spirv.resource_limits<subgroup_size = 32>>
+} {
+  llvm.func @triton_gen.sub_group_reduce_interleaved(%arg0: f32) {
+    // CHECK-LABEL: triton_gen.sub_group_reduce_interleaved
+    // CHECK-DAG: [[ADD:%.*]] = llvm.mlir.constant(0 : i8) : i8
+    // CHECK-DAG: [[STEP:%.*]] = llvm.mlir.constant(2 : i32) : i32
+    // CHECK-DAG: [[HELPER:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK:     llvm.call spir_funccc @llvm.genx.GenISA.WaveInterleave.f32(%arg0, [[ADD]], [[STEP]], [[HELPER]])
+    %0 = triton_gen.sub_group_reduce add %arg0 {size = 16, interleave = 2} : f32
+    // CHECK-DAG: [[MAX:%.*]] = llvm.mlir.constant(3 : i8) : i8
+    // CHECK-DAG: [[CLUSTER:%.*]] = llvm.mlir.constant(16 : i32) : i32
+    // CHECK-DAG: [[STEP:%.*]] = llvm.mlir.constant(4 : i32) : i32
+    // CHECK-DAG: [[HELPER:%.*]] = llvm.mlir.constant(0 : i32) : i32
+    // CHECK:     llvm.call spir_funccc @llvm.genx.GenISA.WaveClusteredInterleave.f32(%arg0, [[MAX]], [[CLUSTER]], [[STEP]], [[HELPER]])
+    %1 = triton_gen.sub_group_reduce max %arg0 {size = 4, interleave = 4} : f32
+    llvm.return
+  }
+}
+
+// -----
+
 // CHECK-DAG: llvm.func spir_funccc @_Z40sub_group_non_uniform_scan_exclusive_addi(i32) -> i32 attributes {convergent, no_unwind, will_return}
 // CHECK-DAG: llvm.func spir_funccc @_Z40sub_group_non_uniform_scan_exclusive_muli(i32) -> i32 attributes {convergent, no_unwind, will_return}
 // CHECK-DAG: llvm.func spir_funccc @_Z40sub_group_non_uniform_scan_exclusive_maxi(i32) -> i32 attributes {convergent, no_unwind, will_return}
@@ -240,6 +268,28 @@ llvm.func @triton_gen.dpas.f16(%c : vector<8xf32>, %a : vector<8xi16>, %b : vect
 
 // -----
 
+// CHECK: llvm.func spir_funccc @_Z38intel_sub_group_bf8_bf8_matrix_mad_k32Dv8_sDv8_iDv8_f(vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32> attributes {convergent, memory_effects = #llvm.memory_effects<other = none, argMem = none, inaccessibleMem = none>, no_unwind, will_return}
+
+llvm.func @triton_gen.dpas.bf8(%c : vector<8xf32>, %a : vector<8xi16>, %b : vector<8xi32>) {
+  // CHECK:     llvm.func @triton_gen.dpas.bf8(%arg0: vector<8xf32>, %arg1: vector<8xi16>, %arg2: vector<8xi32>) {
+  // CHECK-NEXT: llvm.call spir_funccc @_Z38intel_sub_group_bf8_bf8_matrix_mad_k32Dv8_sDv8_iDv8_f(%arg1, %arg2, %arg0) {{.*}} : (vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32>
+  %0 = triton_gen.dpas %c, %a, %b {pa = bf8, pb = bf8, rc = 8} : (vector<8xf32>, vector<8xi16>, vector<8xi32>) -> vector<8xf32>
+  llvm.return
+}
+
+// -----
+
+// CHECK: llvm.func spir_funccc @_Z38intel_sub_group_hf8_hf8_matrix_mad_k32Dv8_sDv8_iDv8_f(vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32> attributes {convergent, memory_effects = #llvm.memory_effects<other = none, argMem = none, inaccessibleMem = none>, no_unwind, will_return}
+
+llvm.func @triton_gen.dpas.hf8(%c : vector<8xf32>, %a : vector<8xi16>, %b : vector<8xi32>) {
+  // CHECK:     llvm.func @triton_gen.dpas.hf8(%arg0: vector<8xf32>, %arg1: vector<8xi16>, %arg2: vector<8xi32>) {
+  // CHECK-NEXT: llvm.call spir_funccc @_Z38intel_sub_group_hf8_hf8_matrix_mad_k32Dv8_sDv8_iDv8_f(%arg1, %arg2, %arg0) {{.*}} : (vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32>
+  %0 = triton_gen.dpas %c, %a, %b {pa = hf8, pb = hf8, rc = 8} : (vector<8xf32>, vector<8xi16>, vector<8xi32>) -> vector<8xf32>
+  llvm.return
+}
+
+// -----
+
 // CHECK: llvm.func spir_funccc @_Z39intel_sub_group_tf32_tf32_matrix_mad_k8Dv4_fDv8_fS0_(vector<4xf32>, vector<8xf32>, vector<8xf32>) -> vector<8xf32> attributes {convergent, memory_effects = #llvm.memory_effects<other = none, argMem = none, inaccessibleMem = none>, no_unwind, will_return}
 
 llvm.func @triton_gen.dpas.f32(%c : vector<8xf32>, %a : vector<4xf32>, %b : vector<8xf32>) {
@@ -303,3 +353,27 @@ llvm.func @triton_gen.simdblockwrite(%ptr: !llvm.ptr<3>, %val : vector<2xi16>) {
   triton_gen.simdblockwrite %ptr, %val : (!llvm.ptr<3>, vector<2xi16>)
   llvm.return
 }
+
+// -----
+
+// CHECK: llvm.func spir_funccc @_Z29intel_sub_group_block_read_uiPU3AS1j(!llvm.ptr<1>) -> i32 attributes {memory_effects = #llvm.memory_effects<other = none, argMem = read, inaccessibleMem = none>, no_unwind, will_return}
+
+llvm.func @triton_gen.simdblockread(%ptr: !llvm.ptr<1>) {
+  // CHECK:     llvm.func @triton_gen.simdblockread(%arg0: !llvm.ptr<1>) {
+  // CHECK:       [[RES:%.*]] = llvm.call spir_funccc @_Z29intel_sub_group_block_read_uiPU3AS1j(%arg0) {{.*}} : (!llvm.ptr<1>) -> i32
+  // CHECK-NEXT:  llvm.bitcast [[RES]] : i32 to vector<1xi32>
+  %ret = triton_gen.simdblockread %ptr : (!llvm.ptr<1>) -> vector<1xi32>
+  llvm.return
+}
+
+// -----
+
+// CHECK: llvm.func spir_funccc @_Z30intel_sub_group_block_write_uiPU3AS1jj(!llvm.ptr<1>, i32) attributes {memory_effects = #llvm.memory_effects<other = none, argMem = readwrite, inaccessibleMem = none>, no_unwind, will_return}
+
+llvm.func @triton_gen.simdblockwrite(%ptr: !llvm.ptr<1>, %val : vector<1xi32>) {
+  // CHECK:     llvm.func @triton_gen.simdblockwrite(%arg0: !llvm.ptr<1>, %arg1: vector<1xi32>) {
+  // CHECK:       [[VAL:%.*]] = llvm.bitcast %arg1 : vector<1xi32> to i32
+  // CHECK-NEXT:  llvm.call spir_funccc @_Z30intel_sub_group_block_write_uiPU3AS1jj(%arg0, [[VAL]]) {{.*}} : (!llvm.ptr<1>, i32) -> ()
+  triton_gen.simdblockwrite %ptr, %val : (!llvm.ptr<1>, vector<1xi32>)
+  llvm.return
+}
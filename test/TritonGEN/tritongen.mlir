@@ -65,6 +65,8 @@ module attributes {
     %6 = triton_gen.sub_group_reduce or %0 {size = 16} : i32
     // CHECK: triton_gen.sub_group_reduce xor %0 {size = 16} : i32
     %7 = triton_gen.sub_group_reduce xor %0 {size = 16} : i32
+    // CHECK: triton_gen.sub_group_reduce add %0 {size = 8, interleave = 2} : i32
+    %8 = triton_gen.sub_group_reduce add %0 {size = 8, interleave = 2} : i32
     llvm.return
   }
 }
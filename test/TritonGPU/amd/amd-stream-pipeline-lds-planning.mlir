@@ -0,0 +1,54 @@
+// RUN: triton-opt %s -tritonamdgpu-stream-pipeline-v2="num_stages=3 waves_per_eu=1" | FileCheck %s --check-prefix=PLANNED
+// RUN: triton-opt %s -tritonamdgpu-stream-pipeline-v2="num_stages=3" | FileCheck %s --check-prefix=UNPLANNED
+
+// COM: The two buffers of 64KB of the 3 stages of the loop do not fit in the
+// COM: LDS, so a work-group cannot even run alone on a CU. With a target of 1
+// COM: wave per EU, the loop is pipelined in 2 stages instead, single-buffered.
+
+// PLANNED: module attributes {{.*}}"triton_amdgpu.num-stages" = 2 : i32, "triton_amdgpu.waves-per-eu" = 1 : i32
+// PLANNED-LABEL: tt.func @matmul_loop
+// PLANNED-COUNT-2: triton_gpu.local_alloc : () -> !tt.memdesc<1x128x128xf16
+// UNPLANNED: module attributes {{.*}}"triton_amdgpu.num-stages" = 3 : i32, "triton_amdgpu.waves-per-eu" = 0 : i32
+// UNPLANNED-LABEL: tt.func @matmul_loop
+// UNPLANNED-COUNT-2: triton_gpu.local_alloc : () -> !tt.memdesc<2x128x128xf16
+
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#ALs0 = #triton_gpu.slice<{parent=#AL, dim=0}>
+#BLs0 = #triton_gpu.slice<{parent=#BL, dim=0}>
+#C = #triton_gpu.amd_mfma<{versionMajor = 3, versionMinor = 0, warpsPerCTA = [2, 2], instrShape = [32, 32], isTransposed = false}>
+#A = #triton_gpu.dot_op<{opIdx = 0, parent = #C, kWidth=4}>
+#B = #triton_gpu.dot_op<{opIdx = 1, parent = #C, kWidth=4}>
+
+module attributes {"triton_gpu.target" = "hip:gfx942", "triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.threads-per-warp" = 64 : i32} {
+tt.func @matmul_loop(%lb : index, %ub : index, %step : index,
+                  %A : !tt.ptr<f16> {tt.divisibility = 16 : i32},
+                  %B : !tt.ptr<f16> {tt.divisibility = 16 : i32}) -> tensor<128x128xf32, #C> {
+  %a_ptr_splat = tt.splat %A : !tt.ptr<f16> -> tensor<128x128x!tt.ptr<f16>, #AL>
+  %a_tmp0 = tt.make_range {end = 128: i32, start = 0: i32} : tensor<128xi32, #ALs0>
+  %a_tmp1 = tt.expand_dims %a_tmp0 {axis = 0 : i32} : tensor<128xi32, #ALs0> -> tensor<1x128xi32, #AL>
+  %a_offs = tt.broadcast %a_tmp1 : tensor<1x128xi32, #AL> -> tensor<128x128xi32, #AL>
+  %a_ptr_init = tt.addptr %a_ptr_splat, %a_offs : tensor<128x128x!tt.ptr<f16>, #AL>, tensor<128x128xi32, #AL>
+  %b_ptr_splat = tt.splat %B : !tt.ptr<f16> -> tensor<128x128x!tt.ptr<f16>, #BL>
+  %b_tmp0 = tt.make_range {end = 128: i32, start = 0: i32} : tensor<128xi32, #BLs0>
+  %b_tmp1 = tt.expand_dims %b_tmp0 {axis = 0 : i32} : tensor<128xi32, #BLs0> -> tensor<1x128xi32, #BL>
+  %b_offs = tt.broadcast %b_tmp1 : tensor<1x128xi32, #BL> -> tensor<128x128xi32, #BL>
+  %b_ptr_init = tt.addptr %b_ptr_splat, %b_offs : tensor<128x128x!tt.ptr<f16>, #BL>, tensor<128x128xi32, #BL>
+
+  %c_init = arith.constant dense<0.00e+00> : tensor<128x128xf32, #C>
+  %a_off = arith.constant dense<128> : tensor<128x128xi32, #AL>
+  %b_off = arith.constant dense<128> : tensor<128x128xi32, #BL>
+
+  %loop:3 = scf.for %iv = %lb to %ub step %step iter_args(%a_ptr = %a_ptr_init, %b_ptr = %b_ptr_init, %prev_c = %c_init) -> (tensor<128x128x!tt.ptr<f16>, #AL>, tensor<128x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>) {
+    %a_ = tt.load %a_ptr : tensor<128x128x!tt.ptr<f16>, #AL>
+    %a = triton_gpu.convert_layout %a_ : tensor<128x128xf16, #AL> -> tensor<128x128xf16, #A>
+    %b_ = tt.load %b_ptr : tensor<128x128x!tt.ptr<f16>, #BL>
+    %b = triton_gpu.convert_layout %b_ : tensor<128x128xf16, #BL> -> tensor<128x128xf16, #B>
+    %c = tt.dot %a, %b, %prev_c : tensor<128x128xf16, #A> * tensor<128x128xf16, #B> -> tensor<128x128xf32, #C>
+    %next_a_ptr = tt.addptr %a_ptr, %a_off : tensor<128x128x!tt.ptr<f16>, #AL>, tensor<128x128xi32, #AL>
+    %next_b_ptr = tt.addptr %b_ptr, %b_off : tensor<128x128x!tt.ptr<f16>, #BL>, tensor<128x128xi32, #BL>
+    scf.yield %next_a_ptr, %next_b_ptr, %c : tensor<128x128x!tt.ptr<f16>, #AL>, tensor<128x128x!tt.ptr<f16>, #BL>, tensor<128x128xf32, #C>
+  }
+  tt.return %loop#2: tensor<128x128xf32, #C>
+}
+}
@@ -201,3 +201,40 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     tt.return
   }
 }
+
+// -----
+
+// COM: FP8 operands are upcast to FP16 when DPAS does not support FP8 natively.
+// CHECK: #[[$DPAS:.+]] = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [1, 1], repCluster = [4, 2], A = [32, 16], B = [16, 32], C = [32, 32]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.min_sg_size" = 16 : i32, "triton_intel_gpu.support_dpas"} {
+  // CHECK-LABEL: fp8_dot_upcast
+  tt.func @fp8_dot_upcast(%a: tensor<128x32xf8E5M2, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x128xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>, %arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+    %zero_f32 = arith.constant dense<0.000000e+00> : tensor<128x128xf32, #blocked>
+    // CHECK: tt.fp_to_fp {{.*}} -> tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK: tt.fp_to_fp {{.*}} -> tensor<32x128xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK: tt.dot {{.*}} -> tensor<128x128xf32, #[[$DPAS]]>
+    %result = tt.dot %a, %b, %zero_f32 : tensor<128x32xf8E5M2, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x128xf8E5M2, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x128xf32, #blocked>
+    %result_ptr = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x128x!tt.ptr<f32>, #blocked>
+    tt.store %result_ptr, %result : tensor<128x128x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: FP8 operands feed the DPAS instruction directly when it supports FP8 natively.
+// CHECK: #[[$DPAS:.+]] = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 4, threadsPerWarp = 16, warpsPerCTA = [1, 1], repCluster = [4, 4]{{.*}}}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.min_sg_size" = 16 : i32, "triton_intel_gpu.support_dpas", "triton_intel_gpu.support_fp8_dpas"} {
+  // CHECK-LABEL: fp8_dot_native
+  tt.func @fp8_dot_native(%a: tensor<128x32xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %b: tensor<32x128xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>, %arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+    %zero_f32 = arith.constant dense<0.000000e+00> : tensor<128x128xf32, #blocked>
+    // CHECK-NOT: tt.fp_to_fp
+    // CHECK: tt.dot {{.*}} : tensor<128x32xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 0, parent = #[[$DPAS]], kWidth = 4}>> * tensor<32x128xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 4}>> -> tensor<128x128xf32, #[[$DPAS]]>
+    %result = tt.dot %a, %b, %zero_f32 : tensor<128x32xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x128xf8E4M3FN, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x128xf32, #blocked>
+    %result_ptr = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x128x!tt.ptr<f32>, #blocked>
+    tt.store %result_ptr, %result : tensor<128x128x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
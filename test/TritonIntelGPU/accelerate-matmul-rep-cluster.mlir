@@ -0,0 +1,14 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul | FileCheck %s
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-accelerate-matmul="max-rep-cluster-m=2 max-rep-cluster-n=1" | FileCheck %s --check-prefix=BOUNDED
+
+// COM: The cluster is the largest one filled by a 2D block load of each operand: 32 rows of A and 64 bytes of B, unless bounded.
+// CHECK: #triton_intel_gpu.dpas<{{.*}}repCluster = [4, 2]
+// BOUNDED: #triton_intel_gpu.dpas<{{.*}}repCluster = [2, 1]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4, 4], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.min_sg_size" = 16 : i32, "triton_intel_gpu.support_dpas"} {
+  tt.func public @dot(%arg0: tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>, %arg1: tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>) -> tensor<128x64xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x64xf32, #blocked>
+    %0 = tt.dot %arg0, %arg1, %cst {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<128x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<128x64xf32, #blocked>
+    tt.return %0 : tensor<128x64xf32, #blocked>
+  }
+}
@@ -0,0 +1,102 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-canonicalize-pointers | FileCheck %s
+
+// COM: The uniform part of the 32-bit offsets is added to the scalar base
+// COM: pointer, and their non-uniform part is kept in a 32-bit tensor.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @offsets_32bit(%arg0: !tt.ptr<f32>) -> tensor<256xf32, #blocked> {
+    // CHECK-LABEL: @offsets_32bit
+    // CHECK: [[C0:%.*]] = arith.constant 0 : i32
+    // CHECK: [[ZERO:%.*]] = tt.splat [[C0]] : i32 -> tensor<256xi32, #blocked>
+    // CHECK: [[BASE:%.*]] = tt.addptr %arg0, {{.*}} : !tt.ptr<f32>, i32
+    // CHECK-NOT: arith.extsi
+    // CHECK: [[OFFSET:%.*]] = arith.addi {{.*}}, [[ZERO]] : tensor<256xi32, #blocked>
+    // CHECK: [[SPLAT:%.*]] = tt.splat [[BASE]] : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    // CHECK: [[PTRS:%.*]] = tt.addptr [[SPLAT]], [[OFFSET]] : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    // CHECK: tt.load [[PTRS]]
+    %c256_i32 = arith.constant 256 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = arith.muli %0, %c256_i32 : i32
+    %2 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %3 = tt.splat %1 : i32 -> tensor<256xi32, #blocked>
+    %4 = arith.addi %3, %2 : tensor<256xi32, #blocked>
+    %5 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %6 = tt.addptr %5, %4 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    %7 = tt.load %6 : tensor<256x!tt.ptr<f32>, #blocked>
+    tt.return %7 : tensor<256xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The loops carry the scalar base pointer and the 32-bit tensor of
+// COM: offsets, and the uniform increments of the pointers bump the base.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @loop_32bit(%arg0: !tt.ptr<f32>, %arg1: i32) -> tensor<256xf32, #blocked> {
+    // CHECK-LABEL: @loop_32bit
+    // CHECK: scf.for {{.*}} iter_args({{.*}}, [[BASE:%[^ ]+]] = %arg0, [[OFFSET:%[^ ]+]] = {{.*}}) -> (tensor<256xf32, #blocked>, tensor<256x!tt.ptr<f32>, #blocked>, !tt.ptr<f32>, tensor<256xi32, #blocked>)
+    // CHECK: [[SPLAT:%.*]] = tt.splat [[BASE]] : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    // CHECK: [[PTRS:%.*]] = tt.addptr [[SPLAT]], [[OFFSET]] : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    // CHECK: tt.load [[PTRS]]
+    // CHECK: [[NEXT:%.*]] = tt.addptr [[BASE]], {{.*}} : !tt.ptr<f32>, i32
+    // CHECK: scf.yield {{.*}}, [[NEXT]], [[OFFSET]] : tensor<256xf32, #blocked>, tensor<256x!tt.ptr<f32>, #blocked>, !tt.ptr<f32>, tensor<256xi32, #blocked>
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<256xf32, #blocked>
+    %cst_0 = arith.constant dense<256> : tensor<256xi32, #blocked>
+    %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    %3:2 = scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32 iter_args(%arg3 = %cst, %arg4 = %2) -> (tensor<256xf32, #blocked>, tensor<256x!tt.ptr<f32>, #blocked>) : i32 {
+      %4 = tt.load %arg4 : tensor<256x!tt.ptr<f32>, #blocked>
+      %5 = arith.addf %arg3, %4 : tensor<256xf32, #blocked>
+      %6 = tt.addptr %arg4, %cst_0 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+      scf.yield %5, %6 : tensor<256xf32, #blocked>, tensor<256x!tt.ptr<f32>, #blocked>
+    }
+    tt.return %3#0 : tensor<256xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The offsets of functions adding 64-bit offsets to their pointers are
+// COM: accumulated in 64 bits.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @offsets_64bit(%arg0: !tt.ptr<f32>, %arg1: tensor<256xi64, #blocked>) -> tensor<256xf32, #blocked> {
+    // CHECK-LABEL: @offsets_64bit
+    // CHECK: [[C0:%.*]] = arith.constant 0 : i64
+    // CHECK: [[ZERO:%.*]] = tt.splat [[C0]] : i64 -> tensor<256xi64, #blocked>
+    // CHECK: [[OFFSET:%.*]] = arith.addi %arg1, [[ZERO]] : tensor<256xi64, #blocked>
+    // CHECK: [[SPLAT:%.*]] = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    // CHECK: [[PTRS:%.*]] = tt.addptr [[SPLAT]], [[OFFSET]] : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi64, #blocked>
+    // CHECK: tt.load [[PTRS]]
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %1 = tt.addptr %0, %arg1 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi64, #blocked>
+    %2 = tt.load %1 : tensor<256x!tt.ptr<f32>, #blocked>
+    tt.return %2 : tensor<256xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: The offsets of the `tt.pointer_range = 32` arguments are accumulated in
+// COM: 32 bits, the 64-bit offsets added to them being truncated.
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @pointer_range_32(%arg0: !tt.ptr<f32> {tt.pointer_range = 32 : i32}, %arg1: tensor<256xi64, #blocked>) -> tensor<256xf32, #blocked> {
+    // CHECK-LABEL: @pointer_range_32
+    // CHECK: [[C0:%.*]] = arith.constant 0 : i32
+    // CHECK: [[ZERO:%.*]] = tt.splat [[C0]] : i32 -> tensor<256xi32, #blocked>
+    // CHECK: [[TRUNC:%.*]] = arith.trunci %arg1 : tensor<256xi64, #blocked> to tensor<256xi32, #blocked>
+    // CHECK: [[OFFSET:%.*]] = arith.addi [[TRUNC]], [[ZERO]] : tensor<256xi32, #blocked>
+    // CHECK: [[SPLAT:%.*]] = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    // CHECK: [[PTRS:%.*]] = tt.addptr [[SPLAT]], [[OFFSET]] : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    // CHECK: tt.load [[PTRS]]
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %1 = tt.addptr %0, %arg1 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi64, #blocked>
+    %2 = tt.load %1 : tensor<256x!tt.ptr<f32>, #blocked>
+    tt.return %2 : tensor<256xf32, #blocked>
+  }
+}
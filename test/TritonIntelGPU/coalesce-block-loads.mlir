@@ -0,0 +1,90 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-coalesce-block-loads | FileCheck %s
+
+// COM: Loads of horizontally adjacent tiles are merged into a single load with 2 blocks.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: @adjacent_tiles
+  tt.func public @adjacent_tiles(%arg0: !tt.ptr<f16>, %arg1: i32) -> (tensor<16x16xf16>, tensor<16x16xf16>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c64_i64 = arith.constant 64 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %1 = arith.addi %arg1, %c16_i32 : i32
+    // CHECK: [[PTR:%.*]] = tt.make_tensor_ptr %arg0, {{.*}}, [%c0_i32, %arg1] {order = array<i32: 1, 0>} : <tensor<16x32xf16>>
+    // CHECK: [[LOAD:%.*]] = tt.load [[PTR]] {DotIdx = 1 : i32} : !tt.ptr<tensor<16x32xf16>>
+    // CHECK-NEXT: [[LHS:%.*]] = triton_intel_gpu.extract [[LOAD]][0] : tensor<16x32xf16> -> tensor<16x16xf16>
+    // CHECK-NEXT: [[RHS:%.*]] = triton_intel_gpu.extract [[LOAD]][1] : tensor<16x32xf16> -> tensor<16x16xf16>
+    // CHECK-NOT: tt.load
+    // CHECK: tt.return [[RHS]], [[LHS]]
+    %2 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %1] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %3 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %arg1] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %4 = tt.load %2 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    %5 = tt.load %3 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    tt.return %4, %5 : tensor<16x16xf16>, tensor<16x16xf16>
+  }
+}
+
+// -----
+
+// COM: Loop carried pointers advanced by the same amount are merged, the wider pointer is added to the loop.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: @loop_carried
+  tt.func public @loop_carried(%arg0: !tt.ptr<f16>) -> (tensor<16x16xf16>, tensor<16x16xf16>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %c1024_i64 = arith.constant 1024 : i64
+    %c64_i64 = arith.constant 64 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<16x16xf16>
+    // CHECK: [[INIT:%.*]] = tt.make_tensor_ptr {{.*}} : <tensor<16x32xf16>>
+    // CHECK: scf.for {{.*}} iter_args({{.*}}, [[ARG:%[a-z0-9]+]] = [[INIT]]) -> ({{.*}}, !tt.ptr<tensor<16x32xf16>>)
+    // CHECK: [[LOAD:%.*]] = tt.load [[ARG]] {DotIdx = 0 : i32} : !tt.ptr<tensor<16x32xf16>>
+    // CHECK-NEXT: triton_intel_gpu.extract [[LOAD]][0] : tensor<16x32xf16> -> tensor<16x16xf16>
+    // CHECK-NEXT: triton_intel_gpu.extract [[LOAD]][1] : tensor<16x32xf16> -> tensor<16x16xf16>
+    // CHECK-NOT: tt.load
+    // CHECK: [[NEXT:%.*]] = tt.advance [[ARG]], [%c0_i32, %c32_i32] : <tensor<16x32xf16>>
+    // CHECK: scf.yield {{.*}}, [[NEXT]] : {{.*}}, !tt.ptr<tensor<16x32xf16>>
+    %0 = tt.make_tensor_ptr %arg0, [%c64_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %1 = tt.make_tensor_ptr %arg0, [%c64_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c16_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %2:4 = scf.for %arg1 = %c0_i32 to %c1024_i32 step %c32_i32 iter_args(%arg2 = %cst, %arg3 = %cst, %arg4 = %0, %arg5 = %1) -> (tensor<16x16xf16>, tensor<16x16xf16>, !tt.ptr<tensor<16x16xf16>>, !tt.ptr<tensor<16x16xf16>>) : i32 {
+      %3 = tt.load %arg4 {DotIdx = 0 : i32} : !tt.ptr<tensor<16x16xf16>>
+      %4 = tt.load %arg5 {DotIdx = 0 : i32} : !tt.ptr<tensor<16x16xf16>>
+      %5 = arith.addf %arg2, %3 : tensor<16x16xf16>
+      %6 = arith.addf %arg3, %4 : tensor<16x16xf16>
+      %7 = tt.advance %arg4, [%c0_i32, %c32_i32] : <tensor<16x16xf16>>
+      %8 = tt.advance %arg5, [%c0_i32, %c32_i32] : <tensor<16x16xf16>>
+      scf.yield %5, %6, %7, %8 : tensor<16x16xf16>, tensor<16x16xf16>, !tt.ptr<tensor<16x16xf16>>, !tt.ptr<tensor<16x16xf16>>
+    }
+    tt.return %2#0, %2#1 : tensor<16x16xf16>, tensor<16x16xf16>
+  }
+}
+
+// -----
+
+// COM: Tiles that aren't adjacent, column-major tiles, and loads separated by a store aren't merged.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: @not_coalesced
+  tt.func public @not_coalesced(%arg0: !tt.ptr<f16>, %arg1: tensor<16x16xf16>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c64_i64 = arith.constant 64 : i64
+    %c1_i64 = arith.constant 1 : i64
+    // CHECK-NOT: tensor<16x32xf16>
+    // CHECK-NOT: triton_intel_gpu.extract
+    %0 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %1 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %c32_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %2 = tt.load %0 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    %3 = tt.load %1 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    %4 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c1_i64, %c64_i64], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : <tensor<16x16xf16>>
+    %5 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c1_i64, %c64_i64], [%c0_i32, %c16_i32] {order = array<i32: 0, 1>} : <tensor<16x16xf16>>
+    %6 = tt.load %4 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    %7 = tt.load %5 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+    %8 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %c16_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %9 = tt.load %0 {DotIdx = 0 : i32} : !tt.ptr<tensor<16x16xf16>>
+    tt.store %8, %arg1 : !tt.ptr<tensor<16x16xf16>>
+    %10 = tt.load %8 {DotIdx = 0 : i32} : !tt.ptr<tensor<16x16xf16>>
+    tt.return
+  }
+}
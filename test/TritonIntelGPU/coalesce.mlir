@@ -0,0 +1,100 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-coalesce | FileCheck %s
+
+// COM: Rows contiguous over several sub-group chunks are given to consecutive lanes, so that they are accessed with SIMD block messages.
+// CHECK: [[BLOCK_LAYOUT:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: @block_load
+// CHECK: tt.load {{.*}} : tensor<64x64x!tt.ptr<f32>, [[BLOCK_LAYOUT]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @block_load(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) -> tensor<64x64xf32, #blocked> {
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> -> tensor<64x1xi32, #blocked>
+    %2 = tt.splat %arg1 : i32 -> tensor<64x1xi32, #blocked>
+    %3 = arith.muli %1, %2 : tensor<64x1xi32, #blocked>
+    %4 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %5 = tt.expand_dims %4 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %6 = tt.broadcast %3 : tensor<64x1xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %7 = tt.broadcast %5 : tensor<1x64xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %8 = arith.addi %6, %7 : tensor<64x64xi32, #blocked>
+    %9 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x64x!tt.ptr<f32>, #blocked>
+    %10 = tt.addptr %9, %8 : tensor<64x64x!tt.ptr<f32>, #blocked>, tensor<64x64xi32, #blocked>
+    %11 = tt.load %10 : tensor<64x64x!tt.ptr<f32>, #blocked>
+    tt.return %11 : tensor<64x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: A mask that is not uniform across the sub-group chunks prevents SIMD block messages, each work-item accesses its own vector.
+// CHECK: [[VEC_LAYOUT:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: @masked_load
+// CHECK: tt.load {{.*}} : tensor<64x64x!tt.ptr<f32>, [[VEC_LAYOUT]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @masked_load(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}, %arg2: i32) -> tensor<64x64xf32, #blocked> {
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> -> tensor<64x1xi32, #blocked>
+    %2 = tt.splat %arg1 : i32 -> tensor<64x1xi32, #blocked>
+    %3 = arith.muli %1, %2 : tensor<64x1xi32, #blocked>
+    %4 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %5 = tt.expand_dims %4 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %6 = tt.broadcast %3 : tensor<64x1xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %7 = tt.broadcast %5 : tensor<1x64xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %8 = arith.addi %6, %7 : tensor<64x64xi32, #blocked>
+    %9 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x64x!tt.ptr<f32>, #blocked>
+    %10 = tt.addptr %9, %8 : tensor<64x64x!tt.ptr<f32>, #blocked>, tensor<64x64xi32, #blocked>
+    %12 = tt.splat %arg2 : i32 -> tensor<1x64xi32, #blocked>
+    %13 = arith.cmpi slt, %5, %12 : tensor<1x64xi32, #blocked>
+    %14 = tt.broadcast %13 : tensor<1x64xi1, #blocked> -> tensor<64x64xi1, #blocked>
+    %11 = tt.load %10, %14 : tensor<64x64x!tt.ptr<f32>, #blocked>
+    tt.return %11 : tensor<64x64xf32, #blocked>
+  }
+}
+
+// -----
+
+// COM: SIMD block messages of 4 elements per lane would need more messages than 128 bits vectors of 16 bits elements.
+// CHECK: [[VEC_LAYOUT:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: @narrow_load
+// CHECK: tt.load {{.*}} : tensor<64x64x!tt.ptr<f16>, [[VEC_LAYOUT]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @narrow_load(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) -> tensor<64x64xf16, #blocked> {
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> -> tensor<64x1xi32, #blocked>
+    %2 = tt.splat %arg1 : i32 -> tensor<64x1xi32, #blocked>
+    %3 = arith.muli %1, %2 : tensor<64x1xi32, #blocked>
+    %4 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %5 = tt.expand_dims %4 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %6 = tt.broadcast %3 : tensor<64x1xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %7 = tt.broadcast %5 : tensor<1x64xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %8 = arith.addi %6, %7 : tensor<64x64xi32, #blocked>
+    %9 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>, #blocked>
+    %10 = tt.addptr %9, %8 : tensor<64x64x!tt.ptr<f16>, #blocked>, tensor<64x64xi32, #blocked>
+    %11 = tt.load %10 : tensor<64x64x!tt.ptr<f16>, #blocked>
+    tt.return %11 : tensor<64x64xf16, #blocked>
+  }
+}
+
+// -----
+
+// COM: The rows of a gather are only 4 bytes aligned, which is enough for SIMD block reads.
+// CHECK: [[BLOCK_LAYOUT:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: @gather_load
+// CHECK: tt.load {{.*}} : tensor<64x64x!tt.ptr<f16>, [[BLOCK_LAYOUT]]>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [16, 1], warpsPerCTA = [1, 4], order = [0, 1]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @gather_load(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: tensor<64x1xi32, #blocked>, %arg2: i32 {tt.divisibility = 2 : i32}) -> tensor<64x64xf16, #blocked> {
+    %0 = tt.splat %arg2 : i32 -> tensor<64x1xi32, #blocked>
+    %1 = arith.muli %arg1, %0 : tensor<64x1xi32, #blocked>
+    %2 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %3 = tt.expand_dims %2 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %4 = tt.broadcast %1 : tensor<64x1xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %5 = tt.broadcast %3 : tensor<1x64xi32, #blocked> -> tensor<64x64xi32, #blocked>
+    %6 = arith.addi %4, %5 : tensor<64x64xi32, #blocked>
+    %7 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>, #blocked>
+    %8 = tt.addptr %7, %6 : tensor<64x64x!tt.ptr<f16>, #blocked>, tensor<64x64xi32, #blocked>
+    %9 = tt.load %8 : tensor<64x64x!tt.ptr<f16>, #blocked>
+    tt.return %9 : tensor<64x64xf16, #blocked>
+  }
+}
@@ -1835,12 +1835,12 @@ tt.func @reduce_to_scalar(%ptr: tensor<1024x!tt.ptr<f32>, #blocked>) -> (f32, i3
 module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
 // CHECK-LABEL: whileop
 //       CHECK: %[[L:.+]] = tt.load %{{.*}} : tensor<1024x!tt.ptr<f32>, #blocked>
-//       CHECK: %[[W:.+]] = scf.while (%[[I:.+]] = %[[L]], %{{.*}} = %{{.*}}) : (tensor<1024xf32, #blocked>, i1) -> tensor<1024xf32, #blocked> {
+//       CHECK: %[[W:.+]] = scf.while (%[[I:.+]] = %[[L]]{{.*}}) : (tensor<1024xf32, #blocked>{{.*}}) -> tensor<1024xf32, #blocked> {
 //       CHECK:   scf.condition(%{{.*}}) %[[I]] : tensor<1024xf32, #blocked>
 //       CHECK: } do {
 //       CHECK: ^bb0(%[[ARG1:.+]]: tensor<1024xf32, #blocked>):
 //       CHECK:    %[[ADD:.+]] = arith.addf %[[ARG1]], %[[ARG1]] : tensor<1024xf32, #blocked>
-//       CHECK:    scf.yield %[[ADD]], %{{.*}} : tensor<1024xf32, #blocked>, i1
+//       CHECK:    scf.yield %[[ADD]]{{.*}} : tensor<1024xf32, #blocked>
 //       CHECK:  }
 //       CHECK:  tt.store %{{.*}}, %[[W]] : tensor<1024x!tt.ptr<f32>, #blocked>
 tt.func @whileop(%ptr: tensor<1024x!tt.ptr<f32>, #blocked>, %cond: i1) {
@@ -2297,3 +2297,102 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 :
     tt.return %3 : tensor<128x256xf32, #blocked>
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 1], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Verify that the convert to the dot operand layout is hoisted above the
+  // dequantization of the packed weights: the convert moves the loaded i8 data
+  // and the unpacking runs in the dot operand layout.
+  // CHECK: #[[$DPAS:.+]] = #triton_intel_gpu.dpas
+  // CHECK-LABEL: @hoist_convert_above_dequant
+  tt.func public @hoist_convert_above_dequant(%arg0: tensor<32x64x!tt.ptr<i8>, #blocked>, %arg1: f16) -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>> {
+    // CHECK: %[[LOAD:.+]] = tt.load
+    // CHECK: %[[CVT:.+]] = triton_gpu.convert_layout %[[LOAD]] : tensor<32x64xi8, #{{.+}}> -> tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK: arith.shrsi %[[CVT]], {{.*}} : tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK: arith.sitofp {{.*}} : tensor<32x64xi8, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>> to tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK: arith.mulf {{.*}} : tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[$DPAS]], kWidth = 2}>>
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK: tt.return
+    %cst = arith.constant dense<4> : tensor<32x64xi8, #blocked>
+    %0 = tt.load %arg0 : tensor<32x64x!tt.ptr<i8>, #blocked>
+    %1 = arith.shrsi %0, %cst : tensor<32x64xi8, #blocked>
+    %2 = arith.sitofp %1 : tensor<32x64xi8, #blocked> to tensor<32x64xf16, #blocked>
+    %3 = tt.splat %arg1 : f16 -> tensor<32x64xf16, #blocked>
+    %4 = arith.mulf %2, %3 : tensor<32x64xf16, #blocked>
+    %5 = triton_gpu.convert_layout %4 : tensor<32x64xf16, #blocked> -> tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+    tt.return %5 : tensor<32x64xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [2, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 1], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Verify that the DPAS layout of an accumulator carried by a while loop is
+  // propagated through the loop regions.
+  // CHECK: #[[$DPAS:.+]] = #triton_intel_gpu.dpas
+  // CHECK-LABEL: @while_dpas_accumulator
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: scf.while ({{.*}}) : (tensor<32x32xf32, #[[$DPAS]]>, i32) -> (tensor<32x32xf32, #[[$DPAS]]>, i32)
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.dot {{.*}} -> tensor<32x32xf32, #[[$DPAS]]>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.return
+  tt.func public @while_dpas_accumulator(%arg0: tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>>, %arg1: tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>>, %arg2: i32) -> tensor<32x32xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32, #blocked>
+    %0:2 = scf.while (%arg3 = %cst, %arg4 = %c0_i32) : (tensor<32x32xf32, #blocked>, i32) -> (tensor<32x32xf32, #blocked>, i32) {
+      %1 = arith.cmpi slt, %arg4, %arg2 : i32
+      scf.condition(%1) %arg3, %arg4 : tensor<32x32xf32, #blocked>, i32
+    } do {
+    ^bb0(%arg3: tensor<32x32xf32, #blocked>, %arg4: i32):
+      %2 = triton_gpu.convert_layout %arg3 : tensor<32x32xf32, #blocked> -> tensor<32x32xf32, #dpas>
+      %3 = tt.dot %arg0, %arg1, %2 : tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>> * tensor<32x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>> -> tensor<32x32xf32, #dpas>
+      %4 = triton_gpu.convert_layout %3 : tensor<32x32xf32, #dpas> -> tensor<32x32xf32, #blocked>
+      %5 = arith.addi %arg4, %c1_i32 : i32
+      scf.yield %4, %5 : tensor<32x32xf32, #blocked>, i32
+    }
+    %6 = triton_gpu.convert_layout %0#0 : tensor<32x32xf32, #blocked> -> tensor<32x32xf32, #dpas>
+    tt.return %6 : tensor<32x32xf32, #dpas>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // Verify that a convert of a while loop result is rematerialized through the
+  // loop regions.
+  // CHECK: #[[$BLOCKED1:.+]] = #triton_gpu.blocked<{sizePerThread = [1]
+  // CHECK-LABEL: @while_backward_remat
+  // CHECK: %[[W:.+]]:{{[0-9]+}} = scf.while
+  // CHECK:   arith.addf {{.*}} : tensor<1024xf32, #[[$BLOCKED1]]>
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store %{{.*}}, %[[W]]#{{[0-9]+}} : tensor<1024x!tt.ptr<f32>, #[[$BLOCKED1]]>
+  tt.func public @while_backward_remat(%arg0: tensor<1024x!tt.ptr<f32>, #blocked1>, %arg1: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<1.000000e+00> : tensor<1024xf32, #blocked>
+    %0:2 = scf.while (%arg2 = %cst, %arg3 = %c0_i32) : (tensor<1024xf32, #blocked>, i32) -> (tensor<1024xf32, #blocked>, i32) {
+      %1 = arith.cmpi slt, %arg3, %arg1 : i32
+      scf.condition(%1) %arg2, %arg3 : tensor<1024xf32, #blocked>, i32
+    } do {
+    ^bb0(%arg2: tensor<1024xf32, #blocked>, %arg3: i32):
+      %2 = arith.addf %arg2, %arg2 : tensor<1024xf32, #blocked>
+      %3 = arith.addi %arg3, %c1_i32 : i32
+      scf.yield %2, %3 : tensor<1024xf32, #blocked>, i32
+    }
+    %4 = triton_gpu.convert_layout %0#0 : tensor<1024xf32, #blocked> -> tensor<1024xf32, #blocked1>
+    tt.store %arg0, %4 : tensor<1024x!tt.ptr<f32>, #blocked1>
+    tt.return
+  }
+}
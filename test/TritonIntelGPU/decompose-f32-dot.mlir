@@ -0,0 +1,58 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-decompose-f32-dot | FileCheck %s
+
+module attributes {triton_intel_gpu.support_dpas} {
+  // CHECK-LABEL: tt.func @tf32x3(
+  // CHECK-SAME:      %[[A:.*]]: tensor<32x16xf32>, %[[B:.*]]: tensor<16x32xf32>, %[[C:.*]]: tensor<32x32xf32>)
+  tt.func @tf32x3(%a: tensor<32x16xf32>, %b: tensor<16x32xf32>, %c: tensor<32x32xf32>) -> tensor<32x32xf32> {
+    // CHECK:         %[[A_BITS:.*]] = arith.bitcast %[[A]] : tensor<32x16xf32> to tensor<32x16xi32>
+    // CHECK:         %[[A_HI_BITS:.*]] = arith.andi %[[A_BITS]], %{{.*}} : tensor<32x16xi32>
+    // CHECK:         %[[A_HI:.*]] = arith.bitcast %[[A_HI_BITS]] : tensor<32x16xi32> to tensor<32x16xf32>
+    // CHECK:         %[[A_LO:.*]] = arith.subf %[[A]], %[[A_HI]] : tensor<32x16xf32>
+    // CHECK:         %[[B_HI:.*]] = arith.bitcast %{{.*}} : tensor<16x32xi32> to tensor<16x32xf32>
+    // CHECK:         %[[B_LO:.*]] = arith.subf %[[B]], %[[B_HI]] : tensor<16x32xf32>
+    // CHECK:         %[[D0:.*]] = tt.dot %[[A_LO]], %[[B_HI]], %[[C]], inputPrecision = tf32
+    // CHECK:         %[[D1:.*]] = tt.dot %[[A_HI]], %[[B_LO]], %[[D0]], inputPrecision = tf32
+    // CHECK:         %[[D2:.*]] = tt.dot %[[A_HI]], %[[B_HI]], %[[D1]], inputPrecision = tf32
+    // CHECK:         tt.return %[[D2]]
+    %0 = tt.dot %a, %b, %c, inputPrecision = tf32x3 : tensor<32x16xf32> * tensor<16x32xf32> -> tensor<32x32xf32>
+    tt.return %0 : tensor<32x32xf32>
+  }
+
+  // CHECK-LABEL: tt.func @bf16x3(
+  // CHECK-SAME:      %[[A:.*]]: tensor<32x16xf32>, %[[B:.*]]: tensor<16x32xf32>, %[[C:.*]]: tensor<32x32xf32>)
+  tt.func @bf16x3(%a: tensor<32x16xf32>, %b: tensor<16x32xf32>, %c: tensor<32x32xf32>) -> tensor<32x32xf32> {
+    // CHECK:         %[[A_HI:.*]] = arith.truncf %[[A]] : tensor<32x16xf32> to tensor<32x16xbf16>
+    // CHECK:         %[[A_HI_F32:.*]] = arith.extf %[[A_HI]] : tensor<32x16xbf16> to tensor<32x16xf32>
+    // CHECK:         %[[A_REST:.*]] = arith.subf %[[A]], %[[A_HI_F32]] : tensor<32x16xf32>
+    // CHECK:         %[[A_LO:.*]] = arith.truncf %[[A_REST]] : tensor<32x16xf32> to tensor<32x16xbf16>
+    // CHECK:         %[[B_HI:.*]] = arith.truncf %[[B]] : tensor<16x32xf32> to tensor<16x32xbf16>
+    // CHECK:         %[[B_LO:.*]] = arith.truncf %{{.*}} : tensor<16x32xf32> to tensor<16x32xbf16>
+    // CHECK:         %[[D0:.*]] = tt.dot %[[A_LO]], %[[B_HI]], %[[C]] : tensor<32x16xbf16> * tensor<16x32xbf16> -> tensor<32x32xf32>
+    // CHECK:         %[[D1:.*]] = tt.dot %[[A_HI]], %[[B_LO]], %[[D0]] : tensor<32x16xbf16> * tensor<16x32xbf16> -> tensor<32x32xf32>
+    // CHECK:         %[[D2:.*]] = tt.dot %[[A_HI]], %[[B_HI]], %[[D1]] : tensor<32x16xbf16> * tensor<16x32xbf16> -> tensor<32x32xf32>
+    // CHECK:         tt.return %[[D2]]
+    %0 = tt.dot %a, %b, %c, inputPrecision = bf16x3 : tensor<32x16xf32> * tensor<16x32xf32> -> tensor<32x32xf32>
+    tt.return %0 : tensor<32x32xf32>
+  }
+
+  // CHECK-LABEL: tt.func @ieee(
+  // CHECK-NEXT:    tt.dot %{{.*}}, %{{.*}}, %{{.*}} : tensor<32x16xf32>
+  // CHECK-NEXT:    tt.return
+  tt.func @ieee(%a: tensor<32x16xf32>, %b: tensor<16x32xf32>, %c: tensor<32x32xf32>) -> tensor<32x32xf32> {
+    %0 = tt.dot %a, %b, %c, inputPrecision = ieee : tensor<32x16xf32> * tensor<16x32xf32> -> tensor<32x32xf32>
+    tt.return %0 : tensor<32x32xf32>
+  }
+}
+
+// -----
+
+module {
+  // COM: Without DPAS, the dot is lowered with FMAs.
+  // CHECK-LABEL: tt.func @no_dpas(
+  // CHECK-NEXT:    tt.dot %{{.*}}, %{{.*}}, %{{.*}}, inputPrecision = tf32x3
+  // CHECK-NEXT:    tt.return
+  tt.func @no_dpas(%a: tensor<32x16xf32>, %b: tensor<16x32xf32>, %c: tensor<32x32xf32>) -> tensor<32x32xf32> {
+    %0 = tt.dot %a, %b, %c, inputPrecision = tf32x3 : tensor<32x16xf32> * tensor<16x32xf32> -> tensor<32x32xf32>
+    tt.return %0 : tensor<32x32xf32>
+  }
+}
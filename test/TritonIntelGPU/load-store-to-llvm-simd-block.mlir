@@ -0,0 +1,93 @@
+// RUN: triton-opt %s -split-input-file --convert-triton-intel-gpu-to-llvm | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Each lane accesses 4 elements, one from each 16 elements chunk.
+  // CHECK-LABEL: @simd_block_load_store_vec4
+  tt.func public @simd_block_load_store_vec4(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+    %c64_i32 = arith.constant 64 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = arith.muli %0, %c64_i32 : i32
+    %2 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #blocked>
+    %3 = tt.splat %1 : i32 -> tensor<64xi32, #blocked>
+    %4 = arith.addi %3, %2 : tensor<64xi32, #blocked>
+    %5 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>, #blocked>
+    %6 = tt.addptr %5, %4 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+    // CHECK:     [[OFFSET:%.*]] = llvm.sub {{.*}} : i32
+    // CHECK:     [[BASE:%.*]] = llvm.getelementptr {{.*}}{{\[}}[[OFFSET]]] : (!llvm.ptr<1>, i32) -> !llvm.ptr<1>, i32
+    // CHECK:     llvm.call spir_funccc @_Z30intel_sub_group_block_read_ui4PU3AS1j([[BASE]]) {{.*}} : (!llvm.ptr<1>) -> vector<4xi32>
+    // CHECK-NOT: llvm.load
+    %7 = tt.load %6 : tensor<64x!tt.ptr<f32>, #blocked>
+    %8 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>, #blocked>
+    %9 = tt.addptr %8, %4 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+    // CHECK:     llvm.call spir_funccc @_Z31intel_sub_group_block_write_ui4PU3AS1jDv4_j({{.*}}) {{.*}} : (!llvm.ptr<1>, vector<4xi32>) -> ()
+    // CHECK-NOT: llvm.store
+    tt.store %9, %7 : tensor<64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The chunks accessed by a lane are not consecutive, each one is accessed with its own block message.
+  // CHECK-LABEL: @simd_block_load_store_vec1
+  tt.func public @simd_block_load_store_vec1(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}) {
+    %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<256x!tt.ptr<f16>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f16>, #blocked>, tensor<256xi32, #blocked>
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z29intel_sub_group_block_read_usPU3AS1t({{.*}}) {{.*}} : (!llvm.ptr<1>) -> i16
+    %3 = tt.load %2 : tensor<256x!tt.ptr<f16>, #blocked>
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z30intel_sub_group_block_write_usPU3AS1tt({{.*}}) {{.*}} : (!llvm.ptr<1>, i16) -> ()
+    tt.store %2, %3 : tensor<256x!tt.ptr<f16>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Block messages are not used for masks that are not uniform across the sub-group, or writes to addresses that are not 16 bytes aligned.
+  // CHECK-LABEL: @simd_block_load_store_fallback
+  tt.func public @simd_block_load_store_fallback(%arg0: !tt.ptr<f32> {tt.divisibility = 4 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg2: i32) {
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #blocked>
+    %1 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+    %3 = tt.splat %arg2 : i32 -> tensor<64xi32, #blocked>
+    %4 = arith.cmpi slt, %0, %3 : tensor<64xi32, #blocked>
+    // CHECK-NOT: intel_sub_group_block_read
+    // CHECK:     llvm.load {{.*}} : !llvm.ptr<1> -> i32
+    %5 = tt.load %2, %4 : tensor<64x!tt.ptr<f32>, #blocked>
+    %6 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>, #blocked>
+    %7 = tt.addptr %6, %0 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+    // CHECK-NOT: intel_sub_group_block_write
+    // CHECK:     llvm.store {{.*}} : vector<1xi32>, !llvm.ptr<1>
+    tt.store %7, %5 : tensor<64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Block reads only need 4 bytes aligned addresses, each row of a gather is read with its own block message.
+  // CHECK-LABEL: @simd_block_load_gather_rows
+  tt.func public @simd_block_load_gather_rows(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: tensor<4x1xi32, #blocked>, %arg2: i32) -> tensor<4x64xf32, #blocked> {
+    %0 = tt.splat %arg2 : i32 -> tensor<4x1xi32, #blocked>
+    %1 = arith.muli %arg1, %0 : tensor<4x1xi32, #blocked>
+    %2 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %3 = tt.expand_dims %2 {axis = 0 : i32} : tensor<64xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x64xi32, #blocked>
+    %4 = tt.broadcast %1 : tensor<4x1xi32, #blocked> -> tensor<4x64xi32, #blocked>
+    %5 = tt.broadcast %3 : tensor<1x64xi32, #blocked> -> tensor<4x64xi32, #blocked>
+    %6 = arith.addi %4, %5 : tensor<4x64xi32, #blocked>
+    %7 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<4x64x!tt.ptr<f32>, #blocked>
+    %8 = tt.addptr %7, %6 : tensor<4x64x!tt.ptr<f32>, #blocked>, tensor<4x64xi32, #blocked>
+    // CHECK-COUNT-4: llvm.call spir_funccc @_Z30intel_sub_group_block_read_ui4PU3AS1j({{.*}}) {{.*}} : (!llvm.ptr<1>) -> vector<4xi32>
+    // CHECK-NOT: llvm.load
+    %9 = tt.load %8 : tensor<4x64x!tt.ptr<f32>, #blocked>
+    tt.return %9 : tensor<4x64xf32, #blocked>
+  }
+}
@@ -1,4 +1,4 @@
-// RUN: triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s --implicit-check-not=llvm.inline_asm
+// RUN: TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=0 triton-opt %s -split-input-file --intel-allocate-shared-memory --convert-triton-intel-gpu-to-llvm | FileCheck %s --implicit-check-not=llvm.inline_asm
 
 // CHECK-DAG: llvm.func spir_funccc @_Z38intel_sub_group_f16_f16_matrix_mad_k16Dv8_sDv8_iDv8_f(vector<8xi16>, vector<8xi32>, vector<8xf32>) -> vector<8xf32> attributes {convergent, memory_effects = #llvm.memory_effects<other = none, argMem = none, inaccessibleMem = none>, no_unwind, will_return}
 // CHECK-DAG: llvm.func spir_funccc @_Z41intel_sub_group_2d_block_read_16b_8r16x2cPU3AS1viiiDv2_iPt(!llvm.ptr<1> {llvm.nonnull, llvm.readonly}, i32, i32, i32, vector<2xi32>, !llvm.ptr {llvm.nonnull, llvm.writeonly}) attributes {no_unwind, will_return}
@@ -255,3 +255,48 @@ module attributes {"triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-war
       tt.return
   }
 }
+
+// -----
+
+// CHECK:   llvm.func spir_funccc @_Z51intel_sub_group_2d_block_read_transpose_32b_16r4x1cPU3AS1viiiDv2_iPj
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [1, 1], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+#dot_a = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-warps" = 1 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL:   llvm.func spir_kernelcc @column_major_dot_a
+  tt.func public @column_major_dot_a(%arg0: !tt.ptr<f16>, %col_stride: i64) {
+      %c64_i64 = arith.constant 64 : i64
+      %c1_i64 = arith.constant 1 : i64
+      %c0_i32 = arith.constant 0 : i32
+      %21 = tt.make_tensor_ptr %arg0, [%c64_i64, %c64_i64], [%c1_i64, %col_stride], [%c0_i32, %c0_i32] {order = array<i32: 0, 1>} : <tensor<16x32xf16, #dot_a>>
+      // COM: Each load returns the pairs of rows of one column per lane, which are bitcast to the 16-bit elements of
+      // COM: one A operand.
+      // CHECK:    [[LOAD:%.*]] = llvm.call spir_funccc @_Z51intel_sub_group_2d_block_read_transpose_32b_16r4x1cPU3AS1viiiDv2_iPj
+      // CHECK:    [[VAL:%.*]] = llvm.bitcast [[LOAD]] : vector<4xi32> to vector<8xi16>
+      // CHECK:    llvm.shufflevector [[VAL]], [[VAL]] [0, 1, 2, 3, 4, 5, 6, 7] : vector<8xi16>
+      // CHECK-COUNT-3:    llvm.call spir_funccc @_Z51intel_sub_group_2d_block_read_transpose_32b_16r4x1cPU3AS1viiiDv2_iPj
+      // CHECK-NOT:    llvm.call spir_funccc @_Z51intel_sub_group_2d_block_read_transpose_32b_16r4x1cPU3AS1viiiDv2_iPj
+      %45 = tt.load %21 {triton_intel_gpu.block_io = "column_major"} : !tt.ptr<tensor<16x32xf16, #dot_a>>
+      tt.return
+  }
+}
+
+// -----
+
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [1, 1], repCluster = [4, 2], A = [32, 16], B = [16, 32], C = [32, 32]}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth=2}>
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL:   llvm.func spir_kernelcc @indirect_base_block_load(
+  tt.func public @indirect_base_block_load(%arg0: !tt.ptr<f16>, %arg1: i64, %arg2: i64, %arg3: i64) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    // The base is rounded down to 64 bytes before the 2D block load.
+    // CHECK:           [[BASE_INT:%.*]] = llvm.ptrtoint {{.*}} : !llvm.ptr<1> to i64
+    // CHECK:           [[MISALIGNMENT:%.*]] = llvm.and [[BASE_INT]], {{.*}} : i64
+    // CHECK:           [[ALIGNED:%.*]] = llvm.sub [[BASE_INT]], [[MISALIGNMENT]] : i64
+    // CHECK:           [[BASE:%.*]] = llvm.inttoptr [[ALIGNED]] : i64 to !llvm.ptr<1>
+    // CHECK:           llvm.call spir_funccc @_Z52intel_sub_group_2d_block_read_transform_16b_32r16x2cPU3AS1viiiDv2_iPj([[BASE]],
+    %ptrB = tt.make_tensor_ptr %arg0, [%arg2, %arg1], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x32xf16, #dot1>>
+    %B = tt.load %ptrB {boundaryCheck = array<i32: 0>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major", triton_intel_gpu.block_io_indirect_base} : !tt.ptr<tensor<32x32xf16, #dot1>>
+    tt.return
+  }
+}
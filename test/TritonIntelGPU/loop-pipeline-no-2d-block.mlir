@@ -0,0 +1,54 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-pipeline="num-stages=2" | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-pipeline="num-stages=4 slm-size=65536" | FileCheck %s --check-prefix=SLM-BOUND
+
+// COM: Without 2D block messages, dot operands loaded with a blocked layout are staged through shared local memory by default.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [2, 2], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [1, 4], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth=2}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth=2}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @matmul_kernel
+  tt.func public @matmul_kernel(%arg0: tensor<64x32x!tt.ptr<f16>, #blocked>, %arg1: tensor<32x256x!tt.ptr<f16>, #blocked1>, %arg2: i32) -> tensor<64x256xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<32> : tensor<64x32xi32, #blocked>
+    %cst_0 = arith.constant dense<8192> : tensor<32x256xi32, #blocked1>
+    %cst_1 = arith.constant dense<0.000000e+00> : tensor<64x256xf32, #dpas>
+    // COM: Only three buffers of both operands (60 KB) fit in 64 KB of shared local memory.
+    // SLM-BOUND: triton_gpu.local_alloc : () -> !tt.memdesc<3x64x32xf16
+    // SLM-BOUND: triton_gpu.local_alloc : () -> !tt.memdesc<3x32x256xf16
+    // CHECK: [[ABUF:%.*]] = triton_gpu.local_alloc : () -> !tt.memdesc<2x64x32xf16, #{{.*}}, #triton_gpu.shared_memory, mutable>
+    // CHECK: [[BBUF:%.*]] = triton_gpu.local_alloc : () -> !tt.memdesc<2x32x256xf16, #{{.*}}, #triton_gpu.shared_memory, mutable>
+    // COM: The prologue fills the buffers of the first iteration.
+    // CHECK-COUNT-2: triton_gpu.local_store
+    // CHECK: scf.for
+    // CHECK: tt.load {{.*}} : tensor<64x32x!tt.ptr<f16>, #{{.*}}>
+    // CHECK: [[ASUB:%.*]] = triton_gpu.memdesc_subview [[ABUF]]
+    // CHECK: triton_gpu.local_store {{.*}}, [[ASUB]]
+    // CHECK: tt.load {{.*}} : tensor<32x256x!tt.ptr<f16>, #{{.*}}>
+    // CHECK: [[BSUB:%.*]] = triton_gpu.memdesc_subview [[BBUF]]
+    // CHECK: triton_gpu.local_store {{.*}}, [[BSUB]]
+    // CHECK: [[AVIEW:%.*]] = triton_gpu.memdesc_subview [[ABUF]]
+    // CHECK: [[A:%.*]] = triton_gpu.local_load [[AVIEW]] : !tt.memdesc<64x32xf16, #{{.*}}, #triton_gpu.shared_memory, mutable> -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, {{.*}}}>>
+    // CHECK: [[BVIEW:%.*]] = triton_gpu.memdesc_subview [[BBUF]]
+    // CHECK: [[B:%.*]] = triton_gpu.local_load [[BVIEW]] : !tt.memdesc<32x256xf16, #{{.*}}, #triton_gpu.shared_memory, mutable> -> tensor<32x256xf16, #triton_gpu.dot_op<{opIdx = 1, {{.*}}}>>
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK: tt.dot [[A]], [[B]]
+    // CHECK: scf.yield
+    // CHECK: triton_gpu.local_dealloc [[BBUF]]
+    // CHECK: triton_gpu.local_dealloc [[ABUF]]
+    %0:3 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst_1, %arg5 = %arg0, %arg6 = %arg1) -> (tensor<64x256xf32, #dpas>, tensor<64x32x!tt.ptr<f16>, #blocked>, tensor<32x256x!tt.ptr<f16>, #blocked1>) : i32 {
+      %1 = tt.load %arg5 : tensor<64x32x!tt.ptr<f16>, #blocked>
+      %2 = tt.load %arg6 : tensor<32x256x!tt.ptr<f16>, #blocked1>
+      %3 = triton_gpu.convert_layout %1 : tensor<64x32xf16, #blocked> -> tensor<64x32xf16, #dot0>
+      %4 = triton_gpu.convert_layout %2 : tensor<32x256xf16, #blocked1> -> tensor<32x256xf16, #dot1>
+      %5 = tt.dot %3, %4, %arg4, inputPrecision = tf32 : tensor<64x32xf16, #dot0> * tensor<32x256xf16, #dot1> -> tensor<64x256xf32, #dpas>
+      %6 = tt.addptr %arg5, %cst : tensor<64x32x!tt.ptr<f16>, #blocked>, tensor<64x32xi32, #blocked>
+      %7 = tt.addptr %arg6, %cst_0 : tensor<32x256x!tt.ptr<f16>, #blocked1>, tensor<32x256xi32, #blocked1>
+      scf.yield %5, %6, %7 : tensor<64x256xf32, #dpas>, tensor<64x32x!tt.ptr<f16>, #blocked>, tensor<32x256x!tt.ptr<f16>, #blocked1>
+    }
+    tt.return %0#0 : tensor<64x256xf32, #dpas>
+  }
+}
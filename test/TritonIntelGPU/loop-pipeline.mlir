@@ -185,3 +185,57 @@ module attributes {"triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-wa
     tt.return
   }
 }
+
+// -----
+
+// COM: Test that the tile loop of a persistent matmul kernel is pipelined, so that the prefetches of the next tile are issued before the store of the current one.
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 8], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth=2}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth=2}>
+
+module attributes {"triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.support_sg_2d_block"} {
+  tt.func public @persistent_matmul_kernel(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg2: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg3: i32 {tt.divisibility = 16 : i32}, %arg4: i32 {tt.divisibility = 16 : i32}, %arg5: i32 {tt.divisibility = 16 : i32}, %arg6: i32 {tt.divisibility = 16 : i32}) {
+    // CHECK-LABEL:   tt.func public @persistent_matmul_kernel
+    // CHECK-COUNT-4:   triton_intel_gpu.prefetch
+    // CHECK:           scf.for
+    // CHECK:             scf.for
+    // CHECK-COUNT-2:       triton_intel_gpu.prefetch
+    // CHECK:               tt.dot
+    // CHECK:               scf.yield
+    // CHECK-COUNT-4:     triton_intel_gpu.prefetch
+    // CHECK:             tt.store
+    // CHECK:             scf.yield
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x256xf32, #dpas>
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c64_i32 = arith.constant 64 : i32
+    %c128_i32 = arith.constant 128 : i32
+    %c256_i32 = arith.constant 256 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = tt.get_num_programs x : i32
+    %2 = arith.divsi %arg4, %c256_i32 : i32
+    %3 = arith.extsi %arg3 : i32 to i64
+    %4 = arith.extsi %arg4 : i32 to i64
+    %5 = arith.extsi %arg5 : i32 to i64
+    %6 = arith.extsi %arg6 : i32 to i64
+    scf.for %arg7 = %0 to %arg6 step %1  : i32 {
+      %7 = arith.divsi %arg7, %2 : i32
+      %8 = arith.remsi %arg7, %2 : i32
+      %9 = arith.muli %7, %c128_i32 : i32
+      %10 = arith.muli %8, %c256_i32 : i32
+      %11 = tt.make_tensor_ptr %arg0, [%3, %5], [%5, %c1_i64], [%9, %c0_i32] {order = array<i32: 1, 0>} : <tensor<128x64xf16, #dot0>>
+      %12 = tt.make_tensor_ptr %arg1, [%5, %4], [%4, %c1_i64], [%c0_i32, %10] {order = array<i32: 1, 0>} : <tensor<64x256xf16, #dot1>>
+      %13:3 = scf.for %arg8 = %c0_i32 to %arg5 step %c64_i32 iter_args(%arg9 = %cst, %arg10 = %11, %arg11 = %12) -> (tensor<128x256xf32, #dpas>, !tt.ptr<tensor<128x64xf16, #dot0>>, !tt.ptr<tensor<64x256xf16, #dot1>>)  : i32 {
+        %15 = tt.load %arg10 {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<128x64xf16, #dot0>>
+        %16 = tt.load %arg11 {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x256xf16, #dot1>>
+        %17 = tt.dot %15, %16, %arg9, inputPrecision = tf32 : tensor<128x64xf16, #dot0> * tensor<64x256xf16, #dot1> -> tensor<128x256xf32, #dpas>
+        %18 = tt.advance %arg10, [%c0_i32, %c64_i32] : <tensor<128x64xf16, #dot0>>
+        %19 = tt.advance %arg11, [%c64_i32, %c0_i32] : <tensor<64x256xf16, #dot1>>
+        scf.yield %17, %18, %19 : tensor<128x256xf32, #dpas>, !tt.ptr<tensor<128x64xf16, #dot0>>, !tt.ptr<tensor<64x256xf16, #dot1>>
+      }
+      %14 = tt.make_tensor_ptr %arg2, [%3, %4], [%4, %c1_i64], [%9, %10] {order = array<i32: 1, 0>} : <tensor<128x256xf32, #dpas>>
+      tt.store %14, %13#0 {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<128x256xf32, #dpas>>
+    }
+    tt.return
+  }
+}
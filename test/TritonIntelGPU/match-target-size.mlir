@@ -563,3 +563,29 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 :
     tt.return
   }
 }
+
+// -----
+
+// COM: Reductions over more than four native-size sub-tensors.
+#warp = #triton_intel_gpu.warp<{sizePerThread = [16, 128], threadsPerWarp = [1, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: @reduce_min
+  tt.func public @reduce_min(%arg0: f32) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #warp}>> {
+    %cst = arith.constant dense<1.000000e+00> : tensor<16x128xf32, #warp>
+    %0 = tt.splat %arg0 : f32 -> tensor<16x128xf32, #warp>
+    %1 = arith.addf %0, %cst : tensor<16x128xf32, #warp>
+
+    // CHECK-TR-RED-COUNT-7:     arith.minnumf {{.*}} : tensor<16x16xf32>
+    // CHECK-TR-RED:             triton_intel_gpu.sub_group_transpose
+    // CHECK-SG-RED-COUNT-7:     arith.minnumf {{.*}} : tensor<8x16xf32>
+    // CHECK-SG-RED-COUNT-8:     "tt.reduce"({{.*}}) <{axis = 0 : i32}>
+    // CHECK-SG-RED-COUNT-7:     arith.minnumf {{.*}} : tensor<8x16xf32>
+    // CHECK-SG-RED-COUNT-8:     "tt.reduce"({{.*}}) <{axis = 0 : i32}>
+    %2 = "tt.reduce"(%1) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %3 = arith.minnumf %arg1, %arg2 : f32
+      tt.reduce.return %3 : f32
+    }) : (tensor<16x128xf32, #warp>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #warp}>>
+    tt.return %2 : tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #warp}>>
+  }
+}
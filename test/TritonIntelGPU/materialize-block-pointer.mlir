@@ -5,7 +5,7 @@
 #dot_b = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
 module attributes {"triton_gpu.num-ctas" = 1 : i32, triton_gpu.target = "xpu", triton_intel_gpu.support_sg_2d_block} {
   // CHECK-LABEL: tt.func public @materialize_block_pointer(
-  tt.func public @materialize_block_pointer(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %pitch: i64 {tt.divisibility = 16 : i32}, %pitch_odd: i64 {tt.divisibility = 15 : i32}) {
+  tt.func public @materialize_block_pointer(%arg0: !tt.ptr<f16> {tt.divisibility = 64 : i32}, %pitch: i64 {tt.divisibility = 16 : i32}, %pitch_odd: i64 {tt.divisibility = 15 : i32}) {
     %c0_i32 = arith.constant 0 : i32
     %c0_i64 = arith.constant 0 : i64
     %c1_i64 = arith.constant 1 : i64
@@ -41,4 +41,80 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, triton_gpu.target = "xpu", t
     %18 = tt.load %16 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
     tt.return
   }
+
+  // CHECK-LABEL: tt.func public @materialize_block_pointer_specialization(
+  tt.func public @materialize_block_pointer_specialization(%arg0: !tt.ptr<f16> {tt.divisibility = 64 : i32}, %arg1: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %pitch_8: i64 {tt.divisibility = 8 : i32}) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c16_i64 = arith.constant 16 : i64
+    %c32_i64 = arith.constant 32 : i64
+    %c64_i64 = arith.constant 64 : i64
+
+    // COM: A pitch of 16-bit elements divisible by 8 is a multiple of 16 bytes.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major"}
+    %0 = tt.make_tensor_ptr %arg0, [%c32_i64, %c64_i64], [%pitch_8, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot_b>>
+    %1 = tt.load %0 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
+
+    // COM: Pitch smaller than 64 bytes.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32}
+    %2 = tt.make_tensor_ptr %arg0, [%c32_i64, %c16_i64], [%c16_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot_b>>
+    %3 = tt.load %2 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
+
+    // COM: The base is not known to be 64-byte aligned.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major", triton_intel_gpu.block_io_indirect_base}
+    %4 = tt.make_tensor_ptr %arg1, [%c32_i64, %c64_i64], [%c64_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot_b>>
+    %5 = tt.load %4 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
+    tt.return
+  }
+
+  // CHECK-LABEL: tt.func public @materialize_indirect_block_pointer(
+  tt.func public @materialize_indirect_block_pointer(%arg0: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<i32> {tt.divisibility = 16 : i32}, %pitch: i64 {tt.divisibility = 16 : i32}, %page_stride: i64 {tt.divisibility = 16 : i32}) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c32_i64 = arith.constant 32 : i64
+    %c64_i64 = arith.constant 64 : i64
+
+    // COM: The base of the page is read from a block table.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major", triton_intel_gpu.block_io_indirect_base}
+    %0 = tt.load %arg1 : !tt.ptr<i32>
+    %1 = arith.extsi %0 : i32 to i64
+    %2 = arith.muli %1, %page_stride : i64
+    %3 = tt.addptr %arg0, %2 : !tt.ptr<f16>, i64
+    %4 = tt.make_tensor_ptr %3, [%c32_i64, %c64_i64], [%pitch, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot_b>>
+    %5 = tt.load %4 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
+
+    // COM: The base depends on the arguments only, but is not known to be
+    // COM: 64-byte aligned.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major", triton_intel_gpu.block_io_indirect_base}
+    %6 = tt.addptr %arg0, %page_stride : !tt.ptr<f16>, i64
+    %7 = tt.make_tensor_ptr %6, [%c32_i64, %c64_i64], [%pitch, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot_b>>
+    %8 = tt.load %7 {boundaryCheck = array<i32: 0>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<32x64xf16, #dot_b>>
+    tt.return
+  }
+
+  // CHECK-LABEL: tt.func public @materialize_im2col_block_pointer(
+  tt.func public @materialize_im2col_block_pointer(%arg0: !tt.ptr<f16> {tt.divisibility = 64 : i32}, %stride: i32, %channels: i32 {tt.divisibility = 16 : i32}, %row: i32, %tile_stride: i64 {tt.divisibility = 32 : i32}) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c32_i64 = arith.constant 32 : i64
+    %c64_i64 = arith.constant 64 : i64
+
+    // COM: The window of an input row of a convolution: the pitch is the
+    // COM: stride scaled by the number of channels, the base is offset by a
+    // COM: number of pixels, so is only aligned at runtime.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major", triton_intel_gpu.block_io_indirect_base}
+    %0 = arith.muli %row, %channels : i32
+    %1 = tt.addptr %arg0, %0 : !tt.ptr<f16>, i32
+    %2 = arith.muli %stride, %channels : i32
+    %3 = arith.extsi %2 : i32 to i64
+    %4 = tt.make_tensor_ptr %1, [%c32_i64, %c64_i64], [%3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x32xf16, #dot_a>>
+    %5 = tt.load %4 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16, #dot_a>>
+
+    // COM: The base is offset by a multiple of 64 bytes.
+    // CHECK: tt.load {{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32, triton_intel_gpu.block_io = "row_major"}
+    %6 = tt.addptr %arg0, %tile_stride : !tt.ptr<f16>, i64
+    %7 = tt.make_tensor_ptr %6, [%c32_i64, %c64_i64], [%3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x32xf16, #dot_a>>
+    %8 = tt.load %7 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32, isVolatile = false, padding = 1 : i32} : !tt.ptr<tensor<64x32xf16, #dot_a>>
+    tt.return
+  }
 }
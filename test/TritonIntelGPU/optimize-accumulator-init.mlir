@@ -0,0 +1,60 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-optimize-accumulator-init | FileCheck %s
+
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 2], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth = 2}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth = 2}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @peel_zero_acc(
+  // CHECK-SAME:      %[[A:.*]]: tensor<64x32xf16, #{{.*}}>, %[[B:.*]]: tensor<32x64xf16, #{{.*}}>, %[[UB:.*]]: i32)
+  tt.func public @peel_zero_acc(%arg0: tensor<64x32xf16, #dot0>, %arg1: tensor<32x64xf16, #dot1>, %arg2: i32) -> tensor<64x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    // CHECK:         %[[ZERO:.*]] = arith.constant dense<0.000000e+00>
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+    // CHECK:         %[[HAS_ITERS:.*]] = arith.cmpi slt, %c0_i32, %[[UB]] : i32
+    // CHECK:         %[[FIRST:.*]] = scf.if %[[HAS_ITERS]]
+    // CHECK-NEXT:      %[[DOT:.*]] = tt.dot %[[A]], %[[B]], %[[ZERO]]
+    // CHECK-NEXT:      scf.yield %[[DOT]]
+    // CHECK-NEXT:    } else {
+    // CHECK-NEXT:      scf.yield %[[ZERO]]
+    // CHECK-NEXT:    }
+    // CHECK:         %[[LB:.*]] = arith.addi %c0_i32, %c1_i32 : i32
+    // CHECK:         %[[LOOP:.*]] = scf.for %{{.*}} = %[[LB]] to %[[UB]] step %c1_i32 iter_args(%[[ACC:.*]] = %[[FIRST]])
+    // CHECK-NEXT:      tt.dot %[[A]], %[[B]], %[[ACC]]
+    // CHECK:         tt.return %[[LOOP]]
+    %0 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<64x64xf32, #dpas>) : i32 {
+      %1 = tt.dot %arg0, %arg1, %arg4, inputPrecision = tf32 : tensor<64x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<64x64xf32, #dpas>
+      scf.yield %1 : tensor<64x64xf32, #dpas>
+    }
+    tt.return %0 : tensor<64x64xf32, #dpas>
+  }
+
+  // The accumulator is not initialized with zero.
+  // CHECK-LABEL: tt.func public @nonzero_acc(
+  // CHECK-NOT:     scf.if
+  tt.func public @nonzero_acc(%arg0: tensor<64x32xf16, #dot0>, %arg1: tensor<32x64xf16, #dot1>, %arg2: i32) -> tensor<64x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<1.000000e+00> : tensor<64x64xf32, #dpas>
+    %0 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<64x64xf32, #dpas>) : i32 {
+      %1 = tt.dot %arg0, %arg1, %arg4, inputPrecision = tf32 : tensor<64x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<64x64xf32, #dpas>
+      scf.yield %1 : tensor<64x64xf32, #dpas>
+    }
+    tt.return %0 : tensor<64x64xf32, #dpas>
+  }
+
+  // The accumulator is also used outside of the dot.
+  // CHECK-LABEL: tt.func public @acc_other_use(
+  // CHECK-NOT:     scf.if
+  tt.func public @acc_other_use(%arg0: tensor<64x32xf16, #dot0>, %arg1: tensor<32x64xf16, #dot1>, %arg2: i32) -> tensor<64x64xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32, #dpas>
+    %0 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<64x64xf32, #dpas>) : i32 {
+      %1 = tt.dot %arg0, %arg1, %arg4, inputPrecision = tf32 : tensor<64x32xf16, #dot0> * tensor<32x64xf16, #dot1> -> tensor<64x64xf32, #dpas>
+      %2 = arith.addf %1, %arg4 : tensor<64x64xf32, #dpas>
+      scf.yield %2 : tensor<64x64xf32, #dpas>
+    }
+    tt.return %0 : tensor<64x64xf32, #dpas>
+  }
+}
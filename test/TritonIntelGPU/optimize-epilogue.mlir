@@ -0,0 +1,64 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-optimize-epilogue | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [8, 1], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 2], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.support_sg_2d_block"} {
+  // CHECK: #[[$DPAS:.+]] = #triton_intel_gpu.dpas
+  // CHECK-LABEL: @store_block_ptr
+  tt.func public @store_block_ptr(%arg0: !tt.ptr<f16>, %arg1: tensor<64x64xf32, #dpas>, %arg2: i64) {
+    // CHECK-NOT:  triton_gpu.convert_layout
+    // CHECK:      [[SCALE:%.*]] = arith.constant dense<2.000000e+00> : tensor<64x64xf32, #[[$DPAS]]>
+    // CHECK:      [[MUL:%.*]] = arith.mulf [[SCALE]], %arg1 : tensor<64x64xf32, #[[$DPAS]]>
+    // CHECK:      [[TRUNC:%.*]] = arith.truncf [[MUL]] : tensor<64x64xf32, #[[$DPAS]]> to tensor<64x64xf16, #[[$DPAS]]>
+    // CHECK:      [[PTR:%.*]] = tt.make_tensor_ptr %arg0, {{.*}} : <tensor<64x64xf16, #[[$DPAS]]>>
+    // CHECK:      tt.store [[PTR]], [[TRUNC]] {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x64xf16, #[[$DPAS]]>>
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<2.000000e+00> : tensor<64x64xf32, #blocked>
+    %0 = triton_gpu.convert_layout %arg1 : tensor<64x64xf32, #dpas> -> tensor<64x64xf32, #blocked>
+    %1 = arith.mulf %cst, %0 : tensor<64x64xf32, #blocked>
+    %2 = arith.truncf %1 : tensor<64x64xf32, #blocked> to tensor<64x64xf16, #blocked>
+    %3 = tt.make_tensor_ptr %arg0, [%arg2, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf16, #blocked>>
+    tt.store %3, %2 {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x64xf16, #blocked>>
+    tt.return
+  }
+
+  // CHECK-LABEL: @store_tensor_of_ptrs
+  tt.func public @store_tensor_of_ptrs(%arg0: tensor<64x64x!tt.ptr<f32>, #blocked>, %arg1: tensor<64x64xf32, #dpas>, %arg2: tensor<64x64xi1, #blocked>) {
+    // CHECK:      [[PTR:%.*]] = triton_gpu.convert_layout %arg0 : tensor<64x64x!tt.ptr<f32>, #{{.*}}> -> tensor<64x64x!tt.ptr<f32>, #[[$DPAS]]>
+    // CHECK:      [[MASK:%.*]] = triton_gpu.convert_layout %arg2 : tensor<64x64xi1, #{{.*}}> -> tensor<64x64xi1, #[[$DPAS]]>
+    // CHECK:      tt.store [[PTR]], %arg1, [[MASK]] : tensor<64x64x!tt.ptr<f32>, #[[$DPAS]]>
+    %0 = triton_gpu.convert_layout %arg1 : tensor<64x64xf32, #dpas> -> tensor<64x64xf32, #blocked>
+    tt.store %arg0, %0, %arg2 : tensor<64x64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+
+  // CHECK-LABEL: @store_non_splat_epilogue
+  tt.func public @store_non_splat_epilogue(%arg0: tensor<64x64x!tt.ptr<f32>, #blocked>, %arg1: tensor<64x64xf32, #dpas>, %arg2: tensor<64x64xf32, #blocked>) {
+    // COM: The bias has the blocked layout, the accumulator is converted.
+    // CHECK:      triton_gpu.convert_layout %arg1 : tensor<64x64xf32, #[[$DPAS]]> -> tensor<64x64xf32, #{{.*}}>
+    // CHECK:      tt.store %arg0, {{.*}} : tensor<64x64x!tt.ptr<f32>, #{{.*}}>
+    %0 = triton_gpu.convert_layout %arg1 : tensor<64x64xf32, #dpas> -> tensor<64x64xf32, #blocked>
+    %1 = arith.addf %0, %arg2 : tensor<64x64xf32, #blocked>
+    tt.store %arg0, %1 : tensor<64x64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [4, 4], warpsPerCTA = [8, 1], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [4, 2], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: Block pointers are not stored with the DPAS layout without 2D block stores.
+  // CHECK-LABEL: @store_block_ptr_no_2d_block
+  tt.func public @store_block_ptr_no_2d_block(%arg0: !tt.ptr<f32>, %arg1: tensor<64x64xf32, #dpas>, %arg2: i64) {
+    // CHECK:      triton_gpu.convert_layout
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %0 = triton_gpu.convert_layout %arg1 : tensor<64x64xf32, #dpas> -> tensor<64x64xf32, #blocked>
+    %1 = tt.make_tensor_ptr %arg0, [%arg2, %arg2], [%arg2, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf32, #blocked>>
+    tt.store %1, %0 {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<64x64xf32, #blocked>>
+    tt.return
+  }
+}
@@ -0,0 +1,56 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-optimize-reduction-locality | FileCheck %s
+
+// COM: Rows reduced across the sub-groups are given to a single sub-group, with the warps distributed along the rows.
+// CHECK-DAG: [[BLOCKED:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
+// CHECK-DAG: [[SUB_GROUP:#.*]] = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK-LABEL: @row_max
+// CHECK: [[CVT:%.*]] = triton_gpu.convert_layout %{{.*}} : tensor<16x128xf32, [[BLOCKED]]> -> tensor<16x128xf32, [[SUB_GROUP]]>
+// CHECK: [[MAX:%.*]] = "tt.reduce"([[CVT]]) <{axis = 1 : i32}>
+// CHECK: }) : (tensor<16x128xf32, [[SUB_GROUP]]>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = [[SUB_GROUP]]}>>
+// CHECK: [[RES:%.*]] = triton_gpu.convert_layout [[MAX]] : tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = [[SUB_GROUP]]}>> -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = [[BLOCKED]]}>>
+// CHECK: tt.return [[RES]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @row_max(%arg0: tensor<16x128xf32, #blocked>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> {
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.maxnumf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<16x128xf32, #blocked>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return %0 : tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  }
+}
+
+// -----
+
+// COM: A single row cannot be reduced by all the warps without a cross sub-group reduction.
+// CHECK-LABEL: @single_row
+// CHECK-NOT: triton_gpu.convert_layout
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @single_row(%arg0: tensor<1x256xf32, #blocked>) -> tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> {
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<1x256xf32, #blocked>) -> tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return %0 : tensor<1xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  }
+}
+
+// -----
+
+// COM: Rows already held by a single sub-group are left unchanged.
+// CHECK-LABEL: @sub_group_rows
+// CHECK-NOT: triton_gpu.convert_layout
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @sub_group_rows(%arg0: tensor<16x128xf32, #blocked>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> {
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<16x128xf32, #blocked>) -> tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    tt.return %0 : tensor<16xf32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+  }
+}
@@ -0,0 +1,99 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-peel-masked-tail | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @peel_load(
+  // CHECK-SAME:      %[[PTR:.*]]: !tt.ptr<f32>, %[[M:.*]]: i64, %[[K:.*]]: i64, %[[PITCH:.*]]: i64, %[[UB:.*]]: i32, %[[OFF:.*]]: i32)
+  tt.func public @peel_load(%arg0: !tt.ptr<f32>, %arg1: i64, %arg2: i64, %arg3: i64, %arg4: i32, %arg5: i32) -> tensor<32x32xf32, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32, #blocked>
+    // CHECK:         %[[INIT:.*]] = tt.make_tensor_ptr
+    // CHECK:         %[[NUM_ITERS:.*]] = arith.ceildivsi
+    // CHECK:         %[[NUM_MAIN_ITERS:.*]] = arith.maxsi
+    // CHECK:         %[[LAST:.*]] = arith.subi %[[NUM_MAIN_ITERS]], %{{.*}} : i32
+    // CHECK:         arith.extsi %[[LAST]] : i32 to i64
+    // CHECK:         %[[FIRST:.*]] = arith.extsi %[[OFF]] : i32 to i64
+    // CHECK:         arith.cmpi sge, %[[FIRST]]
+    // CHECK:         arith.cmpi sle, %{{.*}}, %[[K]] : i64
+    // CHECK:         %[[MAIN_UB:.*]] = arith.select %{{.*}}, %{{.*}}, %c0_i32 : i32
+    // CHECK:         %[[MAIN:.*]]:2 = scf.for %{{.*}} = %c0_i32 to %[[MAIN_UB]] step %{{.*}} iter_args(%{{.*}} = %{{.*}}, %{{.*}} = %[[INIT]])
+    // CHECK:           tt.load %{{.*}} {boundaryCheck = array<i32: 0>, padding = 1 : i32}
+    // CHECK:           tt.advance
+    // CHECK:         %[[TAIL:.*]]:2 = scf.for %{{.*}} = %[[MAIN_UB]] to %[[UB]] step %{{.*}} iter_args(%{{.*}} = %[[MAIN]]#0, %{{.*}} = %[[MAIN]]#1)
+    // CHECK:           tt.load %{{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32}
+    // CHECK:           tt.advance
+    // CHECK:         tt.return %[[TAIL]]#0
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg3, %c1_i64], [%c0_i32, %arg5] {order = array<i32: 1, 0>} : <tensor<32x32xf32, #blocked>>
+    %1:2 = scf.for %arg6 = %c0_i32 to %arg4 step %c1_i32 iter_args(%arg7 = %cst, %arg8 = %0) -> (tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>) : i32 {
+      %2 = tt.load %arg8 {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<32x32xf32, #blocked>>
+      %3 = arith.addf %arg7, %2 : tensor<32x32xf32, #blocked>
+      %4 = tt.advance %arg8, [%c0_i32, %c32_i32] : <tensor<32x32xf32, #blocked>>
+      scf.yield %3, %4 : tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>
+    }
+    tt.return %1#0 : tensor<32x32xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @peel_store(
+  // CHECK:         scf.for
+  // CHECK:           tt.store %{{.*}}, %{{.*}} {boundaryCheck = array<i32: 1>}
+  // CHECK:         scf.for
+  // CHECK:           tt.store %{{.*}}, %{{.*}} {boundaryCheck = array<i32: 0, 1>}
+  tt.func public @peel_store(%arg0: !tt.ptr<f32>, %arg1: i64, %arg2: i64, %arg3: i64, %arg4: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32, #blocked>
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x32xf32, #blocked>>
+    %1 = scf.for %arg5 = %c0_i32 to %arg4 step %c1_i32 iter_args(%arg6 = %0) -> (!tt.ptr<tensor<32x32xf32, #blocked>>) : i32 {
+      tt.store %arg6, %cst {boundaryCheck = array<i32: 0, 1>} : !tt.ptr<tensor<32x32xf32, #blocked>>
+      %2 = tt.advance %arg6, [%c32_i32, %c0_i32] : <tensor<32x32xf32, #blocked>>
+      scf.yield %2 : !tt.ptr<tensor<32x32xf32, #blocked>>
+    }
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // COM: The loop is not peeled when the step of the checked dimensions varies
+  // COM: across iterations, or when the accesses are not checked.
+  // CHECK-LABEL: tt.func public @no_peel(
+  // CHECK-NOT:     arith.select
+  // CHECK:         scf.for
+  // CHECK:           tt.load %{{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32}
+  // CHECK:         scf.for
+  // CHECK:           tt.load %{{.*}} : !tt.ptr
+  // CHECK-NOT:     scf.for
+  tt.func public @no_peel(%arg0: !tt.ptr<f32>, %arg1: i64, %arg2: i64, %arg3: i64, %arg4: i32) -> (tensor<32x32xf32, #blocked>, tensor<32x32xf32, #blocked>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<32x32xf32, #blocked>
+    %0 = tt.make_tensor_ptr %arg0, [%arg1, %arg2], [%arg3, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x32xf32, #blocked>>
+    %1:2 = scf.for %arg5 = %c0_i32 to %arg4 step %c1_i32 iter_args(%arg6 = %cst, %arg7 = %0) -> (tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>) : i32 {
+      %2 = tt.load %arg7 {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<32x32xf32, #blocked>>
+      %3 = arith.addf %arg6, %2 : tensor<32x32xf32, #blocked>
+      %4 = tt.advance %arg7, [%c0_i32, %arg5] : <tensor<32x32xf32, #blocked>>
+      scf.yield %3, %4 : tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>
+    }
+    %5:2 = scf.for %arg5 = %c0_i32 to %arg4 step %c1_i32 iter_args(%arg6 = %cst, %arg7 = %0) -> (tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>) : i32 {
+      %6 = tt.load %arg7 : !tt.ptr<tensor<32x32xf32, #blocked>>
+      %7 = arith.addf %arg6, %6 : tensor<32x32xf32, #blocked>
+      %8 = tt.advance %arg7, [%c0_i32, %c32_i32] : <tensor<32x32xf32, #blocked>>
+      scf.yield %7, %8 : tensor<32x32xf32, #blocked>, !tt.ptr<tensor<32x32xf32, #blocked>>
+    }
+    tt.return %1#0, %5#0 : tensor<32x32xf32, #blocked>, tensor<32x32xf32, #blocked>
+  }
+}
@@ -0,0 +1,85 @@
+// RUN: triton-opt %s -tritonintelgpu-prefetch-block="inject-split-barriers=false adaptive-distance=true" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [32, 64], threadsPerWarp = [1, 1], warpsPerCTA = [8, 4], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 16], threadsPerWarp = [1, 1], warpsPerCTA = [8, 4], order = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+#dot2 = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked1}>
+#dot3 = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked1}>
+
+module attributes {"triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 1 : i32} {
+  // CHECK-LABEL: @prefetch_distance
+  tt.func public @prefetch_distance(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c4096_i32 = arith.constant 4096 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c4096_i64 = arith.constant 4096 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<256x256xf32, #blocked>
+    %cst_0 = arith.constant dense<0.000000e+00> : tensor<8x64xf32, #blocked1>
+
+    // The DPAS operations of an iteration hide the latency of the next loads.
+    // CHECK: scf.for
+    // CHECK: } {triton_gpu.workload = 3 : i32, triton_intel_gpu.prefetch_distance = 1 : i32}
+    %0 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<256x32xf16, #dot0>, 1>
+    %1 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x256xf16, #dot1>, 1>
+    %2:3 = scf.for %arg2 = %c0_i32 to %c4096_i32 step %c32_i32 iter_args(%arg3 = %cst, %arg4 = %0, %arg5 = %1) -> (tensor<256x256xf32, #blocked>, !tt.ptr<tensor<256x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x256xf16, #dot1>, 1>) : i32 {
+      %10 = tt.load %arg4 : !tt.ptr<tensor<256x32xf16, #dot0>, 1>
+      %11 = tt.load %arg5 : !tt.ptr<tensor<32x256xf16, #dot1>, 1>
+      %12 = tt.dot %10, %11, %arg3 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<256x32xf16, #dot0> * tensor<32x256xf16, #dot1> -> tensor<256x256xf32, #blocked>
+      %13 = tt.advance %arg4, [%c0_i32, %c32_i32] : <tensor<256x32xf16, #dot0>, 1>
+      %14 = tt.advance %arg5, [%c32_i32, %c0_i32] : <tensor<32x256xf16, #dot1>, 1>
+      scf.yield %12, %13, %14 : tensor<256x256xf32, #blocked>, !tt.ptr<tensor<256x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x256xf16, #dot1>, 1>
+    } {triton_gpu.workload = 3 : i32}
+
+    // Small tiles are bandwidth bound: prefetch several iterations ahead.
+    // CHECK: scf.for
+    // CHECK: } {triton_gpu.workload = 3 : i32, triton_intel_gpu.prefetch_distance = 7 : i32}
+    %3 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x32xf16, #dot2>, 1>
+    %4 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot3>, 1>
+    %5:3 = scf.for %arg2 = %c0_i32 to %c4096_i32 step %c32_i32 iter_args(%arg3 = %cst_0, %arg4 = %3, %arg5 = %4) -> (tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>) : i32 {
+      %10 = tt.load %arg4 : !tt.ptr<tensor<8x32xf16, #dot2>, 1>
+      %11 = tt.load %arg5 : !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+      %12 = tt.dot %10, %11, %arg3 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<8x32xf16, #dot2> * tensor<32x64xf16, #dot3> -> tensor<8x64xf32, #blocked1>
+      %13 = tt.advance %arg4, [%c0_i32, %c32_i32] : <tensor<8x32xf16, #dot2>, 1>
+      %14 = tt.advance %arg5, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot3>, 1>
+      scf.yield %12, %13, %14 : tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+    } {triton_gpu.workload = 3 : i32}
+
+    // The distance does not exceed the trip count.
+    // CHECK:      [[PTR:%.*]] = tt.make_tensor_ptr %arg0, {{.*}} : <tensor<8x32xf16, #blocked{{[0-9]*}}>>
+    // CHECK-NEXT: triton_intel_gpu.prefetch [[PTR]]
+    // CHECK-NEXT: [[PTR1:%.*]] = tt.advance [[PTR]]
+    // CHECK-NEXT: triton_intel_gpu.prefetch [[PTR1]]
+    // CHECK-NEXT: tt.advance [[PTR1]]
+    // CHECK-NEXT: tt.make_tensor_ptr %arg0
+    // CHECK: scf.for
+    // CHECK: } {triton_gpu.workload = 3 : i32, triton_intel_gpu.prefetch_distance = 2 : i32}
+    %6 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x32xf16, #dot2>, 1>
+    %7 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot3>, 1>
+    %8:3 = scf.for %arg2 = %c0_i32 to %c64_i32 step %c32_i32 iter_args(%arg3 = %cst_0, %arg4 = %6, %arg5 = %7) -> (tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>) : i32 {
+      %10 = tt.load %arg4 : !tt.ptr<tensor<8x32xf16, #dot2>, 1>
+      %11 = tt.load %arg5 : !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+      %12 = tt.dot %10, %11, %arg3 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<8x32xf16, #dot2> * tensor<32x64xf16, #dot3> -> tensor<8x64xf32, #blocked1>
+      %13 = tt.advance %arg4, [%c0_i32, %c32_i32] : <tensor<8x32xf16, #dot2>, 1>
+      %14 = tt.advance %arg5, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot3>, 1>
+      scf.yield %12, %13, %14 : tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+    } {triton_gpu.workload = 3 : i32}
+
+    // The distance set on the loop overrides the computed one.
+    // CHECK: scf.for
+    // CHECK: } {triton_gpu.workload = 3 : i32, triton_intel_gpu.prefetch_distance = 4 : i32}
+    %15 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x32xf16, #dot2>, 1>
+    %16 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16, #dot3>, 1>
+    %17:3 = scf.for %arg2 = %c0_i32 to %c4096_i32 step %c32_i32 iter_args(%arg3 = %cst_0, %arg4 = %15, %arg5 = %16) -> (tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>) : i32 {
+      %10 = tt.load %arg4 : !tt.ptr<tensor<8x32xf16, #dot2>, 1>
+      %11 = tt.load %arg5 : !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+      %12 = tt.dot %10, %11, %arg3 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<8x32xf16, #dot2> * tensor<32x64xf16, #dot3> -> tensor<8x64xf32, #blocked1>
+      %13 = tt.advance %arg4, [%c0_i32, %c32_i32] : <tensor<8x32xf16, #dot2>, 1>
+      %14 = tt.advance %arg5, [%c32_i32, %c0_i32] : <tensor<32x64xf16, #dot3>, 1>
+      scf.yield %12, %13, %14 : tensor<8x64xf32, #blocked1>, !tt.ptr<tensor<8x32xf16, #dot2>, 1>, !tt.ptr<tensor<32x64xf16, #dot3>, 1>
+    } {triton_gpu.workload = 3 : i32, triton_intel_gpu.prefetch_distance = 4 : i32}
+    tt.return
+  }
+}
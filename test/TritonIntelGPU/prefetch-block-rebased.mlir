@@ -0,0 +1,68 @@
+// RUN: triton-opt %s -tritonintelgpu-prefetch-block="inject-split-barriers=false num-advance-prefetches=2" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [32, 64], threadsPerWarp = [1, 1], warpsPerCTA = [8, 4], order = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// COM: The K loop of a block sparse (BSR) GEMM visits the nonzero blocks of a
+// COM: row of blocks of A, whose columns are read from the block table: the
+// COM: block pointers are rebased in each iteration, and the number of
+// COM: iterations differs between work-groups. The block pointers of the
+// COM: iterations prefetched are recomputed from the block table, for the
+// COM: iterations of the loop only.
+module attributes {"triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 1 : i32} {
+  tt.func public @bsr_matmul(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<i32, 1>, %arg3: i32, %arg4: i32) -> tensor<256x256xf32, #blocked> {
+    // CHECK-LABEL: @bsr_matmul
+    // CHECK:      [[IV0:%.*]] = arith.addi %arg3, {{.*}} : i32
+    // CHECK-NEXT: [[IN0:%.*]] = arith.cmpi slt, [[IV0]], %arg4 : i32
+    // CHECK-NEXT: scf.if [[IN0]] {
+    // CHECK-NEXT:   [[COL_PTR0:%.*]] = tt.addptr %arg2, [[IV0]] : !tt.ptr<i32>, i32
+    // CHECK-NEXT:   [[COL0:%.*]] = tt.load [[COL_PTR0]] : !tt.ptr<i32>
+    // CHECK-NEXT:   [[K0:%.*]] = arith.muli [[COL0]], %c32_i32 : i32
+    // CHECK-NEXT:   [[A0:%.*]] = tt.make_tensor_ptr %arg0, {{.*}}, [%c0_i32, [[K0]]] {{.*}} : <tensor<256x32xf16, #blocked{{[0-9]*}}>>
+    // CHECK-NEXT:   triton_intel_gpu.prefetch [[A0]]
+    // CHECK-NEXT: }
+    // CHECK:      [[IV1:%.*]] = arith.addi %arg3, {{.*}} : i32
+    // CHECK-NEXT: [[IN1:%.*]] = arith.cmpi slt, [[IV1]], %arg4 : i32
+    // CHECK-NEXT: scf.if [[IN1]] {
+    // CHECK-NEXT:   tt.addptr %arg2, [[IV1]] : !tt.ptr<i32>, i32
+    // CHECK:        tt.make_tensor_ptr %arg0
+    // CHECK-NEXT:   triton_intel_gpu.prefetch
+    // CHECK-NEXT: }
+    // CHECK-COUNT-2: tt.make_tensor_ptr %arg1, {{.*}} : <tensor<32x256xf16, #blocked{{[0-9]*}}>>
+
+    // CHECK:      scf.for [[IV:%[a-z0-9_]+]] = %arg3 to %arg4 step {{%[a-z0-9_]+}} iter_args(
+    // CHECK:        tt.load {{.*}} : !tt.ptr<tensor<32x256xf16, #dot1>>
+    // CHECK:        [[NEXT:%.*]] = arith.addi [[IV]], {{.*}} : i32
+    // CHECK-NEXT:   [[IN:%.*]] = arith.cmpi slt, [[NEXT]], %arg4 : i32
+    // CHECK-NEXT:   scf.if [[IN]] {
+    // CHECK-NEXT:     [[COL_PTR:%.*]] = tt.addptr %arg2, [[NEXT]] : !tt.ptr<i32>, i32
+    // CHECK-NEXT:     tt.load [[COL_PTR]] : !tt.ptr<i32>
+    // CHECK-NEXT:     arith.muli
+    // CHECK-NEXT:     tt.make_tensor_ptr %arg0
+    // CHECK-NEXT:     triton_intel_gpu.prefetch
+    // CHECK-NEXT:   }
+    // CHECK:        scf.if
+    // CHECK:          tt.make_tensor_ptr %arg1
+    // CHECK-NEXT:     triton_intel_gpu.prefetch
+    // CHECK:        tt.dot
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c4096_i64 = arith.constant 4096 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<256x256xf32, #blocked>
+    %0 = scf.for %arg5 = %arg3 to %arg4 step %c1_i32 iter_args(%arg6 = %cst) -> (tensor<256x256xf32, #blocked>) : i32 {
+      %1 = tt.addptr %arg2, %arg5 : !tt.ptr<i32, 1>, i32
+      %2 = tt.load %1 : !tt.ptr<i32, 1>
+      %3 = arith.muli %2, %c32_i32 : i32
+      %4 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %3] {order = array<i32: 1, 0>} : <tensor<256x32xf16, #dot0>, 1>
+      %5 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%3, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x256xf16, #dot1>, 1>
+      %6 = tt.load %4 : !tt.ptr<tensor<256x32xf16, #dot0>, 1>
+      %7 = tt.load %5 : !tt.ptr<tensor<32x256xf16, #dot1>, 1>
+      %8 = tt.dot %6, %7, %arg6 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<256x32xf16, #dot0> * tensor<32x256xf16, #dot1> -> tensor<256x256xf32, #blocked>
+      scf.yield %8 : tensor<256x256xf32, #blocked>
+    } {triton_gpu.workload = 3 : i32}
+    tt.return %0 : tensor<256x256xf32, #blocked>
+  }
+}
@@ -0,0 +1,79 @@
+// RUN: triton-opt %s -tritonintelgpu-prefetch-block="inject-split-barriers=false num-advance-prefetches=2 num-sharing-workgroups=4" | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [32, 64], threadsPerWarp = [1, 1], warpsPerCTA = [8, 4], order = [1, 0]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>
+
+// COM: The 4 consecutive work-groups of a group share the panels of B: each of
+// COM: them prefetches every 4th iteration of B into L3 only, and A as usual.
+module attributes {"triton_gpu.num-warps" = 32 : i32, "triton_gpu.threads-per-warp" = 1 : i32} {
+  tt.func public @matmul_kernel_with_block_pointers(%arg0: !tt.ptr<f16, 1>, %arg1: !tt.ptr<f16, 1>, %arg2: !tt.ptr<f32, 1>) {
+    // CHECK-LABEL: @matmul_kernel_with_block_pointers
+    // CHECK:      [[A0:%.*]] = tt.make_tensor_ptr %arg0
+    // CHECK-NEXT: triton_intel_gpu.prefetch [[A0]] {cache = 1 : i32
+
+    // CHECK:      [[B0:%.*]] = tt.make_tensor_ptr %arg1
+    // CHECK-NEXT: [[PID:%.*]] = tt.get_program_id x : i32
+    // CHECK-NEXT: [[I0:%.*]] = arith.constant 0 : i32
+    // CHECK-NEXT: [[SUM:%.*]] = arith.addi [[I0]], [[PID]] : i32
+    // CHECK-NEXT: [[C4:%.*]] = arith.constant 4 : i32
+    // CHECK-NEXT: [[OWNER:%.*]] = arith.remui [[SUM]], [[C4]] : i32
+    // CHECK-NEXT: [[ZERO:%.*]] = arith.constant 0 : i32
+    // CHECK-NEXT: [[IS_OWNER:%.*]] = arith.cmpi eq, [[OWNER]], [[ZERO]] : i32
+    // CHECK-NEXT: scf.if [[IS_OWNER]] {
+    // CHECK-NEXT:   triton_intel_gpu.prefetch [[B0]] {cache = 3 : i32
+
+    // CHECK:      scf.for [[IV:%[a-z0-9_]+]] = [[LB:%[a-z0-9_]+]] to {{%[a-z0-9_]+}} step [[STEP:%[a-z0-9_]+]] iter_args(
+    // CHECK-NEXT:   [[SUB:%.*]] = arith.subi [[IV]], [[LB]] : i32
+    // CHECK-NEXT:   [[INDEX:%.*]] = arith.divsi [[SUB]], [[STEP]] : i32
+    // CHECK-NEXT:   [[DISTANCE:%.*]] = arith.constant 2 : i32
+    // CHECK-NEXT:   [[ITER:%.*]] = arith.addi [[INDEX]], [[DISTANCE]] : i32
+    // CHECK-NEXT:   tt.load
+    // CHECK-NEXT:   tt.load
+    // CHECK-NEXT:   triton_intel_gpu.prefetch {{.*}} {cache = 1 : i32
+    // CHECK-NEXT:   [[PID1:%.*]] = tt.get_program_id x : i32
+    // CHECK-NEXT:   arith.addi [[ITER]], [[PID1]] : i32
+    // CHECK-NEXT:   arith.constant 4 : i32
+    // CHECK-NEXT:   arith.remui
+    // CHECK-NEXT:   arith.constant 0 : i32
+    // CHECK-NEXT:   arith.cmpi eq
+    // CHECK-NEXT:   scf.if
+    // CHECK-NEXT:     triton_intel_gpu.prefetch {{.*}} {cache = 3 : i32
+    // CHECK:        tt.dot
+
+    %c64_i32 = arith.constant 64 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c4096_i32 = arith.constant 4096 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<256x256xf32, #blocked>
+    %c32_i32 = arith.constant 32 : i32
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c4096_i64 = arith.constant 4096 : i64
+    %c256_i32 = arith.constant 256 : i32
+    %c4_i32 = arith.constant 4 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = arith.divsi %0, %c64_i32 : i32
+    %2 = arith.muli %1, %c4_i32 : i32
+    %3 = arith.subi %c16_i32, %2 : i32
+    %4 = arith.minsi %3, %c4_i32 : i32
+    %5 = arith.remsi %0, %4 : i32
+    %6 = arith.addi %2, %5 : i32
+    %7 = arith.remsi %0, %c64_i32 : i32
+    %8 = arith.divsi %7, %4 : i32
+    %9 = arith.muli %6, %c256_i32 : i32
+    %10 = tt.make_tensor_ptr %arg0, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%9, %c0_i32] {order = array<i32: 1, 0>} : <tensor<256x32xf16, #dot0>, 1>
+    %11 = arith.muli %8, %c256_i32 : i32
+    %12 = tt.make_tensor_ptr %arg1, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%c0_i32, %11] {order = array<i32: 1, 0>} : <tensor<32x256xf16, #dot1>, 1>
+    %13:3 = scf.for %arg6 = %c0_i32 to %c4096_i32 step %c32_i32 iter_args(%arg7 = %cst, %arg8 = %10, %arg9 = %12) -> (tensor<256x256xf32, #blocked>, !tt.ptr<tensor<256x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x256xf16, #dot1>, 1>) : i32 {
+      %15 = tt.load %arg8 : !tt.ptr<tensor<256x32xf16, #dot0>, 1>
+      %16 = tt.load %arg9 : !tt.ptr<tensor<32x256xf16, #dot1>, 1>
+      %17 = tt.dot %15, %16, %arg7 {inputPrecision = 0 : i32, maxNumImpreciseAcc = 0 : i32} : tensor<256x32xf16, #dot0> * tensor<32x256xf16, #dot1> -> tensor<256x256xf32, #blocked>
+      %18 = tt.advance %arg8, [%c0_i32, %c32_i32] : <tensor<256x32xf16, #dot0>, 1>
+      %19 = tt.advance %arg9, [%c32_i32, %c0_i32] : <tensor<32x256xf16, #dot1>, 1>
+      scf.yield %17, %18, %19 : tensor<256x256xf32, #blocked>, !tt.ptr<tensor<256x32xf16, #dot0>, 1>, !tt.ptr<tensor<32x256xf16, #dot1>, 1>
+    } {triton_gpu.workload = 3 : i32}
+    %14 = tt.make_tensor_ptr %arg2, [%c4096_i64, %c4096_i64], [%c4096_i64, %c1_i64], [%9, %11] {order = array<i32: 1, 0>} : <tensor<256x256xf32, #blocked>, 1>
+    tt.store %14, %13#0 {boundaryCheck = array<i32: 0, 1>, cache = 1 : i32, evict = 1 : i32} : !tt.ptr<tensor<256x256xf32, #blocked>, 1>
+    tt.return
+  }
+}
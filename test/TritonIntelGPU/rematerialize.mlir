@@ -0,0 +1,76 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-rematerialize | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-rematerialize=grf-budget=1 | FileCheck %s --check-prefix=SMALL-BUDGET
+
+// COM: The pointers and the mask of the loads of a dot loop are recomputed in
+// COM: the loop body once the register pressure exceeds the GRF budget.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<tensor<16x16xf16>>, %arg2: i32, %arg3: i32) -> tensor<8x16xf32> {
+    // CHECK-LABEL: @matmul
+    // CHECK:         tt.make_range
+    // CHECK:         tt.addptr
+    // CHECK:         arith.cmpi
+    // CHECK:         scf.for
+    // CHECK-NOT:       tt.addptr
+    // CHECK:           tt.load
+    // SMALL-BUDGET-LABEL: @matmul
+    // SMALL-BUDGET-NOT:    tt.make_range
+    // SMALL-BUDGET:        scf.for
+    // SMALL-BUDGET-NEXT:     tt.splat %arg0
+    // SMALL-BUDGET-NEXT:     tt.make_range
+    // SMALL-BUDGET-NEXT:     tt.expand_dims
+    // SMALL-BUDGET-NEXT:     [[OFFSETS:%.*]] = tt.broadcast
+    // SMALL-BUDGET-NEXT:     [[PTRS:%.*]] = tt.addptr
+    // SMALL-BUDGET-NEXT:     tt.splat %arg3
+    // SMALL-BUDGET-NEXT:     [[MASK:%.*]] = arith.cmpi slt, [[OFFSETS]]
+    // SMALL-BUDGET-NEXT:     tt.load [[PTRS]], [[MASK]]
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32>
+    %1 = tt.expand_dims %0 {axis = 0 : i32} : tensor<16xi32> -> tensor<1x16xi32>
+    %2 = tt.broadcast %1 : tensor<1x16xi32> -> tensor<8x16xi32>
+    %3 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<8x16x!tt.ptr<f16>>
+    %4 = tt.addptr %3, %2 : tensor<8x16x!tt.ptr<f16>>, tensor<8x16xi32>
+    %5 = tt.splat %arg3 : i32 -> tensor<8x16xi32>
+    %6 = arith.cmpi slt, %2, %5 : tensor<8x16xi32>
+    %7 = scf.for %arg4 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg5 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %8 = tt.load %4, %6 : tensor<8x16x!tt.ptr<f16>>
+      %9 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %10 = tt.dot %8, %9, %arg5, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %10 : tensor<8x16xf32>
+    }
+    tt.return %7 : tensor<8x16xf32>
+  }
+}
+
+// -----
+
+// COM: The pointers used after the loop stay live across it, so they are not
+// COM: recomputed.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @used_after_loop(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<tensor<16x16xf16>>, %arg2: i32) -> tensor<8x16xf32> {
+    // SMALL-BUDGET-LABEL: @used_after_loop
+    // SMALL-BUDGET:         tt.addptr
+    // SMALL-BUDGET:         scf.for
+    // SMALL-BUDGET-NOT:       tt.addptr
+    // SMALL-BUDGET:           scf.yield
+    // SMALL-BUDGET:         tt.store
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32>
+    %1 = tt.expand_dims %0 {axis = 0 : i32} : tensor<16xi32> -> tensor<1x16xi32>
+    %2 = tt.broadcast %1 : tensor<1x16xi32> -> tensor<8x16xi32>
+    %3 = tt.splat %arg0 : !tt.ptr<f16> -> tensor<8x16x!tt.ptr<f16>>
+    %4 = tt.addptr %3, %2 : tensor<8x16x!tt.ptr<f16>>, tensor<8x16xi32>
+    %5 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %6 = tt.load %4 : tensor<8x16x!tt.ptr<f16>>
+      %7 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %8 = tt.dot %6, %7, %arg4, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %8 : tensor<8x16xf32>
+    }
+    %9 = arith.truncf %5 : tensor<8x16xf32> to tensor<8x16xf16>
+    tt.store %4, %9 : tensor<8x16x!tt.ptr<f16>>
+    tt.return %5 : tensor<8x16xf32>
+  }
+}
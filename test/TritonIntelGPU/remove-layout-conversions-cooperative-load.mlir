@@ -0,0 +1,42 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-remove-layout-conversions=cache-size=8192 | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-remove-layout-conversions=cache-size=65536 | FileCheck %s --check-prefix=LARGE-CACHE
+
+// COM: The A operand is shared by the 4 sub-groups along N. Its duplicated loads
+// COM: would miss a cache smaller than the loads of an iteration, so it is kept
+// COM: cooperative and converted to the dot operand layout, while the B operand
+// COM: loaded by a single sub-group is loaded with its dot operand layout.
+// CHECK-DAG: #[[BLOCKED:.+]] = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [2, 2], order = [1, 0]}>
+// CHECK-DAG: #[[DPAS:.+]] = #triton_intel_gpu.dpas<{{.*}}warpsPerCTA = [1, 4]{{.*}}>
+// CHECK-LABEL: @matmul
+// CHECK: scf.for
+// CHECK: %[[A:.*]] = tt.load %{{.*}} : !tt.ptr<tensor<64x32xf16, #[[BLOCKED]]>>
+// CHECK: %[[B:.*]] = tt.load %{{.*}} : !tt.ptr<tensor<32x256xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #[[DPAS]], kWidth = 2}>>>
+// CHECK: %[[CVT:.*]] = triton_gpu.convert_layout %[[A]] : tensor<64x32xf16, #[[BLOCKED]]> -> tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #[[DPAS]], kWidth = 2}>>
+// CHECK: tt.dot %[[CVT]], %[[B]]
+// COM: In a cache holding the loads of an iteration, the duplicated loads hit.
+// LARGE-CACHE-LABEL: @matmul
+// LARGE-CACHE-NOT: triton_gpu.convert_layout
+// LARGE-CACHE: tt.dot
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [2, 2], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [1, 4], order = [1, 0]}>
+#dpas = #triton_intel_gpu.dpas<{repeatCount = 8, systolicDepth = 8, executionSize = 16, opsPerChan = 2, threadsPerWarp = 16, warpsPerCTA = [1, 4], repCluster = [1, 1], A = [8, 16], B = [16, 16], C = [8, 16]}>
+#dot0 = #triton_gpu.dot_op<{opIdx = 0, parent = #dpas, kWidth=2}>
+#dot1 = #triton_gpu.dot_op<{opIdx = 1, parent = #dpas, kWidth=2}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 16 : i32, "triton_intel_gpu.support_sg_2d_block"} {
+  tt.func public @matmul(%arg0: !tt.ptr<tensor<64x32xf16, #blocked>>, %arg1: !tt.ptr<tensor<32x256xf16, #blocked1>>, %arg2: i32) -> tensor<64x256xf32, #dpas> {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x256xf32, #dpas>
+    %0:3 = scf.for %arg3 = %c0_i32 to %arg2 step %c32_i32 iter_args(%arg4 = %cst, %arg5 = %arg0, %arg6 = %arg1) -> (tensor<64x256xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #blocked>>, !tt.ptr<tensor<32x256xf16, #blocked1>>)  : i32 {
+      %1 = tt.load %arg5 : !tt.ptr<tensor<64x32xf16, #blocked>>
+      %2 = tt.load %arg6 : !tt.ptr<tensor<32x256xf16, #blocked1>>
+      %3 = triton_gpu.convert_layout %1 : tensor<64x32xf16, #blocked> -> tensor<64x32xf16, #dot0>
+      %4 = triton_gpu.convert_layout %2 : tensor<32x256xf16, #blocked1> -> tensor<32x256xf16, #dot1>
+      %5 = tt.dot %3, %4, %arg4, inputPrecision = tf32 : tensor<64x32xf16, #dot0> * tensor<32x256xf16, #dot1> -> tensor<64x256xf32, #dpas>
+      %6 = tt.advance %arg5, [%c0_i32, %c32_i32] : <tensor<64x32xf16, #blocked>>
+      %7 = tt.advance %arg6, [%c32_i32, %c0_i32] : <tensor<32x256xf16, #blocked1>>
+      scf.yield %5, %6, %7 : tensor<64x256xf32, #dpas>, !tt.ptr<tensor<64x32xf16, #blocked>>, !tt.ptr<tensor<32x256xf16, #blocked1>>
+    }
+    tt.return %0#0 : tensor<64x256xf32, #dpas>
+  }
+}
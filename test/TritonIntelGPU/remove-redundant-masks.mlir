@@ -0,0 +1,61 @@
+// RUN: triton-opt %s -split-input-file --tritonintelgpu-remove-redundant-masks | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [16], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @remove_masks(
+  tt.func public @remove_masks(%arg0: !tt.ptr<f32>, %arg1: i32) {
+    %c0_i32 = arith.constant 0 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %cst = arith.constant dense<1024> : tensor<64xi32, #blocked>
+    %cst_0 = arith.constant dense<0.000000e+00> : tensor<64xf32, #blocked>
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>, #blocked>
+    // The offsets are in [0, 1024) in all the iterations.
+    // CHECK: scf.for
+    scf.for %arg2 = %c0_i32 to %c1024_i32 step %c64_i32  : i32 {
+      %2 = tt.splat %arg2 : i32 -> tensor<64xi32, #blocked>
+      %3 = arith.addi %2, %0 : tensor<64xi32, #blocked>
+      %4 = arith.cmpi slt, %3, %cst : tensor<64xi32, #blocked>
+      %5 = tt.addptr %1, %3 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+      // CHECK-NOT: arith.cmpi
+      // CHECK: %[[VAL:.*]] = tt.load %{{.*}} : tensor<64x!tt.ptr<f32>, #blocked>
+      %6 = tt.load %5, %4, %cst_0 : tensor<64x!tt.ptr<f32>, #blocked>
+      // CHECK: tt.store %{{.*}}, %[[VAL]] : tensor<64x!tt.ptr<f32>, #blocked>
+      tt.store %5, %6, %4 : tensor<64x!tt.ptr<f32>, #blocked>
+    }
+    // The offsets depend on the unknown %arg1.
+    %7 = tt.splat %arg1 : i32 -> tensor<64xi32, #blocked>
+    %8 = arith.addi %7, %0 : tensor<64xi32, #blocked>
+    // CHECK: %[[MASK:.*]] = arith.cmpi slt
+    %9 = arith.cmpi slt, %8, %cst : tensor<64xi32, #blocked>
+    %10 = tt.addptr %1, %8 : tensor<64x!tt.ptr<f32>, #blocked>, tensor<64xi32, #blocked>
+    // CHECK: tt.load %{{.*}}, %[[MASK]], %{{.*}} : tensor<64x!tt.ptr<f32>, #blocked>
+    %11 = tt.load %10, %9, %cst_0 : tensor<64x!tt.ptr<f32>, #blocked>
+    tt.store %10, %11, %9 : tensor<64x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 16], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "xpu", "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @remove_boundary_checks(
+  tt.func public @remove_boundary_checks(%arg0: !tt.ptr<f32>, %arg1: i64, %arg2: i32) -> (tensor<32x32xf32, #blocked>, tensor<32x32xf32, #blocked>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c64_i64 = arith.constant 64 : i64
+    // Only the rows are in bounds: [32, 64) of 64 rows.
+    %0 = tt.make_tensor_ptr %arg0, [%c64_i64, %arg1], [%arg1, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x32xf32, #blocked>>
+    %1 = tt.advance %0, [%c32_i32, %c32_i32] : <tensor<32x32xf32, #blocked>>
+    // CHECK: tt.load %{{.*}} {boundaryCheck = array<i32: 1>, padding = 1 : i32}
+    %2 = tt.load %1 {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<32x32xf32, #blocked>>
+    // The unknown offset may be out of bounds.
+    %3 = tt.advance %0, [%arg2, %c0_i32] : <tensor<32x32xf32, #blocked>>
+    // CHECK: tt.load %{{.*}} {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32}
+    %4 = tt.load %3 {boundaryCheck = array<i32: 0, 1>, padding = 1 : i32} : !tt.ptr<tensor<32x32xf32, #blocked>>
+    tt.return %2, %4 : tensor<32x32xf32, #blocked>, tensor<32x32xf32, #blocked>
+  }
+}
@@ -0,0 +1,63 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-schedule-loop | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-schedule-loop=grf-budget=1 | FileCheck %s --check-prefix=SMALL-BUDGET
+
+// COM: The loads are hoisted above the dots to hide their latency, unless the
+// COM: GRF budget is exhausted.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul(%arg0: !tt.ptr<tensor<8x16xf16>>, %arg1: !tt.ptr<tensor<16x16xf16>>, %arg2: !tt.ptr<tensor<8x16xf16>>, %arg3: !tt.ptr<tensor<16x16xf16>>) -> (tensor<8x16xf32>, tensor<8x16xf32>) {
+    // CHECK-LABEL: @matmul
+    // CHECK: scf.for
+    // CHECK-COUNT-4: tt.load
+    // CHECK-COUNT-2: tt.dot
+    // CHECK: scf.yield
+    // SMALL-BUDGET-LABEL: @matmul
+    // SMALL-BUDGET: scf.for
+    // SMALL-BUDGET-NEXT: tt.load %arg0
+    // SMALL-BUDGET-NEXT: tt.load %arg1
+    // SMALL-BUDGET-NEXT: tt.dot
+    // SMALL-BUDGET-NEXT: tt.load %arg2
+    // SMALL-BUDGET-NEXT: tt.load %arg3
+    // SMALL-BUDGET-NEXT: tt.dot
+    // SMALL-BUDGET-NEXT: scf.yield
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0:2 = scf.for %arg4 = %c0_i32 to %c64_i32 step %c1_i32 iter_args(%arg5 = %cst, %arg6 = %cst) -> (tensor<8x16xf32>, tensor<8x16xf32>) : i32 {
+      %1 = tt.load %arg0 : !tt.ptr<tensor<8x16xf16>>
+      %2 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %3 = tt.dot %1, %2, %arg5, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      %4 = tt.load %arg2 : !tt.ptr<tensor<8x16xf16>>
+      %5 = tt.load %arg3 : !tt.ptr<tensor<16x16xf16>>
+      %6 = tt.dot %4, %5, %arg6, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %3, %6 : tensor<8x16xf32>, tensor<8x16xf32>
+    }
+    tt.return %0#0, %0#1 : tensor<8x16xf32>, tensor<8x16xf32>
+  }
+}
+
+// -----
+
+// COM: Operations are not moved across stores.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @store(%arg0: !tt.ptr<tensor<8x16xf16>>, %arg1: !tt.ptr<tensor<16x16xf16>>, %arg2: !tt.ptr<tensor<8x16xf32>>) -> tensor<8x16xf32> {
+    // CHECK-LABEL: @store
+    // CHECK: scf.for
+    // CHECK-NEXT: tt.load %arg0
+    // CHECK-NEXT: tt.store
+    // CHECK-NEXT: tt.load %arg1
+    // CHECK-NEXT: tt.dot
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = scf.for %arg3 = %c0_i32 to %c64_i32 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %1 = tt.load %arg0 : !tt.ptr<tensor<8x16xf16>>
+      tt.store %arg2, %arg4 : !tt.ptr<tensor<8x16xf32>>
+      %2 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %3 = tt.dot %1, %2, %arg4, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %3 : tensor<8x16xf32>
+    }
+    tt.return %0 : tensor<8x16xf32>
+  }
+}
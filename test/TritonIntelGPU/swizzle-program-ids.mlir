@@ -0,0 +1,67 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-swizzle-program-ids=num-xe-cores=64 | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-swizzle-program-ids="num-xe-cores=64 cache-size=4096" | FileCheck %s --check-prefix=SMALL-CACHE
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-swizzle-program-ids=group-size=2 | FileCheck %s --check-prefix=GROUP-SIZE
+
+// COM: The program ids of kernels launched over a 2D grid are remapped to walk
+// COM: the grid by groups of rows along X: 8 rows for 64 Xe-cores, halved while
+// COM: the 1KB of operand blocks of each program do not fit in the cache.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @tile_2d(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<f16>) {
+    // CHECK-LABEL: @tile_2d
+    // CHECK-DAG: [[PIDX:%.*]] = tt.get_program_id x : i32
+    // CHECK-DAG: [[PIDY:%.*]] = tt.get_program_id y : i32
+    // CHECK-DAG: [[GRIDX:%.*]] = tt.get_num_programs x : i32
+    // CHECK-DAG: [[GRIDY:%.*]] = tt.get_num_programs y : i32
+    // CHECK-DAG: [[SIZE:%.*]] = arith.constant 8 : i32
+    // CHECK: [[MUL:%.*]] = arith.muli [[PIDY]], [[GRIDX]] : i32
+    // CHECK: [[PID:%.*]] = arith.addi [[MUL]], [[PIDX]] : i32
+    // CHECK: [[WIDTH:%.*]] = arith.muli [[SIZE]], [[GRIDY]] : i32
+    // CHECK: [[GROUP:%.*]] = arith.divsi [[PID]], [[WIDTH]] : i32
+    // CHECK: [[FIRST:%.*]] = arith.muli [[GROUP]], [[SIZE]] : i32
+    // CHECK: [[LEFT:%.*]] = arith.subi [[GRIDX]], [[FIRST]] : i32
+    // CHECK: [[ROWS:%.*]] = arith.minsi [[SIZE]], [[LEFT]] : i32
+    // CHECK: [[IN_GROUP:%.*]] = arith.remsi [[PID]], [[WIDTH]] : i32
+    // CHECK: [[ROW:%.*]] = arith.remsi [[IN_GROUP]], [[ROWS]] : i32
+    // CHECK: [[NEW_PIDX:%.*]] = arith.addi [[FIRST]], [[ROW]] : i32
+    // CHECK: [[NEW_PIDY:%.*]] = arith.divsi [[IN_GROUP]], [[ROWS]] : i32
+    // CHECK-NOT: tt.get_program_id
+    // CHECK: arith.muli [[NEW_PIDX]]
+    // CHECK: arith.muli [[NEW_PIDY]]
+    // SMALL-CACHE-LABEL: @tile_2d
+    // SMALL-CACHE: arith.constant 4 : i32
+    // GROUP-SIZE-LABEL: @tile_2d
+    // GROUP-SIZE: arith.constant 2 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %0 = tt.get_program_id x : i32
+    %1 = tt.get_program_id y : i32
+    %2 = arith.muli %0, %c16_i32 : i32
+    %3 = arith.muli %1, %c32_i32 : i32
+    %4 = tt.addptr %arg0, %2 : !tt.ptr<f16>, i32
+    %5 = tt.addptr %arg1, %3 : !tt.ptr<f16>, i32
+    %6 = tt.make_range {end = 512 : i32, start = 0 : i32} : tensor<512xi32>
+    %7 = tt.splat %4 : !tt.ptr<f16> -> tensor<512x!tt.ptr<f16>>
+    %8 = tt.addptr %7, %6 : tensor<512x!tt.ptr<f16>>, tensor<512xi32>
+    %9 = tt.load %8 : tensor<512x!tt.ptr<f16>>
+    %10 = tt.splat %5 : !tt.ptr<f16> -> tensor<512x!tt.ptr<f16>>
+    %11 = tt.addptr %10, %6 : tensor<512x!tt.ptr<f16>>, tensor<512xi32>
+    tt.store %11, %9 : tensor<512x!tt.ptr<f16>>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Kernels launched over a 1D grid are left unchanged.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @tile_1d(%arg0: !tt.ptr<i32>) {
+    // CHECK-LABEL: @tile_1d
+    // CHECK-NOT: tt.get_num_programs
+    // CHECK: [[PID:%.*]] = tt.get_program_id x : i32
+    // CHECK-NEXT: tt.addptr %arg0, [[PID]]
+    %0 = tt.get_program_id x : i32
+    %1 = tt.addptr %arg0, %0 : !tt.ptr<i32>, i32
+    tt.store %1, %0 : !tt.ptr<i32>
+    tt.return
+  }
+}
@@ -0,0 +1,60 @@
+// RUN: triton-opt %s --split-input-file -triton-annotate-module='min-sg-size=16 support-sg-2d-block=true support-dpas=true threads-per-warp=32 advanced-path=true' | FileCheck %s
+
+module {
+  // COM: Ensure that a kernel loading the operands of its dot through block pointers uses the advanced path.
+  // CHECK: module attributes {{.*}}triton_intel_gpu.advanced_path = true
+  tt.func @matmul(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<f16>, %arg2: !tt.ptr<f32>) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i64 = arith.constant 1 : i64
+    %c32_i32 = arith.constant 32 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %c1024_i64 = arith.constant 1024 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+    %0 = tt.make_tensor_ptr %arg0, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x32xf16>>
+    %1 = tt.make_tensor_ptr %arg1, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<32x64xf16>>
+    %2:3 = scf.for %arg3 = %c0_i32 to %c1024_i32 step %c32_i32 iter_args(%arg4 = %cst, %arg5 = %0, %arg6 = %1) -> (tensor<64x64xf32>, !tt.ptr<tensor<64x32xf16>>, !tt.ptr<tensor<32x64xf16>>) : i32 {
+      %4 = tt.load %arg5 : !tt.ptr<tensor<64x32xf16>>
+      %5 = tt.load %arg6 : !tt.ptr<tensor<32x64xf16>>
+      %6 = tt.dot %4, %5, %arg4 : tensor<64x32xf16> * tensor<32x64xf16> -> tensor<64x64xf32>
+      %7 = tt.advance %arg5, [%c0_i32, %c32_i32] : <tensor<64x32xf16>>
+      %8 = tt.advance %arg6, [%c32_i32, %c0_i32] : <tensor<32x64xf16>>
+      scf.yield %6, %7, %8 : tensor<64x64xf32>, !tt.ptr<tensor<64x32xf16>>, !tt.ptr<tensor<32x64xf16>>
+    }
+    %3 = tt.make_tensor_ptr %arg2, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<64x64xf32>>
+    tt.store %3, %2#0 : !tt.ptr<tensor<64x64xf32>>
+    tt.return
+  }
+}
+
+// -----
+
+module {
+  // COM: Ensure that a kernel without dots uses the default path.
+  // CHECK: module attributes {{.*}}triton_intel_gpu.advanced_path = false
+  tt.func @add(%arg0: !tt.ptr<f32>, %arg1: !tt.ptr<f32>) {
+    %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+    %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    %3 = tt.load %2 : tensor<128x!tt.ptr<f32>>
+    %4 = arith.addf %3, %3 : tensor<128xf32>
+    %5 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+    %6 = tt.addptr %5, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    tt.store %6, %4 : tensor<128x!tt.ptr<f32>>
+    tt.return
+  }
+}
+
+// -----
+
+module {
+  // COM: Ensure that a kernel with a dot on operands loaded through tensors of pointers uses the default path.
+  // CHECK: module attributes {{.*}}triton_intel_gpu.advanced_path = false
+  tt.func @matmul_tensor_of_pointers(%arg0: tensor<64x32x!tt.ptr<f16>>, %arg1: tensor<32x64x!tt.ptr<f16>>, %arg2: tensor<64x64x!tt.ptr<f32>>) {
+    %cst = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+    %0 = tt.load %arg0 : tensor<64x32x!tt.ptr<f16>>
+    %1 = tt.load %arg1 : tensor<32x64x!tt.ptr<f16>>
+    %2 = tt.dot %0, %1, %cst : tensor<64x32xf16> * tensor<32x64xf16> -> tensor<64x64xf32>
+    tt.store %arg2, %2 : tensor<64x64x!tt.ptr<f32>>
+    tt.return
+  }
+}
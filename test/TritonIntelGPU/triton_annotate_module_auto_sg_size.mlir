@@ -0,0 +1,45 @@
+// RUN: triton-opt %s --split-input-file -triton-annotate-module='min-sg-size=16 support-sg-2d-block=true support-dpas=true threads-per-warp=0 num-warps=4' | FileCheck %s
+
+module {
+  // COM: Ensure that a 32-wide subgroup is selected when each lane holds at least one element.
+  // CHECK: module attributes {"triton_gpu.threads-per-warp" = 32 : i32
+  tt.func @elementwise(%arg0: !tt.ptr<f32>) {
+    %0 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<1024x!tt.ptr<f32>>
+    %2 = tt.addptr %1, %0 : tensor<1024x!tt.ptr<f32>>, tensor<1024xi32>
+    %3 = tt.load %2 : tensor<1024x!tt.ptr<f32>>
+    %4 = arith.addf %3, %3 : tensor<1024xf32>
+    tt.store %2, %4 : tensor<1024x!tt.ptr<f32>>
+    tt.return
+  }
+}
+
+// -----
+
+module {
+  // COM: Ensure that a 16-wide subgroup is selected when the tensors cannot occupy all the lanes of a 32-wide subgroup.
+  // CHECK: module attributes {"triton_gpu.threads-per-warp" = 16 : i32
+  tt.func @small_elementwise(%arg0: !tt.ptr<f32>) {
+    %0 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>>
+    %2 = tt.addptr %1, %0 : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+    %3 = tt.load %2 : tensor<64x!tt.ptr<f32>>
+    %4 = arith.addf %3, %3 : tensor<64xf32>
+    tt.store %2, %4 : tensor<64x!tt.ptr<f32>>
+    tt.return
+  }
+}
+
+// -----
+
+module {
+  // COM: Ensure that kernels using DPAS instructions keep a 16-wide subgroup.
+  // CHECK: module attributes {"triton_gpu.threads-per-warp" = 16 : i32
+  tt.func @dot() {
+    %a = arith.constant dense<1.00e+00> : tensor<128x32xf16>
+    %b = arith.constant dense<2.00e+00> : tensor<32x128xf16>
+    %c = arith.constant dense<3.00e+00> : tensor<128x128xf32>
+    %d = tt.dot %a, %b, %c : tensor<128x32xf16> * tensor<32x128xf16> -> tensor<128x128xf32>
+    tt.return
+  }
+}
@@ -0,0 +1,74 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-unroll-dot-loop | FileCheck %s
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-unroll-dot-loop=grf-budget=1 | FileCheck %s --check-prefix=SMALL-BUDGET
+
+// COM: Loops with a small constant trip count are unrolled by the largest
+// COM: factor dividing the trip count, unless the GRF budget is exhausted.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @matmul(%arg0: !tt.ptr<tensor<8x16xf16>>, %arg1: !tt.ptr<tensor<16x16xf16>>) -> tensor<8x16xf32> {
+    // CHECK-LABEL: @matmul
+    // CHECK: scf.for
+    // CHECK-COUNT-4: tt.dot
+    // CHECK-NOT: tt.dot
+    // CHECK: scf.yield
+    // SMALL-BUDGET-LABEL: @matmul
+    // SMALL-BUDGET: scf.for
+    // SMALL-BUDGET-COUNT-1: tt.dot
+    // SMALL-BUDGET-NEXT: scf.yield
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = scf.for %arg2 = %c0_i32 to %c8_i32 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %1 = tt.load %arg0 : !tt.ptr<tensor<8x16xf16>>
+      %2 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %3 = tt.dot %1, %2, %arg3, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %3 : tensor<8x16xf32>
+    }
+    tt.return %0 : tensor<8x16xf32>
+  }
+}
+
+// -----
+
+// COM: Loops with a dynamic trip count are not unrolled.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @dynamic(%arg0: !tt.ptr<tensor<8x16xf16>>, %arg1: !tt.ptr<tensor<16x16xf16>>, %arg2: i32) -> tensor<8x16xf32> {
+    // CHECK-LABEL: @dynamic
+    // CHECK: scf.for
+    // CHECK-COUNT-1: tt.dot
+    // CHECK-NEXT: scf.yield
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %1 = tt.load %arg0 : !tt.ptr<tensor<8x16xf16>>
+      %2 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %3 = tt.dot %1, %2, %arg4, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %3 : tensor<8x16xf32>
+    }
+    tt.return %0 : tensor<8x16xf32>
+  }
+}
+
+// -----
+
+// COM: Loops with an explicit unroll factor are left to the loop unroll pass.
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  tt.func public @explicit(%arg0: !tt.ptr<tensor<8x16xf16>>, %arg1: !tt.ptr<tensor<16x16xf16>>) -> tensor<8x16xf32> {
+    // CHECK-LABEL: @explicit
+    // CHECK: scf.for
+    // CHECK-COUNT-1: tt.dot
+    // CHECK-NEXT: scf.yield
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = scf.for %arg2 = %c0_i32 to %c8_i32 step %c1_i32 iter_args(%arg3 = %cst) -> (tensor<8x16xf32>) : i32 {
+      %1 = tt.load %arg0 : !tt.ptr<tensor<8x16xf16>>
+      %2 = tt.load %arg1 : !tt.ptr<tensor<16x16xf16>>
+      %3 = tt.dot %1, %2, %arg3, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      scf.yield %3 : tensor<8x16xf32>
+    } {tt.loop_unroll_factor = 2 : i32}
+    tt.return %0 : tensor<8x16xf32>
+  }
+}
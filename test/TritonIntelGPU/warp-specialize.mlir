@@ -0,0 +1,91 @@
+// RUN: triton-opt %s -split-input-file -tritonintelgpu-warp-specialize | FileCheck %s
+
+// COM: The prefetches are moved to producer subgroups, synchronized with the consumers by a named barrier.
+// CHECK: module attributes {"triton_gpu.num-warp-groups-per-cta" = 2 : i32
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @matmul
+  tt.func public @matmul(%arg0: !tt.ptr<f16>, %arg1: !tt.ptr<f16>, %arg2: !tt.ptr<f32>) {
+    // CHECK: [[SGID:%.*]] = gpu.subgroup_id : index
+    // CHECK-DAG: [[NUM:%.*]] = arith.constant 8 : index
+    // CHECK-DAG: [[BARRIER:%.*]] = arith.constant 1 : i32
+    // CHECK-DAG: [[COUNT:%.*]] = arith.constant 16 : i32
+    // CHECK: [[COND:%.*]] = arith.cmpi ult, [[SGID]], [[NUM]] : index
+    // CHECK: scf.if [[COND]] {
+    // CHECK-NOT: triton_intel_gpu.prefetch
+    // CHECK: scf.for
+    // CHECK-NEXT: triton_gen.named_barrier_signal [[BARRIER]], [[COUNT]] : (i32, i32)
+    // CHECK: tt.dot
+    // CHECK-NOT: triton_intel_gpu.prefetch
+    // CHECK: triton_gen.named_barrier_wait [[BARRIER]] : i32
+    // CHECK-NEXT: scf.yield
+    // CHECK: tt.store
+    // CHECK: } else {
+    // CHECK: [[PID:%.*]] = arith.subi [[SGID]], [[NUM]] : index
+    // CHECK: arith.index_cast [[PID]] : index to i32
+    // CHECK: [[PTR:%.*]] = tt.make_tensor_ptr %arg0
+    // CHECK-NEXT: triton_intel_gpu.prefetch [[PTR]]
+    // CHECK-NEXT: [[NEXT:%.*]] = tt.advance [[PTR]]
+    // CHECK-NOT: tt.load
+    // CHECK: scf.for {{.*}} iter_args([[ARG:%[a-z0-9]+]] = [[NEXT]]) -> (!tt.ptr<tensor<8x16xf16>>)
+    // CHECK-NEXT: triton_intel_gpu.prefetch [[ARG]]
+    // CHECK-NEXT: [[ADV:%.*]] = tt.advance [[ARG]]
+    // CHECK-NEXT: triton_gen.named_barrier_signal [[BARRIER]], [[COUNT]] : (i32, i32)
+    // CHECK-NEXT: triton_gen.named_barrier_wait [[BARRIER]] : i32
+    // CHECK-NEXT: scf.yield [[ADV]]
+    // CHECK-NOT: tt.store
+    // CHECK: tt.return
+    %c0_i32 = arith.constant 0 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %c16_i32 = arith.constant 16 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %c1024_i64 = arith.constant 1024 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %cst = arith.constant dense<0.000000e+00> : tensor<8x16xf32>
+    %0 = gpu.subgroup_id : index
+    %1 = arith.index_cast %0 : index to i32
+    %2 = arith.muli %1, %c8_i32 : i32
+    %3 = tt.make_tensor_ptr %arg0, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%2, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x16xf16>>
+    triton_intel_gpu.prefetch %3 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<8x16xf16>>
+    %4 = tt.advance %3, [%c0_i32, %c16_i32] : <tensor<8x16xf16>>
+    %5 = tt.make_tensor_ptr %arg0, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%2, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x16xf16>>
+    %6 = tt.make_tensor_ptr %arg1, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%c0_i32, %c0_i32] {order = array<i32: 1, 0>} : <tensor<16x16xf16>>
+    %7:4 = scf.for %arg3 = %c0_i32 to %c1024_i32 step %c16_i32 iter_args(%arg4 = %cst, %arg5 = %5, %arg6 = %6, %arg7 = %4) -> (tensor<8x16xf32>, !tt.ptr<tensor<8x16xf16>>, !tt.ptr<tensor<16x16xf16>>, !tt.ptr<tensor<8x16xf16>>) : i32 {
+      %10 = tt.load %arg5 {DotIdx = 0 : i32} : !tt.ptr<tensor<8x16xf16>>
+      %11 = tt.load %arg6 {DotIdx = 1 : i32} : !tt.ptr<tensor<16x16xf16>>
+      %12 = tt.dot %10, %11, %arg4, inputPrecision = tf32 : tensor<8x16xf16> * tensor<16x16xf16> -> tensor<8x16xf32>
+      triton_intel_gpu.prefetch %arg7 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<8x16xf16>>
+      %13 = tt.advance %arg5, [%c0_i32, %c16_i32] : <tensor<8x16xf16>>
+      %14 = tt.advance %arg6, [%c16_i32, %c0_i32] : <tensor<16x16xf16>>
+      %15 = tt.advance %arg7, [%c0_i32, %c16_i32] : <tensor<8x16xf16>>
+      scf.yield %12, %13, %14, %15 : tensor<8x16xf32>, !tt.ptr<tensor<8x16xf16>>, !tt.ptr<tensor<16x16xf16>>, !tt.ptr<tensor<8x16xf16>>
+    }
+    %8 = tt.make_tensor_ptr %arg2, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%2, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x16xf32>>
+    tt.store %8, %7#0 : !tt.ptr<tensor<8x16xf32>>
+    tt.return
+  }
+}
+
+// -----
+
+// COM: Kernels synchronizing the whole work-group aren't specialized.
+// CHECK: module attributes {"triton_gpu.num-warps" = 8 : i32
+module attributes {"triton_gpu.num-warps" = 8 : i32, "triton_gpu.threads-per-warp" = 16 : i32} {
+  // CHECK-LABEL: tt.func public @work_group_barrier
+  tt.func public @work_group_barrier(%arg0: !tt.ptr<f16>) {
+    // CHECK-NOT: scf.if
+    // CHECK: triton_intel_gpu.prefetch
+    // CHECK-NOT: named_barrier
+    // CHECK: gpu.barrier
+    %c0_i32 = arith.constant 0 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %c1024_i64 = arith.constant 1024 : i64
+    %c1_i64 = arith.constant 1 : i64
+    %0 = gpu.subgroup_id : index
+    %1 = arith.index_cast %0 : index to i32
+    %2 = arith.muli %1, %c8_i32 : i32
+    %3 = tt.make_tensor_ptr %arg0, [%c1024_i64, %c1024_i64], [%c1024_i64, %c1_i64], [%2, %c0_i32] {order = array<i32: 1, 0>} : <tensor<8x16xf16>>
+    triton_intel_gpu.prefetch %3 {cache = 1 : i32, evict = 1 : i32, isVolatile = false} : !tt.ptr<tensor<8x16xf16>>
+    gpu.barrier
+    tt.return
+  }
+}
@@ -0,0 +1,49 @@
+// RUN: triton-opt %s -split-input-file --triton-nvidia-persistent-kernel | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "cuda:90", "triton_gpu.threads-per-warp" = 32 : i32} {
+// CHECK: module attributes {{.*}}triton_nvidia_gpu.persistent = 1 : i32
+// CHECK-LABEL: add_one
+// CHECK-SAME: %[[PTR:.*]]: !tt.ptr<f32>, %[[GRIDX:.*]]: i32, %[[GRIDY:.*]]: i32, %[[GRIDZ:.*]]: i32
+// CHECK: %[[GRIDXY:.*]] = arith.muli %[[GRIDX]], %[[GRIDY]]
+// CHECK: %[[NUM_TILES:.*]] = arith.muli %[[GRIDXY]], %[[GRIDZ]]
+// CHECK: %[[START:.*]] = tt.get_program_id x
+// CHECK: %[[STEP:.*]] = tt.get_num_programs x
+// CHECK: scf.for %[[TILE:.*]] = %[[START]] to %[[NUM_TILES]] step %[[STEP]]
+// CHECK: %[[PID:.*]] = arith.remsi %[[TILE]], %[[GRIDX]]
+// CHECK-NOT: tt.get_program_id
+// CHECK: arith.muli %[[PID]]
+// CHECK: tt.store
+// CHECK: }
+// CHECK: tt.return
+  tt.func public @add_one(%arg0: !tt.ptr<f32>) {
+    %c128_i32 = arith.constant 128 : i32
+    %cst = arith.constant dense<1.000000e+00> : tensor<128xf32, #blocked>
+    %0 = tt.get_program_id x : i32
+    %1 = arith.muli %0, %c128_i32 : i32
+    %2 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32, #blocked>
+    %3 = tt.splat %1 : i32 -> tensor<128xi32, #blocked>
+    %4 = arith.addi %3, %2 : tensor<128xi32, #blocked>
+    %5 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>, #blocked>
+    %6 = tt.addptr %5, %4 : tensor<128x!tt.ptr<f32>, #blocked>, tensor<128xi32, #blocked>
+    %7 = tt.load %6 : tensor<128x!tt.ptr<f32>, #blocked>
+    %8 = arith.addf %7, %cst : tensor<128xf32, #blocked>
+    tt.store %6, %8 : tensor<128x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+// Kernels launched over clusters are left unchanged.
+module attributes {"triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, triton_gpu.target = "cuda:90", "triton_gpu.threads-per-warp" = 32 : i32} {
+// CHECK-NOT: triton_nvidia_gpu.persistent
+// CHECK-LABEL: clustered
+// CHECK-SAME: (%{{.*}}: !tt.ptr<i32>)
+// CHECK-NOT: scf.for
+  tt.func public @clustered(%arg0: !tt.ptr<i32>) {
+    %0 = tt.get_program_id x : i32
+    tt.store %arg0, %0 : !tt.ptr<i32>
+    tt.return
+  }
+}
@@ -0,0 +1,47 @@
+#include "intel/include/Analysis/LayoutConversions.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+using namespace mlir;
+
+namespace {
+
+struct TestLayoutConversionsPass
+    : public PassWrapper<TestLayoutConversionsPass, OperationPass<ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestLayoutConversionsPass)
+
+  StringRef getArgument() const final { return "test-layout-conversions"; }
+
+  StringRef getDescription() const final {
+    return "print the cost of each layout conversion";
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    raw_ostream &os = llvm::errs();
+
+    mod.walk([&](triton::gpu::ConvertLayoutOp op) {
+      triton::gpu::intel::LayoutConversionCost cost =
+          triton::gpu::intel::getLayoutConversionCost(op);
+      op.getLoc().print(os);
+      if (cost.registerLocal) {
+        os << ": register-local\n";
+        return;
+      }
+      os << ": " << (cost.warpLocal ? "warp-local" : "cross-warp") << ", "
+         << cost.slmBytes << " SLM bytes, " << cost.slmTrafficBytes
+         << " bytes moved, " << cost.barriers << " barriers\n";
+    });
+  }
+};
+
+} // end anonymous namespace
+
+namespace mlir {
+namespace test {
+void registerTestLayoutConversionsPass() {
+  PassRegistration<TestLayoutConversionsPass>();
+}
+} // end namespace test
+} // end namespace mlir
@@ -0,0 +1,45 @@
+#include "intel/include/Analysis/RegisterPressure.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+using namespace mlir;
+
+namespace {
+
+struct TestRegisterPressurePass
+    : public PassWrapper<TestRegisterPressurePass, OperationPass<ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestRegisterPressurePass)
+
+  StringRef getArgument() const final { return "test-register-pressure"; }
+
+  StringRef getDescription() const final {
+    return "print the register pressure estimate of each function";
+  }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    raw_ostream &os = llvm::errs();
+    unsigned threadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+
+    mod.walk<WalkOrder::PreOrder>([&](triton::FuncOp func) {
+      auto opName = SymbolTable::getSymbolName(func).getValue().str();
+      os << opName << ": "
+         << triton::gpu::intel::estimateMaxLiveBytesPerThread(func,
+                                                              threadsPerWarp)
+         << " bytes\n";
+    });
+  }
+};
+
+} // end anonymous namespace
+
+namespace mlir {
+namespace test {
+void registerTestRegisterPressurePass() {
+  PassRegistration<TestRegisterPressurePass>();
+}
+} // end namespace test
+} // end namespace mlir
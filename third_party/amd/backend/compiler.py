@@ -168,7 +168,7 @@ class HIPBackend(BaseBackend):
                 # different than the NVIDIA side. In the new pipeliner we unify the num_stages
                 # interpretation. Default to use 2 stages if not explicitly set.
                 num_stages = options.num_stages if options.num_stages != 0 else 2
-                amd.passes.ttgpuir.add_stream_pipelinev2(pm, num_stages)
+                amd.passes.ttgpuir.add_stream_pipelinev2(pm, num_stages, options.waves_per_eu)
             else:
                 if options.num_stages == 0:
                     amd.passes.ttgpuir.add_stream_pipeline(pm)
@@ -262,6 +262,9 @@ class HIPBackend(BaseBackend):
 
         # Get some metadata
         metadata["shared"] = src.get_int_attr("triton_gpu.shared")
+        # The pipeline depth of the loops and the occupancy allowed by their LDS buffers.
+        metadata["pipeline_stages"] = src.get_int_attr("triton_amdgpu.num-stages")
+        metadata["lds_waves_per_eu"] = src.get_int_attr("triton_amdgpu.waves-per-eu")
 
         amd.cleanup_bitcode_metadata(llvm_mod)
         return str(llvm_mod)
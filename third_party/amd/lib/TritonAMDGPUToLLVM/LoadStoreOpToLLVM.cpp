@@ -7,12 +7,17 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "triton/Conversion/TritonGPUToLLVM/Utility.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "triton/Tools/Sys/GetEnv.hpp"
+#include "llvm/ADT/TypeSwitch.h"
 
 using namespace mlir;
 using namespace mlir::triton::gpu;
 
 using ::mlir::LLVM::delinearize;
 using ::mlir::LLVM::getSharedMemoryBase;
+using ::mlir::LLVM::AMD::llBufferLoad;
+using ::mlir::LLVM::AMD::llBufferRsrc;
+using ::mlir::LLVM::AMD::llBufferStore;
 using ::mlir::LLVM::AMD::llLoad;
 using ::mlir::LLVM::AMD::llStore;
 using ::mlir::triton::gpu::getTotalElemsPerThread;
@@ -92,6 +97,38 @@ Value redundantDataMask(Type valueTy, ConversionPatternRewriter &rewriter,
   return mask;
 }
 
+// Return true if the integer `offset` is known to be non-negative, i.e. it is
+// computed from non-negative constants, ranges and program ids by operations
+// preserving the sign, assuming that they do not overflow.
+bool isNonNegativeOffset(Value offset) {
+  APInt constVal;
+  if (matchPattern(offset, m_ConstantInt(&constVal)))
+    return constVal.isNonNegative();
+  Operation *op = offset.getDefiningOp();
+  if (!op)
+    return false;
+  auto allNonNegative = [](Operation *op) {
+    return llvm::all_of(op->getOperands(), isNonNegativeOffset);
+  };
+  auto anyNonNegative = [](Operation *op) {
+    return llvm::any_of(op->getOperands(), isNonNegativeOffset);
+  };
+  return llvm::TypeSwitch<Operation *, bool>(op)
+      .Case<triton::MakeRangeOp, triton::GetProgramIdOp,
+            triton::GetNumProgramsOp, arith::ExtUIOp>(
+          [](Operation *) { return true; })
+      .Case<triton::SplatOp, triton::BroadcastOp, triton::ExpandDimsOp,
+            triton::gpu::ConvertLayoutOp, arith::ExtSIOp, arith::AddIOp,
+            arith::MulIOp, arith::DivSIOp, arith::DivUIOp, arith::RemSIOp,
+            arith::RemUIOp, arith::MinSIOp, arith::ShRUIOp>(allNonNegative)
+      .Case<arith::MaxSIOp, arith::AndIOp>(anyNonNegative)
+      .Case<arith::SelectOp>([](arith::SelectOp selectOp) {
+        return isNonNegativeOffset(selectOp.getTrueValue()) &&
+               isNonNegativeOffset(selectOp.getFalseValue());
+      })
+      .Default([](Operation *) { return false; });
+}
+
 // Contains some helper functions for both Load and Store conversions.
 struct LoadStoreConversionBase {
   explicit LoadStoreConversionBase(const AMD::TargetInfo &targetInfo,
@@ -119,9 +156,40 @@ struct LoadStoreConversionBase {
     return axisAnalysisPass.getMaskAlignment(mask);
   }
 
+  // Returns the scalar base pointer and the tensor of offsets of `ptr` if its
+  // accesses can be lowered to buffer instructions, i.e. if `ptr` splats a
+  // global pointer and offsets it by non-negative 32-bit offsets. The buffers
+  // span 2GB from their base, so this assumes that the tensors accessed do not
+  // exceed 2GB.
+  std::optional<std::pair<Value, Value>>
+  getBufferBaseAndOffsets(Value ptr, triton::CacheModifier cm) const {
+    if (!useBufferOps || cm != triton::CacheModifier::NONE)
+      return std::nullopt;
+    auto addPtrOp = ptr.getDefiningOp<triton::AddPtrOp>();
+    if (!addPtrOp)
+      return std::nullopt;
+    auto splatOp = addPtrOp.getPtr().getDefiningOp<triton::SplatOp>();
+    if (!splatOp)
+      return std::nullopt;
+    Value basePtr = splatOp.getSrc();
+    Value offset = addPtrOp.getOffset();
+    auto ptrTy = cast<triton::PointerType>(basePtr.getType());
+    Type pointeeTy = ptrTy.getPointeeType();
+    if (ptrTy.getAddressSpace() != 1 || !pointeeTy.isIntOrFloat() ||
+        pointeeTy.getIntOrFloatBitWidth() < 8 ||
+        !getElementTypeOrSelf(offset).isInteger(32) ||
+        !isNonNegativeOffset(offset))
+      return std::nullopt;
+    return std::make_pair(basePtr, offset);
+  }
+
 protected:
   const AMD::TargetInfo &targetInfo;
   ModuleAxisInfoAnalysis &axisAnalysisPass;
+  // Lower the accesses to buffers to buffer instructions, whose hardware
+  // range checking implements the masks.
+  const bool useBufferOps =
+      triton::tools::getBoolEnv("AMDGCN_USE_BUFFER_OPS");
 };
 
 struct LoadOpConversion : public ConvertOpToLLVMPattern<triton::LoadOp>,
@@ -196,6 +264,22 @@ struct LoadOpConversion : public ConvertOpToLLVMPattern<triton::LoadOp>,
     const int numVecs = numElems / vec;
 
     auto cacheMod = op.getCache();
+
+    // Get the buffer resource and the LLVM values for the offsets, if the
+    // load can use buffer instructions
+    Value rsrc;
+    SmallVector<Value> offsetElems;
+    if (auto baseAndOffsets = getBufferBaseAndOffsets(ptr, cacheMod)) {
+      rsrc = llBufferRsrc(rewriter, loc,
+                          rewriter.getRemappedValue(baseAndOffsets->first),
+                          targetInfo.getISAFamily());
+      offsetElems = unpackLLElements(
+          loc, rewriter.getRemappedValue(baseAndOffsets->second), rewriter);
+      assert(offsetElems.size() == numElems);
+    }
+    // The buffer loads return 0 for the masked-off elements
+    bool needOther = other && !isZeroConst(other);
+
     SmallVector<Value> loadedVals;
     for (size_t vecStart = 0; vecStart < numElems; vecStart += vec) {
       size_t in_off = 0;
@@ -230,8 +314,15 @@ struct LoadOpConversion : public ConvertOpToLLVMPattern<triton::LoadOp>,
         falseVal = v;
       }
 
-      auto loadVal =
-          llLoad(rewriter, loc, ptr, vecTy, pred, falseVal, cacheMod);
+      Value loadVal;
+      if (rsrc) {
+        Value offset =
+            mul(offsetElems[vecStart], i32_val(valueElemNBits / 8));
+        loadVal = llBufferLoad(rewriter, loc, rsrc, offset, vecTy, pred,
+                               needOther ? falseVal : Value());
+      } else {
+        loadVal = llLoad(rewriter, loc, ptr, vecTy, pred, falseVal, cacheMod);
+      }
       for (size_t ii = 0; ii < vec; ++ii) {
         Value vecIdx = createIndexAttrConstant(
             rewriter, loc, this->getTypeConverter()->getIndexType(), ii % vec);
@@ -301,6 +392,19 @@ struct StoreOpConversion : public ConvertOpToLLVMPattern<triton::StoreOp>,
     auto cacheMod = op.getCache();
     const int numVecs = elemsPerThread / vec;
     Value rDataMask = redundantDataMask(valueTy, rewriter, loc, targetInfo);
+
+    // Get the buffer resource and the LLVM values for the offsets, if the
+    // store can use buffer instructions
+    Value rsrc;
+    SmallVector<Value> offsetElems;
+    if (auto baseAndOffsets = getBufferBaseAndOffsets(ptr, cacheMod)) {
+      rsrc = llBufferRsrc(rewriter, loc,
+                          rewriter.getRemappedValue(baseAndOffsets->first),
+                          targetInfo.getISAFamily());
+      offsetElems = unpackLLElements(
+          loc, rewriter.getRemappedValue(baseAndOffsets->second), rewriter);
+      assert(offsetElems.size() == elemsPerThread);
+    }
     for (size_t vecStart = 0; vecStart < elemsPerThread; vecStart += vec) {
       size_t in_off = 0;
       Value pred = mask ? and_(maskElems[vecStart], rDataMask) : rDataMask;
@@ -328,7 +432,12 @@ struct StoreOpConversion : public ConvertOpToLLVMPattern<triton::StoreOp>,
             rewriter, loc, this->getTypeConverter()->getIndexType(), s);
         storeVal = insert_element(vecTy, storeVal, otherElem, indexVal);
       }
-      llStore(rewriter, loc, ptr, storeVal, pred, cacheMod);
+      if (rsrc) {
+        Value offset = mul(offsetElems[vecStart], i32_val(dtsize));
+        llBufferStore(rewriter, loc, rsrc, offset, storeVal, pred);
+      } else {
+        llStore(rewriter, loc, ptr, storeVal, pred, cacheMod);
+      }
     } // end vec
     rewriter.eraseOp(op);
     return success();
@@ -8,6 +8,8 @@
 #include "triton/Conversion/TritonGPUToLLVM/Utility.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 
+#include <limits>
+
 using mlir::triton::gpu::appendOrGetExternFuncOp;
 using mlir::triton::gpu::getFunctionType;
 
@@ -68,6 +70,23 @@ Type castToVectorType(Type ty) {
   return LLVM::getFixedVectorType(ty, 1);
 }
 
+// The byte offsets of a buffer are in the range [0, maxBufferOffset). The
+// offset maxBufferOffset is out of range, and so are the negative offsets read
+// as unsigned.
+constexpr int32_t maxBufferOffset = std::numeric_limits<int32_t>::max();
+
+// Returns the type accessed by the buffer instructions for `type`: the
+// sub-word vectors are packed into integers, and the vectors of more than 32
+// bits into vectors of 32-bit integers.
+Type getBufferOpType(RewriterBase &rewriter, Type type) {
+  Type elemTy = getElementTypeOrSelf(type);
+  const int64_t totalBits =
+      getNumElements(type) * std::max(8u, elemTy.getIntOrFloatBitWidth());
+  if (totalBits <= 32)
+    return rewriter.getIntegerType(totalBits);
+  return LLVM::getFixedVectorType(rewriter.getI32Type(), totalBits / 32);
+}
+
 } // namespace
 
 namespace mlir::LLVM::AMD {
@@ -275,4 +294,41 @@ void llStore(RewriterBase &rewriter, Location loc, Value ptr, Value val,
   rewriter.create<LLVM::CallOp>(loc, funcOp, ValueRange({ptr, val, pred}));
 }
 
+Value llBufferRsrc(RewriterBase &rewriter, Location loc, Value basePtr,
+                   triton::AMD::ISAFamily isaFamily) {
+  // The data format (bits 12-18) is ignored by the raw buffer instructions,
+  // but must be non-zero: 32-bit float. The RDNA targets also need the bit 24
+  // set, and their out-of-range check (bits 28-29) to test the offset.
+  uint32_t flags = (7 << 12) | (4 << 15);
+  if (isaFamily == triton::AMD::ISAFamily::RDNA2 ||
+      isaFamily == triton::AMD::ISAFamily::RDNA3)
+    flags |= (1 << 24) | (3 << 28);
+  Type rsrcTy = ptr_ty(rewriter.getContext(), 8);
+  return rewriter.create<ROCDL::MakeBufferRsrcOp>(
+      loc, rsrcTy, basePtr, int_val(16, 0), i32_val(maxBufferOffset),
+      i32_val(flags));
+}
+
+Value llBufferLoad(RewriterBase &rewriter, Location loc, Value rsrc,
+                   Value offset, Type elemTy, Value pred, Value falseVal) {
+  Value maskedOffset = select(pred, offset, i32_val(maxBufferOffset));
+  Type bufferTy = getBufferOpType(rewriter, elemTy);
+  Value loadVal = rewriter.create<ROCDL::RawPtrBufferLoadOp>(
+      loc, bufferTy, ValueRange{rsrc, maskedOffset, i32_val(0), i32_val(0)});
+  loadVal = bitcast(loadVal, elemTy);
+  if (falseVal)
+    loadVal = select(pred, loadVal, falseVal);
+  return loadVal;
+}
+
+void llBufferStore(RewriterBase &rewriter, Location loc, Value rsrc,
+                   Value offset, Value val, Value pred) {
+  Value maskedOffset = select(pred, offset, i32_val(maxBufferOffset));
+  val = bitcast(val, getBufferOpType(rewriter, val.getType()));
+  rewriter.create<ROCDL::RawPtrBufferStoreOp>(
+      loc, TypeRange{},
+      ValueRange{val, rsrc, maskedOffset, i32_val(0), i32_val(0)},
+      ArrayRef<NamedAttribute>());
+}
+
 } // namespace mlir::LLVM::AMD
@@ -2,6 +2,7 @@
 #define TRITON_CONVERSION_TRITONAMDGPU_TO_LLVM_UTILITY_H
 
 #include "TritonAMDGPUToLLVM/GCNAsmFormat.h"
+#include "TritonAMDGPUToLLVM/TargetUtils.h"
 
 #include "mlir/Conversion/LLVMCommon/Pattern.h"
 #include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
@@ -36,6 +37,25 @@ Value llLoad(RewriterBase &rewriter, Location loc, Value ptr, Type elemTy,
 void llStore(RewriterBase &rewriter, Location loc, Value ptr, Value val,
              Value pred,
              triton::CacheModifier cm = triton::CacheModifier::NONE);
+
+// Creates the resource descriptor of a buffer starting at the global pointer
+// `basePtr`, spanning the whole range of the non-negative 32-bit byte offsets.
+// The buffer instructions accessing it return 0 for the loads, and drop the
+// stores, out of its range.
+Value llBufferRsrc(RewriterBase &rewriter, Location loc, Value basePtr,
+                   triton::AMD::ISAFamily isaFamily);
+
+// Loads from the byte `offset` of the buffer `rsrc` with predication. The
+// lanes whose predicate is false access an offset out of range of the buffer,
+// so that the hardware returns 0 without a branch, and get `falseVal` instead
+// if not null.
+Value llBufferLoad(RewriterBase &rewriter, Location loc, Value rsrc,
+                   Value offset, Type elemTy, Value pred, Value falseVal);
+
+// Stores to the byte `offset` of the buffer `rsrc` with predication. The
+// stores of the lanes whose predicate is false are dropped by the hardware.
+void llBufferStore(RewriterBase &rewriter, Location loc, Value rsrc,
+                   Value offset, Value val, Value pred);
 } // namespace mlir::LLVM::AMD
 
 #endif
@@ -660,24 +660,113 @@ static bool pipelineLoop(scf::ForOp forOp, int numStages) {
   return succeeded(tt::pipelineForLoop(rewriter, forOp, options));
 }
 
+// The number of SIMDs (EUs) of a compute unit, and their largest number of
+// waves.
+static constexpr int numEUsPerCU = 4;
+static constexpr int maxWavesPerEU = 8;
+
+// Return the LDS bytes of one buffer of the loads of the loop going through
+// shared memory once pipelined.
+static int64_t getLDSBytesPerBuffer(scf::ForOp forOp) {
+  ModuleOp moduleOp = forOp->getParentOfType<ModuleOp>();
+  tt::ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
+  llvm::SmallVector<std::tuple<Operation *, int, Operation *>>
+      loadOpToIndLevelAndUse = loadOpsToIndirectionLevelAndUse(forOp);
+  llvm::MapVector<Operation *, LoadInfo> loadToInfo =
+      assignMemoryLayouts(loadOpToIndLevelAndUse, axisInfoAnalysis);
+  int64_t bytes = 0;
+  for (auto &[loadOp, info] : loadToInfo) {
+    if (!info.sharedEncoding)
+      continue;
+    auto ty = cast<RankedTensorType>(loadOp->getResultTypes()[0]);
+    bytes += ty.getNumElements() * ty.getElementTypeBitWidth() / 8;
+  }
+  return bytes;
+}
+
+// Return the number of waves per EU allowed by work-groups of `numWarps` waves
+// allocating `ldsBytes` bytes each out of the `ldsSize` bytes of a CU.
+static int getLDSWavesPerEU(int64_t ldsBytes, int numWarps, int ldsSize) {
+  if (ldsBytes == 0)
+    return maxWavesPerEU;
+  int64_t numWorkGroups = ldsSize / ldsBytes;
+  return std::min<int64_t>(
+      maxWavesPerEU, llvm::divideCeil(numWorkGroups * numWarps, numEUsPerCU));
+}
+
 namespace {
 struct PipelinePass : public TritonAMDGPUStreamPipelineV2Base<PipelinePass> {
   PipelinePass() = default;
-  PipelinePass(int32_t numStages) { this->numStages = numStages; }
+  PipelinePass(int32_t numStages, int32_t wavesPerEU) {
+    this->numStages = numStages;
+    this->wavesPerEU = wavesPerEU;
+  }
 
   void runOnOperation() override {
+    ModuleOp moduleOp = getOperation();
     SmallVector<scf::ForOp> loops;
-    getOperation()->walk([&](scf::ForOp forOp) {
+    moduleOp->walk([&](scf::ForOp forOp) {
       // Bail out for loops with num_stage <= 1.
       if (getNumStagesOrDefault(forOp) > 1)
         loops.push_back(forOp);
     });
 
-    for (scf::ForOp forOp : loops)
-      pipelineLoop(forOp, getNumStagesOrDefault(forOp));
+    int numWarps = ttg::TritonGPUDialect::getNumWarps(moduleOp);
+    int pipelineStages = 0;
+    int ldsWavesPerEU = maxWavesPerEU;
+    for (scf::ForOp forOp : loops) {
+      int64_t bytesPerBuffer = getLDSBytesPerBuffer(forOp);
+      int stages = planNumStages(forOp, getNumStagesOrDefault(forOp),
+                                 bytesPerBuffer, numWarps);
+      if (!pipelineLoop(forOp, stages))
+        continue;
+      pipelineStages = std::max(pipelineStages, stages);
+      ldsWavesPerEU = std::min(
+          ldsWavesPerEU,
+          getLDSWavesPerEU((stages - 1) * bytesPerBuffer, numWarps, ldsSize));
+    }
+
+    // Report the pipeline depth, and the occupancy allowed by its buffers, in
+    // the kernel metadata.
+    if (pipelineStages > 0) {
+      Builder b(moduleOp.getContext());
+      moduleOp->setAttr("triton_amdgpu.num-stages",
+                        b.getI32IntegerAttr(pipelineStages));
+      moduleOp->setAttr("triton_amdgpu.waves-per-eu",
+                        b.getI32IntegerAttr(ldsWavesPerEU));
+    }
   }
 
 private:
+  // Return the number of stages of the loop, reduced from `numStages` until
+  // the `numStages - 1` buffers of its loads allow `wavesPerEU` waves per EU,
+  // down to 2 stages (single buffering).
+  int planNumStages(scf::ForOp forOp, int numStages, int64_t bytesPerBuffer,
+                    int numWarps) {
+    if (wavesPerEU <= 0)
+      return numStages;
+    auto getWaves = [&](int stages) {
+      return getLDSWavesPerEU((stages - 1) * bytesPerBuffer, numWarps,
+                              ldsSize);
+    };
+    int stages = numStages;
+    while (stages > 2 && getWaves(stages) < wavesPerEU)
+      --stages;
+    LDBG("planned " << stages << " stages using " << bytesPerBuffer
+                    << " bytes per buffer for " << getWaves(stages)
+                    << " waves per EU");
+    if (stages != numStages)
+      forOp->emitRemark() << "reduced the pipeline depth from " << numStages
+                          << " to " << stages << " stages for "
+                          << getWaves(stages) << " waves per EU";
+    if (getWaves(stages) < wavesPerEU)
+      forOp->emitWarning() << "the LDS usage of the pipelined loop limits the "
+                           << "occupancy to " << getWaves(stages)
+                           << " waves per EU, below the target of "
+                           << wavesPerEU;
+    return stages;
+  }
+
   int getNumStagesOrDefault(scf::ForOp forOp) {
     // Use the attribute attached to the loop if it exists, otherwise use the
     // global control.
@@ -689,6 +778,6 @@ private:
 } // anonymous namespace
 
 std::unique_ptr<Pass>
-mlir::createTritonAMDGPUStreamPipelineV2Pass(int numStages) {
-  return std::make_unique<PipelinePass>(numStages);
+mlir::createTritonAMDGPUStreamPipelineV2Pass(int numStages, int wavesPerEU) {
+  return std::make_unique<PipelinePass>(numStages, wavesPerEU);
 }
@@ -10,9 +10,15 @@ import re
 import os
 import shutil
 import subprocess
+import time
 from pathlib import Path
 
 
+# The LLVM IR stored for a kernel when its text is not kept, see
+# `XPUBackend.keep_llir`.
+LLIR_NOT_KEPT = "; LLVM IR not kept, set TRITON_INTEL_KEEP_LLIR=1 to keep it\n"
+
+
 @functools.lru_cache()
 def _path_to_binary(binary: str):
     paths = [
@@ -38,16 +44,51 @@ class XPUOptions:
     num_ctas: int = 1
     num_stages: int = 2
     cluster_dims: tuple = (1, 1, 1)
-    threads_per_warp: int = 32
+    # 0 selects the sub-group size per kernel: 16 for kernels using DPAS instructions, otherwise 32 unless the kernel's
+    # tensors are too small to occupy 32 lanes.
+    threads_per_warp: int = 0
     optimize_epilogue: bool = False
     enable_fp_fusion: bool = True
     supported_fp8_dtypes: Tuple[str] = ("fp8e5", "fp8e4nv", "fp8e4b15")
     deprecated_fp8_dtypes: Tuple[str] = ()
     default_dot_input_precision: str = "tf32"
-    allowed_dot_input_precisions: Tuple[str] = ("tf32", "tf32x3", "ieee")
+    allowed_dot_input_precisions: Tuple[str] = ("tf32", "tf32x3", "ieee", "bf16x3")
     allow_fp8e4nv: bool = False
     allow_fp8e4b15: bool = True
     grf_mode: tuple = ('small', 'large', 'auto', 'default')
+    # Spill size (in bytes) above which a kernel without an explicit `grf_mode` is compiled in large GRF mode.
+    max_reg_spill: int = 1000
+    # LLVM pipeline: 'full' (O3) for final builds, or 'fast' (O1 without loop optimizations and SLP vectorization) to cut
+    # the compile time of e.g. autotuning sweeps. IGC optimizes the resulting SPIR-V in both cases.
+    llvm_pipeline: str = 'full'
+    # Accuracy of the FP32 transcendental functions (exp, log, sin, tanh, ...): 'ieee' calls the math library, 'approx'
+    # the OpenCL builtins (a few ulp), and 'fast' the native hardware functions, e.g. for GELU, SiLU or softmax epilogues.
+    math_precision: str = 'ieee'
+    # Launch all the programs of the kernel at once, so that they can synchronize with
+    # `tl.extra.intel.grid_barrier`. The launcher clamps the grid along X to the work-groups resident on the device.
+    launch_cooperative_grid: bool = False
+    # Start the kernel without waiting for the kernels launched before it on the queue, so that its prologue overlaps
+    # their tail. It waits for their data with `tl.extra.intel.dependent.wait_dependency`. The grid must fit on the
+    # device at once.
+    launch_pdl: bool = False
+    # Walk the launch grid of kernels reading their program ids along X and Y by groups of `grid_swizzle` rows along X,
+    # so that the programs running at once compute a block of tiles sharing their operand blocks in the L3 cache. -1
+    # sizes the groups to the Xe-cores and the L3 cache of the device, and 0 keeps the dispatch order.
+    grid_swizzle: int = 0
+    # Compile the kernel with the advanced (warp-level) pipeline if it supports it, i.e. its dots use DPAS instructions
+    # and its loads and stores use block pointers. None follows `TRITON_INTEL_ADVANCED_PATH`.
+    advanced_path: bool = None
+    # Number of consecutive work-groups along X loading the same panels of the 2nd operand of their dots, e.g. the
+    # GROUP_SIZE_M of a grouped GEMM. On the advanced path, each of them then only prefetches a share of these panels,
+    # into L3 only, instead of all of them prefetching the whole panels.
+    prefetch_sharing: int = 1
+    # Maximum number of DPAS repetitions (M, N) of a sub-group grouped in a cluster, whose operands are each loaded by
+    # a single 2D block load. 0 takes the largest cluster such a load fills: fewer, larger loads, but more registers.
+    dpas_rep_cluster: tuple = (0, 0)
+    # Shared local memory (in bytes) the pipeline of the kernel plans for, up to the SLM of an Xe-core (128 KB on PVC).
+    # 0 plans for two work-groups per Xe-core, i.e. half of it. A larger SLM stages more buffers of the dot operands,
+    # e.g. for deep attention pipelines, at the cost of the occupancy and of the L1 cache, which shares its storage.
+    slm_size: int = 0
     max_num_imprecise_acc_default: int = 0  # `max_num_imprecise_acc` only applies to fp8 -> fp32 dot on sm_90 for cuda
     extern_libs: dict = None
     debug: bool = False
@@ -60,14 +101,42 @@ class XPUOptions:
             extern_libs['libdevice'] = os.getenv("TRITON_LIBDEVICE_PATH",
                                                  str(default_libdir / 'libsycl-spir64-unknown-unknown.bc'))
         object.__setattr__(self, 'extern_libs', tuple(extern_libs.items()))
+        if self.advanced_path is None:
+            object.__setattr__(self, 'advanced_path', os.getenv("TRITON_INTEL_ADVANCED_PATH", "0") == "1")
         if self.num_warps <= 0 or (self.num_warps & (self.num_warps - 1)) != 0:
             raise AssertionError("num_warps must be a power of 2")
+        if self.llvm_pipeline not in ('full', 'fast'):
+            raise AssertionError("llvm_pipeline must be 'full' or 'fast'")
+        if self.math_precision not in ('ieee', 'approx', 'fast'):
+            raise AssertionError("math_precision must be 'ieee', 'approx' or 'fast'")
+        if self.prefetch_sharing < 1:
+            raise AssertionError("prefetch_sharing must be a positive number of work-groups")
+        if self.grid_swizzle < -1:
+            raise AssertionError("grid_swizzle must be a number of rows, -1 or 0")
+        object.__setattr__(self, 'dpas_rep_cluster', tuple(self.dpas_rep_cluster))
+        if len(self.dpas_rep_cluster) != 2 or any(size < 0 or size & (size - 1) for size in self.dpas_rep_cluster):
+            raise AssertionError("dpas_rep_cluster must be a pair of powers of 2 or 0")
+        if self.slm_size < 0:
+            raise AssertionError("slm_size must be a number of bytes or 0")
 
     def hash(self):
         key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items()])
         return hashlib.sha256(key.encode("utf-8")).hexdigest()
 
 
+def report_compile_time(scope_name, elapsed):
+    """
+    Records a compile step taking `elapsed` seconds as a Proton scope with a
+    `compile_time/ms` metric, if Proton is available and profiling.
+    """
+    try:
+        import triton.profiler as proton
+    except ImportError:
+        return
+    with proton.scope(scope_name, metrics={"compile_time/ms": elapsed * 1e3}):
+        pass
+
+
 def min_dot_size(device_props: dict):
     # (M, N, K)
     # M: repeatCount. 1,2,4,8
@@ -100,14 +169,29 @@ class XPUBackend(BaseBackend):
 
             intel.passes.ttir.add_convert_to_ttgpuir_warp(pm, opt.num_warps)
             inject_split_barriers = False
-            intel.passes.ttgpuir.add_prefetch_block(pm, opt.num_stages, inject_split_barriers)
+            adaptive_prefetch = os.getenv("TRITON_INTEL_ADAPTIVE_PREFETCH", "1") == "1"
+            intel.passes.ttgpuir.add_prefetch_block(pm, opt.num_stages, inject_split_barriers, adaptive_prefetch,
+                                                    opt.prefetch_sharing)
             intel.passes.ttgpuir.add_distribute_to_warps(pm)
             passes.common.add_canonicalizer(pm)
             passes.common.add_cse(pm)
             intel.passes.ttgpuir.add_match_target_size(pm)
             passes.common.add_canonicalizer(pm)
             passes.common.add_cse(pm)
-            intel.passes.ttgpuir.add_schedule_load(pm)
+            intel.passes.ttgpuir.add_coalesce_block_loads(pm)
+            passes.common.add_canonicalizer(pm)
+            if os.getenv("TRITON_INTEL_WARP_SPECIALIZE", "0") == "1":
+                intel.passes.ttgpuir.add_warp_specialize(pm)
+                passes.common.add_canonicalizer(pm)
+            grf_budget = 256 if opt.grf_mode == 'large' and XPUBackend.supports_large_grf(opt.num_warps) else 128
+            # Unroll the short dot loops so that the scheduler interleaves the DPAS chains of their iterations.
+            intel.passes.ttgpuir.add_unroll_dot_loop(pm, grf_budget, 16, 4)
+            passes.common.add_canonicalizer(pm)
+            # The naive scheduler moving loads next to their dots is kept behind `TRITON_INTEL_ENABLE_INSTR_SCHED`.
+            if os.getenv("TRITON_INTEL_ENABLE_INSTR_SCHED", "0") == "1":
+                intel.passes.ttgpuir.add_schedule_load(pm)
+            else:
+                intel.passes.ttgpuir.add_schedule_loop(pm, grf_budget, 32, 200)
             passes.common.add_symbol_dce(pm)
             pm.run(mod)
             return mod
@@ -139,8 +223,14 @@ class XPUBackend(BaseBackend):
                                                                            False)
         dev_prop['has_subgroup_matrix_multiply_accumulate_tensor_float32'] = tgt_prop.get(
             'has_subgroup_matrix_multiply_accumulate_tensor_float32', False)
+        dev_prop['has_subgroup_matrix_multiply_accumulate_fp8'] = tgt_prop.get(
+            'has_subgroup_matrix_multiply_accumulate_fp8', False)
         dev_prop['has_subgroup_2d_block_io'] = tgt_prop.get('has_subgroup_2d_block_io', False)
         dev_prop['has_bfloat16_conversions'] = tgt_prop.get('has_bfloat16_conversions', True)
+        # SLM shared by the workgroups resident on an Xe-core (PVC default).
+        dev_prop['slm_size_per_xe_core'] = tgt_prop.get('slm_size_per_xe_core', 128 * 1024)
+        # Size (in bytes) of the last level cache, or 0 if unknown.
+        dev_prop['l3_cache_size'] = tgt_prop.get('l3_cache_size', 0)
         return dev_prop
 
     def parse_options(self, opts) -> Any:
@@ -170,6 +260,7 @@ class XPUBackend(BaseBackend):
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
         passes.common.add_inliner(pm)
+        intel.passes.ttir.add_tensor_descriptor_to_block_pointer(pm)
         passes.ttir.add_combine(pm)
         passes.common.add_canonicalizer(pm)
         passes.ttir.add_reorder_broadcast(pm)
@@ -193,7 +284,15 @@ class XPUBackend(BaseBackend):
         intel.passes.ttgpuir.add_triton_annotate_module(pm, min(properties["sub_group_sizes"]),
                                                         properties["has_subgroup_2d_block_io"],
                                                         properties["has_subgroup_matrix_multiply_accumulate"],
-                                                        properties["has_bfloat16_conversions"], opt.threads_per_warp)
+                                                        properties["has_subgroup_matrix_multiply_accumulate_fp8"],
+                                                        properties["has_bfloat16_conversions"], opt.threads_per_warp,
+                                                        opt.num_warps, opt.advanced_path)
+        # Split the FP32 dots emulated with several DPAS dots before lowering.
+        intel.passes.ttgpuir.add_decompose_f32_dot(pm)
+        if opt.grid_swizzle:
+            num_xe_cores = properties["gpu_subslice_count"] or 0
+            l3_cache_size = min(properties["l3_cache_size"], 2**32 - 1)
+            intel.passes.ttgpuir.add_swizzle_program_ids(pm, max(opt.grid_swizzle, 0), num_xe_cores, l3_cache_size)
         pm.run(mod)
 
         # Overwrite the threads_per_warp option with the module annotation.
@@ -203,42 +302,204 @@ class XPUBackend(BaseBackend):
         pm = ir.pass_manager(mod.context)
         pm.enable_debug()
 
-        if (properties["has_subgroup_2d_block_io"] and properties["has_subgroup_matrix_multiply_accumulate"]
-                and os.getenv("TRITON_INTEL_ADVANCED_PATH", "0") == "1"):
+        # The module annotation records whether the kernel supports the advanced path.
+        metadata["advanced_path"] = bool(mod.get_int_attr("triton_intel_gpu.advanced_path"))
+        if metadata["advanced_path"]:
             return XPUBackend.AdvancedPath.make_ttgir(mod, metadata, opt)
 
+        # The L1 cache and SLM of a Xe-core share the same storage: the dot operands whose duplicated loads would
+        # miss a cache of the size of the SLM are loaded cooperatively through SLM instead.
+        cache_size = properties["slm_size_per_xe_core"]
+
         passes.ttir.add_convert_to_ttgpuir(pm, "xpu", opt.num_warps, opt.threads_per_warp, opt.num_ctas)
-        intel.passes.ttgpuir.add_accelerate_matmul(pm)
-        intel.passes.ttgpuir.add_remove_layout_conversions(pm)
+        intel.passes.ttgpuir.add_accelerate_matmul(pm, *opt.dpas_rep_cluster)
+        intel.passes.ttgpuir.add_remove_layout_conversions(pm, cache_size)
+        intel.passes.ttgpuir.add_remove_redundant_masks(pm)
+        passes.common.add_canonicalizer(pm)
         intel.passes.ttgpuir.add_materialize_block_pointer(pm)
+        intel.passes.ttgpuir.add_peel_masked_tail(pm)
         intel.passes.ttgpuir.add_rewrite_tensor_pointer(pm)
-        intel.passes.ttgpuir.add_pipeline(pm, opt.num_stages, False)
-
-        passes.ttgpuir.add_coalesce(pm)
-        intel.passes.ttgpuir.add_remove_layout_conversions(pm)
+        # Targets without 2D block IO stage the dot operands in SLM, in as many buffers as fit in the SLM budget.
+        intel.passes.ttgpuir.add_pipeline(pm, opt.num_stages, False,
+                                          os.getenv("TRITON_INTEL_PIPELINE_SLM", "0") == "1",
+                                          XPUBackend.get_slm_budget(properties, opt))
+
+        intel.passes.ttgpuir.add_coalesce(pm)
+        # Keep the reduction rows within a sub-group before the layouts are propagated.
+        intel.passes.ttgpuir.add_optimize_reduction_locality(pm)
+        intel.passes.ttgpuir.add_remove_layout_conversions(pm, cache_size)
         passes.ttgpuir.add_optimize_thread_locality(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm, True)
         passes.common.add_cse(pm)
         passes.ttgpuir.add_prefetch(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm, True)
-        intel.passes.ttgpuir.add_remove_layout_conversions(pm)
+        intel.passes.ttgpuir.add_optimize_epilogue(pm)
+        intel.passes.ttgpuir.add_remove_layout_conversions(pm, cache_size)
         intel.passes.ttgpuir.add_reduce_data_duplication(pm)
+        # Peel the first iteration of the K-loops so that DPAS starts from a constant zero accumulator.
+        intel.passes.ttgpuir.add_optimize_accumulator_init(pm)
+        # Carry scalar base pointers and tensors of offsets through the loops instead of tensors of pointers.
+        intel.passes.ttgpuir.add_canonicalize_pointers(pm)
+        passes.common.add_canonicalizer(pm)
         passes.ttgpuir.add_reorder_instructions(pm)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         passes.common.add_canonicalizer(pm)
+        # Recompute the cheap loop invariant tensors in the dot loops spilling in the small GRF mode. CSE would hoist
+        # them out of the loops again.
+        intel.passes.ttgpuir.add_rematerialize(pm, 128, 8)
         pm.run(mod)
         metadata["cluster_dims"] = (cluster_info.clusterDimX, cluster_info.clusterDimY, cluster_info.clusterDimZ)
+        # Report the layout conversions left by the pipeline, which are usually
+        # lowered through SLM.
+        metadata["layout_conversions"] = intel.get_layout_conversions(mod)
         return mod
 
     @staticmethod
-    def make_llir(src, metadata, options):
+    def supports_large_grf(num_warps):
+        # An Xe-core runs half as many hardware threads in the large GRF mode, too few for a work-group of more than 32
+        # sub-groups.
+        return num_warps <= 32
+
+    @staticmethod
+    def get_grf_mode(metadata, options):
+        num_warps = metadata.get("num_warps", options.num_warps)
+        if options.grf_mode == 'large' and not XPUBackend.supports_large_grf(num_warps):
+            # Let IGC select the GRF mode, rather than failing the kernel, e.g. the configs of an autotuning sweep over
+            # `num_warps`.
+            return 'auto'
+        if options.grf_mode in ('small', 'large', 'auto'):
+            return options.grf_mode
+        # A sub-group runs on a hardware thread, which has 128 64-byte GRFs in
+        # the default (small) GRF mode. Estimate the spill size from the
+        # register pressure of the TTGIR to select the large GRF mode upfront
+        # rather than after recompiling the kernel in `load_binary`.
+        small_grf_bytes = 128 * 64
+        spills = metadata.get("live_bytes", 0) - small_grf_bytes > options.max_reg_spill
+        if spills and XPUBackend.supports_large_grf(num_warps):
+            return 'large'
+        return 'default'
+
+    @staticmethod
+    def get_slm_budget(properties, options):
+        slm_size_per_xe_core = properties["slm_size_per_xe_core"]
+        if options.slm_size:
+            return min(options.slm_size, slm_size_per_xe_core)
+        return slm_size_per_xe_core // 2
+
+    @staticmethod
+    def get_threads_per_xe_core(properties, grf_mode):
+        eu_count, subslice_count = properties["gpu_eu_count"], properties["gpu_subslice_count"]
+        if not eu_count or not subslice_count:
+            return 0
+        # Each EU (XVE) runs 8 hardware threads, or 4 in the large GRF mode.
+        threads_per_eu = 4 if grf_mode == 'large' else 8
+        return eu_count // subslice_count * threads_per_eu
+
+    def get_option_stages(self, options):
+        """
+        The earliest stage each option affects, if not the first one. The
+        compiled stages are reused when only the options of later stages
+        change. The options mapped to None only affect `finalize_metadata`,
+        e.g. the GRF mode, which IGC applies when it loads the SPIR-V.
+        """
+        return {
+            # Autotuning the launch options reuses the TTIR without tracing
+            # again, unless the kernel reads them, e.g. with `num_warps()`.
+            "num_warps": "ttgir",
+            "num_stages": "ttgir",
+            "num_ctas": "ttgir",
+            "cluster_dims": "ttgir",
+            "threads_per_warp": "ttgir",
+            "optimize_epilogue": "ttgir",
+            "grid_swizzle": "ttgir",
+            "prefetch_sharing": "ttgir",
+            "slm_size": "ttgir",
+            "llvm_pipeline": "llir",
+            "math_precision": "llir",
+            "extern_libs": "llir",
+            # The advanced path unrolls the dot loops within the GRF budget.
+            "grf_mode": "ttgir" if options.advanced_path else None,
+            "max_reg_spill": None,
+            "launch_cooperative_grid": None,
+            "launch_pdl": None,
+        }
+
+    def finalize_metadata(self, metadata, options):
+        grf_mode = XPUBackend.get_grf_mode(metadata, options)
+        metadata["grf_mode"] = grf_mode
+        # Records the large GRF mode requested for a work-group too large for it.
+        metadata["grf_mode_fallback"] = options.grf_mode == 'large' and grf_mode != 'large'
+        if grf_mode == 'small':
+            metadata["build_flags"] = "-cl-intel-128-GRF-per-thread"
+        elif grf_mode == 'large':
+            metadata["build_flags"] = "-cl-intel-256-GRF-per-thread"
+        elif grf_mode == 'auto':
+            metadata["build_flags"] = "-cl-intel-enable-auto-large-GRF-mode"
+        else:
+            metadata["build_flags"] = ""
+        # The SLM allocation reports the occupancy of the default GRF mode.
+        threads_per_xe_core = XPUBackend.get_threads_per_xe_core(self.properties, grf_mode)
+        if grf_mode == 'large' and metadata.get("workgroups_per_xe_core") and threads_per_xe_core:
+            workgroups = threads_per_xe_core // metadata["num_warps"]
+            if metadata.get("shared"):
+                workgroups = min(workgroups, self.properties["slm_size_per_xe_core"] // metadata["shared"])
+            metadata["workgroups_per_xe_core"] = workgroups
+
+    @staticmethod
+    def keep_llir():
+        # The text of the LLVM IR is only needed to dump, override or link it.
+        if os.getenv("USE_IR_LOC") == "llir":
+            return True
+        return any(
+            os.getenv(var, "0") == "1"
+            for var in ("TRITON_KERNEL_DUMP", "TRITON_KERNEL_OVERRIDE", "TRITON_INTEL_KEEP_LLIR", "TRITON_LINK_KERNELS"))
+
+    @staticmethod
+    def explicit_scaling():
+        # Split the grid of the kernels across the stacks of multi-stack
+        # devices, see `sycl_kernel_launch`.
+        return os.getenv("TRITON_INTEL_EXPLICIT_SCALING", "0") == "1"
+
+    @staticmethod
+    def use_spirv_backend():
+        # LLVM's SPIR-V backend, if built, emits the SPIR-V of the kernels it
+        # supports instead of the SPIRV-LLVM-Translator.
+        return os.getenv("TRITON_INTEL_SPIRV_BACKEND", "0") == "1"
+
+    @staticmethod
+    def print_buffer_size():
+        # With `TRITON_INTEL_PRINT_BUFFER_SIZE=<bytes>`, `tl.device_print`
+        # appends binary records to a device buffer of that size, which the
+        # host decodes after each launch, instead of calling printf.
+        size = int(os.getenv("TRITON_INTEL_PRINT_BUFFER_SIZE", "0"))
+        return size - size % 4
+
+    @staticmethod
+    def make_llir(src, metadata, options, properties, handoff=None):
         # warp-specialization mutates num_warps
         num_warp_groups = src.get_int_attr("triton_gpu.num-warp-groups-per-cta")
         if num_warp_groups is not None:
             metadata["num_warps"] *= num_warp_groups
         threads_per_warp = ir.ttgpuir.get_threads_per_warp(src)
         metadata["threads_per_warp"] = threads_per_warp
+        # Selects the GRF mode in `finalize_metadata`.
+        metadata["live_bytes"] = intel.get_max_live_bytes_per_thread(src) * threads_per_warp
+        metadata["explicit_scaling"] = XPUBackend.explicit_scaling()
+        if metadata["explicit_scaling"]:
+            # The program ids account for the global offset of the part of the
+            # grid launched on each stack.
+            src.set_attr("triton_intel_gpu.explicit_scaling", ir.builder(src.context).get_bool_attr(True))
+        if options.math_precision != 'ieee':
+            src.set_attr("triton_intel_gpu.math_precision", ir.builder(src.context).get_str_attr(options.math_precision))
+        print_buffer_size = XPUBackend.print_buffer_size()
+        if print_buffer_size > 4:
+            print_formats = intel.assign_print_ids(src)
+            if print_formats:
+                metadata["print_formats"] = print_formats
+                metadata["print_buffer_size"] = print_buffer_size
+                src.set_attr("triton_intel_gpu.print_buffer_size",
+                             ir.builder(src.context).get_int32_attr(print_buffer_size))
         mod = src
         # TritonGPU -> LLVM-IR (MLIR)
         pm = ir.pass_manager(mod.context)
@@ -253,14 +514,22 @@ class XPUBackend(BaseBackend):
         # solutions for SLM allocation, so this will crash on some operations
         # being used, e.g., convert_layout.
         if os.getenv("TRITON_INTEL_REDUCE_TRANSPOSE", "0") != "1":
-            intel.passes.ttgpuir.add_allocate_shared_memory(pm)
+            # Kernels opting in a larger SLM budget expect a single work-group per Xe-core.
+            slm_budget = XPUBackend.get_slm_budget(properties, options)
+            intel.passes.ttgpuir.add_allocate_shared_memory(pm, properties["slm_size_per_xe_core"],
+                                                            XPUBackend.get_threads_per_xe_core(properties, 'default'),
+                                                            max(properties["slm_size_per_xe_core"] // slm_budget, 1))
         intel.passes.ttgpuir.add_to_llvmir(pm)
         passes.convert.add_arith_to_llvmir(pm)
         passes.common.add_canonicalizer(pm)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         if os.environ.get("TRITON_DISABLE_LINE_INFO", "0") == "0":
-            passes.llvmir.add_di_scope(pm)
+            # The fast pipeline only keeps the lines of the kernel, which is
+            # what profilers correlate the instructions with.
+            line_tables_only = (options.llvm_pipeline == 'fast'
+                                or os.getenv("TRITON_INTEL_LINE_TABLES_ONLY", "0") == "1")
+            passes.llvmir.add_di_scope_options(pm, line_tables_only)
         pm.run(mod)
         # LLVM-IR (MLIR) -> LLVM-IR (LLVM)
         llvm.init_targets()
@@ -270,38 +539,70 @@ class XPUBackend(BaseBackend):
         if options.extern_libs:
             paths = [path for (name, path) in options.extern_libs]
             llvm.link_extern_libs(llvm_mod, paths)
-        intel.optimize_module(llvm_mod, llvm.OPTIMIZE_O3)
-        intel.post_process_llir(llvm_mod)
+        fast = options.llvm_pipeline == 'fast'
+        # The reports are empty unless `LLVM_ENABLE_TIMING` is set.
+        metadata["llvm_pass_timing"] = intel.optimize_module(llvm_mod, llvm.OPTIMIZE_O1 if fast else llvm.OPTIMIZE_O3)
+        post_process_timing, metadata["slp_vectorization"] = intel.post_process_llir(llvm_mod, fast)
+        metadata["llvm_pass_timing"] += post_process_timing
 
         # Get some metadata
         metadata["shared"] = src.get_int_attr("triton_gpu.shared")
-        ret = str(llvm_mod)
-        del llvm_mod
-        del context
+        metadata["global_scratch_size"] = src.get_int_attr("triton_intel_gpu.global_scratch_size") or 0
+        # The parameters the kernel never reads are not set by the launcher.
+        num_hidden_args = bool(metadata["global_scratch_size"]) + bool(metadata["shared"])
+        metadata["dead_args"] = intel.remove_dead_kernel_args(llvm_mod, num_hidden_args)
+        metadata["workgroups_per_xe_core"] = src.get_int_attr("triton_intel_gpu.workgroups_per_xe_core")
+        if handoff is None:
+            ret = str(llvm_mod)
+            del llvm_mod
+            del context
+            return ret
+        # The module is translated to SPIR-V by `make_spv` in memory, so its
+        # text is only printed when it is needed.
+        ret = str(llvm_mod) if XPUBackend.keep_llir() else LLIR_NOT_KEPT
+        handoff["llir"] = (ret, llvm_mod, context)
         return ret
 
     @staticmethod
-    def make_spv(src, metadata, options):
-        ret, name = intel.translate_to_spirv(src)
-        metadata["name"] = name
-        if options.grf_mode == 'small':
-            metadata["build_flags"] = "-cl-intel-128-GRF-per-thread"
-        elif options.grf_mode == 'large':
-            if options.num_warps > 32:
-                raise RuntimeError("grf_mode = large cannot be used with num_warps > 32")
-            metadata["build_flags"] = "-cl-intel-256-GRF-per-thread"
-        elif options.grf_mode == 'auto':
-            metadata["build_flags"] = "-cl-intel-enable-auto-large-GRF-mode"
+    def make_spv(src, metadata, options, handoff=None):
+        llir, llvm_mod, context = (handoff or {}).pop("llir", (None, None, None))
+        use_backend = XPUBackend.use_spirv_backend()
+        if llvm_mod is not None and src is llir:
+            ret, name = intel.translate_to_spirv(llvm_mod, use_backend)
         else:
-            metadata["build_flags"] = ""
-
+            # The LLVM IR was overridden, or produced by another stage.
+            ret, name = intel.translate_to_spirv(src, use_backend)
+        del llvm_mod
+        del context
+        metadata["name"] = name
         return ret
 
+    @staticmethod
+    def timed_stage(name, stage):
+        """
+        Records the wall time (in seconds) of the compile stage `name` in the
+        `compile_times` metadata, and as a Proton scope when profiling.
+        """
+
+        def run(src, metadata):
+            start = time.perf_counter()
+            ret = stage(src, metadata)
+            elapsed = time.perf_counter() - start
+            metadata.setdefault("compile_times", {})[name] = elapsed
+            report_compile_time(f"compile_{name}", elapsed)
+            return ret
+
+        return run
+
     def add_stages(self, stages, options):
-        stages["ttir"] = lambda src, metadata: self.make_ttir(src, metadata, options)
-        stages["ttgir"] = lambda src, metadata: self.make_ttgir(src, metadata, options, self.properties)
-        stages["llir"] = lambda src, metadata: self.make_llir(src, metadata, options)
-        stages["spv"] = lambda src, metadata: self.make_spv(src, metadata, options)
+        stages["ttir"] = self.timed_stage("ttir", lambda src, metadata: self.make_ttir(src, metadata, options))
+        stages["ttgir"] = self.timed_stage(
+            "ttgir", lambda src, metadata: self.make_ttgir(src, metadata, options, self.properties))
+        # Hands the LLVM module from the llir stage to the spv stage.
+        handoff = {}
+        stages["llir"] = self.timed_stage(
+            "llir", lambda src, metadata: self.make_llir(src, metadata, options, self.properties, handoff))
+        stages["spv"] = self.timed_stage("spv", lambda src, metadata: self.make_spv(src, metadata, options, handoff))
 
     @functools.lru_cache()
     def hash(self):
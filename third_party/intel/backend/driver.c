@@ -6,8 +6,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -20,7 +22,10 @@
 #include <Python.h>
 #include <numpy/arrayobject.h>
 
+// Guarded by `g_sycl_queue_map_mutex`, as the contexts of the queues can be
+// initialized concurrently in the free-threaded builds of Python.
 static SyclQueueMap g_sycl_queue_map;
+static std::mutex g_sycl_queue_map_mutex;
 
 static std::vector<ze_device_handle_t> g_devices;
 static std::vector<std::pair<sycl::device, ze_device_handle_t>>
@@ -68,7 +73,18 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
 
   int multiprocessor_count =
       device_properties.numSlices * device_properties.numSubslicesPerSlice;
+  int num_eus_per_xe_core = device_properties.numEUsPerSubslice;
+  int num_threads_per_eu = device_properties.numThreadsPerEU;
   int sm_clock_rate = device_properties.coreClockRate;
+  int pci_device_id = device_properties.deviceId;
+
+  ze_driver_handle_t phDriver =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          device.first.get_platform());
+  ze_driver_properties_t driver_properties = {};
+  driver_properties.stype = ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES;
+  zeDriverGetProperties(phDriver, &driver_properties);
+  unsigned int driver_version = driver_properties.driverVersion;
 
   ze_device_compute_properties_t compute_properties = {};
   compute_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES;
@@ -96,15 +112,34 @@ static PyObject *getDeviceProperties(PyObject *self, PyObject *args) {
 
   delete[] pMemoryProperties;
 
-  return Py_BuildValue("{s:i, s:i, s:i, s:i, s:i, s:i, s:N}", "max_shared_mem",
-                       max_shared_mem, "multiprocessor_count",
-                       multiprocessor_count, "sm_clock_rate", sm_clock_rate,
-                       "mem_clock_rate", mem_clock_rate, "mem_bus_width",
-                       mem_bus_width, "max_work_group_size", max_group_size,
-                       "sub_group_sizes", subgroup_sizes);
+  // The last level (L3) cache is the largest cache of the device.
+  uint32_t cacheCount = 0;
+  zeDeviceGetCacheProperties(phDevice, &cacheCount, nullptr);
+  std::vector<ze_device_cache_properties_t> cacheProperties(cacheCount);
+  for (ze_device_cache_properties_t &cache : cacheProperties) {
+    cache.stype = ZE_STRUCTURE_TYPE_DEVICE_CACHE_PROPERTIES;
+    cache.pNext = nullptr;
+  }
+  zeDeviceGetCacheProperties(phDevice, &cacheCount, cacheProperties.data());
+  unsigned long long l3_cache_size = 0;
+  for (const ze_device_cache_properties_t &cache : cacheProperties)
+    l3_cache_size =
+        std::max<unsigned long long>(l3_cache_size, cache.cacheSize);
+
+  return Py_BuildValue(
+      "{s:i, s:i, s:i, s:i, s:i, s:i, s:N, s:i, s:I, s:i, s:i, s:K}",
+      "max_shared_mem", max_shared_mem, "multiprocessor_count",
+      multiprocessor_count, "sm_clock_rate", sm_clock_rate, "mem_clock_rate",
+      mem_clock_rate, "mem_bus_width", mem_bus_width, "max_work_group_size",
+      max_group_size, "sub_group_sizes", subgroup_sizes, "pci_device_id",
+      pci_device_id, "driver_version", driver_version, "num_eus_per_xe_core",
+      num_eus_per_xe_core, "num_threads_per_eu", num_threads_per_eu,
+      "l3_cache_size", l3_cache_size);
 }
 void freeKernel(PyObject *p) {
   delete reinterpret_cast<sycl::kernel *>(PyCapsule_GetPointer(p, "kernel"));
+  // The launcher caches the decoded kernel metadata as the capsule context.
+  free(PyCapsule_GetContext(p));
 }
 
 void freeKernelBundle(PyObject *p) {
@@ -113,17 +148,47 @@ void freeKernelBundle(PyObject *p) {
       PyCapsule_GetPointer(p, "kernel_bundle"));
 }
 
+// Returns whether the GRF mode is specified by the build flags, and sets
+// `n_regs` to the number of GRFs per thread it selects.
+static bool getGRFMode(const std::string &build_flags, int32_t &n_regs) {
+  if (build_flags.find("-cl-intel-256-GRF-per-thread") != std::string::npos) {
+    n_regs = 256;
+    return true;
+  }
+  if (build_flags.find("-cl-intel-128-GRF-per-thread") != std::string::npos) {
+    n_regs = 128;
+    return true;
+  }
+  if (build_flags.find("-cl-intel-enable-auto-large-GRF-mode") !=
+      std::string::npos) {
+    n_regs = 0;
+    return true;
+  }
+  return false;
+}
+
+// Releases a buffer parsed with the "y*" format on all the return paths.
+struct BufferGuard {
+  Py_buffer *buffer;
+  ~BufferGuard() { PyBuffer_Release(buffer); }
+};
+
+// The binary can be any bytes-like object, e.g. a read-only mmap of a native
+// binary in the cache.
 static PyObject *loadBinary(PyObject *self, PyObject *args) {
   const char *name, *build_flags;
   int shared;
-  PyObject *py_bytes;
+  Py_buffer binary;
   int devId;
+  int is_spv = 1;
+  int max_reg_spill = 1000;
 
-  if (!PyArg_ParseTuple(args, "sSisi", &name, &py_bytes, &shared, &build_flags,
-                        &devId)) {
+  if (!PyArg_ParseTuple(args, "sy*isi|pi", &name, &binary, &shared,
+                        &build_flags, &devId, &is_spv, &max_reg_spill)) {
     std::cerr << "loadBinary arg parse failed" << std::endl;
     return NULL;
   }
+  BufferGuard binary_guard{&binary};
 
   if (devId > g_sycl_l0_device_list.size()) {
     std::cerr << "Device is not found " << std::endl;
@@ -134,17 +199,24 @@ static PyObject *loadBinary(PyObject *self, PyObject *args) {
   const sycl::device sycl_device = sycl_l0_device_pair.first;
 
   std::string kernel_name = name;
-  size_t binary_size = PyBytes_Size(py_bytes);
-  binary_size = binary_size / sizeof(uint32_t);
+  size_t binary_size = binary.len;
+  if (is_spv)
+    binary_size = binary_size / sizeof(uint32_t);
 
-  uint8_t *binary_ptr = (uint8_t *)PyBytes_AsString(py_bytes);
+  uint8_t *binary_ptr = static_cast<uint8_t *>(binary.buf);
   const auto ctx = sycl_device.get_platform().ext_oneapi_get_default_context();
   const auto l0_device =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_device);
   const auto l0_context =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
-  auto l0_module = checkSyclErrors(create_module(
-      l0_context, l0_device, binary_ptr, binary_size, build_flags));
+  // Release the GIL while the driver builds the module, so kernels can be
+  // loaded concurrently from several threads.
+  std::tuple<ze_module_handle_t, ze_result_t> module_result;
+  Py_BEGIN_ALLOW_THREADS;
+  module_result = create_module(l0_context, l0_device, binary_ptr, binary_size,
+                                build_flags, is_spv);
+  Py_END_ALLOW_THREADS;
+  auto l0_module = checkSyclErrors(module_result);
 
   auto checkL0Errors = [&](auto l0_module) -> ze_kernel_handle_t {
     if (PyErr_Occurred()) {
@@ -162,41 +234,37 @@ static PyObject *loadBinary(PyObject *self, PyObject *args) {
 
   // Retrieve the kernel properties (e.g. register spills).
   ze_kernel_handle_t l0_kernel = checkL0Errors(l0_module);
+  if (PyErr_Occurred())
+    return NULL;
   ze_kernel_properties_t props;
   props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
   props.pNext = nullptr;
   gpuAssert(zeKernelGetProperties(l0_kernel, &props));
 
   int32_t n_spills = props.spillMemSize;
-  const int32_t n_regs = 0;
-  constexpr int32_t max_reg_spill = 1000;
   std::string build_flags_str(build_flags);
-  bool is_GRF_mode_specified = false;
-
-  // Check whether the GRF mode is specified by the build flags.
-  if (build_flags_str.find("-cl-intel-256-GRF-per-thread") !=
-          std::string::npos ||
-      build_flags_str.find("-cl-intel-128-GRF-per-thread") !=
-          std::string::npos ||
-      build_flags_str.find("-cl-intel-enable-auto-large-GRF-mode") !=
-          std::string::npos) {
-    is_GRF_mode_specified = true;
-  }
+  // Number of GRFs per thread, 0 when the finalizer selects it (auto mode).
+  int32_t n_regs = 128;
+  bool is_GRF_mode_specified = getGRFMode(build_flags_str, n_regs);
 
   // If the register mode isn't set, and the number of spills is greater
   // than the threshold, recompile the kernel using large GRF mode.
-  if (!is_GRF_mode_specified && n_spills > max_reg_spill) {
+  // Native binaries are already finalized and cannot be recompiled.
+  if (is_spv && !is_GRF_mode_specified && n_spills > max_reg_spill) {
     std::cout << "(I): Detected " << n_spills
               << " spills, recompiling the kernel using large GRF mode"
               << std::endl;
     const std::string new_build_flags =
         build_flags_str.append(" -cl-intel-256-GRF-per-thread");
-    l0_module =
-        checkSyclErrors(create_module(l0_context, l0_device, binary_ptr,
-                                      binary_size, new_build_flags.c_str()));
+    Py_BEGIN_ALLOW_THREADS;
+    module_result = create_module(l0_context, l0_device, binary_ptr,
+                                  binary_size, new_build_flags.c_str());
+    Py_END_ALLOW_THREADS;
+    l0_module = checkSyclErrors(module_result);
     l0_kernel = checkL0Errors(l0_module);
     gpuAssert(zeKernelGetProperties(l0_kernel, &props));
     n_spills = props.spillMemSize;
+    n_regs = 256;
     std::cout << "(I): Kernel has now " << n_spills << " spills" << std::endl;
   }
 
@@ -217,6 +285,488 @@ static PyObject *loadBinary(PyObject *self, PyObject *args) {
   return Py_BuildValue("(OOii)", kernel_bundle_py, kernel_py, n_regs, n_spills);
 }
 
+// Loads a SPIR-V module holding several kernels (see `link_to_spirv`), so that
+// the driver builds all of them with a single module creation, and returns the
+// kernel bundle with one kernel and its number of spills per name.
+static PyObject *loadBinaries(PyObject *self, PyObject *args) {
+  PyObject *py_names;
+  const char *build_flags;
+  PyObject *py_bytes;
+  int devId;
+  int max_reg_spill = 1000;
+
+  if (!PyArg_ParseTuple(args, "OSsi|i", &py_names, &py_bytes, &build_flags,
+                        &devId, &max_reg_spill))
+    return NULL;
+
+  if (devId > g_sycl_l0_device_list.size()) {
+    std::cerr << "Device is not found " << std::endl;
+    return NULL;
+  }
+
+  std::vector<std::string> kernel_names;
+  PyObject *names_seq = PySequence_Fast(py_names, "Expecting kernel names");
+  if (!names_seq)
+    return NULL;
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(names_seq); ++i) {
+    const char *name =
+        PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(names_seq, i));
+    if (!name) {
+      Py_DECREF(names_seq);
+  if (kernel_names.empty()) {
+    PyErr_SetString(PyExc_ValueError, "Expecting at least one kernel name");
+    return NULL;
+  }
+      return NULL;
+    }
+    kernel_names.push_back(name);
+  }
+  Py_DECREF(names_seq);
+
+  const auto &sycl_l0_device_pair = g_sycl_l0_device_list[devId];
+  const sycl::device sycl_device = sycl_l0_device_pair.first;
+  size_t binary_size = PyBytes_Size(py_bytes) / sizeof(uint32_t);
+  uint8_t *binary_ptr = (uint8_t *)PyBytes_AsString(py_bytes);
+  const auto ctx = sycl_device.get_platform().ext_oneapi_get_default_context();
+  const auto l0_device =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_device);
+  const auto l0_context =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
+
+  std::string build_flags_str(build_flags);
+  int32_t n_regs = 128;
+  bool is_GRF_mode_specified = getGRFMode(build_flags_str, n_regs);
+
+  ze_module_handle_t l0_module;
+  std::vector<ze_kernel_handle_t> l0_kernels;
+  std::vector<int32_t> n_spills;
+  auto createKernels = [&](const char *flags) -> bool {
+    std::tuple<ze_module_handle_t, ze_result_t> module_result;
+    Py_BEGIN_ALLOW_THREADS;
+    module_result = create_module(l0_context, l0_device, binary_ptr,
+                                  binary_size, flags);
+    Py_END_ALLOW_THREADS;
+    l0_module = checkSyclErrors(module_result);
+    if (PyErr_Occurred())
+      return false;
+    l0_kernels.clear();
+    n_spills.clear();
+    for (const std::string &kernel_name : kernel_names) {
+      ze_kernel_handle_t l0_kernel =
+          checkSyclErrors(create_function(l0_module, kernel_name));
+      if (PyErr_Occurred())
+        return false;
+      ze_kernel_properties_t props;
+      props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
+      props.pNext = nullptr;
+      gpuAssert(zeKernelGetProperties(l0_kernel, &props));
+      l0_kernels.push_back(l0_kernel);
+      n_spills.push_back(props.spillMemSize);
+    }
+    return true;
+  };
+  if (!createKernels(build_flags))
+    return NULL;
+
+  // The GRF mode applies to the whole module: if any kernel spills more than
+  // the threshold, recompile all of them using large GRF mode.
+  if (!is_GRF_mode_specified &&
+      *std::max_element(n_spills.begin(), n_spills.end()) > max_reg_spill) {
+    std::cout << "(I): Detected "
+              << *std::max_element(n_spills.begin(), n_spills.end())
+              << " spills, recompiling the module using large GRF mode"
+              << std::endl;
+    for (ze_kernel_handle_t l0_kernel : l0_kernels)
+      zeKernelDestroy(l0_kernel);
+    zeModuleDestroy(l0_module);
+    const std::string new_build_flags =
+        build_flags_str.append(" -cl-intel-256-GRF-per-thread");
+    if (!createKernels(new_build_flags.c_str()))
+      return NULL;
+    n_regs = 256;
+  }
+
+  auto mod = new sycl::kernel_bundle<sycl::bundle_state::executable>(
+      sycl::make_kernel_bundle<sycl::backend::ext_oneapi_level_zero,
+                               sycl::bundle_state::executable>(
+          {l0_module, sycl::ext::oneapi::level_zero::ownership::transfer},
+          ctx));
+  PyObject *kernels_py = PyList_New(l0_kernels.size());
+  PyObject *n_spills_py = PyList_New(l0_kernels.size());
+  for (size_t i = 0; i < l0_kernels.size(); ++i) {
+    sycl::kernel *fun = new sycl::kernel(
+        sycl::make_kernel<sycl::backend::ext_oneapi_level_zero>(
+            {*mod, l0_kernels[i],
+             sycl::ext::oneapi::level_zero::ownership::transfer},
+            ctx));
+    PyList_SET_ITEM(
+        kernels_py, i,
+        PyCapsule_New(reinterpret_cast<void *>(fun), "kernel", freeKernel));
+    PyList_SET_ITEM(n_spills_py, i, PyLong_FromLong(n_spills[i]));
+  }
+  auto kernel_bundle_py = PyCapsule_New(reinterpret_cast<void *>(mod),
+                                        "kernel_bundle", freeKernelBundle);
+
+  return Py_BuildValue("(NNiN)", kernel_bundle_py, kernels_py, n_regs,
+                       n_spills_py);
+}
+
+static PyObject *getNativeBinary(PyObject *self, PyObject *args) {
+  PyObject *py_kernel_bundle;
+  if (!PyArg_ParseTuple(args, "O", &py_kernel_bundle))
+    return NULL;
+
+  auto kernel_bundle = reinterpret_cast<
+      sycl::kernel_bundle<sycl::bundle_state::executable> *>(
+      PyCapsule_GetPointer(py_kernel_bundle, "kernel_bundle"));
+  if (kernel_bundle == nullptr)
+    return NULL;
+
+  const auto l0_modules =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(*kernel_bundle);
+  if (l0_modules.size() != 1) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "Expected a kernel bundle with a single L0 module");
+    return NULL;
+  }
+
+  size_t binary_size = 0;
+  gpuAssert(zeModuleGetNativeBinary(l0_modules[0], &binary_size, nullptr));
+  if (PyErr_Occurred())
+    return NULL;
+  PyObject *py_bytes = PyBytes_FromStringAndSize(NULL, binary_size);
+  if (py_bytes == NULL)
+    return NULL;
+  gpuAssert(zeModuleGetNativeBinary(
+      l0_modules[0], &binary_size,
+      reinterpret_cast<uint8_t *>(PyBytes_AsString(py_bytes))));
+  if (PyErr_Occurred()) {
+    Py_DECREF(py_bytes);
+    return NULL;
+  }
+  return py_bytes;
+}
+
+static PyObject *getKernelProperties(PyObject *self, PyObject *args) {
+  PyObject *py_kernel;
+  if (!PyArg_ParseTuple(args, "O", &py_kernel))
+    return NULL;
+
+  auto kernel = reinterpret_cast<sycl::kernel *>(
+      PyCapsule_GetPointer(py_kernel, "kernel"));
+  if (kernel == nullptr)
+    return NULL;
+
+  const auto l0_kernel =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(*kernel);
+  ze_kernel_properties_t props;
+  props.stype = ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES;
+  props.pNext = nullptr;
+  gpuAssert(zeKernelGetProperties(l0_kernel, &props));
+  if (PyErr_Occurred())
+    return NULL;
+
+  return Py_BuildValue(
+      "{s:I, s:I, s:I, s:I, s:I, s:I}", "local_mem_size", props.localMemSize,
+      "private_mem_size", props.privateMemSize, "spill_mem_size",
+      props.spillMemSize, "required_sub_group_size",
+      props.requiredSubgroupSize, "max_sub_group_size", props.maxSubgroupSize,
+      "max_num_sub_groups", props.maxNumSubgroups);
+}
+
+namespace syclex = sycl::ext::oneapi::experimental;
+using modifiable_graph = syclex::command_graph<syclex::graph_state::modifiable>;
+using executable_graph =
+    syclex::command_graph<syclex::graph_state::executable>;
+
+void freeGraph(PyObject *p) {
+  delete reinterpret_cast<modifiable_graph *>(PyCapsule_GetPointer(p, "graph"));
+}
+
+void freeExecGraph(PyObject *p) {
+  delete reinterpret_cast<executable_graph *>(
+      PyCapsule_GetPointer(p, "exec_graph"));
+}
+
+static sycl::queue *getSyclQueue(PyObject *cap) {
+  void *queue = PyLong_AsVoidPtr(cap);
+  if (!queue && !PyErr_Occurred())
+    PyErr_SetString(PyExc_ValueError, "Invalid SYCL queue");
+  return static_cast<sycl::queue *>(queue);
+}
+
+static PyObject *graphBeginCapture(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+
+  try {
+    auto graph = new modifiable_graph(sycl_queue->get_context(),
+                                      sycl_queue->get_device());
+    graph->begin_recording(*sycl_queue);
+    return PyCapsule_New(reinterpret_cast<void *>(graph), "graph", freeGraph);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *graphEndCapture(PyObject *self, PyObject *args) {
+  PyObject *py_graph, *cap;
+  if (!PyArg_ParseTuple(args, "OO", &py_graph, &cap))
+    return NULL;
+  auto graph = reinterpret_cast<modifiable_graph *>(
+      PyCapsule_GetPointer(py_graph, "graph"));
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!graph || !sycl_queue)
+    return NULL;
+
+  try {
+    graph->end_recording(*sycl_queue);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *graphFinalize(PyObject *self, PyObject *args) {
+  PyObject *py_graph;
+  if (!PyArg_ParseTuple(args, "O", &py_graph))
+    return NULL;
+  auto graph = reinterpret_cast<modifiable_graph *>(
+      PyCapsule_GetPointer(py_graph, "graph"));
+  if (!graph)
+    return NULL;
+
+  try {
+    // The executable graph is updatable so that it can be replayed with the
+    // arguments of a later capture of the same launch sequence.
+    auto exec_graph = new executable_graph(
+        graph->finalize({syclex::property::graph::updatable{}}));
+    return PyCapsule_New(reinterpret_cast<void *>(exec_graph), "exec_graph",
+                         freeExecGraph);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *graphUpdate(PyObject *self, PyObject *args) {
+  PyObject *py_exec_graph, *py_graph;
+  if (!PyArg_ParseTuple(args, "OO", &py_exec_graph, &py_graph))
+    return NULL;
+  auto exec_graph = reinterpret_cast<executable_graph *>(
+      PyCapsule_GetPointer(py_exec_graph, "exec_graph"));
+  auto graph = reinterpret_cast<modifiable_graph *>(
+      PyCapsule_GetPointer(py_graph, "graph"));
+  if (!exec_graph || !graph)
+    return NULL;
+
+  try {
+    exec_graph->update(*graph);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *graphReplay(PyObject *self, PyObject *args) {
+  PyObject *py_exec_graph, *cap;
+  if (!PyArg_ParseTuple(args, "OO", &py_exec_graph, &cap))
+    return NULL;
+  auto exec_graph = reinterpret_cast<executable_graph *>(
+      PyCapsule_GetPointer(py_exec_graph, "exec_graph"));
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!exec_graph || !sycl_queue)
+    return NULL;
+
+  try {
+    sycl_queue->ext_oneapi_graph(*exec_graph);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+void freeEvent(PyObject *p) {
+  delete reinterpret_cast<sycl::event *>(PyCapsule_GetPointer(p, "event"));
+}
+
+static PyObject *supportsProfilingTag(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  return PyBool_FromLong(
+      sycl_queue->get_device().has(sycl::aspect::ext_oneapi_queue_profiling_tag));
+}
+
+static PyObject *submitProfilingTag(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+
+  try {
+    // The tag records a device timestamp once all the commands previously
+    // submitted to the queue completed, even if the queue was not created
+    // with profiling enabled.
+    auto event = new sycl::event(syclex::submit_profiling_tag(*sycl_queue));
+    return PyCapsule_New(reinterpret_cast<void *>(event), "event", freeEvent);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *elapsedTime(PyObject *self, PyObject *args) {
+  PyObject *py_start, *py_end;
+  if (!PyArg_ParseTuple(args, "OO", &py_start, &py_end))
+    return NULL;
+  auto start =
+      reinterpret_cast<sycl::event *>(PyCapsule_GetPointer(py_start, "event"));
+  auto end =
+      reinterpret_cast<sycl::event *>(PyCapsule_GetPointer(py_end, "event"));
+  if (!start || !end)
+    return NULL;
+
+  try {
+    start->wait();
+    end->wait();
+    uint64_t start_ns =
+        start->get_profiling_info<sycl::info::event_profiling::command_end>();
+    uint64_t end_ns =
+        end->get_profiling_info<sycl::info::event_profiling::command_end>();
+    return PyFloat_FromDouble((static_cast<double>(end_ns) -
+                               static_cast<double>(start_ns)) *
+                              1e-6);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *createQueue(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+
+  try {
+    // The kernels of the new queue can run concurrently with the ones of
+    // `sycl_queue`, whose context and device it shares.
+    auto queue =
+        new sycl::queue(sycl_queue->get_context(), sycl_queue->get_device(),
+                        sycl::property::queue::in_order());
+    return PyLong_FromVoidPtr(queue);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *destroyQueue(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  if (!PyArg_ParseTuple(args, "O", &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  delete sycl_queue;
+  Py_RETURN_NONE;
+}
+
+static PyObject *submitBarrier(PyObject *self, PyObject *args) {
+  PyObject *cap, *py_events;
+  if (!PyArg_ParseTuple(args, "OO", &cap, &py_events))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+  PyObject *seq = PySequence_Fast(py_events, "events must be a sequence");
+  if (!seq)
+    return NULL;
+  std::vector<sycl::event> events;
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+    auto event = reinterpret_cast<sycl::event *>(
+        PyCapsule_GetPointer(PySequence_Fast_GET_ITEM(seq, i), "event"));
+    if (!event) {
+      Py_DECREF(seq);
+      return NULL;
+    }
+    events.push_back(*event);
+  }
+  Py_DECREF(seq);
+
+  try {
+    // Without events, the barrier waits for all the commands previously
+    // submitted to the queue. Either way, the commands submitted after it
+    // wait for the barrier.
+    auto event = new sycl::event(
+        events.empty() ? sycl_queue->ext_oneapi_submit_barrier()
+                       : sycl_queue->ext_oneapi_submit_barrier(events));
+    return PyCapsule_New(reinterpret_cast<void *>(event), "event", freeEvent);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *eventWait(PyObject *self, PyObject *args) {
+  PyObject *py_event;
+  if (!PyArg_ParseTuple(args, "O", &py_event))
+    return NULL;
+  auto event =
+      reinterpret_cast<sycl::event *>(PyCapsule_GetPointer(py_event, "event"));
+  if (!event)
+    return NULL;
+
+  std::string error;
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    event->wait_and_throw();
+  } catch (const sycl::exception &e) {
+    error = e.what();
+  }
+  Py_END_ALLOW_THREADS;
+  if (!error.empty()) {
+    PyErr_SetString(PyExc_RuntimeError, error.c_str());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *eventQuery(PyObject *self, PyObject *args) {
+  PyObject *py_event;
+  if (!PyArg_ParseTuple(args, "O", &py_event))
+    return NULL;
+  auto event =
+      reinterpret_cast<sycl::event *>(PyCapsule_GetPointer(py_event, "event"));
+  if (!event)
+    return NULL;
+
+  try {
+    return PyBool_FromLong(
+        event->get_info<sycl::info::event::command_execution_status>() ==
+        sycl::info::event_command_status::complete);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
 static PyObject *initContext(PyObject *self, PyObject *args) {
   PyObject *cap;
   void *queue = NULL;
@@ -225,6 +775,7 @@ static PyObject *initContext(PyObject *self, PyObject *args) {
   if (!(queue = PyLong_AsVoidPtr(cap)))
     return NULL;
   sycl::queue *sycl_queue = static_cast<sycl::queue *>(queue);
+  std::lock_guard<std::mutex> lock(g_sycl_queue_map_mutex);
   if (g_sycl_queue_map.find(*sycl_queue) == g_sycl_queue_map.end()) {
     const auto updated_sycl_devices = update(*sycl_queue, g_sycl_queue_map);
     if (!updated_sycl_devices.empty()) {
@@ -268,11 +819,336 @@ static PyObject *initDevices(PyObject *self, PyObject *args) {
   return Py_BuildValue("(i)", deviceCount);
 }
 
+static bool getL0Device(int device_id, ze_device_handle_t *device,
+                        ze_context_handle_t *context) {
+  if (device_id < 0 || device_id >= g_sycl_l0_device_list.size()) {
+    PyErr_Format(PyExc_ValueError, "Device %d is not found", device_id);
+    return false;
+  }
+  const auto &sycl_l0_device_pair = g_sycl_l0_device_list[device_id];
+  *device = sycl_l0_device_pair.second;
+  const auto ctx =
+      sycl_l0_device_pair.first.get_platform().ext_oneapi_get_default_context();
+  *context = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
+  return true;
+}
+
+static PyObject *canAccessPeer(PyObject *self, PyObject *args) {
+  int device_id, peer_id;
+  if (!PyArg_ParseTuple(args, "ii", &device_id, &peer_id))
+    return NULL;
+  ze_device_handle_t device, peer;
+  ze_context_handle_t context;
+  if (!getL0Device(device_id, &device, &context) ||
+      !getL0Device(peer_id, &peer, &context))
+    return NULL;
+  ze_bool_t can_access = false;
+  gpuAssert(zeDeviceCanAccessPeer(device, peer, &can_access));
+  if (PyErr_Occurred())
+    return NULL;
+  return PyBool_FromLong(can_access);
+}
+
+// Returns the IPC handle of the allocation holding `ptr` and the offset of
+// `ptr` in the allocation.
+static PyObject *getIpcHandle(PyObject *self, PyObject *args) {
+  int device_id;
+  unsigned long long ptr;
+  if (!PyArg_ParseTuple(args, "iK", &device_id, &ptr))
+    return NULL;
+  ze_device_handle_t device;
+  ze_context_handle_t context;
+  if (!getL0Device(device_id, &device, &context))
+    return NULL;
+  void *base = nullptr;
+  size_t size = 0;
+  gpuAssert(zeMemGetAddressRange(context, reinterpret_cast<void *>(ptr), &base,
+                                 &size));
+  if (PyErr_Occurred())
+    return NULL;
+  ze_ipc_mem_handle_t handle;
+  gpuAssert(zeMemGetIpcHandle(context, base, &handle));
+  if (PyErr_Occurred())
+    return NULL;
+  return Py_BuildValue("(y#K)", handle.data, (Py_ssize_t)ZE_MAX_IPC_HANDLE_SIZE,
+                       ptr - reinterpret_cast<uintptr_t>(base));
+}
+
+static PyObject *openIpcHandle(PyObject *self, PyObject *args) {
+  int device_id;
+  Py_buffer py_handle;
+  if (!PyArg_ParseTuple(args, "iy*", &device_id, &py_handle))
+    return NULL;
+  ze_ipc_mem_handle_t handle;
+  bool valid = py_handle.len == ZE_MAX_IPC_HANDLE_SIZE;
+  if (valid)
+    memcpy(handle.data, py_handle.buf, ZE_MAX_IPC_HANDLE_SIZE);
+  PyBuffer_Release(&py_handle);
+  if (!valid) {
+    PyErr_SetString(PyExc_ValueError, "Invalid IPC memory handle");
+    return NULL;
+  }
+  ze_device_handle_t device;
+  ze_context_handle_t context;
+  if (!getL0Device(device_id, &device, &context))
+    return NULL;
+  void *ptr = nullptr;
+  gpuAssert(zeMemOpenIpcHandle(context, device, handle, 0, &ptr));
+  if (PyErr_Occurred())
+    return NULL;
+  return PyLong_FromVoidPtr(ptr);
+}
+
+static PyObject *closeIpcHandle(PyObject *self, PyObject *args) {
+  int device_id;
+  unsigned long long ptr;
+  if (!PyArg_ParseTuple(args, "iK", &device_id, &ptr))
+    return NULL;
+  ze_device_handle_t device;
+  ze_context_handle_t context;
+  if (!getL0Device(device_id, &device, &context))
+    return NULL;
+  gpuAssert(zeMemCloseIpcHandle(context, reinterpret_cast<void *>(ptr)));
+  if (PyErr_Occurred())
+    return NULL;
+  Py_RETURN_NONE;
+}
+
+// Enqueues on a queue the copy of the print buffer of a kernel (see
+// `TRITON_INTEL_PRINT_BUFFER_SIZE`) to host memory, followed by the reset of
+// its reserved size, so that the next launches get an empty buffer.
+static PyObject *copyPrintBuffer(PyObject *self, PyObject *args) {
+  PyObject *py_kernel, *cap;
+  unsigned long long host_ptr;
+  Py_ssize_t host_size;
+  if (!PyArg_ParseTuple(args, "OOKn", &py_kernel, &cap, &host_ptr, &host_size))
+    return NULL;
+  auto kernel = reinterpret_cast<sycl::kernel *>(
+      PyCapsule_GetPointer(py_kernel, "kernel"));
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!kernel || !sycl_queue)
+    return NULL;
+
+  const auto l0_modules =
+      sycl::get_native<sycl::backend::ext_oneapi_level_zero>(
+          kernel->get_kernel_bundle());
+  size_t size = 0;
+  void *buffer = nullptr;
+  for (ze_module_handle_t l0_module : l0_modules)
+    if (zeModuleGetGlobalPointer(l0_module, "__triton_print_buffer", &size,
+                                 &buffer) == ZE_RESULT_SUCCESS)
+      break;
+  if (!buffer) {
+    PyErr_SetString(PyExc_RuntimeError, "The kernel has no print buffer");
+    return NULL;
+  }
+
+  try {
+    sycl_queue->memcpy(reinterpret_cast<void *>(host_ptr), buffer,
+                       std::min<size_t>(size, host_size));
+    sycl_queue->memset(buffer, 0, sizeof(uint32_t));
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+// Device memory managed by the launchers for the kernels, e.g. their global
+// scratch, cached across launches by size class. A block is released in the
+// order of a queue: it is reused right away by the later launches on the same
+// in-order queue, which run after the kernels using it, and by other queues
+// once the commands submitted before its release completed.
+struct ScratchBlock {
+  void *ptr;
+  sycl::queue queue;
+  sycl::event released;
+};
+
+// Size of the smallest size class. Larger blocks are rounded up to a power of
+// two.
+static constexpr size_t minScratchBlockSize = 4096;
+
+// Cached blocks indexed by size class, and the size class of the blocks in
+// use.
+static std::unordered_map<size_t, std::vector<ScratchBlock>> freeScratchBlocks;
+static std::unordered_map<void *, size_t> usedScratchBlocks;
+static size_t scratchPoolSize = 0;
+
+static size_t getScratchSizeClass(size_t size) {
+  size_t sizeClass = minScratchBlockSize;
+  while (sizeClass < size)
+    sizeClass *= 2;
+  return sizeClass;
+}
+
+static bool isScratchBlockCompleted(const ScratchBlock &block) {
+  return block.released
+             .get_info<sycl::info::event::command_execution_status>() ==
+         sycl::info::event_command_status::complete;
+}
+
+// Frees the cached blocks, waiting for their release on their queue.
+static void emptyScratchPool() {
+  for (auto &[sizeClass, blocks] : freeScratchBlocks) {
+    for (ScratchBlock &block : blocks) {
+      block.released.wait();
+      sycl::free(block.ptr, block.queue);
+      scratchPoolSize -= sizeClass;
+    }
+    blocks.clear();
+  }
+}
+
+static void *allocateScratch(sycl::queue &queue, size_t size) {
+  size_t sizeClass = getScratchSizeClass(size);
+  std::vector<ScratchBlock> &blocks = freeScratchBlocks[sizeClass];
+  for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    if (it->queue.get_context() != queue.get_context() ||
+        it->queue.get_device() != queue.get_device())
+      continue;
+    bool ordered = it->queue == queue && queue.is_in_order();
+    if (!ordered && !isScratchBlockCompleted(*it))
+      continue;
+    void *ptr = it->ptr;
+    blocks.erase(it);
+    usedScratchBlocks[ptr] = sizeClass;
+    return ptr;
+  }
+
+  void *ptr = sycl::malloc_device(sizeClass, queue);
+  if (!ptr) {
+    // The cached blocks of the other size classes may hold the memory.
+    emptyScratchPool();
+    ptr = sycl::malloc_device(sizeClass, queue);
+  }
+  if (ptr) {
+    usedScratchBlocks[ptr] = sizeClass;
+    scratchPoolSize += sizeClass;
+  }
+  return ptr;
+}
+
+static PyObject *scratchAlloc(PyObject *self, PyObject *args) {
+  PyObject *cap;
+  Py_ssize_t size;
+  if (!PyArg_ParseTuple(args, "nO", &size, &cap))
+    return NULL;
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (!sycl_queue)
+    return NULL;
+
+  try {
+    void *ptr = allocateScratch(*sycl_queue, size);
+    if (!ptr)
+      return PyErr_Format(PyExc_MemoryError,
+                          "Cannot allocate %zd bytes of device scratch", size);
+    return PyLong_FromVoidPtr(ptr);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+}
+
+static PyObject *scratchFree(PyObject *self, PyObject *args) {
+  PyObject *py_ptr, *cap;
+  if (!PyArg_ParseTuple(args, "OO", &py_ptr, &cap))
+    return NULL;
+  void *ptr = PyLong_AsVoidPtr(py_ptr);
+  sycl::queue *sycl_queue = getSyclQueue(cap);
+  if (PyErr_Occurred() || !sycl_queue)
+    return NULL;
+  auto it = usedScratchBlocks.find(ptr);
+  if (it == usedScratchBlocks.end()) {
+    PyErr_SetString(PyExc_ValueError, "Not a device scratch block");
+    return NULL;
+  }
+
+  try {
+    // The barrier completes with the kernels submitted before the release.
+    sycl::event released = sycl_queue->ext_oneapi_submit_barrier();
+    freeScratchBlocks[it->second].push_back({ptr, *sycl_queue, released});
+    usedScratchBlocks.erase(it);
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *scratchPoolStats(PyObject *self, PyObject *args) {
+  size_t used = 0;
+  for (const auto &[ptr, sizeClass] : usedScratchBlocks)
+    used += sizeClass;
+  return Py_BuildValue("{s:n,s:n}", "allocated", scratchPoolSize, "used",
+                       used);
+}
+
+static PyObject *scratchPoolEmpty(PyObject *self, PyObject *args) {
+  try {
+    emptyScratchPool();
+  } catch (const sycl::exception &e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 static PyMethodDef ModuleMethods[] = {
     {"load_binary", loadBinary, METH_VARARGS,
-     "Load provided SPV into ZE driver"},
+     "Load provided SPV (or native binary) into ZE driver"},
+    {"load_binaries", loadBinaries, METH_VARARGS,
+     "Load a SPV module holding several kernels into ZE driver"},
+    {"get_native_binary", getNativeBinary, METH_VARARGS,
+     "Get the device native binary of a loaded kernel bundle"},
+    {"get_kernel_properties", getKernelProperties, METH_VARARGS,
+     "Get the properties (SLM, private memory, SIMD width) of a loaded kernel"},
+    {"copy_print_buffer", copyPrintBuffer, METH_VARARGS,
+     "Enqueue the copy of the print buffer of a kernel to host memory"},
+    {"scratch_alloc", scratchAlloc, METH_VARARGS,
+     "Allocate device scratch from the pool of the launchers"},
+    {"scratch_free", scratchFree, METH_VARARGS,
+     "Release device scratch to the pool after the commands of a queue"},
+    {"scratch_pool_stats", scratchPoolStats, METH_NOARGS,
+     "Bytes allocated by the scratch pool, and in use"},
+    {"scratch_pool_empty", scratchPoolEmpty, METH_NOARGS,
+     "Free the device scratch cached by the pool"},
     {"get_device_properties", getDeviceProperties, METH_VARARGS,
      "Get the properties for a given device"},
+    {"supports_profiling_tag", supportsProfilingTag, METH_VARARGS,
+     "Whether device timestamps can be recorded on a queue"},
+    {"submit_profiling_tag", submitProfilingTag, METH_VARARGS,
+     "Record a device timestamp on a queue"},
+    {"elapsed_time", elapsedTime, METH_VARARGS,
+     "Time in milliseconds elapsed between two device timestamps"},
+    {"create_queue", createQueue, METH_VARARGS,
+     "Create an in-order queue on the context and device of a queue"},
+    {"destroy_queue", destroyQueue, METH_VARARGS,
+     "Destroy a queue created by create_queue"},
+    {"submit_barrier", submitBarrier, METH_VARARGS,
+     "Submit a barrier waiting for events, or all the commands, to a queue"},
+    {"event_wait", eventWait, METH_VARARGS,
+     "Wait for the completion of an event"},
+    {"event_query", eventQuery, METH_VARARGS,
+     "Whether an event completed"},
+    {"graph_begin_capture", graphBeginCapture, METH_VARARGS,
+     "Start recording the commands submitted to a queue into a SYCL graph"},
+    {"graph_end_capture", graphEndCapture, METH_VARARGS,
+     "Stop recording the commands submitted to a queue"},
+    {"graph_finalize", graphFinalize, METH_VARARGS,
+     "Create an executable graph from a recorded SYCL graph"},
+    {"graph_update", graphUpdate, METH_VARARGS,
+     "Update the arguments of an executable graph from a recorded SYCL graph"},
+    {"graph_replay", graphReplay, METH_VARARGS,
+     "Submit an executable SYCL graph to a queue"},
+    {"can_access_peer", canAccessPeer, METH_VARARGS,
+     "Whether the kernels of a device can access the memory of a peer device"},
+    {"get_ipc_handle", getIpcHandle, METH_VARARGS,
+     "Get the IPC handle of the allocation holding a device pointer"},
+    {"open_ipc_handle", openIpcHandle, METH_VARARGS,
+     "Map the allocation of an IPC handle exported by another process"},
+    {"close_ipc_handle", closeIpcHandle, METH_VARARGS,
+     "Unmap an allocation mapped by open_ipc_handle"},
     {"init_context", initContext, METH_VARARGS,
      "Initialize the ZE GPU context"},
     {"init_devices", initDevices, METH_VARARGS,
@@ -291,5 +1167,9 @@ PyMODINIT_FUNC PyInit_spirv_utils(void) {
     return NULL;
   }
   PyModule_AddFunctions(m, ModuleMethods);
+#ifdef Py_GIL_DISABLED
+  // The devices are initialized once, before the kernels are loaded.
+  PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+#endif
   return m;
 }
@@ -1,14 +1,24 @@
+import contextlib
+import ctypes
 import importlib.metadata
 import os
 import hashlib
+import json
+import math
+import mmap
+import struct
 import shutil
 import tempfile
+import threading
+import time
 from pathlib import Path
-from functools import cached_property
+from functools import cached_property, lru_cache, partial
 
+from triton._C.libtriton import intel
 from triton.runtime.build import _build
-from triton.runtime.cache import get_cache_manager
+from triton.runtime.cache import ZSTD_MAGIC, compress_cache_entry, get_cache_manager, read_cache_entry
 from triton.backends.compiler import GPUTarget
+from triton.backends.intel.compiler import LLIR_NOT_KEPT, XPUBackend, report_compile_time
 from triton.backends.driver import DriverBase
 from packaging.version import Version
 from packaging.specifiers import SpecifierSet
@@ -125,6 +135,10 @@ def compile_module_from_src(src, name):
 # Utils
 # ------------------------
 
+# Layout of the tensor descriptors passed by value to the kernels, must match
+# `XPUTensorDescriptor` in the launcher: base address, width, height and pitch.
+_tensor_desc_struct = struct.Struct("<Qqqq")
+
 
 class XPUUtils(object):
 
@@ -136,11 +150,257 @@ class XPUUtils(object):
     def __init__(self):
         dirname = os.path.dirname(os.path.realpath(__file__))
         mod = compile_module_from_src(Path(os.path.join(dirname, "driver.c")).read_text(), "spirv_utils")
-        self.load_binary = mod.load_binary
+        self._load_binary = mod.load_binary
+        self._load_binaries = mod.load_binaries
+        self.get_native_binary = mod.get_native_binary
+        self.get_kernel_properties = mod.get_kernel_properties
+        self.copy_print_buffer = mod.copy_print_buffer
+        self.scratch_alloc = mod.scratch_alloc
+        self.scratch_free = mod.scratch_free
+        self.scratch_pool_stats = mod.scratch_pool_stats
+        self.scratch_pool_empty = mod.scratch_pool_empty
         self.get_device_properties = mod.get_device_properties
+        self.supports_profiling_tag = mod.supports_profiling_tag
+        self.submit_profiling_tag = mod.submit_profiling_tag
+        self.elapsed_time = mod.elapsed_time
+        self.create_queue = mod.create_queue
+        self.destroy_queue = mod.destroy_queue
+        self.submit_barrier = mod.submit_barrier
+        self.event_wait = mod.event_wait
+        self.event_query = mod.event_query
+        self.graph_begin_capture = mod.graph_begin_capture
+        self.graph_end_capture = mod.graph_end_capture
+        self.graph_finalize = mod.graph_finalize
+        self.graph_update = mod.graph_update
+        self.graph_replay = mod.graph_replay
+        # Access to the memory of peer devices, e.g. over Xe Link, see
+        # `triton.language.extra.intel.comm`.
+        self.can_access_peer = mod.can_access_peer
+        self.get_ipc_handle = mod.get_ipc_handle
+        self.open_ipc_handle = mod.open_ipc_handle
+        self.close_ipc_handle = mod.close_ipc_handle
         self.context = mod.init_context(self.get_sycl_queue())
         self.device_count = mod.init_devices(self.get_sycl_queue())
         self.current_device = 0 if self.device_count[0] > 0 else -1
+        self._native_binary_keys = {}
+        self._recorded_kernels = set()
+        self._linked_kernels = {}
+        # Time spent loading each kernel, until reported in its metadata.
+        self._load_times = {}
+
+    def _record_kernel(self, name, kernel, shared, build_flags, max_reg_spill):
+        # Store the SPIR-V under its content hash, so that identical kernels
+        # share one entry, and append the kernel to the manifest used by
+        # `python -m triton.backends.intel.prewarm` to fill the native binary
+        # cache on other nodes.
+        manifest_path = os.getenv("TRITON_INTEL_KERNEL_MANIFEST", "").strip()
+        if not manifest_path:
+            return
+        spirv_key = hashlib.sha256(kernel).hexdigest()
+        entry = (name, spirv_key, shared, build_flags, max_reg_spill)
+        if entry in self._recorded_kernels:
+            return
+        self._recorded_kernels.add(entry)
+        cache = get_cache_manager(spirv_key)
+        if cache.get_file(f"{name}.spv") is None:
+            cache.put(compress_cache_entry(kernel), f"{name}.spv", binary=True)
+        record = {
+            "name": name, "spirv": spirv_key, "shared": shared, "build_flags": build_flags, "max_reg_spill":
+            max_reg_spill
+        }
+        with open(manifest_path, "a") as f:
+            f.write(json.dumps(record) + "\n")
+
+    def _native_binary_key(self, kernel, build_flags, device, max_reg_spill):
+        # Native binaries are only valid for the device and driver (IGC) they
+        # were produced by.
+        if device not in self._native_binary_keys:
+            props = self.get_device_properties(device)
+            self._native_binary_keys[device] = f"{props['pci_device_id']}-{props['driver_version']}"
+        key = f"{hashlib.sha256(kernel).hexdigest()}-{build_flags}-{max_reg_spill}-{self._native_binary_keys[device]}"
+        return hashlib.sha256(key.encode("utf-8")).hexdigest()
+
+    def load_binary(self, name, kernel, shared, build_flags, device, max_reg_spill=1000):
+        """
+        Loads a SPIR-V kernel into the Level Zero driver.
+
+        If `build_flags` doesn't select a GRF mode and the kernel spills more
+        than `max_reg_spill` bytes, it is recompiled in large GRF mode.
+
+        The device native binary produced by the driver is stored in the Triton
+        cache, so that subsequent processes skip the finalizer (and a possible
+        large GRF recompilation). Set `TRITON_INTEL_NATIVE_BINARY_CACHE=0` to
+        always load from SPIR-V.
+
+        If `TRITON_INTEL_KERNEL_MANIFEST` is set, the kernel is recorded in the
+        manifest at this path.
+        """
+        start = time.perf_counter()
+        module, function, n_regs, n_spills = self._load_binary_cached(name, kernel, shared, build_flags, device,
+                                                                      max_reg_spill)
+        self._load_times.setdefault(function, time.perf_counter() - start)
+        return module, function, n_regs, n_spills
+
+    def _load_binary_cached(self, name, kernel, shared, build_flags, device, max_reg_spill):
+        self._record_kernel(name, kernel, shared, build_flags, max_reg_spill)
+        linked_key = (hashlib.sha256(kernel).hexdigest(), build_flags, device, max_reg_spill)
+        if linked_key in self._linked_kernels:
+            return self._linked_kernels.pop(linked_key)
+        if os.getenv("TRITON_INTEL_NATIVE_BINARY_CACHE", "1") != "1":
+            return self._load_binary(name, kernel, shared, build_flags, device, True, max_reg_spill)
+
+        cache = get_cache_manager(self._native_binary_key(kernel, build_flags, device, max_reg_spill))
+        loaded = self._load_native_binary(cache, name, shared, build_flags, device)
+        if loaded is not None:
+            return loaded
+
+        with self._native_binary_lock(cache, name):
+            # Loaded from the binary built by another process while waiting.
+            loaded = self._load_native_binary(cache, name, shared, build_flags, device)
+            if loaded is not None:
+                return loaded
+            module, function, n_regs, n_spills = self._load_binary(name, kernel, shared, build_flags, device, True,
+                                                                   max_reg_spill)
+            # The binary is stored last: the processes finding it find its info.
+            cache.put(json.dumps({"n_regs": n_regs}), f"{name}.zebin.json")
+            cache.put(compress_cache_entry(self.get_native_binary(module)), f"{name}.zebin", binary=True)
+        return module, function, n_regs, n_spills
+
+    def _load_native_binary(self, cache, name, shared, build_flags, device):
+        cache_path = cache.get_file(f"{name}.zebin")
+        info_path = cache.get_file(f"{name}.zebin.json")
+        if cache_path is None:
+            return None
+        try:
+            with open(cache_path, "rb") as f:
+                compressed = f.read(len(ZSTD_MAGIC)) == ZSTD_MAGIC
+            if compressed:
+                module, function, n_regs, n_spills = self._load_binary(name, read_cache_entry(cache_path), shared,
+                                                                       build_flags, device, False)
+            else:
+                # The driver copies the binary when it creates the module, the
+                # file is mapped rather than read.
+                with open(cache_path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as native_binary:
+                    module, function, n_regs, n_spills = self._load_binary(name, native_binary, shared, build_flags,
+                                                                           device, False)
+        except (RuntimeError, ValueError, ImportError):
+            # Stale, corrupted or empty binary, fall back to SPIR-V.
+            return None
+        # The GRF mode may have been switched when the binary was built.
+        if info_path is not None:
+            n_regs = json.loads(Path(info_path).read_text())["n_regs"]
+        return module, function, n_regs, n_spills
+
+    @contextlib.contextmanager
+    def _native_binary_lock(self, cache, name):
+        """
+        With `TRITON_INTEL_SHARED_NATIVE_BINARIES=1`, holds an exclusive lock on
+        the native binary of the kernel in the cache while it is built, so that
+        when processes sharing the cache (e.g. the workers of a server) start,
+        one of them builds it and the others wait and load it.
+        """
+        cache_dir = getattr(cache, "cache_dir", None)
+        if os.getenv("TRITON_INTEL_SHARED_NATIVE_BINARIES", "0") != "1" or not cache_dir:
+            yield
+            return
+        import fcntl
+        os.makedirs(cache_dir, exist_ok=True)
+        with open(os.path.join(cache_dir, f"{name}.zebin.lock"), "a") as lock:
+            fcntl.flock(lock, fcntl.LOCK_EX)
+            try:
+                yield
+            finally:
+                fcntl.flock(lock, fcntl.LOCK_UN)
+
+    def load_kernels(self, kernels, device):
+        """
+        Loads the compiled `kernels` (e.g. the configs of an autotuned
+        function) into the Level Zero driver, linking the kernels with the same
+        build flags into one SPIR-V module. Building a module has a large fixed
+        cost, so a single module creation per build flags is much faster than
+        one per kernel.
+
+        The kernels are then returned by `load_binary` when their handles are
+        initialized.
+        """
+        groups = {}
+        for kernel in kernels:
+            # Kernels compiled without keeping their LLVM IR cannot be linked.
+            if kernel.module is None and kernel.asm["llir"] != LLIR_NOT_KEPT:
+                key = (kernel.metadata.build_flags, kernel.metadata.max_reg_spill)
+                groups.setdefault(key, []).append(kernel)
+        for (build_flags, max_reg_spill), group in groups.items():
+            if len(group) == 1:
+                continue
+            # Autotuned configs share the kernel name.
+            names = [f"{kernel.name}_{i}" for i, kernel in enumerate(group)]
+            start = time.perf_counter()
+            spirv = intel.link_to_spirv([kernel.asm["llir"] for kernel in group], names,
+                                        XPUBackend.use_spirv_backend())
+            module, functions, n_regs, n_spills = self._load_binaries(names, spirv, build_flags, device,
+                                                                      max_reg_spill)
+            # The load time of the module is shared by its kernels.
+            load_time = (time.perf_counter() - start) / len(group)
+            for kernel, function, spills in zip(group, functions, n_spills):
+                self._load_times[function] = load_time
+                key = (hashlib.sha256(kernel.kernel).hexdigest(), build_flags, device, max_reg_spill)
+                self._linked_kernels[key] = (module, function, n_regs, spills)
+
+    def get_kernel_resources(self, function, n_regs, metadata, device):
+        """
+        Returns the resources used by a loaded kernel and the resulting
+        theoretical number of concurrent workgroups per Xe-core.
+        """
+        props = self.get_kernel_properties(function)
+        dev_props = self.get_device_properties(device)
+        # Add the time spent by the driver building the native binary, or
+        # loading it from the cache, to the compile stages.
+        compile_times = dict(getattr(metadata, "compile_times", {}))
+        if function in self._load_times:
+            compile_times["load_binary"] = self._load_times.pop(function)
+            report_compile_time("compile_load_binary", compile_times["load_binary"])
+        slm_size = metadata.shared + props["local_mem_size"]
+        # A sub-group runs on a hardware thread. The large GRF mode halves the
+        # number of threads of an EU.
+        threads_per_eu = dev_props["num_threads_per_eu"]
+        if n_regs == 256:
+            threads_per_eu //= 2
+        max_workgroups = dev_props["num_eus_per_xe_core"] * threads_per_eu // metadata.num_warps
+        if slm_size > 0:
+            max_workgroups = min(max_workgroups, dev_props["max_shared_mem"] // slm_size)
+        return {
+            "grf_per_thread": n_regs,
+            "slm_size": slm_size,
+            "private_mem_size": props["private_mem_size"],
+            "spill_size": props["spill_mem_size"],
+            "simd_width": props["required_sub_group_size"] or props["max_sub_group_size"],
+            "max_workgroups_per_xe_core": max_workgroups,
+            "compile_times": compile_times,
+        }
+
+    def fill_1d_tma_descriptor(self, global_address, dim, block_dim, element_size, desc_address):
+        """
+        Writes the tensor descriptor of a contiguous 1D tensor of `dim`
+        elements at the host address `desc_address`, see
+        `fill_2d_tma_descriptor`.
+        """
+        del block_dim, element_size
+        ctypes.memmove(desc_address, _tensor_desc_struct.pack(global_address, dim, 1, dim), _tensor_desc_struct.size)
+
+    def fill_2d_tma_descriptor(self, global_address, dim1, dim0, block_dim1, block_dim0, element_size, desc_address):
+        """
+        Writes the tensor descriptor of a row-major (`dim1`, `dim0`) tensor at
+        the host address `desc_address`, in the layout expected by the kernels:
+        the base address, the width, height and pitch of the tensor in
+        elements, as 64-bit words. The launcher passes the descriptor by value,
+        so the 2D block loads through it do not recompute the payload.
+        """
+        assert global_address % 64 == 0, "2D block I/O requires a 64-byte aligned base address"
+        assert (dim0 * element_size) % 16 == 0, "2D block I/O requires a pitch multiple of 16 bytes"
+        # The block shape is carried by the loads and stores.
+        del block_dim1, block_dim0
+        ctypes.memmove(desc_address, _tensor_desc_struct.pack(global_address, dim0, dim1, dim0),
+                       _tensor_desc_struct.size)
 
     def get_current_device(self):
         return self.current_device
@@ -153,6 +413,19 @@ class XPUUtils(object):
         return torch.xpu.current_stream().sycl_queue
 
 
+# The queue the kernels launched by the current thread are submitted to
+# instead of the current torch stream, see `XPUTaskQueue.launch`.
+_queue_override = threading.local()
+
+
+def _current_sycl_queue():
+    queue = getattr(_queue_override, "queue", None)
+    if queue is not None:
+        return queue
+    import torch
+    return torch.xpu.current_stream().sycl_queue
+
+
 # ------------------------
 # Launcher
 # ------------------------
@@ -177,53 +450,69 @@ def ty_to_cpp(ty):
         "fp32": "float",
         "f32": "float",
         "fp64": "double",
+        "nvTmaDesc": "XPUTensorDescriptor",
     }[ty]
 
 
-def make_launcher(constants, signature, ids):
-    # Record the end of regular arguments;
-    # subsequent arguments are architecture-specific descriptors.
-    arg_decls = ', '.join(f"{ty_to_cpp(ty)} arg{i}" for i, ty in signature.items())
-
-    def _extracted_type(ty):
-        if ty[0] == '*':
-            return "PyObject*"
-        return ty_to_cpp(ty)
-
-    def format_of(ty):
-        return {
-            "PyObject*": "O",
-            "float": "f",
-            "double": "d",
-            "long": "l",
-            "int8_t": "b",
-            "int16_t": "h",
-            "int32_t": "i",
-            "int64_t": "l",
-            "uint8_t": "B",
-            "uint16_t": "H",
-            "uint32_t": "I",
-            "uint64_t": "K",
-        }[ty]
+def ty_to_struct_format(ty):
+    return {
+        "void*": "P",
+        "int8_t": "b",
+        "int16_t": "h",
+        "int32_t": "i",
+        "int64_t": "q",
+        "uint8_t": "B",
+        "uint16_t": "H",
+        "uint32_t": "I",
+        "uint64_t": "Q",
+        "float": "f",
+        "double": "d",
+        "XPUTensorDescriptor": "Qqqq",
+    }[ty_to_cpp(ty)]
+
+
+def make_packed_args_struct(constants, signature):
+    """
+    Returns a `struct.Struct` with the layout of the `PackedArgs` C struct
+    generated by `make_launcher`.
+    """
+    formats = [ty_to_struct_format(ty) for i, ty in signature.items() if i not in constants]
+    if not formats:
+        # `PackedArgs` has a single `char` member.
+        return struct.Struct("@x")
+    # Pad the end of the struct to its alignment, as the C compiler does. The
+    # alignment of a field is the size of its first member.
+    alignment = max(struct.calcsize(f[0]) for f in formats)
+    return struct.Struct("@" + "".join(formats) + "0" + {1: "b", 2: "h", 4: "i", 8: "q"}[alignment])
 
-    args_format = ''.join([format_of(_extracted_type(ty)) for ty in signature.values()])
-    format = "iiiOOOOOO" + args_format
-    args_list = ', ' + ', '.join(f"&_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''
 
-    # generate glue code
-    src = f"""
+def _launcher_helpers_src(trusted_pointers, direct_launch):
+    """
+    Returns the C++ helpers shared by the launchers of `make_launcher` and
+    `make_generic_launcher`: pointer validation, kernel metadata and submission.
+    """
+    return f"""    #include <algorithm>
     #include <cstddef>
+    #include <map>
+    #include <mutex>
     #include <string>
     #include <iostream>
     #include <iomanip>
+    #include <unordered_map>
+    #include <vector>
     #include <level_zero/ze_api.h>
     #include <sycl/sycl.hpp>
 
+    #include "sycl_functions.h"
+    // Defined below for the launcher, which reports errors as Python exceptions.
+    #undef ZE_CHECK
+
     #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
     #include <Python.h>
     #include <stdio.h>
     #include <numpy/arrayobject.h>
 
+    // Also called by the submission of the launches, which releases the GIL.
     static inline void gpuAssert(ze_result_t code, const char *file, int line)
     {{
       if (code != ZE_RESULT_SUCCESS)
@@ -233,7 +522,9 @@ def make_launcher(constants, signature, ids):
          char err[1024] = {{0}};
          strcat(err, prefix);
          strcat(err, str.c_str());
+         PyGILState_STATE gil_state = PyGILState_Ensure();
          PyErr_SetString(PyExc_RuntimeError, err);
+         PyGILState_Release(gil_state);
       }}
     }}
 
@@ -244,17 +535,77 @@ def make_launcher(constants, signature, ids):
       bool valid;
     }} DevicePtrInfo;
 
+    // Tensor descriptor filled on the host by `fill_2d_tma_descriptor` and
+    // passed by value to the kernel.
+    typedef struct _XPUTensorDescriptor {{
+      uint64_t base;
+      int64_t width;
+      int64_t height;
+      int64_t pitch;
+    }} XPUTensorDescriptor;
+
+    static inline bool getTensorDescriptor(PyObject *obj, XPUTensorDescriptor *desc) {{
+      PyObject *ret = PyObject_CallMethod(obj, "tma_desc_cpu_ptr", NULL);
+      if (!ret) {{
+        return false;
+      }}
+      if (!PyLong_Check(ret)) {{
+        Py_DECREF(ret);
+        PyErr_SetString(PyExc_TypeError, "tma_desc_cpu_ptr() must return 64-bit int");
+        return false;
+      }}
+      void *ptr = PyLong_AsVoidPtr(ret);
+      Py_DECREF(ret);
+      if (!ptr) {{
+        PyErr_SetString(PyExc_ValueError, "received NULL ptr from tma_desc_cpu_ptr()");
+        return false;
+      }}
+      memcpy(desc, ptr, sizeof(XPUTensorDescriptor));
+      return true;
+    }}
+
+    // Skip the USM checks of pointer arguments (TRITON_INTEL_TRUSTED_POINTERS=1).
+    static constexpr bool trusted_pointers = {"true" if trusted_pointers else "false"};
+
+    // USM allocations already known to be device memory, indexed by the end
+    // of their address range. Guarded by `device_allocations_mutex` for the
+    // free-threaded builds of Python.
+    static std::map<uintptr_t, uintptr_t> device_allocations;
+    static std::mutex device_allocations_mutex;
+
+    static inline bool isKnownDevicePointer(uintptr_t ptr) {{
+      std::lock_guard<std::mutex> lock(device_allocations_mutex);
+      auto it = device_allocations.upper_bound(ptr);
+      return it != device_allocations.end() && it->second <= ptr;
+    }}
+
+    // Whether the kernels submitted to `queue` can access the memory of
+    // `device`: their own device, or a peer device (e.g. over Xe Link). The
+    // memory of a peer is allocated in the same context, or imported from
+    // another process with an IPC handle.
+    static inline bool canAccessDevice(const sycl::queue &queue, ze_device_handle_t device) {{
+      auto queue_device = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(queue.get_device());
+      if (device == nullptr || device == queue_device)
+        return true;
+      ze_bool_t can_access = false;
+      return zeDeviceCanAccessPeer(queue_device, device, &can_access) == ZE_RESULT_SUCCESS && can_access;
+    }}
+
     static inline void checkDevicePointer(DevicePtrInfo *ptr_info, int idx, const sycl::queue &queue) {{
-      if (!ptr_info->dev_ptr || !ptr_info->valid) {{
+      if (trusted_pointers || !ptr_info->dev_ptr || !ptr_info->valid) {{
+        return;
+      }}
+      uintptr_t ptr = reinterpret_cast<uintptr_t>(ptr_info->dev_ptr);
+      if (isKnownDevicePointer(ptr)) {{
         return;
       }}
       auto context = queue.get_context();
-      auto handle = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(context);
+      auto handle = (ze_context_handle_t)sycl::get_native<sycl::backend::ext_oneapi_level_zero>(context);
       ze_memory_allocation_properties_t prop;
       prop.stype = ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES;
       prop.pNext = nullptr;
       ze_device_handle_t device;
-      auto res = zeMemGetAllocProperties((ze_context_handle_t)handle, ptr_info->dev_ptr, &prop, &device);
+      auto res = zeMemGetAllocProperties(handle, ptr_info->dev_ptr, &prop, &device);
       if (res != ZE_RESULT_SUCCESS) {{
         PyErr_Format(PyExc_ValueError,
                      "Cannot get memory properties for pointer argument (at %d, err=%d)", idx, res);
@@ -263,6 +614,18 @@ def make_launcher(constants, signature, ids):
         PyErr_Format(PyExc_ValueError,
                      "Pointer argument (at %d) doesn't reference XPU device memory (cpu tensor?)", idx);
         ptr_info->valid = false;
+      }} else if (!canAccessDevice(queue, device)) {{
+        PyErr_Format(PyExc_ValueError,
+                     "Pointer argument (at %d) references the memory of a device without peer access", idx);
+        ptr_info->valid = false;
+      }} else {{
+        void *base = nullptr;
+        size_t size = 0;
+        if (zeMemGetAddressRange(handle, ptr_info->dev_ptr, &base, &size) == ZE_RESULT_SUCCESS && size > 0) {{
+          uintptr_t begin = reinterpret_cast<uintptr_t>(base);
+          std::lock_guard<std::mutex> lock(device_allocations_mutex);
+          device_allocations[begin + size] = begin;
+        }}
       }}
     }}
 
@@ -279,27 +642,27 @@ def make_launcher(constants, signature, ids):
         // valid nullptr
         return ptr_info;
       }}
-      PyObject *ptr = PyObject_GetAttrString(obj, "data_ptr");
-      if(ptr){{
-        PyObject *empty_tuple = PyTuple_New(0);
-        PyObject *ret = PyObject_Call(ptr, empty_tuple, NULL);
-        Py_DECREF(empty_tuple);
-        Py_DECREF(ptr);
-        if (!PyLong_Check(ret)) {{
-          PyErr_SetString(PyExc_TypeError, "data_ptr method of Pointer object must return 64-bit int");
+      static PyObject *data_ptr_str = PyUnicode_InternFromString("data_ptr");
+      PyObject *ret = PyObject_CallMethodNoArgs(obj, data_ptr_str);
+      if (!ret) {{
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {{
           ptr_info.valid = false;
           return ptr_info;
         }}
-        ptr_info.dev_ptr = PyLong_AsVoidPtr(ret);
-        if(!ptr_info.dev_ptr) {{
-          return ptr_info;
-        }}
-        checkDevicePointer(&ptr_info, idx, queue);
-        Py_DECREF(ret);  // Thanks ChatGPT!
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "Pointer argument must be either uint64 or have data_ptr method");
+        ptr_info.valid = false;
         return ptr_info;
       }}
-      PyErr_SetString(PyExc_TypeError, "Pointer argument must be either uint64 or have data_ptr method");
-      ptr_info.valid = false;
+      if (!PyLong_Check(ret)) {{
+        Py_DECREF(ret);
+        PyErr_SetString(PyExc_TypeError, "data_ptr method of Pointer object must return 64-bit int");
+        ptr_info.valid = false;
+        return ptr_info;
+      }}
+      ptr_info.dev_ptr = PyLong_AsVoidPtr(ret);
+      Py_DECREF(ret);
+      checkDevicePointer(&ptr_info, idx, queue);
       return ptr_info;
     }}
 // start sycl
@@ -307,11 +670,126 @@ def make_launcher(constants, signature, ids):
   static inline void set_scalar_arg(sycl::handler &cgh, int index, const void *value) {{
     cgh.set_arg(index, *static_cast<const T *>(value));
   }}
-  static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, sycl::queue& stream, sycl::kernel& kernel_ptr {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
-
-    std::string kernel_name = kernel_ptr.get_info<sycl::info::kernel::function_name>();
-    void *params[] = {{ {', '.join(f"&arg{i}" for i in signature.keys() if i not in constants)} }};
-    uint32_t num_params = sizeof(params)/sizeof(params[0]);
+  // In-order queues on the stacks of the device of `stream`, created on the
+  // first launch with explicit scaling. The list is empty when the device has
+  // a single stack or is a stack itself (flat device hierarchy).
+  static std::vector<sycl::queue> &getStackQueues(sycl::queue &stream) {{
+    static std::unordered_map<sycl::queue, std::vector<sycl::queue>> stack_queues;
+    static std::mutex stack_queues_mutex;
+    std::lock_guard<std::mutex> lock(stack_queues_mutex);
+    auto it = stack_queues.find(stream);
+    if (it != stack_queues.end())
+      return it->second;
+    std::vector<sycl::queue> &queues = stack_queues[stream];
+    sycl::device device = stream.get_device();
+    try {{
+      if (device.get_info<sycl::info::device::partition_max_sub_devices>() > 1) {{
+        auto stacks = device.create_sub_devices<sycl::info::partition_property::partition_by_affinity_domain>(
+            sycl::info::partition_affinity_domain::next_partitionable);
+        for (const sycl::device &stack : stacks)
+          queues.emplace_back(stream.get_context(), stack, sycl::property::queue::in_order());
+      }}
+    }} catch (const sycl::exception &) {{
+      queues.clear();
+    }}
+    return queues;
+  }}
+  // In-order queue on the device of `stream`, created on the first dependent
+  // launch (`launch_pdl`) on it. The dependent kernels are submitted to it so
+  // that they do not wait for the commands before them on `stream`.
+  static sycl::queue &getCompanionQueue(sycl::queue &stream) {{
+    static std::unordered_map<sycl::queue, sycl::queue> companion_queues;
+    static std::mutex companion_queues_mutex;
+    std::lock_guard<std::mutex> lock(companion_queues_mutex);
+    auto it = companion_queues.find(stream);
+    if (it == companion_queues.end())
+      it = companion_queues.emplace(stream, sycl::queue(stream.get_context(), stream.get_device(),
+                                                        sycl::property::queue::in_order())).first;
+    return it->second;
+  }}
+  // Append the kernel launches to the Level Zero immediate command list of
+  // the queue (TRITON_INTEL_DIRECT_LAUNCH=1), bypassing the SYCL scheduler.
+  static constexpr bool direct_launch = {"true" if direct_launch else "false"};
+  // Events signaled by the direct launches on a queue, reused round-robin.
+  static constexpr uint32_t num_direct_launch_events = 64;
+  // An in-order queue with an immediate command list, on which the kernels
+  // are launched directly. Each launch signals an event, set as the external
+  // event of the queue: the SYCL commands submitted after it, and
+  // `queue.wait()`, wait for the kernel. The direct launches are serialized
+  // by `direct_launch_mutex`, as they set the arguments of the kernel handles
+  // shared by all the queues.
+  typedef struct _DirectQueue {{
+    ze_command_list_handle_t cmd_list = nullptr;
+    ze_event_pool_handle_t event_pool = nullptr;
+    std::vector<ze_event_handle_t> events;
+    size_t num_launches = 0;
+  }} DirectQueue;
+  // Found on the first launch on each queue. Null if the queue does not use an
+  // immediate command list.
+  static std::mutex direct_launch_mutex;
+  static DirectQueue *getDirectQueue(sycl::queue &stream) {{
+    static std::unordered_map<sycl::queue, DirectQueue> direct_queues;
+    std::lock_guard<std::mutex> lock(direct_launch_mutex);
+    auto it = direct_queues.find(stream);
+    if (it != direct_queues.end())
+      return it->second.cmd_list ? &it->second : nullptr;
+    DirectQueue &direct = direct_queues[stream];
+    SyclQueueMap handles;
+    if (!stream.is_in_order() || update(stream, handles).empty() || !handles[stream].cmd_list)
+      return nullptr;
+    ze_device_handle_t device = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(stream.get_device());
+    ze_event_pool_desc_t pool_desc = {{ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr, ZE_EVENT_POOL_FLAG_HOST_VISIBLE,
+                                      num_direct_launch_events}};
+    if (zeEventPoolCreate(handles[stream].context, &pool_desc, 1, &device, &direct.event_pool) != ZE_RESULT_SUCCESS)
+      return nullptr;
+    for (uint32_t i = 0; i < num_direct_launch_events; ++i) {{
+      ze_event_desc_t event_desc = {{ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i, ZE_EVENT_SCOPE_FLAG_HOST,
+                                    ZE_EVENT_SCOPE_FLAG_HOST}};
+      ze_event_handle_t event;
+      if (zeEventCreate(direct.event_pool, &event_desc, &event) != ZE_RESULT_SUCCESS)
+        return nullptr;
+      direct.events.push_back(event);
+    }}
+    direct.cmd_list = handles[stream].cmd_list;
+    return &direct;
+  }}
+  // Sets the work-group size of `kernel`, unless it is already set. The size
+  // of a kernel only changes with its number of warps, i.e. never.
+  static void setGroupSize(ze_kernel_handle_t kernel, uint32_t group_size) {{
+    static std::unordered_map<ze_kernel_handle_t, uint32_t> group_sizes;
+    auto [it, inserted] = group_sizes.try_emplace(kernel, group_size);
+    if (inserted || it->second != group_size) {{
+      ZE_CHECK(zeKernelSetGroupSize(kernel, group_size, 1, 1));
+      it->second = group_size;
+    }}
+  }}
+  static void zeKernelLaunch(DirectQueue &direct, sycl::queue &stream, sycl::kernel &kernel, uint32_t gridX,
+                             uint32_t gridY, uint32_t gridZ, uint32_t group_size, int shared_memory, void **params,
+                             const size_t *param_sizes, uint32_t num_params) {{
+    std::lock_guard<std::mutex> lock(direct_launch_mutex);
+    auto l0_kernel = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(kernel);
+    setGroupSize(l0_kernel, group_size);
+    for (uint32_t i = 0; i < num_params; ++i)
+      ZE_CHECK(zeKernelSetArgumentValue(l0_kernel, i, param_sizes[i], params[i]));
+    if (shared_memory)
+      ZE_CHECK(zeKernelSetArgumentValue(l0_kernel, num_params, shared_memory, nullptr));
+    ze_event_handle_t event = direct.events[direct.num_launches % direct.events.size()];
+    // The event was signaled by the launch `num_direct_launch_events` before,
+    // usually long complete.
+    if (direct.num_launches++ >= direct.events.size()) {{
+      ZE_CHECK(zeEventHostSynchronize(event, UINT64_MAX));
+      ZE_CHECK(zeEventHostReset(event));
+    }}
+    ze_group_count_t group_count = {{gridX, gridY, gridZ}};
+    ZE_CHECK(zeCommandListAppendLaunchKernel(direct.cmd_list, l0_kernel, &group_count, event, 0, nullptr));
+    stream.ext_oneapi_set_external_event(sycl::make_event<sycl::backend::ext_oneapi_level_zero>(
+        {{event, sycl::ext::oneapi::level_zero::ownership::keep}}, stream.get_context()));
+  }}
+  // Submits `kernel_ptr` with the `num_params` arguments at `params`, set on
+  // the SYCL handler by `set_args` and sized by `param_sizes` for direct
+  // launches. Runs without the GIL.
+  template <class SetArgs>
+  static void sycl_kernel_submit(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, bool explicit_scaling, bool launch_pdl, sycl::queue& stream, sycl::kernel& kernel_ptr, void **params, const size_t *param_sizes, uint32_t num_params, SetArgs set_args) {{
     uint32_t expected_num_params = kernel_ptr.get_info<sycl::info::kernel::num_args>();
     size_t global_range_x = gridX*threads_per_warp*num_warps;
     size_t global_range_y = gridY;
@@ -326,53 +804,315 @@ def make_launcher(constants, signature, ids):
       expected_num_params -= 1;
     }}
     assert(num_params == expected_num_params && "number of kernel param not matched");
-    // Submit the imported kernel.
-    auto cgf = [&](sycl::handler &cgh) {{
-      {" ".join(f'set_scalar_arg<{ty_to_cpp(item)}>(cgh, {idx}, params[{idx}]);' for idx, item in enumerate([signature[i] for i in signature if i not in constants]))}
-      if (shared_memory) {{
-          using share_mem_t = sycl::local_accessor<int8_t, 1>;
-          share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
-          cgh.set_arg(num_params, local_buffer);
-          cgh.parallel_for(parallel_work_size, kernel_ptr);
-      }} else {{
-          cgh.parallel_for(parallel_work_size, kernel_ptr);
+    // Submit the imported kernel over `work_size`, after `after` if not null.
+    auto submit = [&](sycl::queue &queue, const sycl::nd_range<3> &work_size, const sycl::event *after) {{
+      return queue.submit([&](sycl::handler &cgh) {{
+        if (after)
+          cgh.depends_on(*after);
+        set_args(cgh);
+        if (shared_memory) {{
+            using share_mem_t = sycl::local_accessor<int8_t, 1>;
+            share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
+            cgh.set_arg(num_params, local_buffer);
+            cgh.parallel_for(work_size, kernel_ptr);
+        }} else {{
+            cgh.parallel_for(work_size, kernel_ptr);
+        }}
+      }});
+    }};
+    if (launch_pdl) {{
+      // The kernel starts alongside the commands before it on `stream`, and
+      // waits for the data they produce itself. The commands after it on
+      // `stream` still wait for it.
+      sycl::event done = submit(getCompanionQueue(stream), parallel_work_size, nullptr);
+      stream.ext_oneapi_submit_barrier({{done}});
+      return;
+    }}
+    if (explicit_scaling) {{
+      std::vector<sycl::queue> &stacks = getStackQueues(stream);
+      size_t num_stacks = stacks.size();
+      if (num_stacks > 1 && gridX >= num_stacks) {{
+        // Each stack runs a contiguous range of the program ids along X, e.g.
+        // neighbouring M-blocks of a GEMM sharing the L3 cache of the stack.
+        // The kernel adds the global offset of its stack to its program id.
+        // The barriers order the launch like a single kernel on `stream`.
+        sycl::event ready = stream.ext_oneapi_submit_barrier();
+        std::vector<sycl::event> done;
+        for (size_t s = 0; s < num_stacks; ++s) {{
+          size_t begin = gridX * s / num_stacks;
+          size_t end = gridX * (s + 1) / num_stacks;
+          sycl::range<3> stack_range(global_range_z, global_range_y, (end - begin) * local_range_x);
+          sycl::id<3> stack_offset(0, 0, begin * local_range_x);
+          done.push_back(submit(stacks[s], sycl::nd_range<3>(stack_range, local_range, stack_offset), &ready));
+        }}
+        stream.ext_oneapi_submit_barrier(done);
+        return;
       }}
-      }};
-    auto event = stream.submit(cgf);
+    }}
+    // Launches recorded into a SYCL graph go through the queue.
+    if (direct_launch && stream.ext_oneapi_get_state() == sycl::ext::oneapi::experimental::queue_state::executing) {{
+      if (DirectQueue *direct = getDirectQueue(stream)) {{
+        zeKernelLaunch(*direct, stream, kernel_ptr, gridX, gridY, gridZ, local_range_x, shared_memory, params,
+                       param_sizes, num_params);
+        return;
+      }}
+    }}
+    submit(stream, parallel_work_size, nullptr);
+  }}
+  // Launches `kernel_ptr` as `sycl_kernel_submit`. The arguments were already
+  // extracted from their Python objects, so the submission runs with the GIL
+  // released: the threads launching kernels on other queues are not
+  // serialized behind it.
+  template <class SetArgs>
+  static void sycl_kernel_launch_impl(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, bool explicit_scaling, bool launch_pdl, sycl::queue& stream, sycl::kernel& kernel_ptr, void **params, const size_t *param_sizes, uint32_t num_params, SetArgs set_args) {{
+    std::string error;
+    Py_BEGIN_ALLOW_THREADS;
+    try {{
+      sycl_kernel_submit(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, explicit_scaling, launch_pdl, stream,
+                         kernel_ptr, params, param_sizes, num_params, set_args);
+    }} catch (const sycl::exception &e) {{
+      error = e.what();
+    }}
+    Py_END_ALLOW_THREADS;
+    if (!error.empty())
+      PyErr_SetString(PyExc_RuntimeError, error.c_str());
   }}
 // end sycl
-    static PyObject* launch(PyObject* self, PyObject* args) {{
+    // Kernel metadata decoded on the first launch of a kernel. It is cached as
+    // the context of the kernel capsule, which releases it with `free`.
+    typedef struct _KernelMetadata {{
+      int num_warps;
+      int num_ctas;
+      int shared_memory;
+      int threads_per_warp;
+      int explicit_scaling;
+      // Work-groups guaranteed to be resident at once, or 0 if the kernel is
+      // not launched as a cooperative grid.
+      int max_cooperative_workgroups;
+      // Whether the kernel is a dependent launch, and the work-groups
+      // guaranteed to be resident at once then.
+      int launch_pdl;
+      int max_dependent_workgroups;
+      int cluster_dims[3];
+    }} KernelMetadata;
+
+    static inline bool getIntAttr(PyObject *obj, const char *name, int *value) {{
+      PyObject *attr = PyObject_GetAttrString(obj, name);
+      if (!attr)
+        return false;
+      *value = PyLong_AsLong(attr);
+      Py_DECREF(attr);
+      return !PyErr_Occurred();
+    }}
 
-      int gridX, gridY, gridZ;
-      PyObject *launch_enter_hook = NULL;
-      PyObject *launch_exit_hook = NULL;
-      PyObject *kernel_metadata = NULL;
-      PyObject *launch_metadata = NULL;
-      PyObject *py_obj_stream;
-      PyObject* py_kernel;
+    // The work-groups of `kernel` the device can run at once, as needed by a
+    // grid-wide barrier. The kernel has `num_kernel_params` arguments before
+    // the SLM buffer.
+    static int getMaxCooperativeWorkgroups(sycl::kernel &kernel, const KernelMetadata &metadata,
+                                           uint32_t num_kernel_params) {{
+      auto l0_kernel = sycl::get_native<sycl::backend::ext_oneapi_level_zero>(kernel);
+      uint32_t group_size = metadata.num_warps * metadata.threads_per_warp;
+      // The count depends on the work-group size and on the SLM buffer, which
+      // are set again when the kernel is submitted.
+      setGroupSize(l0_kernel, group_size);
+      if (metadata.shared_memory)
+        ZE_CHECK(zeKernelSetArgumentValue(l0_kernel, num_kernel_params, metadata.shared_memory, nullptr));
+      uint32_t count = 0;
+      ZE_CHECK(zeKernelSuggestMaxCooperativeGroupCount(l0_kernel, &count));
+      return PyErr_Occurred() ? -1 : static_cast<int>(count);
+    }}
 
-      {' '.join([f"{_extracted_type(ty)} _arg{i}; " for i, ty in signature.items()])}
-      if(!PyArg_ParseTuple(args, \"{format}\", &gridX, &gridY, &gridZ, &py_obj_stream, &py_kernel,
-                                           &kernel_metadata, &launch_metadata,
-                                           &launch_enter_hook, &launch_exit_hook {args_list})) {{
-        return NULL;
+    // Clamps the X dimension of the grid of a cooperative kernel to the
+    // work-groups resident at once. Cooperative kernels stride over their work
+    // by `tl.num_programs`.
+    static bool clampCooperativeGrid(const KernelMetadata *metadata, int *gridX, int gridY, int gridZ) {{
+      int max_workgroups = metadata->max_cooperative_workgroups;
+      if (!max_workgroups || gridY == 0 || gridZ == 0)
+        return true;
+      if ((int64_t)gridY * gridZ > max_workgroups) {{
+        PyErr_Format(PyExc_RuntimeError,
+                     "cooperative grid of %d x %d programs along Y and Z exceeds the %d resident work-groups",
+                     gridY, gridZ, max_workgroups);
+        return false;
       }}
+      *gridX = std::min(*gridX, max_workgroups / (gridY * gridZ));
+      return true;
+    }}
+
+    // Rejects the grids of dependent launches larger than the work-groups
+    // resident at once, whose programs could wait for programs never running.
+    static bool checkDependentGrid(const KernelMetadata *metadata, int gridX, int gridY, int gridZ) {{
+      if (!metadata->launch_pdl || (int64_t)gridX * gridY * gridZ <= metadata->max_dependent_workgroups)
+        return true;
+      PyErr_Format(PyExc_RuntimeError,
+                   "dependent launch of %d x %d x %d programs exceeds the %d resident work-groups",
+                   gridX, gridY, gridZ, metadata->max_dependent_workgroups);
+      return false;
+    }}
 
-      // extract kernel metadata
-      int num_warps     = PyLong_AsLong(PyObject_GetAttrString(kernel_metadata, "num_warps"));
-      int num_ctas      = PyLong_AsLong(PyObject_GetAttrString(kernel_metadata, "num_ctas"));
-      int shared_memory = PyLong_AsLong(PyObject_GetAttrString(kernel_metadata, "shared"));
-      int threads_per_warp = PyLong_AsLong(PyObject_GetAttrString(kernel_metadata, "threads_per_warp"));
+    static KernelMetadata *getKernelMetadata(PyObject *py_kernel, PyObject *kernel_metadata,
+                                              uint32_t num_kernel_params) {{
+      KernelMetadata *metadata = static_cast<KernelMetadata *>(PyCapsule_GetContext(py_kernel));
+      if (metadata || PyErr_Occurred())
+        return metadata;
+
+      KernelMetadata decoded;
+      if (!getIntAttr(kernel_metadata, "num_warps", &decoded.num_warps) ||
+          !getIntAttr(kernel_metadata, "num_ctas", &decoded.num_ctas) ||
+          !getIntAttr(kernel_metadata, "shared", &decoded.shared_memory) ||
+          !getIntAttr(kernel_metadata, "threads_per_warp", &decoded.threads_per_warp))
+        return NULL;
+      // Kernels compiled before TRITON_INTEL_EXPLICIT_SCALING lack the field.
+      if (!getIntAttr(kernel_metadata, "explicit_scaling", &decoded.explicit_scaling)) {{
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+          return NULL;
+        PyErr_Clear();
+        decoded.explicit_scaling = 0;
+      }}
+      int launch_cooperative_grid = 0;
+      if (!getIntAttr(kernel_metadata, "launch_cooperative_grid", &launch_cooperative_grid)) {{
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+          return NULL;
+        PyErr_Clear();
+      }}
+      decoded.max_cooperative_workgroups = 0;
+      if (launch_cooperative_grid) {{
+        // The stacks of a device are not guaranteed to run at once.
+        decoded.explicit_scaling = 0;
+        sycl::kernel *kernel = reinterpret_cast<sycl::kernel *>(PyCapsule_GetPointer(py_kernel, "kernel"));
+        decoded.max_cooperative_workgroups = getMaxCooperativeWorkgroups(*kernel, decoded, num_kernel_params);
+        if (decoded.max_cooperative_workgroups < 0)
+          return NULL;
+        if (decoded.max_cooperative_workgroups == 0) {{
+          PyErr_SetString(PyExc_RuntimeError, "the kernel cannot be launched as a cooperative grid");
+          return NULL;
+        }}
+      }}
+      decoded.launch_pdl = 0;
+      if (!getIntAttr(kernel_metadata, "launch_pdl", &decoded.launch_pdl)) {{
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+          return NULL;
+        PyErr_Clear();
+        decoded.launch_pdl = 0;
+      }}
+      decoded.max_dependent_workgroups = 0;
+      if (decoded.launch_pdl) {{
+        // The programs of a dependent kernel wait for the previous kernels,
+        // which only terminates if they are all resident.
+        decoded.explicit_scaling = 0;
+        sycl::kernel *kernel = reinterpret_cast<sycl::kernel *>(PyCapsule_GetPointer(py_kernel, "kernel"));
+        decoded.max_dependent_workgroups = getMaxCooperativeWorkgroups(*kernel, decoded, num_kernel_params);
+        if (decoded.max_dependent_workgroups < 0)
+          return NULL;
+      }}
 
       // extract cluster dims
-      PyObject *clusterDim =  PyObject_GetAttrString(kernel_metadata, "cluster_dims");
-      if (!PyTuple_Check(kernel_metadata)) {{
-        PyErr_SetString(PyExc_TypeError, "kernel_metadata.cluster_dims must be a tuple");
+      PyObject *clusterDim = PyObject_GetAttrString(kernel_metadata, "cluster_dims");
+      if (!clusterDim)
+        return NULL;
+      if (!PyTuple_Check(clusterDim) || PyTuple_Size(clusterDim) != 3) {{
+        Py_DECREF(clusterDim);
+        PyErr_SetString(PyExc_TypeError, "kernel_metadata.cluster_dims must be a tuple of 3 elements");
+        return NULL;
+      }}
+      for (int i = 0; i < 3; ++i)
+        decoded.cluster_dims[i] = PyLong_AsLong(PyTuple_GetItem(clusterDim, i));
+      Py_DECREF(clusterDim);
+      if (PyErr_Occurred())
+        return NULL;
+
+      metadata = static_cast<KernelMetadata *>(malloc(sizeof(KernelMetadata)));
+      if (!metadata) {{
+        PyErr_NoMemory();
+        return NULL;
+      }}
+      *metadata = decoded;
+      if (PyCapsule_SetContext(py_kernel, metadata) != 0) {{
+        free(metadata);
         return NULL;
       }}
-      int clusterDimX   = PyLong_AsLong(PyTuple_GetItem(clusterDim, 0));
-      int clusterDimY   = PyLong_AsLong(PyTuple_GetItem(clusterDim, 1));
-      int clusterDimZ   = PyLong_AsLong(PyTuple_GetItem(clusterDim, 2));
+      return metadata;
+    }}
+
+    static bool getKernelAndQueue(PyObject *py_obj_stream, PyObject *py_kernel, sycl::queue **stream,
+                                  sycl::kernel **kernel) {{
+      void *pStream = PyLong_AsVoidPtr(py_obj_stream);
+      //error check
+      if (pStream == nullptr || py_kernel == nullptr)
+        return false;
+      *stream = static_cast<sycl::queue *>(pStream);
+      *kernel = reinterpret_cast<sycl::kernel *>(PyCapsule_GetPointer(py_kernel, "kernel"));
+      return *kernel != nullptr;
+    }}
+    """
+
+
+def make_launcher(constants, signature, ids, dead_args=()):
+    # The arguments in `dead_args` were removed from the kernel: they are
+    # accepted by the entry points but neither converted nor set.
+    kernel_signature = {i: ty for i, ty in signature.items() if i not in dead_args}
+    # Record the end of regular arguments;
+    # subsequent arguments are architecture-specific descriptors.
+    arg_decls = ', '.join(f"{ty_to_cpp(ty)} arg{i}" for i, ty in kernel_signature.items())
+
+    def _extracted_type(ty, i=None):
+        if ty[0] == '*' or ty == "nvTmaDesc" or i in dead_args:
+            return "PyObject*"
+        return ty_to_cpp(ty)
+
+    def format_of(ty):
+        return {
+            "PyObject*": "O",
+            "float": "f",
+            "double": "d",
+            "long": "l",
+            "int8_t": "b",
+            "int16_t": "h",
+            "int32_t": "i",
+            "int64_t": "l",
+            "uint8_t": "B",
+            "uint16_t": "H",
+            "uint32_t": "I",
+            "uint64_t": "K",
+        }[ty]
+
+    args_format = ''.join([format_of(_extracted_type(ty, i)) for i, ty in signature.items()])
+    format = "iiiOOOOOO" + args_format
+    format_without_hooks = "OOiiiO" + args_format
+    args_list = ', ' + ', '.join(f"&_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''
+    params_list = ''.join(f", {_extracted_type(ty, i)} _arg{i}" for i, ty in signature.items())
+    call_args_list = ''.join(f", _arg{i}" for i in signature)
+    packed_signature = {i: ty for i, ty in kernel_signature.items() if i not in constants}
+    trusted_pointers = os.getenv("TRITON_INTEL_TRUSTED_POINTERS", "0") == "1"
+    direct_launch = os.getenv("TRITON_INTEL_DIRECT_LAUNCH", "0") == "1"
+
+    # generate glue code
+    src = f"""
+    {_launcher_helpers_src(trusted_pointers, direct_launch)}
+  static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ, int num_warps, int threads_per_warp, int shared_memory, bool explicit_scaling, bool launch_pdl, sycl::queue& stream, sycl::kernel& kernel_ptr {', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+    void *params[] = {{ {', '.join(f"&arg{i}" for i in kernel_signature.keys() if i not in constants)} }};
+    size_t param_sizes[] = {{ {', '.join(f"sizeof(arg{i})" for i in kernel_signature.keys() if i not in constants)} }};
+    uint32_t num_params = sizeof(params)/sizeof(params[0]);
+    sycl_kernel_launch_impl(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, explicit_scaling, launch_pdl, stream,
+                            kernel_ptr, params, param_sizes, num_params, [&](sycl::handler &cgh) {{
+      {" ".join(f'set_scalar_arg<{ty_to_cpp(item)}>(cgh, {idx}, params[{idx}]);' for idx, item in enumerate([kernel_signature[i] for i in kernel_signature if i not in constants]))}
+    }});
+  }}
+
+    // Number of arguments of the kernel, before the SLM buffer.
+    static constexpr uint32_t num_kernel_params = {len(packed_signature)};
+
+    static PyObject* launchKernel(int gridX, int gridY, int gridZ, PyObject *py_obj_stream, PyObject *py_kernel,
+                                  PyObject *kernel_metadata, PyObject *launch_metadata,
+                                  PyObject *launch_enter_hook, PyObject *launch_exit_hook{params_list}) {{
+      sycl::queue *stream;
+      sycl::kernel *kernel;
+      if (!getKernelAndQueue(py_obj_stream, py_kernel, &stream, &kernel)) return NULL;
+      KernelMetadata *metadata = getKernelMetadata(py_kernel, kernel_metadata, num_kernel_params);
+      if (!metadata) return NULL;
+      if (!clampCooperativeGrid(metadata, &gridX, gridY, gridZ)) return NULL;
+      if (!checkDependentGrid(metadata, gridX, gridY, gridZ)) return NULL;
+
       // extract launch metadata
       if (launch_enter_hook != Py_None){{
         PyObject* args = Py_BuildValue("(O)", launch_metadata);
@@ -382,17 +1122,9 @@ def make_launcher(constants, signature, ids):
           return NULL;
       }}
 
-      void * pStream = PyLong_AsVoidPtr(py_obj_stream);
-      //error check
-      if(pStream == nullptr || py_kernel == nullptr) return NULL;
-
-      sycl::queue stream = *(static_cast<sycl::queue*>(pStream));
-      sycl::kernel* kernel_ptr = reinterpret_cast<sycl::kernel*>(PyCapsule_GetPointer(py_kernel, "kernel"));
-      if(kernel_ptr == nullptr) return NULL;
-      sycl::kernel kernel = *kernel_ptr;
-
-      {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}, stream); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
-      sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp, shared_memory, stream, kernel {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"_arg{i}" for i, ty in signature.items()) if len(signature) > 0 else ''});
+      {"; ".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}, *stream); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in kernel_signature.items()])};
+      {" ".join([f"XPUTensorDescriptor desc{i}; if (!getTensorDescriptor(_arg{i}, &desc{i})) return NULL;" for i, ty in kernel_signature.items() if ty == "nvTmaDesc"])}
+      sycl_kernel_launch(gridX, gridY, gridZ, metadata->num_warps, metadata->threads_per_warp, metadata->shared_memory, metadata->explicit_scaling, metadata->launch_pdl, *stream, *kernel {',' + ', '.join(f"ptr_info{i}.dev_ptr" if ty[0]=="*" else f"desc{i}" if ty == "nvTmaDesc" else f"_arg{i}" for i, ty in kernel_signature.items()) if len(kernel_signature) > 0 else ''});
 
       if(launch_exit_hook != Py_None){{
         PyObject* args = Py_BuildValue("(O)", launch_metadata);
@@ -410,8 +1142,90 @@ def make_launcher(constants, signature, ids):
       return Py_None;
     }}
 
+    static PyObject* launch(PyObject* self, PyObject* args) {{
+
+      int gridX, gridY, gridZ;
+      PyObject *launch_enter_hook = NULL;
+      PyObject *launch_exit_hook = NULL;
+      PyObject *kernel_metadata = NULL;
+      PyObject *launch_metadata = NULL;
+      PyObject *py_obj_stream;
+      PyObject* py_kernel;
+
+      {' '.join([f"{_extracted_type(ty, i)} _arg{i}; " for i, ty in signature.items()])}
+      if(!PyArg_ParseTuple(args, \"{format}\", &gridX, &gridY, &gridZ, &py_obj_stream, &py_kernel,
+                                           &kernel_metadata, &launch_metadata,
+                                           &launch_enter_hook, &launch_exit_hook {args_list})) {{
+        return NULL;
+      }}
+      return launchKernel(gridX, gridY, gridZ, py_obj_stream, py_kernel, kernel_metadata, launch_metadata,
+                          launch_enter_hook, launch_exit_hook{call_args_list});
+    }}
+
+    // Entry point for launches without hooks, taking the kernel and its
+    // metadata first so that they can be bound once:
+    // `launch_without_hooks(function, metadata, gridX, gridY, gridZ, stream, *args)`.
+    static PyObject* launch_without_hooks(PyObject* self, PyObject* args) {{
+      int gridX, gridY, gridZ;
+      PyObject *kernel_metadata;
+      PyObject *py_obj_stream;
+      PyObject *py_kernel;
+
+      {' '.join([f"{_extracted_type(ty, i)} _arg{i}; " for i, ty in signature.items()])}
+      if(!PyArg_ParseTuple(args, \"{format_without_hooks}\", &py_kernel, &kernel_metadata, &gridX, &gridY, &gridZ,
+                           &py_obj_stream {args_list})) {{
+        return NULL;
+      }}
+      return launchKernel(gridX, gridY, gridZ, py_obj_stream, py_kernel, kernel_metadata, Py_None, Py_None, Py_None{call_args_list});
+    }}
+
+    // Arguments of the kernel packed by `XPULauncher.pack_args`.
+    typedef struct _PackedArgs {{
+      {' '.join(f"{ty_to_cpp(ty)} arg{i};" for i, ty in packed_signature.items()) or "char unused;"}
+    }} PackedArgs;
+
+    // Low-overhead entry point taking arguments packed ahead of time. Launch
+    // hooks are not invoked and pointer arguments are not validated.
+    static PyObject* launch_packed(PyObject* self, PyObject* args) {{
+      int gridX, gridY, gridZ;
+      PyObject *py_obj_stream;
+      PyObject *py_kernel;
+      PyObject *kernel_metadata;
+      Py_buffer packed_args;
+      if (!PyArg_ParseTuple(args, "iiiOOOy*", &gridX, &gridY, &gridZ, &py_obj_stream, &py_kernel,
+                            &kernel_metadata, &packed_args)) {{
+        return NULL;
+      }}
+      if (packed_args.len != (Py_ssize_t)sizeof(PackedArgs)) {{
+        PyBuffer_Release(&packed_args);
+        PyErr_SetString(PyExc_ValueError, "packed arguments do not match the kernel signature");
+        return NULL;
+      }}
+      PackedArgs packed;
+      memcpy(&packed, packed_args.buf, sizeof(PackedArgs));
+      PyBuffer_Release(&packed_args);
+
+      sycl::queue *stream;
+      sycl::kernel *kernel;
+      if (!getKernelAndQueue(py_obj_stream, py_kernel, &stream, &kernel)) return NULL;
+      KernelMetadata *metadata = getKernelMetadata(py_kernel, kernel_metadata, num_kernel_params);
+      if (!metadata) return NULL;
+      if (!clampCooperativeGrid(metadata, &gridX, gridY, gridZ)) return NULL;
+      if (!checkDependentGrid(metadata, gridX, gridY, gridZ)) return NULL;
+
+      sycl_kernel_launch(gridX, gridY, gridZ, metadata->num_warps, metadata->threads_per_warp, metadata->shared_memory, metadata->explicit_scaling, metadata->launch_pdl, *stream, *kernel {',' + ', '.join(f"packed.arg{i}" if i in packed_signature else "0" for i in kernel_signature) if len(kernel_signature) > 0 else ''});
+      if (PyErr_Occurred()) {{
+        return NULL;
+      }}
+
+      Py_INCREF(Py_None);
+      return Py_None;
+    }}
+
     static PyMethodDef ModuleMethods[] = {{
       {{"launch", launch, METH_VARARGS, "Entry point for all kernels with this signature"}},
+      {{"launch_without_hooks", launch_without_hooks, METH_VARARGS, "Entry point for launches without hooks"}},
+      {{"launch_packed", launch_packed, METH_VARARGS, "Entry point taking pre-packed kernel arguments"}},
       {{NULL, NULL, 0, NULL}} // sentinel
     }};
 
@@ -429,26 +1243,1047 @@ def make_launcher(constants, signature, ids):
         return NULL;
       }}
       PyModule_AddFunctions(m, ModuleMethods);
+    #ifdef Py_GIL_DISABLED
+      // The launches can run concurrently in the free-threaded builds.
+      PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+    #endif
       return m;
     }}
     """
     return src
 
 
+def make_signature_descriptor(unset_args, signature):
+    """
+    Returns the descriptor of `signature` for the generic launcher: a type code
+    per launch argument ('-' for the arguments in `unset_args`, which are
+    accepted but not set), the offsets of the kernel parameters in the argument
+    buffer and the size of the buffer. The buffer has the layout of the
+    `make_packed_args_struct` struct, so packed arguments are launched as is.
+    """
+    codes, offsets, formats = "", [], ""
+    for i, ty in signature.items():
+        if i in unset_args:
+            codes += "-"
+            continue
+        fmt = ty_to_struct_format(ty)
+        # The alignment of a field is the size of its first member.
+        offsets.append(struct.calcsize("@" + formats + "0" + fmt[0]))
+        formats += fmt
+        codes += "T" if ty == "nvTmaDesc" else fmt
+    return codes, tuple(offsets), make_packed_args_struct(unset_args, signature).size
+
+
+def make_generic_launcher(trusted_pointers, direct_launch):
+    """
+    Returns the source of a launcher for the kernels of any signature. The
+    signature of a kernel is described once by `make_signature(codes, offsets,
+    size)` from `make_signature_descriptor`, and its arguments are converted
+    into an argument buffer at each launch.
+    """
+    return f"""
+    {_launcher_helpers_src(trusted_pointers, direct_launch)}
+    #include <memory>
+
+    // Signature of a kernel, built by `make_signature`.
+    typedef struct _LaunchSignature {{
+      // Type code of each launch argument, '-' for the arguments not set.
+      std::string codes;
+      // Type code, offset in the argument buffer and size of each kernel
+      // parameter.
+      std::string param_codes;
+      std::vector<size_t> offsets;
+      std::vector<size_t> sizes;
+      size_t buffer_size;
+    }} LaunchSignature;
+
+    static size_t sizeOfCode(char code) {{
+      switch (code) {{
+      case 'b': case 'B':
+        return 1;
+      case 'h': case 'H':
+        return 2;
+      case 'i': case 'I': case 'f':
+        return 4;
+      case 'q': case 'Q': case 'd': case 'P':
+        return 8;
+      case 'T':
+        return sizeof(XPUTensorDescriptor);
+      default:
+        return 0;
+      }}
+    }}
+
+    static void setArg(sycl::handler &cgh, int index, char code, const void *value) {{
+      switch (code) {{
+      case 'b': return set_scalar_arg<int8_t>(cgh, index, value);
+      case 'h': return set_scalar_arg<int16_t>(cgh, index, value);
+      case 'i': return set_scalar_arg<int32_t>(cgh, index, value);
+      case 'q': return set_scalar_arg<int64_t>(cgh, index, value);
+      case 'B': return set_scalar_arg<uint8_t>(cgh, index, value);
+      case 'H': return set_scalar_arg<uint16_t>(cgh, index, value);
+      case 'I': return set_scalar_arg<uint32_t>(cgh, index, value);
+      case 'Q': return set_scalar_arg<uint64_t>(cgh, index, value);
+      case 'f': return set_scalar_arg<float>(cgh, index, value);
+      case 'd': return set_scalar_arg<double>(cgh, index, value);
+      case 'P': return set_scalar_arg<void *>(cgh, index, value);
+      case 'T': return set_scalar_arg<XPUTensorDescriptor>(cgh, index, value);
+      }}
+    }}
+
+    template <class T>
+    static inline void storeArg(char *dst, T value) {{
+      memcpy(dst, &value, sizeof(T));
+    }}
+
+    // Converts the launch argument `obj` at position `idx` into `dst`.
+    static bool convertArg(char code, PyObject *obj, int idx, const sycl::queue &queue, char *dst) {{
+      switch (code) {{
+      case 'P': {{
+        DevicePtrInfo ptr_info = getPointer(obj, idx, queue);
+        if (!ptr_info.valid)
+          return false;
+        storeArg(dst, ptr_info.dev_ptr);
+        break;
+      }}
+      case 'T':
+        return getTensorDescriptor(obj, reinterpret_cast<XPUTensorDescriptor *>(dst));
+      case 'f': storeArg(dst, static_cast<float>(PyFloat_AsDouble(obj))); break;
+      case 'd': storeArg(dst, PyFloat_AsDouble(obj)); break;
+      case 'b': storeArg(dst, static_cast<int8_t>(PyLong_AsLongLong(obj))); break;
+      case 'h': storeArg(dst, static_cast<int16_t>(PyLong_AsLongLong(obj))); break;
+      case 'i': storeArg(dst, static_cast<int32_t>(PyLong_AsLongLong(obj))); break;
+      case 'q': storeArg(dst, static_cast<int64_t>(PyLong_AsLongLong(obj))); break;
+      case 'B': storeArg(dst, static_cast<uint8_t>(PyLong_AsUnsignedLongLongMask(obj))); break;
+      case 'H': storeArg(dst, static_cast<uint16_t>(PyLong_AsUnsignedLongLongMask(obj))); break;
+      case 'I': storeArg(dst, static_cast<uint32_t>(PyLong_AsUnsignedLongLongMask(obj))); break;
+      case 'Q': storeArg(dst, static_cast<uint64_t>(PyLong_AsUnsignedLongLongMask(obj))); break;
+      }}
+      return !PyErr_Occurred();
+    }}
+
+    static void releaseSignature(PyObject *capsule) {{
+      delete static_cast<LaunchSignature *>(PyCapsule_GetPointer(capsule, "launch_signature"));
+    }}
+
+    static LaunchSignature *getSignature(PyObject *capsule) {{
+      return static_cast<LaunchSignature *>(PyCapsule_GetPointer(capsule, "launch_signature"));
+    }}
+
+    static PyObject *make_signature(PyObject *self, PyObject *args) {{
+      const char *codes;
+      PyObject *py_offsets;
+      Py_ssize_t buffer_size;
+      if (!PyArg_ParseTuple(args, "sOn", &codes, &py_offsets, &buffer_size))
+        return NULL;
+      PyObject *offsets = PySequence_Fast(py_offsets, "offsets must be a sequence");
+      if (!offsets)
+        return NULL;
+      auto signature = std::make_unique<LaunchSignature>();
+      signature->codes = codes;
+      signature->buffer_size = buffer_size;
+      Py_ssize_t num_offsets = PySequence_Fast_GET_SIZE(offsets);
+      for (char code : signature->codes) {{
+        if (code == '-')
+          continue;
+        size_t size = sizeOfCode(code);
+        Py_ssize_t k = signature->offsets.size();
+        Py_ssize_t offset = k < num_offsets ? PyLong_AsSsize_t(PySequence_Fast_GET_ITEM(offsets, k)) : -1;
+        if (!size || offset < 0 || offset + (Py_ssize_t)size > buffer_size) {{
+          Py_DECREF(offsets);
+          if (!PyErr_Occurred())
+            PyErr_Format(PyExc_ValueError, "invalid launch signature '%s'", codes);
+          return NULL;
+        }}
+        signature->param_codes.push_back(code);
+        signature->offsets.push_back(offset);
+        signature->sizes.push_back(size);
+      }}
+      bool valid = (Py_ssize_t)signature->offsets.size() == num_offsets;
+      Py_DECREF(offsets);
+      if (!valid) {{
+        PyErr_Format(PyExc_ValueError, "invalid launch signature '%s'", codes);
+        return NULL;
+      }}
+      PyObject *capsule = PyCapsule_New(signature.get(), "launch_signature", releaseSignature);
+      if (capsule)
+        signature.release();
+      return capsule;
+    }}
+
+    static void sycl_kernel_launch(const LaunchSignature &signature, char *buffer, int gridX, int gridY, int gridZ,
+                                   const KernelMetadata &metadata, sycl::queue &stream, sycl::kernel &kernel) {{
+      uint32_t num_params = signature.offsets.size();
+      std::vector<void *> params(num_params);
+      for (uint32_t i = 0; i < num_params; ++i)
+        params[i] = buffer + signature.offsets[i];
+      sycl_kernel_launch_impl(gridX, gridY, gridZ, metadata.num_warps, metadata.threads_per_warp,
+                              metadata.shared_memory, metadata.explicit_scaling, metadata.launch_pdl, stream, kernel,
+                              params.data(),
+                              signature.sizes.data(), num_params, [&](sycl::handler &cgh) {{
+        for (uint32_t i = 0; i < num_params; ++i)
+          setArg(cgh, i, signature.param_codes[i], params[i]);
+      }});
+    }}
+
+    // Launches the kernel with the launch arguments `args[first_arg:]`.
+    static PyObject *launchKernel(const LaunchSignature &signature, int gridX, int gridY, int gridZ,
+                                  PyObject *py_obj_stream, PyObject *py_kernel, PyObject *kernel_metadata,
+                                  PyObject *launch_metadata, PyObject *launch_enter_hook,
+                                  PyObject *launch_exit_hook, PyObject *args, Py_ssize_t first_arg) {{
+      Py_ssize_t num_args = PyTuple_GET_SIZE(args) - first_arg;
+      if (num_args != (Py_ssize_t)signature.codes.size()) {{
+        PyErr_Format(PyExc_TypeError, "kernel takes %zd arguments (%zd given)", (Py_ssize_t)signature.codes.size(),
+                     num_args);
+        return NULL;
+      }}
+      sycl::queue *stream;
+      sycl::kernel *kernel;
+      if (!getKernelAndQueue(py_obj_stream, py_kernel, &stream, &kernel)) return NULL;
+      KernelMetadata *metadata = getKernelMetadata(py_kernel, kernel_metadata, signature.offsets.size());
+      if (!metadata) return NULL;
+      if (!clampCooperativeGrid(metadata, &gridX, gridY, gridZ)) return NULL;
+      if (!checkDependentGrid(metadata, gridX, gridY, gridZ)) return NULL;
+
+      if (launch_enter_hook != Py_None) {{
+        PyObject* hook_args = Py_BuildValue("(O)", launch_metadata);
+        PyObject* ret = PyObject_CallObject(launch_enter_hook, hook_args);
+        Py_DECREF(hook_args);
+        if (!ret)
+          return NULL;
+      }}
+
+      std::vector<uint64_t> buffer((signature.buffer_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+      char *data = reinterpret_cast<char *>(buffer.data());
+      for (Py_ssize_t i = 0, k = 0; i < num_args; ++i) {{
+        char code = signature.codes[i];
+        if (code == '-')
+          continue;
+        if (!convertArg(code, PyTuple_GET_ITEM(args, first_arg + i), i, *stream, data + signature.offsets[k++]))
+          return NULL;
+      }}
+      sycl_kernel_launch(signature, data, gridX, gridY, gridZ, *metadata, *stream, *kernel);
+
+      if (launch_exit_hook != Py_None) {{
+        PyObject* hook_args = Py_BuildValue("(O)", launch_metadata);
+        PyObject* ret = PyObject_CallObject(launch_exit_hook, hook_args);
+        Py_DECREF(hook_args);
+        if (!ret)
+          return NULL;
+      }}
+      if (PyErr_Occurred()) {{
+        return NULL;
+      }}
+
+      Py_INCREF(Py_None);
+      return Py_None;
+    }}
+
+    static bool getGrid(PyObject *args, Py_ssize_t first, int *gridX, int *gridY, int *gridZ) {{
+      *gridX = PyLong_AsLong(PyTuple_GET_ITEM(args, first));
+      *gridY = PyLong_AsLong(PyTuple_GET_ITEM(args, first + 1));
+      *gridZ = PyLong_AsLong(PyTuple_GET_ITEM(args, first + 2));
+      return !PyErr_Occurred();
+    }}
+
+    // `launch(signature, gridX, gridY, gridZ, stream, function, metadata,
+    // launch_metadata, launch_enter_hook, launch_exit_hook, *args)`.
+    static PyObject* launch(PyObject* self, PyObject* args) {{
+      if (PyTuple_GET_SIZE(args) < 10) {{
+        PyErr_SetString(PyExc_TypeError, "launch takes at least 10 arguments");
+        return NULL;
+      }}
+      LaunchSignature *signature = getSignature(PyTuple_GET_ITEM(args, 0));
+      int gridX, gridY, gridZ;
+      if (!signature || !getGrid(args, 1, &gridX, &gridY, &gridZ))
+        return NULL;
+      return launchKernel(*signature, gridX, gridY, gridZ, PyTuple_GET_ITEM(args, 4), PyTuple_GET_ITEM(args, 5),
+                          PyTuple_GET_ITEM(args, 6), PyTuple_GET_ITEM(args, 7), PyTuple_GET_ITEM(args, 8),
+                          PyTuple_GET_ITEM(args, 9), args, 10);
+    }}
+
+    // `launch_without_hooks(signature, function, metadata, gridX, gridY, gridZ, stream, *args)`.
+    static PyObject* launch_without_hooks(PyObject* self, PyObject* args) {{
+      if (PyTuple_GET_SIZE(args) < 7) {{
+        PyErr_SetString(PyExc_TypeError, "launch_without_hooks takes at least 7 arguments");
+        return NULL;
+      }}
+      LaunchSignature *signature = getSignature(PyTuple_GET_ITEM(args, 0));
+      int gridX, gridY, gridZ;
+      if (!signature || !getGrid(args, 3, &gridX, &gridY, &gridZ))
+        return NULL;
+      return launchKernel(*signature, gridX, gridY, gridZ, PyTuple_GET_ITEM(args, 6), PyTuple_GET_ITEM(args, 1),
+                          PyTuple_GET_ITEM(args, 2), Py_None, Py_None, Py_None, args, 7);
+    }}
+
+    // `launch_packed(signature, gridX, gridY, gridZ, stream, function, metadata, packed)`, with the arguments
+    // packed by `XPULauncher.pack_args`. Launch hooks are not invoked and pointer arguments are not validated.
+    static PyObject* launch_packed(PyObject* self, PyObject* args) {{
+      PyObject *py_signature;
+      int gridX, gridY, gridZ;
+      PyObject *py_obj_stream;
+      PyObject *py_kernel;
+      PyObject *kernel_metadata;
+      Py_buffer packed_args;
+      if (!PyArg_ParseTuple(args, "OiiiOOOy*", &py_signature, &gridX, &gridY, &gridZ, &py_obj_stream, &py_kernel,
+                            &kernel_metadata, &packed_args)) {{
+        return NULL;
+      }}
+      LaunchSignature *signature = getSignature(py_signature);
+      if (!signature || packed_args.len != (Py_ssize_t)signature->buffer_size) {{
+        PyBuffer_Release(&packed_args);
+        if (signature)
+          PyErr_SetString(PyExc_ValueError, "packed arguments do not match the kernel signature");
+        return NULL;
+      }}
+      std::vector<uint64_t> buffer((signature->buffer_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+      memcpy(buffer.data(), packed_args.buf, signature->buffer_size);
+      PyBuffer_Release(&packed_args);
+
+      sycl::queue *stream;
+      sycl::kernel *kernel;
+      if (!getKernelAndQueue(py_obj_stream, py_kernel, &stream, &kernel)) return NULL;
+      KernelMetadata *metadata = getKernelMetadata(py_kernel, kernel_metadata, signature->offsets.size());
+      if (!metadata) return NULL;
+      if (!clampCooperativeGrid(metadata, &gridX, gridY, gridZ)) return NULL;
+      if (!checkDependentGrid(metadata, gridX, gridY, gridZ)) return NULL;
+
+      sycl_kernel_launch(*signature, reinterpret_cast<char *>(buffer.data()), gridX, gridY, gridZ, *metadata, *stream,
+                         *kernel);
+      if (PyErr_Occurred()) {{
+        return NULL;
+      }}
+
+      Py_INCREF(Py_None);
+      return Py_None;
+    }}
+
+    static PyMethodDef ModuleMethods[] = {{
+      {{"make_signature", make_signature, METH_VARARGS, "Describes the signature of a kernel"}},
+      {{"launch", launch, METH_VARARGS, "Entry point for all kernels"}},
+      {{"launch_without_hooks", launch_without_hooks, METH_VARARGS, "Entry point for launches without hooks"}},
+      {{"launch_packed", launch_packed, METH_VARARGS, "Entry point taking pre-packed kernel arguments"}},
+      {{NULL, NULL, 0, NULL}} // sentinel
+    }};
+
+    static struct PyModuleDef ModuleDef = {{
+      PyModuleDef_HEAD_INIT,
+      \"__triton_generic_launcher\",
+      NULL, //documentation
+      -1, //size
+      ModuleMethods
+    }};
+
+    PyMODINIT_FUNC PyInit___triton_generic_launcher(void) {{
+      PyObject *m = PyModule_Create(&ModuleDef);
+      if(m == NULL) {{
+        return NULL;
+      }}
+      PyModule_AddFunctions(m, ModuleMethods);
+    #ifdef Py_GIL_DISABLED
+      // The launches can run concurrently in the free-threaded builds.
+      PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+    #endif
+      return m;
+    }}
+    """
+
+
+@lru_cache
+def _generic_launcher(trusted_pointers, direct_launch):
+    return compile_module_from_src(make_generic_launcher(trusted_pointers, direct_launch), "__triton_generic_launcher")
+
+
+def generic_launcher():
+    """
+    Returns the generic launcher module for the current environment. It does
+    not depend on the kernel signatures, so it is built once and then loaded
+    from the cache.
+    """
+    return _generic_launcher(
+        os.getenv("TRITON_INTEL_TRUSTED_POINTERS", "0") == "1",
+        os.getenv("TRITON_INTEL_DIRECT_LAUNCH", "0") == "1",
+    )
+
+
+# Types of the scalar arguments in a `utils/SPIRVRunner` launch manifest.
+_MANIFEST_SCALAR_TYPES = {
+    "int8_t": "i8",
+    "int16_t": "i16",
+    "int32_t": "i32",
+    "int64_t": "i64",
+    "uint8_t": "u8",
+    "uint16_t": "u16",
+    "uint32_t": "u32",
+    "uint64_t": "u64",
+    "float": "f32",
+    "double": "f64",
+}
+
+
+class LaunchCapture(object):
+    """
+    Snapshots kernel launches for offline replay with `utils/SPIRVRunner`.
+
+    Enabled by `TRITON_INTEL_CAPTURE_DIR`. Each captured launch is written to
+    `<dir>/<kernel>-<launch>/` as a launch manifest referencing the SPIR-V in
+    the Triton cache, and the pointer arguments saved with `torch.save`. The
+    first launch for each grid and tensor shapes is captured, or every n-th
+    launch with `TRITON_INTEL_CAPTURE_EVERY=<n>`.
+
+    The arguments are copied to pinned host memory with asynchronous copies
+    enqueued before the kernel, and written by a background thread once the
+    copies complete, so that capturing does not stall the queue.
+    """
+
+    _writer = None
+
+    def __init__(self, src, metadata, constants, signature, out_dir):
+        self.out_dir = out_dir
+        self.every = int(os.getenv("TRITON_INTEL_CAPTURE_EVERY", "0"))
+        self.metadata = metadata
+        arg_names = src.fn.arg_names if hasattr(src, "fn") else None
+        # Position in the arguments of `launch`, name and type of the kernel
+        # parameters.
+        self.params = [(pos, arg_names[i] if arg_names else f"arg{i}", ty)
+                       for pos, (i, ty) in enumerate(signature.items())
+                       if i not in constants]
+        self.supported = all(ty != "nvTmaDesc" for _, _, ty in self.params)
+        self.num_launches = 0
+        self.shapes = set()
+
+    def _should_capture(self, grid, args):
+        self.num_launches += 1
+        if self.every > 0:
+            return (self.num_launches - 1) % self.every == 0
+        key = (grid, ) + tuple((tuple(arg.shape), arg.dtype) for arg in args if hasattr(arg, "shape"))
+        if key in self.shapes:
+            return False
+        self.shapes.add(key)
+        return True
+
+    def __call__(self, grid, args):
+        if not self.supported or not self._should_capture(grid, [args[pos] for pos, _, _ in self.params]):
+            return
+        import torch
+        from concurrent.futures import ThreadPoolExecutor
+
+        md = self.metadata
+        spirv = get_cache_manager(md.hash).get_file(f"{md.name}.spv")
+        path = os.path.join(self.out_dir, f"{md.name}-{self.num_launches - 1}")
+        # The replay tools read plain SPIR-V.
+        spirv_copy = None
+        if spirv is not None:
+            with open(spirv, "rb") as f:
+                if f.read(len(ZSTD_MAGIC)) == ZSTD_MAGIC:
+                    spirv_copy = read_cache_entry(spirv)
+                    spirv = os.path.join(path, f"{md.name}.spv")
+        lines = [
+            f"# hash {md.hash}",
+            f"kernel {md.name}",
+            f"spirv {spirv}",
+            f"build_flags {getattr(md, 'build_flags', '')}",
+            f"grid {grid[0]} {grid[1]} {grid[2]}",
+            f"num_warps {md.num_warps}",
+            f"threads_per_warp {md.threads_per_warp}",
+            f"shared_memory {md.shared}",
+        ]
+        tensors = {}
+        for pos, name, ty in self.params:
+            arg = args[pos]
+            if ty[0] != "*":
+                value = float(arg) if ty_to_cpp(ty) in ("float", "double") else int(arg)
+                lines.append(f"arg {name} {_MANIFEST_SCALAR_TYPES[ty_to_cpp(ty)]} {value!r}")
+            elif not isinstance(arg, torch.Tensor):
+                # The memory behind raw pointers cannot be captured.
+                ptr = 0 if arg is None else arg.data_ptr() if hasattr(arg, "data_ptr") else int(arg)
+                lines.append(f"arg {name} u64 {ptr}")
+            else:
+                # Capture the memory accessed through the data pointer, which
+                # is the span of the strides of a non-contiguous tensor.
+                if not arg.is_contiguous():
+                    span = 1 + sum((size - 1) * stride for size, stride in zip(arg.shape, arg.stride()))
+                    arg = arg.as_strided((span if arg.numel() else 0, ), (1, ))
+                host = torch.empty(arg.shape, dtype=arg.dtype, pin_memory=True)
+                host.copy_(arg, non_blocking=True)
+                tensors[f"{name}.pt"] = host
+                lines.append(f"arg {name} tensor {name}.pt")
+        event = torch.xpu.Event()
+        event.record()
+
+        def write():
+            event.synchronize()
+            os.makedirs(path, exist_ok=True)
+            if spirv_copy is not None:
+                Path(spirv).write_bytes(spirv_copy)
+            for filename, tensor in tensors.items():
+                torch.save(tensor, os.path.join(path, filename))
+            with open(os.path.join(path, f"{md.name}.manifest"), "w") as f:
+                f.write("\n".join(lines) + "\n")
+
+        if LaunchCapture._writer is None:
+            LaunchCapture._writer = ThreadPoolExecutor(max_workers=1, thread_name_prefix="triton-capture")
+        LaunchCapture._writer.submit(write)
+
+
+class PrintBuffer(object):
+    """
+    Prints the records appended by `tl.device_print` to the print buffer of a
+    kernel compiled with `TRITON_INTEL_PRINT_BUFFER_SIZE=<bytes>`, in the
+    format of device printf.
+
+    After each launch, the buffer is copied to pinned host memory and reset by
+    commands enqueued on the queue of the launch, and the records are decoded
+    by a background thread once the copy completes, so that printing does not
+    stall the queue. The records not fitting in the buffer are dropped, and
+    reported.
+    """
+
+    _printer = None
+
+    def __init__(self, metadata):
+        self.formats = metadata.print_formats
+        self.size = metadata.print_buffer_size
+
+    def __call__(self, stream, function):
+        import torch
+        from concurrent.futures import ThreadPoolExecutor
+        from triton.runtime import driver
+
+        host = torch.empty(self.size, dtype=torch.uint8, pin_memory=True)
+        driver.active.utils.copy_print_buffer(function, stream, host.data_ptr(), self.size)
+        event = torch.xpu.Event()
+        event.record()
+
+        def decode():
+            event.synchronize()
+            lines = self.decode(ctypes.string_at(host.data_ptr(), self.size))
+            if lines:
+                print("\n".join(lines), flush=True)
+
+        if PrintBuffer._printer is None:
+            PrintBuffer._printer = ThreadPoolExecutor(max_workers=1, thread_name_prefix="triton-print")
+        PrintBuffer._printer.submit(decode)
+
+    def decode(self, data):
+        """
+        Returns the lines printed by the records of the print buffer `data`.
+        The first word of the buffer is the number of words reserved by the
+        records following it.
+        """
+        words = memoryview(data).cast("I")
+        reserved = words[0]
+        end = min(reserved + 1, len(words))
+        lines = []
+        pos = 1
+        while pos < end:
+            print_id, operand = words[pos], words[pos + 1]
+            fmt = self.formats[print_id]
+            operands = fmt["operands"]
+            num_words = operands[operand]["num_words"] if operands else fmt["num_words"]
+            if pos + num_words > end:
+                break
+            pid = f"pid ({words[pos + 2]}, {words[pos + 3]}, {words[pos + 4]})"
+            if not operands:
+                lines.append(f"{pid}{fmt['prefix']}")
+            else:
+                lines.extend(self._decode_operand(fmt, operand, words[pos + 5:pos + num_words], pid))
+            pos += num_words
+        if reserved + 1 > pos:
+            lines.append(f"(print buffer full, {reserved + 1 - pos} words of records dropped, "
+                         "increase TRITON_INTEL_PRINT_BUFFER_SIZE)")
+        return lines
+
+    @staticmethod
+    def _decode_operand(fmt, operand, words, pid):
+        desc = fmt["operands"][operand]
+        kind, bits, shape = desc["kind"], desc["bits"], desc["shape"]
+        dim_widths = [math.ceil(math.log10(dim)) if dim > 0 else 0 for dim in shape]
+        value_words = 2 if kind == "p" or bits > 32 else 1
+        operand_str = f"(operand {operand}) " if len(fmt["operands"]) > 1 else ""
+        lines = []
+        for pos in range(0, len(words), len(shape) + value_words):
+            idx = ", ".join(f"{i:{w}}" for i, w in zip(words[pos:pos + len(shape)], dim_widths))
+            raw = words[pos + len(shape)]
+            if value_words == 2:
+                raw |= words[pos + len(shape) + 1] << 32
+            if kind == "p":
+                value = f"0x{raw:x}"
+            elif fmt["hex"]:
+                value = f"0x{raw:0{bits // 4}x}"
+            elif kind == "f":
+                float_format = "d" if value_words == 2 else "f"
+                value = f"{struct.unpack(float_format, raw.to_bytes(4 * value_words, 'little'))[0]:f}"
+            elif kind == "i" and raw >> (32 * value_words - 1):
+                value = str(raw - (1 << (32 * value_words)))
+            else:
+                value = str(raw)
+            lines.append(f"{pid} idx ({idx}){fmt['prefix']}{operand_str}{value}")
+        return lines
+
+
 class XPULauncher(object):
 
     def __init__(self, src, metadata):
         ids = {"ids_of_const_exprs": src.fn.constexprs if hasattr(src, "fn") else tuple()}
+        kernel_src = src
         constants = src.constants if hasattr(src, "constants") else dict()
         cst_key = lambda i: src.fn.arg_names.index(i) if isinstance(i, str) else i
         constants = {cst_key(key): value for key, value in constants.items()}
         signature = {cst_key(key): value for key, value in src.signature.items()}
-        src = make_launcher(constants, signature, ids)
-        mod = compile_module_from_src(src, "__triton_launcher")
-        self.launch = mod.launch
+        # The parameters removed from the kernel are not set, like constants.
+        kernel_args = [i for i in signature if i not in constants]
+        dead_args = {kernel_args[pos] for pos in getattr(metadata, "dead_args", ())}
+        unset_args = {**constants, **dict.fromkeys(dead_args)}
+        # The global scratch of a launch is allocated by the launcher and
+        # passed as a hidden pointer argument after the kernel arguments.
+        self._global_scratch_size = getattr(metadata, "global_scratch_size", 0)
+        launch_signature = dict(signature)
+        if self._global_scratch_size:
+            launch_signature[len(signature)] = "*i8"
+        if os.getenv("TRITON_INTEL_SPECIALIZED_LAUNCHER", "0") == "1":
+            # A launcher generated for the signature, built once per signature.
+            src = make_launcher(constants, launch_signature, ids, dead_args)
+            mod = compile_module_from_src(src, "__triton_launcher")
+            launch, launch_without_hooks, launch_packed = mod.launch, mod.launch_without_hooks, mod.launch_packed
+        else:
+            # The generic launcher, built once for all the signatures.
+            mod = generic_launcher()
+            launch_desc = mod.make_signature(*make_signature_descriptor(unset_args, launch_signature))
+            launch = partial(mod.launch, launch_desc)
+            launch_without_hooks = partial(mod.launch_without_hooks, launch_desc)
+            launch_packed = partial(mod.launch_packed, launch_desc)
+        self.launch = launch
+        self.launch_packed = launch_packed
+        self._packed_args = make_packed_args_struct(unset_args, signature)
+        # Positions of the arguments of `launch`, which follow the signature.
+        self._packed_ptr_args = [
+            pos for pos, (i, ty) in enumerate(signature.items()) if ty[0] == '*' and i not in dead_args
+        ]
+        self._packed_desc_args = [
+            pos for pos, (i, ty) in enumerate(signature.items()) if ty == "nvTmaDesc" and i not in dead_args
+        ]
+        self._packed_arg_ids = [pos for pos, i in enumerate(signature) if i not in unset_args]
+        capture_dir = os.getenv("TRITON_INTEL_CAPTURE_DIR", "").strip()
+        self._capture = LaunchCapture(kernel_src, metadata, unset_args, signature, capture_dir) if capture_dir else None
+        self._print_buffer = PrintBuffer(metadata) if getattr(metadata, "print_formats", None) else None
+        # Captured launches, launches printing through a print buffer and
+        # launches with global scratch go through `__call__`.
+        use_call = self._capture is not None or self._print_buffer is not None or self._global_scratch_size
+        self.launch_without_hooks = None if use_call else launch_without_hooks
 
     def __call__(self, *args, **kwargs):
-        self.launch(*args, **kwargs)
+        if self._capture is not None:
+            # The arguments follow the grid, stream, function, metadata and
+            # launch hooks.
+            self._capture(args[:3], args[9:])
+        if self._global_scratch_size:
+            self._launch_with_scratch(args, kwargs)
+        else:
+            self.launch(*args, **kwargs)
+        if self._print_buffer is not None:
+            self._print_buffer(args[3], args[4])
+
+    def _launch_with_scratch(self, args, kwargs):
+        from triton.runtime import driver
+        utils = driver.active.utils
+        stream = args[3]
+        scratch = utils.scratch_alloc(self._global_scratch_size, stream)
+        try:
+            self.launch(*args, scratch, **kwargs)
+        finally:
+            # The scratch is reused by the later launches on the stream.
+            utils.scratch_free(scratch, stream)
+
+    def pack_args(self, *args):
+        """
+        Packs the kernel arguments (as passed to `launch`) for `launch_packed`.
+
+        The packed arguments can be launched repeatedly with
+        `launch_packed(gridX, gridY, gridZ, stream, function, metadata, packed)`,
+        which skips argument parsing and pointer validation.
+        """
+        if self._global_scratch_size:
+            raise RuntimeError("kernels with global scratch cannot be launched with packed arguments")
+        values = list(args)
+        for i in self._packed_ptr_args:
+            arg = values[i]
+            if arg is None:
+                values[i] = 0
+            elif not isinstance(arg, int):
+                values[i] = arg.data_ptr()
+        # Tensor descriptors are packed by value.
+        for i in self._packed_desc_args:
+            values[i] = _tensor_desc_struct.unpack(
+                ctypes.string_at(values[i].tma_desc_cpu_ptr(), _tensor_desc_struct.size))
+        fields = []
+        for i in self._packed_arg_ids:
+            fields.extend(values[i] if i in self._packed_desc_args else (values[i], ))
+        return self._packed_args.pack(*fields)
+
+
+class XPUGraph(object):
+    """
+    Records the kernels launched on the current SYCL queue into a SYCL command
+    graph and replays them with a single submission, like a CUDA graph.
+
+        graph = triton.runtime.driver.active.create_graph()
+        with graph.capture():
+            kernel[grid](x, y)
+        graph.replay()
+
+    Capturing the same sequence of launches again, e.g. with different scalar
+    or pointer arguments, updates the executable graph in place instead of
+    finalizing a new one.
+    """
+
+    def __init__(self, utils):
+        self._utils = utils
+        self._exec_graph = None
+
+    @contextlib.contextmanager
+    def capture(self):
+        queue = self._utils.get_sycl_queue()
+        graph = self._utils.graph_begin_capture(queue)
+        try:
+            yield self
+        finally:
+            self._utils.graph_end_capture(graph, queue)
+
+        if self._exec_graph is not None:
+            try:
+                self._utils.graph_update(self._exec_graph, graph)
+                return
+            except RuntimeError:
+                # The launch sequence changed, the graph has to be finalized again.
+                pass
+        self._exec_graph = self._utils.graph_finalize(graph)
+
+    def replay(self):
+        if self._exec_graph is None:
+            raise RuntimeError("XPUGraph.replay() called before capture()")
+        self._utils.graph_replay(self._exec_graph, self._utils.get_sycl_queue())
+
+
+class XPUTaskEvent(object):
+    """
+    Completes once the launch of `XPUTaskQueue.launch` returning it, or the
+    commands of `XPUTaskQueue.current_stream_event`, complete.
+    """
+
+    def __init__(self, utils, event):
+        self._utils = utils
+        self._event = event
+
+    def query(self):
+        return self._utils.event_query(self._event)
+
+    def synchronize(self):
+        self._utils.event_wait(self._event)
+
+
+class XPUTaskQueue(object):
+    """
+    Launches kernels out of order, ordered only by the events each launch
+    depends on, so that independent kernels, e.g. small kernels of separate
+    attention heads, run at the same time. A scheduler expresses a DAG of
+    launches with the events returned by `launch`:
+
+        tasks = triton.runtime.driver.active.create_task_queue()
+        ready = tasks.current_stream_event()
+        a = tasks.launch(kernel_a[grid], x, deps=[ready])
+        b = tasks.launch(kernel_b[grid], y, deps=[ready])
+        tasks.launch(kernel_c[grid], x, y, deps=[a, b])
+        tasks.join()
+
+    The launches are spread over `num_queues` in-order queues of the context
+    and device of the current stream, which the Level Zero driver runs
+    concurrently, and the dependencies are barriers waiting for their events.
+    The tensors used by the launches must be kept alive until `join`.
+    """
+
+    def __init__(self, utils, num_queues=4):
+        if num_queues < 1:
+            raise ValueError("num_queues must be positive")
+        self._utils = utils
+        stream = utils.get_sycl_queue()
+        self._queues = [utils.create_queue(stream) for _ in range(num_queues)]
+        self._next = 0
+        # Events of the last launch of each queue.
+        self._last_events = {}
+
+    def __del__(self):
+        queues = getattr(self, "_queues", ())
+        for queue in queues:
+            self._utils.destroy_queue(queue)
+
+    def launch(self, fn, *args, deps=(), **kwargs):
+        """
+        Calls `fn(*args, **kwargs)`, e.g. `kernel[grid]`, with its launches
+        submitted after the events `deps`, and returns the event of their
+        completion.
+        """
+        queue = self._queues[self._next]
+        self._next = (self._next + 1) % len(self._queues)
+        # The queue is in order: the previous launches of the queue need no
+        # barrier.
+        events = [dep._event for dep in deps if dep is not self._last_events.get(queue)]
+        if events:
+            self._utils.submit_barrier(queue, events)
+        previous = getattr(_queue_override, "queue", None)
+        _queue_override.queue = queue
+        try:
+            fn(*args, **kwargs)
+        finally:
+            _queue_override.queue = previous
+        event = XPUTaskEvent(self._utils, self._utils.submit_barrier(queue, []))
+        self._last_events[queue] = event
+        return event
+
+    def current_stream_event(self):
+        """
+        Returns the event of the completion of the commands submitted to the
+        current stream so far, e.g. of the tensors read by the launches.
+        """
+        return XPUTaskEvent(self._utils, self._utils.submit_barrier(self._utils.get_sycl_queue(), []))
+
+    def join(self):
+        """
+        Orders the commands submitted to the current stream after all the
+        launches.
+        """
+        events = [event._event for event in self._last_events.values()]
+        if events:
+            self._utils.submit_barrier(self._utils.get_sycl_queue(), events)
+        self._last_events.clear()
+
+
+def make_dispatcher(buckets, name):
+    """
+    Returns the source of a module selecting the first bucket whose predicates
+    hold for the integer arguments of a launch, see `XPUDispatcher`. Each
+    bucket is a `(predicates, grid)` pair of resolved argument positions.
+    """
+    positions = sorted({pos for predicates, grid in buckets for pos in predicates} |
+                       {dim[0] for predicates, grid in buckets for dim in grid if isinstance(dim, tuple)})
+
+    def cond_of(pos, pred):
+        if isinstance(pred, int):
+            return f"arg{pos} % {pred} == 0"
+        lo, hi = pred
+        return " && ".join([f"arg{pos} >= {lo}"] * (lo is not None) + [f"arg{pos} < {hi}"] * (hi is not None)) or "1"
+
+    def grid_of(dim):
+        if isinstance(dim, int):
+            return str(dim)
+        pos, block = dim
+        return f"(arg{pos} + {block - 1}) / {block}"
+
+    nl = "\n"
+    select = []
+    for idx, (predicates, grid) in enumerate(buckets):
+        conds = " && ".join(f"({cond_of(pos, pred)})" for pos, pred in predicates.items()) or "1"
+        grid_values = ", ".join(grid_of(dim) for dim in grid)
+        select.append(f"if ({conds}) {{{nl}        int64_t g[] = {{{grid_values}}};{nl}"
+                      f"        memcpy(grid, g, sizeof(g));{nl}        return {idx};{nl}      }}")
+
+    src = f"""
+    #include <cstdint>
+    #include <cstring>
+    #include <mutex>
+
+    #include <Python.h>
+
+    // Launchers of the buckets, taking `(gridX, gridY, gridZ, stream, *args)`.
+    // Guarded by `launchers_mutex` for the free-threaded builds of Python.
+    static PyObject *launchers[{len(buckets)}];
+    static std::mutex launchers_mutex;
+
+    // Returns the first bucket matching `args`, and its grid, or -1 if none
+    // does.
+    static int selectBucket(PyObject *const *args, Py_ssize_t nargs, int64_t grid[3]) {{
+      {"".join(f"if ({pos} >= nargs || !PyLong_Check(args[{pos}])){nl}        return -1;{nl}      int64_t arg{pos} = PyLong_AsLongLong(args[{pos}]);{nl}      " for pos in positions)}
+      if (PyErr_Occurred()) {{
+        PyErr_Clear();
+        return -1;
+      }}
+      {"".join(cond + nl + "      " for cond in select)}return -1;
+    }}
+
+    static PyObject *noBucket() {{
+      PyErr_SetString(PyExc_ValueError, "no kernel of the dispatcher matches the arguments");
+      return NULL;
+    }}
+
+    // `select(*args)` returns the index of the bucket launched for `args`.
+    static PyObject *selectLaunch(PyObject *self, PyObject *const *args, Py_ssize_t nargs) {{
+      int64_t grid[3];
+      int idx = selectBucket(args, nargs, grid);
+      if (idx < 0)
+        return noBucket();
+      return Py_BuildValue("(i(LLL))", idx, (long long)grid[0], (long long)grid[1], (long long)grid[2]);
+    }}
+
+    // `dispatch(stream, *args)` launches the first bucket matching `args`.
+    static PyObject *dispatch(PyObject *self, PyObject *const *args, Py_ssize_t nargs) {{
+      if (nargs < 1) {{
+        PyErr_SetString(PyExc_TypeError, "dispatch() takes the stream first");
+        return NULL;
+      }}
+      int64_t grid[3];
+      int idx = selectBucket(args + 1, nargs - 1, grid);
+      if (idx < 0)
+        return noBucket();
+      PyObject *launcher;
+      {{
+        std::lock_guard<std::mutex> lock(launchers_mutex);
+        launcher = launchers[idx];
+        Py_XINCREF(launcher);
+      }}
+      if (launcher == NULL) {{
+        PyErr_SetString(PyExc_RuntimeError, "the launchers of the dispatcher are not set");
+        return NULL;
+      }}
+      // The launcher takes the grid before the arguments of `dispatch`.
+      Py_ssize_t n = nargs + 3;
+      PyObject *small[32];
+      PyObject **call_args = n <= 32 ? small : (PyObject **)PyMem_Malloc(n * sizeof(PyObject *));
+      if (call_args == NULL) {{
+        Py_DECREF(launcher);
+        return PyErr_NoMemory();
+      }}
+      PyObject *result = NULL;
+      int dims = 0;
+      for (; dims < 3; ++dims)
+        if (!(call_args[dims] = PyLong_FromLongLong(grid[dims])))
+          goto done;
+      memcpy(call_args + 3, args, nargs * sizeof(PyObject *));
+      result = PyObject_Vectorcall(launcher, call_args, n, NULL);
+    done:
+      Py_DECREF(launcher);
+      for (int i = 0; i < dims; ++i)
+        Py_DECREF(call_args[i]);
+      if (call_args != small)
+        PyMem_Free(call_args);
+      return result;
+    }}
+
+    // `set_launchers(launchers)` sets the launchers of the buckets.
+    static PyObject *setLaunchers(PyObject *self, PyObject *args) {{
+      PyObject *list;
+      if (!PyArg_ParseTuple(args, "O!", &PyList_Type, &list))
+        return NULL;
+      if (PyList_Size(list) != {len(buckets)}) {{
+        PyErr_SetString(PyExc_ValueError, "expected one launcher per bucket");
+        return NULL;
+      }}
+      for (Py_ssize_t i = 0; i < {len(buckets)}; ++i) {{
+        PyObject *launcher = PyList_GetItem(list, i);
+        Py_INCREF(launcher);
+        PyObject *previous;
+        {{
+          std::lock_guard<std::mutex> lock(launchers_mutex);
+          previous = launchers[i];
+          launchers[i] = launcher;
+        }}
+        Py_XDECREF(previous);
+      }}
+      Py_RETURN_NONE;
+    }}
+
+    static PyMethodDef ModuleMethods[] = {{
+      {{"select", (PyCFunction)(void (*)(void))selectLaunch, METH_FASTCALL, "Returns the bucket and grid of a launch"}},
+      {{"dispatch", (PyCFunction)(void (*)(void))dispatch, METH_FASTCALL, "Launches the bucket matching the arguments"}},
+      {{"set_launchers", setLaunchers, METH_VARARGS, "Sets the launchers of the buckets"}},
+      {{NULL, NULL, 0, NULL}} // sentinel
+    }};
+
+    static struct PyModuleDef ModuleDef = {{
+      PyModuleDef_HEAD_INIT,
+      \"{name}\",
+      NULL, //documentation
+      -1, //size
+      ModuleMethods
+    }};
+
+    PyMODINIT_FUNC PyInit_{name}(void) {{
+      PyObject *m = PyModule_Create(&ModuleDef);
+    #ifdef Py_GIL_DISABLED
+      if (m != NULL)
+        PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+    #endif
+      return m;
+    }}
+    """
+    return src
+
+
+class XPUDispatcher(object):
+    """
+    Launches the first of several precompiled variants of a kernel whose
+    predicates hold for the runtime arguments, selecting it and computing
+    its grid in C without going through `JITFunction.run`:
+
+        dispatcher = triton.runtime.driver.active.create_dispatcher([
+            (kernel.warmup(x, y, n, BLOCK=1024, grid=(1, )), {"n": (4096, None)}, [("n", 1024)]),
+            (kernel.warmup(x, y, n, BLOCK=128, grid=(1, )), {}, [("n", 128)]),
+        ])
+        dispatcher(x, y, n)
+
+    Each bucket is a `(kernel, predicates, grid)` triple. The predicates map
+    the name or position of an integer argument to a divisor, or to a
+    `(lo, hi)` range, either bound being optional (`lo <= arg < hi`). The
+    grid has up to three dimensions, each an integer or an `(arg, block)`
+    pair for `cdiv(arg, block)`. The kernels take the same arguments.
+    """
+
+    def __init__(self, buckets):
+        if not buckets:
+            raise ValueError("a dispatcher needs at least one kernel")
+        self._kernels = [kernel for kernel, _, _ in buckets]
+        fn = getattr(self._kernels[0].src, "fn", None)
+        arg_names = [name for i, name in enumerate(fn.arg_names) if i not in fn.constexprs] if fn else []
+
+        def position(arg):
+            if isinstance(arg, int):
+                return arg
+            if arg not in arg_names:
+                raise ValueError(f"{arg} is not a runtime argument of the kernel")
+            return arg_names.index(arg)
+
+        resolved = []
+        for _, predicates, grid in buckets:
+            if not 1 <= len(grid) <= 3:
+                raise ValueError(f"invalid grid {grid}")
+            grid = [dim if isinstance(dim, int) else (position(dim[0]), int(dim[1])) for dim in grid]
+            resolved.append(({position(arg): pred
+                              for arg, pred in predicates.items()}, grid + [1] * (3 - len(grid))))
+        src = make_dispatcher(resolved, "__triton_dispatcher")
+        self._mod = compile_module_from_src(src, "__triton_dispatcher")
+        self.select = self._mod.select
+        self._hooks_version = None
+
+    def _bind(self):
+        from triton.compiler.compiler import CompiledKernel
+
+        def launcher_of(kernel):
+            kernel.update_launcher()
+            if kernel.launcher is not None:
+                return kernel.launcher
+            # Launches with hooks, captured launches or launches with global
+            # scratch go through the Python launcher.
+            return lambda g0, g1, g2, stream, *args: kernel[(g0, g1, g2)](*args, stream=stream)
+
+        self._mod.set_launchers([launcher_of(kernel) for kernel in self._kernels])
+        self._hooks_version = CompiledKernel.launch_hooks_version
+
+    def __call__(self, *args, stream=None):
+        from triton.compiler.compiler import CompiledKernel
+        if stream is None:
+            stream = _current_sycl_queue()
+        if self._hooks_version != CompiledKernel.launch_hooks_version:
+            self._bind()
+        self._mod.dispatch(stream, *args)
 
 
 class XPUDriver(DriverBase):
@@ -469,8 +2304,16 @@ class XPUDriver(DriverBase):
         return self.utils.get_current_device()
 
     def get_current_stream(self, device):
-        import torch
-        return torch.xpu.current_stream().sycl_queue
+        return _current_sycl_queue()
+
+    def create_graph(self):
+        return XPUGraph(self.utils)
+
+    def create_task_queue(self, num_queues=4):
+        return XPUTaskQueue(self.utils, num_queues)
+
+    def create_dispatcher(self, buckets):
+        return XPUDispatcher(buckets)
 
     def get_current_target(self):
         import torch
@@ -45,19 +45,23 @@ bool getBoolEnv(const std::string &env) {
   return (str == "on" || str == "true" || str == "1");
 }
 
+// Create a module from either a SPIR-V binary (`binary_size` in 32-bit words)
+// or a device native binary previously retrieved with
+// `zeModuleGetNativeBinary` (`binary_size` in bytes).
 std::tuple<ze_module_handle_t, ze_result_t>
 create_module(ze_context_handle_t context, ze_device_handle_t device,
-              uint8_t *binary_ptr, size_t binary_size,
-              const char *build_flags) {
+              uint8_t *binary_ptr, size_t binary_size, const char *build_flags,
+              const bool is_spv = true) {
   assert(binary_ptr != nullptr && "binary_ptr should not be NULL");
   assert(build_flags != nullptr && "build_flags should not be NULL");
 
-  const ze_module_format_t format = ZE_MODULE_FORMAT_IL_SPIRV;
+  const ze_module_format_t format =
+      is_spv ? ZE_MODULE_FORMAT_IL_SPIRV : ZE_MODULE_FORMAT_NATIVE;
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
   module_description.format = format;
-  module_description.inputSize =
-      static_cast<uint32_t>(binary_size * sizeof(uint32_t));
+  module_description.inputSize = static_cast<uint32_t>(
+      is_spv ? binary_size * sizeof(uint32_t) : binary_size);
   module_description.pInputModule = binary_ptr;
   module_description.pBuildFlags = build_flags;
   ze_module_build_log_handle_t buildlog;
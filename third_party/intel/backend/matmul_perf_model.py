@@ -0,0 +1,216 @@
+"""
+Analytical performance model of DPAS matmul kernels, to prune and rank the
+configurations of an autotuned GEMM before benchmarking them:
+
+    from triton.backends.intel.matmul_perf_model import early_config_prune, estimate_matmul_time
+
+    @triton.autotune(configs=configs, key=["M", "N", "K"],
+                     prune_configs_by={"early_config_prune": early_config_prune,
+                                       "perf_model": estimate_matmul_time, "top_k": 5})
+
+The kernel takes the sizes of the problem as `M`, `N`, `K` (and optionally an
+integer batch size `B` and a `SPLIT_K` factor), and the tile sizes as
+`BLOCK_M`, `BLOCK_N`, `BLOCK_K` or `BLOCK_SIZE_M`, `BLOCK_SIZE_N`,
+`BLOCK_SIZE_K`. A and C are the first and third tensor arguments.
+
+The model only needs to order the configurations: it combines the DPAS
+throughput of the Xe-cores kept busy by the configuration, and the DRAM and L3
+traffic of the tiles, given the device properties, the GRF budget of the
+selected GRF mode and the width of the 2D block loads.
+"""
+
+import functools
+import os
+
+# A hardware thread has 128 64-byte GRFs, or 256 in the large GRF mode.
+SMALL_GRF_BYTES = 128 * 64
+LARGE_GRF_BYTES = 256 * 64
+# Widest row of a 2D block load, in bytes.
+BLOCK_LOAD_ROW_BYTES = 64
+# Bandwidth of the L3 cache relative to the DRAM bandwidth.
+L3_TO_DRAM_BANDWIDTH = 4
+# The systolic depth and repeat count of DPAS instructions.
+DPAS_SYSTOLIC_DEPTH = 8
+DPAS_REPEAT_COUNT = 8
+
+
+def cdiv(x, y):
+    return (x + y - 1) // y
+
+
+@functools.lru_cache
+def _device_info(device):
+    from triton.runtime import driver
+    props = dict(driver.active.utils.get_device_properties(device))
+    arch = driver.active.get_current_target().arch
+    props["dpas_execution_size"] = 8 if min(props["sub_group_sizes"]) == 8 else 16
+    props["has_dpas"] = arch.get("has_subgroup_matrix_multiply_accumulate", False)
+    props["has_tf32_dpas"] = arch.get("has_subgroup_matrix_multiply_accumulate_tensor_float32", False)
+    props["has_fp8_dpas"] = arch.get("has_subgroup_matrix_multiply_accumulate_fp8", False)
+    return props
+
+
+def _ops_per_channel(dtype, info):
+    """Return the number of elements in a 32-bit DPAS channel, or 0 if the dot does not use DPAS."""
+    import torch
+    if not info["has_dpas"]:
+        return 0
+    if dtype in (torch.float16, torch.bfloat16):
+        return 2
+    if dtype in (torch.int8, torch.uint8):
+        return 4
+    if dtype.is_floating_point and dtype.itemsize == 1:
+        # FP8 operands are upcast to FP16 without native FP8 DPAS.
+        return 4 if info["has_fp8_dpas"] else 2
+    if dtype == torch.float32 and info["has_tf32_dpas"]:
+        return 1
+    return 0
+
+
+def _tensors(args):
+    return [arg for arg in args.values() if hasattr(arg, "data_ptr") and hasattr(arg, "dtype")]
+
+
+def _block_sizes(args):
+
+    def get(dim):
+        return args[f"BLOCK_{dim}"] if f"BLOCK_{dim}" in args else args[f"BLOCK_SIZE_{dim}"]
+
+    return get("M"), get("N"), get("K")
+
+
+def _warps_per_tile(block_m, block_n, num_warps, exec_size):
+    """Split the warps of a work-group over the tile like AccelerateMatmul."""
+    row_col_ratio = cdiv(DPAS_REPEAT_COUNT, exec_size)
+    col_row_ratio = cdiv(exec_size, DPAS_REPEAT_COUNT)
+    warps_m, warps_n = 1, 1
+    while warps_m * warps_n < num_warps:
+        if (block_m // (DPAS_REPEAT_COUNT * col_row_ratio) // warps_m
+                >= block_n // (exec_size * row_col_ratio) // warps_n):
+            if warps_m < block_m // DPAS_REPEAT_COUNT:
+                warps_m *= 2
+            else:
+                warps_n *= 2
+        else:
+            warps_n *= 2
+    return warps_m, warps_n
+
+
+class _Config:
+    """The resources used by a configuration of a matmul on a device."""
+
+    def __init__(self, args, num_warps, num_stages):
+        tensors = _tensors(args)
+        a = tensors[0]
+        self.device = a.device.index if a.device.index is not None else 0
+        self.info = _device_info(self.device)
+        self.elem_bytes = a.element_size()
+        self.out_bytes = tensors[2].element_size() if len(tensors) > 2 else self.elem_bytes
+        self.block_m, self.block_n, self.block_k = _block_sizes(args)
+        self.num_warps = num_warps
+        self.num_stages = num_stages
+
+        self.ops_per_channel = _ops_per_channel(a.dtype, self.info)
+        exec_size = self.info["dpas_execution_size"]
+        self.sub_group_size = args.get("threads_per_warp") or exec_size
+        warps_m, warps_n = _warps_per_tile(self.block_m, self.block_n, num_warps, exec_size)
+        # Each warp holds at least one DPAS tile, replicated if the block is too small.
+        self.warp_m = max(cdiv(self.block_m, warps_m), DPAS_REPEAT_COUNT)
+        self.warp_n = max(cdiv(self.block_n, warps_n), exec_size)
+
+        # The accumulator and the A and B tiles of a K step stay in registers.
+        self.grf_bytes = (self.warp_m * self.warp_n * 4 +
+                          (self.warp_m + self.warp_n) * self.block_k * self.elem_bytes) // self.sub_group_size
+        grf_mode = args.get("grf_mode")
+        if grf_mode in ("small", "default"):
+            self.grf_budget, self.large_grf = SMALL_GRF_BYTES, False
+        else:
+            self.grf_budget = LARGE_GRF_BYTES
+            self.large_grf = grf_mode == "large" or self.grf_bytes > SMALL_GRF_BYTES
+
+        self.slm_bytes = 0
+        if os.getenv("TRITON_INTEL_PIPELINE_SLM", "0") == "1":
+            self.slm_bytes = num_stages * (self.block_m + self.block_n) * self.block_k * self.elem_bytes
+
+    def is_valid(self):
+        info = self.info
+        if self.num_warps * self.sub_group_size > info["max_work_group_size"]:
+            return False
+        if self.slm_bytes > info["max_shared_mem"]:
+            return False
+        if self.grf_bytes > self.grf_budget:
+            return False
+        if self.ops_per_channel:
+            # The tile must be made of whole DPAS instructions.
+            dpas_k = DPAS_SYSTOLIC_DEPTH * self.ops_per_channel
+            if self.block_k % dpas_k or self.block_n % info["dpas_execution_size"]:
+                return False
+        return True
+
+    def workgroups_per_xe_core(self):
+        info = self.info
+        threads_per_eu = info["num_threads_per_eu"] // (2 if self.large_grf else 1)
+        workgroups = max(1, info["num_eus_per_xe_core"] * threads_per_eu // self.num_warps)
+        if self.slm_bytes:
+            workgroups = min(workgroups, max(1, info["max_shared_mem"] // self.slm_bytes))
+        return workgroups
+
+
+def early_config_prune(configs, named_args, **kwargs):
+    """
+    Drop the configurations that exceed the maximum work-group size, the SLM of
+    an Xe-core or the GRF budget of their GRF mode, or that don't tile the
+    block with whole DPAS instructions.
+    """
+    args = {**named_args, **kwargs}
+    pruned_configs = []
+    for config in configs:
+        kw = config.all_kwargs()
+        resources = _Config({**args, **kw}, kw.get("num_warps", 4), kw.get("num_stages", 1))
+        if resources.is_valid():
+            pruned_configs.append(config)
+    # Leave the configurations to the benchmark rather than pruning them all.
+    return pruned_configs or configs
+
+
+def estimate_matmul_time(M, N, K, num_warps=4, num_stages=1, SPLIT_K=1, **kwargs):
+    """Return the estimated running time, in ms, of a matmul configuration."""
+    cfg = _Config(kwargs, num_warps, num_stages)
+    info = cfg.info
+    batch = kwargs.get("B")
+    batch = batch if isinstance(batch, int) else 1
+
+    # Compute: the work-groups resident on an Xe-core share its EUs, each
+    # warp running on its own EU.
+    num_xe_cores = info["multiprocessor_count"]
+    eus = info["num_eus_per_xe_core"]
+    tiles = batch * cdiv(M, cfg.block_m) * cdiv(N, cfg.block_n) * SPLIT_K
+    workgroups = min(cfg.workgroups_per_xe_core(), cdiv(tiles, num_xe_cores))
+    waves = cdiv(tiles, workgroups * num_xe_cores)
+    active_eus = min(eus, workgroups * cfg.num_warps)
+    if cfg.ops_per_channel:
+        macs_per_clock = DPAS_SYSTOLIC_DEPTH * info["dpas_execution_size"] * cfg.ops_per_channel
+    else:
+        macs_per_clock = 16
+    clock_hz = info["sm_clock_rate"] * 1e6
+    k_per_tile = cdiv(cdiv(K, SPLIT_K), cfg.block_k) * cfg.block_k
+    # Each warp computes a whole number of DPAS tiles.
+    warp_macs = cfg.warp_m * cfg.warp_n * k_per_tile
+    compute_s = waves * workgroups * cfg.num_warps * warp_macs / (active_eus * macs_per_clock * clock_hz)
+
+    # Memory: the tiles read A and B from L3, which keeps the part of the
+    # operands that fits in it for reuse by the other work-groups.
+    loaded = tiles * (cfg.block_m + cfg.block_n) * k_per_tile * cfg.elem_bytes
+    unique = batch * (M + N) * K * cfg.elem_bytes
+    reuse = min(1.0, info.get("l3_cache_size", 0) / unique) if unique else 1.0
+    dram = unique + max(0, loaded - unique) * (1 - reuse)
+    stored = batch * M * N * cfg.out_bytes * SPLIT_K
+    dram_bw = info["mem_clock_rate"] * 1e6 * info["mem_bus_width"] / 8 * 2 or 1e12
+    l3_bw = L3_TO_DRAM_BANDWIDTH * dram_bw
+    # Loads of narrow rows do not use the full width of the 2D block loads.
+    load_efficiency = min(1.0, min(cfg.block_k, cfg.warp_n) * cfg.elem_bytes / BLOCK_LOAD_ROW_BYTES)
+    memory_s = max(dram / dram_bw, loaded / (l3_bw * load_efficiency)) + stored / dram_bw
+
+    # Prefetching the next tiles overlaps the loads with the DPAS.
+    total_s = max(compute_s, memory_s) if num_stages > 1 else compute_s + memory_s
+    return total_s * 1e3
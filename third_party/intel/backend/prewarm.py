@@ -0,0 +1,73 @@
+"""
+Fill the native binary cache of this node from a manifest of kernels.
+
+Native binaries depend on the device and driver of a node, so they are rebuilt
+by every node even when the SPIR-V of the kernels comes from a shared cache.
+Run the kernels once with `TRITON_INTEL_KERNEL_MANIFEST=<path>` to record them,
+then, on every node sharing the cache (see `RemoteCacheManager` and
+`FileSystemRemoteCacheBackend` in `triton.runtime.cache`):
+
+    python -m triton.backends.intel.prewarm <path> [--device N]
+
+to finalize all the recorded kernels, and build the kernel launcher, before the
+first launch.
+"""
+
+import argparse
+import json
+from pathlib import Path
+
+from triton.runtime.cache import get_cache_manager, read_cache_entry
+
+
+def read_manifest(path):
+    """Return the unique kernels recorded in the manifest at `path`, in recording order."""
+    entries = {}
+    for line in Path(path).read_text().splitlines():
+        if not line.strip():
+            continue
+        record = json.loads(line)
+        key = (record["name"], record["spirv"], record["shared"], record["build_flags"], record["max_reg_spill"])
+        entries.setdefault(key, record)
+    return list(entries.values())
+
+
+def prewarm(path, device=None):
+    """
+    Load every kernel of the manifest at `path` on `device` (the current device
+    by default), storing its native binary in the cache. Returns the number of
+    kernels loaded and the names of the kernels whose SPIR-V is not in the cache.
+    """
+    from triton.runtime import driver
+    from triton.backends.intel.driver import generic_launcher
+    utils = driver.active.utils
+    # The launcher of all the kernels is built once per node.
+    generic_launcher()
+    if device is None:
+        device = driver.active.get_current_device()
+    loaded, missing = 0, []
+    for record in read_manifest(path):
+        name = record["name"]
+        spirv_path = get_cache_manager(record["spirv"]).get_file(f"{name}.spv")
+        if spirv_path is None:
+            missing.append(name)
+            continue
+        utils.load_binary(name, read_cache_entry(spirv_path), record["shared"], record["build_flags"], device,
+                          record["max_reg_spill"])
+        loaded += 1
+    return loaded, missing
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("manifest", help="manifest recorded with TRITON_INTEL_KERNEL_MANIFEST")
+    parser.add_argument("--device", type=int, default=None, help="device to load the kernels on")
+    args = parser.parse_args()
+    loaded, missing = prewarm(args.manifest, args.device)
+    print(f"Loaded {loaded} kernels")
+    for name in missing:
+        print(f"Missing SPIR-V for kernel {name}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,70 @@
+"""
+Pruning of the configurations of an autotuned kernel from the resources of
+their compiled kernels, before benchmarking them:
+
+    from triton.backends.intel.resource_prune import resource_prune
+
+    @triton.autotune(configs=configs, key=["M", "N", "K"],
+                     prune_configs_by={"kernel_prune": resource_prune(max_spills=0, min_workgroups=2)})
+
+The autotuner compiles all the configurations (with `TRITON_COMPILE_WORKERS`
+threads) and passes their kernels to the hook, which reads the spill size, the
+GRF mode and the SLM size from the metadata reported by the driver.
+"""
+
+
+def kernel_resources(kernel):
+    """Return the spill size in bytes and the work-groups per Xe-core of a loaded kernel."""
+    metadata = kernel.metadata
+    spills = getattr(metadata, "spill_size", None)
+    if spills is None:
+        spills = kernel.n_spills or 0
+    # The occupancy accounts for the SLM and for the GRF mode, as the large GRF
+    # mode halves the threads of an EU.
+    workgroups = getattr(metadata, "max_workgroups_per_xe_core", None)
+    return spills, workgroups
+
+
+def _same_work(config):
+    """The configurations splitting the work the same way differ only in their resources."""
+    kwargs = {name: value for name, value in config.kwargs.items() if name != "grf_mode"}
+    return str(sorted(kwargs.items())), config.num_warps, config.num_ctas
+
+
+def _dominates(a, b):
+    """Whether resources `a` spill no more and run no fewer work-groups than `b`, and are better in one of them."""
+    (spills_a, workgroups_a), (spills_b, workgroups_b) = a, b
+    if workgroups_a is None or workgroups_b is None:
+        return spills_a < spills_b
+    if spills_a > spills_b or workgroups_a < workgroups_b:
+        return False
+    return spills_a < spills_b or workgroups_a > workgroups_b
+
+
+def resource_prune(max_spills=0, min_workgroups=2):
+    """
+    Return a `kernel_prune` hook dropping the configurations whose kernel
+    spills more than `max_spills` bytes or whose occupancy is below
+    `min_workgroups` work-groups per Xe-core, unless none of them meets both,
+    and those dominated by a configuration splitting the work the same way
+    (e.g. with a different `num_stages` or `grf_mode`) that spills less and
+    runs at least as many work-groups, or spills as much and runs more.
+    """
+
+    def prune(configs, kernels, named_args, **kwargs):
+        resources = {config: kernel_resources(kernels[config]) for config in configs}
+
+        def fits(config):
+            spills, workgroups = resources[config]
+            return spills <= max_spills and (workgroups is None or workgroups >= min_workgroups)
+
+        candidates = [config for config in configs if fits(config)] or list(configs)
+        groups = {}
+        for config in candidates:
+            groups.setdefault(_same_work(config), []).append(config)
+        return [
+            config for config in candidates
+            if not any(_dominates(resources[other], resources[config]) for other in groups[_same_work(config)])
+        ]
+
+    return prune
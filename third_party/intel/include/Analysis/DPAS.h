@@ -26,6 +26,8 @@ public:
     BF16_BF16_BF16_BF16,
     U32_U32_U8_U8,
     S32_S32_S8_S8,
+    FP32_FP32_BF8_BF8, // native FP8 (E5M2)
+    FP32_FP32_HF8_HF8, // native FP8 (E4M3)
     NOT_APPLICABLE
   };
 
@@ -42,6 +44,12 @@ public:
   /// Given a DotOp operation, return its DPAS engine type.
   static DPASEngineType getDPASType(DotOp op);
 
+  /// Return true if the given DPAS engine type consumes FP8 operands directly.
+  static bool isNativeFP8(DPASEngineType dpasType) {
+    return dpasType == DPASEngineType::FP32_FP32_BF8_BF8 ||
+           dpasType == DPASEngineType::FP32_FP32_HF8_HF8;
+  }
+
 private:
   mlir::ModuleOp mod;
 
@@ -0,0 +1,30 @@
+#ifndef TRITON_INTEL_ANALYSIS_LAYOUT_CONVERSIONS_H
+#define TRITON_INTEL_ANALYSIS_LAYOUT_CONVERSIONS_H
+
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+namespace mlir::triton::gpu::intel {
+
+/// The cost of lowering a `triton_gpu.convert_layout` operation.
+struct LayoutConversionCost {
+  /// The conversion only reorders the registers of each work-item.
+  bool registerLocal = false;
+  /// The conversion exchanges values within the sub-groups only, so it can be
+  /// lowered with sub-group shuffles instead of SLM.
+  bool warpLocal = false;
+  /// The SLM scratch buffer, in bytes, used by the SLM lowering.
+  unsigned slmBytes = 0;
+  /// The number of bytes each work-group stores to and loads from SLM.
+  unsigned slmTrafficBytes = 0;
+  /// The number of work-group barriers emitted by the SLM lowering.
+  unsigned barriers = 0;
+};
+
+/// Price the lowering of \p op. The SLM costs are those of the default
+/// lowering, which goes through SLM unless the values stay in the registers of
+/// each work-item, even for warp-local conversions.
+LayoutConversionCost getLayoutConversionCost(ConvertLayoutOp op);
+
+} // namespace mlir::triton::gpu::intel
+
+#endif // TRITON_INTEL_ANALYSIS_LAYOUT_CONVERSIONS_H
@@ -0,0 +1,24 @@
+#ifndef TRITON_INTEL_ANALYSIS_MEMBAR_H
+#define TRITON_INTEL_ANALYSIS_MEMBAR_H
+
+#include "triton/Analysis/Allocation.h"
+
+namespace mlir::triton::gpu::intel {
+
+/// Runs the MembarAnalysis on the functions of \p allocation, then optimizes
+/// the barriers it inserted for the Intel GPUs:
+///   - barriers separated by operations that do not access the shared local
+///     memory (SLM) are merged,
+///   - a barrier separated from the SLM accesses before and after it by work
+///     hiding its latency (global memory accesses, dots) is replaced by a split
+///     barrier: the signal is hoisted after the last SLM access before the
+///     barrier, and the wait is sunk before the first SLM access after it.
+///
+/// The barriers already in the module (e.g. `tl.debug_barrier`) are kept. No
+/// split barrier is inserted in functions already using split barriers, since
+/// they cannot be nested.
+void runMembarAnalysis(ModuleAllocation &allocation);
+
+} // namespace mlir::triton::gpu::intel
+
+#endif // TRITON_INTEL_ANALYSIS_MEMBAR_H
@@ -0,0 +1,44 @@
+#ifndef TRITON_INTEL_ANALYSIS_RANGE_H
+#define TRITON_INTEL_ANALYSIS_RANGE_H
+
+#include "mlir/Analysis/DataFlow/IntegerRangeAnalysis.h"
+#include "mlir/Analysis/DataFlowFramework.h"
+#include <optional>
+
+namespace mlir::triton::gpu::intel {
+
+/// Integer range analysis of a Triton module. It extends the MLIR analysis,
+/// which covers the arith and scf dialects, to the Triton operations producing
+/// integer tensors: the range of a tensor is the range of its elements.
+///
+/// The kernel arguments are unknown, so the ranges derive from the constants
+/// (e.g. `tl.arange` and constexpr sizes), the loop bounds and the program ids.
+class TritonIntegerRangeAnalysis : public dataflow::IntegerRangeAnalysis {
+public:
+  using dataflow::IntegerRangeAnalysis::IntegerRangeAnalysis;
+
+  LogicalResult visitOperation(
+      Operation *op,
+      ArrayRef<const dataflow::IntegerValueRangeLattice *> operands,
+      ArrayRef<dataflow::IntegerValueRangeLattice *> results) override;
+
+  /// Bounds the induction variable of `scf.for` loops with constant bounds by
+  /// their last iteration rather than by their upper bound.
+  void visitNonControlFlowArguments(
+      Operation *op, const RegionSuccessor &successor,
+      ArrayRef<dataflow::IntegerValueRangeLattice *> argLattices,
+      unsigned firstIndex) override;
+};
+
+/// Run the integer range analysis (and the analyses it depends on) on \p op.
+/// Returns null if the analysis fails.
+std::unique_ptr<DataFlowSolver> runIntegerRangeAnalysis(Operation *op);
+
+/// Returns the range of the integer value (or elements of the integer tensor)
+/// \p value computed by \p solver, if known.
+std::optional<ConstantIntRanges> getIntegerRange(DataFlowSolver &solver,
+                                                 Value value);
+
+} // namespace mlir::triton::gpu::intel
+
+#endif // TRITON_INTEL_ANALYSIS_RANGE_H
@@ -0,0 +1,26 @@
+#ifndef TRITON_INTEL_ANALYSIS_REGISTER_PRESSURE_H
+#define TRITON_INTEL_ANALYSIS_REGISTER_PRESSURE_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+
+namespace mlir::triton::gpu::intel {
+
+/// Return the number of bytes a work-item needs to keep a value of type \p
+/// type in registers. Tensors without a layout are assumed to be distributed
+/// evenly across the \p threadsPerWarp work-items of a sub-group.
+unsigned getBytesPerThread(Type type, unsigned threadsPerWarp);
+
+/// Estimate the register pressure of \p func as the largest number of bytes a
+/// work-item keeps live across any operation in the function, nested regions
+/// included.
+unsigned estimateMaxLiveBytesPerThread(FunctionOpInterface func,
+                                       unsigned threadsPerWarp);
+
+/// Return the largest register pressure estimate across all the functions in
+/// \p mod.
+unsigned estimateMaxLiveBytesPerThread(ModuleOp mod);
+
+} // namespace mlir::triton::gpu::intel
+
+#endif // TRITON_INTEL_ANALYSIS_REGISTER_PRESSURE_H
@@ -0,0 +1,25 @@
+#ifndef TRITON_INTEL_ANALYSIS_UNIFORMITY_H
+#define TRITON_INTEL_ANALYSIS_UNIFORMITY_H
+
+#include "triton/Analysis/AxisInfo.h"
+
+namespace mlir::triton::gpu::intel {
+
+/// Returns true if all the elements of the tensor \p value are equal: the
+/// constancy of \p axisInfo spans the tensor, or the tensor is a splat, a view
+/// (e.g. a broadcast) of a uniform tensor, an elementwise operation on uniform
+/// tensors and scalars, or a load of uniform pointers. Scalars are uniform. At
+/// most \p depth defining operations are looked through.
+bool isUniformTensor(Value value, ModuleAxisInfoAnalysis &axisInfo,
+                     unsigned depth = 6);
+
+/// Returns true if the elements of \p value held by each sub-group are equal,
+/// i.e. the value is the same in every register of every lane of a sub-group.
+/// This is the case for uniform tensors, for tensors whose layout only spreads
+/// the registers and lanes within blocks of equal elements, and for elementwise
+/// operations and loads of sub-group-uniform tensors.
+bool isSubgroupUniform(Value value, ModuleAxisInfoAnalysis &axisInfo);
+
+} // namespace mlir::triton::gpu::intel
+
+#endif // TRITON_INTEL_ANALYSIS_UNIFORMITY_H
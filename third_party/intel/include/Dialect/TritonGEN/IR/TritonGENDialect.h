@@ -18,6 +18,8 @@
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/OpDefinition.h"
 
+#include <optional>
+
 #include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h.inc"
 #include "intel/include/Dialect/TritonGEN/IR/TritonGENOpsEnums.h.inc"
 
@@ -43,6 +45,16 @@ enum TritonGENMemorySpace {
 /// Get the subgroup size from the target.
 int getSubgroupSize(Operation *op);
 
+/// Get the cache control decorations implementing \p orig for the pointer
+/// operand \p operandNum of an operation, or std::nullopt for the default
+/// cache policy.
+std::optional<DecorationCacheControlAttr>
+loadCacheControlToCacheControls(Builder &builder, LoadCacheControl orig,
+                                uint32_t operandNum);
+std::optional<DecorationCacheControlAttr>
+storeCacheControlToCacheControls(Builder &builder, StoreCacheControl orig,
+                                 uint32_t operandNum);
+
 } // namespace mlir::triton::TritonGEN
 
 #endif // TRITON_DIALECT_TRITONGENDIALECT_H
@@ -11,6 +11,8 @@
 
 #include <optional>
 
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "mlir/IR/BuiltinOps.h"
 #include <triton/Tools/Sys/GetEnv.hpp>
 
 namespace mlir::triton::gpu::intel {
@@ -20,6 +22,19 @@ namespace mlir::triton::gpu::intel {
 inline bool applyTransposedReduction() {
   return tools::getBoolEnv("TRITON_INTEL_REDUCE_TRANSPOSE");
 }
+
+/// Check whether the module is compiled by the advanced (warp-level) path.
+/// The decision is recorded by the triton-annotate-module pass; modules it did
+/// not annotate use the advanced path when `TRITON_INTEL_ADVANCED_PATH` is set
+/// and the device supports 2D block IO and DPAS.
+inline bool isAdvancedPathEnabled(ModuleOp mod) {
+  if (auto attr = mod->getAttrOfType<BoolAttr>(
+          TritonIntelGPUDialect::getAdvancedPathAttrName()))
+    return attr.getValue();
+  return mod->hasAttr(TritonIntelGPUDialect::getSupportSG2DBlockAttrName()) &&
+         mod->hasAttr(TritonIntelGPUDialect::getSupportDPASAttrName()) &&
+         tools::getBoolEnv("TRITON_INTEL_ADVANCED_PATH");
+}
 } // namespace mlir::triton::gpu::intel
 
 #endif // TRITON_DIALECT_TRITON_INTEL_GPU_IR_UTILS_H
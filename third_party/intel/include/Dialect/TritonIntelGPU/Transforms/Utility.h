@@ -60,6 +60,26 @@ std::optional<int64_t> getFoldedConstantValue(Operation *op);
 // expected.
 bool isConstant(Value val, const unsigned expected);
 
+// Module attribute holding the size (in bytes) of the print buffer, set when
+// `tt.print` operations append binary records to the buffer instead of calling
+// printf, and attribute holding the id of each `tt.print` operation in the
+// table of formats of the kernel.
+constexpr const char *printBufferSizeAttrName =
+    "triton_intel_gpu.print_buffer_size";
+constexpr const char *printIdAttrName = "triton_intel_gpu.print_id";
+
+// Name of the global holding the print buffer, read by the host after the
+// kernel. Its first word is the number of words reserved by the records that
+// follow it.
+constexpr const char *printBufferName = "__triton_print_buffer";
+
+// Returns the number of 32-bit words of the print buffer record of a
+// work-item for a `tt.print` operand of type `type`, or for a `tt.print`
+// without operands if `type` is null. A record holds the print id, the operand
+// number and the program id, followed by the index and the value of each
+// element of the operand held by the work-item.
+unsigned getPrintRecordNumWords(Type type);
+
 } // namespace mlir::triton::gpu::intel
 
 #endif // TRITON_DIALECT_TRITONINTELGPU_TRANSFORMS_UTILITY_H
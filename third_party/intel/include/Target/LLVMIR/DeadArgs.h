@@ -0,0 +1,20 @@
+#ifndef TRITON_TARGET_LLVMIR_DEADARGS_H
+#define TRITON_TARGET_LLVMIR_DEADARGS_H
+
+#include "llvm/ADT/SmallVector.h"
+
+namespace llvm {
+class Module;
+} // namespace llvm
+
+namespace mlir::triton::intel {
+/// Removes the parameters the kernel of \p module never uses, e.g. after
+/// dead code elimination, so that the launcher neither validates nor sets
+/// them. The last \p numHiddenArgs parameters (global scratch and shared
+/// local memory), passed by the launcher, are kept. Returns the positions of
+/// the removed parameters.
+llvm::SmallVector<unsigned> removeDeadKernelArgs(llvm::Module &module,
+                                                 unsigned numHiddenArgs);
+} // namespace mlir::triton::intel
+
+#endif // TRITON_TARGET_LLVMIR_DEADARGS_H
@@ -3,10 +3,19 @@
 
 namespace llvm {
 class Module;
+class raw_ostream;
 } // namespace llvm
 
 namespace mlir::triton::intel {
-void postProcessLLVMIR(llvm::Module &module);
+struct SLPVectorizerStats;
+
+/// Runs the Intel specific optimizations on \p module. The SLP vectorizer is
+/// skipped when \p fast is set. When \p timingReport is given, the time
+/// spent in each step is written to it. When \p slpStats is given, the
+/// vectorization achieved by the SLP vectorizer is stored in it.
+void postProcessLLVMIR(llvm::Module &module, bool fast = false,
+                       llvm::raw_ostream *timingReport = nullptr,
+                       SLPVectorizerStats *slpStats = nullptr);
 } // namespace mlir::triton::intel
 
 #endif // TRITON_TARGET_LLVMIR_POSTPROCESS_H
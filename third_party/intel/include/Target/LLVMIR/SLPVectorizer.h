@@ -23,7 +23,15 @@ class Module;
 } // namespace llvm
 
 namespace mlir::triton::intel {
-void SLPVectorizer(llvm::Module &module, bool trace);
+/// Vectorization achieved on a module.
+struct SLPVectorizerStats {
+  /// Number of vectorized trees.
+  unsigned numTrees = 0;
+  /// Number of scalar instructions replaced by vector ones.
+  unsigned numScalars = 0;
+};
+
+SLPVectorizerStats SLPVectorizer(llvm::Module &module, bool trace);
 } // namespace mlir::triton::intel
 
 #endif // TRITON_TARGET_LLVMIR_SLPVECTORIZER_H
@@ -97,11 +97,16 @@ DPASAnalysis::DPASEngineType DPASAnalysis::getDPASType(DotOp op) {
         return DPASEngineType::FP32_FP32_BF16_BF16;
       if (aElemTy.isF32() && op.getInputPrecision() == InputPrecision::TF32)
         return DPASEngineType::FP32_FP32_TF32_TF32;
-      // For FP8XFP8->FP32, upcast to FP16
-      if (aElemTy.isFloat8E5M2())
-        return DPASEngineType::FP32_FP32_FP16_FP16;
-      if (aElemTy.isFloat8E4M3FN())
-        return DPASEngineType::FP32_FP32_FP16_FP16;
+      // For FP8XFP8->FP32, use the native FP8 DPAS instruction if available,
+      // otherwise upcast to FP16.
+      if (aElemTy.isFloat8E5M2() || aElemTy.isFloat8E4M3FN()) {
+        auto mod = op->getParentOfType<ModuleOp>();
+        if (!mod || !mod->hasAttr(
+                        TritonIntelGPUDialect::getSupportFP8DPASAttrName()))
+          return DPASEngineType::FP32_FP32_FP16_FP16;
+        return aElemTy.isFloat8E5M2() ? DPASEngineType::FP32_FP32_BF8_BF8
+                                      : DPASEngineType::FP32_FP32_HF8_HF8;
+      }
     } else if (dElemTy.isF16()) {
       if (aElemTy.isF16())
         return DPASEngineType::FP16_FP16_FP16_FP16;
@@ -0,0 +1,43 @@
+#include "intel/include/Analysis/LayoutConversions.h"
+#include "triton/Analysis/Allocation.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Utility.h"
+
+using namespace mlir;
+
+namespace mlir::triton::gpu::intel {
+
+static unsigned getElementBytes(Type elemTy) {
+  // Same element sizes as the allocation of the scratch buffers.
+  if (isa<triton::PointerType>(elemTy))
+    return 8;
+  return std::max<unsigned>(8, elemTy.getIntOrFloatBitWidth()) / 8;
+}
+
+LayoutConversionCost getLayoutConversionCost(ConvertLayoutOp op) {
+  RankedTensorType srcTy = op.getSrc().getType();
+  RankedTensorType dstTy = op.getType();
+  LayoutConversionCost cost;
+  if (!cvtNeedsSharedMemory(srcTy, dstTy)) {
+    cost.registerLocal = true;
+    return cost;
+  }
+  cost.warpLocal = cvtNeedsWarpShuffle(srcTy, dstTy);
+
+  ScratchConfig config = getScratchConfigForCvt(srcTy, dstTy);
+  unsigned elemBytes = getElementBytes(srcTy.getElementType());
+  cost.slmBytes = product<unsigned>(config.paddedRepShape) * elemBytes;
+
+  // The tensor goes through the scratch buffer one replica at a time, with a
+  // barrier between the stores and the loads of a replica and another one
+  // before the stores of the next replica.
+  SmallVector<int64_t> shapePerCTA = getShapePerCTA(srcTy);
+  unsigned numReplicates = 1;
+  for (auto [dim, repDim] : llvm::zip(shapePerCTA, config.repShape))
+    numReplicates *= ceil<unsigned>(dim, repDim);
+  cost.barriers = 2 * numReplicates - 1;
+  cost.slmTrafficBytes = 2 * product<int64_t>(shapePerCTA) * elemBytes;
+  return cost;
+}
+
+} // namespace mlir::triton::gpu::intel
@@ -0,0 +1,152 @@
+#include "intel/include/Analysis/Membar.h"
+#include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Analysis/Membar.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "intel-membar"
+
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace mlir::triton::gpu::intel {
+
+namespace {
+
+bool isBarrier(Operation *op) {
+  return isa<gpu::BarrierOp, TritonGEN::BarrierOp,
+             TritonGEN::SplitBarrierSignalOp, TritonGEN::SplitBarrierWaitOp,
+             TritonGEN::NamedBarrierSignalOp, TritonGEN::NamedBarrierWaitOp>(
+      op);
+}
+
+/// Returns whether a barrier can be moved across \p op, i.e. whether \p op
+/// neither accesses the SLM nor is lowered with barriers of its own.
+bool isMovableAcross(Operation *op, Allocation *allocation) {
+  if (isBarrier(op) || op->getNumRegions() != 0 ||
+      op->hasTrait<OpTrait::IsTerminator>())
+    return false;
+  // Operations with a scratch buffer exchange values through the SLM.
+  if (allocation->getBufferId(op) != Allocation::InvalidBufferId)
+    return false;
+  if (isa<tt::LoadOp, tt::StoreOp>(op)) {
+    auto memEffects = cast<MemoryEffectOpInterface>(op);
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    memEffects.getEffects(effects);
+    return llvm::none_of(effects, [&](MemoryEffects::EffectInstance &effect) {
+      Value value = effect.getValue();
+      return isa<ttg::SharedMemory>(effect.getResource()) ||
+             (value && !allocation->getBufferIds(value).empty());
+    });
+  }
+  // The other operations with side effects (e.g. atomics, which the lowering
+  // surrounds with barriers) are not moved across.
+  return isMemoryEffectFree(op);
+}
+
+/// Returns whether \p op keeps the work-items busy while they wait on a split
+/// barrier.
+bool hidesBarrierLatency(Operation *op) {
+  return isa<tt::LoadOp, tt::StoreOp, tt::DotOp>(op);
+}
+
+/// Erases the barriers of \p block which follow another barrier with no SLM
+/// access in between.
+void mergeBarriers(Block &block, Allocation *allocation,
+                   const DenseSet<Operation *> &userBarriers) {
+  gpu::BarrierOp lastBarrier;
+  for (Operation &op : llvm::make_early_inc_range(block)) {
+    auto barrier = dyn_cast<gpu::BarrierOp>(op);
+    if (!barrier) {
+      if (!isMovableAcross(&op, allocation))
+        lastBarrier = nullptr;
+      continue;
+    }
+    if (!lastBarrier) {
+      lastBarrier = barrier;
+      continue;
+    }
+    // Keep the barriers of the user rather than the inserted ones.
+    if (userBarriers.contains(barrier)) {
+      if (!userBarriers.contains(lastBarrier)) {
+        LLVM_DEBUG(llvm::dbgs() << "Merged barrier: " << lastBarrier << "\n");
+        lastBarrier->erase();
+      }
+      lastBarrier = barrier;
+      continue;
+    }
+    LLVM_DEBUG(llvm::dbgs() << "Merged barrier: " << barrier << "\n");
+    barrier->erase();
+  }
+}
+
+/// Replaces the inserted barriers of \p block by split barriers, when there is
+/// work to do between the SLM accesses before and after them.
+void splitBarriers(Block &block, Allocation *allocation,
+                   const DenseSet<Operation *> &userBarriers) {
+  for (auto barrier :
+       llvm::make_early_inc_range(block.getOps<gpu::BarrierOp>())) {
+    if (userBarriers.contains(barrier))
+      continue;
+
+    bool hidesLatency = false;
+    Operation *signalPoint = barrier;
+    for (Operation *op = barrier->getPrevNode();
+         op && isMovableAcross(op, allocation); op = op->getPrevNode()) {
+      hidesLatency |= hidesBarrierLatency(op);
+      signalPoint = op;
+    }
+    Operation *waitPoint = barrier->getNextNode();
+    for (; isMovableAcross(waitPoint, allocation);
+         waitPoint = waitPoint->getNextNode())
+      hidesLatency |= hidesBarrierLatency(waitPoint);
+    if (!hidesLatency)
+      continue;
+
+    LLVM_DEBUG(llvm::dbgs() << "Split barrier: " << barrier << "\n");
+    OpBuilder builder(signalPoint);
+    builder.create<TritonGEN::SplitBarrierSignalOp>(
+        barrier.getLoc(), TritonGEN::MemFence::LOCAL,
+        TritonGEN::MemScope::WORK_GROUP);
+    builder.setInsertionPoint(waitPoint);
+    builder.create<TritonGEN::SplitBarrierWaitOp>(
+        barrier.getLoc(), TritonGEN::MemFence::LOCAL,
+        TritonGEN::MemScope::WORK_GROUP);
+    barrier->erase();
+  }
+}
+
+} // namespace
+
+void runMembarAnalysis(ModuleAllocation &allocation) {
+  ModuleOp mod = allocation.getModuleOp();
+  DenseSet<Operation *> userBarriers;
+  mod.walk([&](gpu::BarrierOp op) { userBarriers.insert(op); });
+
+  ModuleMembarAnalysis membarPass(&allocation);
+  membarPass.run();
+
+  mod.walk([&](FunctionOpInterface funcOp) {
+    Allocation *funcAllocation = allocation.getFuncData(funcOp);
+    if (!funcAllocation)
+      return;
+    bool hasSplitBarriers = false;
+    funcOp.walk([&](Operation *op) {
+      hasSplitBarriers |=
+          isa<TritonGEN::SplitBarrierSignalOp, TritonGEN::SplitBarrierWaitOp>(
+              op);
+    });
+    SmallVector<Block *> blocks;
+    funcOp.walk([&](Block *block) { blocks.push_back(block); });
+    for (Block *block : blocks) {
+      mergeBarriers(*block, funcAllocation, userBarriers);
+      if (!hasSplitBarriers)
+        splitBarriers(*block, funcAllocation, userBarriers);
+    }
+  });
+}
+
+} // namespace mlir::triton::gpu::intel
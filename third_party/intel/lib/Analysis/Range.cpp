@@ -0,0 +1,93 @@
+#include "intel/include/Analysis/Range.h"
+#include "mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"
+#include "mlir/Analysis/DataFlow/DeadCodeAnalysis.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Matchers.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include <limits>
+
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace mlir::triton::gpu::intel {
+
+LogicalResult TritonIntegerRangeAnalysis::visitOperation(
+    Operation *op,
+    ArrayRef<const dataflow::IntegerValueRangeLattice *> operands,
+    ArrayRef<dataflow::IntegerValueRangeLattice *> results) {
+  auto join = [&](const IntegerValueRange &range) {
+    dataflow::IntegerValueRangeLattice *lattice = results.front();
+    propagateIfChanged(lattice, lattice->join(range));
+  };
+  auto signedRange = [](unsigned width, int64_t min, int64_t max) {
+    return IntegerValueRange(ConstantIntRanges::fromSigned(
+        APInt(width, min, /*isSigned=*/true),
+        APInt(width, max, /*isSigned=*/true)));
+  };
+
+  if (auto makeRangeOp = dyn_cast<tt::MakeRangeOp>(op)) {
+    join(signedRange(32, makeRangeOp.getStart(), makeRangeOp.getEnd() - 1));
+    return success();
+  }
+  // The program ids are in [0, num_programs), without a bound on the grid.
+  if (isa<tt::GetProgramIdOp>(op)) {
+    join(signedRange(32, 0, std::numeric_limits<int32_t>::max() - 1));
+    return success();
+  }
+  if (isa<tt::GetNumProgramsOp>(op)) {
+    join(signedRange(32, 1, std::numeric_limits<int32_t>::max()));
+    return success();
+  }
+  // The elements of the result are elements of the operand.
+  if (isa<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp, tt::ReshapeOp,
+          tt::TransOp, ttg::ConvertLayoutOp>(op) &&
+      getElementTypeOrSelf(op->getResult(0)).isIntOrIndex()) {
+    join(operands.front()->getValue());
+    return success();
+  }
+  return dataflow::IntegerRangeAnalysis::visitOperation(op, operands, results);
+}
+
+void TritonIntegerRangeAnalysis::visitNonControlFlowArguments(
+    Operation *op, const RegionSuccessor &successor,
+    ArrayRef<dataflow::IntegerValueRangeLattice *> argLattices,
+    unsigned firstIndex) {
+  if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+    APInt lb, ub, step;
+    if (matchPattern(forOp.getLowerBound(), m_ConstantInt(&lb)) &&
+        matchPattern(forOp.getUpperBound(), m_ConstantInt(&ub)) &&
+        matchPattern(forOp.getStep(), m_ConstantInt(&step)) &&
+        step.isStrictlyPositive() && ub.sgt(lb)) {
+      APInt last = lb + (ub - lb - 1).sdiv(step) * step;
+      dataflow::IntegerValueRangeLattice *ivLattice =
+          getLatticeElement(forOp.getInductionVar());
+      propagateIfChanged(ivLattice,
+                         ivLattice->join(IntegerValueRange(
+                             ConstantIntRanges::fromSigned(lb, last))));
+      return;
+    }
+  }
+  dataflow::IntegerRangeAnalysis::visitNonControlFlowArguments(
+      op, successor, argLattices, firstIndex);
+}
+
+std::unique_ptr<DataFlowSolver> runIntegerRangeAnalysis(Operation *op) {
+  auto solver = std::make_unique<DataFlowSolver>();
+  solver->load<dataflow::DeadCodeAnalysis>();
+  solver->load<dataflow::SparseConstantPropagation>();
+  solver->load<TritonIntegerRangeAnalysis>();
+  if (failed(solver->initializeAndRun(op)))
+    return nullptr;
+  return solver;
+}
+
+std::optional<ConstantIntRanges> getIntegerRange(DataFlowSolver &solver,
+                                                 Value value) {
+  auto *lattice = solver.lookupState<dataflow::IntegerValueRangeLattice>(value);
+  if (!lattice || lattice->getValue().isUninitialized())
+    return std::nullopt;
+  return lattice->getValue().getValue();
+}
+
+} // namespace mlir::triton::gpu::intel
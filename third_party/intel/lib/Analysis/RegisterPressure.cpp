@@ -0,0 +1,78 @@
+#include "intel/include/Analysis/RegisterPressure.h"
+#include "mlir/Analysis/Liveness.h"
+#include "triton/Dialect/Triton/IR/Types.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+using namespace mlir;
+
+namespace mlir::triton::gpu::intel {
+
+static unsigned getElementBytes(Type elemTy) {
+  if (isa<triton::PointerType>(elemTy) || elemTy.isIndex())
+    return 8;
+  if (elemTy.isIntOrFloat())
+    return std::max<unsigned>(1, elemTy.getIntOrFloatBitWidth() / 8);
+  return 0;
+}
+
+unsigned getBytesPerThread(Type type, unsigned threadsPerWarp) {
+  assert(threadsPerWarp != 0 && "expecting a non-zero sub-group size");
+  if (auto tensorTy = dyn_cast<RankedTensorType>(type)) {
+    unsigned elemBytes = getElementBytes(tensorTy.getElementType());
+    if (tensorTy.getEncoding())
+      return getTotalElemsPerThread(tensorTy) * elemBytes;
+    return llvm::divideCeil(tensorTy.getNumElements() * elemBytes,
+                            threadsPerWarp);
+  }
+  // Values in shared memory (e.g. memory descriptors) do not occupy
+  // registers.
+  return getElementBytes(type);
+}
+
+unsigned estimateMaxLiveBytesPerThread(FunctionOpInterface func,
+                                       unsigned threadsPerWarp) {
+  if (func.isExternal())
+    return 0;
+
+  Liveness liveness(func);
+  unsigned maxBytes = 0;
+  func->walk([&](Operation *op) {
+    if (op == func.getOperation())
+      return;
+
+    // Values live across an enclosing operation are live in its regions too,
+    // even when they are not used there.
+    DenseSet<Value> liveValues;
+    for (Operation *curr = op; curr != func.getOperation();
+         curr = curr->getParentOp()) {
+      const LivenessBlockInfo *livenessInfo =
+          liveness.getLiveness(curr->getBlock());
+      if (!livenessInfo)
+        continue;
+      for (Value val : livenessInfo->currentlyLiveValues(curr)) {
+        // The results of an enclosing operation are not defined yet.
+        if (curr != op && val.getDefiningOp() == curr)
+          continue;
+        liveValues.insert(val);
+      }
+    }
+
+    unsigned bytes = 0;
+    for (Value val : liveValues)
+      bytes += getBytesPerThread(val.getType(), threadsPerWarp);
+    maxBytes = std::max(maxBytes, bytes);
+  });
+  return maxBytes;
+}
+
+unsigned estimateMaxLiveBytesPerThread(ModuleOp mod) {
+  unsigned threadsPerWarp = TritonGPUDialect::getThreadsPerWarp(mod);
+  unsigned maxBytes = 0;
+  mod.walk([&](FunctionOpInterface func) {
+    maxBytes = std::max(maxBytes,
+                        estimateMaxLiveBytesPerThread(func, threadsPerWarp));
+  });
+  return maxBytes;
+}
+
+} // namespace mlir::triton::gpu::intel
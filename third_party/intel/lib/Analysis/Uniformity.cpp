@@ -0,0 +1,116 @@
+#include "intel/include/Analysis/Uniformity.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+#include "llvm/Support/MathExtras.h"
+
+namespace mlir::triton::gpu::intel {
+
+namespace {
+
+/// Returns the operands of \p op whose uniformity implies the uniformity of
+/// its result, if any: the operands of elementwise operations, and the
+/// pointers, mask and `other` value of non-volatile loads. The operands of
+/// these operations have the layout of their result.
+std::optional<OperandRange> getElementwiseSources(Operation *op) {
+  if (auto load = dyn_cast<triton::LoadOp>(op)) {
+    if (load.getIsVolatile())
+      return std::nullopt;
+    return op->getOperands();
+  }
+  if (op->getNumResults() == 1 && isMemoryEffectFree(op) &&
+      op->hasTrait<OpTrait::Elementwise>())
+    return op->getOperands();
+  return std::nullopt;
+}
+
+/// Returns true if the registers and lanes of the layout of \p value, relative
+/// to the first element of a sub-group, stay within the aligned blocks of
+/// equal elements found by the axis analysis.
+bool hasSubgroupConstancy(Value value, ModuleAxisInfoAnalysis &axisInfo) {
+  auto tensorTy = cast<RankedTensorType>(value.getType());
+  AxisInfo *info = axisInfo.getAxisInfo(value);
+  if (!info || info->getRank() != tensorTy.getRank())
+    return false;
+  std::optional<LinearLayout> ll =
+      toLinearLayout(tensorTy.getShape(), tensorTy.getEncoding());
+  if (!ll)
+    return false;
+
+  // The bits of the coordinates above the blocks only come from the warps, so
+  // the elements of a sub-group all belong to a single block.
+  MLIRContext *ctx = value.getContext();
+  for (StringRef name : {"register", "lane"}) {
+    StringAttr inDim = StringAttr::get(ctx, name);
+    for (int i = 0; i < ll->getInDimSizeLog2(inDim); ++i) {
+      for (auto [dim, outDim] : llvm::enumerate(ll->getOutDimNames())) {
+        int64_t constancy = info->getConstancy(dim);
+        if (!llvm::isPowerOf2_64(constancy) ||
+            ll->getBasis(inDim, i, outDim) >= constancy)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool isSubgroupUniform(Value value, ModuleAxisInfoAnalysis &axisInfo,
+                       unsigned depth) {
+  if (!isa<RankedTensorType>(value.getType()) ||
+      isUniformTensor(value, axisInfo, depth) ||
+      hasSubgroupConstancy(value, axisInfo))
+    return true;
+
+  Operation *op = value.getDefiningOp();
+  if (!op || depth == 0)
+    return false;
+  std::optional<OperandRange> sources = getElementwiseSources(op);
+  return sources && llvm::all_of(*sources, [&](Value operand) {
+           return isSubgroupUniform(operand, axisInfo, depth - 1);
+         });
+}
+
+} // namespace
+
+bool isUniformTensor(Value value, ModuleAxisInfoAnalysis &axisInfo,
+                     unsigned depth) {
+  auto tensorTy = dyn_cast<RankedTensorType>(value.getType());
+  if (!tensorTy)
+    return true;
+
+  if (AxisInfo *info = axisInfo.getAxisInfo(value)) {
+    if (info->getRank() == tensorTy.getRank() &&
+        llvm::all_of(llvm::seq<unsigned>(0, tensorTy.getRank()),
+                     [&](unsigned dim) {
+                       return info->getConstancy(dim) ==
+                              tensorTy.getDimSize(dim);
+                     }))
+      return true;
+  }
+
+  // The axis analysis neither covers floating point operations nor loads, so
+  // the sources of the value are looked at too.
+  Operation *op = value.getDefiningOp();
+  if (!op || depth == 0)
+    return false;
+  if (isa<triton::SplatOp>(op))
+    return true;
+  DenseElementsAttr attr;
+  if (matchPattern(value, m_Constant(&attr)))
+    return attr.isSplat();
+  if (isa<triton::BroadcastOp, triton::ExpandDimsOp, triton::ReshapeOp,
+          triton::TransOp, ConvertLayoutOp>(op))
+    return isUniformTensor(op->getOperand(0), axisInfo, depth - 1);
+  std::optional<OperandRange> sources = getElementwiseSources(op);
+  return sources && llvm::all_of(*sources, [&](Value operand) {
+           return isUniformTensor(operand, axisInfo, depth - 1);
+         });
+}
+
+bool isSubgroupUniform(Value value, ModuleAxisInfoAnalysis &axisInfo) {
+  return isSubgroupUniform(value, axisInfo, /*depth=*/6);
+}
+
+} // namespace mlir::triton::gpu::intel
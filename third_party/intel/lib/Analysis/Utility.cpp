@@ -7,21 +7,32 @@ namespace mlir::triton::gpu::intel {
 bool isDpasToDotShortcut(RankedTensorType dpasTy, RankedTensorType dotTy) {
   auto dpasLayout = dyn_cast<DpasEncodingAttr>(dpasTy.getEncoding());
   auto dotOperandLayout = dyn_cast<DotOperandEncodingAttr>(dotTy.getEncoding());
+  if (!dpasLayout || !dotOperandLayout)
+    return false;
+  auto parentLayout = dyn_cast<DpasEncodingAttr>(dotOperandLayout.getParent());
+  if (!parentLayout)
+    return false;
+
   // dpas -> dot_operand conversion when:
-  if (dpasLayout && dotOperandLayout &&
-      dotOperandLayout.getParent() == dpasLayout) {
-    SmallVector<unsigned> shapeC = dpasLayout.getDPASInstShapeC();
-    SmallVector<unsigned> shapeA = dpasLayout.getDPASInstShapeA();
-    if (dotOperandLayout.getOpIdx() == 0 && /* A operands. */
-        dpasLayout.getWarpsPerCTA().back() ==
-            1 && /* The warpsPerCTA is [..., 1]. */
-        shapeA[0] == shapeC[0] &&
-        shapeA[1] == shapeC[1] /* C shape is equal to A shape */
-    )
-      return true;
-  }
+  SmallVector<unsigned> shapeC = dpasLayout.getDPASInstShapeC();
+  SmallVector<unsigned> shapeA = parentLayout.getDPASInstShapeA();
+  if (dotOperandLayout.getOpIdx() != 0 || /* A operands. */
+      dpasLayout.getWarpsPerCTA().back() !=
+          1 || /* The warpsPerCTA is [..., 1]. */
+      shapeA[0] != shapeC[0] ||
+      shapeA[1] != shapeC[1] /* C shape is equal to A shape */)
+    return false;
 
-  return false;
+  // The result of a dot feeding the A operand of a chained dot (e.g. P@V in
+  // flash attention) may have a different repCluster along N than the chained
+  // dot: the values are moved per DPAS instruction tile, so only the tiles
+  // held by each thread have to match.
+  return dpasLayout == parentLayout ||
+         (dpasLayout.getRepeatCount() == parentLayout.getRepeatCount() &&
+          dpasLayout.getExecutionSize() == parentLayout.getExecutionSize() &&
+          dpasLayout.getSubGroupSize() == parentLayout.getSubGroupSize() &&
+          dpasLayout.getWarpsPerCTA() == parentLayout.getWarpsPerCTA() &&
+          dpasLayout.getRepCluster()[0] == parentLayout.getRepCluster()[0]);
 }
 
 } // namespace mlir::triton::gpu::intel
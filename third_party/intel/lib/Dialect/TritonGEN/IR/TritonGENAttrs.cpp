@@ -51,4 +51,112 @@ LogicalResult TritonGEN::DecorationCacheControlAttr::verify(
   }
   return success();
 }
+
+//===----------------------------------------------------------------------===//
+// Cache controls
+//===----------------------------------------------------------------------===//
+
+static SmallVector<Attribute>
+loadCacheControlToDecoration(Builder &builder, uint32_t operandNum,
+                             TritonGEN::LoadCacheControl orig) {
+  const auto build = [&builder,
+                      operandNum](TritonGEN::LoadCacheControlDecorationEnum l1,
+                                  TritonGEN::LoadCacheControlDecorationEnum l3)
+      -> SmallVector<Attribute> {
+    return {builder.getAttr<TritonGEN::LoadCacheControlDecorationAttr>(
+                0, l1, operandNum),
+            builder.getAttr<TritonGEN::LoadCacheControlDecorationAttr>(
+                1, l3, operandNum)};
+  };
+
+  switch (orig) {
+  case TritonGEN::LoadCacheControl::DEFAULT:
+    return {};
+  case TritonGEN::LoadCacheControl::L1UC_L3UC:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Uncached,
+                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
+  case TritonGEN::LoadCacheControl::L1UC_L3C:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Uncached,
+                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
+  case TritonGEN::LoadCacheControl::L1C_L3UC:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Cached,
+                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
+  case TritonGEN::LoadCacheControl::L1C_L3C:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Cached,
+                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
+  case TritonGEN::LoadCacheControl::L1S_L3UC:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Streaming,
+                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
+  case TritonGEN::LoadCacheControl::L1S_L3C:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::Streaming,
+                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
+  case TritonGEN::LoadCacheControl::L1IAR_L3C:
+    return build(TritonGEN::LoadCacheControlDecorationEnum::InvalidateAfterRead,
+                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
+  }
+  llvm_unreachable("Unhandled case");
+}
+
+std::optional<TritonGEN::DecorationCacheControlAttr>
+loadCacheControlToCacheControls(Builder &builder,
+                                TritonGEN::LoadCacheControl orig,
+                                uint32_t operandNum) {
+  SmallVector<Attribute> decorations =
+      loadCacheControlToDecoration(builder, operandNum, orig);
+  if (decorations.empty())
+    return {};
+  return builder.getAttr<TritonGEN::DecorationCacheControlAttr>(decorations);
+}
+
+static SmallVector<Attribute>
+storeCacheControlToDecoration(Builder &builder, uint32_t operandNum,
+                              TritonGEN::StoreCacheControl orig) {
+  const auto build = [&builder,
+                      operandNum](TritonGEN::StoreCacheControlDecorationEnum l1,
+                                  TritonGEN::StoreCacheControlDecorationEnum l3)
+      -> SmallVector<Attribute> {
+    return {builder.getAttr<TritonGEN::StoreCacheControlDecorationAttr>(
+                0, l1, operandNum),
+            builder.getAttr<TritonGEN::StoreCacheControlDecorationAttr>(
+                1, l3, operandNum)};
+  };
+
+  switch (orig) {
+  case TritonGEN::StoreCacheControl::DEFAULT:
+    return {};
+  case TritonGEN::StoreCacheControl::L1UC_L3UC:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::Uncached,
+                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
+  case TritonGEN::StoreCacheControl::L1UC_L3WB:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::Uncached,
+                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
+  case TritonGEN::StoreCacheControl::L1WT_L3UC:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteThrough,
+                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
+  case TritonGEN::StoreCacheControl::L1WT_L3WB:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteThrough,
+                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
+  case TritonGEN::StoreCacheControl::L1S_L3UC:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::Streaming,
+                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
+  case TritonGEN::StoreCacheControl::L1S_L3WB:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::Streaming,
+                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
+  case TritonGEN::StoreCacheControl::L1WB_L3WB:
+    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteBack,
+                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
+  }
+  llvm_unreachable("Unhandled case");
+}
+
+std::optional<TritonGEN::DecorationCacheControlAttr>
+storeCacheControlToCacheControls(Builder &builder,
+                                 TritonGEN::StoreCacheControl orig,
+                                 uint32_t operandNum) {
+  SmallVector<Attribute> decorations =
+      storeCacheControlToDecoration(builder, operandNum, orig);
+  if (decorations.empty())
+    return {};
+  return builder.getAttr<TritonGEN::DecorationCacheControlAttr>(decorations);
+}
 } // namespace mlir::triton::TritonGEN
@@ -74,6 +74,11 @@ LogicalResult TritonGEN::SubGroupReduceOp::verify() {
     return this->emitOpError(
         "expecting size to be a power of 2 between 1 and subgroup size");
 
+  if (!llvm::isPowerOf2_32(getInterleave()) ||
+      getSize() * getInterleave() > TritonGEN::getSubgroupSize(*this))
+    return this->emitOpError("expecting interleave to be a power of 2 and "
+                             "size * interleave to not exceed subgroup size");
+
   return success();
 }
 
@@ -129,13 +134,15 @@ LogicalResult TritonGEN::MatrixDPASOp::verify() {
                                "result should be bf16 or f32");
     break;
   case PrecisionType::TF32:
+  case PrecisionType::BF8:
+  case PrecisionType::HF8:
     if (!CElemTy.isF32())
       return this->emitOpError(
           "the element type for 1st operand (C) and the result should be f32");
     break;
   default:
-    return this->emitOpError(
-        "expecting precision type to be tf32, bf16, fp16, u8, or s8");
+    return this->emitOpError("expecting precision type to be tf32, bf16, "
+                             "fp16, bf8, hf8, u8, or s8");
   }
 
   switch (precision) {
@@ -154,6 +161,8 @@ LogicalResult TritonGEN::MatrixDPASOp::verify() {
   case TritonGEN::PrecisionType::FP16:
   case TritonGEN::PrecisionType::U8:
   case TritonGEN::PrecisionType::S8:
+  case TritonGEN::PrecisionType::BF8:
+  case TritonGEN::PrecisionType::HF8:
     if (ATy.getNumElements() != getRc())
       return this->emitOpError("2nd operand (A) should have the same number of "
                                "elements as repeat count");
@@ -319,6 +319,10 @@ private:
 
         if (trace)
           print(SetPayloads);
+
+        // The field is overwritten with a different value, so an earlier set
+        // of the same value does not make this one dead.
+        return false;
       }
     }
 
@@ -0,0 +1,60 @@
+#include "third_party/intel/include/Target/LLVMIR/DeadArgs.h"
+
+#include "llvm/IR/Attributes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+
+namespace mlir::triton::intel {
+
+SmallVector<unsigned> removeDeadKernelArgs(Module &module,
+                                           unsigned numHiddenArgs) {
+  SmallVector<unsigned> deadArgs;
+  for (Function &func : make_early_inc_range(module)) {
+    // The kernel is only referenced by its name, from the host.
+    if (func.isDeclaration() ||
+        func.getCallingConv() != CallingConv::SPIR_KERNEL ||
+        !func.use_empty() || func.arg_size() < numHiddenArgs)
+      continue;
+
+    SmallVector<Type *> paramTypes;
+    SmallVector<AttributeSet> paramAttrs;
+    AttributeList attrs = func.getAttributes();
+    unsigned numArgs = func.arg_size() - numHiddenArgs;
+    for (Argument &arg : func.args()) {
+      if (arg.getArgNo() < numArgs && arg.use_empty()) {
+        deadArgs.push_back(arg.getArgNo());
+        continue;
+      }
+      paramTypes.push_back(arg.getType());
+      paramAttrs.push_back(attrs.getParamAttrs(arg.getArgNo()));
+    }
+    if (deadArgs.empty())
+      return deadArgs;
+
+    auto *funcType = FunctionType::get(func.getReturnType(), paramTypes,
+                                       func.isVarArg());
+    Function *newFunc = Function::Create(funcType, func.getLinkage(),
+                                         func.getAddressSpace(), "", &module);
+    newFunc->copyAttributesFrom(&func);
+    newFunc->setAttributes(AttributeList::get(module.getContext(),
+                                              attrs.getFnAttrs(),
+                                              attrs.getRetAttrs(), paramAttrs));
+    newFunc->copyMetadata(&func, 0);
+    newFunc->splice(newFunc->begin(), &func);
+    auto newArg = newFunc->arg_begin();
+    for (Argument &arg : func.args()) {
+      if (llvm::is_contained(deadArgs, arg.getArgNo()))
+        continue;
+      newArg->takeName(&arg);
+      arg.replaceAllUsesWith(&*newArg++);
+    }
+    newFunc->takeName(&func);
+    func.eraseFromParent();
+    return deadArgs;
+  }
+  return deadArgs;
+}
+
+} // namespace mlir::triton::intel
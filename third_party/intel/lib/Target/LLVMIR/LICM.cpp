@@ -27,13 +27,15 @@ public:
     auto &SE = AM.getResult<ScalarEvolutionAnalysis>(F);
     auto &MSSA = AM.getResult<MemorySSAAnalysis>(F).getMSSA();
 
+    // Visit inner loops before their parent, so that an instruction hoisted
+    // out of an inner loop can be hoisted again out of the outer loop.
     bool changed = false;
-    for (Loop *L : LI) {
+    for (Loop *L : llvm::reverse(LI.getLoopsInPreorder())) {
       BasicBlock *preHeader = L->getLoopPreheader();
       if (!preHeader)
         continue;
 
-      changed = runOnLoop(*L, LI, AA, DT, MSSA, SE);
+      changed |= runOnLoop(*L, LI, AA, DT, MSSA, SE);
     }
 
     return changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
@@ -4,13 +4,18 @@
 #include "third_party/intel/include/Target/LLVMIR/SLPVectorizer.h"
 
 #include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "triton/Tools/Sys/GetEnv.hpp"
 
+#include <chrono>
+
 namespace mlir::triton::intel {
 
-void postProcessLLVMIR(llvm::Module &mod) {
+void postProcessLLVMIR(llvm::Module &mod, bool fast,
+                       llvm::raw_ostream *timingReport,
+                       SLPVectorizerStats *slpStats) {
   bool trace = tools::getBoolEnv("LLVM_IR_ENABLE_DUMP");
 
   auto print = [&](llvm::StringRef title, llvm::Module &mod) {
@@ -35,17 +40,31 @@ void postProcessLLVMIR(llvm::Module &mod) {
              "__devicelib_assert_fail must be a declaration!");
     }
   }
-  print("PostProcessing: Before SLPVectorizer", mod);
-  SLPVectorizer(mod, trace);
-  print("PostProcessing: After SLPVectorizer", mod);
-
-  print("PostProcessing: Before LICM", mod);
-  LICM(mod, trace);
-  print("PostProcessing: After LICM", mod);
+  auto run = [&](llvm::StringRef name, auto &&step) {
+    print(("PostProcessing: Before " + name).str(), mod);
+    auto start = std::chrono::steady_clock::now();
+    step(mod, trace);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (timingReport)
+      *timingReport << llvm::format("%10.4f", elapsed.count()) << "  " << name
+                    << "\n";
+    print(("PostProcessing: After " + name).str(), mod);
+  };
 
-  print("PostProcessing: Before DSE", mod);
-  DSE(mod, trace);
-  print("PostProcessing: After DSE", mod);
+  if (timingReport)
+    *timingReport << "===" << std::string(73, '-') << "===\n"
+                  << "  Intel post-processing execution timing report\n"
+                  << "===" << std::string(73, '-') << "===\n"
+                  << "  Wall Time (s)  Name\n";
+  if (!fast)
+    run("SLPVectorizer", [&](llvm::Module &mod, bool trace) {
+      SLPVectorizerStats stats = SLPVectorizer(mod, trace);
+      if (slpStats)
+        *slpStats = stats;
+    });
+  run("LICM", LICM);
+  run("DSE", DSE);
 }
 
 } // namespace mlir::triton::intel
@@ -46,6 +46,7 @@
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Analysis/TargetTransformInfoImpl.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/Analysis/VectorUtils.h"
 #include "llvm/IR/Attributes.h"
@@ -1113,6 +1114,16 @@ public:
 
   unsigned getTreeSize() const { return VectorizableTree.size(); }
 
+  /// \returns the number of scalar instructions replaced by vector ones when
+  /// the tree is vectorized.
+  unsigned getNumVectorizedScalars() const {
+    unsigned NumScalars = 0;
+    for (const std::unique_ptr<TreeEntry> &TE : VectorizableTree)
+      if (TE->State != TreeEntry::NeedToGather)
+        NumScalars += TE->Scalars.size();
+    return NumScalars;
+  }
+
   /// Perform LICM and CSE on the newly generated gather sequences.
   void optimizeGatherSequence();
 
@@ -15113,7 +15124,8 @@ struct SLPVectorizerPass : public PassInfoMixin<SLPVectorizerPass> {
   const DataLayout *DL = nullptr;
 
 public:
-  SLPVectorizerPass(bool trace) : trace(trace) {}
+  SLPVectorizerPass(bool trace, mlir::triton::intel::SLPVectorizerStats &stats)
+      : trace(trace), stats(stats) {}
 
   PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
 
@@ -15124,6 +15136,7 @@ public:
 
 private:
   bool trace;
+  mlir::triton::intel::SLPVectorizerStats &stats;
 
   /// Try to vectorize a list of operands.
   /// \param MaxVFOnly Vectorize only using maximal allowed register size.
@@ -15307,6 +15320,8 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
                         << " for VF=" << ActualVF << "\n");
       if (Cost <= -SLPCostThreshold) {
         LLVM_DEBUG(dbgs() << "SLP: Vectorizing list at cost:" << Cost << ".\n");
+        ++stats.numTrees;
+        stats.numScalars += R.getNumVectorizedScalars();
         R.vectorizeTree();
         // Move to the next bundle.
         I += VF - 1;
@@ -15465,12 +15480,133 @@ static bool isCandidate(llvm::Function &F) {
   });
 }
 
+namespace {
+/// Cost model of the Xe GPUs. The target independent model prices an
+/// operation on a vector like a scalar one, whatever the width of the vector.
+///
+/// On Xe, a vector of a work-item spans several GRFs, and an arithmetic
+/// operation on it takes one instruction per element, or per pair of 16-bit
+/// elements. The gains of vectorization come from:
+///  - loads and stores of up to 16 elements, the shape of the 2D block IO
+///    messages, which replace one message per element;
+///  - the insertelement chains building the DPAS operands and the stored
+///    vectors, which cost one move per element;
+///  - shuffles, which only select GRF regions and are free.
+class XeTTIImpl : public TargetTransformInfoImplCRTPBase<XeTTIImpl> {
+  using BaseT = TargetTransformInfoImplCRTPBase<XeTTIImpl>;
+
+  /// Number of 32-bit elements of the preferred vectors.
+  static constexpr unsigned PreferredNumElts = 16;
+
+  /// \returns the number of instructions of an operation on \p Ty.
+  static unsigned getNumInstrs(Type *Ty) {
+    auto *VecTy = dyn_cast<FixedVectorType>(Ty);
+    if (!VecTy)
+      return 1;
+    unsigned NumElts = VecTy->getNumElements();
+    return VecTy->getScalarSizeInBits() <= 16 ? divideCeil(NumElts, 2)
+                                              : NumElts;
+  }
+
+public:
+  explicit XeTTIImpl(const DataLayout &DL) : BaseT(DL) {}
+
+  unsigned getNumberOfRegisters(unsigned ClassID) const { return 128; }
+
+  TypeSize getRegisterBitWidth(TTI::RegisterKind K) const {
+    switch (K) {
+    case TTI::RGK_Scalar:
+      return TypeSize::getFixed(32);
+    case TTI::RGK_FixedWidthVector:
+      return TypeSize::getFixed(PreferredNumElts * 32);
+    case TTI::RGK_ScalableVector:
+      return TypeSize::getScalable(0);
+    }
+    llvm_unreachable("Unsupported register kind");
+  }
+
+  unsigned getMinVectorRegisterBitWidth() const { return 64; }
+
+  InstructionCost getArithmeticInstrCost(
+      unsigned Opcode, Type *Ty, TTI::TargetCostKind CostKind,
+      TTI::OperandValueInfo Opd1Info, TTI::OperandValueInfo Opd2Info,
+      ArrayRef<const Value *> Args, const Instruction *CxtI = nullptr) const {
+    return BaseT::getArithmeticInstrCost(Opcode, Ty->getScalarType(),
+                                         CostKind, Opd1Info, Opd2Info, Args,
+                                         CxtI) *
+           getNumInstrs(Ty);
+  }
+
+  InstructionCost getCastInstrCost(unsigned Opcode, Type *Dst, Type *Src,
+                                   TTI::CastContextHint CCH,
+                                   TTI::TargetCostKind CostKind,
+                                   const Instruction *I) const {
+    return BaseT::getCastInstrCost(Opcode, Dst->getScalarType(),
+                                   Src->getScalarType(), CCH, CostKind, I) *
+           getNumInstrs(Dst);
+  }
+
+  InstructionCost getCmpSelInstrCost(unsigned Opcode, Type *ValTy,
+                                     Type *CondTy, CmpInst::Predicate VecPred,
+                                     TTI::TargetCostKind CostKind,
+                                     const Instruction *I) const {
+    return getNumInstrs(ValTy);
+  }
+
+  InstructionCost getIntrinsicInstrCost(const IntrinsicCostAttributes &ICA,
+                                        TTI::TargetCostKind CostKind) const {
+    return BaseT::getIntrinsicInstrCost(ICA, CostKind) *
+           getNumInstrs(ICA.getReturnType());
+  }
+
+  InstructionCost getMemoryOpCost(unsigned Opcode, Type *Src,
+                                  Align Alignment, unsigned AddressSpace,
+                                  TTI::TargetCostKind CostKind,
+                                  TTI::OperandValueInfo OpInfo,
+                                  const Instruction *I) const {
+    // One message per preferred vector.
+    auto *VecTy = dyn_cast<FixedVectorType>(Src);
+    if (!VecTy)
+      return 1;
+    return divideCeil(VecTy->getPrimitiveSizeInBits().getFixedValue(),
+                      PreferredNumElts * 32);
+  }
+
+  InstructionCost getShuffleCost(TTI::ShuffleKind Kind, VectorType *Ty,
+                                 ArrayRef<int> Mask,
+                                 TTI::TargetCostKind CostKind, int Index,
+                                 VectorType *SubTp,
+                                 ArrayRef<const Value *> Args = std::nullopt,
+                                 const Instruction *CxtI = nullptr) const {
+    return TTI::TCC_Free;
+  }
+
+  InstructionCost getVectorInstrCost(unsigned Opcode, Type *Val,
+                                     TTI::TargetCostKind CostKind,
+                                     unsigned Index, Value *Op0,
+                                     Value *Op1) const {
+    return TTI::TCC_Basic;
+  }
+
+  InstructionCost getVectorInstrCost(const Instruction &I, Type *Val,
+                                     TTI::TargetCostKind CostKind,
+                                     unsigned Index) const {
+    return TTI::TCC_Basic;
+  }
+};
+} // namespace
+
 /// FIXME: This is a temporary workaround (should be done by IGC). We should
 /// remove it once that feature is implemented.
-void mlir::triton::intel::SLPVectorizer(llvm::Module &mod, bool trace) {
+mlir::triton::intel::SLPVectorizerStats
+mlir::triton::intel::SLPVectorizer(llvm::Module &mod, bool trace) {
   FunctionAnalysisManager FAM;
   FAM.registerPass([&] { return ScalarEvolutionAnalysis(); });
-  FAM.registerPass([&] { return TargetIRAnalysis(); });
+  FAM.registerPass([&] {
+    return TargetIRAnalysis([](const Function &F) {
+      return TargetTransformInfo(XeTTIImpl(F.getDataLayout()));
+    });
+  });
   FAM.registerPass([&] { return TargetLibraryAnalysis(); });
   FAM.registerPass([&] { return LoopAnalysis(); });
   FAM.registerPass([&] { return DominatorTreeAnalysis(); });
@@ -15489,11 +15625,13 @@ void mlir::triton::intel::SLPVectorizer(llvm::Module &mod, bool trace) {
     return AA;
   });
 
+  SLPVectorizerStats stats;
   FunctionPassManager FPM;
-  FPM.addPass(SLPVectorizerPass(trace));
+  FPM.addPass(SLPVectorizerPass(trace, stats));
 
   for (llvm::Function &function : mod.functions()) {
     if (isCandidate(function))
       FPM.run(function, FAM);
   }
+  return stats;
 }
@@ -1,6 +1,10 @@
 #include "intel/include/Analysis/DPAS.h"
 #include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
 #include "intel/include/TritonAnnotateModule/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "triton/Dialect/Triton/IR/Types.h"
 
 namespace mlir::triton::gpu::intel {
 #define GEN_PASS_DEF_TRITONANNOTATEMODULE
@@ -32,6 +36,10 @@ struct TritonAnnotateModule
       mod->setAttr(intel::TritonIntelGPUDialect::getSupportDPASAttrName(),
                    builder.getUnitAttr());
 
+    if (supportFP8DPAS)
+      mod->setAttr(intel::TritonIntelGPUDialect::getSupportFP8DPASAttrName(),
+                   builder.getUnitAttr());
+
     if (supportBF16Conversion)
       mod->setAttr(
           intel::TritonIntelGPUDialect::getSupportBF16ConversionAttrName(),
@@ -39,9 +47,53 @@ struct TritonAnnotateModule
 
     DPASAnalysis &dpasAnalysis = getAnalysis<DPASAnalysis>();
     setThreadsPerWarp(mod, dpasAnalysis);
+
+    // Record the pipeline decision, so that the lowering of this kernel does
+    // not depend on the one of the other kernels of the process.
+    bool useAdvancedPath = advancedPath && supportSG2DBlock && supportDPAS &&
+                           isAdvancedPathApplicable(mod, dpasAnalysis);
+    mod->setAttr(intel::TritonIntelGPUDialect::getAdvancedPathAttrName(),
+                 builder.getBoolAttr(useAdvancedPath));
   }
 
 private:
+  /// Return whether the advanced path can compile the kernel: all its
+  /// functions have dots lowered to DPAS instructions, its loops have at most
+  /// two dots, its tensor loads and stores use block pointers, and its tensor
+  /// operations are among the ones handled by the warp-level pipeline.
+  bool isAdvancedPathApplicable(ModuleOp mod,
+                                const DPASAnalysis &dpasAnalysis) const {
+    auto isTensorType = [](Type type) { return isa<RankedTensorType>(type); };
+    auto isSupported = [](Operation *op) {
+      if (isa<arith::ArithDialect, math::MathDialect>(op->getDialect()))
+        return true;
+      if (isa<triton::LoadOp, triton::StoreOp>(op))
+        return triton::isTensorPointerType(op->getOperand(0).getType());
+      return isa<triton::MakeTensorPtrOp, triton::AdvanceOp, triton::DotOp,
+                 triton::ReduceOp, triton::SplatOp, triton::BroadcastOp,
+                 triton::ExpandDimsOp, triton::MakeRangeOp, scf::ForOp,
+                 scf::YieldOp>(op);
+    };
+
+    WalkResult result = mod.walk([&](Operation *op) {
+      if (auto funcOp = dyn_cast<FunctionOpInterface>(op))
+        return dpasAnalysis.canUseDPAS(funcOp) == DPASAnalysis::Result::True
+                   ? WalkResult::advance()
+                   : WalkResult::interrupt();
+      if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+        auto dots = forOp.getOps<triton::DotOp>();
+        if (std::distance(dots.begin(), dots.end()) > 2)
+          return WalkResult::interrupt();
+      }
+      if (llvm::none_of(op->getOperandTypes(), isTensorType) &&
+          llvm::none_of(op->getResultTypes(), isTensorType) &&
+          !isa<triton::LoadOp, triton::StoreOp>(op))
+        return WalkResult::advance();
+      return isSupported(op) ? WalkResult::advance() : WalkResult::interrupt();
+    });
+    return !result.wasInterrupted();
+  }
+
   void setThreadsPerWarp(ModuleOp &mod,
                          const DPASAnalysis &dpasAnalysis) const {
     Builder builder(mod);
@@ -68,10 +120,35 @@ private:
       return WalkResult::advance();
     });
 
-    // If the threads per warp attribute was not set, use the option value.
+    // If the threads per warp attribute was not set, use the option value or
+    // select it automatically.
     if (!mod->hasAttr(AttrNumThreadsPerWarp))
       mod->setAttr(AttrNumThreadsPerWarp,
-                   builder.getI32IntegerAttr(threadsPerWarp));
+                   builder.getI32IntegerAttr(
+                       threadsPerWarp ? threadsPerWarp
+                                      : getAutoThreadsPerWarp(mod)));
+  }
+
+  // Select the subgroup size of a kernel that doesn't use DPAS instructions.
+  // Wider subgroups issue half the instructions for the same amount of data,
+  // which favors memory bound (e.g. elementwise, reduction or softmax)
+  // kernels. However, when the kernel's tensors cannot distribute at least one
+  // element to each lane of a 32-wide subgroup, the additional lanes hold
+  // replicated data, so use 16 lanes instead.
+  unsigned getAutoThreadsPerWarp(ModuleOp mod) const {
+    constexpr unsigned wideSGSize = 32;
+    constexpr unsigned narrowSGSize = 16;
+    if (minSGSize > narrowSGSize)
+      return wideSGSize;
+
+    int64_t maxNumElems = 0;
+    mod.walk([&](Operation *op) {
+      for (Type type : op->getResultTypes())
+        if (auto tensorTy = dyn_cast<RankedTensorType>(type))
+          maxNumElems = std::max(maxNumElems, tensorTy.getNumElements());
+    });
+
+    return maxNumElems >= numWarps * wideSGSize ? wideSGSize : narrowSGSize;
   }
 };
 
@@ -28,6 +28,7 @@
 #include "mlir/Target/LLVMIR/TypeToLLVM.h"
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ModRef.h"
@@ -150,10 +151,28 @@ createGenISASubGroupReduce(TritonGEN::SubGroupReduceOp op, Value val,
   auto kind =
       rewriter.create<LLVM::ConstantOp>(loc, i8_ty, getKindVal(op.getKind()));
 
-  std::string funcName =
-      "llvm.genx.GenISA.WaveAll." + getGenISATypeMangling(val.getType());
-  SmallVector<Type> argTypes = {val.getType(), i8_ty, i32_ty};
-  SmallVector<Value> args = {val, kind, i32_val(0)};
+  // The interleaved reductions reduce the lanes of a block of
+  // `size * interleave` lanes which are equal modulo `interleave`, over the
+  // whole subgroup if the block spans it.
+  std::string funcName = "llvm.genx.GenISA.WaveAll.";
+  SmallVector<Type> argTypes = {val.getType(), i8_ty};
+  SmallVector<Value> args = {val, kind};
+  if (unsigned interleave = op.getInterleave(); interleave > 1) {
+    unsigned clusterSize = op.getSize() * interleave;
+    if (clusterSize == getSubgroupSize(op)) {
+      funcName = "llvm.genx.GenISA.WaveInterleave.";
+    } else {
+      funcName = "llvm.genx.GenISA.WaveClusteredInterleave.";
+      argTypes.push_back(i32_ty);
+      args.push_back(i32_val(clusterSize));
+    }
+    argTypes.push_back(i32_ty);
+    args.push_back(i32_val(interleave));
+  }
+  funcName += getGenISATypeMangling(val.getType());
+  // The helper lanes mode.
+  argTypes.push_back(i32_ty);
+  args.push_back(i32_val(0));
 
   auto inaccessibleMemOnly = rewriter.getAttr<LLVM::MemoryEffectsAttr>(
       /*other=*/LLVM::ModRefInfo::NoModRef,
@@ -166,58 +185,6 @@ createGenISASubGroupReduce(TritonGEN::SubGroupReduceOp op, Value val,
                                   args, {}, funcAttrs);
 }
 
-static SmallVector<Attribute>
-loadCacheControlToDecoration(Builder &builder, uint32_t operandNum,
-                             TritonGEN::LoadCacheControl orig) {
-  const auto build = [&builder,
-                      operandNum](TritonGEN::LoadCacheControlDecorationEnum l1,
-                                  TritonGEN::LoadCacheControlDecorationEnum l3)
-      -> SmallVector<Attribute> {
-    return {builder.getAttr<TritonGEN::LoadCacheControlDecorationAttr>(
-                0, l1, operandNum),
-            builder.getAttr<TritonGEN::LoadCacheControlDecorationAttr>(
-                1, l3, operandNum)};
-  };
-
-  switch (orig) {
-  case TritonGEN::LoadCacheControl::DEFAULT:
-    return {};
-  case TritonGEN::LoadCacheControl::L1UC_L3UC:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Uncached,
-                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
-  case TritonGEN::LoadCacheControl::L1UC_L3C:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Uncached,
-                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
-  case TritonGEN::LoadCacheControl::L1C_L3UC:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Cached,
-                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
-  case TritonGEN::LoadCacheControl::L1C_L3C:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Cached,
-                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
-  case TritonGEN::LoadCacheControl::L1S_L3UC:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Streaming,
-                 TritonGEN::LoadCacheControlDecorationEnum::Uncached);
-  case TritonGEN::LoadCacheControl::L1S_L3C:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::Streaming,
-                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
-  case TritonGEN::LoadCacheControl::L1IAR_L3C:
-    return build(TritonGEN::LoadCacheControlDecorationEnum::InvalidateAfterRead,
-                 TritonGEN::LoadCacheControlDecorationEnum::Cached);
-  }
-  llvm_unreachable("Unhandled case");
-}
-
-static std::optional<TritonGEN::DecorationCacheControlAttr>
-loadCacheControlToCacheControls(Builder &builder,
-                                TritonGEN::LoadCacheControl orig,
-                                uint32_t operandNum) {
-  SmallVector<Attribute> decorations =
-      loadCacheControlToDecoration(builder, operandNum, orig);
-  if (decorations.empty())
-    return {};
-  return builder.getAttr<TritonGEN::DecorationCacheControlAttr>(decorations);
-}
-
 static bool isOCLBuiltinAvailable(TritonGEN::Matrix2DBlockLoadOp op) {
   VectorType resTy = op.getRes().getType();
   unsigned resElemTySize = resTy.getElementType().getIntOrFloatBitWidth();
@@ -249,6 +216,68 @@ static bool isOCLBuiltinAvailable(TritonGEN::Matrix2DBlockLoadOp op) {
   return false;
 }
 
+//===----------------------------------------------------------------------===//
+// Lowering Selection
+//===----------------------------------------------------------------------===//
+
+/// The lowering of an operation which has both an OpenCL builtin and a GenISA
+/// intrinsic.
+enum class GenLowering { Builtin, GenISA };
+
+/// Returns true if TRITONGEN_FORCE_GENISA=1 selects the GenISA intrinsics for
+/// all the operations which have one, for debugging.
+static bool forceGenISA() {
+  return tools::getBoolEnv("TRITONGEN_FORCE_GENISA");
+}
+
+/// Returns the lowering of \p op. The targets with 2D block messages (PVC and
+/// Xe2) have the same builtins, and the other ones never get these operations,
+/// so the lowering only depends on the operation: the builtins are portable
+/// across IGC versions and let IGC optimize across them, they are used
+/// wherever they cover the operation, and the intrinsics otherwise.
+static GenLowering getLowering(Operation *op) {
+  if (forceGenISA())
+    return GenLowering::GenISA;
+  return TypeSwitch<Operation *, GenLowering>(op)
+      // The builtins only cover some of the tile shapes and element types.
+      .Case([](TritonGEN::Matrix2DBlockLoadOp op) {
+        return isOCLBuiltinAvailable(op) ? GenLowering::Builtin
+                                         : GenLowering::GenISA;
+      })
+      // The intrinsic prefetches the 64 bytes rows with a single message, with
+      // TRITON_INTEL_ENABLE_FAST_PREFETCH=1.
+      // There are no builtins for the interleaved reductions.
+      .Case([](TritonGEN::SubGroupReduceOp op) {
+        return op.getInterleave() > 1 ? GenLowering::GenISA
+                                      : GenLowering::Builtin;
+      })
+      .Case([](TritonGEN::Matrix2DBlockPrefetchOp op) {
+        bool fullRow =
+            (op.getElemSizeInBits() == 8 && op.getTileWidth() == 64) ||
+            (op.getElemSizeInBits() == 16 && op.getTileWidth() == 32);
+        if (fullRow && tools::getBoolEnv("TRITON_INTEL_ENABLE_FAST_PREFETCH"))
+          return GenLowering::GenISA;
+        return GenLowering::Builtin;
+      })
+      .Default([](Operation *) { return GenLowering::Builtin; });
+}
+
+/// Returns true if the 2D block load \p op should be lowered through an
+/// address payload. The payload is created once and only its block offsets are
+/// updated, which lets LICM and DSE hoist and reuse it across loop iterations.
+/// This is the default, it can be disabled by setting
+/// TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT=0. The payload reads have no cache
+/// control, so loads requesting one use the regular lowering.
+static bool useAddressPayload(TritonGEN::Matrix2DBlockLoadOp op) {
+  std::optional<bool> enabled = tools::isEnvValueBool(
+      tools::getStrEnv("TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT"));
+  if (!enabled.value_or(true))
+    return false;
+  if (op.getCacheControl() != TritonGEN::LoadCacheControl::DEFAULT)
+    return false;
+  return forceGenISA() || isOCLBuiltinAvailable(op);
+}
+
 static Value createGenISA2DBlockRead(TritonGEN::Matrix2DBlockLoadOp op,
                                      ConversionPatternRewriter &rewriter) {
   MLIRContext *ctx = rewriter.getContext();
@@ -443,63 +472,9 @@ createBlock2DReadWithAddressPayloadUpdate(TritonGEN::Matrix2DBlockLoadOp op,
   Value ptr = createBlock2DAddressPayload(op);
   setBlock2DAddressPayload(ptr, op);
 
-  // TODO: Remove GenISA lowering after PoC productization is completed.
-  char *env = std::getenv("TRITONGEN_FORCE_GENISA");
-  const bool useGenISA = env ? (bool)std::atoi(env) : false;
-  return (useGenISA) ? createBlock2DReadGenISA(ptr, op)
-                     : createBlock2DRead(ptr, op);
-}
-
-static SmallVector<Attribute>
-storeCacheControlToDecoration(Builder &builder, uint32_t operandNum,
-                              TritonGEN::StoreCacheControl orig) {
-  const auto build = [&builder,
-                      operandNum](TritonGEN::StoreCacheControlDecorationEnum l1,
-                                  TritonGEN::StoreCacheControlDecorationEnum l3)
-      -> SmallVector<Attribute> {
-    return {builder.getAttr<TritonGEN::StoreCacheControlDecorationAttr>(
-                0, l1, operandNum),
-            builder.getAttr<TritonGEN::StoreCacheControlDecorationAttr>(
-                1, l3, operandNum)};
-  };
-
-  switch (orig) {
-  case TritonGEN::StoreCacheControl::DEFAULT:
-    return {};
-  case TritonGEN::StoreCacheControl::L1UC_L3UC:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::Uncached,
-                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
-  case TritonGEN::StoreCacheControl::L1UC_L3WB:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::Uncached,
-                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
-  case TritonGEN::StoreCacheControl::L1WT_L3UC:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteThrough,
-                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
-  case TritonGEN::StoreCacheControl::L1WT_L3WB:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteThrough,
-                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
-  case TritonGEN::StoreCacheControl::L1S_L3UC:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::Streaming,
-                 TritonGEN::StoreCacheControlDecorationEnum::Uncached);
-  case TritonGEN::StoreCacheControl::L1S_L3WB:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::Streaming,
-                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
-  case TritonGEN::StoreCacheControl::L1WB_L3WB:
-    return build(TritonGEN::StoreCacheControlDecorationEnum::WriteBack,
-                 TritonGEN::StoreCacheControlDecorationEnum::WriteBack);
-  }
-  llvm_unreachable("Unhandled case");
-}
-
-static std::optional<TritonGEN::DecorationCacheControlAttr>
-storeCacheControlToCacheControls(Builder &builder,
-                                 TritonGEN::StoreCacheControl orig,
-                                 uint32_t operandNum) {
-  SmallVector<Attribute> decorations =
-      storeCacheControlToDecoration(builder, operandNum, orig);
-  if (decorations.empty())
-    return {};
-  return builder.getAttr<TritonGEN::DecorationCacheControlAttr>(decorations);
+  return getLowering(op) == GenLowering::GenISA
+             ? createBlock2DReadGenISA(ptr, op)
+             : createBlock2DRead(ptr, op);
 }
 
 static LLVM::CallOp
@@ -827,7 +802,8 @@ struct TritonSubGroupReduceLowering
     SmallVector<Value> args{val};
     bool useCluster = (getSubgroupSize(op) != op.getSize());
 
-    if (tools::getBoolEnv("TRITONGEN_FORCE_GENISA") && !useCluster) {
+    if (getLowering(op) == GenLowering::GenISA &&
+        (!useCluster || op.getInterleave() > 1)) {
       Value result = createGenISASubGroupReduce(op, val, rewriter).getResult();
       result = TritonSubGroupBase::truncate(op, result, origTy, rewriter);
       rewriter.replaceOp(op, result);
@@ -991,6 +967,8 @@ private:
       return 2;
     case TritonGEN::PrecisionType::U8:
     case TritonGEN::PrecisionType::S8:
+    case TritonGEN::PrecisionType::BF8:
+    case TritonGEN::PrecisionType::HF8:
       return 4;
     default:
       llvm_unreachable("unsupported TritonGEN::PrecisionType");
@@ -1006,16 +984,14 @@ struct TritonMatrix2DBlockLoadLowering
   LogicalResult
   matchAndRewrite(TritonGEN::Matrix2DBlockLoadOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    if (tools::getBoolEnv("TRITON_INTEL_ENABLE_ADDRESS_PAYLOAD_OPT")) {
+    if (useAddressPayload(op)) {
       LLVM::CallOp callOp =
           createBlock2DReadWithAddressPayloadUpdate(op, rewriter);
       rewriter.replaceOp(op, callOp);
       return success();
     }
 
-    // TODO: Remove GenISA lowering after PoC productization is completed.
-    if (tools::getBoolEnv("TRITONGEN_FORCE_GENISA") ||
-        !isOCLBuiltinAvailable(op)) {
+    if (getLowering(op) == GenLowering::GenISA) {
       rewriter.replaceOp(op, createGenISA2DBlockRead(op, rewriter));
       return success();
     }
@@ -1061,8 +1037,8 @@ struct TritonMatrix2DBlockLoadLowering
                                  paramAttrs, noUnwindWillReturnAttrs);
     constexpr uint32_t ptrOperandIndex = 0;
     if (std::optional<TritonGEN::DecorationCacheControlAttr> optCacheControls =
-            loadCacheControlToCacheControls(rewriter, op.getCacheControl(),
-                                            ptrOperandIndex)) {
+            TritonGEN::loadCacheControlToCacheControls(
+                rewriter, op.getCacheControl(), ptrOperandIndex)) {
       call->setAttr(TritonGEN::TritonGENDialect::getCacheControlsAttrName(),
                     *optCacheControls);
     }
@@ -1080,8 +1056,7 @@ struct TritonMatrix2DBlockStoreLowering
   LogicalResult
   matchAndRewrite(TritonGEN::Matrix2DBlockStoreOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    // TODO: Remove GenISA lowering after PoC productization is completed.
-    if (tools::getBoolEnv("TRITONGEN_FORCE_GENISA")) {
+    if (getLowering(op) == GenLowering::GenISA) {
       rewriter.replaceOp(op, createGenISA2DBlockWrite(op, rewriter));
       return success();
     }
@@ -1129,8 +1104,8 @@ struct TritonMatrix2DBlockStoreLowering
                                  paramAttrs, noUnwindWillReturnAttrs);
     constexpr uint32_t ptrOperandIndex = 0;
     if (std::optional<TritonGEN::DecorationCacheControlAttr> optCacheControls =
-            storeCacheControlToCacheControls(rewriter, op.getCacheControl(),
-                                             ptrOperandIndex)) {
+            TritonGEN::storeCacheControlToCacheControls(
+                rewriter, op.getCacheControl(), ptrOperandIndex)) {
       call->setAttr(TritonGEN::TritonGENDialect::getCacheControlsAttrName(),
                     *optCacheControls);
     }
@@ -1148,13 +1123,7 @@ struct TritonMatrix2DBlockPrefetchLowering
   LogicalResult
   matchAndRewrite(TritonGEN::Matrix2DBlockPrefetchOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    // TODO: Remove GenISA lowering after PoC productization is completed.
-    bool useGenISA = tools::getBoolEnv("TRITONGEN_FORCE_GENISA");
-    if (tools::getBoolEnv("TRITON_INTEL_ENABLE_FAST_PREFETCH") &&
-        ((op.getElemSizeInBits() == 8 && op.getTileWidth() == 64) ||
-         (op.getElemSizeInBits() == 16 && op.getTileWidth() == 32)))
-      useGenISA = true;
-    if (useGenISA) {
+    if (getLowering(op) == GenLowering::GenISA) {
       rewriter.replaceOp(op, createGenISA2DBlockPrefetch(op, rewriter));
       return success();
     }
@@ -1190,8 +1159,8 @@ struct TritonMatrix2DBlockPrefetchLowering
         rewriter, fnName, void_ty(ctx), argTypes, args, paramAttrs, funcAttrs);
     constexpr uint32_t ptrOperandIndex = 0;
     if (std::optional<TritonGEN::DecorationCacheControlAttr> optCacheControls =
-            loadCacheControlToCacheControls(rewriter, op.getCacheControl(),
-                                            ptrOperandIndex)) {
+            TritonGEN::loadCacheControlToCacheControls(
+                rewriter, op.getCacheControl(), ptrOperandIndex)) {
       call->setAttr(TritonGEN::TritonGENDialect::getCacheControlsAttrName(),
                     *optCacheControls);
     }
@@ -1222,7 +1191,10 @@ static std::string getSIMDBlockManglingName(OpType op, VectorType vecTy) {
       std::to_string(ptrTy.getAddressSpace()) +
       intel::getTypeMangling(vecTy.getElementType(), /*isUnsigned=*/true);
   if constexpr (isWrite)
-    funcName += intel::getTypeMangling(vecTy, /*isUnsigned=*/true);
+    funcName += numElems == 1
+                    ? intel::getTypeMangling(vecTy.getElementType(),
+                                             /*isUnsigned=*/true)
+                    : intel::getTypeMangling(vecTy, /*isUnsigned=*/true);
   return funcName;
 }
 
@@ -1244,10 +1216,16 @@ struct TritonSIMDBlockReadLowering
         /*inaccessibleMem=*/LLVM::ModRefInfo::NoModRef);
     auto funcAttrs = noUnwindWillReturnAttrs;
     funcAttrs.memEffectsAttr = memAttr;
+    // Single element reads return a scalar.
+    Type resTy =
+        vecTy.getNumElements() == 1 ? vecTy.getElementType() : Type(vecTy);
     LLVM::CallOp call = createDeviceFunctionCall(
-        rewriter, funcName, vecTy, {ptrTy}, {op.getPtr()}, {}, funcAttrs, {});
+        rewriter, funcName, resTy, {ptrTy}, {op.getPtr()}, {}, funcAttrs, {});
 
-    rewriter.replaceOp(op, call.getResult());
+    Value res = call.getResult();
+    if (resTy != vecTy)
+      res = rewriter.create<LLVM::BitcastOp>(op.getLoc(), vecTy, res);
+    rewriter.replaceOp(op, res);
     return success();
   }
 };
@@ -1272,9 +1250,14 @@ struct TritonSIMDBlockWriteLowering
         /*inaccessibleMem=*/LLVM::ModRefInfo::NoModRef);
     auto funcAttrs = noUnwindWillReturnAttrs;
     funcAttrs.memEffectsAttr = memAttr;
+    // Single element writes take a scalar.
+    Value val = op.getVal();
+    if (vecTy.getNumElements() == 1)
+      val = rewriter.create<LLVM::BitcastOp>(op.getLoc(),
+                                             vecTy.getElementType(), val);
     LLVM::CallOp call = createDeviceFunctionCall(
-        rewriter, funcName, void_ty(ctx), {ptrTy, vecTy},
-        {op.getPtr(), op.getVal()}, {}, funcAttrs);
+        rewriter, funcName, void_ty(ctx), {ptrTy, val.getType()},
+        {op.getPtr(), val}, {}, funcAttrs);
 
     rewriter.replaceOp(op, call);
     return success();
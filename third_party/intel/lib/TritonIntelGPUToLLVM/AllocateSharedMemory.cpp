@@ -1,5 +1,6 @@
 
 #include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
 #include "intel/include/TritonIntelGPUToLLVM/Passes.h"
 #include "mlir/Dialect/LLVMIR/LLVMTypes.h"
 #include "triton/Analysis/Allocation.h"
@@ -24,7 +25,19 @@ struct AllocateSharedMemory
     MLIRContext *ctx = &getContext();
     ModuleAllocation allocation(mod);
 
+    IntegerAttr globalScratchAttr = mod->getAttrOfType<IntegerAttr>(
+        triton::gpu::intel::TritonIntelGPUDialect::
+            getGlobalScratchSizeAttrName());
+    bool hasGlobalScratch = globalScratchAttr && globalScratchAttr.getInt();
     mod.walk([&](FunctionOpInterface funcOp) {
+      // The global scratch of the launch is passed before the SLM buffer,
+      // which stays the last argument of the kernel.
+      if (allocation.isRoot(funcOp) && hasGlobalScratch) {
+        LLVM::LLVMPointerType ptrTy = LLVM::LLVMPointerType::get(
+            ctx, triton::TritonGEN::TritonGENMemorySpace::kCrossWorkgroup);
+        funcOp.insertArgument(funcOp.getNumArguments(), ptrTy, {},
+                              funcOp.getLoc());
+      }
       if (allocation.isRoot(funcOp) && allocation.getSharedMemorySize()) {
         LLVM::LLVMPointerType ptrTy = LLVM::LLVMPointerType::get(
             ctx, triton::TritonGEN::TritonGENMemorySpace::kWorkgroup);
@@ -53,10 +66,37 @@ struct AllocateSharedMemory
     if (IntegerAttr sharedAttr =
             mod->getAttrOfType<IntegerAttr>("triton_gpu.shared"))
       initialSharedMemorySize = sharedAttr.getInt();
+    int32_t sharedMemorySize =
+        initialSharedMemorySize + allocation.getSharedMemorySize();
     mod->setAttr("triton_gpu.shared",
-                 IntegerAttr::get(IntegerType::get(ctx, 32),
-                                  initialSharedMemorySize +
-                                      allocation.getSharedMemorySize()));
+                 IntegerAttr::get(IntegerType::get(ctx, 32), sharedMemorySize));
+    reportWorkGroupsPerXeCore(mod, sharedMemorySize);
+  }
+
+private:
+  // Record how many workgroups fit on an Xe-core given their SLM footprint
+  // and the hardware threads they use (one per sub-group).
+  void reportWorkGroupsPerXeCore(ModuleOp mod, unsigned sharedMemorySize) {
+    if (slmSizePerXeCore == 0 || threadsPerXeCore == 0)
+      return;
+
+    unsigned numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+    unsigned workGroupsByThreads = threadsPerXeCore / numWarps;
+    unsigned workGroupsBySLM = sharedMemorySize
+                                   ? slmSizePerXeCore / sharedMemorySize
+                                   : workGroupsByThreads;
+    unsigned workGroups = std::min(workGroupsByThreads, workGroupsBySLM);
+    mod->setAttr(
+        triton::gpu::intel::TritonIntelGPUDialect::
+            getWorkGroupsPerXeCoreAttrName(),
+        IntegerAttr::get(IntegerType::get(mod.getContext(), 32), workGroups));
+
+    if (workGroupsBySLM < targetWorkGroupsPerXeCore &&
+        workGroupsBySLM < workGroupsByThreads)
+      mod.emitWarning() << "SLM footprint of " << sharedMemorySize
+                        << " bytes limits occupancy to " << workGroups
+                        << " workgroup(s) per Xe-core (expected "
+                        << targetWorkGroupsPerXeCore << ")";
   }
 };
 
@@ -9,6 +9,7 @@
 #include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
 #include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "triton/Tools/Sys/GetEnv.hpp"
 
 using ::mlir::LLVM::getSharedMemoryObjectFromStruct;
 using ::mlir::LLVM::getStridesFromShapeAndOrder;
@@ -446,13 +447,107 @@ private:
   const triton::intel::TargetInfo &targetInfo;
 };
 
+// Shared local memory (SLM) geometry used by the bank conflict model: each
+// cycle serves one 4-byte word per bank.
+constexpr unsigned slmNumBanks = 64;
+constexpr unsigned slmBankWidthInBytes = 4;
+
+// XOR swizzle of the SLM offsets used to move data between registers. The
+// offset is split into a column (the fastest varying dimension of the
+// replication shape) and a row. Groups of `vec` columns are xor'ed with the
+// phase `(row / perPhase) % maxPhase`, the same scheme used by the shared
+// encoding. Vector accesses of at most `vec` elements stay contiguous.
+struct SLMSwizzle {
+  unsigned vec = 1;
+  unsigned perPhase = 1;
+  unsigned maxPhase = 1;
+
+  int32_t apply(int32_t offset, unsigned numCols) const {
+    int32_t row = offset / numCols;
+    int32_t phase = (row / perPhase) % maxPhase;
+    return offset ^ (phase * vec);
+  }
+};
+
+// Return the number of SLM cycles needed by one vector access of `vec`
+// elements of `elemBytes` bytes by every lane of a sub-group, given the
+// (swizzled) element offset accessed by each lane.
+static unsigned getSLMAccessCycles(ArrayRef<int32_t> laneOffsets, unsigned vec,
+                                   unsigned elemBytes) {
+  SmallVector<llvm::SmallDenseSet<int32_t>> wordsPerBank(slmNumBanks);
+  for (int32_t offset : laneOffsets) {
+    unsigned firstByte = offset * elemBytes;
+    unsigned lastByte = firstByte + vec * elemBytes - 1;
+    for (unsigned word = firstByte / slmBankWidthInBytes;
+         word <= lastByte / slmBankWidthInBytes; ++word)
+      wordsPerBank[word % slmNumBanks].insert(word);
+  }
+  unsigned cycles = 1;
+  for (const auto &words : wordsPerBank)
+    cycles = std::max<unsigned>(cycles, words.size());
+  return cycles;
+}
+
+// Return the offset accessed by each lane of the first warp for register 0 of
+// `layout` ([register, lane, warp, block] -> [offset, iteration]).
+static SmallVector<int32_t> getLaneOffsets(MLIRContext *ctx,
+                                           const LinearLayout &layout) {
+  StringAttr kRegister = str_attr("register");
+  StringAttr kLane = str_attr("lane");
+  StringAttr kWarp = str_attr("warp");
+  StringAttr kBlock = str_attr("block");
+  SmallVector<int32_t> offsets;
+  for (int lane = 0; lane < layout.getInDimSize(kLane); ++lane)
+    offsets.push_back(layout
+                          .apply({{kRegister, 0},
+                                  {kLane, lane},
+                                  {kWarp, 0},
+                                  {kBlock, 0}})[0]
+                          .second);
+  return offsets;
+}
+
+// Rewrite `sharedLayout` ([offset, iteration, block] -> tensor dims) so that
+// the physical offset `swizzle.apply(o)` holds the element that was stored at
+// offset `o`. The swizzle is an involution, so this amounts to composing the
+// layout with it.
+static LinearLayout applySLMSwizzle(MLIRContext *ctx,
+                                    const LinearLayout &sharedLayout,
+                                    const SLMSwizzle &swizzle,
+                                    unsigned numCols) {
+  StringAttr kOffset = str_attr("offset");
+  LinearLayout::BasesT bases = sharedLayout.getBases();
+  const auto &offsetBases = sharedLayout.getBases().lookup(kOffset);
+  for (unsigned bit = 0; bit < offsetBases.size(); ++bit) {
+    // Offsets xor'ed into the element stored at offset `1 << bit`.
+    int32_t delta = swizzle.apply(1 << bit, numCols) ^ (1 << bit);
+    std::vector<int32_t> &basis = bases[kOffset][bit];
+    for (unsigned i = 0; i < offsetBases.size(); ++i) {
+      if (!(delta & (1 << i)))
+        continue;
+      for (unsigned dim = 0; dim < basis.size(); ++dim)
+        basis[dim] ^= offsetBases[i][dim];
+    }
+  }
+  SmallVector<std::pair<StringAttr, int32_t>> outDims;
+  for (StringAttr dim : sharedLayout.getOutDimNames())
+    outDims.push_back({dim, sharedLayout.getOutDimSize(dim)});
+  return LinearLayout(std::move(bases), outDims,
+                      /*requireSurjective=*/true);
+}
+
 struct ConvertLayoutOpUsingLinearLayoutsConversion
     : public ConvertOpToLLVMPattern<ConvertLayoutOp> {
   // Set benefit to 2 so that this pattern applies before other convert-layout
   // conversions.  TODO(jlebar): Eventually we want this to be the only pattern.
   explicit ConvertLayoutOpUsingLinearLayoutsConversion(
-      LLVMTypeConverter &typeConverter, PatternBenefit benefit = 2)
-      : ConvertOpToLLVMPattern(typeConverter, benefit) {}
+      LLVMTypeConverter &typeConverter,
+      const triton::intel::TargetInfo &targetInfo, PatternBenefit benefit = 2)
+      : ConvertOpToLLVMPattern(typeConverter, benefit), targetInfo(targetInfo),
+        enableShuffle(triton::tools::getBoolEnv(
+            "TRITON_INTEL_ENABLE_SHUFFLE_CONVERT_LAYOUT")),
+        enableSLMSwizzle(
+            triton::tools::getBoolEnv("TRITON_INTEL_ENABLE_SLM_SWIZZLE")) {}
 
   LogicalResult
   matchAndRewrite(ConvertLayoutOp op, OpAdaptor adaptor,
@@ -495,8 +590,6 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
       return transferWithinLane(op, *srcLayout, *dstLayout, adaptor, rewriter);
     }
 
-    // TODO: match transferWithinBlockOrGroup from
-    // TritonGPUToLLVM/ConvertLayoutOpToLLVM.cpp
     return transferWithinBlockGroup(op, *srcLayout, *dstLayout, adaptor,
                                     rewriter);
   }
@@ -522,7 +615,8 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
     // because not all destination registers are covered.
     // Since the goal is to cover all of the destination
     // registers, we can instead use `dstLayout . srcLayout^-1`.
-    LinearLayout conversion = dstLayout.invertAndCompose(srcLayout);
+    LinearLayout conversion =
+        getLinearLayoutCache(ctx).invertAndCompose(dstLayout, srcLayout);
     auto dstToSrc = conversion.divideRight(
         LinearLayout::identity1D(conversion.getInDimSize(kLane), kLane, kLane) *
         LinearLayout::identity1D(conversion.getInDimSize(kWarp), kWarp, kWarp) *
@@ -548,22 +642,327 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
     return success();
   }
 
+  // Move the values between the lanes of a sub-group with shuffles, skipping
+  // the SLM round-trip and its barriers.
+  //
+  // For each destination register `r`, the source lane and register are given
+  // by the conversion: srcLane = C(r, 0).lane ^ C(0, laneId).lane and
+  // srcReg = C(r, 0).register ^ C(0, laneId).register. All lanes read the same
+  // register of another lane in a shuffle, so when the source register depends
+  // on the lane, one shuffle per distinct `C(0, laneId).register` is emitted
+  // and each lane selects the one it needs.
   LogicalResult transferWithinLane(ConvertLayoutOp op,
                                    const LinearLayout &srcLayout,
                                    const LinearLayout &dstLayout,
                                    OpAdaptor adaptor,
                                    ConversionPatternRewriter &rewriter) const {
-    // TODO(jlebar): Implement me.
-    return failure();
+    if (!enableShuffle)
+      return transferWithinBlockGroup(op, srcLayout, dstLayout, adaptor,
+                                      rewriter);
+
+    MLIRContext *ctx = op.getContext();
+    Location loc = op.getLoc();
+    StringAttr kRegister = str_attr("register");
+    StringAttr kLane = str_attr("lane");
+    StringAttr kWarp = str_attr("warp");
+    StringAttr kBlock = str_attr("block");
+
+    // The shuffles only support integer and floating point values.
+    if (!op.getType().getElementType().isIntOrFloat())
+      return transferWithinBlockGroup(op, srcLayout, dstLayout, adaptor,
+                                      rewriter);
+
+    // Input dims: [register, lane] of the destination.
+    // Output dims: [register, lane] of the source.
+    LinearLayout conversion =
+        getLinearLayoutCache(ctx).invertAndCompose(dstLayout, srcLayout);
+    std::optional<LinearLayout> laneConversion = conversion.divideRight(
+        LinearLayout::identity1D(conversion.getInDimSize(kWarp), kWarp, kWarp) *
+        LinearLayout::identity1D(conversion.getInDimSize(kBlock), kBlock,
+                                 kBlock));
+    if (!laneConversion)
+      return failure();
+
+    auto applyConversion = [&](int32_t reg, int32_t lane) {
+      int32_t srcReg = 0, srcLane = 0;
+      for (auto [dim, value] :
+           laneConversion->apply({{kRegister, reg}, {kLane, lane}})) {
+        if (dim == kRegister)
+          srcReg = value;
+        else if (dim == kLane)
+          srcLane = value;
+      }
+      return std::make_pair(srcReg, srcLane);
+    };
+
+    // Registers read depending on the lane: the shuffles needed per register.
+    SmallVector<int32_t> laneRegs;
+    for (int32_t lane = 0; lane < laneConversion->getInDimSize(kLane); ++lane) {
+      int32_t reg = applyConversion(0, lane).first;
+      if (!llvm::is_contained(laneRegs, reg))
+        laneRegs.push_back(reg);
+    }
+    // Beyond a few shuffles per register going through SLM is cheaper.
+    constexpr unsigned maxShufflesPerRegister = 4;
+    if (laneRegs.size() > maxShufflesPerRegister)
+      return transferWithinBlockGroup(op, srcLayout, dstLayout, adaptor,
+                                      rewriter);
+
+    Value threadId = getThreadId(rewriter, loc);
+    Value threadsPerWarp = i32_val(srcLayout.getInDimSize(kLane));
+    Value laneId = urem(threadId, threadsPerWarp);
+    auto applyLaneSublayout = [&](StringAttr outDim) {
+      return applyLinearLayout(loc, rewriter,
+                               laneConversion->sublayout({kLane}, {outDim}),
+                               {{kLane, laneId}})[0]
+          .second;
+    };
+    Value srcLaneBase = applyLaneSublayout(kLane);
+    Value srcRegBase =
+        laneRegs.size() > 1 ? applyLaneSublayout(kRegister) : Value();
+
+    SmallVector<Value> inVals =
+        unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    SmallVector<Value> outVals(laneConversion->getInDimSize(kRegister));
+    for (unsigned reg = 0; reg < outVals.size(); ++reg) {
+      auto [srcReg, srcLane] = applyConversion(reg, 0);
+      Value srcLaneId = xor_(srcLaneBase, i32_val(srcLane));
+      Value outVal;
+      for (int32_t laneReg : laneRegs) {
+        Value shuffled = targetInfo.shuffleIdx(
+            rewriter, loc, inVals[srcReg ^ laneReg], srcLaneId);
+        outVal = outVal ? select(icmp_eq(srcRegBase, i32_val(laneReg)),
+                                 shuffled, outVal)
+                        : shuffled;
+      }
+      outVals[reg] = outVal;
+    }
+
+    Value result =
+        packLLElements(loc, getTypeConverter(), outVals, rewriter, op.getType());
+    rewriter.replaceOp(op, result);
+    return success();
   }
 
+  // Move the values through SLM. Unlike the legacy lowering, which pads the
+  // rows of the scratch buffer, the SLM offsets are swizzled: the vector width
+  // of the stores and loads and the swizzle pattern are chosen to minimize the
+  // number of SLM cycles given the bank conflicts of each access.
   LogicalResult
   transferWithinBlockGroup(ConvertLayoutOp op, const LinearLayout &srcLayout,
                            const LinearLayout &dstLayout, OpAdaptor adaptor,
                            ConversionPatternRewriter &rewriter) const {
-    // TODO(jlebar): Implement me.
-    return failure();
+    if (!enableSLMSwizzle)
+      return failure();
+
+    LinearLayout conversion = getLinearLayoutCache(op.getContext())
+                                  .invertAndCompose(srcLayout, dstLayout);
+    if (isCrossCTAConversion(conversion))
+      return failure();
+
+    RankedTensorType srcTy = op.getSrc().getType();
+    RankedTensorType dstTy = op.getType();
+    std::function<bool(Attribute)> layoutIsOK = [&](Attribute layout) {
+      if (isa<BlockedEncodingAttr, DpasEncodingAttr>(layout))
+        return true;
+      if (auto slice = dyn_cast<SliceEncodingAttr>(layout))
+        return layoutIsOK(slice.getParent());
+      return false;
+    };
+    if (!layoutIsOK(srcTy.getEncoding()) || !layoutIsOK(dstTy.getEncoding()))
+      return failure();
+
+    // Leave pointers, sub-byte integers and the FP8 types requiring 4-element
+    // vectors to the legacy lowering.
+    Type elemTy = srcTy.getElementType();
+    if (!elemTy.isIntOrFloat() || elemTy.getIntOrFloatBitWidth() < 8 ||
+        isa<Float8E4M3B11FNUZType, Float8E4M3FNType>(elemTy))
+      return failure();
+
+    assert(cvtNeedsSharedMemory(srcTy, dstTy));
+
+    MLIRContext *ctx = op.getContext();
+    Location loc = op.getLoc();
+    StringAttr kRegister = str_attr("register");
+    StringAttr kLane = str_attr("lane");
+    StringAttr kWarp = str_attr("warp");
+    StringAttr kBlock = str_attr("block");
+    StringAttr kOffset = str_attr("offset");
+    StringAttr kIteration = str_attr("iteration");
+
+    SmallVector<Value> inVals =
+        unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    assert(!inVals.empty());
+
+    ScratchConfig scratchConfig = getScratchConfigForCvt(srcTy, dstTy);
+    auto tensorShape = convertType<unsigned, int64_t>(dstTy.getShape());
+    // Input dims: [offset, iteration, block]
+    LinearLayout sharedLayout = chooseShemLayoutForRegToRegConversion(
+        ctx, tensorShape, scratchConfig.repShape, scratchConfig.order);
+    unsigned numCols = scratchConfig.repShape[scratchConfig.order[0]];
+    unsigned colBits = llvm::Log2_32(numCols);
+    unsigned rowBits = sharedLayout.getInDimSizeLog2(kOffset) - colBits;
+
+    // Search the vector widths and swizzle minimizing the SLM cycles. Every
+    // candidate swizzle is linear, so a lane of the swizzled layout accesses
+    // the swizzled offset of the same lane of the unswizzled layout.
+    SmallVector<int32_t> storeOffsets =
+        getLaneOffsets(ctx, srcLayout.invertAndCompose(sharedLayout));
+    SmallVector<int32_t> loadOffsets =
+        getLaneOffsets(ctx, dstLayout.invertAndCompose(sharedLayout));
+    unsigned elemBytes = elemTy.getIntOrFloatBitWidth() / 8;
+    unsigned numOutRegs = dstLayout.getInDimSize(kRegister);
+    auto getCycles = [&](const SLMSwizzle &swizzle, unsigned inVec,
+                         unsigned outVec) {
+      SmallVector<int32_t> swizzledStores, swizzledLoads;
+      for (int32_t offset : storeOffsets)
+        swizzledStores.push_back(swizzle.apply(offset, numCols));
+      for (int32_t offset : loadOffsets)
+        swizzledLoads.push_back(swizzle.apply(offset, numCols));
+      return getSLMAccessCycles(swizzledStores, inVec, elemBytes) *
+                 (inVals.size() / inVec) +
+             getSLMAccessCycles(swizzledLoads, outVec, elemBytes) *
+                 (numOutRegs / outVec);
+    };
+
+    SLMSwizzle bestSwizzle;
+    unsigned bestInVec = scratchConfig.inVec, bestOutVec = scratchConfig.outVec;
+    unsigned bestCycles = getCycles(bestSwizzle, bestInVec, bestOutVec);
+    for (unsigned inVec = scratchConfig.inVec; inVec >= 1; inVec /= 2) {
+      for (unsigned outVec = scratchConfig.outVec; outVec >= 1; outVec /= 2) {
+        SLMSwizzle swizzle;
+        swizzle.vec = std::max(inVec, outVec);
+        unsigned vecBits = llvm::Log2_32(swizzle.vec);
+        for (unsigned perPhaseBits = 0; perPhaseBits < rowBits;
+             ++perPhaseBits) {
+          for (unsigned maxPhaseBits = 0;
+               vecBits + maxPhaseBits <= colBits &&
+               perPhaseBits + maxPhaseBits <= rowBits;
+               ++maxPhaseBits) {
+            swizzle.perPhase = 1 << perPhaseBits;
+            swizzle.maxPhase = 1 << maxPhaseBits;
+            unsigned cycles = getCycles(swizzle, inVec, outVec);
+            if (cycles < bestCycles) {
+              bestCycles = cycles;
+              bestSwizzle = swizzle;
+              bestInVec = inVec;
+              bestOutVec = outVec;
+            }
+          }
+        }
+      }
+    }
+    sharedLayout = applySLMSwizzle(ctx, sharedLayout, bestSwizzle, numCols);
+    // Input dims: [reg, lane, warp], output dims: [offset, iteration]
+    LinearLayout shmemStoreLayout = srcLayout.invertAndCompose(sharedLayout);
+    LinearLayout shmemLoadLayout = dstLayout.invertAndCompose(sharedLayout);
+    assert(shmemStoreLayout.getOutDimSize(kOffset) <=
+           getNumScratchElements(scratchConfig.paddedRepShape));
+    // Each thread does the same reads and writes to SLM on each iteration,
+    // just with different input/output registers.
+    assert(shmemStoreLayout.sublayoutIsZero({kLane, kWarp, kBlock},
+                                            {kIteration}));
+    assert(
+        shmemLoadLayout.sublayoutIsZero({kLane, kWarp, kBlock}, {kIteration}));
+
+    SmallVector<SmallVector<int>> inRegsForIter =
+        collectRegsForIter(ctx, shmemStoreLayout);
+    SmallVector<SmallVector<int>> outRegsForIter =
+        collectRegsForIter(ctx, shmemLoadLayout);
+
+    Value threadId = getThreadId(rewriter, loc);
+    Value threadsPerWarp = i32_val(srcLayout.getInDimSize(kLane));
+    Value laneId = urem(threadId, threadsPerWarp);
+    Value warpId = udiv(threadId, threadsPerWarp);
+
+    Value smemBase =
+        LLVM::intel::getSharedMemoryBase(loc, rewriter, op.getOperation());
+    auto sharedPtrTy = ptr_ty(ctx, 3);
+    Type llvmElemTy = inVals[0].getType();
+
+    // L(r, t, w, b) = L(0, t, w, b) xor L(r, 0, 0, 0)
+    //   offset      =    regBase   xor    regIdx
+    auto getVecAddr = [&](const LinearLayout &layout, Value regBase,
+                          int regSlice) -> Value {
+      int32_t regIdx = layout
+                           .apply({{kRegister, regSlice},
+                                   {kLane, 0},
+                                   {kWarp, 0},
+                                   {kBlock, 0}})[0]
+                           .second;
+      Value offset = xor_(regBase, i32_val(regIdx));
+      auto vecAddr = gep(sharedPtrTy, llvmElemTy, smemBase, offset);
+      vecAddr.setInbounds(true);
+      return vecAddr;
+    };
+    auto getBase = [&](const LinearLayout &layout) {
+      return applyLinearLayout(loc, rewriter, layout,
+                               {{kRegister, i32_val(0)},
+                                {kLane, laneId},
+                                {kWarp, warpId},
+                                {kBlock, i32_val(0)}})[0]
+          .second;
+    };
+    Value storeBase = getBase(shmemStoreLayout);
+    Value loadBase = getBase(shmemLoadLayout);
+
+    unsigned iterations = sharedLayout.getInDimSize(kIteration);
+    SmallVector<Value> outVals(numOutRegs);
+    for (unsigned i = 0; i < iterations; ++i) {
+      if (i != 0)
+        barrier();
+
+      ArrayRef<int> inRegs = inRegsForIter[i];
+      for (unsigned j = 0; j < inRegs.size(); j += bestInVec) {
+        int inRegSlice = inRegs[j];
+        Value vecAddr = getVecAddr(shmemStoreLayout, storeBase, inRegSlice);
+        Value valsVec = packLLVector(
+            loc, ArrayRef(inVals).slice(inRegSlice, bestInVec), rewriter);
+        targetInfo.storeDShared(rewriter, loc, vecAddr, std::nullopt, valsVec,
+                                /*pred=*/true_val());
+      }
+
+      barrier();
+
+      ArrayRef<int> outRegs = outRegsForIter[i];
+      for (unsigned j = 0; j < outRegs.size(); j += bestOutVec) {
+        int outRegSlice = outRegs[j];
+        Value vecAddr = getVecAddr(shmemLoadLayout, loadBase, outRegSlice);
+        Value valsVec = targetInfo.loadDShared(
+            rewriter, loc, vecAddr, std::nullopt,
+            vec_ty(llvmElemTy, bestOutVec), /*pred=*/true_val());
+        for (Value v : unpackLLVector(loc, valsVec, rewriter))
+          outVals[outRegSlice++] = v;
+      }
+    }
+
+    Value result =
+        packLLElements(loc, getTypeConverter(), outVals, rewriter, dstTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+  // Determine which registers are read/written in which iteration of the SLM
+  // transfer specified by `layout`.
+  SmallVector<SmallVector<int> /*registers*/>
+  collectRegsForIter(MLIRContext *ctx, const LinearLayout &layout) const {
+    StringAttr kRegister = str_attr("register");
+    StringAttr kIteration = str_attr("iteration");
+    LinearLayout sublayout = layout.sublayout({kRegister}, {kIteration});
+    SmallVector<SmallVector<int>> ret(sublayout.getOutDimSize(kIteration));
+    for (int reg = 0; reg < sublayout.getInDimSize(kRegister); reg++) {
+      auto idx = sublayout.apply({{kRegister, reg}});
+      ret[idx.begin()->second].push_back(reg);
+    }
+    return ret;
   }
+
+private:
+  const triton::intel::TargetInfo &targetInfo;
+  /// The opt-in lowerings, read when the pattern is created so that the
+  /// conversion does not query the environment.
+  const bool enableShuffle;
+  const bool enableSLMSwizzle;
 };
 
 } // namespace
@@ -576,7 +975,7 @@ void mlir::triton::intel::populateConvertLayoutOpToLLVMPatterns(
   // Eventually the LL conversion will subsume all of the others and be the only
   // one left.
   patterns.add<gpu::ConvertLayoutOpUsingLinearLayoutsConversion>(
-      typeConverter, benefit.getBenefit() + 1);
+      typeConverter, targetInfo, benefit.getBenefit() + 1);
   patterns.add<gpu::ConvertLayoutOpConversion>(typeConverter, targetInfo,
                                                benefit);
 }
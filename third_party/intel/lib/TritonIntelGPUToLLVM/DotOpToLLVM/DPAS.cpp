@@ -89,6 +89,13 @@ public:
       Type bTy = vec_ty(i32Ty, elemNumB / opsPerChannel); // pack scalar to i32.
       return {cTy, cTy, aTy, bTy};
     }
+    case DPASEngineType::FP32_FP32_BF8_BF8:
+    case DPASEngineType::FP32_FP32_HF8_HF8: {
+      Type cTy = vec_ty(fp32Ty, elemNumC);
+      Type aTy = vec_ty(i16Ty, elemNumA / 2);             // pack 2 fp8 to i16.
+      Type bTy = vec_ty(i32Ty, elemNumB / opsPerChannel); // pack scalar to i32.
+      return {cTy, cTy, aTy, bTy};
+    }
     default:
       llvm::report_fatal_error("Unsupported dpas type found");
     }
@@ -217,6 +224,8 @@ private:
       return 4;
     case TritonGEN::PrecisionType::U8:
     case TritonGEN::PrecisionType::S8:
+    case TritonGEN::PrecisionType::BF8:
+    case TritonGEN::PrecisionType::HF8:
       return 8;
     case TritonGEN::PrecisionType::BF16:
     case TritonGEN::PrecisionType::FP16:
@@ -332,6 +341,10 @@ private:
         return TritonGEN::PrecisionType::BF16;
       if (isa<Float16Type>(elemType))
         return TritonGEN::PrecisionType::FP16;
+      if (elemType.isFloat8E5M2())
+        return TritonGEN::PrecisionType::BF8;
+      if (elemType.isFloat8E4M3FN())
+        return TritonGEN::PrecisionType::HF8;
     } else if (width == 8) {
       return elemType.isUnsignedInteger() ? TritonGEN::PrecisionType::U8
                                           : TritonGEN::PrecisionType::S8;
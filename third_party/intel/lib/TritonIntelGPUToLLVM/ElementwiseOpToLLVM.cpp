@@ -1,9 +1,12 @@
 #include "PatternTritonGPUOpToLLVM.h"
+#include "intel/include/Analysis/Uniformity.h"
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
 #include "mlir/Conversion/ArithCommon/AttrToLLVMConverter.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/MLIRContext.h"
 #include "third_party/intel/include/Dialect/TritonIntelGPU/Transforms/Utility.h"
 #include "triton/Conversion/TritonGPUToLLVM/TargetInfoBase.h"
+#include "llvm/ADT/StringSwitch.h"
 
 namespace {
 static SmallVector<Value> identity_func(Location loc,
@@ -408,77 +411,40 @@ Fp16_to_Fp8E4M3B15_func(Location loc, ConversionPatternRewriter &rewriter,
 // has more than a single NaN values.
 
 // Fp8E4M3 -> Fp16 (packed)
+// The exponent and significand bits of a fp8e4 value shifted right by one land
+// in the exponent and significand fields of a fp16 value, which is then the
+// original value scaled by 2^(7-15), for normal and subnormal numbers alike.
+// The scale is undone exactly with one packed multiplication, which avoids the
+// per element table lookup required to renormalize subnormal numbers.
 static SmallVector<Value>
 Fp8E4M3Nv_to_Fp16_func(Location loc, ConversionPatternRewriter &rewriter,
                        const SmallVector<Value> &v) {
   auto fp8x4VecTy = vec_ty(i8_ty, 4);
-  Value a0 = undef(fp8x4VecTy);
-  a0 = insert_element(fp8x4VecTy, a0, int_val(8, 0), i32_val(0));
-  a0 = insert_element(fp8x4VecTy, a0, v[0], i32_val(1));
-  a0 = insert_element(fp8x4VecTy, a0, int_val(8, 0), i32_val(2));
-  a0 = insert_element(fp8x4VecTy, a0, v[1], i32_val(3));
-  a0 = bitcast(a0, i32_ty);
-
-  Value b0 = and_(i32_ty, a0, i32_val(0x7fff7fff));
-
-  b0 = lshr(i32_ty, b0, i32_val(1));
-
-  Value c0 = and_(i32_ty, b0, i32_val(0xffff0000));
-  Value c1 = shl(i32_ty, b0, i32_val(16));
-
-  // Check if the exponent is zero, i.e. subnormal number.
-  // fp8e4 has a bias of 7
-  // depending on the significand value normalization goes like:
-  //  [000] -> 0x0
-  //  [001] -> exp=15-9, sig=0x0
-  //  [010] -> exp=15-8, sig=0x0
-  //  [011] -> exp=15-8, sig=b100...
-  //  [100] -> exp=15-7, sig=0x0
-  //  [101] -> exp=15-7, sig=b010...
-  //  [110] -> exp=15-7, sig=b100...
-  //  [111] -> exp=15-7, sig=b110...
-  Value cmp0 = icmp_eq(and_(c0, i32_val(0x7c000000)), i32_val(0));
-  Value cmp1 = icmp_eq(and_(c1, i32_val(0x7c000000)), i32_val(0));
-
-  auto i32x8VecTy = vec_ty(i32_ty, 8);
-  Value predefined = undef(i32x8VecTy);
-  predefined = insert_element(i32x8VecTy, predefined, i32_val(0x0), i32_val(0));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x18000000), i32_val(1));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x1C000000), i32_val(2));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x1E000000), i32_val(3));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x20000000), i32_val(4));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x21000000), i32_val(5));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x22000000), i32_val(6));
-  predefined =
-      insert_element(i32x8VecTy, predefined, i32_val(0x23000000), i32_val(7));
-
-  Value predef_idx0 = lshr(and_(c0, i32_val(7 << 23)), i32_val(23));
-  Value predef_idx1 = lshr(and_(c1, i32_val(7 << 23)), i32_val(23));
-
-  Value normalized0 = extract_element(i32_ty, predefined, predef_idx0);
-  Value normalized1 = extract_element(i32_ty, predefined, predef_idx1);
-
-  Value d0 = add(i32_ty, c0, i32_val(0x20000000));
-  Value d1 = add(i32_ty, c1, i32_val(0x20000000));
-
-  Value res0 = select(cmp0, normalized0, d0);
-  Value res1 = select(cmp1, normalized1, d1);
-
-  Value f0 = or_(i32_ty, res0, lshr(i32_ty, res1, i32_val(16)));
-  Value sign0 = and_(i32_ty, a0, i32_val(0x80008000));
-
   auto fp16x2VecTy = vec_ty(f16_ty, 2);
-  Value fp16x2Vec0 = or_(i32_ty, sign0, f0);
-  fp16x2Vec0 = bitcast(fp16x2Vec0, fp16x2VecTy);
-
-  return {extract_element(f16_ty, fp16x2Vec0, i32_val(0)),
-          extract_element(f16_ty, fp16x2Vec0, i32_val(1))};
+  Value scale = undef(fp16x2VecTy);
+  scale = insert_element(fp16x2VecTy, scale, f16_val(256.0), i32_val(0));
+  scale = insert_element(fp16x2VecTy, scale, f16_val(256.0), i32_val(1));
+
+  SmallVector<Value> res;
+  for (unsigned i = 0; i < v.size(); i += 2) {
+    Value a = undef(fp8x4VecTy);
+    a = insert_element(fp8x4VecTy, a, int_val(8, 0), i32_val(0));
+    a = insert_element(fp8x4VecTy, a, v[i], i32_val(1));
+    a = insert_element(fp8x4VecTy, a, int_val(8, 0), i32_val(2));
+    a = insert_element(fp8x4VecTy, a, v[i + 1], i32_val(3));
+    a = bitcast(a, i32_ty);
+
+    Value sign = and_(i32_ty, a, i32_val(0x80008000));
+    Value nosign =
+        lshr(i32_ty, and_(i32_ty, a, i32_val(0x7f007f00)), i32_val(1));
+    Value scaled = fmul(fp16x2VecTy, bitcast(nosign, fp16x2VecTy), scale);
+    Value fp16x2Vec =
+        bitcast(or_(i32_ty, bitcast(scaled, i32_ty), sign), fp16x2VecTy);
+
+    res.push_back(extract_element(f16_ty, fp16x2Vec, i32_val(0)));
+    res.push_back(extract_element(f16_ty, fp16x2Vec, i32_val(1)));
+  }
+  return res;
 }
 
 // Fp16 -> Fp8E4M3 (packed)
@@ -1039,6 +1005,11 @@ public:
     if (!encoding)
       // encoding not available
       return resultVals;
+    if (!resultVals.empty() &&
+        mlir::triton::gpu::intel::isSubgroupUniform(result, axisAnalysisPass))
+      // the elements of a thread are equal whatever the layout: only the
+      // first one is computed
+      return SmallVector<Value>(resultVals.size(), resultVals.front());
     if (!dyn_cast<BlockedEncodingAttr>(encoding) &&
         !dyn_cast<SliceEncodingAttr>(encoding)) {
       // TODO: constraining the ecndoing type here is necessary for avoiding
@@ -1256,13 +1227,13 @@ struct FpToFpOpConversion
     }
 
     auto undefRounding = static_cast<RoundingMode>(-1);
-    static DenseMap<std::tuple<TypeID, TypeID, RoundingMode>,
-                    std::pair<ConverterT, size_t>>
+    static const DenseMap<std::tuple<TypeID, TypeID, RoundingMode>,
+                          std::pair<ConverterT, size_t>>
         srcMap = {
             // F8 -> F16
             {{F8E4M3B15TyID, F16TyID, undefRounding},
              {Fp8E4M3B15_to_Fp16_func, 4}},
-            {{F8E4M3TyID, F16TyID, undefRounding}, {Fp8E4M3Nv_to_Fp16_func, 2}},
+            {{F8E4M3TyID, F16TyID, undefRounding}, {Fp8E4M3Nv_to_Fp16_func, 4}},
             {{F8E5M2TyID, F16TyID, undefRounding}, {Fp8E5M2_to_Fp16_func, 4}},
             // F16 -> F8
             {{F16TyID, F8E4M3B15TyID, RoundingMode::RTZ},
@@ -1378,15 +1349,62 @@ struct FpToFpOpConversion
   }
 };
 
+static bool supportsBF16Conversion(Operation *op) {
+  return op->getParentOfType<ModuleOp>()->hasAttr(
+      triton::gpu::intel::TritonIntelGPUDialect::
+          getSupportBF16ConversionAttrName());
+}
+
 template <typename OP>
 Value EmitDualBF16ElementwiseOp(Location loc,
                                 ConversionPatternRewriter &rewriter,
+                                Operation *op,
                                 MultipleOperandsRange operands) {
   auto v0 = intel::convertBf16ToFp32(loc, rewriter, operands[0][0]);
   auto v1 = intel::convertBf16ToFp32(loc, rewriter, operands[0][1]);
   auto result = rewriter.create<OP>(loc, f32_ty, v0, v1);
-  auto undefRounding = static_cast<RoundingMode>(-1);
-  return intel::convertFp32ToBf16(loc, rewriter, result, undefRounding);
+  // The conversion instructions round to nearest even, as cheaply as the
+  // emulation truncates.
+  auto rounding = supportsBF16Conversion(op) ? RoundingMode::RTNE
+                                             : static_cast<RoundingMode>(-1);
+  return intel::convertFp32ToBf16(loc, rewriter, result, rounding);
+}
+
+// Emit the binary operation OP on the first two operand pairs at once, as a
+// 2-wide vector operation, so that IGC emits packed half instructions, and
+// converts bf16 operands to f32 (and back) with a single vector conversion.
+// Return no value if the element type is not f16 or bf16 (with conversion
+// instructions), or if there is a single operand pair left.
+template <typename OP>
+SmallVector<Value> EmitPackedElementwiseOp(Location loc,
+                                           ConversionPatternRewriter &rewriter,
+                                           Operation *op, Type elemTy,
+                                           MultipleOperandsRange operands) {
+  if (operands.size() < 2 || !(elemTy.isF16() || elemTy.isBF16()) ||
+      (elemTy.isBF16() && !supportsBF16Conversion(op)))
+    return {};
+
+  auto vecTy = vec_ty(elemTy, 2);
+  auto pack = [&](unsigned idx) {
+    Value vec = undef(vecTy);
+    for (unsigned i = 0; i < 2; ++i)
+      vec = insert_element(vecTy, vec, operands[i][idx], i32_val(i));
+    return vec;
+  };
+  Value lhs = pack(0);
+  Value rhs = pack(1);
+  Value result;
+  if (elemTy.isBF16()) {
+    lhs = intel::convertBf16ToFp32(loc, rewriter, lhs);
+    rhs = intel::convertBf16ToFp32(loc, rewriter, rhs);
+    result = rewriter.create<OP>(loc, vec_ty(f32_ty, 2), lhs, rhs);
+    result =
+        intel::convertFp32ToBf16(loc, rewriter, result, RoundingMode::RTNE);
+  } else {
+    result = rewriter.create<OP>(loc, vecTy, lhs, rhs);
+  }
+  return {extract_element(elemTy, result, i32_val(0)),
+          extract_element(elemTy, result, i32_val(1))};
 }
 
 struct CmpIOpConversion
@@ -1728,13 +1746,19 @@ struct FMulOpConversion
                                    ConversionPatternRewriter &rewriter,
                                    Type elemTy, MultipleOperandsRange operands,
                                    Location loc) const {
+    SmallVector<Value> packed = EmitPackedElementwiseOp<LLVM::FMulOp>(
+        loc, rewriter, op, elemTy, operands);
+    if (!packed.empty())
+      return packed;
+
     auto lhsElemTy = getElementType(op.getLhs());
     auto rhsElemTy = getElementType(op.getRhs());
 
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
     if (lhsAndRhsAreBF16) {
-      return {EmitDualBF16ElementwiseOp<LLVM::FMulOp>(loc, rewriter, operands)};
+      return {
+          EmitDualBF16ElementwiseOp<LLVM::FMulOp>(loc, rewriter, op, operands)};
     }
 
     return {rewriter.create<LLVM::FMulOp>(loc, elemTy, operands[0][0],
@@ -1752,12 +1776,18 @@ struct FAddOpConversion
                                    ConversionPatternRewriter &rewriter,
                                    Type elemTy, MultipleOperandsRange operands,
                                    Location loc) const {
+    SmallVector<Value> packed = EmitPackedElementwiseOp<LLVM::FAddOp>(
+        loc, rewriter, op, elemTy, operands);
+    if (!packed.empty())
+      return packed;
+
     auto lhsElemTy = getElementType(op.getLhs());
     auto rhsElemTy = getElementType(op.getRhs());
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
     if (lhsAndRhsAreBF16) {
-      return {EmitDualBF16ElementwiseOp<LLVM::FAddOp>(loc, rewriter, operands)};
+      return {
+          EmitDualBF16ElementwiseOp<LLVM::FAddOp>(loc, rewriter, op, operands)};
     }
 
     return {rewriter.create<LLVM::FAddOp>(loc, elemTy, operands[0][0],
@@ -1775,12 +1805,18 @@ struct FSubOpConversion
                                    ConversionPatternRewriter &rewriter,
                                    Type elemTy, MultipleOperandsRange operands,
                                    Location loc) const {
+    SmallVector<Value> packed = EmitPackedElementwiseOp<LLVM::FSubOp>(
+        loc, rewriter, op, elemTy, operands);
+    if (!packed.empty())
+      return packed;
+
     auto lhsElemTy = getElementType(op.getLhs());
     auto rhsElemTy = getElementType(op.getRhs());
     bool lhsAndRhsAreBF16 = lhsElemTy.isBF16() && rhsElemTy.isBF16();
 
     if (lhsAndRhsAreBF16) {
-      return {EmitDualBF16ElementwiseOp<LLVM::FSubOp>(loc, rewriter, operands)};
+      return {
+          EmitDualBF16ElementwiseOp<LLVM::FSubOp>(loc, rewriter, op, operands)};
     }
     return {rewriter.create<LLVM::FSubOp>(loc, elemTy, operands[0][0],
                                           operands[0][1])};
@@ -1903,6 +1939,138 @@ struct ExpOpConversionApprox
   }
 };
 
+// Accuracy of the FP32 transcendental functions, selected for the module by
+// the `math_precision` compilation option.
+enum class MathPrecision {
+  // The math library, correctly rounded or within 1 ulp.
+  IEEE,
+  // The OpenCL builtins, within a few ulp.
+  Approx,
+  // The native functions, computed by the math unit of the EUs.
+  Fast
+};
+
+static MathPrecision getMathPrecision(Operation *op) {
+  auto mod = op->getParentOfType<ModuleOp>();
+  auto attr = mod->getAttrOfType<StringAttr>(
+      triton::gpu::intel::TritonIntelGPUDialect::getMathPrecisionAttrName());
+  if (!attr)
+    return MathPrecision::IEEE;
+  return llvm::StringSwitch<MathPrecision>(attr.getValue())
+      .Case("approx", MathPrecision::Approx)
+      .Case("fast", MathPrecision::Fast)
+      .Default(MathPrecision::IEEE);
+}
+
+// Call the FP32 overload of the OpenCL builtin `name`, e.g. "native_exp2".
+static Value callOclBuiltin(ConversionPatternRewriter &rewriter,
+                            Operation *op, Location loc, StringRef name,
+                            Value x) {
+  std::string funcName = ("__spirv_ocl_" + name).str();
+  funcName = "_Z" + std::to_string(funcName.size()) + funcName + "f";
+  Type funcType = getFunctionType(f32_ty, x);
+  LLVM::LLVMFuncOp funcOp =
+      appendOrGetExternFuncOp(rewriter, op, funcName, funcType);
+  auto callOp = rewriter.create<LLVM::CallOp>(loc, funcOp, x);
+  callOp.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return callOp.getResult();
+}
+
+// Lower the FP32 transcendental function `name` (its OpenCL name) of `x` at the
+// given (non IEEE) precision.
+static Value lowerTranscendental(ConversionPatternRewriter &rewriter,
+                                 Operation *op, Location loc, StringRef name,
+                                 Value x, MathPrecision precision) {
+  assert(precision != MathPrecision::IEEE && "expecting a math library call");
+  if (precision == MathPrecision::Approx)
+    return callOclBuiltin(rewriter, op, loc, name, x);
+
+  // There is no native erf, the OpenCL builtin is the fastest available.
+  if (name == "erf")
+    return callOclBuiltin(rewriter, op, loc, name, x);
+  // tanh(x) = 1 - 2 / (exp(2x) + 1), saturating to +/-1 as exp(2x) overflows
+  // or underflows.
+  if (name == "tanh") {
+    const double twoLog2e = 2.8853900817779268;
+    Value e = callOclBuiltin(rewriter, op, loc, "native_exp2",
+                             fmul(f32_ty, x, f32_val(twoLog2e)));
+    Value r = callOclBuiltin(rewriter, op, loc, "native_recip",
+                             fadd(f32_ty, e, f32_val(1.0)));
+    return fsub(f32_ty, f32_val(1.0), fmul(f32_ty, r, f32_val(2.0)));
+  }
+  // exp, exp2, log, log2, rsqrt, sqrt, sin and cos have a native function.
+  return callOclBuiltin(rewriter, op, loc, ("native_" + name).str(), x);
+}
+
+// Lower a FP32 math dialect function at the precision selected for the module,
+// falling back to the math library (lower benefit patterns) for IEEE.
+template <typename MathOp>
+struct TranscendentalOpConversion
+    : ElementwiseOpConversionBase<MathOp, TranscendentalOpConversion<MathOp>> {
+  using Base =
+      ElementwiseOpConversionBase<MathOp, TranscendentalOpConversion<MathOp>>;
+  using Base::Base;
+  using Adaptor = typename Base::OpAdaptor;
+
+  explicit TranscendentalOpConversion(LLVMTypeConverter &typeConverter,
+                                      ModuleAxisInfoAnalysis &axisAnalysisPass,
+                                      StringRef name, PatternBenefit benefit)
+      : Base::ElementwiseOpConversionBase(typeConverter, axisAnalysisPass,
+                                          benefit),
+        name(name) {}
+
+  SmallVector<Value> createDestOps(MathOp op, Adaptor adaptor,
+                                   ConversionPatternRewriter &rewriter,
+                                   Type elemTy, MultipleOperandsRange operands,
+                                   Location loc) const {
+    MathPrecision precision = getMathPrecision(op);
+    if (!elemTy.isF32() || precision == MathPrecision::IEEE)
+      return {};
+    return {lowerTranscendental(rewriter, op, loc, name, operands[0][0],
+                                precision)};
+  }
+
+private:
+  StringRef name;
+};
+
+// Lower the FP32 libdevice transcendental functions (e.g. `tl.math.tanh`) at
+// the precision selected for the module instead of calling the library.
+struct ExternTranscendentalOpConversion
+    : ElementwiseOpConversionBase<ExternElementwiseOp,
+                                  ExternTranscendentalOpConversion> {
+  using Base = ElementwiseOpConversionBase<ExternElementwiseOp,
+                                           ExternTranscendentalOpConversion>;
+  using Base::Base;
+  using Adaptor = typename Base::OpAdaptor;
+
+  SmallVector<Value> createDestOps(ExternElementwiseOp op, OpAdaptor adaptor,
+                                   ConversionPatternRewriter &rewriter,
+                                   Type elemTy, MultipleOperandsRange operands,
+                                   Location loc) const {
+    MathPrecision precision = getMathPrecision(op);
+    if (!elemTy.isF32() || operands[0].size() != 1 ||
+        precision == MathPrecision::IEEE)
+      return {};
+    // The precise functions (e.g. `__imf_sqrtf`) are left to the library.
+    StringRef name = llvm::StringSwitch<StringRef>(op.getSymbol())
+                         .Case("__imf_expf", "exp")
+                         .Case("__imf_exp2f", "exp2")
+                         .Case("__imf_logf", "log")
+                         .Case("__imf_log2f", "log2")
+                         .Case("__imf_rsqrtf", "rsqrt")
+                         .Case("__imf_sinf", "sin")
+                         .Case("__imf_cosf", "cos")
+                         .Case("__imf_tanhf", "tanh")
+                         .Case("__imf_erff", "erf")
+                         .Default("");
+    if (name.empty())
+      return {};
+    return {lowerTranscendental(rewriter, op, loc, name, operands[0][0],
+                                precision)};
+  }
+};
+
 struct AbsIOpConversion
     : ElementwiseOpConversionBase<math::AbsIOp, AbsIOpConversion> {
   using Base = ElementwiseOpConversionBase<math::AbsIOp, AbsIOpConversion>;
@@ -2114,6 +2282,15 @@ struct MulhiUIOpConversion
     Type resultElementTy = getElementTypeOrSelf(op.getResult().getType());
     assert(resultElementTy.isInteger(32) || resultElementTy.isInteger(64));
 
+    // The high half of the 64-bit product. Unlike a call to __imf_umulhi,
+    // IGC sees through it and lowers it to a mul/mach pair scheduled with
+    // the rest of the computation, e.g. the Philox rounds of tl.rand.
+    if (resultElementTy.isInteger(32)) {
+      Value product = mul(i64_ty, zext(i64_ty, operands[0][0]),
+                          zext(i64_ty, operands[0][1]));
+      return {trunc(i32_ty, lshr(i64_ty, product, i64_val(32)))};
+    }
+
     std::string funcName = targetInfo.getMulhiFuncName(resultElementTy);
     Type funcType = getFunctionType(elemTy, operands[0]);
     LLVM::LLVMFuncOp funcOp =
@@ -2321,6 +2498,25 @@ void populateElementwiseOpToLLVMPatterns(
   // ElementwiseOpConversion<math::ExpOp, math::ExpOp> defined below will call
   // a vendor specific math library for higher-precision calculation
   patterns.add<ExpOpConversionApprox>(typeConverter, axisInfoAnalysis, benefit);
+  // At the precision selected by the `math_precision` option, the FP32
+  // transcendental functions are lowered to OpenCL builtins or native
+  // functions, otherwise these patterns fail and the ones above apply.
+  PatternBenefit benefitForMathPrecision = benefit.getBenefit() + 1;
+#define POPULATE_TRANSCENDENTAL_OP(SRC_OP, NAME)                               \
+  patterns.add<TranscendentalOpConversion<SRC_OP>>(                            \
+      typeConverter, axisInfoAnalysis, NAME, benefitForMathPrecision);
+  POPULATE_TRANSCENDENTAL_OP(math::ExpOp, "exp")
+  POPULATE_TRANSCENDENTAL_OP(math::Exp2Op, "exp2")
+  POPULATE_TRANSCENDENTAL_OP(math::LogOp, "log")
+  POPULATE_TRANSCENDENTAL_OP(math::Log2Op, "log2")
+  POPULATE_TRANSCENDENTAL_OP(math::RsqrtOp, "rsqrt")
+  POPULATE_TRANSCENDENTAL_OP(math::SqrtOp, "sqrt")
+  POPULATE_TRANSCENDENTAL_OP(math::SinOp, "sin")
+  POPULATE_TRANSCENDENTAL_OP(math::CosOp, "cos")
+  POPULATE_TRANSCENDENTAL_OP(math::ErfOp, "erf")
+#undef POPULATE_TRANSCENDENTAL_OP
+  patterns.add<ExternTranscendentalOpConversion>(
+      typeConverter, axisInfoAnalysis, benefitForMathPrecision);
   patterns.add<MulhiUIOpConversion>(typeConverter, axisInfoAnalysis, targetInfo,
                                     benefit);
   patterns.add<ClampFOpConversion>(typeConverter, axisInfoAnalysis, benefit);
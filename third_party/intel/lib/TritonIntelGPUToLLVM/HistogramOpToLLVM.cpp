@@ -5,6 +5,10 @@ using namespace mlir;
 using namespace mlir::triton;
 
 namespace {
+// Maximum number of bins owned by each thread of a warp for which the histogram
+// is computed with vote ballots.
+constexpr int maxBinsPerThreadInWarpHistogram = 8;
+
 static int log2Int(int64_t num) { return (num > 1) ? 1 + log2Int(num / 2) : 0; }
 
 static Value generateVoteBallot(Location loc, Value bit, int threadMask,
@@ -91,17 +95,12 @@ static void atomicAdd(Value ptr, Value val, Location loc,
                                      LLVM::AtomicOrdering::monotonic);
 }
 
-static SmallVector<Value> computeCrossWarpHistogram(
-    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
-    Value baseSharedMemPtr, const SmallVector<Value> &warpLevelHistogram,
-    int numBins, int numThreadPerWarp, const SmallVector<Value> &indices,
-    Value threadId, int numWarps) {
-  SmallVector<Value> histogramValues;
-  unsigned numWarpsWithUniqueData =
-      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
-                                                      srcType.getShape())[0];
-  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
-  // Initialize the shared memory with zeros.
+// Initialize the histogram in shared memory with zeros.
+static void initSharedMemHistogram(Location loc,
+                                   ConversionPatternRewriter &rewriter,
+                                   Value baseSharedMemPtr, int numBins,
+                                   int numThreadPerWarp, Value threadId,
+                                   int numWarps) {
   int64_t numElementPerThread =
       ceil<int64_t>(numBins, numThreadPerWarp * numWarps);
   for (int i = 0; i < numElementPerThread; ++i) {
@@ -111,21 +110,58 @@ static SmallVector<Value> computeCrossWarpHistogram(
         gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
     store(i32_val(0), sharedMemPtr);
   }
+}
+
+// Load the histogram from shared memory to registers with the right layout.
+static SmallVector<Value>
+loadSharedMemHistogram(Location loc, ConversionPatternRewriter &rewriter,
+                       Value baseSharedMemPtr,
+                       const SmallVector<Value> &indices) {
+  SmallVector<Value> histogramValues;
+  for (Value index : indices) {
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, index);
+    Value val = load(i32_ty, sharedMemPtr);
+    histogramValues.push_back(val);
+  }
+  return histogramValues;
+}
+
+// Split the current block and branch to a new block if `cond` holds. Returns
+// the block to continue with once the conditional code is emitted.
+static Block *createConditionalBlock(Location loc,
+                                     ConversionPatternRewriter &rewriter,
+                                     Value cond) {
+  Block *currentBlock = rewriter.getInsertionBlock();
+  Block *afterBlock =
+      rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+  Block *thenBlock = rewriter.createBlock(afterBlock);
+  rewriter.setInsertionPointToEnd(currentBlock);
+  rewriter.create<LLVM::CondBrOp>(loc, cond, thenBlock, afterBlock);
+  rewriter.setInsertionPointToStart(thenBlock);
+  return afterBlock;
+}
+
+static SmallVector<Value> computeCrossWarpHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, const SmallVector<Value> &warpLevelHistogram,
+    int numBins, int numThreadPerWarp, const SmallVector<Value> &indices,
+    Value threadId, int numWarps) {
+  unsigned numWarpsWithUniqueData =
+      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                      srcType.getShape())[0];
+  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
+  initSharedMemHistogram(loc, rewriter, baseSharedMemPtr, numBins,
+                         numThreadPerWarp, threadId, numWarps);
   barrier();
   Block *afterAtomics = nullptr;
   // If some warps have replicated data we need to skip those warps when
   // accumulating.
-  if (numWarpsWithUniqueData < numWarps) {
-    Block *currentBlock = rewriter.getInsertionBlock();
-    afterAtomics =
-        rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
-    Block *atomicBlock = rewriter.createBlock(afterAtomics);
-    rewriter.setInsertionPointToEnd(currentBlock);
-    Value cond =
-        icmp_ult(threadId, i32_val(numWarpsWithUniqueData * numThreadPerWarp));
-    rewriter.create<LLVM::CondBrOp>(loc, cond, atomicBlock, afterAtomics);
-    rewriter.setInsertionPointToStart(atomicBlock);
-  }
+  if (numWarpsWithUniqueData < numWarps)
+    afterAtomics = createConditionalBlock(
+        loc, rewriter,
+        icmp_ult(threadId,
+                 i32_val(numWarpsWithUniqueData * numThreadPerWarp)));
   // Apply atomic add to update the histogram in shared memory.
   for (int i = 0; i < warpLevelHistogram.size(); ++i) {
     Value warpLevelHistogramValue = warpLevelHistogram[i];
@@ -140,14 +176,52 @@ static SmallVector<Value> computeCrossWarpHistogram(
     rewriter.setInsertionPointToStart(afterAtomics);
   }
   barrier();
-  // load the histogram to register with the right layout.
-  for (Value index : indices) {
+  return loadSharedMemHistogram(loc, rewriter, baseSharedMemPtr, indices);
+}
+
+// Compute the histogram by accumulating every element directly into the
+// histogram privatized in shared memory. Unlike the warp level histogram, the
+// cost per element doesn't grow with the number of bins.
+static SmallVector<Value> computeSharedMemHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, SmallVector<Value> &srcValues, int numBins,
+    int numThreadPerWarp, const SmallVector<Value> &indices, Value threadId,
+    int numWarps) {
+  unsigned numThreadWithUniqueData =
+      triton::gpu::getThreadsPerWarpWithUniqueData(srcType.getEncoding(),
+                                                   srcType.getShape())[0];
+  unsigned numWarpsWithUniqueData =
+      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                      srcType.getShape())[0];
+  initSharedMemHistogram(loc, rewriter, baseSharedMemPtr, numBins,
+                         numThreadPerWarp, threadId, numWarps);
+  barrier();
+  // Skip the threads holding replicated data.
+  Block *afterAtomics = nullptr;
+  if (numThreadWithUniqueData < numThreadPerWarp ||
+      numWarpsWithUniqueData < numWarps) {
+    Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
+    Value cond = and_(
+        icmp_ult(laneId, i32_val(numThreadWithUniqueData)),
+        icmp_ult(threadId,
+                 i32_val(numWarpsWithUniqueData * numThreadPerWarp)));
+    afterAtomics = createConditionalBlock(loc, rewriter, cond);
+  }
+  unsigned numElementsPerThreads = triton::gpu::getTotalElemsPerThread(srcType);
+  for (int i = 0; i < numElementsPerThreads; ++i) {
+    // Like the warp level histogram, only the low bits of the value select the
+    // bin.
+    Value offset = and_(srcValues[i], i32_val(numBins - 1));
     Value sharedMemPtr =
-        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, index);
-    Value val = load(i32_ty, sharedMemPtr);
-    histogramValues.push_back(val);
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+    atomicAdd(sharedMemPtr, i32_val(1), loc, rewriter);
   }
-  return histogramValues;
+  if (afterAtomics) {
+    rewriter.create<LLVM::BrOp>(loc, afterAtomics);
+    rewriter.setInsertionPointToStart(afterAtomics);
+  }
+  barrier();
+  return loadSharedMemHistogram(loc, rewriter, baseSharedMemPtr, indices);
 }
 
 struct HistogramOpConversion
@@ -180,15 +254,6 @@ public:
     numBins = std::max(numBins, numThreadsPerWarp);
     Value threadId = getThreadId(rewriter, loc);
     auto srcType = op.getSrc().getType();
-    // First compute a warp local histogram based on values owned by each warps.
-    SmallVector<Value> warpLevelHistogram =
-        computeWarpLevelHistogram(loc, srcType, srcValues, numBins,
-                                  numThreadsPerWarp, threadId, rewriter);
-
-    // Then use atomic to update the histogram in shared memory.
-    // TODO: we could skip this for cases with num_warps=1 as long as we can
-    // generate the right layout. Currently the warp level histogram generates
-    // data in the default blocked layout.
     Value baseSharedMemPtr =
         LLVM::intel::getSharedMemoryBase(loc, rewriter, op.getOperation());
     auto dstType = op.getType();
@@ -200,9 +265,30 @@ public:
     SmallVector<Value> innerDimIndices;
     for (int i = 0; i < indices.size(); ++i)
       innerDimIndices.push_back(indices[i][0]);
-    SmallVector<Value> histogramValue = computeCrossWarpHistogram(
-        loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
-        numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+
+    // The warp level histogram processes every element for each of the bins
+    // owned by a thread. With many bins, accumulating each element directly
+    // into the histogram in shared memory is cheaper.
+    SmallVector<Value> histogramValue;
+    if (numBins / numThreadsPerWarp > maxBinsPerThreadInWarpHistogram) {
+      histogramValue = computeSharedMemHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, srcValues, numBins,
+          numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    } else {
+      // First compute a warp local histogram based on values owned by each
+      // warps.
+      SmallVector<Value> warpLevelHistogram =
+          computeWarpLevelHistogram(loc, srcType, srcValues, numBins,
+                                    numThreadsPerWarp, threadId, rewriter);
+
+      // Then use atomic to update the histogram in shared memory.
+      // TODO: we could skip this for cases with num_warps=1 as long as we can
+      // generate the right layout. Currently the warp level histogram
+      // generates data in the default blocked layout.
+      histogramValue = computeCrossWarpHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram,
+          numBins, numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    }
 
     Value results = packLLElements(loc, typeConverter, histogramValue, rewriter,
                                    op.getType());
@@ -9,6 +9,7 @@
 #include "TargetInfo.h"
 #include "Utility.h"
 
+#include "intel/include/Analysis/Uniformity.h"
 #include "intel/include/Dialect/TritonIntelGPU/IR/Attributes.h"
 #include "intel/include/Dialect/TritonIntelGPU/Transforms/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Attributes.h"
@@ -187,6 +188,88 @@ struct LoadStoreConversionBase {
     return axisAnalysisPass.getMaskAlignment(mask);
   }
 
+  bool isSubgroupUniform(Value value) const {
+    return mlir::triton::gpu::intel::isSubgroupUniform(value,
+                                                       axisAnalysisPass);
+  }
+
+  /// Returns the number of elements each lane accesses with one SIMD block
+  /// read or write of \p ptr, or 0 if \p ptr cannot be accessed with SIMD
+  /// block messages. This requires the lanes of a sub-group to access
+  /// consecutive elements along the contiguous dimension, from an address
+  /// aligned to the sub-group chunk and to \p minAlignment bytes, under a mask
+  /// uniform across the chunk.
+  unsigned getSIMDBlockVectorSize(Value ptr, Value mask,
+                                  unsigned minAlignment) const {
+    auto tensorTy = dyn_cast<RankedTensorType>(ptr.getType());
+    if (!tensorTy)
+      return 0;
+    auto ptrTy = cast<triton::PointerType>(tensorTy.getElementType());
+    unsigned elemNumBits = triton::getPointeeBitWidth(tensorTy);
+    if (ptrTy.getAddressSpace() != 1 ||
+        !llvm::is_contained({8u, 16u, 32u, 64u}, elemNumBits))
+      return 0;
+
+    Attribute layout = tensorTy.getEncoding();
+    std::optional<LinearLayout> ll =
+        triton::gpu::toLinearLayout(tensorTy.getShape(), layout);
+    if (!ll)
+      return 0;
+
+    MLIRContext *ctx = ptr.getContext();
+    unsigned dim = triton::gpu::getOrder(layout)[0];
+    StringAttr kRegister = str_attr("register");
+    StringAttr kLane = str_attr("lane");
+    StringAttr kDim = str_attr("dim" + std::to_string(dim));
+    auto isStrideAlongDim = [&](StringAttr inDim, int pos, int32_t stride) {
+      return llvm::all_of(ll->getOutDimNames(), [&](StringAttr outDim) {
+        int32_t expected = outDim == kDim ? stride : 0;
+        return ll->getBasis(inDim, pos, outDim) == expected;
+      });
+    };
+
+    // Lane i must access the i-th element of the sub-group chunk.
+    unsigned subGroupSize = ll->getInDimSize(kLane);
+    for (int i = 0; i < ll->getInDimSizeLog2(kLane); ++i)
+      if (!isStrideAlongDim(kLane, i, 1 << i))
+        return 0;
+
+    // The chunks must be contiguous in memory, from an aligned address.
+    AxisInfo *axisInfo = axisAnalysisPass.getAxisInfo(ptr);
+    if (!axisInfo)
+      return 0;
+    if (axisInfo->getDivisibility(dim) < minAlignment)
+      return 0;
+    unsigned alignment = axisInfo->getContiguity(dim);
+    if (mask)
+      alignment = std::min(alignment, getMaskAlignment(mask));
+
+    // Consecutive registers accessing consecutive chunks are read or written
+    // together, a block message accesses up to 8 elements per lane.
+    constexpr unsigned maxVecSize = 8;
+    unsigned vec = 1;
+    int numGroupedRegs = 0;
+    while (numGroupedRegs < ll->getInDimSizeLog2(kRegister) &&
+           2 * vec <= maxVecSize && 2 * vec * subGroupSize <= alignment &&
+           isStrideAlongDim(kRegister, numGroupedRegs, vec * subGroupSize)) {
+      vec *= 2;
+      ++numGroupedRegs;
+    }
+    if (vec * subGroupSize > alignment)
+      return 0;
+
+    // Every chunk must start at an aligned offset.
+    for (StringAttr inDim : ll->getInDimNames()) {
+      if (inDim == kLane)
+        continue;
+      int firstPos = inDim == kRegister ? numGroupedRegs : 0;
+      for (int i = firstPos; i < ll->getInDimSizeLog2(inDim); ++i)
+        if (ll->getBasis(inDim, i, kDim) % (vec * subGroupSize) != 0)
+          return 0;
+    }
+    return vec;
+  }
+
 protected:
   ModuleAxisInfoAnalysis &axisAnalysisPass;
   const triton::intel::TargetInfo &targetInfo;
@@ -204,7 +287,9 @@ struct PrefetchOpConversion
                        PatternBenefit benefit)
       : ConvertTritonGPUOpToLLVMPattern<triton::gpu::intel::PrefetchOp>(
             converter, benefit),
-        LoadStoreConversionBase(targetInfo, axisAnalysisPass) {}
+        LoadStoreConversionBase(targetInfo, axisAnalysisPass),
+        enableFastPrefetch(
+            tools::getBoolEnv("TRITON_INTEL_ENABLE_FAST_PREFETCH")) {}
 
   LogicalResult
   matchAndRewrite(triton::gpu::intel::PrefetchOp op, OpAdaptor adaptor,
@@ -276,7 +361,10 @@ struct PrefetchOpConversion
     unsigned tileWidthInElem = shapePerWarp[1];
     unsigned tileHeightInElem = shapePerWarp[0];
     unsigned vBlocks = 1;
-    if (!tools::getBoolEnv("TRITON_INTEL_ENABLE_FAST_PREFETCH")) {
+    TritonGEN::LoadCacheControl cacheControl =
+        LLVM::intel::getLoadCacheControl(op.getCache(), op.getEvict(),
+                                         TritonGEN::LoadCacheControl::L1C_L3C);
+    if (!enableFastPrefetch) {
       switch (elemSizeInBits) {
       case 8:
         if (tileWidthInElem == 64) {
@@ -354,7 +442,7 @@ struct PrefetchOpConversion
             /*tile_width*/ tileWidthInElem,
             /*tile_height*/ tileHeightInElem,
             /*v_blocks*/ vBlocks,
-            /*cache_opt*/ TritonGEN::LoadCacheControl::L1C_L3C);
+            /*cache_opt*/ cacheControl);
         if (failed(newOp.verify())) {
           // Explicitly invoke verifier because `triton_gen` ops are immediately
           // lowered further to a builtin call.
@@ -366,6 +454,9 @@ struct PrefetchOpConversion
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  const bool enableFastPrefetch;
 };
 
 struct LoadOpConversion
@@ -427,6 +518,8 @@ struct LoadOpConversion
     const SmallVector<unsigned> warpsPerCTA = dpasLayout.getWarpsPerCTA();
     SmallVector<unsigned> dpasOrder = triton::gpu::getOrder(dpasLayout);
     int threadsPerWarp = triton::gpu::getWarpSize(dpasLayout);
+    TritonGEN::LoadCacheControl cacheControl =
+        LLVM::intel::getLoadCacheControl(op.getCache(), op.getEvict());
 
     Value warpId = rewriter.create<arith::IndexCastOp>(
         loc, i32_ty,
@@ -495,6 +588,23 @@ struct LoadOpConversion
           offsetBaseY] =
         getValuesFromBlockPointerStruct(adaptor.getPtr(), rewriter);
 
+    // The base address of 2D block loads must be 64-byte aligned. The base of
+    // an indirect block pointer is not known to be aligned, so it is rounded
+    // down, and the offset and size of the contiguous dimension are extended
+    // by the misalignment. The transposing loads address 32-bit elements, so
+    // they are left unchanged.
+    if (op->hasAttr(TritonIntelGPUDialect::getBlockIOIndirectBaseAttrName()) &&
+        !isTransposeRequired) {
+      Value &offset = memoryRowMajor ? offsetBaseX : offsetBaseY;
+      Value &size = memoryRowMajor ? baseWidth : baseHeight;
+      Value baseInt = ptrtoint(i64_ty, base);
+      Value misalignment = and_(baseInt, i64_val(63));
+      base = inttoptr(base.getType(), sub(baseInt, misalignment));
+      Value numElems = udiv(misalignment, i64_val(elemBits / 8));
+      offset = add(offset, trunc(i32_ty, numElems));
+      size = add(size, numElems);
+    }
+
     unsigned tileWidth = elemsPerDPASInst[dotOrder[0]];
     unsigned tileHeight = elemsPerDPASInst[dotOrder[1]];
     unsigned vBlocks = 1;
@@ -505,10 +615,20 @@ struct LoadOpConversion
     if (!isTransposeRequired) {
       numOperandsPer2DLoadM = isOperandA ? repCluster[opIdx] : numReps[!opIdx];
       numOperandsPer2DloadN = isOperandA ? numReps[!opIdx] : repCluster[opIdx];
-    } else {
-      if (isOperandA)
-        return op.emitOpError("Transposing load doesn't support dot A layout.");
+    } else if (isOperandA) {
+      // The transposing load of a column-major A returns, to the lane of each
+      // column k, the 32-bit pairs of consecutive rows of the column, which
+      // are the 16-bit elements of the DPAS A operand of the lane when there
+      // is one column per lane. Load one operand per inst.
+      if (!usePackedType || elemBits != 16 ||
+          elemsPerDPASInst[1] != static_cast<unsigned>(threadsPerWarp))
+        return op.emitOpError("Transposing load doesn't support dot A layout "
+                              "of non 16-bit elements.");
 
+      std::swap(tileHeight, tileWidth);
+      numOperandsPer2DLoadM = 1;
+      numOperandsPer2DloadN = 1;
+    } else {
       if (!usePackedType)
         return op.emitOpError(
             "Transposing load doesn't support un-pack-able dot B layout.");
@@ -555,6 +675,12 @@ struct LoadOpConversion
                                 numOperandsInnerDimPerLoad;
     Type load2DGenXType =
         LLVM::getFixedVectorType(loadResultElemType, numValuesPerLoad);
+    // The transposing load of A returns 32-bit elements, which are bitcast to
+    // the 16-bit elements of the operand.
+    Type load2DResultType =
+        (isTransposeRequired && isOperandA)
+            ? LLVM::getFixedVectorType(i32_ty, numValuesPerLoad / 2)
+            : load2DGenXType;
 
     // The stride for the replicates.
     unsigned repOuterStride = warpShape[opIdx] * outerDimWarpNum;
@@ -610,7 +736,7 @@ struct LoadOpConversion
           }
 
           auto load2dOp = rewriter.create<TritonGEN::Matrix2DBlockLoadOp>(
-              loc, load2DGenXType,
+              loc, load2DResultType,
               /*ptr*/ base,
               /*base_width*/ mul(baseWidth, elemSizeInBytes),
               /*base_height*/ baseHeight,
@@ -624,12 +750,16 @@ struct LoadOpConversion
               /*transpose*/ isTransposeRequired,
               /*vnni_transform*/
               (usePackedType && !isOperandA && !isTransposeRequired &&
-               eltTy.getIntOrFloatBitWidth() != 32));
+               eltTy.getIntOrFloatBitWidth() != 32),
+              /*cache_control*/ cacheControl);
           if (failed(load2dOp.verify())) {
             // Explicitly invoke verifier because `triton_gen` ops are
             // immediately lowered further to a builtin call.
             return failure();
           }
+          Value loadResult = load2dOp;
+          if (load2DResultType != load2DGenXType)
+            loadResult = bitcast(loadResult, load2DGenXType);
 
           unsigned packedRowNum = opIdx == 0 ? numOperandsOuterDimPerLoad
                                              : numOperandsInnerDimPerLoad;
@@ -654,7 +784,7 @@ struct LoadOpConversion
                 }
                 DenseI32ArrayAttr attr = rewriter.getDenseI32ArrayAttr(indices);
                 Value loadVal = rewriter.create<LLVM::ShuffleVectorOp>(
-                    loc, packedDPASOperandType, load2dOp, load2dOp, attr);
+                    loc, packedDPASOperandType, loadResult, loadResult, attr);
 
                 // Save the decomposed vals to the map;
                 if (opIdx == 0) {
@@ -698,6 +828,49 @@ struct LoadOpConversion
     return success();
   }
 
+  /// Loads the elements of \p ptrElems with SIMD block reads of \p vec
+  /// elements per lane. Each read is predicated on the mask of its first
+  /// element, which is uniform across the sub-group.
+  SmallVector<Value> emitSIMDBlockReads(ConversionPatternRewriter &rewriter,
+                                        Location loc, Type valueElemTy,
+                                        unsigned vec, ArrayRef<Value> ptrElems,
+                                        ArrayRef<Value> maskElems,
+                                        ArrayRef<Value> otherElems) const {
+    MLIRContext *ctx = rewriter.getContext();
+    Type intTy = int_ty(valueElemTy.getIntOrFloatBitWidth());
+    VectorType blockTy = vec_ty(intTy, vec);
+    // The block read takes the address of the chunk accessed by lane 0.
+    Value laneId = rewriter.create<TritonGEN::SubgroupLocalIdOp>(loc, i32_ty);
+    Value laneOffset = sub(i32_val(0), laneId);
+
+    SmallVector<Value> loadedVals;
+    for (size_t vecStart = 0; vecStart < ptrElems.size(); vecStart += vec) {
+      Value pred = maskElems.empty() ? int_val(1, 1) : maskElems[vecStart];
+      Value other_ = rewriter.create<LLVM::ConstantOp>(
+          loc, blockTy, rewriter.getZeroAttr(blockTy));
+      if (!otherElems.empty())
+        for (unsigned i = 0; i < vec; ++i)
+          other_ = insert_element(blockTy, other_,
+                                  bitcast(otherElems[vecStart + i], intTy),
+                                  i32_val(i));
+
+      Block &endBlock = LLVM::intel::createPredicatedBlock(
+          rewriter, loc, pred, SmallVector<Value, 1>{other_}, [&]() {
+            Value base = gep(ptr_ty(ctx, 1), intTy,
+                             bitcast(ptrElems[vecStart], ptr_ty(ctx, 1)),
+                             laneOffset);
+            Value ret =
+                rewriter.create<TritonGEN::SIMDBlockReadOp>(loc, blockTy, base);
+            return SmallVector<Value, 1>{ret};
+          });
+      Value ret = *endBlock.args_begin();
+      for (unsigned i = 0; i < vec; ++i)
+        loadedVals.push_back(
+            bitcast(extract_element(intTy, ret, i32_val(i)), valueElemTy));
+    }
+    return loadedVals;
+  }
+
   LogicalResult
   matchAndRewrite(triton::LoadOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -729,6 +902,16 @@ struct LoadOpConversion
     if (llMask)
       vec = std::min<size_t>(vec, getMaskAlignment(mask));
 
+    // Every element of a thread loads the same address when the pointers,
+    // the mask and `other` are uniform across the sub-group: the first element
+    // is loaded once and broadcast to the others.
+    bool isUniformLoad = !op.getIsVolatile() && isSubgroupUniform(ptr) &&
+                         (!mask || isSubgroupUniform(mask)) &&
+                         (!other || isSubgroupUniform(other));
+    unsigned numLoadedElems = isUniformLoad ? 1 : numElems;
+    if (isUniformLoad)
+      vec = 1;
+
     // Get the LLVM values for pointers
     auto ptrElems = unpackLLElements(loc, llPtr, rewriter);
     assert(ptrElems.size() == numElems);
@@ -760,10 +943,33 @@ struct LoadOpConversion
     // vectorized iteration through all the pointer/mask/other elements
     const int valueElemNBits =
         std::max(8u, valueElemTy.getIntOrFloatBitWidth());
-    const int numVecs = numElems / vec;
+    const int numVecs = numLoadedElems / vec;
+
+    std::optional<TritonGEN::DecorationCacheControlAttr> cacheControls =
+        TritonGEN::loadCacheControlToCacheControls(
+            rewriter,
+            LLVM::intel::getLoadCacheControl(op.getCache(), op.getEvict()),
+            /*operandNum=*/0);
+
+    // SIMD block reads carry no cache control, and require a 4 bytes aligned
+    // address.
+    if (unsigned blockVec = isUniformLoad
+                                ? 0
+                                : getSIMDBlockVectorSize(ptr, mask,
+                                                         /*minAlignment=*/4);
+        blockVec && valueElemTy.isIntOrFloat() && !cacheControls) {
+      SmallVector<Value> loadedVals = emitSIMDBlockReads(
+          rewriter, loc, valueElemTy, blockVec, ptrElems, maskElems,
+          otherElems);
+      Type llvmResultStructTy = typeConverter->convertType(op.getType());
+      Value resultStruct = packLLElements(loc, typeConverter, loadedVals,
+                                          rewriter, llvmResultStructTy);
+      rewriter.replaceOp(op, {resultStruct});
+      return success();
+    }
 
     SmallVector<Value> loadedVals;
-    for (size_t vecStart = 0; vecStart < numElems; vecStart += vec) {
+    for (size_t vecStart = 0; vecStart < numLoadedElems; vecStart += vec) {
       // TODO: optimization when ptr is GEP with constant offset
       size_t in_off = 0;
 
@@ -773,7 +979,7 @@ struct LoadOpConversion
       const size_t nWords = std::max<size_t>(1, totalWidth / width);
       const size_t wordNElems = width / valueElemNBits;
       const size_t movWidth = width < 16 ? 16 : width;
-      assert(wordNElems * nWords * numVecs == numElems);
+      assert(wordNElems * nWords * numVecs == numLoadedElems);
 
       Value pred = mask ? maskElems[vecStart] : int_val(1, 1);
 
@@ -819,10 +1025,19 @@ struct LoadOpConversion
       // Create a predicated load operation.
       Block &endBlock = LLVM::intel::createPredicatedBlock(
           rewriter, loc, pred, SmallVector<Value, 1>{other_}, [&]() {
+            // Keep the address space: tensor descriptors are read from
+            // private memory.
+            unsigned addrSpace =
+                cast<LLVM::LLVMPointerType>(ptrElems[vecStart].getType())
+                    .getAddressSpace();
             Value addrElem =
-                bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
+                bitcast(ptrElems[vecStart], ptr_ty(ctx, addrSpace));
             uint32_t alignment = nWords * width / 8;
-            Value ret = load(retTy, addrElem, alignment);
+            auto ret = load(retTy, addrElem, alignment);
+            if (cacheControls)
+              ret->setAttr(
+                  TritonGEN::TritonGENDialect::getCacheControlsAttrName(),
+                  *cacheControls);
             return SmallVector<Value, 1>{ret};
           });
       Value ret = *endBlock.args_begin();
@@ -848,6 +1063,8 @@ struct LoadOpConversion
         loadedVals.push_back(loaded);
       }
     } // end vec
+    if (isUniformLoad)
+      loadedVals.resize(numElems, loadedVals.front());
 
     Type llvmResultStructTy = typeConverter->convertType(op.getType());
     Value resultStruct = packLLElements(loc, typeConverter, loadedVals,
@@ -896,6 +1113,8 @@ struct StoreOpConversion
         dpasLayout.getDPASRepetitions(tensorShape, 2);
     SmallVector<unsigned> order = triton::gpu::getOrder(dpasLayout);
     unsigned threadsPerWarp = triton::gpu::getWarpSize(dpasLayout);
+    TritonGEN::StoreCacheControl cacheControl =
+        LLVM::intel::getStoreCacheControl(op.getCache(), op.getEvict());
 
     Value warpId = rewriter.create<arith::IndexCastOp>(
         loc, i32_ty,
@@ -978,7 +1197,8 @@ struct StoreOpConversion
                 /*tile_width*/ elemsPerInstr[1],
                 /*tile_height*/ elemsPerInstr[0],
                 /*v_blocks*/ 1,
-                /*stored_val*/ bitcast(storeVal, store2DGenXType));
+                /*stored_val*/ bitcast(storeVal, store2DGenXType),
+                /*cache_control*/ cacheControl);
 
             if (failed(newOp.verify())) {
               // Explicitly invoke verifier because `triton_gen` ops are
@@ -993,6 +1213,38 @@ struct StoreOpConversion
     return success();
   }
 
+  /// Stores \p valueElems with SIMD block writes of \p vec elements per
+  /// lane. Each write is predicated on \p mask and the mask of its first
+  /// element, which are uniform across the sub-group.
+  void emitSIMDBlockWrites(ConversionPatternRewriter &rewriter, Location loc,
+                           Type valueElemTy, unsigned vec,
+                           ArrayRef<Value> ptrElems, ArrayRef<Value> valueElems,
+                           ArrayRef<Value> maskElems, Value mask) const {
+    MLIRContext *ctx = rewriter.getContext();
+    Type intTy = int_ty(valueElemTy.getIntOrFloatBitWidth());
+    VectorType blockTy = vec_ty(intTy, vec);
+    // The block write takes the address of the chunk accessed by lane 0.
+    Value laneId = rewriter.create<TritonGEN::SubgroupLocalIdOp>(loc, i32_ty);
+    Value laneOffset = sub(i32_val(0), laneId);
+
+    for (size_t vecStart = 0; vecStart < ptrElems.size(); vecStart += vec) {
+      Value val = undef(blockTy);
+      for (unsigned i = 0; i < vec; ++i)
+        val = insert_element(blockTy, val,
+                             bitcast(valueElems[vecStart + i], intTy),
+                             i32_val(i));
+
+      Value pred = maskElems.empty() ? mask : and_(mask, maskElems[vecStart]);
+      LLVM::intel::createPredicatedBlock(rewriter, loc, pred, [&] {
+        Value base = gep(ptr_ty(ctx, 1), intTy,
+                         bitcast(ptrElems[vecStart], ptr_ty(ctx, 1)),
+                         laneOffset);
+        rewriter.create<TritonGEN::SIMDBlockWriteOp>(loc, base, val);
+        return ArrayRef<Value>();
+      });
+    }
+  }
+
   LogicalResult
   matchAndRewrite(triton::StoreOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -1032,6 +1284,23 @@ struct StoreOpConversion
     }
 
     Value mask = redundantDataMask(valueTy, rewriter, loc, targetInfo);
+    // The pointer is the second operand of 'llvm.store'.
+    std::optional<TritonGEN::DecorationCacheControlAttr> cacheControls =
+        TritonGEN::storeCacheControlToCacheControls(
+            rewriter,
+            LLVM::intel::getStoreCacheControl(op.getCache(), op.getEvict()),
+            /*operandNum=*/1);
+    // SIMD block writes carry no cache control, and require a 16 bytes
+    // aligned address.
+    if (unsigned blockVec = getSIMDBlockVectorSize(ptr, op.getMask(),
+                                                   /*minAlignment=*/16);
+        blockVec && valueElemTy.isIntOrFloat() && !cacheControls) {
+      emitSIMDBlockWrites(rewriter, loc, valueElemTy, blockVec, ptrElems,
+                          valueElems, maskElems, mask);
+      rewriter.eraseOp(op);
+      return success();
+    }
+
     const size_t dtsize =
         std::max<int>(1, valueElemTy.getIntOrFloatBitWidth() / 8);
     const size_t valueElemNBits = dtsize * 8;
@@ -1048,9 +1317,6 @@ struct StoreOpConversion
       const size_t wordNElems = width / valueElemNBits;
       assert(wordNElems * nWords * numVecs == elemsPerThread);
 
-      // TODO(Superjomn) Add cache policy fields to StoreOp.
-      // TODO(Superjomn) Deal with cache policy here.
-
       Type valArgTy = IntegerType::get(ctx, width);
       auto wordTy = vec_ty(valueElemTy, wordNElems);
 
@@ -1088,7 +1354,11 @@ struct StoreOpConversion
       LLVM::intel::createPredicatedBlock(rewriter, loc, maskVal, [&] {
         Value addrElem = bitcast(ptrElems[vecStart], ptr_ty(ctx, 1 /*global*/));
         uint32_t alignment = nWords * width / 8;
-        store(vecWord, addrElem, alignment);
+        auto storeOp = store(vecWord, addrElem, alignment);
+        if (cacheControls)
+          storeOp->setAttr(
+              TritonGEN::TritonGENDialect::getCacheControlsAttrName(),
+              *cacheControls);
         return ArrayRef<Value>();
       });
     } // for
@@ -1103,6 +1373,43 @@ void createBarrier(ConversionPatternRewriter &rewriter, Location loc,
   barrier();
 }
 
+static LLVM::AtomicOrdering getMemoryOrdering(MemSemantic memOrdering) {
+  switch (memOrdering) {
+  case MemSemantic::RELAXED:
+    return LLVM::AtomicOrdering::monotonic;
+  case MemSemantic::ACQUIRE:
+    return LLVM::AtomicOrdering::acquire;
+  case MemSemantic::RELEASE:
+    return LLVM::AtomicOrdering::release;
+  case MemSemantic::ACQUIRE_RELEASE:
+    return LLVM::AtomicOrdering::acq_rel;
+  }
+  llvm_unreachable("Unexpected memory semantic");
+}
+
+// The ordering of a failed cmpxchg, which does not store.
+static LLVM::AtomicOrdering getFailureOrdering(LLVM::AtomicOrdering ordering) {
+  return ordering == LLVM::AtomicOrdering::acquire ||
+                 ordering == LLVM::AtomicOrdering::acq_rel
+             ? LLVM::AtomicOrdering::acquire
+             : LLVM::AtomicOrdering::monotonic;
+}
+
+// Returns the LLVM synchronization scope of an atomic, mapped to the SPIR-V
+// Workgroup, Device and CrossDevice scopes. Narrower scopes let IGC skip the
+// cache flushes needed to synchronize with other Xe-cores or devices.
+static StringRef getSyncScope(MemSyncScope scope) {
+  switch (scope) {
+  case MemSyncScope::CTA:
+    return "workgroup";
+  case MemSyncScope::GPU:
+    return "device";
+  case MemSyncScope::SYSTEM:
+    return "";
+  }
+  llvm_unreachable("Unexpected memory scope");
+}
+
 struct AtomicCASOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::AtomicCASOp>,
       public LoadStoreConversionBase {
@@ -1134,6 +1441,8 @@ struct AtomicCASOpConversion
     auto ptrElements = unpackLLElements(loc, llPtr, rewriter);
     auto cmpElements = unpackLLElements(loc, llCmp, rewriter);
     auto valElements = unpackLLElements(loc, llVal, rewriter);
+    LLVM::AtomicOrdering ordering = getMemoryOrdering(op.getSem());
+    StringRef scope = getSyncScope(op.getScope());
 
     auto valueTy = op.getType();
     auto tensorTy = dyn_cast<RankedTensorType>(valueTy);
@@ -1179,8 +1488,8 @@ struct AtomicCASOpConversion
             casVal = bitcast(casVal, zero.getType());
 
             auto cmpxchg = rewriter.create<LLVM::AtomicCmpXchgOp>(
-                loc, casPtr, casCmp, casVal, LLVM::AtomicOrdering::acq_rel,
-                LLVM::AtomicOrdering::monotonic);
+                loc, casPtr, casCmp, casVal, ordering,
+                getFailureOrdering(ordering), scope);
             Value newLoaded =
                 rewriter.create<LLVM::ExtractValueOp>(loc, cmpxchg, 0);
             return SmallVector<Value, 1>{newLoaded};
@@ -1245,6 +1554,8 @@ struct AtomicRMWOpConversion
     int numCTAs = triton::gpu::TritonGPUDialect::getNumCTAs(moduleOp);
 
     auto atomicRmwAttr = op.getAtomicRmwOp();
+    LLVM::AtomicOrdering ordering = getMemoryOrdering(op.getSem());
+    StringRef scope = getSyncScope(op.getScope());
 
     Value val = op.getVal();
     Value ptr = op.getPtr();
@@ -1269,13 +1580,12 @@ struct AtomicRMWOpConversion
     // vec = 1, numElements = 1 for scalar
     auto vec = getVectorSize(ptr);
     int numElems = 1;
+    // Contiguous pairs of 16-bit floats are added by a single 32-bit atomic.
+    bool packed = tensorTy && valueElemNBits == 16 &&
+                  isa<FloatType>(valueElemTy) && atomicRmwAttr == RMWOp::FADD;
     // tensor
     if (tensorTy) {
-      auto valTy = cast<RankedTensorType>(val.getType());
-      auto maxVecSize =
-          valueElemNBits / valTy.getElementType().getIntOrFloatBitWidth();
-      vec = std::min<unsigned>(vec,
-                               valTy.getElementType().isF16() ? maxVecSize : 1);
+      vec = std::min<unsigned>(vec, packed ? 2 : 1);
       // mask
       numElems = tensorTy.getNumElements();
     }
@@ -1293,6 +1603,23 @@ struct AtomicRMWOpConversion
 
       Value rmwPtr = ptrElements[i];
       Value rmwMask = llMask ? and_(mask, maskElements[i]) : mask;
+      if (vec == 2 && llMask) {
+        // Adding -0.0 leaves the masked out element of the pair unchanged.
+        Value negZero = rewriter.create<LLVM::ConstantOp>(
+            loc, valueElemTy,
+            rewriter.getFloatAttr(
+                valueElemTy,
+                APFloat::getZero(
+                    cast<FloatType>(valueElemTy).getFloatSemantics(),
+                    /*Negative=*/true)));
+        for (int ii = 0; ii < vec; ++ii) {
+          Value iiVal = i32_val(ii);
+          Value elem = select(maskElements[i + ii], valElements[i + ii],
+                              negZero);
+          rmwVal = insert_element(vecTy, rmwVal, elem, iiVal);
+        }
+        rmwMask = and_(mask, or_(maskElements[i], maskElements[i + 1]));
+      }
 
       assert((valueElemNBits == 16 || valueElemNBits == 32 ||
               valueElemNBits == 64) &&
@@ -1303,6 +1630,10 @@ struct AtomicRMWOpConversion
           .Case<mlir::IntegerType>(
               [&](auto ty) { zero = int_val(valueElemNBits, 0); })
           .Case<mlir::Float16Type>([&](auto ty) { zero = f16_val(0); })
+          .Case<mlir::BFloat16Type>([&](auto ty) {
+            zero = rewriter.create<LLVM::ConstantOp>(
+                loc, ty, rewriter.getFloatAttr(ty, 0.0));
+          })
           .Case<mlir::Float32Type>([&](auto ty) { zero = f32_val(0); })
           .Case<mlir::Float64Type>([&](auto ty) { zero = f64_val(0); });
 
@@ -1314,9 +1645,11 @@ struct AtomicRMWOpConversion
             "'tt.atomic_rmw' op fp16 datatype is not supported in the target "
             "HW, software emulation is an experimental feature (use at own "
             "risk)");
-        endBlock =
-            emulateFp16AtomicRmw(rewriter, loc, atomicRmwAttr, valueElemTy,
-                                 rmwPtr, rmwVal, rmwMask, {zero});
+        if (vec == 2)
+          zero = undef(vecTy);
+        endBlock = emulateFp16AtomicRmw(rewriter, loc, atomicRmwAttr,
+                                        valueElemTy, vec, rmwPtr, rmwVal,
+                                        rmwMask, {zero}, ordering, scope);
       } else {
         if (!atomicNeedsSharedMemory(op.getResult()))
           rewriter.create<TritonGEN::BarrierOp>(loc,
@@ -1359,7 +1692,7 @@ struct AtomicRMWOpConversion
 
               rmwVal = bitcast(rmwVal, valueElemTy);
               auto atomRMW = rewriter.create<LLVM::AtomicRMWOp>(
-                  loc, rmwKind, rmwPtr, rmwVal, LLVM::AtomicOrdering::acq_rel);
+                  loc, rmwKind, rmwPtr, rmwVal, ordering, scope);
               return SmallVector<Value, 1>{atomRMW.getRes()};
             });
       }
@@ -1398,11 +1731,17 @@ struct AtomicRMWOpConversion
     return success();
   }
 
-  // Emulate 16-bit atomicrmw through a loop with 32-bit cmpxchg.
+  // Emulate 16-bit atomicrmw through a loop with 32-bit cmpxchg. With `vec`
+  // = 2, `rmwPtr` is 4-byte aligned and `rmwVal` holds the values of the two
+  // 16-bit elements of the 32-bit word, updated at once.
   Block *emulateFp16AtomicRmw(ConversionPatternRewriter &rewriter, Location loc,
                               mlir::triton::RMWOp atomicOp, Type valueElemTy,
-                              Value rmwPtr, Value rmwVal, Value rmwMask,
-                              ArrayRef<Value> ops) const {
+                              unsigned vec, Value rmwPtr, Value rmwVal,
+                              Value rmwMask, ArrayRef<Value> ops,
+                              LLVM::AtomicOrdering ordering,
+                              StringRef scope) const {
+    assert((vec == 1 || atomicOp == RMWOp::FADD) &&
+           "Only FADD updates both elements");
     Block *insertionBlock = rewriter.getInsertionBlock();
     Block *headerBlock =
         rewriter.splitBlock(insertionBlock, rewriter.getInsertionPoint());
@@ -1411,17 +1750,22 @@ struct AtomicRMWOpConversion
     rewriter.create<cf::CondBranchOp>(loc, rmwMask, headerBlock, endBlock, ops);
     rewriter.setInsertionPointToStart(headerBlock);
 
-    rmwVal = bitcast(rmwVal, valueElemTy);
+    Type pairTy = vec_ty(valueElemTy, 2);
+    rmwVal = bitcast(rmwVal, vec == 2 ? pairTy : valueElemTy);
 
     // Align pointer by 4 bytes by zeroing lower address bits. Atomically read
     // a vector of two fp16 values as a single i32. The second lowest bit is
     // extracted to later be used as an index to extract the required vector
     // element.
     assert(isa<LLVM::LLVMPointerType>(rmwPtr.getType()));
-    auto intPtr = ptrtoint(i64_ty, rmwPtr);
-    auto lowPtrBits = and_(intPtr, i64_val(3));
-    auto elemIndex = trunc(i32_ty, lshr(lowPtrBits, i64_val(1)));
-    auto alignPtr = inttoptr(rmwPtr.getType(), sub(intPtr, lowPtrBits));
+    Value elemIndex;
+    Value alignPtr = rmwPtr;
+    if (vec == 1) {
+      auto intPtr = ptrtoint(i64_ty, rmwPtr);
+      auto lowPtrBits = and_(intPtr, i64_val(3));
+      elemIndex = trunc(i32_ty, lshr(lowPtrBits, i64_val(1)));
+      alignPtr = inttoptr(rmwPtr.getType(), sub(intPtr, lowPtrBits));
+    }
     auto firstValInt = load(i32_ty, alignPtr, 4, false, false, false,
                             LLVM::AtomicOrdering::acquire);
 
@@ -1437,8 +1781,9 @@ struct AtomicRMWOpConversion
     rewriter.setInsertionPointToEnd(bodyBlock);
 
     // Extract value for modification.
-    auto origValVec = bitcast(origValInt, vec_ty(valueElemTy, 2));
-    Value origVal = extract_element(origValVec, elemIndex);
+    auto origValVec = bitcast(origValInt, pairTy);
+    Value origVal =
+        vec == 2 ? origValVec : extract_element(origValVec, elemIndex);
 
     // Apply operation.
     Value newVal = nullptr;
@@ -1461,14 +1806,14 @@ struct AtomicRMWOpConversion
 
     // Use modified value to form a new i32 value to write to memory.
     assert(newVal);
-    Value newValVec = insert_element(origValVec, newVal, elemIndex);
+    Value newValVec =
+        vec == 2 ? newVal : insert_element(origValVec, newVal, elemIndex);
     Value newValInt = bitcast(newValVec, i32_ty);
 
     // Execute cmpxchg and loop back if it fails.
-    auto successOrdering = LLVM::AtomicOrdering::acq_rel;
-    auto failureOrdering = LLVM::AtomicOrdering::monotonic;
     auto cmpxchg = rewriter.create<LLVM::AtomicCmpXchgOp>(
-        loc, alignPtr, origValInt, newValInt, successOrdering, failureOrdering);
+        loc, alignPtr, origValInt, newValInt, ordering,
+        getFailureOrdering(ordering), scope);
     auto newLoaded = extract_val(cmpxchg, 0);
     auto done = extract_val(cmpxchg, 1);
     assert(ops.size() == (size_t)1);
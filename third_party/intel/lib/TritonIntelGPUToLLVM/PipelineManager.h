@@ -21,6 +21,7 @@
 #include "mlir/Dialect/SPIRV/IR/TargetAndABI.h"
 #include "mlir/IR/PatternMatch.h"
 
+#include "intel/include/Dialect/TritonIntelGPU/IR/Utils.h"
 #include "intel/include/GPUToTritonGEN/GPUToTritonGENPass.h"
 #include "intel/include/TritonGENToLLVM/TritonGENToLLVMPass.h"
 #include "triton/Analysis/AxisInfo.h"
@@ -93,6 +94,26 @@ struct FuncOpConversion : public ConvertOpToLLVMPattern<triton::FuncOp> {
     return amendedFuncOp;
   }
 
+  /// Map the attribute `tt.nv_tma_desc` to a by-value argument: the XPU
+  /// launcher passes tensor descriptors as a struct of four 64-bit words.
+  static void handleByvalTensorDescArgs(LLVM::LLVMFuncOp funcOp) {
+    MLIRContext *ctx = funcOp.getContext();
+    for (unsigned i = 0; i < funcOp.getNumArguments(); ++i) {
+      if (!funcOp.getArgAttr(i, "tt.nv_tma_desc"))
+        continue;
+      assert(LLVM::isKernel(funcOp) &&
+             "tt.nv_tma_desc is not supported for device functions");
+      Type i64Ty = IntegerType::get(ctx, 64);
+      auto descTy = LLVM::LLVMStructType::getLiteral(
+          ctx, SmallVector<Type>(4, i64Ty));
+      funcOp.removeArgAttr(i, "tt.nv_tma_desc");
+      funcOp.setArgAttr(i, LLVM::LLVMDialect::getByValAttrName(),
+                        TypeAttr::get(descTy));
+      funcOp.setArgAttr(i, LLVM::LLVMDialect::getAlignAttrName(),
+                        IntegerAttr::get(IntegerType::get(ctx, 32), 8));
+    }
+  }
+
   LogicalResult
   matchAndRewrite(triton::FuncOp funcOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -128,6 +149,8 @@ struct FuncOpConversion : public ConvertOpToLLVMPattern<triton::FuncOp> {
       rewriter.eraseOp(amendedFuncOp);
     }
 
+    handleByvalTensorDescArgs(newFuncOp);
+
     // required by AxisInfoAnalysis
     rewriter.eraseOp(funcOp);
     return success();
@@ -181,12 +204,7 @@ class TritonGPUToLLVMPipelineManager {
 public:
   TritonGPUToLLVMPipelineManager(ModuleOp &mod, MLIRContext *ctx)
       : mod(mod), ctx(ctx),
-        isAdvancedPathEnabled(
-            mod->hasAttr(gpu::intel::TritonIntelGPUDialect::
-                             getSupportSG2DBlockAttrName()) &&
-            mod->hasAttr(
-                gpu::intel::TritonIntelGPUDialect::getSupportDPASAttrName()) &&
-            mlir::triton::tools::getBoolEnv("TRITON_INTEL_ADVANCED_PATH")) {}
+        isAdvancedPathEnabled(gpu::intel::isAdvancedPathEnabled(mod)) {}
 
   /// FIXME: remove once the block ptr conversion path is capable of handling
   ///        shared memory.
@@ -271,8 +289,6 @@ private:
   MLIRContext *ctx;
 
   /// Selects which conversion pipeline to use.
-  /// FIXME: this is temporary and should be removed once we have an analysis to
-  /// determine whether a kernel uses block pointers.
   bool isAdvancedPathEnabled = false;
 };
 
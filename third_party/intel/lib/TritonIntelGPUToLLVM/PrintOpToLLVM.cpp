@@ -14,6 +14,11 @@ using namespace mlir::triton;
 //
 // For each operand, we print all of the values contained in this GPU thread,
 // one per line, along with the index of the value in its tensor.
+//
+// When the module has a print buffer (`TRITON_INTEL_PRINT_BUFFER_SIZE`), the
+// values are instead appended as binary records to the buffer, which the host
+// decodes with the formats of the kernel after the launch. This avoids the
+// serialization of device printf, so that prints can be left in hot kernels.
 struct PrintOpConversion
     : public ConvertTritonGPUOpToLLVMPattern<triton::PrintOp> {
   explicit PrintOpConversion(LLVMTypeConverter &typeConverter,
@@ -36,6 +41,14 @@ struct PrintOpConversion
     };
     std::array<Value, 3> pid = {getPid(0), getPid(1), getPid(2)};
 
+    auto mod = op->getParentOfType<ModuleOp>();
+    if (auto bufferSize = mod->getAttrOfType<IntegerAttr>(
+            triton::gpu::intel::printBufferSizeAttrName)) {
+      bufferPrint(op, adaptor, pid, bufferSize.getInt(), rewriter);
+      rewriter.eraseOp(op);
+      return success();
+    }
+
     // Simple printf of a string without any tensors.
     if (op.getNumOperands() == 0) {
       std::string formatStr;
@@ -177,6 +190,141 @@ struct PrintOpConversion
     }
   }
 
+  /// Appends the records of \p op to the print buffer of \p bufferSize bytes,
+  /// one record per operand for each work-item.
+  void bufferPrint(triton::PrintOp op, OpAdaptor adaptor,
+                   std::array<Value, 3> pid, int64_t bufferSize,
+                   ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    auto printId = op->getAttrOfType<IntegerAttr>(
+        triton::gpu::intel::printIdAttrName);
+    assert(printId && "Expecting the print ids to be assigned");
+    Value buffer = getPrintBuffer(rewriter, loc, bufferSize);
+    auto getHeader = [&](unsigned operand) {
+      return SmallVector<Value>{i32_val(printId.getInt()), i32_val(operand),
+                                pid[0], pid[1], pid[2]};
+    };
+
+    if (op.getNumOperands() == 0) {
+      appendRecord(rewriter, loc, buffer, bufferSize, getHeader(0));
+      return;
+    }
+
+    for (size_t i = 0; i < op.getNumOperands(); i++) {
+      bool isSigned = op.getIsSigned()[i] > 0;
+      auto elems = unpackLLElements(loc, adaptor.getOperands()[i], rewriter);
+      if (elems.empty())
+        continue;
+      SmallVector<SmallVector<Value>> indices;
+      if (auto rankedTy =
+              dyn_cast<RankedTensorType>(op.getOperand(i).getType()))
+        indices = ::intel::emitIndices(loc, rewriter, targetInfo,
+                                       rankedTy.getEncoding(), rankedTy, true);
+      else
+        indices.push_back({});
+
+      SmallVector<Value> words = getHeader(i);
+      for (auto [elem, index] : llvm::zip_equal(elems, indices)) {
+        llvm::append_range(words, index);
+        appendValueWords(rewriter, loc, elem, op.getHex(), isSigned, words);
+      }
+      assert(words.size() == triton::gpu::intel::getPrintRecordNumWords(
+                                 op.getOperand(i).getType()) &&
+             "Inconsistent print record size");
+      appendRecord(rewriter, loc, buffer, bufferSize, words);
+    }
+  }
+
+  /// Returns a pointer to the print buffer of \p bufferSize bytes, a zero
+  /// initialized global exported to the host.
+  Value getPrintBuffer(ConversionPatternRewriter &rewriter, Location loc,
+                       int64_t bufferSize) const {
+    MLIRContext *ctx = rewriter.getContext();
+    auto mod = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+    unsigned addrSpace = TritonGEN::TritonGENMemorySpace::kCrossWorkgroup;
+    StringRef name = triton::gpu::intel::printBufferName;
+    if (!mod.lookupSymbol(name)) {
+      RewriterBase::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(mod.getBody());
+      auto globalType = LLVM::LLVMArrayType::get(i32_ty, bufferSize / 4);
+      auto global = rewriter.create<LLVM::GlobalOp>(
+          UnknownLoc::get(ctx), globalType, /*isConstant=*/false,
+          LLVM::Linkage::External, name, /*value=*/Attribute(),
+          /*alignment=*/4, addrSpace);
+      rewriter.createBlock(&global.getInitializerRegion());
+      Value zero = rewriter.create<LLVM::ZeroOp>(loc, globalType);
+      rewriter.create<LLVM::ReturnOp>(loc, zero);
+    }
+    return address_of(ptr_ty(ctx, addrSpace), name);
+  }
+
+  /// Appends the 32-bit words holding \p elem to \p words. Hex values keep
+  /// their bits, other values are extended like printf arguments.
+  void appendValueWords(ConversionPatternRewriter &rewriter, Location loc,
+                        Value elem, bool hex, bool isSigned,
+                        SmallVectorImpl<Value> &words) const {
+    Type type = elem.getType();
+    if (isa<LLVM::LLVMPointerType>(type)) {
+      elem = ptrtoint(i64_ty, elem);
+    } else if (hex || type.isInteger()) {
+      unsigned bitWidth = type.getIntOrFloatBitWidth();
+      if (!type.isInteger())
+        elem = bitcast(elem, int_ty(bitWidth));
+      if (bitWidth < 32)
+        elem = isSigned && !hex ? sext(i32_ty, elem) : zext(i32_ty, elem);
+    } else if (!type.isF64()) {
+      if (!type.isF32())
+        elem = fpext(f32_ty, elem);
+      elem = bitcast(elem, i32_ty);
+    } else {
+      elem = bitcast(elem, i64_ty);
+    }
+    if (elem.getType() == i32_ty) {
+      words.push_back(elem);
+      return;
+    }
+    words.push_back(trunc(i32_ty, elem));
+    words.push_back(trunc(i32_ty, lshr(elem, i64_val(32))));
+  }
+
+  /// Writes the record \p words of each work-item to the print buffer. The
+  /// first lane of the sub-group reserves the space of the records of all the
+  /// lanes with a single atomic. Records not fitting in the buffer are
+  /// dropped, the reserved size still tells the host how much was dropped.
+  void appendRecord(ConversionPatternRewriter &rewriter, Location loc,
+                    Value buffer, int64_t bufferSize,
+                    ArrayRef<Value> words) const {
+    MLIRContext *ctx = rewriter.getContext();
+    auto mod = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+    unsigned threadsPerWarp =
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    unsigned numWords = words.size();
+    auto ptrTy = ptr_ty(ctx, TritonGEN::TritonGENMemorySpace::kCrossWorkgroup);
+
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(threadsPerWarp));
+    Block &reserved = LLVM::intel::createPredicatedBlock(
+        rewriter, loc, icmp_eq(laneId, i32_val(0)),
+        SmallVector<Value, 1>{i32_val(0)}, [&] {
+          Value offset = rewriter.create<LLVM::AtomicRMWOp>(
+              loc, LLVM::AtomicBinOp::add, buffer,
+              i32_val(threadsPerWarp * numWords),
+              LLVM::AtomicOrdering::monotonic);
+          return SmallVector<Value, 1>{offset};
+        });
+    Value offset = LLVM::intel::shuffleIdx(loc, rewriter,
+                                           reserved.getArgument(0), 0);
+    offset = add(offset, mul(laneId, i32_val(numWords)));
+    // The records follow the reserved size.
+    Value end = add(offset, i32_val(numWords + 1));
+    LLVM::intel::createPredicatedBlock(
+        rewriter, loc, icmp_ule(end, i32_val(bufferSize / 4)), [&] {
+          Value base = gep(ptrTy, i32_ty, buffer, add(offset, i32_val(1)));
+          for (auto [i, word] : llvm::enumerate(words))
+            store(word, gep(ptrTy, i32_ty, base, i32_val(i)));
+          return ArrayRef<Value>();
+        });
+  }
+
   std::string getFormatSubstr(Value value, bool hex = false,
                               std::optional<int> width = std::nullopt,
                               bool isSigned = false) const {
@@ -75,6 +75,26 @@ Value TargetInfo::shuffleIdx(RewriterBase &rewriter, Location loc, Value val,
   return LLVM::intel::shuffleIdx(loc, rewriter, val, i);
 }
 
+// Returns the declaration of the OpenCL `size_t get_global_offset(uint)`
+// builtin.
+static LLVM::LLVMFuncOp getGlobalOffsetDeclaration(RewriterBase &rewriter) {
+  auto moduleOp = rewriter.getBlock()->getParent()->getParentOfType<ModuleOp>();
+  StringRef funcName = "_Z17get_global_offsetj";
+  if (Operation *funcOp = moduleOp.lookupSymbol(funcName))
+    return cast<LLVM::LLVMFuncOp>(*funcOp);
+
+  auto *ctx = rewriter.getContext();
+  auto funcType = LLVM::LLVMFunctionType::get(i64_ty, {i32_ty});
+
+  RewriterBase::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(moduleOp.getBody());
+
+  auto func = rewriter.create<LLVM::LLVMFuncOp>(UnknownLoc::get(ctx), funcName,
+                                                funcType);
+  func.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  return func;
+}
+
 Value TargetInfo::programId(RewriterBase &rewriter, Location loc,
                             ModuleOp moduleOp, int axis) const {
   assert(axis >= 0);
@@ -86,7 +106,171 @@ Value TargetInfo::programId(RewriterBase &rewriter, Location loc,
                                            mlir::gpu::Dimension::z};
 
   Value blockId = rewriter.create<::mlir::gpu::BlockIdOp>(loc, dims[axis]);
-  return rewriter.create<arith::IndexCastOp>(loc, i32_ty, blockId);
+  Value programId = rewriter.create<arith::IndexCastOp>(loc, i32_ty, blockId);
+  using triton::gpu::intel::TritonIntelGPUDialect;
+  if (!moduleOp->hasAttr(TritonIntelGPUDialect::getExplicitScalingAttrName()))
+    return programId;
+
+  // The part of the grid launched on a stack starts at the global offset of
+  // the launch, in work-items. Only the X dimension of a work-group has more
+  // than one work-item.
+  auto funcOp = getGlobalOffsetDeclaration(rewriter);
+  Value dim = i32_val(axis);
+  auto offset = call(funcOp, ValueRange{dim});
+  offset.setCConv(LLVM::cconv::CConv::SPIR_FUNC);
+  Value groupOffset = trunc(i32_ty, offset.getResult());
+  if (axis == 0) {
+    unsigned workGroupSize =
+        triton::gpu::TritonGPUDialect::getNumWarps(moduleOp) *
+        triton::gpu::TritonGPUDialect::getThreadsPerWarp(moduleOp);
+    // Warp specialization adds subgroups to the work-group.
+    if (auto numWarpGroups = moduleOp->getAttrOfType<IntegerAttr>(
+            "triton_gpu.num-warp-groups-per-cta"))
+      workGroupSize *= numWarpGroups.getInt();
+    groupOffset = udiv(groupOffset, i32_val(workGroupSize));
+  }
+  return add(programId, groupOffset);
+}
+
+namespace {
+// The combine region of a reduction selecting the (value, index) pair with the
+// largest or smallest value, e.g. `tl.argmax` or `tl.argmin`.
+struct ArgMinMaxCombiner {
+  TritonGEN::ReduceKind kind;
+  // Whether the values are compared as unsigned integers.
+  bool isUnsigned;
+};
+} // namespace
+
+// Match a combine region of the form:
+//   %cond = cmp %v1, %v2 [or (%v1 == %v2 and %i1 < %i2)]
+//   tt.reduce.return select(%cond, %v1, %v2), select(%cond, %i1, %i2)
+static std::optional<ArgMinMaxCombiner>
+matchArgMinMaxCombiner(Region &combineOp) {
+  if (!combineOp.hasOneBlock())
+    return std::nullopt;
+  Block &block = combineOp.front();
+  if (block.getNumArguments() != 4)
+    return std::nullopt;
+  Value v1 = block.getArgument(0), i1 = block.getArgument(1);
+  Value v2 = block.getArgument(2), i2 = block.getArgument(3);
+  if (!isa<IntegerType>(i1.getType()))
+    return std::nullopt;
+
+  Operation *yield = block.getTerminator();
+  auto valSelect = yield->getOperand(0).getDefiningOp<arith::SelectOp>();
+  auto idxSelect = yield->getOperand(1).getDefiningOp<arith::SelectOp>();
+  if (!valSelect || !idxSelect ||
+      valSelect.getCondition() != idxSelect.getCondition() ||
+      valSelect.getTrueValue() != v1 || valSelect.getFalseValue() != v2 ||
+      idxSelect.getTrueValue() != i1 || idxSelect.getFalseValue() != i2)
+    return std::nullopt;
+
+  // Strip the optional tie break in favor of the lowest index: the fused
+  // reduction always selects the lowest index among the equal values.
+  Value cond = valSelect.getCondition();
+  if (auto orOp = cond.getDefiningOp<arith::OrIOp>()) {
+    auto isValueEq = [&](Value val) {
+      if (auto cmp = val.getDefiningOp<arith::CmpFOp>())
+        return cmp.getPredicate() == arith::CmpFPredicate::OEQ &&
+               cmp.getLhs() == v1 && cmp.getRhs() == v2;
+      if (auto cmp = val.getDefiningOp<arith::CmpIOp>())
+        return cmp.getPredicate() == arith::CmpIPredicate::eq &&
+               cmp.getLhs() == v1 && cmp.getRhs() == v2;
+      return false;
+    };
+    auto isIndexLt = [&](Value val) {
+      auto cmp = val.getDefiningOp<arith::CmpIOp>();
+      return cmp && cmp.getPredicate() == arith::CmpIPredicate::slt &&
+             cmp.getLhs() == i1 && cmp.getRhs() == i2;
+    };
+    auto isTieBreak = [&](Value val) {
+      auto andOp = val.getDefiningOp<arith::AndIOp>();
+      if (!andOp)
+        return false;
+      Value lhs = andOp.getLhs(), rhs = andOp.getRhs();
+      return (isValueEq(lhs) && isIndexLt(rhs)) ||
+             (isValueEq(rhs) && isIndexLt(lhs));
+    };
+    if (isTieBreak(orOp.getRhs()))
+      cond = orOp.getLhs();
+    else if (isTieBreak(orOp.getLhs()))
+      cond = orOp.getRhs();
+    else
+      return std::nullopt;
+  }
+
+  if (auto cmp = cond.getDefiningOp<arith::CmpFOp>()) {
+    if (cmp.getLhs() != v1 || cmp.getRhs() != v2)
+      return std::nullopt;
+    switch (cmp.getPredicate()) {
+    case arith::CmpFPredicate::OGT:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MAX, false};
+    case arith::CmpFPredicate::OLT:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MIN, false};
+    default:
+      return std::nullopt;
+    }
+  }
+  if (auto cmp = cond.getDefiningOp<arith::CmpIOp>()) {
+    if (cmp.getLhs() != v1 || cmp.getRhs() != v2)
+      return std::nullopt;
+    switch (cmp.getPredicate()) {
+    case arith::CmpIPredicate::sgt:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MAX, false};
+    case arith::CmpIPredicate::ugt:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MAX, true};
+    case arith::CmpIPredicate::slt:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MIN, false};
+    case arith::CmpIPredicate::ult:
+      return ArgMinMaxCombiner{TritonGEN::ReduceKind::MIN, true};
+    default:
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+// Reduce the (value, index) pairs with two subgroup reductions rather than a
+// shuffle butterfly: the first one computes the extreme value, the second one
+// the lowest index of the lanes holding it.
+static void warpArgMinMaxReduce(RewriterBase &rewriter, Location loc,
+                                SmallVector<Value> &acc,
+                                const ArgMinMaxCombiner &combiner,
+                                unsigned numLaneToReduce,
+                                unsigned interleave) {
+  // Integer subgroup reductions are signed. Flipping the sign bit maps the
+  // unsigned order to the signed one.
+  auto flipSign = [&](Value val) -> Value {
+    unsigned bitWidth = val.getType().getIntOrFloatBitWidth();
+    return xor_(val, int_val(bitWidth, APInt::getSignMask(bitWidth)
+                                           .getSExtValue()));
+  };
+
+  Value val = combiner.isUnsigned ? flipSign(acc[0]) : acc[0];
+  Value maxOrMin = rewriter.create<TritonGEN::SubGroupReduceOp>(
+      loc, val.getType(), val, combiner.kind, numLaneToReduce, interleave);
+
+  // Lanes holding NaN values are candidates only when all the values are NaN.
+  Value isCandidate;
+  if (isa<FloatType>(val.getType()))
+    isCandidate =
+        or_(fcmp_eq(val, maxOrMin),
+            rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::uno,
+                                          maxOrMin, maxOrMin));
+  else
+    isCandidate = icmp_eq(val, maxOrMin);
+
+  unsigned idxBitWidth = acc[1].getType().getIntOrFloatBitWidth();
+  Value idx = select(isCandidate, acc[1],
+                     int_val(idxBitWidth, APInt::getSignedMaxValue(idxBitWidth)
+                                              .getSExtValue()));
+  Value minIdx = rewriter.create<TritonGEN::SubGroupReduceOp>(
+      loc, idx.getType(), idx, TritonGEN::ReduceKind::MIN, numLaneToReduce,
+      interleave);
+
+  acc[0] = combiner.isUnsigned ? flipSign(maxOrMin) : maxOrMin;
+  acc[1] = minIdx;
 }
 
 bool TargetInfo::warpReduce(RewriterBase &rewriter, Location loc,
@@ -96,9 +280,21 @@ bool TargetInfo::warpReduce(RewriterBase &rewriter, Location loc,
   // No horizontal reduce required.
   if (numLaneToReduce == 1)
     return false;
-  // Horizontal reduce with interleave stride not supported.
-  if (interleave > 1)
+  // The lanes reduced together are `interleave` lanes apart, e.g. for a
+  // reduction along the slower dimension of the lanes, and only
+  // `numLaneToReduce` of them, e.g. for rows narrower than the subgroup: both
+  // map to a single clustered, interleaved, subgroup reduction.
+
+  // Check if it is an argmin/argmax reduction.
+  if (op.getNumOperands() == 2 && op.getNumResults() == 2) {
+    if (std::optional<ArgMinMaxCombiner> combiner =
+            matchArgMinMaxCombiner(op.getCombineOp())) {
+      warpArgMinMaxReduce(rewriter, loc, acc, *combiner, numLaneToReduce,
+                          interleave);
+      return true;
+    }
     return false;
+  }
   // Check if it is a simple reduce operation supported by
   // TritonGEN::SubGroupReduceOp.
   if (op.getNumOperands() != 1 || op.getNumResults() != 1)
@@ -137,7 +333,7 @@ bool TargetInfo::warpReduce(RewriterBase &rewriter, Location loc,
   for (unsigned i = 0; i < acc.size(); ++i) {
     acc[i] = rewriter.create<TritonGEN::SubGroupReduceOp>(
         loc, reduceOp->getResult(0).getType(), acc[i], *reduceKind,
-        numLaneToReduce);
+        numLaneToReduce, interleave);
   }
 
   return true;
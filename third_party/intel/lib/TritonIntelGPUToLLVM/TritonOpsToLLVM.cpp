@@ -243,7 +243,8 @@ public:
       }
       auto load = rewriter.create<TritonGEN::Matrix2DBlockLoadOp>(
           loc, vectorType, base, surfaceW, surfaceH, surfaceP, offsetX, offsetY,
-          dataSize, blockWidth, blockHeight, vBlks, transpose, vnni);
+          dataSize, blockWidth, blockHeight, vBlks, transpose, vnni,
+          LLVM::intel::getLoadCacheControl(op.getCache(), op.getEvict()));
       VERIFY_OPERATION(load)
 
       rewriter.replaceOp(op, bitcast(load, resType));
@@ -252,7 +253,10 @@ public:
         std::swap(offsetX, offsetY);
       auto newOp = rewriter.create<TritonGEN::Matrix2DBlockPrefetchOp>(
           loc, base, surfaceW, surfaceH, surfaceP, offsetX, offsetY, dataSize,
-          blockWidth, blockHeight, vBlks, TritonGEN::LoadCacheControl::L1C_L3C);
+          blockWidth, blockHeight, vBlks,
+          LLVM::intel::getLoadCacheControl(
+              op.getCache(), op.getEvict(),
+              TritonGEN::LoadCacheControl::L1C_L3C));
       VERIFY_OPERATION(newOp)
 
       rewriter.eraseOp(op);
@@ -263,7 +267,8 @@ public:
       auto newOp = rewriter.create<TritonGEN::Matrix2DBlockStoreOp>(
           loc, base, surfaceW, surfaceH, surfaceP, offsetX, offsetY, dataSize,
           blockWidth, blockHeight, vBlks,
-          bitcast(adaptor.getValue(), vectorType));
+          bitcast(adaptor.getValue(), vectorType),
+          LLVM::intel::getStoreCacheControl(op.getCache(), op.getEvict()));
       VERIFY_OPERATION(newOp)
 
       rewriter.eraseOp(op);
@@ -581,21 +586,45 @@ public:
 
     Operation *combine = &*combineOp.front().getOperations().begin();
 
-    // FIXME: support all possible reduction modes
-    using AllReduceOperation = mlir::gpu::AllReduceOperation;
-    AllReduceOperation redKind;
-    if (isa<arith::AddFOp>(combine))
-      redKind = AllReduceOperation::ADD;
-    else if (isa<arith::MaxNumFOp>(combine))
-      redKind = AllReduceOperation::MAXNUMF;
-    else
-      llvm_unreachable("Unhandled reduction kind");
+    std::optional<mlir::gpu::AllReduceOperation> redKind =
+        getReductionKind(combine);
+    if (!redKind)
+      return failure();
 
     Value result = rewriter.create<mlir::gpu::SubgroupReduceOp>(
-        loc, adaptor.getSrcs()[0], redKind, true);
+        loc, adaptor.getSrcs()[0], *redKind, true);
     rewriter.replaceOp(op, result);
     return success();
   }
+
+private:
+  /// Return the sub-group reduction performed by the \p combine operation if
+  /// there is one.
+  static std::optional<mlir::gpu::AllReduceOperation>
+  getReductionKind(Operation *combine) {
+    using AllReduceOperation = mlir::gpu::AllReduceOperation;
+    return TypeSwitch<Operation *, std::optional<AllReduceOperation>>(combine)
+        .Case<arith::AddFOp, arith::AddIOp>(
+            [](auto) { return AllReduceOperation::ADD; })
+        .Case<arith::MulFOp, arith::MulIOp>(
+            [](auto) { return AllReduceOperation::MUL; })
+        .Case<arith::MaxNumFOp>(
+            [](auto) { return AllReduceOperation::MAXNUMF; })
+        .Case<arith::MinNumFOp>(
+            [](auto) { return AllReduceOperation::MINNUMF; })
+        .Case<arith::MaximumFOp>(
+            [](auto) { return AllReduceOperation::MAXIMUMF; })
+        .Case<arith::MinimumFOp>(
+            [](auto) { return AllReduceOperation::MINIMUMF; })
+        .Case<arith::MaxSIOp>([](auto) { return AllReduceOperation::MAXSI; })
+        .Case<arith::MinSIOp>([](auto) { return AllReduceOperation::MINSI; })
+        .Case<arith::MaxUIOp>([](auto) { return AllReduceOperation::MAXUI; })
+        .Case<arith::MinUIOp>([](auto) { return AllReduceOperation::MINUI; })
+        .Case<arith::AndIOp>([](auto) { return AllReduceOperation::AND; })
+        .Case<arith::OrIOp>([](auto) { return AllReduceOperation::OR; })
+        .Case<arith::XOrIOp>([](auto) { return AllReduceOperation::XOR; })
+        .Default([](auto) { return std::nullopt; });
+  }
 };
 
 class TransposedReduceOpConversion
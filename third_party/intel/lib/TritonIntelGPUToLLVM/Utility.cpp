@@ -159,4 +159,62 @@ LLVM::LLVMFuncOp getSpirvPrintfDeclaration(RewriterBase &rewriter) {
   return printFunc;
 }
 
+/// Data loaded with a streaming hint (the 'cs' modifier or the 'evict_first'
+/// policy) is not expected to be reused: it is not allocated in L3 so that it
+/// does not evict data that is.
+TritonGEN::LoadCacheControl
+getLoadCacheControl(CacheModifier cache, EvictionPolicy evict,
+                    TritonGEN::LoadCacheControl defaultControl) {
+  using TritonGEN::LoadCacheControl;
+  bool cacheInL3 = evict != EvictionPolicy::EVICT_FIRST;
+  switch (cache) {
+  case CacheModifier::CA:
+    return cacheInL3 ? LoadCacheControl::L1C_L3C : LoadCacheControl::L1C_L3UC;
+  case CacheModifier::CG:
+    return cacheInL3 ? LoadCacheControl::L1UC_L3C : LoadCacheControl::L1UC_L3UC;
+  case CacheModifier::CS:
+    return LoadCacheControl::L1S_L3UC;
+  default:
+    break;
+  }
+
+  switch (evict) {
+  case EvictionPolicy::EVICT_FIRST:
+    return LoadCacheControl::L1S_L3UC;
+  case EvictionPolicy::EVICT_LAST:
+    return LoadCacheControl::L1C_L3C;
+  default:
+    return defaultControl;
+  }
+}
+
+TritonGEN::StoreCacheControl getStoreCacheControl(CacheModifier cache,
+                                                  EvictionPolicy evict) {
+  using TritonGEN::StoreCacheControl;
+  bool cacheInL3 = evict != EvictionPolicy::EVICT_FIRST;
+  switch (cache) {
+  case CacheModifier::WB:
+    return StoreCacheControl::L1WB_L3WB;
+  case CacheModifier::WT:
+    return cacheInL3 ? StoreCacheControl::L1WT_L3WB
+                     : StoreCacheControl::L1WT_L3UC;
+  case CacheModifier::CG:
+    return cacheInL3 ? StoreCacheControl::L1UC_L3WB
+                     : StoreCacheControl::L1UC_L3UC;
+  case CacheModifier::CS:
+    return StoreCacheControl::L1S_L3UC;
+  default:
+    break;
+  }
+
+  switch (evict) {
+  case EvictionPolicy::EVICT_FIRST:
+    return StoreCacheControl::L1S_L3UC;
+  case EvictionPolicy::EVICT_LAST:
+    return StoreCacheControl::L1WB_L3WB;
+  default:
+    return StoreCacheControl::DEFAULT;
+  }
+}
+
 } // namespace mlir::LLVM::intel
@@ -90,6 +90,19 @@ Value addStringToModule(Location loc, RewriterBase &rewriter, StringRef key,
 
 LLVM::LLVMFuncOp getSpirvPrintfDeclaration(RewriterBase &rewriter);
 
+/// Return the L1/L3 cache controls implementing the cache modifier \p cache
+/// and the eviction policy \p evict of a load or a prefetch, or \p
+/// defaultControl if neither is given.
+TritonGEN::LoadCacheControl
+getLoadCacheControl(triton::CacheModifier cache, triton::EvictionPolicy evict,
+                    TritonGEN::LoadCacheControl defaultControl =
+                        TritonGEN::LoadCacheControl::DEFAULT);
+
+/// Return the L1/L3 cache controls implementing the cache modifier \p cache
+/// and the eviction policy \p evict of a store.
+TritonGEN::StoreCacheControl
+getStoreCacheControl(triton::CacheModifier cache, triton::EvictionPolicy evict);
+
 static Value getStackPointer(PatternRewriter &rewriter,
                              FunctionOpInterface funcOp) {
   auto mod = funcOp->getParentOfType<ModuleOp>();
@@ -100,6 +113,24 @@ static Value getStackPointer(PatternRewriter &rewriter,
   return funcOp.getArgument(funcOp.getNumArguments() - 1);
 }
 
+/// Returns the global scratch memory of the launch, passed to the kernel
+/// \p funcOp before its SLM buffer, or a poison pointer if the module has no
+/// global scratch.
+static Value getGlobalScratchPtr(PatternRewriter &rewriter,
+                                 FunctionOpInterface funcOp) {
+  auto mod = funcOp->getParentOfType<ModuleOp>();
+  LLVM::LLVMPointerType ptrTy = ptr_ty(
+      rewriter.getContext(), TritonGEN::TritonGENMemorySpace::kCrossWorkgroup);
+  auto sizeAttr = mod->getAttrOfType<IntegerAttr>(
+      triton::gpu::intel::TritonIntelGPUDialect::
+          getGlobalScratchSizeAttrName());
+  if (!sizeAttr || sizeAttr.getInt() == 0)
+    return rewriter.create<LLVM::PoisonOp>(funcOp.getLoc(), ptrTy);
+  bool hasSLM =
+      mod->getAttrOfType<IntegerAttr>("triton_gpu.shared").getInt() != 0;
+  return funcOp.getArgument(funcOp.getNumArguments() - (hasSLM ? 2 : 1));
+}
+
 static Value getSharedMemoryBase(Location loc,
                                  ConversionPatternRewriter &rewriter,
                                  Operation *op) {
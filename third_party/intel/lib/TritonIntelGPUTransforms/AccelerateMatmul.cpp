@@ -98,13 +98,41 @@ SmallVector<unsigned> getWarpsPerTile(DotOp dotOp,
   return ret;
 }
 
+/// Returns the number of DPAS repetitions along M and N grouped in the cluster
+/// of a sub-group. The operands of a cluster are loaded together: the A
+/// operands of the cluster rows by a single 2D block load of up to 32 rows,
+/// and the B operands of the cluster columns by a single load of up to 64
+/// bytes per row (v_blocks). The cluster is the largest one filled by one load
+/// of each operand, bounded by \p maxRepCluster when it is not 0, and by the
+/// repetitions \p repA and \p repB of the operands of the dot.
+SmallVector<unsigned> getRepCluster(const IntelDPASCapability &dpasCap,
+                                    unsigned elemBitWidth,
+                                    ArrayRef<int64_t> repA,
+                                    ArrayRef<int64_t> repB,
+                                    ArrayRef<unsigned> maxRepCluster) {
+  SmallVector<unsigned> repCluster{
+      PVC_2D_LOAD_MAXIMUM_NUMBER_OF_ROWS / dpasCap.repeatCount,
+      PVC_2D_LOAD_MAXIMUM_BYTES_OF_COLS /
+          ((elemBitWidth / 8) * dpasCap.executionSize)};
+  repCluster[0] = std::min(repCluster[0], static_cast<unsigned>(repA[0]));
+  repCluster[1] = std::min(repCluster[1], static_cast<unsigned>(repB[1]));
+  for (unsigned dim = 0; dim < 2; ++dim) {
+    if (maxRepCluster[dim] != 0)
+      repCluster[dim] = std::min(repCluster[dim], maxRepCluster[dim]);
+    repCluster[dim] = std::max(repCluster[dim], 1u);
+  }
+  return repCluster;
+}
+
 class BlockedToDPAS : public RewritePattern {
   const DPASAnalysis &dpasAnalysis;
+  SmallVector<unsigned> maxRepCluster;
 
 public:
-  BlockedToDPAS(MLIRContext *context, const DPASAnalysis &dpasAnalysis)
+  BlockedToDPAS(MLIRContext *context, const DPASAnalysis &dpasAnalysis,
+                ArrayRef<unsigned> maxRepCluster)
       : RewritePattern(DotOp::getOperationName(), 2, context),
-        dpasAnalysis(dpasAnalysis) {}
+        dpasAnalysis(dpasAnalysis), maxRepCluster(maxRepCluster) {}
 
   LogicalResult matchAndRewrite(Operation *op,
                                 PatternRewriter &rewriter) const override {
@@ -137,9 +165,10 @@ public:
     unsigned dpasElemBitWidths =
         oldAType.getElementType().getIntOrFloatBitWidth();
 
-    // We are upcasting FP8 to FP16
-    if (oldAType.getElementType().isFloat8E5M2() ||
-        oldAType.getElementType().isFloat8E4M3FN())
+    // We are upcasting FP8 to FP16 unless DPAS supports FP8 natively.
+    if ((oldAType.getElementType().isFloat8E5M2() ||
+         oldAType.getElementType().isFloat8E4M3FN()) &&
+        !DPASAnalysis::isNativeFP8(DPASAnalysis::getDPASType(dotOp)))
       dpasElemBitWidths = 2 * dpasElemBitWidths;
 
     unsigned opsPerChan = dpasCap.opsChanBitWidths / dpasElemBitWidths;
@@ -155,25 +184,14 @@ public:
     if (dpasCap.executionSize == 16 /* PVC */) {
       // Enlarge the repCluster size to use the large 2D load for A and B
       // operands.
-      unsigned maxRepClusterM =
-          PVC_2D_LOAD_MAXIMUM_NUMBER_OF_ROWS / dpasCap.repeatCount;
-      SmallVector<int64_t> repA =
-          dpasEnc.getDPASRepetitions(oldAType.getShape(), 0);
-      unsigned repClusterDimM =
-          std::min(maxRepClusterM, static_cast<unsigned>(repA[0]));
-
-      unsigned maxRepClusterN =
-          PVC_2D_LOAD_MAXIMUM_BYTES_OF_COLS /
-          ((dpasElemBitWidths / 8) * dpasCap.executionSize);
-      SmallVector<int64_t> repB =
-          dpasEnc.getDPASRepetitions(oldBType.getShape(), 1);
-      unsigned repClusterDimN =
-          std::min(maxRepClusterN, static_cast<unsigned>(repB[1]));
-
+      SmallVector<unsigned> repCluster = getRepCluster(
+          dpasCap, dpasElemBitWidths,
+          dpasEnc.getDPASRepetitions(oldAType.getShape(), 0),
+          dpasEnc.getDPASRepetitions(oldBType.getShape(), 1), maxRepCluster);
       dpasEnc = intel::DpasEncodingAttr::get(
           oldRetType.getContext(), dpasCap.repeatCount, dpasCap.systolicDepth,
-          dpasCap.executionSize, opsPerChan, warpsPerTile,
-          {repClusterDimM, repClusterDimN}, threadsPerWarp);
+          dpasCap.executionSize, opsPerChan, warpsPerTile, repCluster,
+          threadsPerWarp);
     }
 
     RankedTensorType newRetType =
@@ -243,10 +261,11 @@ static void decomposeMixedModeDotOp(ModuleOp mod) {
 
     Type promoteType;
     if (dpasLayout) {
-      bool isNativeFP8 = AElType.isFloat8E5M2() || AElType.isFloat8E4M3FN();
-      // fp8 is not natively supported by the the DPAS instruction, promote it
-      // to fp16.
-      if (!isNativeFP8)
+      bool isFP8 = AElType.isFloat8E5M2() || AElType.isFloat8E4M3FN();
+      // fp8 is not natively supported by the the DPAS instruction on all
+      // targets, promote it to fp16 when it isn't.
+      if (!isFP8 ||
+          DPASAnalysis::isNativeFP8(DPASAnalysis::getDPASType(dotOp)))
         return;
       promoteType = builder.getF16Type();
     } else {
@@ -278,7 +297,9 @@ public:
     DPASAnalysis &dpasAnalysis = getAnalysis<DPASAnalysis>();
 
     RewritePatternSet patterns(context);
-    patterns.add<BlockedToDPAS>(context, dpasAnalysis);
+    patterns.add<BlockedToDPAS>(context, dpasAnalysis,
+                                ArrayRef<unsigned>{maxRepClusterM,
+                                                   maxRepClusterN});
     if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed())
       signalPassFailure();
 
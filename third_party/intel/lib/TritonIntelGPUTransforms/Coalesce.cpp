@@ -0,0 +1,266 @@
+//===- Coalesce.cpp -----------------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the coalescing of the loads and stores of tensors of
+/// pointers for Intel GPUs. It differs from the upstream pass in the layouts
+/// it picks for the LSC messages the accesses are lowered to:
+///  - accesses contiguous over a sub-group chunk are given to consecutive
+///    lanes, so that they are lowered to SIMD block messages, which access
+///    whole chunks from a single address,
+///  - other accesses give each work-item its own widest vector, so that the
+///    messages of a sub-group access whole cache lines.
+//===----------------------------------------------------------------------===//
+
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Dialect/Triton/IR/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Utility.h"
+#include "triton/Tools/StrUtil.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-coalesce"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUCOALESCE
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+/// Largest number of elements per lane of a SIMD block message.
+constexpr unsigned maxBlockVecSize = 8;
+
+/// Returns the mask of \p op, and whether it has cache controls, which SIMD
+/// block messages cannot carry.
+std::pair<Value, bool> getMaskAndCacheControls(Operation *op) {
+  return TypeSwitch<Operation *, std::pair<Value, bool>>(op)
+      .Case<tt::LoadOp, tt::StoreOp>([](auto op) {
+        bool hasCacheControls = op.getCache() != tt::CacheModifier::NONE ||
+                                op.getEvict() != tt::EvictionPolicy::NORMAL;
+        return std::make_pair(op.getMask(), hasCacheControls);
+      })
+      .Default([](Operation *) { return std::make_pair(Value(), true); });
+}
+
+struct CoalescePass
+    : public ttg::intel::impl::TritonIntelGPUCoalesceBase<CoalescePass> {
+  /// Returns the layout giving consecutive elements along `order[0]` to
+  /// consecutive lanes, so that \p op is lowered to SIMD block messages of
+  /// at least \p perThread elements per lane, or a null attribute if \p op
+  /// cannot use block messages.
+  ttg::BlockedEncodingAttr
+  getBlockEncoding(tt::ModuleAxisInfoAnalysis &axisInfoAnalysis, Operation *op,
+                   ArrayRef<unsigned> order, unsigned perThread, int numWarps,
+                   int threadsPerWarp) {
+    Value ptr = getMemAccessPtr(op);
+    auto tensorType = cast<RankedTensorType>(ptr.getType());
+    auto ptrType = cast<tt::PointerType>(tensorType.getElementType());
+    unsigned elemNumBits = getElementBitWidth(tensorType);
+    auto [mask, hasCacheControls] = getMaskAndCacheControls(op);
+    if (hasCacheControls || ptrType.getAddressSpace() != 1 ||
+        !llvm::is_contained({8u, 16u, 32u, 64u}, elemNumBits))
+      return {};
+
+    // The sub-group chunks must be contiguous, aligned and accessed under a
+    // mask uniform across the chunk. Block reads only need a 4 bytes aligned
+    // address, so that the rows of a gather (e.g. `base + idx[:, None] *
+    // stride + cols[None, :]`) are read with block messages as long as the
+    // row stride is a multiple of 4 bytes. Block writes need 16 bytes.
+    unsigned dim = order[0];
+    unsigned minAlignment = isa<tt::LoadOp>(op) ? 4 : 16;
+    SmallVector<int64_t> shapePerCTA = ttg::getShapePerCTA(tensorType);
+    tt::AxisInfo *axisInfo = axisInfoAnalysis.getAxisInfo(ptr);
+    if (!axisInfo)
+      return {};
+    int64_t contiguity = axisInfo->getContiguity(dim);
+    if (mask) {
+      tt::AxisInfo *maskInfo = axisInfoAnalysis.getAxisInfo(mask);
+      contiguity = maskInfo ? std::min(contiguity, maskInfo->getConstancy(dim))
+                            : 1;
+    }
+    if (axisInfo->getDivisibility(dim) < minAlignment ||
+        contiguity < threadsPerWarp ||
+        shapePerCTA[dim] % threadsPerWarp != 0)
+      return {};
+
+    // The warps are distributed along the other dimensions first, so that
+    // the registers of a lane access consecutive chunks.
+    unsigned rank = tensorType.getRank();
+    SmallVector<unsigned> sizePerThread(rank, 1), threads(rank, 1),
+        warps(rank, 1);
+    threads[dim] = threadsPerWarp;
+    unsigned remainingWarps = numWarps;
+    for (unsigned d : llvm::reverse(order)) {
+      warps[d] = std::min<int64_t>(
+          remainingWarps, std::max<int64_t>(shapePerCTA[d] / threads[d], 1));
+      remainingWarps /= warps[d];
+    }
+    warps[dim] *= remainingWarps;
+
+    int64_t numChunks =
+        std::max<int64_t>(shapePerCTA[dim] / (threadsPerWarp * warps[dim]), 1);
+    int64_t maxBlockVec = std::min<int64_t>(
+        {maxBlockVecSize, numChunks, contiguity / threadsPerWarp});
+    unsigned blockVec = llvm::bit_floor(static_cast<uint64_t>(maxBlockVec));
+    LDBG("blockVec: " << blockVec);
+    // A message of a lane accessing fewer elements than its own vector would
+    // need more messages.
+    if (blockVec < perThread)
+      return {};
+
+    auto CTALayout = ttg::getCTALayout(tensorType.getEncoding());
+    return ttg::BlockedEncodingAttr::get(&getContext(), sizePerThread, threads,
+                                         warps, order, CTALayout);
+  }
+
+  void
+  setCoalescedEncoding(tt::ModuleAxisInfoAnalysis &axisInfoAnalysis,
+                       Operation *op, int numWarps, int threadsPerWarp,
+                       llvm::MapVector<Operation *, Attribute> &layoutMap) {
+    Value ptr = getMemAccessPtr(op);
+    auto refTensorType = cast<RankedTensorType>(ptr.getType());
+
+    LDBG("Considering op: " << *op);
+    LLVM_DEBUG({
+      DBGS() << "axis info of pointer: ";
+      axisInfoAnalysis.getAxisInfo(ptr)->print(llvm::dbgs());
+      llvm::dbgs() << "\n";
+    });
+
+    auto contiguity = axisInfoAnalysis.getAxisInfo(ptr)->getContiguity();
+    SmallVector<unsigned> order = argSort(contiguity);
+    LDBG("order=[" << triton::join(order, ", ") << "]");
+
+    auto shapePerCTA = ttg::getShapePerCTA(refTensorType);
+    LDBG("shapePerCTA=[" << triton::join(shapePerCTA, ", ") << "]");
+
+    int numElems = tt::product<int64_t>(shapePerCTA);
+    int numThreads = numWarps * threadsPerWarp;
+
+    // Unlike NVIDIA GPUs, which take the widest vector of the accesses with
+    // the same order for loads, each work-item accesses its own widest vector:
+    // the messages of a sub-group holding more elements per work-item than
+    // its vector would only access a part of each cache line.
+    unsigned perThread = getNumElementsPerThread(op, order, axisInfoAnalysis);
+    perThread = std::min<int>(perThread, std::max(numElems / numThreads, 1));
+    LDBG("perThread: " << perThread);
+
+    if (auto encoding = getBlockEncoding(axisInfoAnalysis, op, order,
+                                         perThread, numWarps, threadsPerWarp)) {
+      LDBG("SIMD block encoding: " << encoding);
+      layoutMap[op] = encoding;
+      return;
+    }
+
+    SmallVector<unsigned> sizePerThread(refTensorType.getRank(), 1);
+    sizePerThread[order[0]] = perThread;
+
+    auto CTALayout = ttg::getCTALayout(refTensorType.getEncoding());
+    layoutMap[op] = ttg::BlockedEncodingAttr::get(
+        &getContext(), refTensorType.getShape(), sizePerThread, order, numWarps,
+        threadsPerWarp, CTALayout);
+  }
+
+  static Type getNewType(Type type, Attribute encoding) {
+    RankedTensorType tensorType = cast<RankedTensorType>(type);
+    return RankedTensorType::get(tensorType.getShape(),
+                                 tensorType.getElementType(), encoding);
+  }
+
+  void coalesceOp(Attribute encoding, Operation *op) {
+    OpBuilder builder(op);
+    // Convert operands
+    // For load/store with tensor pointers, we don't have to change the
+    // operands' type, we do this by changing the outputs' type of
+    // `make_tensor_ptr`
+    SmallVector<Value, 4> newArgs;
+    for (auto operand : op->getOperands()) {
+      auto tensorType = dyn_cast<RankedTensorType>(operand.getType());
+      if (tensorType &&
+          !isa<ttg::SharedEncodingAttr>(tensorType.getEncoding())) {
+        Type newType = getNewType(tensorType, encoding);
+        newArgs.push_back(builder.create<ttg::ConvertLayoutOp>(
+            op->getLoc(), newType, operand));
+      } else {
+        newArgs.push_back(operand);
+      }
+    }
+
+    // Convert output types
+    SmallVector<Type, 4> newTypes;
+    for (auto t : op->getResultTypes()) {
+      bool isAsync = isa<ttg::AsyncCopyGlobalToLocalOp>(op);
+      newTypes.push_back(isAsync ? t : getNewType(t, encoding));
+    }
+
+    // Construct new op with the new encoding
+    Operation *newOp =
+        builder.create(op->getLoc(), op->getName().getIdentifier(), newArgs,
+                       newTypes, op->getAttrs());
+
+    // Cast the results back to the original layout
+    for (size_t i = 0; i < op->getNumResults(); i++) {
+      Value newResult = newOp->getResult(i);
+      if (newTypes[i] != op->getResultTypes()[i]) {
+        newResult = builder.create<ttg::ConvertLayoutOp>(
+            op->getLoc(), op->getResult(i).getType(), newResult);
+      }
+      op->getResult(i).replaceAllUsesWith(newResult);
+    }
+    op->erase();
+  }
+
+  void runOnOperation() override {
+    // Run axis info analysis
+    ModuleOp moduleOp = getOperation();
+    tt::ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
+
+    // For each i/o operation, we determine what layout
+    // the pointers should have for best memory coalescing
+    llvm::MapVector<Operation *, Attribute> layoutMap;
+    moduleOp.walk([&](Operation *curr) {
+      Value ptr = getMemAccessPtr(curr);
+      if (!ptr)
+        return;
+      // We only convert `tensor<tt.ptr<>>` load/store
+      bool isPtrTensor = false;
+      if (auto tensorType = dyn_cast<RankedTensorType>(ptr.getType()))
+        isPtrTensor = isa<tt::PointerType>(tensorType.getElementType());
+      if (!isPtrTensor)
+        return;
+      auto mod = curr->getParentOfType<ModuleOp>();
+      int numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+      int threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+      setCoalescedEncoding(axisInfoAnalysis, curr, numWarps, threadsPerWarp,
+                           layoutMap);
+    });
+
+    // For each memory op that has a layout L1:
+    // 1. Create a coalesced memory layout L2 of the pointer operands
+    // 2. Convert all operands from layout L1 to layout L2
+    // 3. Create a new memory op that consumes these operands and
+    //    produces a tensor with layout L2
+    // 4. Convert the output of this new memory op back to L1
+    // 5. Replace all the uses of the original memory op by the new one
+    for (auto &kv : layoutMap) {
+      coalesceOp(kv.second, kv.first);
+    }
+  }
+};
+
+} // namespace
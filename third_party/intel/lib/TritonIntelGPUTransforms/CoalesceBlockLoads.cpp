@@ -0,0 +1,330 @@
+//===- CoalesceBlockLoads.cpp -------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements a pass merging pairs of horizontally adjacent 2D block
+/// loads into a single load of twice the width. The wider load is lowered to a
+/// 2D block read with two blocks (v_blocks = 2), halving the number of message
+/// sends. The original tiles are recovered with `triton_intel_gpu.extract`,
+/// whose column-major sub-tile order matches the register layout of a
+/// multi-block read.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUCOALESCEBLOCKLOADS
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttgi = mlir::triton::gpu::intel;
+
+#define DEBUG_TYPE "tritonintelgpu-coalesce-block-loads"
+
+namespace {
+
+/// Width (in elements) of a single block of a 16-bit 2D block read. Two
+/// blocks is the maximum supported by the 2D block read lowering.
+constexpr int64_t blockWidth = 16;
+
+/// A 32-bit offset expressed as a sum of opaque SSA terms plus a constant.
+struct LinearOffset {
+  SmallVector<Value> terms;
+  int64_t constant = 0;
+};
+
+void decompose(Value val, LinearOffset &offset) {
+  APInt cst;
+  if (matchPattern(val, m_ConstantInt(&cst))) {
+    offset.constant += cst.getSExtValue();
+    return;
+  }
+  if (auto addOp = val.getDefiningOp<arith::AddIOp>()) {
+    decompose(addOp.getLhs(), offset);
+    decompose(addOp.getRhs(), offset);
+    return;
+  }
+  offset.terms.push_back(val);
+}
+
+/// Return `rhs - lhs` if it is a compile time constant.
+std::optional<int64_t> getConstantDifference(Value lhs, Value rhs) {
+  LinearOffset lhsOffset, rhsOffset;
+  decompose(lhs, lhsOffset);
+  decompose(rhs, rhsOffset);
+  auto compare = [](Value a, Value b) {
+    return a.getAsOpaquePointer() < b.getAsOpaquePointer();
+  };
+  llvm::sort(lhsOffset.terms, compare);
+  llvm::sort(rhsOffset.terms, compare);
+  if (lhsOffset.terms != rhsOffset.terms)
+    return std::nullopt;
+  return rhsOffset.constant - lhsOffset.constant;
+}
+
+using TileDelta = SmallVector<int64_t, 2>;
+
+/// Add `rhs - lhs` to \p delta, element wise. Return false if any of the
+/// differences isn't a compile time constant.
+bool addDelta(TileDelta &delta, ValueRange lhs, ValueRange rhs) {
+  for (auto [d, l, r] : llvm::zip_equal(delta, lhs, rhs)) {
+    std::optional<int64_t> diff = getConstantDifference(l, r);
+    if (!diff)
+      return false;
+    d += *diff;
+  }
+  return true;
+}
+
+/// Return the offset (in elements) of the tile addressed by \p rhs relative to
+/// the tile addressed by \p lhs, provided it is the same every time both
+/// pointers are used. Both pointers have to be derived, through `tt.advance`
+/// ops and loop carried values, from row-major `tt.make_tensor_ptr` ops
+/// describing the same tensor.
+std::optional<TileDelta> getTileDelta(Value lhs, Value rhs) {
+  if (auto lhsPtr = lhs.getDefiningOp<tt::MakeTensorPtrOp>()) {
+    auto rhsPtr = rhs.getDefiningOp<tt::MakeTensorPtrOp>();
+    if (!rhsPtr || lhsPtr.getBase() != rhsPtr.getBase() ||
+        !llvm::equal(lhsPtr.getShape(), rhsPtr.getShape()) ||
+        !llvm::equal(lhsPtr.getStrides(), rhsPtr.getStrides()) ||
+        lhsPtr.getOrder() != rhsPtr.getOrder() ||
+        lhsPtr.getOrder() != ArrayRef<int32_t>{1, 0})
+      return std::nullopt;
+
+    TileDelta delta(lhsPtr.getOffsets().size(), 0);
+    if (!addDelta(delta, lhsPtr.getOffsets(), rhsPtr.getOffsets()))
+      return std::nullopt;
+    return delta;
+  }
+
+  if (auto lhsAdvance = lhs.getDefiningOp<tt::AdvanceOp>()) {
+    auto rhsAdvance = rhs.getDefiningOp<tt::AdvanceOp>();
+    if (!rhsAdvance)
+      return std::nullopt;
+
+    std::optional<TileDelta> delta =
+        getTileDelta(lhsAdvance.getPtr(), rhsAdvance.getPtr());
+    if (!delta ||
+        !addDelta(*delta, lhsAdvance.getOffsets(), rhsAdvance.getOffsets()))
+      return std::nullopt;
+    return delta;
+  }
+
+  auto lhsArg = dyn_cast<BlockArgument>(lhs);
+  auto rhsArg = dyn_cast<BlockArgument>(rhs);
+  if (!lhsArg || !rhsArg || lhsArg.getOwner() != rhsArg.getOwner())
+    return std::nullopt;
+
+  auto forOp = dyn_cast<scf::ForOp>(lhsArg.getOwner()->getParentOp());
+  unsigned numIVs = forOp ? forOp.getNumInductionVars() : 0;
+  if (!forOp || lhsArg.getArgNumber() < numIVs ||
+      rhsArg.getArgNumber() < numIVs)
+    return std::nullopt;
+
+  // The relative position of loop carried pointers is loop invariant if both
+  // pointers are advanced by the same amount in every iteration.
+  unsigned lhsIdx = lhsArg.getArgNumber() - numIVs;
+  unsigned rhsIdx = rhsArg.getArgNumber() - numIVs;
+  auto yieldOp = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+  auto lhsNext = yieldOp.getOperand(lhsIdx).getDefiningOp<tt::AdvanceOp>();
+  auto rhsNext = yieldOp.getOperand(rhsIdx).getDefiningOp<tt::AdvanceOp>();
+  if (!lhsNext || !rhsNext || lhsNext.getPtr() != lhs ||
+      rhsNext.getPtr() != rhs)
+    return std::nullopt;
+
+  TileDelta step(lhsNext.getOffsets().size(), 0);
+  if (!addDelta(step, lhsNext.getOffsets(), rhsNext.getOffsets()) ||
+      llvm::any_of(step, [](int64_t d) { return d != 0; }))
+    return std::nullopt;
+
+  return getTileDelta(forOp.getInitArgs()[lhsIdx],
+                      forOp.getInitArgs()[rhsIdx]);
+}
+
+/// Recreate the definition of the tensor pointer \p ptr so that it addresses a
+/// tile of type \p type. Pointers already recreated are recorded in
+/// \p mapping. Loop carried pointers are widened by adding a new iteration
+/// argument to the loop.
+Value widenTensorPtr(Value ptr, tt::PointerType type, IRMapping &mapping,
+                     IRRewriter &rewriter) {
+  if (Value widened = mapping.lookupOrNull(ptr))
+    return widened;
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  if (auto makePtr = ptr.getDefiningOp<tt::MakeTensorPtrOp>()) {
+    rewriter.setInsertionPointAfter(makePtr);
+    Operation *clone = rewriter.clone(*makePtr);
+    clone->getResult(0).setType(type);
+    mapping.map(ptr, clone->getResult(0));
+    return clone->getResult(0);
+  }
+
+  if (auto advance = ptr.getDefiningOp<tt::AdvanceOp>()) {
+    Value src = widenTensorPtr(advance.getPtr(), type, mapping, rewriter);
+    rewriter.setInsertionPointAfter(advance);
+    Value widened = rewriter.create<tt::AdvanceOp>(advance.getLoc(), type, src,
+                                                   advance.getOffsets());
+    mapping.map(ptr, widened);
+    return widened;
+  }
+
+  auto arg = cast<BlockArgument>(ptr);
+  auto forOp = cast<scf::ForOp>(arg.getOwner()->getParentOp());
+  unsigned idx = arg.getArgNumber() - forOp.getNumInductionVars();
+  Value init = widenTensorPtr(forOp.getInitArgs()[idx], type, mapping, rewriter);
+  Value next =
+      cast<scf::YieldOp>(forOp.getBody()->getTerminator()).getOperand(idx);
+
+  Value widened;
+  FailureOr<LoopLikeOpInterface> newLoop = forOp.replaceWithAdditionalYields(
+      rewriter, init, /*replaceInitOperandUsesInLoop=*/false,
+      [&](OpBuilder &, Location, ArrayRef<BlockArgument> newArgs) {
+        widened = newArgs.front();
+        mapping.map(ptr, widened);
+        return SmallVector<Value>{
+            widenTensorPtr(next, type, mapping, rewriter)};
+      });
+  assert(succeeded(newLoop) && "Failed to add the widened pointer to the loop");
+  (void)newLoop;
+  return widened;
+}
+
+bool mayWriteMemory(Operation *op) {
+  if (isMemoryEffectFree(op))
+    return false;
+  auto memEffects = dyn_cast<MemoryEffectOpInterface>(op);
+  return !memEffects || !memEffects.onlyHasEffect<MemoryEffects::Read>();
+}
+
+/// Return true if \p loadOp can be merged with an adjacent load, i.e. it loads
+/// a single 16-bit wide block from global memory.
+bool isCandidate(tt::LoadOp loadOp) {
+  if (loadOp.getMask() || !loadOp->hasAttr("DotIdx"))
+    return false;
+
+  auto ptrType = dyn_cast<tt::PointerType>(loadOp.getPtr().getType());
+  if (!ptrType || ptrType.getAddressSpace() ==
+                      TritonGEN::TritonGENMemorySpace::kWorkgroup)
+    return false;
+
+  auto tensorType = dyn_cast<RankedTensorType>(ptrType.getPointeeType());
+  return tensorType && !tensorType.getEncoding() &&
+         tensorType.getRank() == 2 &&
+         tensorType.getElementTypeBitWidth() == 16 &&
+         tensorType.getShape()[1] == blockWidth;
+}
+
+/// Merge \p left and \p right, where \p right loads the tile immediately to
+/// the right of the one loaded by \p left, into a single load inserted before
+/// \p insertPt.
+void mergeLoads(tt::LoadOp left, tt::LoadOp right, Operation *insertPt,
+                IRRewriter &rewriter) {
+  auto tileType = cast<RankedTensorType>(left.getType());
+  auto ptrType = cast<tt::PointerType>(left.getPtr().getType());
+  SmallVector<int64_t> shape(tileType.getShape());
+  shape[1] *= 2;
+  auto wideType = RankedTensorType::get(shape, tileType.getElementType());
+  auto widePtrType = tt::PointerType::get(wideType, ptrType.getAddressSpace());
+
+  IRMapping mapping;
+  Value widePtr = widenTensorPtr(left.getPtr(), widePtrType, mapping, rewriter);
+
+  rewriter.setInsertionPoint(insertPt);
+  Operation *wideLoad = rewriter.clone(*left);
+  wideLoad->setOperand(0, widePtr);
+  wideLoad->getResult(0).setType(wideType);
+
+  Location loc = left.getLoc();
+  Value lhs = rewriter.create<ttgi::ExtractOp>(loc, tileType,
+                                               wideLoad->getResult(0), 0);
+  Value rhs = rewriter.create<ttgi::ExtractOp>(loc, tileType,
+                                               wideLoad->getResult(0), 1);
+  rewriter.replaceOp(left, lhs);
+  rewriter.replaceOp(right, rhs);
+}
+
+class CoalesceBlockLoadsPass
+    : public triton::gpu::intel::impl::TritonIntelGPUCoalesceBlockLoadsBase<
+          CoalesceBlockLoadsPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    IRRewriter rewriter(&getContext());
+
+    // Merging a pair of loop carried loads rewrites the enclosing loops, so
+    // restart the search after every merge.
+    while (coalesceOnePair(mod, rewriter))
+      ;
+  }
+
+private:
+  bool coalesceOnePair(ModuleOp mod, IRRewriter &rewriter) {
+    DominanceInfo domInfo(mod);
+    WalkResult result = mod.walk([&](Block *block) {
+      // Loads that may be reordered with respect to each other, i.e. that
+      // aren't separated by an operation writing memory.
+      SmallVector<tt::LoadOp> pending;
+      for (Operation &op : *block) {
+        auto loadOp = dyn_cast<tt::LoadOp>(op);
+        if (!loadOp) {
+          if (mayWriteMemory(&op))
+            pending.clear();
+          continue;
+        }
+        if (!isCandidate(loadOp))
+          continue;
+
+        for (tt::LoadOp prev : pending) {
+          if (prev->getAttrDictionary() != loadOp->getAttrDictionary() ||
+              prev.getPtr().getType() != loadOp.getPtr().getType())
+            continue;
+
+          std::optional<TileDelta> delta =
+              getTileDelta(prev.getPtr(), loadOp.getPtr());
+          if (!delta || (*delta)[0] != 0 ||
+              std::abs((*delta)[1]) != blockWidth)
+            continue;
+
+          // The merged load replaces `prev`, so it must be able to use the
+          // pointer of the leftmost tile there.
+          bool prevIsLeft = (*delta)[1] > 0;
+          if (!prevIsLeft && !domInfo.properlyDominates(loadOp.getPtr(), prev))
+            continue;
+
+          LLVM_DEBUG(llvm::dbgs() << "Coalescing " << prev << "\n  and "
+                                  << loadOp << "\n");
+          mergeLoads(prevIsLeft ? prev : loadOp, prevIsLeft ? loadOp : prev,
+                     prev, rewriter);
+          return WalkResult::interrupt();
+        }
+        pending.push_back(loadOp);
+      }
+      return WalkResult::advance();
+    });
+    return result.wasInterrupted();
+  }
+};
+
+} // namespace
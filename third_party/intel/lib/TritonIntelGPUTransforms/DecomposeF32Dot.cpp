@@ -0,0 +1,107 @@
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+
+#define DEBUG_TYPE "tritonintelgpu-decompose-f32-dot"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttgi = mlir::triton::gpu::intel;
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUDECOMPOSEF32DOT
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+namespace {
+
+/// Decomposes an FP32 `tt.dot` with the `tf32x3` or `bf16x3` input precision:
+///   dot(a, b, c) -> dot(hi(a), hi(b), dot(hi(a), lo(b), dot(lo(a), hi(b), c)))
+/// where `hi(x)` is `x` rounded to TF32 (resp. BF16) and `lo(x) = x - hi(x)`.
+class DecomposeF32Dot : public OpRewritePattern<tt::DotOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tt::DotOp dotOp,
+                                PatternRewriter &rewriter) const override {
+    tt::InputPrecision precision = dotOp.getInputPrecision();
+    if (precision != tt::InputPrecision::TF32x3 &&
+        precision != tt::InputPrecision::BF16x3)
+      return failure();
+
+    auto isF32 = [](Value value) {
+      return getElementTypeOrSelf(value.getType()).isF32();
+    };
+    if (!isF32(dotOp.getA()) || !isF32(dotOp.getB()) || !isF32(dotOp.getC()))
+      return failure();
+
+    Location loc = dotOp.getLoc();
+    auto withElementType = [](Value value, Type elemTy) {
+      return cast<RankedTensorType>(value.getType()).clone(elemTy);
+    };
+
+    // Returns the high and low parts of `x`.
+    auto split = [&](Value x) -> std::pair<Value, Value> {
+      if (precision == tt::InputPrecision::TF32x3) {
+        // The TF32 DPAS only reads the 10 high bits of the FP32 mantissa, so
+        // truncating them makes the low part exact.
+        RankedTensorType intTy = withElementType(x, rewriter.getI32Type());
+        Value mask = rewriter.create<arith::ConstantOp>(
+            loc, intTy, DenseElementsAttr::get(intTy, APInt(32, 0xFFFFE000)));
+        Value bits = rewriter.create<arith::BitcastOp>(loc, intTy, x);
+        Value hi = rewriter.create<arith::BitcastOp>(
+            loc, x.getType(), rewriter.create<arith::AndIOp>(loc, bits, mask));
+        return {hi, rewriter.create<arith::SubFOp>(loc, x, hi)};
+      }
+      RankedTensorType bf16Ty = withElementType(x, rewriter.getBF16Type());
+      Value hi = rewriter.create<arith::TruncFOp>(loc, bf16Ty, x);
+      Value rest = rewriter.create<arith::SubFOp>(
+          loc, x, rewriter.create<arith::ExtFOp>(loc, x.getType(), hi));
+      return {hi, rewriter.create<arith::TruncFOp>(loc, bf16Ty, rest)};
+    };
+
+    // BF16 operands use the BF16 DPAS whatever the input precision.
+    tt::InputPrecision dpasPrecision = precision == tt::InputPrecision::TF32x3
+                                           ? tt::InputPrecision::TF32
+                                           : tt::InputPrecision::IEEE;
+    auto dot = [&](Value a, Value b, Value c) -> Value {
+      return rewriter.create<tt::DotOp>(loc, c.getType(), a, b, c,
+                                        dpasPrecision,
+                                        dotOp.getMaxNumImpreciseAcc());
+    };
+
+    auto [aHi, aLo] = split(dotOp.getA());
+    auto [bHi, bLo] = split(dotOp.getB());
+    // Accumulate the smallest terms first.
+    Value acc = dot(aLo, bHi, dotOp.getC());
+    acc = dot(aHi, bLo, acc);
+    rewriter.replaceOp(dotOp, dot(aHi, bHi, acc));
+    return success();
+  }
+};
+
+class TritonIntelGPUDecomposeF32DotPass
+    : public triton::gpu::intel::impl::TritonIntelGPUDecomposeF32DotBase<
+          TritonIntelGPUDecomposeF32DotPass> {
+public:
+  using triton::gpu::intel::impl::TritonIntelGPUDecomposeF32DotBase<
+      TritonIntelGPUDecomposeF32DotPass>::TritonIntelGPUDecomposeF32DotBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    ModuleOp mod = getOperation();
+    // Without DPAS, the FMA lowering computes the dots in FP32.
+    if (!mod->hasAttr(ttgi::TritonIntelGPUDialect::getSupportDPASAttrName()))
+      return;
+
+    RewritePatternSet patterns(context);
+    patterns.add<DecomposeF32Dot>(context);
+    if (applyPatternsAndFoldGreedily(mod, std::move(patterns)).failed())
+      signalPassFailure();
+  }
+};
+
+} // namespace
@@ -40,6 +40,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 
 #include "Dialect/TritonIntelGPU/IR/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -282,6 +283,7 @@ public:
     });
 
     initNativeOperationSizes(workload);
+    enableInstrSched = tools::getBoolEnv("TRITON_INTEL_ENABLE_INSTR_SCHED");
 
     // this is ad-hoc for flash attention load/store Q on SLM
     if (tools::getBoolEnv("TRITON_INTEL_ENABLE_FIRST_LOAD_TO_SLM"))
@@ -412,6 +414,10 @@ private:
 
   /// Dot ops that use operands from SLM(outer loop)
   DenseSet<Value> dotWithSLMOperands;
+
+  /// Whether the sub-dots are annotated for the instruction scheduler. Read
+  /// once per run so the transformations do not query the environment.
+  bool enableInstrSched = false;
 };
 
 /// Simplify arith operations with constant RHS.
@@ -821,6 +827,23 @@ static Value hackAlloc(OpBuilder &b, Location loc, Type ptrTy, int64_t size) {
   return func.getArguments().back();
 }
 
+/// Combine \p subVals pairwise with the operation \p id until a single value
+/// of type \p subType is left. The number of values must be a power of two.
+static Value combineSubVals(OpBuilder &b, Location loc, StringAttr id,
+                            ArrayRef<Value> subVals, Type subType) {
+  assert(llvm::isPowerOf2_64(subVals.size()) &&
+         "Expecting a power of two number of values");
+  SmallVector<Value> vals(subVals);
+  while (vals.size() > 1) {
+    SmallVector<Value> accs;
+    for (unsigned i = 0; i < vals.size(); i += 2)
+      accs.push_back(
+          b.create(loc, id, {vals[i], vals[i + 1]}, subType)->getResult(0));
+    vals = std::move(accs);
+  }
+  return vals.front();
+}
+
 static SmallVector<Value> glueForReduction(OpBuilder &builder, Location loc,
                                            ArrayRef<Value> subVals) {
   assert(subVals.size() % 2 == 0 && "Expecting even number of values");
@@ -895,27 +918,7 @@ void MatchTargetSizePass::transformTransposedReduceOp(tt::ReduceOp op) {
     Type subType = dstType;
     auto combine = op.getCombineOp().front().getOperations().begin();
     StringAttr id = combine->getName().getIdentifier();
-    Value acc;
-    switch (subVals.size()) {
-    case 1:
-      acc = subVals[0];
-      break;
-    case 2: {
-      Operation *acc01 = b.create(loc, id, {subVals[0], subVals[1]}, subType);
-      acc = acc01->getResult(0);
-      break;
-    }
-    case 4: {
-      Operation *acc01 = b.create(loc, id, {subVals[0], subVals[1]}, subType);
-      Operation *acc23 = b.create(loc, id, {subVals[2], subVals[3]}, subType);
-      Operation *accOp = b.create(
-          loc, id, {acc01->getResult(0), acc23->getResult(0)}, subType);
-      acc = accOp->getResult(0);
-      break;
-    }
-    default:
-      assert(false && "add more reduce size support");
-    }
+    Value acc = combineSubVals(b, loc, id, subVals, subType);
 
     Value accT = b.create<ttgi::SubGroupTransposeOp>(loc, acc.getType(),
                                                      localBuffer, acc);
@@ -966,27 +969,7 @@ void MatchTargetSizePass::transformReduceOp(tt::ReduceOp op) {
     auto subType = RankedTensorType::get({step, 16}, srcTy.getElementType());
     auto combine = op.getCombineOp().front().getOperations().begin();
     StringAttr id = combine->getName().getIdentifier();
-    Value acc;
-    switch (subVals.size()) {
-    case 1:
-      acc = subVals[0];
-      break;
-    case 2: {
-      Operation *acc01 = b.create(loc, id, {subVals[0], subVals[1]}, subType);
-      acc = acc01->getResult(0);
-      break;
-    }
-    case 4: {
-      Operation *acc01 = b.create(loc, id, {subVals[0], subVals[1]}, subType);
-      Operation *acc23 = b.create(loc, id, {subVals[2], subVals[3]}, subType);
-      Operation *accOp = b.create(
-          loc, id, {acc01->getResult(0), acc23->getResult(0)}, subType);
-      acc = accOp->getResult(0);
-      break;
-    }
-    default:
-      assert(false && "add more reduce size support");
-    }
+    Value acc = combineSubVals(b, loc, id, subVals, subType);
 
     SmallVector<Value> subOps;
     for (unsigned j = 0; j < step; j++) {
@@ -1141,7 +1124,7 @@ void MatchTargetSizePass::transformDotOp(tt::DotOp dot) {
                                       dot.getInputPrecisionAttr(),
                                       dot.getMaxNumImpreciseAccAttr());
         // hack for attention
-        if (triton::tools::getBoolEnv("TRITON_INTEL_ENABLE_INSTR_SCHED"))
+        if (enableInstrSched)
           if (auto definingOp = subDotC.getDefiningOp())
             definingOp->setAttr(
                 "schedule-group",
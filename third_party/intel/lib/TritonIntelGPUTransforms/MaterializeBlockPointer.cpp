@@ -1,7 +1,9 @@
 #include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
 #include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
 #include "intel/include/Dialect/TritonIntelGPU/Transforms/Utility.h"
+#include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Visitors.h"
 #include "triton/Analysis/Utility.h"
 
@@ -16,6 +18,32 @@ namespace mlir::triton::gpu::intel {
 
 namespace {
 
+/// Returns whether the pointer \p ptr is computed from values loaded from
+/// memory, e.g. the base of a page of a paged KV cache read from a block table.
+bool isIndirect(Value ptr) {
+  SetVector<Operation *> slice;
+  BackwardSliceOptions options;
+  options.omitBlockArguments = true;
+  getBackwardSlice(ptr, &slice, options);
+  return llvm::any_of(slice,
+                      [](Operation *op) { return isa<tt::LoadOp>(op); });
+}
+
+/// Returns whether the pointer \p ptr to elements of \p elemBits bits is not
+/// known to be 64-byte aligned: a kernel argument not specialized on its
+/// alignment, or a pointer offset by a number of elements not known to be a
+/// multiple of 64 bytes, e.g. the base of the im2col window of a tap of an
+/// implicit GEMM convolution.
+bool isUnalignedBase(Value ptr, unsigned elemBits) {
+  if (auto addPtrOp = ptr.getDefiningOp<tt::AddPtrOp>())
+    return !ttgi::isDivisible(addPtrOp.getOffset(), 64 * 8 / elemBits) ||
+           isUnalignedBase(addPtrOp.getPtr(), elemBits);
+  auto blockArg = dyn_cast<BlockArgument>(ptr);
+  return blockArg && blockArg.getOwner()->isEntryBlock() &&
+         isa<tt::FuncOp>(blockArg.getOwner()->getParentOp()) &&
+         !ttgi::isDivisible(ptr, 64);
+}
+
 struct TritonIntelGPUMaterializeBlockPointerPass
     : public triton::gpu::intel::impl::
           TritonIntelGPUMaterializeBlockPointerBase<
@@ -58,16 +86,28 @@ public:
           return;
 
         // Across Intel platforms, the strictest pitch restriction is to be a
-        // multiple of OWord(128 bits).
+        // multiple of OWord(128 bits), and at least 64 bytes.
+        unsigned elemBits = tensorType.getElementTypeBitWidth();
         Value pitch =
             strides[(fastChangeDim == rank - 1) ? rank - 2 : rank - 1];
-        if (!ttgi::isDivisible(pitch, 64 / tensorType.getElementTypeBitWidth()))
+        if (!ttgi::isDivisible(pitch, 128 / elemBits))
+          return;
+        std::optional<int64_t> constPitch = getConstantIntValue(pitch);
+        if (constPitch && *constPitch * elemBits < 64 * 8)
           return;
 
         loadOp->setAttr(ttgi::TritonIntelGPUDialect::getBlockIOAttrName(),
                         StringAttr::get(context, fastChangeDim == rank - 1
                                                      ? "row_major"
                                                      : "column_major"));
+        // The base address must be 64-byte aligned, which the kernel
+        // arguments are when they are specialized on it. The indirect bases
+        // and the bases not known to be aligned are aligned at runtime.
+        Value base = makeTensorPtrOp.getBase();
+        if (isIndirect(base) || isUnalignedBase(base, elemBits))
+          loadOp->setAttr(
+              ttgi::TritonIntelGPUDialect::getBlockIOIndirectBaseAttrName(),
+              UnitAttr::get(context));
       }
     });
   }
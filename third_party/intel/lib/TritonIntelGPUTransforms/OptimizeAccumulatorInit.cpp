@@ -0,0 +1,102 @@
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-optimize-accumulator-init"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttgi = mlir::triton::gpu::intel;
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUOPTIMIZEACCUMULATORINIT
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+namespace {
+
+bool isZeroTensor(Value val) {
+  return matchPattern(val, m_PosZeroFloat()) || matchPattern(val, m_Zero());
+}
+
+/// Returns true if the loop carries the accumulator of a DPAS dot of its body
+/// that is initialized with zero.
+bool hasZeroInitAccumulator(scf::ForOp forOp) {
+  for (BlockArgument arg : forOp.getRegionIterArgs()) {
+    if (!isZeroTensor(forOp.getTiedLoopInit(arg)->get()) || !arg.hasOneUse())
+      continue;
+    auto dotOp = dyn_cast<tt::DotOp>(*arg.getUsers().begin());
+    if (!dotOp || dotOp.getC() != arg ||
+        dotOp->getBlock() != forOp.getBody() ||
+        !isa<ttgi::DpasEncodingAttr>(dotOp.getType().getEncoding()))
+      continue;
+    return true;
+  }
+  return false;
+}
+
+/// Peels the first iteration of \p forOp, in which the loop-carried values
+/// are the initial values of the loop. The accumulators initialized with zero
+/// are then constant in the peeled iteration, so DPAS does not read them from
+/// zero-filled registers.
+void peelFirstIteration(scf::ForOp forOp) {
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value lb = forOp.getLowerBound(), ub = forOp.getUpperBound(),
+        step = forOp.getStep();
+
+  Value hasIters =
+      builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt, lb, ub);
+  auto ifOp = builder.create<scf::IfOp>(loc, forOp.getResultTypes(), hasIters,
+                                        /*withElseRegion=*/true);
+
+  OpBuilder thenBuilder = ifOp.getThenBodyBuilder();
+  IRMapping mapping;
+  mapping.map(forOp.getInductionVar(), lb);
+  mapping.map(forOp.getRegionIterArgs(), forOp.getInitArgs());
+  for (Operation &op : forOp.getBody()->without_terminator())
+    thenBuilder.clone(op, mapping);
+  SmallVector<Value> yielded;
+  for (Value val : forOp.getBody()->getTerminator()->getOperands())
+    yielded.push_back(mapping.lookupOrDefault(val));
+  thenBuilder.create<scf::YieldOp>(loc, yielded);
+
+  OpBuilder elseBuilder = ifOp.getElseBodyBuilder();
+  elseBuilder.create<scf::YieldOp>(loc, forOp.getInitArgs());
+
+  // The loop runs the remaining iterations.
+  forOp.getLowerBoundMutable().assign(
+      builder.create<arith::AddIOp>(loc, lb, step));
+  forOp.getInitArgsMutable().assign(ifOp.getResults());
+  LLVM_DEBUG(llvm::dbgs() << "Peeled first iteration: " << ifOp << "\n");
+}
+
+struct TritonIntelGPUOptimizeAccumulatorInitPass
+    : public triton::gpu::intel::impl::
+          TritonIntelGPUOptimizeAccumulatorInitBase<
+              TritonIntelGPUOptimizeAccumulatorInitPass> {
+public:
+  using triton::gpu::intel::impl::TritonIntelGPUOptimizeAccumulatorInitBase<
+      TritonIntelGPUOptimizeAccumulatorInitPass>::
+      TritonIntelGPUOptimizeAccumulatorInitBase;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+
+    SmallVector<scf::ForOp> loops;
+    mod.walk([&](scf::ForOp forOp) {
+      if (hasZeroInitAccumulator(forOp))
+        loops.push_back(forOp);
+    });
+
+    for (scf::ForOp forOp : loops)
+      peelFirstIteration(forOp);
+  }
+};
+
+} // namespace
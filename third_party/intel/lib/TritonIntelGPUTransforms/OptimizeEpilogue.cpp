@@ -0,0 +1,196 @@
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/IR/Types.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-optimize-epilogue"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+namespace ttgi = mlir::triton::gpu::intel;
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUOPTIMIZEEPILOGUE
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+namespace {
+
+/// Returns true if \p val is the same value in every element, i.e. it can be
+/// recreated in any layout.
+bool isSplat(Value val) {
+  if (val.getDefiningOp<tt::SplatOp>())
+    return true;
+  auto constantOp = val.getDefiningOp<arith::ConstantOp>();
+  auto attr =
+      constantOp ? dyn_cast<DenseElementsAttr>(constantOp.getValue()) : nullptr;
+  return attr && attr.isSplat();
+}
+
+/// Recreates the splat \p val with the encoding \p encoding.
+Value getSplatAs(PatternRewriter &rewriter, Value val, Attribute encoding) {
+  auto type = cast<RankedTensorType>(val.getType());
+  auto newType = RankedTensorType::get(type.getShape(), type.getElementType(),
+                                       encoding);
+  if (auto splatOp = val.getDefiningOp<tt::SplatOp>())
+    return rewriter.create<tt::SplatOp>(splatOp.getLoc(), newType,
+                                        splatOp.getSrc());
+  auto constantOp = val.getDefiningOp<arith::ConstantOp>();
+  auto attr = cast<DenseElementsAttr>(constantOp.getValue());
+  return rewriter.create<arith::ConstantOp>(
+      constantOp.getLoc(),
+      DenseElementsAttr::get(newType, attr.getSplatValue<Attribute>()));
+}
+
+/// Returns the operand of the elementwise operation \p op the epilogue is
+/// computed from, if all its other operands are splats.
+std::optional<unsigned> getEpilogueOperand(Operation *op) {
+  if (!op->hasTrait<OpTrait::Elementwise>() || op->getNumResults() != 1 ||
+      !isMemoryEffectFree(op) || !op->hasOneUse())
+    return std::nullopt;
+  std::optional<unsigned> index;
+  for (OpOperand &operand : op->getOpOperands()) {
+    if (!isa<RankedTensorType>(operand.get().getType()) ||
+        isSplat(operand.get()))
+      continue;
+    if (index)
+      return std::nullopt;
+    index = operand.getOperandNumber();
+  }
+  return index;
+}
+
+// convert(acc) : dpas -> blocked
+// elementwise(val, splat) : blocked
+// ...
+// tt.store(ptr, val, mask) : blocked
+// ==>
+// elementwise(acc, splat) : dpas
+// ...
+// tt.store(ptr', val, mask') : dpas
+//
+// The pointer is recreated with the DPAS layout if it is a block pointer, so
+// that the tile is written with 2D block stores, otherwise the pointers and
+// the mask are converted to the DPAS layout, which the layout conversion
+// removal rematerializes. The epilogue is then computed per DPAS tile without
+// exchanging the accumulator through shared local memory, and the math of a
+// tile overlaps the outstanding stores of the previous tiles.
+class StoreDpasResult : public OpRewritePattern<tt::StoreOp> {
+public:
+  using OpRewritePattern<tt::StoreOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tt::StoreOp storeOp,
+                                PatternRewriter &rewriter) const override {
+    auto valType = dyn_cast<RankedTensorType>(storeOp.getValue().getType());
+    if (!valType || !isa<ttg::BlockedEncodingAttr>(valType.getEncoding()))
+      return failure();
+
+    bool isBlockPtr = tt::isTensorPointerType(storeOp.getPtr().getType());
+    auto makeTensorPtrOp =
+        storeOp.getPtr().getDefiningOp<tt::MakeTensorPtrOp>();
+    if (isBlockPtr &&
+        (!makeTensorPtrOp ||
+         !storeOp->getParentOfType<ModuleOp>()->hasAttr(
+             ttgi::TritonIntelGPUDialect::getSupportSG2DBlockAttrName())))
+      return failure();
+
+    // Collect the epilogue operations up to the conversion of the
+    // accumulator.
+    SmallVector<std::pair<Operation *, unsigned>> epilogue;
+    Value val = storeOp.getValue();
+    while (!val.getDefiningOp<ttg::ConvertLayoutOp>()) {
+      Operation *op = val.getDefiningOp();
+      std::optional<unsigned> index =
+          op ? getEpilogueOperand(op) : std::nullopt;
+      if (!index)
+        return failure();
+      epilogue.emplace_back(op, *index);
+      val = op->getOperand(*index);
+    }
+
+    auto cvtOp = val.getDefiningOp<ttg::ConvertLayoutOp>();
+    Attribute encoding = cvtOp.getSrc().getType().getEncoding();
+    if (!isa<ttgi::DpasEncodingAttr>(encoding) ||
+        !cvtOp.getResult().hasOneUse())
+      return failure();
+
+    LLVM_DEBUG(llvm::dbgs() << "Storing with the DPAS layout: " << storeOp
+                            << "\n");
+    auto getTypeAs = [&](Type type) {
+      auto tensorType = cast<RankedTensorType>(type);
+      return RankedTensorType::get(tensorType.getShape(),
+                                   tensorType.getElementType(), encoding);
+    };
+
+    Value newVal = cvtOp.getSrc();
+    for (auto [op, index] : llvm::reverse(epilogue)) {
+      rewriter.setInsertionPoint(op);
+      SmallVector<Value> operands(op->getOperands());
+      for (auto [i, operand] : llvm::enumerate(operands)) {
+        if (i == index)
+          operand = newVal;
+        else if (isa<RankedTensorType>(operand.getType()))
+          operand = getSplatAs(rewriter, operand, encoding);
+      }
+      rewriter.modifyOpInPlace(op, [&]() {
+        op->setOperands(operands);
+        op->getResult(0).setType(getTypeAs(op->getResult(0).getType()));
+      });
+      newVal = op->getResult(0);
+    }
+
+    rewriter.setInsertionPoint(storeOp);
+    if (isBlockPtr) {
+      auto ptrType = cast<tt::PointerType>(makeTensorPtrOp.getType());
+      auto newPtrType = tt::PointerType::get(
+          getTypeAs(ptrType.getPointeeType()), ptrType.getAddressSpace());
+      Value newPtr = rewriter.create<tt::MakeTensorPtrOp>(
+          makeTensorPtrOp.getLoc(), newPtrType, makeTensorPtrOp.getBase(),
+          makeTensorPtrOp.getShape(), makeTensorPtrOp.getStrides(),
+          makeTensorPtrOp.getOffsets(), makeTensorPtrOp.getOrderAttr());
+      rewriter.replaceOpWithNewOp<tt::StoreOp>(
+          storeOp, newPtr, newVal, storeOp.getBoundaryCheck(),
+          storeOp.getCache(), storeOp.getEvict());
+      return success();
+    }
+
+    Value ptr = storeOp.getPtr();
+    Value newPtr = rewriter.create<ttg::ConvertLayoutOp>(
+        ptr.getLoc(), getTypeAs(ptr.getType()), ptr);
+    Value newMask = storeOp.getMask();
+    if (newMask)
+      newMask = rewriter.create<ttg::ConvertLayoutOp>(
+          newMask.getLoc(), getTypeAs(newMask.getType()), newMask);
+    rewriter.replaceOpWithNewOp<tt::StoreOp>(
+        storeOp, newPtr, newVal, newMask, storeOp.getCache(),
+        storeOp.getEvict());
+    return success();
+  }
+};
+
+struct TritonIntelGPUOptimizeEpiloguePass
+    : public triton::gpu::intel::impl::TritonIntelGPUOptimizeEpilogueBase<
+          TritonIntelGPUOptimizeEpiloguePass> {
+public:
+  using triton::gpu::intel::impl::TritonIntelGPUOptimizeEpilogueBase<
+      TritonIntelGPUOptimizeEpiloguePass>::TritonIntelGPUOptimizeEpilogueBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    ModuleOp mod = getOperation();
+
+    RewritePatternSet patterns(context);
+    patterns.add<StoreDpasResult>(context);
+    if (applyPatternsAndFoldGreedily(mod, std::move(patterns)).failed())
+      signalPassFailure();
+  }
+};
+
+} // namespace
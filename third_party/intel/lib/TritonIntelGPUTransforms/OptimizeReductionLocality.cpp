@@ -0,0 +1,139 @@
+//===- OptimizeReductionLocality.cpp ------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the selection of the layouts of the reductions for
+/// Intel GPUs, keeping whole reduction rows within one sub-group. The rows are
+/// then reduced with sub-group operations only, without the SLM round-trip
+/// and the barrier of the reductions across the sub-groups of a work-group.
+//===----------------------------------------------------------------------===//
+
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-optimize-reduction-locality"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUOPTIMIZEREDUCTIONLOCALITY
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+
+namespace {
+
+/// Largest number of elements of a reduction row held by a work-item, beyond
+/// which the rows are spread over the sub-groups to limit register pressure.
+constexpr int64_t maxRowElemsPerThread = 64;
+
+/// Returns the layout of \p type distributing the warps along the dimensions
+/// other than \p axis, so that the rows reduced along \p axis are held by a
+/// single sub-group, or a null attribute if the rows already are, do not fit
+/// in the registers of a sub-group, or are too few for all the warps.
+ttg::BlockedEncodingAttr getSubGroupEncoding(RankedTensorType type,
+                                             unsigned axis, unsigned numWarps,
+                                             unsigned threadsPerWarp) {
+  auto blocked = dyn_cast<ttg::BlockedEncodingAttr>(type.getEncoding());
+  if (!blocked || blocked.getWarpsPerCTA()[axis] == 1)
+    return {};
+  SmallVector<int64_t> shapePerCTA = ttg::getShapePerCTA(type);
+  if (shapePerCTA[axis] > maxRowElemsPerThread * threadsPerWarp)
+    return {};
+
+  // The lanes cover the rows first, then the other dimensions along the
+  // order. The lanes left over are replicated along the rows.
+  unsigned rank = type.getRank();
+  ArrayRef<unsigned> order = blocked.getOrder();
+  SmallVector<unsigned> sizePerThread(blocked.getSizePerThread());
+  SmallVector<unsigned> threads(rank, 1), warps(rank, 1);
+  unsigned remainingLanes = threadsPerWarp;
+  threads[axis] = std::min<int64_t>(
+      remainingLanes,
+      std::max<int64_t>(shapePerCTA[axis] / sizePerThread[axis], 1));
+  remainingLanes /= threads[axis];
+  for (unsigned d : order) {
+    if (d == axis)
+      continue;
+    int64_t numChunks = shapePerCTA[d] / sizePerThread[d];
+    threads[d] = std::min<int64_t>(remainingLanes,
+                                   std::max<int64_t>(numChunks, 1));
+    remainingLanes /= threads[d];
+  }
+  threads[axis] *= remainingLanes;
+
+  unsigned remainingWarps = numWarps;
+  for (unsigned d : order) {
+    if (d == axis)
+      continue;
+    int64_t numChunks = shapePerCTA[d] / (sizePerThread[d] * threads[d]);
+    warps[d] = std::min<int64_t>(remainingWarps,
+                                 std::max<int64_t>(numChunks, 1));
+    remainingWarps /= warps[d];
+  }
+  // The warps left over would hold copies of the same rows.
+  if (remainingWarps != 1)
+    return {};
+
+  return ttg::BlockedEncodingAttr::get(type.getContext(), sizePerThread,
+                                       threads, warps, order,
+                                       blocked.getCTALayout());
+}
+
+struct OptimizeReductionLocalityPass
+    : public ttg::intel::impl::TritonIntelGPUOptimizeReductionLocalityBase<
+          OptimizeReductionLocalityPass> {
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    int numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
+    int threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+
+    SmallVector<tt::ReduceOp> reduceOps;
+    mod.walk([&](tt::ReduceOp reduceOp) { reduceOps.push_back(reduceOp); });
+
+    for (tt::ReduceOp reduceOp : reduceOps) {
+      auto srcType =
+          cast<RankedTensorType>(reduceOp.getOperands()[0].getType());
+      unsigned axis = reduceOp.getAxis();
+      ttg::BlockedEncodingAttr encoding =
+          getSubGroupEncoding(srcType, axis, numWarps, threadsPerWarp);
+      if (!encoding)
+        continue;
+      LDBG("Reducing " << reduceOp << " with " << encoding);
+
+      // The operands are converted to the new layout, and the results back to
+      // the layout of their users.
+      OpBuilder builder(reduceOp);
+      Location loc = reduceOp.getLoc();
+      for (OpOperand &operand : reduceOp->getOpOperands()) {
+        auto type = cast<RankedTensorType>(operand.get().getType());
+        auto newType = RankedTensorType::get(type.getShape(),
+                                             type.getElementType(), encoding);
+        operand.set(
+            builder.create<ttg::ConvertLayoutOp>(loc, newType, operand.get()));
+      }
+      builder.setInsertionPointAfter(reduceOp);
+      auto sliceEncoding =
+          ttg::SliceEncodingAttr::get(&getContext(), axis, encoding);
+      for (OpResult result : reduceOp->getResults()) {
+        auto type = cast<RankedTensorType>(result.getType());
+        result.setType(RankedTensorType::get(
+            type.getShape(), type.getElementType(), sliceEncoding));
+        auto cvt = builder.create<ttg::ConvertLayoutOp>(loc, type, result);
+        result.replaceAllUsesExcept(cvt, cvt);
+      }
+    }
+  }
+};
+
+} // namespace
@@ -0,0 +1,211 @@
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-peel-masked-tail"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUPEELMASKEDTAIL
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+namespace {
+
+/// A load or store in the body of a loop accessing a loop-carried block
+/// pointer advanced by a loop-invariant step at each iteration.
+struct Candidate {
+  Operation *op;
+  tt::MakeTensorPtrOp makeTensorPtrOp;
+  tt::AdvanceOp advanceOp;
+  /// The checked dimensions advanced by the loop.
+  SmallVector<int32_t> dims;
+};
+
+template <typename OpTy>
+std::optional<Candidate> getCandidate(OpTy op, scf::ForOp forOp) {
+  ArrayRef<int32_t> boundaryCheck = op.getBoundaryCheck();
+  if (boundaryCheck.empty())
+    return std::nullopt;
+
+  auto blockArg = dyn_cast<BlockArgument>(op.getPtr());
+  if (!blockArg || blockArg.getOwner() != forOp.getBody() ||
+      blockArg == forOp.getInductionVar())
+    return std::nullopt;
+
+  Value init = forOp.getTiedLoopInit(blockArg)->get();
+  auto makeTensorPtrOp = init.getDefiningOp<tt::MakeTensorPtrOp>();
+  if (!makeTensorPtrOp)
+    return std::nullopt;
+
+  Value yielded = forOp.getTiedLoopYieldedValue(blockArg)->get();
+  auto advanceOp = yielded.getDefiningOp<tt::AdvanceOp>();
+  if (!advanceOp || advanceOp.getPtr() != blockArg)
+    return std::nullopt;
+
+  Candidate candidate{op, makeTensorPtrOp, advanceOp, {}};
+  for (int32_t dim : boundaryCheck) {
+    Value step = advanceOp.getOffsets()[dim];
+    if (!forOp.isDefinedOutsideOfLoop(step) || matchPattern(step, m_Zero()))
+      continue;
+    candidate.dims.push_back(dim);
+  }
+  if (candidate.dims.empty())
+    return std::nullopt;
+  return candidate;
+}
+
+/// Drops the dimensions \p dims from the boundary check of \p op.
+template <typename OpTy>
+void dropBoundaryCheck(OpTy op, ArrayRef<int32_t> dims) {
+  SmallVector<int32_t> boundaryCheck;
+  for (int32_t dim : op.getBoundaryCheck())
+    if (!llvm::is_contained(dims, dim))
+      boundaryCheck.push_back(dim);
+  op.setBoundaryCheckAttr(
+      DenseI32ArrayAttr::get(op.getContext(), boundaryCheck));
+}
+
+class LoopPeeler {
+public:
+  LoopPeeler(scf::ForOp forOp, ArrayRef<Candidate> candidates)
+      : forOp(forOp), candidates(candidates) {}
+
+  void peel() {
+    OpBuilder builder(forOp);
+    Location loc = forOp.getLoc();
+    Value lb = forOp.getLowerBound(), ub = forOp.getUpperBound(),
+          step = forOp.getStep();
+    Type ivTy = lb.getType();
+
+    // The main loop runs all the iterations but the last one.
+    Value zero =
+        builder.create<arith::ConstantOp>(loc, ivTy, builder.getZeroAttr(ivTy));
+    Value one = builder.create<arith::ConstantOp>(
+        loc, ivTy, builder.getIntegerAttr(ivTy, 1));
+    Value numIters = builder.create<arith::CeilDivSIOp>(
+        loc, builder.create<arith::SubIOp>(loc, ub, lb), step);
+    Value numMainIters = builder.create<arith::MaxSIOp>(
+        loc, builder.create<arith::SubIOp>(loc, numIters, one), zero);
+    Value lastIter = toI64(
+        builder, loc, builder.create<arith::SubIOp>(loc, numMainIters, one));
+
+    // The accesses of the main loop are in bounds when they are at its first
+    // and last iterations, as the offsets are advanced by a constant step.
+    Value inBounds;
+    for (const Candidate &candidate : candidates) {
+      auto tensorType = cast<RankedTensorType>(
+          cast<tt::PointerType>(candidate.makeTensorPtrOp.getType())
+              .getPointeeType());
+      for (int32_t dim : candidate.dims) {
+        Value shape = candidate.makeTensorPtrOp.getShape()[dim];
+        Value blockDim = builder.create<arith::ConstantOp>(
+            loc, builder.getI64IntegerAttr(tensorType.getShape()[dim]));
+        Value first =
+            toI64(builder, loc, candidate.makeTensorPtrOp.getOffsets()[dim]);
+        Value stride =
+            toI64(builder, loc, candidate.advanceOp.getOffsets()[dim]);
+        Value last = builder.create<arith::AddIOp>(
+            loc, first, builder.create<arith::MulIOp>(loc, lastIter, stride));
+        for (Value offset : {first, last}) {
+          inBounds = andCond(builder, loc, inBounds,
+                             isInBounds(builder, loc, offset, blockDim, shape));
+        }
+      }
+    }
+
+    Value mainUB = builder.create<arith::SelectOp>(
+        loc, inBounds,
+        builder.create<arith::AddIOp>(
+            loc, lb, builder.create<arith::MulIOp>(loc, numMainIters, step)),
+        lb);
+
+    IRMapping mapping;
+    auto mainLoop = cast<scf::ForOp>(builder.clone(*forOp, mapping));
+    mainLoop.getUpperBoundMutable().assign(mainUB);
+    for (const Candidate &candidate : candidates) {
+      Operation *op = mapping.lookup(candidate.op);
+      if (auto loadOp = dyn_cast<tt::LoadOp>(op))
+        dropBoundaryCheck(loadOp, candidate.dims);
+      else
+        dropBoundaryCheck(cast<tt::StoreOp>(op), candidate.dims);
+    }
+
+    // The original loop runs the remaining iterations.
+    forOp.getLowerBoundMutable().assign(mainUB);
+    forOp.getInitArgsMutable().assign(mainLoop.getResults());
+    LLVM_DEBUG(llvm::dbgs() << "Peeled masked tail of loop: " << mainLoop
+                            << "\n");
+  }
+
+private:
+  static Value toI64(OpBuilder &builder, Location loc, Value val) {
+    Type i64Ty = builder.getI64Type();
+    if (val.getType().isIndex())
+      return builder.create<arith::IndexCastOp>(loc, i64Ty, val);
+    if (val.getType() == i64Ty)
+      return val;
+    return builder.create<arith::ExtSIOp>(loc, i64Ty, val);
+  }
+
+  static Value isInBounds(OpBuilder &builder, Location loc, Value offset,
+                          Value blockDim, Value shape) {
+    Value zero =
+        builder.create<arith::ConstantOp>(loc, builder.getI64IntegerAttr(0));
+    Value end = builder.create<arith::AddIOp>(loc, offset, blockDim);
+    return builder.create<arith::AndIOp>(
+        loc,
+        builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sge, offset,
+                                      zero),
+        builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sle, end,
+                                      shape));
+  }
+
+  static Value andCond(OpBuilder &builder, Location loc, Value lhs,
+                       Value rhs) {
+    return lhs ? builder.create<arith::AndIOp>(loc, lhs, rhs) : rhs;
+  }
+
+  scf::ForOp forOp;
+  ArrayRef<Candidate> candidates;
+};
+
+struct TritonIntelGPUPeelMaskedTailPass
+    : public triton::gpu::intel::impl::TritonIntelGPUPeelMaskedTailBase<
+          TritonIntelGPUPeelMaskedTailPass> {
+public:
+  using triton::gpu::intel::impl::TritonIntelGPUPeelMaskedTailBase<
+      TritonIntelGPUPeelMaskedTailPass>::TritonIntelGPUPeelMaskedTailBase;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+
+    SmallVector<std::pair<scf::ForOp, SmallVector<Candidate>>> loops;
+    mod.walk([&](scf::ForOp forOp) {
+      SmallVector<Candidate> candidates;
+      for (Operation &op : forOp.getBody()->without_terminator()) {
+        std::optional<Candidate> candidate =
+            TypeSwitch<Operation *, std::optional<Candidate>>(&op)
+                .Case<tt::LoadOp, tt::StoreOp>(
+                    [&](auto op) { return getCandidate(op, forOp); })
+                .Default([](Operation *) { return std::nullopt; });
+        if (candidate)
+          candidates.push_back(*candidate);
+      }
+      if (!candidates.empty())
+        loops.emplace_back(forOp, std::move(candidates));
+    });
+
+    for (auto &[forOp, candidates] : loops)
+      LoopPeeler(forOp, candidates).peel();
+  }
+};
+
+} // namespace
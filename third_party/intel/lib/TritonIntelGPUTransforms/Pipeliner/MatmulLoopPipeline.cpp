@@ -120,11 +120,118 @@ static std::optional<LoadDotOperand> loadDotOperand(tt::LoadOp loadOp) {
   return std::nullopt;
 }
 
+/// Return true if the given load can be staged through shared local memory,
+/// i.e. its result is only converted to a dot operand layout.
+static bool canStageInSLM(const LoadDotOperand &loadOperand) {
+  tt::LoadOp loadOp = loadOperand.load;
+  auto tensorType = dyn_cast<RankedTensorType>(loadOp.getType());
+  if (!tensorType || tensorType.getRank() != 2 ||
+      isa<ttg::DotOperandEncodingAttr>(tensorType.getEncoding()))
+    return false;
+  return llvm::all_of(loadOp->getUsers(), [](Operation *user) {
+    return isa<ttg::ConvertLayoutOp>(user);
+  });
+}
+
+/// Stage the given loads through a buffer of `numStages` tiles in shared local
+/// memory. The global load of iteration `i` writes the data into slot
+/// `i % numStages`, which the dot operations read back with the dot operand
+/// layout. The schedule created later on issues the global loads and shared
+/// memory stores `numStages - 1` iterations ahead of the dot operations. The
+/// barriers required between the stores and the loads are inserted by the
+/// memory barrier analysis after shared memory allocation.
+static void createSLMStaging(scf::ForOp &forOp, ArrayRef<LoadDotOperand> loads,
+                             int numStages) {
+  assert(!loads.empty() && "Expecting at least one load operation");
+  MLIRContext *ctx = forOp.getContext();
+  Location loc = forOp.getLoc();
+  OpBuilder builder(forOp);
+  Value iv = forOp.getInductionVar();
+  Value numBuffers = builder.create<arith::ConstantOp>(
+      loc, builder.getIntegerAttr(iv.getType(), numStages));
+  Value zero = builder.create<arith::ConstantIntOp>(loc, 0, 32);
+  Attribute sharedMemorySpace = ttg::SharedMemorySpaceAttr::get(ctx);
+
+  // Create the computation of the buffer slot used by the current iteration.
+  // Producers and consumers get their own copy since they end up in
+  // different pipeline stages.
+  auto createSlot = [&](OpBuilder &b) -> Value {
+    Value iter = b.create<arith::DivSIOp>(
+        loc, b.create<arith::SubIOp>(loc, iv, forOp.getLowerBound()),
+        forOp.getStep());
+    Value slot = b.create<arith::RemSIOp>(loc, iter, numBuffers);
+    if (!slot.getType().isInteger(32))
+      slot = b.create<arith::TruncIOp>(loc, b.getI32Type(), slot);
+    return slot;
+  };
+
+  for (const LoadDotOperand &loadOperand : loads) {
+    tt::LoadOp loadOp = loadOperand.load;
+    auto tensorType = cast<RankedTensorType>(loadOp.getType());
+    Attribute encoding = tensorType.getEncoding();
+    auto sharedEncoding = ttg::SharedEncodingAttr::get(
+        ctx, loadOperand.dotOperandEncoding, tensorType.getShape(),
+        ttg::getOrder(encoding), ttg::getCTALayout(encoding),
+        tensorType.getElementType());
+
+    SmallVector<int64_t> bufferShape(tensorType.getShape());
+    bufferShape.insert(bufferShape.begin(), numStages);
+    auto bufferType = tt::MemDescType::get(
+        bufferShape, tensorType.getElementType(), sharedEncoding,
+        sharedMemorySpace, /*mutableMemory=*/true);
+    auto tileType = tt::MemDescType::get(
+        tensorType.getShape(), tensorType.getElementType(), sharedEncoding,
+        sharedMemorySpace, /*mutableMemory=*/true);
+
+    builder.setInsertionPoint(forOp);
+    Value buffer =
+        builder.create<ttg::LocalAllocOp>(loc, bufferType, Value()).getResult();
+    builder.setInsertionPointAfter(forOp);
+    builder.create<ttg::LocalDeallocOp>(loc, buffer);
+
+    auto createView = [&](OpBuilder &b) -> Value {
+      SmallVector<Value> offsets(bufferShape.size(), zero);
+      offsets[0] = createSlot(b);
+      return b.create<ttg::MemDescSubviewOp>(loc, tileType, buffer, offsets);
+    };
+
+    builder.setInsertionPointAfter(loadOp);
+    builder.create<ttg::LocalStoreOp>(loc, loadOp, createView(builder));
+
+    SmallVector<Operation *> users(loadOp->getUsers());
+    for (Operation *user : users) {
+      auto cvtOp = dyn_cast<ttg::ConvertLayoutOp>(user);
+      if (!cvtOp)
+        continue;
+      builder.setInsertionPoint(cvtOp);
+      auto localLoad = builder.create<ttg::LocalLoadOp>(
+          cvtOp.getLoc(), cvtOp.getType(), createView(builder));
+      cvtOp.replaceAllUsesWith(localLoad.getResult());
+      cvtOp.erase();
+    }
+  }
+}
+
+/// Return the size in bytes of the shared local memory buffers staging the
+/// given loads over `numStages` iterations.
+static uint64_t getSLMStagingSize(ArrayRef<LoadDotOperand> loads,
+                                  int numStages) {
+  uint64_t size = 0;
+  for (const LoadDotOperand &loadOperand : loads) {
+    auto tensorType = cast<RankedTensorType>(loadOperand.load.getType());
+    size += tensorType.getNumElements() *
+            tensorType.getElementTypeBitWidth() / 8 * numStages;
+  }
+  return size;
+}
+
 /// Collect loads to pipeline. Return success if we can pipeline this loop.
 static void collectOpsToPipeline(scf::ForOp forOp,
                                  SmallVectorImpl<LoadDotOperand> &loadOps,
-                                 bool supportRegularPtr) {
-  assert(loadOps.empty() && "Expecting an empty list of load operations");
+                                 SmallVectorImpl<LoadDotOperand> &slmLoadOps,
+                                 bool supportRegularPtr, bool useSLM) {
+  assert(loadOps.empty() && slmLoadOps.empty() &&
+         "Expecting an empty list of load operations");
 
   ModuleOp moduleOp = forOp->getParentOfType<ModuleOp>();
   mlir::triton::ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
@@ -135,12 +242,16 @@ static void collectOpsToPipeline(scf::ForOp forOp,
     if (auto loadOp = dyn_cast<tt::LoadOp>(&op)) {
       Value ptr = loadOp.getPtr();
       bool isBlockPtr = mlir::triton::isTensorPointerType(ptr.getType());
-      if (!isBlockPtr && !supportRegularPtr)
+      if (!isBlockPtr && !supportRegularPtr && !useSLM)
         continue;
 
       std::optional<LoadDotOperand> loadWithDotOperand = loadDotOperand(loadOp);
-      if (loadWithDotOperand.has_value())
-        loadOps.push_back(loadWithDotOperand.value());
+      if (!loadWithDotOperand.has_value())
+        continue;
+      if (useSLM && canStageInSLM(*loadWithDotOperand))
+        slmLoadOps.push_back(*loadWithDotOperand);
+      else if (isBlockPtr || supportRegularPtr)
+        loadOps.push_back(*loadWithDotOperand);
     }
   }
 }
@@ -166,6 +277,11 @@ static Operation *predicateOp(RewriterBase &rewriter, Operation *op,
   if (mlir::isMemoryEffectFree(op) || isa<ttgi::PrefetchOp>(op))
     return op;
 
+  // A store to shared local memory for an iteration past the end of the loop
+  // writes a slot that is never read again, so it doesn't need a predicate.
+  if (isa<ttg::LocalStoreOp>(op))
+    return op;
+
   if (auto loadOp = dyn_cast<tt::LoadOp>(op)) {
     rewriter.setInsertionPoint(loadOp);
     Value mask = getPredMask(rewriter, loadOp.getPtr().getType(),
@@ -231,10 +347,13 @@ createSchedule(scf::ForOp forOp, int numStages) {
   SmallVector<Operation *> loadOps;
   // Find the prefetch/load ops that will go respectively in stage 0 and stage
   // `numStages - 1`. All the other operations will go in stage `numStages - 1`.
+  // Stores to shared local memory go in stage 0 together with the global
+  // loads they depend on, and the loads from shared local memory in stage
+  // `numStages - 1`.
   for (Operation &op : forOp.getBody()->without_terminator()) {
-    if (isa<ttgi::PrefetchOp>(op))
+    if (isa<ttgi::PrefetchOp, ttg::LocalStoreOp>(op))
       prefetchOps.emplace_back(&op);
-    if (isa<tt::LoadOp>(op))
+    if (isa<tt::LoadOp, ttg::LocalLoadOp>(op))
       loadOps.emplace_back(&op);
   }
 
@@ -288,13 +407,27 @@ createSchedule(scf::ForOp forOp, int numStages) {
 }
 
 bool ttgi::preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
-                                        bool supportRegularPtr,
+                                        bool supportRegularPtr, bool useSLM,
+                                        unsigned slmSize,
                                         mlir::scf::PipeliningOption &options) {
   // 1. First collect "interesting" operations with a stage where to schedule
   // them. This gives a coarse scheduling for the loop.
   SmallVector<LoadDotOperand> loads;
-  collectOpsToPipeline(forOp, loads, supportRegularPtr);
-  if (loads.empty()) {
+  SmallVector<LoadDotOperand> slmLoads;
+  collectOpsToPipeline(forOp, loads, slmLoads, supportRegularPtr, useSLM);
+  // The loads are staged in as many buffers as fit in the shared local
+  // memory, and not staged if not even two of them fit.
+  if (slmSize && getSLMStagingSize(slmLoads, numStages) > slmSize) {
+    int maxStages = slmSize / getSLMStagingSize(slmLoads, 1);
+    LLVM_DEBUG(llvm::dbgs() << "SLM staging buffers exceed " << slmSize
+                            << " bytes, pipelining in " << maxStages
+                            << " stages\n");
+    if (maxStages >= 2)
+      numStages = maxStages;
+    else
+      slmLoads.clear();
+  }
+  if (loads.empty() && slmLoads.empty()) {
     LLVM_DEBUG(llvm::dbgs() << "No loads to pipeline\n");
     return false;
   }
@@ -303,10 +436,17 @@ bool ttgi::preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
     llvm::dbgs() << "Loads to pipeline:\n";
     for (const LoadDotOperand &load : loads)
       llvm::dbgs() << "  " << *load.load << "\n";
+    llvm::dbgs() << "Loads to stage in shared local memory:\n";
+    for (const LoadDotOperand &load : slmLoads)
+      llvm::dbgs() << "  " << *load.load << "\n";
   });
 
-  // 2. Create the prefetching operations for the loads collected.
-  createPrefetchOps(forOp, loads);
+  // 2. Create the prefetching operations for the loads collected, and stage
+  // the other ones through shared local memory.
+  if (!loads.empty())
+    createPrefetchOps(forOp, loads);
+  if (!slmLoads.empty())
+    createSLMStaging(forOp, slmLoads, numStages);
 
   // 3. Create the final schedule for the kernel loop. This will dictate the
   // stages and order of operations to the pipeline expander.
@@ -328,3 +468,109 @@ bool ttgi::preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
 
   return true;
 }
+
+/// Create the schedule for an outer loop whose inner loop has been pipelined,
+/// e.g. the tile loop of a persistent kernel. The prefetches of the prologue
+/// of the inner loop, and their dependencies, are moved to stage 0 so that
+/// the prefetches of the next tile are issued before the epilogue of the
+/// current one.
+static std::vector<std::pair<Operation *, unsigned>>
+createOuterLoopSchedule(scf::ForOp forOp) {
+  DenseSet<Operation *> prefetchAndDeps;
+  for (Operation &op : forOp.getBody()->without_terminator())
+    if (isa<ttgi::PrefetchOp>(op))
+      addDep(&op, prefetchAndDeps, true);
+
+  DenseSet<Operation *> epilogue;
+  bool foundLoop = false;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (prefetchAndDeps.count(&op))
+      continue;
+    if (isa<scf::ForOp>(op)) {
+      foundLoop = true;
+      continue;
+    }
+    if (foundLoop)
+      epilogue.insert(&op);
+  }
+
+  std::vector<std::pair<Operation *, unsigned>> schedule;
+  // Schedule the current tile up to the inner loop first.
+  addOps(forOp, 1, schedule, [&](Operation *op) {
+    return prefetchAndDeps.count(op) == 0 && epilogue.count(op) == 0;
+  });
+
+  // Then the prefetches of the next tile.
+  addOps(forOp, 0, schedule,
+         [&](Operation *op) { return prefetchAndDeps.count(op); });
+
+  // Finally the epilogue of the current tile.
+  addOps(forOp, 1, schedule,
+         [&](Operation *op) { return epilogue.count(op); });
+  return schedule;
+}
+
+/// Hoist the constants and the shared local memory buffers allocated by the
+/// pipelining of the inner loop out of the outer loop.
+static void hoistAllocAndConst(scf::ForOp forOp) {
+  SmallVector<Operation *> toHoist;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (auto allocOp = dyn_cast<ttg::LocalAllocOp>(op)) {
+      if (!allocOp.getSrc())
+        toHoist.push_back(&op);
+    } else if (isa<arith::ConstantOp>(op)) {
+      toHoist.push_back(&op);
+    }
+  }
+  for (Operation *op : toHoist) {
+    op->moveBefore(forOp);
+    auto allocOp = dyn_cast<ttg::LocalAllocOp>(op);
+    if (!allocOp)
+      continue;
+    for (Operation *user : allocOp->getUsers())
+      if (auto deallocOp = dyn_cast<ttg::LocalDeallocOp>(user))
+        deallocOp->moveAfter(forOp);
+  }
+}
+
+/// Return true if the outer loop can be pipelined: its body contains a single
+/// loop, prefetches outside of it, and the prefetches don't depend on the
+/// inner loop or on operations that cannot be predicated.
+static bool outerLoopPreCondition(scf::ForOp forOp) {
+  unsigned numForOps = 0;
+  DenseSet<Operation *> prefetchAndDeps;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (isa<scf::ForOp>(op))
+      ++numForOps;
+    if (isa<ttgi::PrefetchOp>(op))
+      addDep(&op, prefetchAndDeps, true);
+  }
+  if (numForOps != 1 || prefetchAndDeps.empty())
+    return false;
+  return llvm::all_of(prefetchAndDeps, [](Operation *op) {
+    return isa<ttgi::PrefetchOp, tt::LoadOp>(op) ||
+           (op->getNumRegions() == 0 && mlir::isMemoryEffectFree(op));
+  });
+}
+
+bool ttgi::getOuterLoopSchedule(scf::ForOp &forOp,
+                                mlir::scf::PipeliningOption &options) {
+  if (!outerLoopPreCondition(forOp))
+    return false;
+
+  hoistAllocAndConst(forOp);
+
+  std::vector<std::pair<Operation *, unsigned>> schedule =
+      createOuterLoopSchedule(forOp);
+  LLVM_DEBUG(llvm::dbgs() << "Pipelining outer loop: " << forOp << "\n");
+
+  options.getScheduleFn =
+      [schedule](scf::ForOp forOp,
+                 std::vector<std::pair<Operation *, unsigned>> &s) {
+        s = std::move(schedule);
+      };
+  options.peelEpilogue = false;
+  options.predicateFn = predicateOp;
+  options.supportDynamicLoops = true;
+  return true;
+}
@@ -6,9 +6,16 @@
 namespace mlir::triton::gpu::intel {
 
 bool preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
-                                  bool supportRegularPtr,
+                                  bool supportRegularPtr, bool useSLM,
+                                  unsigned slmSize,
                                   mlir::scf::PipeliningOption &options);
 
+/// Fill out the pipelining options of an outer loop whose inner loop has been
+/// pipelined, so that the prefetches of the next iteration of the outer loop
+/// overlap the epilogue of the current one. Only two stages are supported.
+bool getOuterLoopSchedule(scf::ForOp &forOp,
+                          mlir::scf::PipeliningOption &options);
+
 } // namespace mlir::triton::gpu::intel
 
 #endif // TRITON_TRITONINTELGPU_TRANSFORM_PIPELINE_SCHEDULE_H
@@ -1,6 +1,9 @@
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/SetVector.h"
 
 #include "Pipeliner/Schedule.h"
 
@@ -38,15 +41,28 @@ static bool preCondition(scf::ForOp forOp) {
   return true;
 }
 
-static void pipelineLoop(scf::ForOp forOp, int numStages,
-                         bool supportRegularPtr) {
+static bool pipelineLoop(scf::ForOp forOp, int numStages,
+                         bool supportRegularPtr, bool useSLM,
+                         unsigned slmSize) {
   mlir::scf::PipeliningOption options;
   if (!preCondition(forOp))
-    return;
+    return false;
 
   bool foundSchedule = ttgi::preProcessLoopAndGetSchedule(
-      forOp, numStages, supportRegularPtr, options);
+      forOp, numStages, supportRegularPtr, useSLM, slmSize, options);
   if (!foundSchedule)
+    return false;
+
+  IRRewriter rewriter(forOp->getContext());
+  rewriter.setInsertionPoint(forOp);
+  FailureOr<scf::ForOp> newForOp =
+      mlir::scf::pipelineForLoop(rewriter, forOp, options);
+  return succeeded(newForOp);
+}
+
+static void pipelineOuterLoop(scf::ForOp forOp) {
+  mlir::scf::PipeliningOption options;
+  if (!ttgi::getOuterLoopSchedule(forOp, options))
     return;
 
   IRRewriter rewriter(forOp->getContext());
@@ -66,18 +82,46 @@ struct IntelGPUPipelinePass
   void runOnOperation() override {
     ModuleOp m = getOperation();
 
-    if (!m->hasAttr(ttgi::TritonIntelGPUDialect::getSupportSG2DBlockAttrName()))
-      return;
-
     if (numStages <= 1)
       return;
 
+    // Without 2D block messages (e.g. on client GPUs), the dot operands cannot
+    // be prefetched into the cache, they are staged through shared local
+    // memory instead, so that the global loads still overlap the dots.
+    bool supportSG2DBlock =
+        m->hasAttr(ttgi::TritonIntelGPUDialect::getSupportSG2DBlockAttrName());
+    bool prefetchRegularPtr = supportRegularPtr && supportSG2DBlock;
+    bool stageInSLM = useSLM || !supportSG2DBlock;
+
     SmallVector<scf::ForOp> loops;
     getOperation()->walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
 
+    llvm::SmallSetVector<scf::ForOp, 8> outerLoops;
     for (scf::ForOp forOp : loops) {
-      pipelineLoop(forOp, numStages, supportRegularPtr);
+      auto outerLoop = dyn_cast<scf::ForOp>(forOp->getParentOp());
+      if (pipelineLoop(forOp, numStages, prefetchRegularPtr, stageInSLM,
+                       slmSize) &&
+          outerLoop)
+        outerLoops.insert(outerLoop);
     }
+
+    if (outerLoops.empty())
+      return;
+
+    // Clean up arithmetic before pipelining the outer loops to simplify the
+    // IR.
+    RewritePatternSet patterns(m.getContext());
+    m.getContext()
+        ->getLoadedDialect<arith::ArithDialect>()
+        ->getCanonicalizationPatterns(patterns);
+    if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed())
+      return signalPassFailure();
+
+    // Pipeline the outer loops, e.g. the tile loops of persistent kernels, so
+    // that the prefetches of the next tile overlap the epilogue of the
+    // current one.
+    for (scf::ForOp outerLoop : outerLoops)
+      pipelineOuterLoop(outerLoop);
   }
 };
 } // anonymous namespace
@@ -14,6 +14,22 @@
 /// Note: this pass add a layout attribute to the newly created prefetch
 /// operations.
 ///
+/// The number of iterations prefetched in advance is either given by a pass
+/// option or, with 'adaptive-distance', computed for each loop from its trip
+/// count, the bytes loaded and the DPAS work done per iteration, and the
+/// estimated memory latency.
+///
+/// With 'num-sharing-workgroups' N > 1, the N consecutive work-groups along X
+/// are expected to load the same panels of the 2nd operand of their dots (e.g.
+/// the work-groups of a group of a grouped GEMM). Each of them then prefetches
+/// every N-th iteration of these panels only, into L3 only, so that the other
+/// work-groups hit L3 rather than competing with each other for bandwidth.
+///
+/// The block pointers may also be rebased in each iteration rather than
+/// advanced, e.g. on the block read from the block table of a block sparse
+/// matrix: their computation is then recomputed for the iteration prefetched,
+/// guarded to stay within the loop bounds.
+///
 /// Limitations:
 ///   - only blocked pointers are supported
 ///   - it is expected that the 'convert-triton-to-tritongpu-warp' pass is run
@@ -38,9 +54,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "TritonToTritonGPUWarp/TritonToTritonGPUWarpPass.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
 #include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
 #include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
@@ -49,7 +69,9 @@
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/IR/Utility.h"
 
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
+#include <algorithm>
 #include <optional>
 
 namespace mlir::triton::gpu::intel {
@@ -66,6 +88,21 @@ namespace ttgi = mlir::triton::gpu::intel;
 
 namespace {
 
+/// Number of multiply-accumulate operations per cycle the DPAS units of an
+/// Xe-core perform on 16-bit operands.
+constexpr unsigned dpasMacsPerCycle = 2048;
+
+/// Number of bytes per cycle an Xe-core can load from the L2/L3 cache.
+constexpr unsigned loadBytesPerCycle = 64;
+
+/// Largest number of iterations prefetched in advance of a loop.
+constexpr unsigned maxPrefetchDistance = 8;
+
+/// Returns the number of bytes of the tensor of type \p type.
+uint64_t getNumBytes(RankedTensorType type) {
+  return type.getNumElements() * type.getElementTypeBitWidth() / 8;
+}
+
 /// Returns true if \p val has a single user of the given type \p tparam T and
 /// false otherwise.
 template <typename T>
@@ -131,6 +168,45 @@ Type annotatePrefetchType(Type type, unsigned numWarps) {
   return newType;
 }
 
+/// Returns the operations of the body of \p loop computing \p blockPtr, in
+/// program order and including it, if they can be recomputed for another
+/// iteration of the loop: they only depend on the induction variable and on
+/// values defined outside of the loop, and are pure operations or scalar
+/// loads (e.g. of a block table).
+std::optional<SmallVector<Operation *>>
+getRebaseSlice(scf::ForOp loop, tt::MakeTensorPtrOp blockPtr) {
+  SetVector<Operation *> slice;
+  SmallVector<Operation *> worklist{blockPtr};
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+    if (!slice.insert(op))
+      continue;
+    if (op->getNumRegions() != 0)
+      return std::nullopt;
+    if (auto load = dyn_cast<tt::LoadOp>(op)) {
+      if (!isa<tt::PointerType>(load.getPtr().getType()) ||
+          tt::isTensorPointerType(load.getPtr().getType()))
+        return std::nullopt;
+    } else if (!isMemoryEffectFree(op)) {
+      return std::nullopt;
+    }
+    for (Value operand : op->getOperands()) {
+      if (operand == loop.getInductionVar() ||
+          loop.isDefinedOutsideOfLoop(operand))
+        continue;
+      Operation *def = operand.getDefiningOp();
+      if (!def || def->getBlock() != loop.getBody())
+        return std::nullopt;
+      worklist.push_back(def);
+    }
+  }
+
+  SmallVector<Operation *> ops(slice.begin(), slice.end());
+  llvm::sort(ops,
+             [](Operation *a, Operation *b) { return a->isBeforeInBlock(b); });
+  return ops;
+}
+
 class PrefetchBlockPass
     : public triton::gpu::intel::impl::TritonIntelGPUPrefetchBlockBase<
           PrefetchBlockPass> {
@@ -140,18 +216,25 @@ public:
     LoadInfo(tt::AdvanceOp advance, SmallVector<Value> offsets,
              tt::MakeTensorPtrOp blockPtr)
         : advance(advance), offsets(offsets), blockPtr(blockPtr) {}
+    LoadInfo(tt::MakeTensorPtrOp blockPtr, SmallVector<Operation *> rebaseSlice)
+        : blockPtr(blockPtr), rebaseSlice(rebaseSlice) {}
     LoadInfo(const LoadInfo &other)
         : advance(other.advance), offsets(other.offsets),
-          blockPtr(other.blockPtr) {}
+          blockPtr(other.blockPtr), rebaseSlice(other.rebaseSlice) {}
 
     tt::AdvanceOp getAdvance() const { return advance; }
     const SmallVector<Value> getOffsets() const { return offsets; }
     tt::MakeTensorPtrOp getBlockPtr() const { return blockPtr; }
+    ArrayRef<Operation *> getRebaseSlice() const { return rebaseSlice; }
+    bool isRebased() const { return !advance; }
 
   private:
     tt::AdvanceOp advance;        /// AdvanceOp using the blocked pointer
     SmallVector<Value> offsets;   /// Offsets used by the AdvanceOp
     tt::MakeTensorPtrOp blockPtr; /// Operation defining the blocked pointer
+    /// Operations computing the blocked pointer in the loop body when it is
+    /// rebased in each iteration rather than advanced
+    SmallVector<Operation *> rebaseSlice;
   };
 
   using triton::gpu::intel::impl::TritonIntelGPUPrefetchBlockBase<
@@ -202,14 +285,35 @@ private:
   /// Insert prefetching operation in the given \p loop.
   void transformLoop(scf::ForOp) const;
 
-  /// Insert prefetch operations in the preheader of the given \p loop and
-  /// return them in \p prefetchPtrs.
-  void injectPrefetchOpsInPreheader(scf::ForOp loop,
+  /// Return the number of iterations of \p loop to prefetch in advance.
+  unsigned getPrefetchDistance(scf::ForOp loop) const;
+
+  /// Returns true if the panels loaded by \p load are shared by the
+  /// 'num-sharing-workgroups' consecutive work-groups.
+  bool isSharedPanel(tt::LoadOp load) const;
+
+  /// Create a prefetch of \p ptr for the iteration of \p load returned by
+  /// \p getIteration, and return the operation to insert the next prefetches
+  /// after.
+  Operation *createPrefetch(OpBuilder &b, Location loc, Value ptr,
+                            tt::LoadOp load,
+                            function_ref<Value()> getIteration) const;
+
+  /// Create a prefetch of the rebased block pointer of \p load for the
+  /// iteration of \p loop with induction variable \p iv, guarded to only be
+  /// issued for an iteration of the loop, and return the guard.
+  Operation *createRebasedPrefetch(OpBuilder &b, scf::ForOp loop,
+                                   tt::LoadOp load, Value iv,
+                                   function_ref<Value()> getIteration) const;
+
+  /// Insert prefetch operations for the first \p distance iterations in the
+  /// preheader of the given \p loop and return them in \p prefetchPtrs.
+  void injectPrefetchOpsInPreheader(scf::ForOp loop, unsigned distance,
                                     SmallVectorImpl<Value> &prefetchPtrs) const;
 
-  /// Insert prefetch operations in the body of the given \p loop and return
-  /// them in \p prefetchPtrs.
-  void injectPrefetchOpsInBody(scf::ForOp loop,
+  /// Insert prefetch operations \p distance iterations ahead in the body of
+  /// the given \p loop and return them in \p prefetchPtrs.
+  void injectPrefetchOpsInBody(scf::ForOp loop, unsigned distance,
                                SmallVectorImpl<Value> &prefetchPtrs) const;
 
   /// Map between a SCF loop and the candidate loads for the transformation.
@@ -243,7 +347,9 @@ void PrefetchBlockPass::collectCandidatesLoadsInLoop(
 /// Determines whether a load (in a loop) is a candidate. A candidate load:
 ///   - must use a block pointer
 ///   - the block pointer must have 2 users in the loop, a 'tt.advance' and the
-///     'tt.load' operation
+///     'tt.load' operation, or be created in the loop body for the 'tt.load'
+///     operation only, by operations that can be recomputed for another
+///     iteration
 ///   - the result of the load must be used by a 'tt.dot' operation
 ///   - satisfy all conditions required in order to create a 'LoadInfo' object
 ///     for the load
@@ -254,6 +360,22 @@ bool PrefetchBlockPass::isCandidateLoad(tt::LoadOp load, scf::ForOp loop) {
   if (!isa<tt::PointerType>(ptr.getType()) || !loop->isProperAncestor(load))
     return false;
 
+  auto blockPtr = ptr.getDefiningOp<tt::MakeTensorPtrOp>();
+  if (blockPtr && blockPtr->getBlock() == loop.getBody()) {
+    if (load->getBlock() != loop.getBody() || !ptr.hasOneUse() ||
+        !load.getResult().hasOneUse() ||
+        !hasSingleUserOfKindInLoop<tt::DotOp>(load.getResult(), loop))
+      return false;
+    std::optional<SmallVector<Operation *>> rebaseSlice =
+        getRebaseSlice(loop, blockPtr);
+    if (!rebaseSlice.has_value())
+      return false;
+
+    assert(!loadToLoadInfo.contains(load) && "Unexpected entry in the map");
+    loadToLoadInfo.insert({load, LoadInfo(blockPtr, *rebaseSlice)});
+    return true;
+  }
+
   unsigned numPtrUsers = range_size(ptr.getUsers());
   if (numPtrUsers != 2)
     return false;
@@ -327,14 +449,124 @@ PrefetchBlockPass::findDefiningMakeTensorPtrOp(scf::ForOp loop,
 }
 
 void PrefetchBlockPass::transformLoop(scf::ForOp loop) const {
+  unsigned distance = getPrefetchDistance(loop);
+  loop->setAttr(ttgi::TritonIntelGPUDialect::getPrefetchDistanceAttrName(),
+                OpBuilder(loop).getI32IntegerAttr(distance));
+
   SmallVector<Value> prefetchPtrs;
-  injectPrefetchOpsInPreheader(loop, prefetchPtrs);
-  injectPrefetchOpsInBody(loop, prefetchPtrs);
+  injectPrefetchOpsInPreheader(loop, distance, prefetchPtrs);
+  injectPrefetchOpsInBody(loop, distance, prefetchPtrs);
+}
+
+bool PrefetchBlockPass::isSharedPanel(tt::LoadOp load) const {
+  if (numSharingWorkgroups <= 1)
+    return false;
+  auto dot = cast<tt::DotOp>(*load->getUsers().begin());
+  return dot.getB() == load.getResult();
+}
+
+/// The prefetches of the shared panels are guarded so that the work-group
+/// \p pid only prefetches the iterations i with (i + pid) % N == 0.
+Operation *
+PrefetchBlockPass::createPrefetch(OpBuilder &b, Location loc, Value ptr,
+                                  tt::LoadOp load,
+                                  function_ref<Value()> getIteration) const {
+  if (!isSharedPanel(load))
+    return b.create<ttgi::PrefetchOp>(loc, ptr, load.getCache(),
+                                      load.getEvict(), load.getIsVolatile());
+
+  Value pid = b.create<tt::GetProgramIdOp>(loc, b.getI32Type(),
+                                           tt::ProgramIDDim::X);
+  Value owner = b.create<arith::RemUIOp>(
+      loc, b.create<arith::AddIOp>(loc, getIteration(), pid),
+      b.create<arith::ConstantIntOp>(loc, numSharingWorkgroups, 32));
+  Value isOwner = b.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, owner,
+      b.create<arith::ConstantIntOp>(loc, 0, 32));
+  auto ifOp = b.create<scf::IfOp>(loc, isOwner, /*withElseRegion=*/false);
+  OpBuilder::InsertionGuard guard(b);
+  b.setInsertionPointToStart(ifOp.thenBlock());
+  // The 'cg' modifier caches the panel in L3 only.
+  b.create<ttgi::PrefetchOp>(loc, ptr, tt::CacheModifier::CG, load.getEvict(),
+                             load.getIsVolatile());
+  return ifOp;
+}
+
+/// The block pointer is recomputed, in the guard, from the induction variable
+/// \p iv.
+Operation *PrefetchBlockPass::createRebasedPrefetch(
+    OpBuilder &b, scf::ForOp loop, tt::LoadOp load, Value iv,
+    function_ref<Value()> getIteration) const {
+  Location loc = load.getLoc();
+  Value inLoop = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt, iv,
+                                         loop.getUpperBound());
+  auto ifOp = b.create<scf::IfOp>(loc, inLoop, /*withElseRegion=*/false);
+  OpBuilder::InsertionGuard guard(b);
+  b.setInsertionPointToStart(ifOp.thenBlock());
+
+  IRMapping mapping;
+  mapping.map(loop.getInductionVar(), iv);
+  Operation *clone = nullptr;
+  for (Operation *op : loadToLoadInfo.at(load).getRebaseSlice())
+    clone = b.clone(*op, mapping);
+  auto ptr = cast<tt::MakeTensorPtrOp>(clone);
+  const unsigned numWarps = ttg::TritonGPUDialect::getNumWarps(
+      loop->getParentOfType<ModuleOp>());
+  ptr.getResult().setType(
+      cast<tt::PointerType>(annotatePrefetchType(ptr.getType(), numWarps)));
+  createPrefetch(b, loc, ptr, load, getIteration);
+  return ifOp;
+}
+
+/// The distance is the number of iterations covering the memory latency, an
+/// iteration lasting as long as the longest of its DPAS operations and its
+/// loads. Loops with little work per iteration (e.g. bandwidth bound ones)
+/// are therefore prefetched further ahead. The distance is given by the
+/// 'triton_intel_gpu.prefetch_distance' attribute of the loop if present.
+unsigned PrefetchBlockPass::getPrefetchDistance(scf::ForOp loop) const {
+  if (auto attr = loop->getAttrOfType<IntegerAttr>(
+          ttgi::TritonIntelGPUDialect::getPrefetchDistanceAttrName()))
+    return std::max<int64_t>(attr.getInt(), 1);
+  if (!adaptiveDistance)
+    return numAdvancePrefetches;
+
+  uint64_t numBytes = 0;
+  for (tt::LoadOp load : loopLoads.at(loop))
+    numBytes += getNumBytes(cast<RankedTensorType>(load.getType()));
+
+  uint64_t dpasCycles = 0;
+  loop.walk([&](tt::DotOp dot) {
+    auto aType = cast<RankedTensorType>(dot.getA().getType());
+    auto dType = cast<RankedTensorType>(dot.getD().getType());
+    unsigned bitWidth = std::max(aType.getElementTypeBitWidth(), 8u);
+    uint64_t numMacs = dType.getNumElements() * aType.getShape().back();
+    dpasCycles += llvm::divideCeil(numMacs * bitWidth, dpasMacsPerCycle * 16);
+  });
+
+  uint64_t iterCycles = std::max<uint64_t>(
+      {llvm::divideCeil(numBytes, loadBytesPerCycle), dpasCycles, 1});
+  uint64_t distance = std::clamp<uint64_t>(
+      llvm::divideCeil(memoryLatency, iterCycles), 1, maxPrefetchDistance);
+
+  // Do not prefetch past the last iteration of the loop.
+  std::optional<int64_t> lb = getConstantIntValue(loop.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(loop.getUpperBound());
+  std::optional<int64_t> step = getConstantIntValue(loop.getStep());
+  if (lb && ub && step && *step > 0) {
+    int64_t tripCount = (*ub - *lb + *step - 1) / *step;
+    distance = std::clamp<int64_t>(tripCount, 1, distance);
+  }
+
+  LLVM_DEBUG(llvm::dbgs() << "Prefetch distance of loop: " << distance << " ("
+                          << numBytes << " bytes loaded and " << dpasCycles
+                          << " DPAS cycles per iteration)\n");
+  return distance;
 }
 
 /// Add prefetch operations in the loop pre-header.
 void PrefetchBlockPass::injectPrefetchOpsInPreheader(
-    scf::ForOp loop, SmallVectorImpl<Value> &prefetchPtrs) const {
+    scf::ForOp loop, unsigned distance,
+    SmallVectorImpl<Value> &prefetchPtrs) const {
   assert(prefetchPtrs.empty() && "Expecting an empty vector");
 
   ModuleOp mod = loop->getParentOfType<ModuleOp>();
@@ -344,6 +576,26 @@ void PrefetchBlockPass::injectPrefetchOpsInPreheader(
     const LoadInfo &loadInfo = loadToLoadInfo.at(load);
     const unsigned numWarps = ttg::TritonGPUDialect::getNumWarps(mod);
 
+    // The first iterations of a rebased block pointer are prefetched from
+    // their induction variable, the loop may not even run once.
+    if (loadInfo.isRebased()) {
+      b.setInsertionPoint(loop);
+      Location loc = load.getLoc();
+      Type ivType = loop.getInductionVar().getType();
+      for (unsigned i = 0; i < distance; ++i) {
+        Value iv = b.create<arith::AddIOp>(
+            loc, loop.getLowerBound(),
+            b.create<arith::MulIOp>(
+                loc, loop.getStep(),
+                b.create<arith::ConstantOp>(loc,
+                                            b.getIntegerAttr(ivType, i))));
+        createRebasedPrefetch(b, loop, load, iv, [&]() -> Value {
+          return b.create<arith::ConstantIntOp>(loc, i, 32);
+        });
+      }
+      continue;
+    }
+
     b.setInsertionPoint(loadInfo.getBlockPtr());
     auto ptr = cast<tt::MakeTensorPtrOp>(
         b.clone(*loadInfo.getBlockPtr().getOperation()));
@@ -353,9 +605,10 @@ void PrefetchBlockPass::injectPrefetchOpsInPreheader(
     Location loc = ptr.getLoc();
 
     Value currPtr = ptr;
-    for (int i = 0; i < numAdvancePrefetches; ++i) {
-      b.create<ttgi::PrefetchOp>(loc, currPtr, load.getCache(), load.getEvict(),
-                                 load.getIsVolatile());
+    for (unsigned i = 0; i < distance; ++i) {
+      createPrefetch(b, loc, currPtr, load, [&]() -> Value {
+        return b.create<arith::ConstantIntOp>(loc, i, 32);
+      });
       currPtr = b.create<tt::AdvanceOp>(loc, currPtr.getType(), currPtr,
                                         loadInfo.getOffsets());
     }
@@ -378,8 +631,8 @@ void PrefetchBlockPass::injectPrefetchOpsInPreheader(
 }
 
 void PrefetchBlockPass::injectPrefetchOpsInBody(
-    scf::ForOp loop, SmallVectorImpl<Value> &prefetchPtrs) const {
-  assert(!prefetchPtrs.empty() && "Expecting an non-empty vector");
+    scf::ForOp loop, unsigned distance,
+    SmallVectorImpl<Value> &prefetchPtrs) const {
 
   OpBuilder b(loop);
   SmallVector<Value> iterArgs = loop.getInitArgs();
@@ -407,17 +660,55 @@ void PrefetchBlockPass::injectPrefetchOpsInBody(
   SmallVector<Value> advances;
   unsigned i = 0;
 
+  // The iteration prefetched by the current iteration of the loop, computed
+  // at most once at the start of the body.
+  Value iteration;
+  auto getIteration = [&]() -> Value {
+    if (iteration)
+      return iteration;
+    OpBuilder::InsertionGuard guard(b);
+    b.setInsertionPointToStart(newLoop.getBody());
+    Location loc = newLoop.getLoc();
+    Value iv = newLoop.getInductionVar();
+    Value index = b.create<arith::DivSIOp>(
+        loc, b.create<arith::SubIOp>(loc, iv, newLoop.getLowerBound()),
+        newLoop.getStep());
+    if (index.getType().isIndex())
+      index = b.create<arith::IndexCastOp>(loc, b.getI32Type(), index);
+    else if (index.getType() != b.getI32Type())
+      index = b.create<arith::TruncIOp>(loc, b.getI32Type(), index);
+    iteration = b.create<arith::AddIOp>(
+        loc, index, b.create<arith::ConstantIntOp>(loc, distance, 32));
+    return iteration;
+  };
+
+  // The induction variable of the iteration prefetched, for the rebased block
+  // pointers.
+  auto createPrefetchedIV = [&]() -> Value {
+    Location loc = newLoop.getLoc();
+    Value iv = newLoop.getInductionVar();
+    return b.create<arith::AddIOp>(
+        loc, iv,
+        b.create<arith::MulIOp>(
+            loc, newLoop.getStep(),
+            b.create<arith::ConstantOp>(
+                loc, b.getIntegerAttr(iv.getType(), distance))));
+  };
+
   // Inject prefetches in a different fashion depending on workload type.
   switch (workload) {
   case Workload::Gemm: {
     Operation *prefetchInsertPoint = loopLoads.at(loop).back();
     for (tt::LoadOp load : loopLoads.at(loop)) {
       b.setInsertionPointAfter(prefetchInsertPoint);
+      if (loadToLoadInfo.at(load).isRebased()) {
+        prefetchInsertPoint = createRebasedPrefetch(
+            b, newLoop, load, createPrefetchedIV(), getIteration);
+        continue;
+      }
       Location loc = load.getLoc();
-      auto prefetch =
-          b.create<ttgi::PrefetchOp>(loc, args[num + 1 + i], load.getCache(),
-                                     load.getEvict(), load.getIsVolatile());
-      prefetchInsertPoint = prefetch;
+      prefetchInsertPoint =
+          createPrefetch(b, loc, args[num + 1 + i], load, getIteration);
 
       const LoadInfo &loadInfo = loadToLoadInfo.at(load);
       b.setInsertionPoint(loadInfo.getAdvance());
@@ -432,11 +723,15 @@ void PrefetchBlockPass::injectPrefetchOpsInBody(
   case mlir::Workload::Attention: {
     for (tt::LoadOp load : loopLoads.at(loop)) {
       const LoadInfo &loadInfo = loadToLoadInfo.at(load);
+      if (loadInfo.isRebased()) {
+        b.setInsertionPointAfter(load);
+        createRebasedPrefetch(b, newLoop, load, createPrefetchedIV(),
+                              getIteration);
+        continue;
+      }
       b.setInsertionPoint(loadInfo.getAdvance());
       Location loc = load.getLoc();
-      auto prefetch =
-          b.create<ttgi::PrefetchOp>(loc, args[num + 1 + i], load.getCache(),
-                                     load.getEvict(), load.getIsVolatile());
+      createPrefetch(b, loc, args[num + 1 + i], load, getIteration);
 
       loc = loadInfo.getAdvance().getLoc();
       auto advance =
@@ -0,0 +1,178 @@
+//===- Rematerialize.cpp ------------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the rematerialization of cheap loop invariant tensors
+/// in the loops with dots. The tensors of offsets, masks and pointers computed
+/// before a loop are live across the whole loop, and thus across its DPAS
+/// chains. When the register pressure exceeds the GRF budget, they are
+/// recomputed in the loop body right before their first use instead, so that
+/// they no longer take registers while the DPAS chains run.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Transforms/RegionUtils.h"
+
+#include "intel/include/Analysis/RegisterPressure.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUREMATERIALIZE
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+namespace ttgi = mlir::triton::gpu::intel;
+
+#define DEBUG_TYPE "tritonintelgpu-rematerialize"
+
+namespace {
+
+/// Size (in bytes) of a GRF.
+constexpr unsigned grfSize = 64;
+
+/// Returns whether \p op is cheap enough to be computed again in each
+/// iteration of a loop rather than kept live across it.
+bool isCheapToRecompute(Operation *op) {
+  return isa<tt::SplatOp, tt::BroadcastOp, tt::ExpandDimsOp, tt::MakeRangeOp,
+             tt::AddPtrOp, arith::ConstantOp, arith::AddIOp, arith::SubIOp,
+             arith::MulIOp, arith::AndIOp, arith::OrIOp, arith::XOrIOp,
+             arith::ShLIOp, arith::ShRSIOp, arith::ShRUIOp, arith::CmpIOp,
+             arith::ExtSIOp, arith::ExtUIOp, arith::TruncIOp,
+             arith::SelectOp>(op);
+}
+
+/// Collects in \p slice, in topological order, the operations computing the
+/// tensor \p val from scalars. Returns false if the tensor is not cheap to
+/// recompute or needs more than \p maxOps operations.
+bool getRecomputedSlice(Value val, unsigned maxOps,
+                        SetVector<Operation *> &slice) {
+  if (!isa<RankedTensorType>(val.getType()))
+    return true;
+  Operation *def = val.getDefiningOp();
+  if (!def || !isCheapToRecompute(def))
+    return false;
+  if (slice.contains(def))
+    return true;
+  for (Value operand : def->getOperands())
+    if (!getRecomputedSlice(operand, maxOps, slice))
+      return false;
+  slice.insert(def);
+  return slice.size() <= maxOps;
+}
+
+class RematerializePass
+    : public triton::gpu::intel::impl::TritonIntelGPURematerializeBase<
+          RematerializePass> {
+public:
+  using Base::Base;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    unsigned threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    mod.walk([&](FunctionOpInterface func) {
+      // A sub-group runs on a hardware thread, whose GRFs hold the values of
+      // all its work-items.
+      unsigned liveBytes =
+          ttgi::estimateMaxLiveBytesPerThread(func, threadsPerWarp) *
+          threadsPerWarp;
+      if (liveBytes <= grfBudget * grfSize)
+        return;
+
+      LLVM_DEBUG(llvm::dbgs() << "Register pressure of " << liveBytes
+                              << " bytes in " << func.getName() << "\n");
+      SmallVector<scf::ForOp> loops;
+      func->walk([&](scf::ForOp loop) {
+        if (!loop.getOps<tt::DotOp>().empty())
+          loops.push_back(loop);
+      });
+      for (scf::ForOp loop : loops)
+        rematerialize(loop);
+    });
+  }
+
+private:
+  /// Recomputes the cheap tensors defined above \p loop, and only used before
+  /// or in it, right before their first use in its body.
+  void rematerialize(scf::ForOp loop) const {
+    Block *body = loop.getBody();
+    SetVector<Value> captured;
+    getUsedValuesDefinedAbove(loop.getRegion(), loop.getRegion(), captured);
+
+    // Returns the first operation of the loop body using \p val, if any.
+    auto getFirstUser = [&](Value val) -> Operation * {
+      Operation *firstUser = nullptr;
+      for (Operation *user : val.getUsers()) {
+        Operation *ancestor = body->findAncestorOpInBlock(*user);
+        if (ancestor && (!firstUser || ancestor->isBeforeInBlock(firstUser)))
+          firstUser = ancestor;
+      }
+      return firstUser;
+    };
+
+    // Returns whether \p val is not used after the loop, so that its live
+    // range ends at the loop once recomputed in the body.
+    auto isDeadAfterLoop = [&](Value val) {
+      return llvm::all_of(val.getUsers(), [&](Operation *user) {
+        if (loop->isAncestor(user))
+          return true;
+        Operation *ancestor = loop->getBlock()->findAncestorOpInBlock(*user);
+        return ancestor && ancestor->isBeforeInBlock(loop);
+      });
+    };
+
+    SmallVector<std::pair<Value, SetVector<Operation *>>> candidates;
+    for (Value val : captured) {
+      SetVector<Operation *> slice;
+      if (!isa<RankedTensorType>(val.getType()) || !isDeadAfterLoop(val) ||
+          !getRecomputedSlice(val, maxOps, slice))
+        continue;
+      candidates.emplace_back(val, std::move(slice));
+    }
+    // The operations shared by several tensors are computed once, before the
+    // first use of any of them.
+    llvm::sort(candidates, [&](const auto &lhs, const auto &rhs) {
+      return getFirstUser(lhs.first)->isBeforeInBlock(
+          getFirstUser(rhs.first));
+    });
+
+    IRMapping mapping;
+    SetVector<Operation *> recomputed;
+    for (auto &[val, slice] : candidates) {
+      LLVM_DEBUG(llvm::dbgs() << "Recomputing in the loop body: " << val
+                              << "\n");
+      OpBuilder builder(getFirstUser(val));
+      for (Operation *op : slice) {
+        if (!mapping.contains(op->getResult(0)))
+          builder.clone(*op, mapping);
+      }
+      val.replaceUsesWithIf(mapping.lookup(val), [&](OpOperand &use) {
+        return loop->isProperAncestor(use.getOwner());
+      });
+      recomputed.insert(slice.begin(), slice.end());
+    }
+
+    // Erase the operations left without uses. The slices are closed under
+    // their operands, so the operations were collected in topological order.
+    for (Operation *op : llvm::reverse(recomputed.takeVector())) {
+      if (isOpTriviallyDead(op))
+        op->erase();
+    }
+  }
+};
+
+} // namespace
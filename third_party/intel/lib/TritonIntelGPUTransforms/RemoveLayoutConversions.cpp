@@ -148,11 +148,15 @@ private:
   DenseMap<std::pair<Value, Attribute>, Value> rewriteMapping;
   SetVector<Operation *> opToDelete;
   FuncOp funcOp;
+  // Size (in bytes) of the L1 cache serving the duplicated loads of the dot
+  // operands, or 0 to always load the dot operands into registers.
+  unsigned cacheSize;
 };
 
 class LayoutRematerialization {
 public:
-  LayoutRematerialization(FuncOp F) : funcOp(F) {}
+  LayoutRematerialization(FuncOp F, unsigned cacheSize = 0)
+      : funcOp(F), cacheSize(cacheSize) {}
   // Map the original value to the remat'ed one.
   void addRematValue(Value old, Attribute encoding, Value newV);
   bool hasRematValue(Value value, Attribute encoding) {
@@ -169,6 +173,8 @@ public:
   void backwardRematerialization(ConvertLayoutOp convertOp);
   void hoistConvertOnTopOfExtOrBroadcast();
   void hoistConvertOnTopOfExtOrBroadcast(ConvertLayoutOp convertOp);
+  void hoistDotOperandConvertOnTopOfDequant();
+  void hoistDotOperandConvertOnTopOfDequant(ConvertLayoutOp convertOp);
   void rewriteSlice(SetVector<Value> &slice, DenseMap<Value, Attribute> &layout,
                     ConvertLayoutOp convertOp, IRMapping &mapping);
   void rewriteSlice(SetVector<Value> &slice, DenseMap<Value, Attribute> &layout,
@@ -185,6 +191,9 @@ private:
   // DenseMap<std::pair<Operation*, Attribute>, Operation*>
   SetVector<Operation *> opToDelete;
   FuncOp funcOp;
+  // Size (in bytes) of the L1 cache serving the duplicated loads of the dot
+  // operands, or 0 to always load the dot operands into registers.
+  unsigned cacheSize;
 };
 
 void LayoutRematerialization::addRematValue(Value old, Attribute encoding,
@@ -257,9 +266,33 @@ bool hasConvertToMMATransisitiveUse(Operation *op, Attribute encoding) {
           cast<NvidiaMmaEncodingAttr>(encoding).getVersionMajor() == 3;
       if (isMMAV3 && isa<LocalAllocOp>(op))
         return true;
+      if (auto conditionOp = dyn_cast<scf::ConditionOp>(op)) {
+        auto whileOp = cast<scf::WhileOp>(conditionOp->getParentOp());
+        for (auto [idx, arg] : llvm::enumerate(conditionOp.getArgs())) {
+          Operation *def = arg.getDefiningOp();
+          if ((def && forwardSlice.count(def)) || arg == currentValue) {
+            if (seen.insert(arg).second) {
+              queue.push_back(whileOp.getAfterArguments()[idx]);
+              queue.push_back(whileOp.getResult(idx));
+            }
+          }
+        }
+        continue;
+      }
       auto yield = dyn_cast<scf::YieldOp>(op);
       if (!yield)
         continue;
+      if (auto whileOp = dyn_cast<scf::WhileOp>(yield->getParentOp())) {
+        for (OpOperand &operand : yield->getOpOperands()) {
+          Operation *def = operand.get().getDefiningOp();
+          if (def &&
+              (forwardSlice.count(def) || operand.get() == currentValue) &&
+              (seen.insert(operand.get()).second == true))
+            queue.push_back(
+                whileOp.getBeforeArguments()[operand.getOperandNumber()]);
+        }
+        continue;
+      }
       if (auto ifOp = dyn_cast<scf::IfOp>(yield->getParentOp())) {
         for (OpOperand &operand : yield->getOpOperands()) {
           Operation *def = operand.get().getDefiningOp();
@@ -941,7 +974,7 @@ bool canBeRemat(Operation *op) {
     return !ttgi::isExpensiveLoadOrStore(op);
   if (isa<AtomicRMWOp, AtomicCASOp, DotOp>(op))
     return false;
-  if (isa<scf::WhileOp, scf::ConditionOp>(op))
+  if (isa<scf::ConditionOp>(op))
     return false;
 
   return true;
@@ -972,6 +1005,22 @@ void LayoutRematerialization::updateRematMapping(
   }
 }
 
+// Return the type \p type of a tensor or tensor pointer with its encoding
+// replaced by \p encoding.
+Type getTypeWithEncoding(Type type, Attribute encoding) {
+  if (isTensorPointerType(type)) {
+    auto ptrType = cast<PointerType>(type);
+    auto tensorType = cast<RankedTensorType>(ptrType.getPointeeType());
+    return triton::PointerType::get(
+        RankedTensorType::get(tensorType.getShape(),
+                              tensorType.getElementType(), encoding),
+        ptrType.getAddressSpace());
+  }
+  auto tensorType = cast<RankedTensorType>(type);
+  return RankedTensorType::get(tensorType.getShape(),
+                               tensorType.getElementType(), encoding);
+}
+
 void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
                                            DenseMap<Value, Attribute> &layout,
                                            ConvertLayoutOp convertOp,
@@ -979,6 +1028,16 @@ void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
   SetVector<Operation *> opsToRewrite;
   // Keep track of yield operands that need to be duplicated.
   DenseMap<Operation *, SmallVector<int>> yieldOperandsMap;
+  // The results and after region arguments of a while loop are duplicated
+  // together, as they are both forwarded from the condition operands.
+  auto addConditionOperand = [&](scf::WhileOp whileOp, unsigned argIdx) {
+    scf::ConditionOp conditionOp = whileOp.getConditionOp();
+    opsToRewrite.insert(conditionOp.getOperation());
+    SmallVector<int> &operands = yieldOperandsMap[conditionOp];
+    // Skip operand 0 as it is the condition.
+    if (!llvm::is_contained(operands, argIdx + 1))
+      operands.push_back(argIdx + 1);
+  };
   for (Value v : slice) {
     auto layoutIt = layout.find(v);
     assert(layoutIt != layout.end());
@@ -996,10 +1055,21 @@ void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
         opsToRewrite.insert(ifOp.elseYield().getOperation());
         yieldOperandsMap[ifOp.elseYield()].push_back(operandIdx);
       }
+      if (auto whileOp = v.getDefiningOp<scf::WhileOp>())
+        addConditionOperand(whileOp, cast<OpResult>(v).getResultNumber());
     } else {
       BlockArgument blockArg = cast<BlockArgument>(v);
       Operation *parentOp = blockArg.getOwner()->getParentOp();
-      if (auto loopOp = cast<LoopLikeOpInterface>(parentOp)) {
+      if (auto whileOp = dyn_cast<scf::WhileOp>(parentOp)) {
+        opsToRewrite.insert(whileOp.getOperation());
+        if (blockArg.getOwner() == whileOp.getBeforeBody()) {
+          scf::YieldOp yieldOp = whileOp.getYieldOp();
+          opsToRewrite.insert(yieldOp.getOperation());
+          yieldOperandsMap[yieldOp].push_back(blockArg.getArgNumber());
+        } else {
+          addConditionOperand(whileOp, blockArg.getArgNumber());
+        }
+      } else if (auto loopOp = cast<LoopLikeOpInterface>(parentOp)) {
         opsToRewrite.insert(loopOp.getOperation());
         OpOperand *operand = loopOp.getTiedLoopYieldedValue(blockArg);
         auto yieldOp = blockArg.getOwner()->getTerminator();
@@ -1054,6 +1124,55 @@ void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
       }
       continue;
     }
+    if (auto whileOp = dyn_cast<scf::WhileOp>(op)) {
+      // Keep a mapping of the before arguments and results indices to the new
+      // indices.
+      SmallVector<std::pair<size_t, size_t>> argMapping, resultMapping;
+      SmallVector<Value> newOperands;
+      SmallVector<Type> newResultTypes;
+      SmallVector<Attribute> argEncodings, resultEncodings;
+      for (BlockArgument arg : whileOp.getBeforeArguments()) {
+        if (!slice.count(arg))
+          continue;
+        unsigned argIdx = arg.getArgNumber();
+        argMapping.push_back(std::make_pair(
+            argIdx, whileOp.getInits().size() + newOperands.size()));
+        newOperands.push_back(mapping.lookup(whileOp.getInits()[argIdx]));
+        argEncodings.push_back(layout[arg]);
+      }
+      for (auto [idx, res] : llvm::enumerate(whileOp.getResults())) {
+        Value afterArg = whileOp.getAfterArguments()[idx];
+        Value v = slice.count(res) ? res : afterArg;
+        if (!slice.count(v))
+          continue;
+        resultMapping.push_back(std::make_pair(
+            idx, whileOp.getNumResults() + newResultTypes.size()));
+        newResultTypes.push_back(getTypeWithEncoding(res.getType(), layout[v]));
+        resultEncodings.push_back(layout[v]);
+      }
+      // The regions are moved to new blocks, so the old block arguments are
+      // remapped to the arguments of the new while loop.
+      scf::WhileOp newWhileOp = replaceWhileOpWithNewSignature(
+          builder, whileOp, newOperands, newResultTypes, replacements);
+      deadOps.push_back(whileOp.getOperation());
+      for (auto [m, encoding] : llvm::zip(argMapping, argEncodings)) {
+        Value oldArg = newWhileOp.getBeforeArguments()[m.first];
+        Value newArg = newWhileOp.getBeforeArguments()[m.second];
+        mapping.map(oldArg, newArg);
+        addRematValue(oldArg, encoding, newArg);
+      }
+      for (auto [m, encoding] : llvm::zip(resultMapping, resultEncodings)) {
+        Value oldArg = newWhileOp.getAfterArguments()[m.first];
+        Value newArg = newWhileOp.getAfterArguments()[m.second];
+        mapping.map(oldArg, newArg);
+        addRematValue(oldArg, encoding, newArg);
+        mapping.map(whileOp.getResult(m.first),
+                    newWhileOp.getResult(m.second));
+        addRematValue(newWhileOp.getResult(m.first), encoding,
+                      newWhileOp.getResult(m.second));
+      }
+      continue;
+    }
     if (auto ifOp = dyn_cast<scf::IfOp>(op)) {
       SmallVector<Type> newTypes;
       for (auto res : ifOp.getResults()) {
@@ -1098,6 +1217,17 @@ void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
       op->erase();
       continue;
     }
+    if (auto conditionOp = dyn_cast<scf::ConditionOp>(op)) {
+      auto args = llvm::to_vector(conditionOp.getArgs());
+      SmallVector<int> operandsToRewrite = yieldOperandsMap[op];
+      std::sort(operandsToRewrite.begin(), operandsToRewrite.end());
+      for (int operandIdx : operandsToRewrite)
+        args.push_back(mapping.lookup(conditionOp->getOperand(operandIdx)));
+      builder.create<scf::ConditionOp>(op->getLoc(),
+                                       conditionOp.getCondition(), args);
+      op->erase();
+      continue;
+    }
     if (isa<arith::ConstantOp>(op)) {
       Operation *newOp = builder.clone(*op);
       auto tensorType = cast<RankedTensorType>(op->getResult(0).getType());
@@ -1116,21 +1246,7 @@ void LayoutRematerialization::rewriteSlice(SetVector<Value> &slice,
       auto it = layout.find(old);
       if (it == layout.end())
         continue;
-      Type oldType = old.getType();
-      Type newType;
-      if (isTensorPointerType(oldType)) {
-        auto ptrType = cast<PointerType>(oldType);
-        auto tensorType = cast<RankedTensorType>(ptrType.getPointeeType());
-        newType = triton::PointerType::get(
-            RankedTensorType::get(tensorType.getShape(),
-                                  tensorType.getElementType(), it->second),
-            ptrType.getAddressSpace());
-      } else {
-        newType = RankedTensorType::get(
-            cast<RankedTensorType>(old.getType()).getShape(),
-            cast<RankedTensorType>(old.getType()).getElementType(), it->second);
-      }
-      newV.setType(newType);
+      newV.setType(getTypeWithEncoding(old.getType(), it->second));
       addRematValue(old, it->second, newV);
     }
   }
@@ -1193,6 +1309,58 @@ void LayoutRematerialization::hoistConvertOnTopOfExtOrBroadcast() {
   }
 }
 
+/// Returns true if the DPAS operand \p convertOp converts a load of a loop to
+/// is better loaded cooperatively by the work-group, each sub-group loading a
+/// unique slice staged through SLM, than directly into the registers of all
+/// the sub-groups sharing it.
+///
+/// Per byte of the tile, the direct loads fetch it once per sub-group sharing
+/// it, the duplicated fetches hitting the L1 cache as long as the loads of an
+/// iteration fit in \p cacheSize, and going to L3 otherwise. The cooperative
+/// load fetches it once, stores it to SLM and reads it once per sub-group.
+static bool preferCooperativeLoad(ConvertLayoutOp convertOp,
+                                  unsigned cacheSize) {
+  // The L3 cache serves a Xe-core at about a quarter of the L1 bandwidth.
+  constexpr double l3Penalty = 4.0;
+  auto dotLayout =
+      dyn_cast<DotOperandEncodingAttr>(convertOp.getType().getEncoding());
+  if (!cacheSize || !dotLayout)
+    return false;
+  auto dpasLayout = dyn_cast<ttgi::DpasEncodingAttr>(dotLayout.getParent());
+  auto loadOp = convertOp.getSrc().getDefiningOp<LoadOp>();
+  if (!dpasLayout || !loadOp)
+    return false;
+  auto forOp = loadOp->getParentOfType<scf::ForOp>();
+  if (!forOp)
+    return false;
+
+  // The A operand is shared by the sub-groups along N, the B operand by the
+  // sub-groups along M.
+  SmallVector<unsigned> warpsPerCTA(dpasLayout.getWarpsPerCTA());
+  unsigned rank = warpsPerCTA.size();
+  unsigned numCopies = dotLayout.getOpIdx() == 0 ? warpsPerCTA[rank - 1]
+                                                 : warpsPerCTA[rank - 2];
+  if (numCopies < 2)
+    return false;
+
+  int64_t workingSet = 0;
+  for (auto load : forOp.getBody()->getOps<LoadOp>()) {
+    auto tensorType = dyn_cast<RankedTensorType>(load.getType());
+    if (tensorType)
+      workingSet += tensorType.getNumElements() *
+                    tensorType.getElementTypeBitWidth() / 8;
+  }
+  double hitRate = std::min(
+      1.0, static_cast<double>(cacheSize) / std::max<int64_t>(workingSet, 1));
+  double directCost =
+      1 + (numCopies - 1) * (hitRate + (1 - hitRate) * l3Penalty);
+  double cooperativeCost = 2 + numCopies;
+  LDBG("dot operand copies: " << numCopies << ", loop working set: "
+                              << workingSet << ", direct cost: " << directCost
+                              << ", cooperative cost: " << cooperativeCost);
+  return cooperativeCost < directCost;
+}
+
 void LayoutRematerialization::backwardRematerialization(
     ConvertLayoutOp convertOp) {
   RankedTensorType targetType = convertOp.getType();
@@ -1202,6 +1370,11 @@ void LayoutRematerialization::backwardRematerialization(
           dyn_cast<DotOperandEncodingAttr>(targetType.getEncoding()))
     if (isa<BlockedEncodingAttr>(dotLayout.getParent()))
       return;
+  // Nor to the loads the duplicated fetches of which would miss the cache.
+  if (preferCooperativeLoad(convertOp, cacheSize)) {
+    LDBG("keep the cooperative load of " << convertOp);
+    return;
+  }
   Value oldV = convertOp->getOperand(0);
   LDBG("check backward remat with source " << oldV << " encoding "
                                            << targetType.getEncoding());
@@ -1320,9 +1493,95 @@ void LayoutRematerialization::hoistConvertOnTopOfExtOrBroadcast(
   rewriteSlice(slice, layout, convertOp, mapping);
 }
 
-void backwardRematerialization(ModuleOp module) {
-  module.walk([](FuncOp funcOp) {
-    LayoutRematerialization layoutRemat(funcOp);
+void LayoutRematerialization::hoistDotOperandConvertOnTopOfDequant() {
+  // Go through each ConvertLayoutOp.
+  SmallVector<ConvertLayoutOp> convertOps;
+  funcOp.walk(
+      [&](ConvertLayoutOp convertOp) { convertOps.push_back(convertOp); });
+  for (ConvertLayoutOp convertOp : convertOps) {
+    hoistDotOperandConvertOnTopOfDequant(convertOp);
+  }
+}
+
+// For converts to a DPAS dot operand layout fed by a dequantization sequence
+// (e.g. packed int4 weights loaded as 8-bit integers, unpacked with shifts and
+// masks, converted to floating point and scaled), convert the loaded values
+// instead and rematerialize the dequantization in the dot operand layout. The
+// unpacking then runs in registers in the layout consumed by DPAS, and the
+// convert moves the narrow integer data rather than the dequantized values.
+void LayoutRematerialization::hoistDotOperandConvertOnTopOfDequant(
+    ConvertLayoutOp convertOp) {
+  RankedTensorType targetType = convertOp.getType();
+  if (!ttgi::hasDotDpasEncoding(targetType) ||
+      !isa<FloatType>(targetType.getElementType()))
+    return;
+
+  auto isExpensiveLoad = [](Operation *op) {
+    return isa<LoadOp>(op) && ttgi::isExpensiveLoadOrStore(op);
+  };
+  // 1. Take a backward slice of all the tensor dependencies, stopping at the
+  // loads that cannot be rematerialized.
+  SetVector<Value> slice;
+  DenseMap<Value, Attribute> layout;
+  // The loads themselves are not rematerializable, so the slice is checked
+  // below rather than through getRematerializableSlice.
+  if (ttgi::getConvertBackwardSlice(convertOp.getSrc(), slice,
+                                    targetType.getEncoding(), layout,
+                                    isExpensiveLoad)
+          .failed() ||
+      slice.empty())
+    return;
+
+  SmallVector<Value> loads;
+  bool hasNarrowIntLoad = false, hasIntToFp = false;
+  for (Value v : slice) {
+    Operation *op = v.getDefiningOp();
+    if (!op)
+      continue;
+    if (isExpensiveLoad(op)) {
+      auto tensorType = cast<RankedTensorType>(v.getType());
+      hasNarrowIntLoad |= isa<IntegerType>(tensorType.getElementType()) &&
+                          tensorType.getElementTypeBitWidth() <= 8;
+      loads.push_back(v);
+      continue;
+    }
+    hasIntToFp |= isa<arith::SIToFPOp, arith::UIToFPOp>(op);
+    if (!canBeRemat(op))
+      return;
+  }
+  if (!hasNarrowIntLoad || !hasIntToFp)
+    return;
+
+  LLVM_DEBUG({
+    DBGS() << "  hoist dot operand convert above dequantization " << convertOp
+           << '\n';
+    for (Value v : loads)
+      DBGS() << "    load " << v << '\n';
+  });
+
+  // 2. Convert the loaded values to the layout required by the slice.
+  IRMapping mapping;
+  for (Value v : loads) {
+    slice.remove(v);
+    auto tensorType = cast<RankedTensorType>(v.getType());
+    if (tensorType.getEncoding() == layout[v])
+      continue;
+    OpBuilder builder(v.getContext());
+    builder.setInsertionPointAfterValue(v);
+    auto newType = RankedTensorType::get(
+        tensorType.getShape(), tensorType.getElementType(), layout[v]);
+    auto newConvertOp =
+        builder.create<ConvertLayoutOp>(convertOp.getLoc(), newType, v);
+    mapping.map(v, newConvertOp.getResult());
+  }
+
+  // 3. Rewrite the slice.
+  rewriteSlice(slice, layout, convertOp, mapping);
+}
+
+void backwardRematerialization(ModuleOp module, unsigned cacheSize) {
+  module.walk([&](FuncOp funcOp) {
+    LayoutRematerialization layoutRemat(funcOp, cacheSize);
     layoutRemat.backwardRematerialization();
     layoutRemat.cleanup();
   });
@@ -1332,6 +1591,7 @@ void hoistConvert(ModuleOp module) {
   SmallVector<ConvertLayoutOp> convertOps;
   module.walk([](FuncOp funcOp) {
     LayoutRematerialization layoutRemat(funcOp);
+    layoutRemat.hoistDotOperandConvertOnTopOfDequant();
     layoutRemat.hoistConvertOnTopOfExtOrBroadcast();
     layoutRemat.cleanup();
   });
@@ -1341,6 +1601,8 @@ class TritonIntelGPURemoveLayoutConversionsPass
     : public intel::impl::TritonIntelGPURemoveLayoutConversionsBase<
           TritonIntelGPURemoveLayoutConversionsPass> {
 public:
+  using Base::Base;
+
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     ModuleOp m = getOperation();
@@ -1372,7 +1634,7 @@ public:
 
     // 2. For remaining convert ops, try to rematerialize the slice of producer
     // operation to avoid having to convert.
-    backwardRematerialization(m);
+    backwardRematerialization(m, cacheSize);
     LLVM_DEBUG({
       DBGS() << "Module after backward remat:\n";
       m.dump();
@@ -1403,6 +1665,7 @@ public:
     populateForOpDeadArgumentElimination(cleanUpPatterns2);
     scf::ForOp::getCanonicalizationPatterns(cleanUpPatterns2, context);
     scf::IfOp::getCanonicalizationPatterns(cleanUpPatterns2, context);
+    scf::WhileOp::getCanonicalizationPatterns(cleanUpPatterns2, context);
     ConvertLayoutOp::getCanonicalizationPatterns(cleanUpPatterns2, context);
     if (applyPatternsAndFoldGreedily(m, std::move(cleanUpPatterns2)).failed()) {
       signalPassFailure();
@@ -0,0 +1,149 @@
+#include "intel/include/Analysis/Range.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/Utils/InferIntRangeCommon.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritonintelgpu-remove-redundant-masks"
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttgi = mlir::triton::gpu::intel;
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUREMOVEREDUNDANTMASKS
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+namespace {
+
+/// Returns the result of \p cmpOp if the ranges of its operands determine it.
+std::optional<bool> evaluate(DataFlowSolver &solver, arith::CmpIOp cmpOp) {
+  std::optional<ConstantIntRanges> lhs =
+      ttgi::getIntegerRange(solver, cmpOp.getLhs());
+  std::optional<ConstantIntRanges> rhs =
+      ttgi::getIntegerRange(solver, cmpOp.getRhs());
+  if (!lhs || !rhs)
+    return std::nullopt;
+  // The predicates of `intrange` are those of `arith`.
+  auto pred = static_cast<intrange::CmpPredicate>(cmpOp.getPredicate());
+  return intrange::evaluatePred(pred, *lhs, *rhs);
+}
+
+/// Returns whether the offsets \p offsets along a dimension of size
+/// \p blockDim are provably within [0, shape).
+bool isInBounds(DataFlowSolver &solver, ArrayRef<Value> offsets,
+                int64_t blockDim, Value shape) {
+  std::optional<ConstantIntRanges> shapeRange =
+      ttgi::getIntegerRange(solver, shape);
+  if (!shapeRange)
+    return false;
+  // The offsets are i32, their sum over a few advances does not overflow.
+  int64_t min = 0, max = 0;
+  for (Value offset : offsets) {
+    std::optional<ConstantIntRanges> range =
+        ttgi::getIntegerRange(solver, offset);
+    if (!range)
+      return false;
+    min += range->smin().getSExtValue();
+    max += range->smax().getSExtValue();
+  }
+  return min >= 0 && max + blockDim <= shapeRange->smin().getSExtValue();
+}
+
+/// Drops the dimensions of the boundary check of \p op that are in bounds, if
+/// its block pointer is created or advanced (outside of a loop) by constant
+/// offsets.
+template <typename OpTy>
+void removeInBoundsChecks(DataFlowSolver &solver, OpTy op) {
+  ArrayRef<int32_t> boundaryCheck = op.getBoundaryCheck();
+  if (boundaryCheck.empty())
+    return;
+
+  SmallVector<tt::AdvanceOp> advanceOps;
+  Value ptr = op.getPtr();
+  while (auto advanceOp = ptr.getDefiningOp<tt::AdvanceOp>()) {
+    advanceOps.push_back(advanceOp);
+    ptr = advanceOp.getPtr();
+  }
+  auto makeTensorPtrOp = ptr.getDefiningOp<tt::MakeTensorPtrOp>();
+  if (!makeTensorPtrOp)
+    return;
+
+  ArrayRef<int64_t> blockShape =
+      cast<RankedTensorType>(
+          cast<tt::PointerType>(makeTensorPtrOp.getType()).getPointeeType())
+          .getShape();
+  SmallVector<int32_t> newBoundaryCheck;
+  for (int32_t dim : boundaryCheck) {
+    SmallVector<Value> offsets{makeTensorPtrOp.getOffsets()[dim]};
+    for (tt::AdvanceOp advanceOp : advanceOps)
+      offsets.push_back(advanceOp.getOffsets()[dim]);
+    if (!isInBounds(solver, offsets, blockShape[dim],
+                    makeTensorPtrOp.getShape()[dim]))
+      newBoundaryCheck.push_back(dim);
+  }
+  if (newBoundaryCheck.size() == boundaryCheck.size())
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "Removed in bounds checks of: " << op << "\n");
+  op.setBoundaryCheckAttr(
+      DenseI32ArrayAttr::get(op.getContext(), newBoundaryCheck));
+}
+
+struct TritonIntelGPURemoveRedundantMasksPass
+    : public triton::gpu::intel::impl::TritonIntelGPURemoveRedundantMasksBase<
+          TritonIntelGPURemoveRedundantMasksPass> {
+public:
+  using triton::gpu::intel::impl::TritonIntelGPURemoveRedundantMasksBase<
+      TritonIntelGPURemoveRedundantMasksPass>::
+      TritonIntelGPURemoveRedundantMasksBase;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    std::unique_ptr<DataFlowSolver> solver = ttgi::runIntegerRangeAnalysis(mod);
+    if (!solver)
+      return signalPassFailure();
+
+    // Query the analysis before changing the module.
+    SmallVector<std::pair<arith::CmpIOp, bool>> knownCmpOps;
+    mod.walk([&](Operation *op) {
+      TypeSwitch<Operation *>(op)
+          .Case<arith::CmpIOp>([&](auto cmpOp) {
+            if (std::optional<bool> result = evaluate(*solver, cmpOp))
+              knownCmpOps.emplace_back(cmpOp, *result);
+          })
+          .Case<tt::LoadOp, tt::StoreOp>(
+              [&](auto op) { removeInBoundsChecks(*solver, op); });
+    });
+
+    for (auto [cmpOp, result] : knownCmpOps) {
+      OpBuilder builder(cmpOp);
+      TypedAttr attr = builder.getBoolAttr(result);
+      if (auto shapedType = dyn_cast<ShapedType>(cmpOp.getType()))
+        attr = DenseElementsAttr::get(shapedType, result);
+      LLVM_DEBUG(llvm::dbgs() << "Folded " << cmpOp << " to " << attr << "\n");
+      cmpOp.replaceAllUsesWith(
+          builder.create<arith::ConstantOp>(cmpOp.getLoc(), attr).getResult());
+      cmpOp.erase();
+    }
+
+    // Remove the masks that are always true, the `other` values of the loads
+    // are then unused.
+    mod.walk([](tt::LoadOp loadOp) {
+      if (loadOp.getMask() && matchPattern(loadOp.getMask(), m_One())) {
+        loadOp.getMaskMutable().clear();
+        loadOp.getOtherMutable().clear();
+      }
+    });
+    mod.walk([](tt::StoreOp storeOp) {
+      if (storeOp.getMask() && matchPattern(storeOp.getMask(), m_One()))
+        storeOp.getMaskMutable().clear();
+    });
+  }
+};
+
+} // namespace
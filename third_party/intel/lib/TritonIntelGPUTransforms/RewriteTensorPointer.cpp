@@ -32,6 +32,8 @@ namespace {
 ///   and does not have DpasEncoding
 ///   - the tensor pointer pitch is not divisible by Qword bitwidth
 ///   - the tensor pointer is not contiguous on memory
+///   - the tensor pointer is column-major and is not a dot B operand or a dot
+///   A operand of 16-bit elements
 bool shouldRemove(tt::MakeTensorPtrOp &op, bool isUsedByStoreOp) {
   if (!op->getParentOfType<ModuleOp>()->hasAttr(
           ttgi::TritonIntelGPUDialect::getSupportSG2DBlockAttrName()))
@@ -51,18 +53,34 @@ bool shouldRemove(tt::MakeTensorPtrOp &op, bool isUsedByStoreOp) {
   ArrayRef<int32_t> order = op.getOrder();
   ArrayRef<int64_t> tensorShape = tensorType.getShape();
 
-  // TODO: support column-major tensor
-  // HW 2D block read instruction has restriction on pitch divisibility
-  if (strides.size() == 2) {
-    auto pitch = strides[0];
-    // Across Intel platforms, the strictest pitch restriction is to be a
-    // multiple of OWord(128 bits).
-    if (!ttgi::isDivisible(pitch, 128 / tensorType.getElementTypeBitWidth()))
+  if (strides.size() != 2)
+    return true;
+
+  // The fast changing dimension is given by the block pointer order. A
+  // column-major block pointer (e.g. the result of `tl.trans` applied to a
+  // row-major tensor) is read with the transposed 2D block read, which is
+  // supported for the B operand of a dot, and for the A operand of a dot of
+  // 16-bit elements.
+  unsigned fastChangeDim = order[0];
+  if (fastChangeDim != 1) {
+    auto dotLayout =
+        dyn_cast<ttg::DotOperandEncodingAttr>(tensorType.getEncoding());
+    if (isUsedByStoreOp || !dotLayout)
+      return true;
+    if (dotLayout.getOpIdx() == 0 &&
+        tensorType.getElementTypeBitWidth() != 16)
       return true;
   }
 
+  // HW 2D block read instruction has restriction on pitch divisibility
+  auto pitch = strides[1 - fastChangeDim];
+  // Across Intel platforms, the strictest pitch restriction is to be a
+  // multiple of OWord(128 bits).
+  if (!ttgi::isDivisible(pitch, 128 / tensorType.getElementTypeBitWidth()))
+    return true;
+
   // HW 2D block read instruction only supports contiguous accessing.
-  auto fastChangeStride = strides[1];
+  auto fastChangeStride = strides[fastChangeDim];
   if (auto stride = fastChangeStride.getDefiningOp<arith::ConstantOp>()) {
     if (auto strideInt = dyn_cast<IntegerAttr>(stride.getValue()))
       return strideInt.getInt() != 1;
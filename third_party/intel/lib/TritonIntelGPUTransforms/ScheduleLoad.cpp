@@ -48,6 +48,8 @@ public:
 
     MLIRContext *ctx = &getContext();
     ModuleOp mod = getOperation();
+    sinkAcrossRegions =
+        !triton::tools::getBoolEnv("TRITON_INTEL_DO_NOT_SINK_INSTR_ACROSS_RGN");
 
     mod.walk<WalkOrder::PreOrder>([&](scf::ForOp loop) {
       visited.clear();
@@ -101,9 +103,6 @@ private:
     if (visited.contains(val))
       return;
 
-    bool sinkAcrossRegions =
-        !triton::tools::getBoolEnv("TRITON_INTEL_DO_NOT_SINK_INSTR_ACROSS_RGN");
-
     auto belongsToRegion = [&](Value val, Region &rgn) {
       Operation *def = val.getDefiningOp();
       return (def && def->getParentRegion() == &rgn);
@@ -134,6 +133,7 @@ private:
   }
 
   DenseSet<Value> visited;
+  bool sinkAcrossRegions = true;
 };
 
 } // namespace
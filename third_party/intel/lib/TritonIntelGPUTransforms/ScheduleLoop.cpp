@@ -0,0 +1,266 @@
+//===- ScheduleLoop.cpp -------------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements a list scheduler for the body of loops containing
+/// dots, on the advanced path. The scheduler models the latency of DPAS
+/// instructions and 2D block loads, and the number of bytes live per
+/// work-item, so that loads and prefetches are issued early enough to hide
+/// their latency behind the DPAS chains without exceeding the GRF budget.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "intel/include/Analysis/Liveness.h"
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUSCHEDULELOOP
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+namespace ttgi = mlir::triton::gpu::intel;
+
+#define DEBUG_TYPE "tritonintelgpu-schedule-loop"
+
+namespace {
+
+/// Size (in bytes) of a GRF.
+constexpr unsigned grfSize = 64;
+
+/// Returns whether \p op can be reordered with the other schedulable operations
+/// of its block.
+bool isSchedulable(Operation *op) {
+  if (op->getNumRegions() != 0 || op->hasTrait<OpTrait::IsTerminator>())
+    return false;
+  // A prefetch only hints the cache, so it can be moved across reads.
+  if (isa<ttgi::PrefetchOp>(op) || isMemoryEffectFree(op))
+    return true;
+  auto memEffects = dyn_cast<MemoryEffectOpInterface>(op);
+  return memEffects && memEffects.onlyHasEffect<MemoryEffects::Read>();
+}
+
+/// Returns the number of bytes of \p val held by each work-item.
+unsigned getNumBytesPerThread(Value val, unsigned threadsPerWarp) {
+  auto tensorTy = dyn_cast<RankedTensorType>(val.getType());
+  if (!tensorTy)
+    return 0;
+  Type elemTy = tensorTy.getElementType();
+  unsigned bitWidth =
+      elemTy.isIntOrFloat() ? elemTy.getIntOrFloatBitWidth() : 64;
+  return llvm::divideCeil(tensorTy.getNumElements() * bitWidth / 8,
+                          threadsPerWarp);
+}
+
+/// Schedules a sequence of schedulable operations of a block.
+class ListScheduler {
+public:
+  ListScheduler(ArrayRef<Operation *> ops, const Liveness::ValueSetT &liveIn,
+                const Liveness::ValueSetT &liveOut, unsigned threadsPerWarp,
+                int budget, unsigned dpasLatency, unsigned loadLatency)
+      : ops(ops), liveOut(liveOut), threadsPerWarp(threadsPerWarp),
+        budget(budget) {
+    for (auto [idx, op] : llvm::enumerate(ops))
+      indices[op] = idx;
+
+    preds.resize(ops.size());
+    succs.resize(ops.size());
+    latencies.resize(ops.size());
+    for (auto [idx, op] : llvm::enumerate(ops)) {
+      latencies[idx] = isa<tt::DotOp>(op)    ? dpasLatency
+                       : isa<tt::LoadOp>(op) ? loadLatency
+                                             : 1;
+      for (Value operand : llvm::SetVector<Value>(op->operand_begin(),
+                                                  op->operand_end())) {
+        ++remainingUses[operand];
+        Operation *def = operand.getDefiningOp();
+        if (def && indices.contains(def) &&
+            !llvm::is_contained(preds[idx], indices[def])) {
+          preds[idx].push_back(indices[def]);
+          succs[indices[def]].push_back(idx);
+        }
+      }
+    }
+
+    // The priority of an operation is the latency of the longest path from it
+    // to the end of the sequence.
+    heights.resize(ops.size());
+    for (int idx = ops.size() - 1; idx >= 0; --idx) {
+      unsigned height = 0;
+      for (unsigned succ : succs[idx])
+        height = std::max(height, heights[succ]);
+      heights[idx] = height + latencies[idx];
+    }
+
+    for (Value val : liveIn) {
+      Operation *def = val.getDefiningOp();
+      if (!def || !indices.contains(def))
+        pressure += getNumBytesPerThread(val, threadsPerWarp);
+    }
+  }
+
+  /// Returns the operations in scheduled order.
+  SmallVector<Operation *> schedule() {
+    SmallVector<Operation *> order;
+    SmallVector<unsigned> numScheduledPreds(ops.size(), 0);
+    SmallVector<unsigned> readyCycles(ops.size(), 0);
+    SmallVector<unsigned> ready;
+    for (unsigned idx = 0; idx < ops.size(); ++idx)
+      if (preds[idx].empty())
+        ready.push_back(idx);
+
+    unsigned cycle = 0;
+    int maxPressure = pressure;
+    while (!ready.empty()) {
+      unsigned *best = pick(ready, readyCycles, cycle);
+      unsigned idx = *best;
+      ready.erase(best);
+
+      cycle = std::max(cycle, readyCycles[idx]);
+      pressure += getPressureDelta(idx);
+      maxPressure = std::max(maxPressure, pressure);
+      for (Value operand : llvm::SetVector<Value>(ops[idx]->operand_begin(),
+                                                  ops[idx]->operand_end()))
+        --remainingUses[operand];
+      order.push_back(ops[idx]);
+
+      for (unsigned succ : succs[idx]) {
+        readyCycles[succ] =
+            std::max(readyCycles[succ], cycle + latencies[idx]);
+        if (++numScheduledPreds[succ] == preds[succ].size())
+          ready.push_back(succ);
+      }
+      ++cycle;
+    }
+    assert(order.size() == ops.size() && "Expecting all operations scheduled");
+    LLVM_DEBUG(llvm::dbgs() << "Scheduled " << ops.size()
+                            << " operations in " << cycle << " cycles, max "
+                            << maxPressure << " live bytes per work-item\n");
+    return order;
+  }
+
+private:
+  /// Returns the change of the number of live bytes if \p idx is scheduled.
+  int getPressureDelta(unsigned idx) const {
+    int delta = 0;
+    for (Value res : ops[idx]->getResults())
+      if (!res.use_empty() || liveOut.contains(res))
+        delta += getNumBytesPerThread(res, threadsPerWarp);
+    for (Value operand : llvm::SetVector<Value>(ops[idx]->operand_begin(),
+                                                ops[idx]->operand_end()))
+      if (remainingUses.lookup(operand) == 1 && !liveOut.contains(operand))
+        delta -= getNumBytesPerThread(operand, threadsPerWarp);
+    return delta;
+  }
+
+  /// Picks the next operation to schedule among the \p ready ones:
+  /// - the operations keeping the live bytes under the budget are scheduled by
+  ///   readiness at \p cycle, then by critical path,
+  /// - otherwise the operation releasing the most bytes is scheduled, or the
+  ///   first one in program order if none releases any.
+  unsigned *pick(SmallVector<unsigned> &ready,
+                 ArrayRef<unsigned> readyCycles, unsigned cycle) const {
+    unsigned *best = nullptr;
+    auto isBetter = [&](unsigned lhs, unsigned rhs) {
+      bool lhsReady = readyCycles[lhs] <= cycle;
+      bool rhsReady = readyCycles[rhs] <= cycle;
+      if (lhsReady != rhsReady)
+        return lhsReady;
+      if (heights[lhs] != heights[rhs])
+        return heights[lhs] > heights[rhs];
+      return lhs < rhs;
+    };
+    for (unsigned &idx : ready)
+      if (pressure + getPressureDelta(idx) <= budget &&
+          (!best || isBetter(idx, *best)))
+        best = &idx;
+    if (best)
+      return best;
+
+    int bestDelta = 0;
+    for (unsigned &idx : ready) {
+      int delta = getPressureDelta(idx);
+      if (delta <= 0 && (!best || delta < bestDelta ||
+                         (delta == bestDelta && idx < *best))) {
+        best = &idx;
+        bestDelta = delta;
+      }
+    }
+    if (best)
+      return best;
+    return llvm::min_element(ready);
+  }
+
+  ArrayRef<Operation *> ops;
+  const Liveness::ValueSetT &liveOut;
+  unsigned threadsPerWarp;
+  int budget;
+  DenseMap<Operation *, unsigned> indices;
+  SmallVector<SmallVector<unsigned>> preds, succs;
+  SmallVector<unsigned> latencies, heights;
+  DenseMap<Value, unsigned> remainingUses;
+  // Number of live bytes per work-item.
+  int pressure = 0;
+};
+
+class ScheduleLoopPass
+    : public triton::gpu::intel::impl::TritonIntelGPUScheduleLoopBase<
+          ScheduleLoopPass> {
+public:
+  using Base::Base;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    unsigned threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    mod.walk([&](scf::ForOp loop) {
+      if (!loop.getOps<tt::DotOp>().empty())
+        scheduleLoopBody(loop, threadsPerWarp);
+    });
+  }
+
+private:
+  void scheduleLoopBody(scf::ForOp loop, unsigned threadsPerWarp) {
+    // Split the body into sequences of schedulable operations, each ending
+    // before an operation that cannot be moved.
+    SmallVector<std::pair<SmallVector<Operation *>, Operation *>> sequences;
+    SmallVector<Operation *> sequence;
+    for (Operation &op : *loop.getBody()) {
+      if (isSchedulable(&op)) {
+        sequence.push_back(&op);
+        continue;
+      }
+      if (sequence.size() > 1)
+        sequences.emplace_back(sequence, &op);
+      sequence.clear();
+    }
+
+    ttgi::LivenessAnalysis liveness(loop);
+    for (auto &[ops, end] : sequences) {
+      Liveness::ValueSetT liveIn = liveness.getLiveValues(ops.front());
+      Liveness::ValueSetT liveOut = liveness.getLiveValues(end);
+      ListScheduler scheduler(ops, liveIn, liveOut, threadsPerWarp,
+                              grfBudget * grfSize, dpasLatency, loadLatency);
+      for (Operation *op : scheduler.schedule())
+        op->moveBefore(end);
+    }
+  }
+};
+
+} // namespace
@@ -0,0 +1,146 @@
+//===- SwizzleProgramIds.cpp --------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the remapping of the program ids of kernels launched
+/// over a 2D grid of tiles. The work-groups are dispatched in the order of
+/// their linear id, along X first, so the programs running at once compute a
+/// row of tiles and each of them loads its own column of operand blocks. The
+/// remapped programs walk the grid by groups of rows instead, so that the
+/// programs running at once compute a square block of tiles, sharing their
+/// operand blocks in the L3 cache.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Debug.h"
+
+#include <cmath>
+
+#define DEBUG_TYPE "tritonintelgpu-swizzle-program-ids"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUSWIZZLEPROGRAMIDS
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+
+namespace {
+
+/// Rows of tiles per group when the number of Xe-cores is unknown.
+constexpr unsigned defaultGroupSize = 8;
+
+/// Returns the number of bytes loaded by each program per iteration of its
+/// loops, i.e. the operand blocks of its tile.
+uint64_t getLoadedBytes(tt::FuncOp func) {
+  uint64_t bytes = 0;
+  func.walk([&](tt::LoadOp loadOp) {
+    Type type = loadOp.getType();
+    if (auto tensorType = dyn_cast<RankedTensorType>(type))
+      bytes += tensorType.getNumElements() *
+               tensorType.getElementTypeBitWidth() / 8;
+    else if (type.isIntOrFloat())
+      bytes += type.getIntOrFloatBitWidth() / 8;
+  });
+  return bytes;
+}
+
+struct SwizzleProgramIdsPass
+    : public triton::gpu::intel::impl::TritonIntelGPUSwizzleProgramIdsBase<
+          SwizzleProgramIdsPass> {
+  using Base::Base;
+
+  void runOnOperation() override {
+    getOperation().walk([&](tt::FuncOp func) {
+      if (func.isPublic())
+        swizzle(func);
+    });
+  }
+
+private:
+  /// Returns the number of rows of tiles of the groups of \p func: the side
+  /// of the square block of tiles computed by one program per Xe-core, as
+  /// long as the operand blocks loaded at once by the block fit in the cache.
+  unsigned getGroupSize(tt::FuncOp func) const {
+    if (groupSize > 0)
+      return groupSize;
+    if (numXeCores == 0)
+      return defaultGroupSize;
+    uint64_t size =
+        llvm::bit_floor(static_cast<uint64_t>(std::sqrt(double(numXeCores))));
+    // The G x G programs of a block load the operand blocks of G rows and G
+    // columns of tiles, i.e. G times the bytes loaded by a program.
+    uint64_t loadedBytes = getLoadedBytes(func);
+    if (cacheSize != 0)
+      while (size > 1 && size * loadedBytes > cacheSize)
+        size /= 2;
+    return std::max<uint64_t>(size, 1);
+  }
+
+  void swizzle(tt::FuncOp func) {
+    SmallVector<tt::GetProgramIdOp> pidOps[2];
+    func.walk([&](tt::GetProgramIdOp op) {
+      if (op.getAxis() != tt::ProgramIDDim::Z)
+        pidOps[op.getAxisAsInt()].push_back(op);
+    });
+    // Kernels with a 1D grid map their program id to their tiles themselves.
+    if (pidOps[0].empty() || pidOps[1].empty())
+      return;
+
+    unsigned size = getGroupSize(func);
+    LDBG("Swizzling " << func.getName() << " by groups of " << size
+                      << " rows");
+
+    // pid = pidY * gridX + pidX is the dispatch order of the program. A group
+    // of `size` rows holds size * gridY programs, and its last group may hold
+    // fewer rows.
+    //   group = pid / (size * gridY), first = group * size
+    //   rows = min(size, gridX - first)
+    //   pidX' = first + (pid % (size * gridY)) % rows
+    //   pidY' = (pid % (size * gridY)) / rows
+    OpBuilder b(&func.getBody().front(), func.getBody().front().begin());
+    Location loc = func.getLoc();
+    Type i32Ty = b.getI32Type();
+    Value pidX = b.create<tt::GetProgramIdOp>(loc, i32Ty, tt::ProgramIDDim::X);
+    Value pidY = b.create<tt::GetProgramIdOp>(loc, i32Ty, tt::ProgramIDDim::Y);
+    Value gridX =
+        b.create<tt::GetNumProgramsOp>(loc, i32Ty, tt::ProgramIDDim::X);
+    Value gridY =
+        b.create<tt::GetNumProgramsOp>(loc, i32Ty, tt::ProgramIDDim::Y);
+    Value sizeVal = b.create<arith::ConstantIntOp>(loc, size, 32);
+
+    Value pid = b.create<arith::AddIOp>(
+        loc, b.create<arith::MulIOp>(loc, pidY, gridX), pidX);
+    Value width = b.create<arith::MulIOp>(loc, sizeVal, gridY);
+    Value group = b.create<arith::DivSIOp>(loc, pid, width);
+    Value first = b.create<arith::MulIOp>(loc, group, sizeVal);
+    Value rows = b.create<arith::MinSIOp>(
+        loc, sizeVal, b.create<arith::SubIOp>(loc, gridX, first));
+    Value inGroup = b.create<arith::RemSIOp>(loc, pid, width);
+    Value newPidX = b.create<arith::AddIOp>(
+        loc, first, b.create<arith::RemSIOp>(loc, inGroup, rows));
+    Value newPidY = b.create<arith::DivSIOp>(loc, inGroup, rows);
+
+    Value newPids[2] = {newPidX, newPidY};
+    for (unsigned axis = 0; axis < 2; ++axis) {
+      for (tt::GetProgramIdOp op : pidOps[axis]) {
+        op.replaceAllUsesWith(newPids[axis]);
+        op.erase();
+      }
+    }
+  }
+};
+
+} // namespace
@@ -0,0 +1,115 @@
+//===- UnrollDotLoop.cpp ------------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the unrolling of loops with dots and a small constant
+/// trip count, on the advanced path. Unrolling exposes the loads and the
+/// independent DPAS chains of consecutive iterations to the scheduler, which
+/// can then interleave them to hide the DPAS latency of short K-loops.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+
+#include "intel/include/Analysis/RegisterPressure.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include "llvm/Support/Debug.h"
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUUNROLLDOTLOOP
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+namespace ttgi = mlir::triton::gpu::intel;
+
+#define DEBUG_TYPE "tritonintelgpu-unroll-dot-loop"
+
+namespace {
+
+/// Size (in bytes) of a GRF.
+constexpr unsigned grfSize = 64;
+
+/// Loops explicitly unrolled by the user are left to the loop unroll pass.
+constexpr const char *loopUnrollFactorAttrName = "tt.loop_unroll_factor";
+
+/// Returns the trip count of \p loop if its bounds are constant.
+std::optional<int64_t> getConstantTripCount(scf::ForOp loop) {
+  std::optional<int64_t> lb = getConstantIntValue(loop.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(loop.getUpperBound());
+  std::optional<int64_t> step = getConstantIntValue(loop.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return std::nullopt;
+  return *ub > *lb ? llvm::divideCeil(*ub - *lb, *step) : 0;
+}
+
+class UnrollDotLoopPass
+    : public triton::gpu::intel::impl::TritonIntelGPUUnrollDotLoopBase<
+          UnrollDotLoopPass> {
+public:
+  using Base::Base;
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    unsigned threadsPerWarp = ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    SmallVector<std::pair<scf::ForOp, unsigned>> loops;
+    mod.walk([&](scf::ForOp loop) {
+      if (unsigned factor = getUnrollFactor(loop, threadsPerWarp); factor > 1)
+        loops.emplace_back(loop, factor);
+    });
+
+    for (auto [loop, factor] : loops) {
+      LLVM_DEBUG(llvm::dbgs() << "Unrolling loop by " << factor << ": "
+                              << loop << "\n");
+      (void)loopUnrollByFactor(loop, factor);
+    }
+  }
+
+private:
+  /// Returns the largest factor dividing the trip count of \p loop such that
+  /// the values carried by the loop and the loads of the unrolled iterations
+  /// fit in the GRF budget, or 1 if the loop should not be unrolled.
+  unsigned getUnrollFactor(scf::ForOp loop, unsigned threadsPerWarp) const {
+    if (loop.getOps<tt::DotOp>().empty() ||
+        loop->hasAttr(loopUnrollFactorAttrName))
+      return 1;
+    // Nested loops keep their own schedule.
+    for (Operation &op : loop.getBody()->without_terminator())
+      if (op.getNumRegions() != 0)
+        return 1;
+
+    std::optional<int64_t> tripCount = getConstantTripCount(loop);
+    if (!tripCount || *tripCount < 2 || *tripCount > maxTripCount)
+      return 1;
+
+    unsigned carriedBytes = 0;
+    for (Value arg : loop.getRegionIterArgs())
+      carriedBytes += ttgi::getBytesPerThread(arg.getType(), threadsPerWarp);
+    unsigned loadedBytes = 0;
+    for (auto loadOp : loop.getOps<tt::LoadOp>())
+      loadedBytes +=
+          ttgi::getBytesPerThread(loadOp.getType(), threadsPerWarp);
+
+    // Keep a loop, so that the scheduler still reorders the unrolled body.
+    for (int64_t factor = std::min<int64_t>(maxUnrollFactor, *tripCount - 1);
+         factor > 1; --factor) {
+      if (*tripCount % factor == 0 &&
+          carriedBytes + factor * loadedBytes <= grfBudget * grfSize)
+        return factor;
+    }
+    return 1;
+  }
+};
+
+} // namespace
@@ -61,6 +61,12 @@ bool isDivisible(Value value, unsigned divisor) {
   if (auto extSIOp = value.getDefiningOp<arith::ExtSIOp>())
     return isDivisible(extSIOp->getOperand(0), divisor);
 
+  // Case 4: Value is a product, e.g. a stride scaled by the number of
+  // channels, divisible if any of its factors is
+  if (auto mulIOp = value.getDefiningOp<arith::MulIOp>())
+    return isDivisible(mulIOp.getLhs(), divisor) ||
+           isDivisible(mulIOp.getRhs(), divisor);
+
   return false;
 }
 
@@ -174,6 +180,11 @@ getConvertBackwardSlice(Value root, SetVector<Value> &slice,
 
       continue;
     }
+    if (auto whileOp = currentValue.getDefiningOp<scf::WhileOp>()) {
+      unsigned argIdx = mlir::cast<OpResult>(currentValue).getResultNumber();
+      enqueue(whileOp.getConditionOp().getArgs()[argIdx], encoding);
+      continue;
+    }
     if (auto *definingOp = currentValue.getDefiningOp()) {
       // If the op has multiple results we need to update all results layout.
       for (Value result : definingOp->getResults()) {
@@ -211,7 +222,17 @@ getConvertBackwardSlice(Value root, SetVector<Value> &slice,
       enqueue(yieldOperand, encoding);
       continue;
     }
-    // TODO: add support for WhileOp and other region types.
+    if (auto whileOp = dyn_cast<scf::WhileOp>(parentOp)) {
+      unsigned argIdx = blockArg.getArgNumber();
+      if (block == whileOp.getBeforeBody()) {
+        enqueue(whileOp.getInits()[argIdx], encoding);
+        enqueue(whileOp.getYieldOp()->getOperand(argIdx), encoding);
+      } else {
+        enqueue(whileOp.getConditionOp().getArgs()[argIdx], encoding);
+      }
+      continue;
+    }
+    // TODO: add support for other region types.
     return failure();
   }
   return success();
@@ -284,4 +305,21 @@ bool isConstant(Value val, const unsigned expected) {
   return (getFoldedConstantValue(defOp) == expected);
 }
 
+unsigned getPrintRecordNumWords(Type type) {
+  constexpr unsigned numHeaderWords = 5;
+  if (!type)
+    return numHeaderWords;
+  // Pointers and 64-bit values take two words, narrower values are extended
+  // to one word.
+  Type elemTy = getElementTypeOrSelf(type);
+  unsigned numValueWords =
+      isa<tt::PointerType>(elemTy) || elemTy.getIntOrFloatBitWidth() > 32 ? 2
+                                                                          : 1;
+  auto tensorTy = dyn_cast<RankedTensorType>(type);
+  if (!tensorTy)
+    return numHeaderWords + numValueWords;
+  return numHeaderWords + ttg::getTotalElemsPerThread(tensorTy) *
+                              (tensorTy.getRank() + numValueWords);
+}
+
 } // namespace mlir::triton::gpu::intel
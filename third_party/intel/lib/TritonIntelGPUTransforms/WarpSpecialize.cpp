@@ -0,0 +1,346 @@
+//===- WarpSpecialize.cpp -----------------------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements a pass splitting the subgroups of a kernel into
+/// producers, which issue the 2D block prefetches of the `tt.dot` operands,
+/// and consumers, which load the operands and execute the DPAS instructions.
+/// The pass expects the IR produced by the 'distribute-to-warps' pass, where
+/// the work of every subgroup is derived from `gpu.subgroup_id`.
+///
+/// The number of subgroups of the kernel is doubled. Consumer N executes the
+/// original kernel without the prefetch operations, producer N executes only
+/// the prefetch operations of subgroup N and the computations they depend on.
+/// Loops containing prefetch operations are executed by both groups, which
+/// synchronize once per iteration with a named barrier:
+///
+///   %sgid = gpu.subgroup_id
+///   scf.if %sgid < numWarps {         // consumers
+///     scf.for {
+///       triton_gen.named_barrier_signal
+///       tt.load, tt.dot, ...
+///       triton_gen.named_barrier_wait
+///     }
+///   } else {                          // producers
+///     // computations where %sgid is replaced by %sgid - numWarps
+///     scf.for {
+///       triton_intel_gpu.prefetch
+///       triton_gen.named_barrier_signal
+///       triton_gen.named_barrier_wait
+///     }
+///   }
+///
+/// A producer can therefore not run more than one iteration ahead of the
+/// consumers, in addition to the iterations prefetched before the loop.
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
+
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir::triton::gpu::intel {
+#define GEN_PASS_DEF_TRITONINTELGPUWARPSPECIALIZE
+#include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h.inc"
+} // namespace mlir::triton::gpu::intel
+
+using namespace mlir;
+namespace tt = mlir::triton;
+namespace ttg = mlir::triton::gpu;
+namespace ttgi = mlir::triton::gpu::intel;
+
+#define DEBUG_TYPE "tritonintelgpu-warp-specialize"
+
+namespace {
+
+/// Named barrier used to synchronize producers and consumers. Barrier 0 is
+/// the work-group barrier.
+constexpr int producerConsumerBarrierId = 1;
+
+/// Module attribute holding the factor by which the number of subgroups of
+/// the kernel is multiplied.
+constexpr StringLiteral numWarpGroupsAttrName =
+    "triton_gpu.num-warp-groups-per-cta";
+
+/// Return true if \p op requires all the subgroups of the work-group to
+/// participate, which would deadlock once producers stop executing it.
+bool isWorkGroupCollective(Operation *op) {
+  return isa<gpu::BarrierOp, tt::TritonGEN::BarrierOp,
+             tt::TritonGEN::SplitBarrierSignalOp,
+             tt::TritonGEN::SplitBarrierWaitOp,
+             tt::TritonGEN::NamedBarrierSignalOp,
+             tt::TritonGEN::NamedBarrierWaitOp, ttgi::AllocOp,
+             ttg::LocalAllocOp, ttg::ConvertLayoutOp, tt::CallOp>(op);
+}
+
+/// The operations a producer has to execute: the prefetch operations and
+/// their transitive operands. Loops are recorded separately, together with
+/// the iteration arguments producers need.
+class ProducerSlice {
+public:
+  ProducerSlice(tt::FuncOp func, gpu::SubgroupIdOp subgroupId)
+      : body(func.getBody().front()), subgroupId(subgroupId) {}
+
+  /// Add \p prefetch to the slice. Return false if the operations it depends
+  /// on cannot be executed by producers.
+  bool addPrefetch(ttgi::PrefetchOp prefetch) {
+    prefetches.push_back(prefetch);
+    return addOp(prefetch);
+  }
+
+  bool contains(Operation *op) const { return ops.contains(op); }
+  bool containsLoop(scf::ForOp forOp) const {
+    return loopIterArgs.contains(forOp);
+  }
+  const llvm::BitVector &getIterArgs(scf::ForOp forOp) const {
+    return loopIterArgs.find(forOp)->second;
+  }
+  ArrayRef<ttgi::PrefetchOp> getPrefetches() const { return prefetches; }
+  gpu::SubgroupIdOp getSubgroupId() const { return subgroupId; }
+
+private:
+  /// Return the loop of the function body directly containing \p block, if
+  /// any.
+  scf::ForOp getTopLevelLoop(Block *block) const {
+    auto forOp = dyn_cast_or_null<scf::ForOp>(block->getParentOp());
+    if (forOp && forOp->getBlock() == &body)
+      return forOp;
+    return nullptr;
+  }
+
+  bool addOp(Operation *op) {
+    if (!ops.insert(op).second)
+      return true;
+    if (op->getNumRegions() != 0 ||
+        (!isa<ttgi::PrefetchOp>(op) && !isMemoryEffectFree(op))) {
+      LLVM_DEBUG(llvm::dbgs() << "Cannot execute in producer: " << *op << "\n");
+      return false;
+    }
+    if (op->getBlock() != &body) {
+      scf::ForOp forOp = getTopLevelLoop(op->getBlock());
+      if (!forOp || !addLoop(forOp))
+        return false;
+    }
+    return llvm::all_of(op->getOperands(),
+                        [&](Value operand) { return addValue(operand); });
+  }
+
+  bool addValue(Value val) {
+    if (val == subgroupId.getResult())
+      return true;
+
+    if (auto arg = dyn_cast<BlockArgument>(val)) {
+      if (arg.getOwner() == &body)
+        return true;
+      scf::ForOp forOp = getTopLevelLoop(arg.getOwner());
+      if (!forOp || !addLoop(forOp))
+        return false;
+      if (arg == forOp.getInductionVar())
+        return true;
+      return addIterArg(forOp, arg.getArgNumber() - 1);
+    }
+
+    Operation *def = val.getDefiningOp();
+    if (auto forOp = dyn_cast<scf::ForOp>(def)) {
+      if (forOp->getBlock() != &body || !addLoop(forOp))
+        return false;
+      return addIterArg(forOp, cast<OpResult>(val).getResultNumber());
+    }
+    return addOp(def);
+  }
+
+  bool addLoop(scf::ForOp forOp) {
+    if (!loopIterArgs.try_emplace(forOp, forOp.getNumRegionIterArgs()).second)
+      return true;
+    return addValue(forOp.getLowerBound()) &&
+           addValue(forOp.getUpperBound()) && addValue(forOp.getStep());
+  }
+
+  bool addIterArg(scf::ForOp forOp, unsigned idx) {
+    llvm::BitVector &iterArgs = loopIterArgs.find(forOp)->second;
+    if (iterArgs.test(idx))
+      return true;
+    iterArgs.set(idx);
+    auto yield = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+    return addValue(forOp.getInitArgs()[idx]) &&
+           addValue(yield.getOperand(idx));
+  }
+
+  Block &body;
+  gpu::SubgroupIdOp subgroupId;
+  DenseSet<Operation *> ops;
+  DenseMap<scf::ForOp, llvm::BitVector> loopIterArgs;
+  SmallVector<ttgi::PrefetchOp> prefetches;
+};
+
+class TritonIntelGPUWarpSpecializePass
+    : public triton::gpu::intel::impl::TritonIntelGPUWarpSpecializeBase<
+          TritonIntelGPUWarpSpecializePass> {
+public:
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    if (mod->hasAttr(numWarpGroupsAttrName))
+      return;
+
+    // The number of subgroups applies to the whole module.
+    auto funcs = llvm::to_vector(mod.getOps<tt::FuncOp>());
+    if (funcs.size() != 1)
+      return;
+    tt::FuncOp func = funcs.front();
+
+    std::optional<ProducerSlice> slice = collectProducerSlice(func);
+    if (!slice)
+      return;
+
+    specialize(func, *slice, ttg::TritonGPUDialect::getNumWarps(mod));
+    mod->setAttr(numWarpGroupsAttrName,
+                 IntegerAttr::get(IntegerType::get(mod.getContext(), 32), 2));
+  }
+
+private:
+  /// Collect the operations producers have to execute in \p func. Return
+  /// std::nullopt if the function cannot be specialized.
+  std::optional<ProducerSlice> collectProducerSlice(tt::FuncOp func) const {
+    if (!func.getBody().hasOneBlock())
+      return std::nullopt;
+    Block &body = func.getBody().front();
+
+    SmallVector<gpu::SubgroupIdOp> subgroupIds;
+    SmallVector<ttgi::PrefetchOp> prefetches;
+    WalkResult result = func.walk([&](Operation *op) {
+      if (isWorkGroupCollective(op)) {
+        LLVM_DEBUG(llvm::dbgs() << "Work-group collective: " << *op << "\n");
+        return WalkResult::interrupt();
+      }
+      if (auto subgroupId = dyn_cast<gpu::SubgroupIdOp>(op))
+        subgroupIds.push_back(subgroupId);
+      if (auto prefetch = dyn_cast<ttgi::PrefetchOp>(op))
+        prefetches.push_back(prefetch);
+      return WalkResult::advance();
+    });
+    if (result.wasInterrupted() || prefetches.empty() ||
+        subgroupIds.size() != 1 || subgroupIds.front()->getBlock() != &body)
+      return std::nullopt;
+
+    ProducerSlice slice(func, subgroupIds.front());
+    for (ttgi::PrefetchOp prefetch : prefetches)
+      if (!slice.addPrefetch(prefetch))
+        return std::nullopt;
+    return slice;
+  }
+
+  /// Split the subgroups of \p func into consumers and producers.
+  void specialize(tt::FuncOp func, const ProducerSlice &slice,
+                  int numWarps) const {
+    Block &body = func.getBody().front();
+    gpu::SubgroupIdOp subgroupId = slice.getSubgroupId();
+    subgroupId->moveBefore(&body.front());
+
+    Location loc = func.getLoc();
+    OpBuilder b(func.getContext());
+    b.setInsertionPointAfter(subgroupId);
+    Value numConsumers = b.create<arith::ConstantIndexOp>(loc, numWarps);
+    Value barrierId =
+        b.create<arith::ConstantIntOp>(loc, producerConsumerBarrierId, 32);
+    Value numSubgroups = b.create<arith::ConstantIntOp>(loc, 2 * numWarps, 32);
+    Value isConsumer =
+        b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::ult,
+                                subgroupId.getResult(), numConsumers);
+    auto ifOp =
+        b.create<scf::IfOp>(loc, isConsumer, /*withElseRegion=*/true);
+
+    // The consumers execute the original kernel.
+    Block *consumer = ifOp.thenBlock();
+    consumer->getOperations().splice(consumer->begin(), body.getOperations(),
+                                     std::next(ifOp->getIterator()),
+                                     body.getTerminator()->getIterator());
+
+    auto signalAndWait = [&](OpBuilder &builder, Location barrierLoc) {
+      builder.create<tt::TritonGEN::NamedBarrierSignalOp>(
+          barrierLoc, barrierId, numSubgroups);
+      builder.create<tt::TritonGEN::NamedBarrierWaitOp>(barrierLoc, barrierId);
+    };
+
+    // The producers execute the prefetch operations of the consumer with the
+    // same index.
+    b.setInsertionPoint(ifOp.elseBlock()->getTerminator());
+    IRMapping mapping;
+    mapping.map(subgroupId.getResult(),
+                b.create<arith::SubIOp>(loc, subgroupId.getResult(),
+                                        numConsumers));
+    for (Operation &op : consumer->without_terminator()) {
+      auto forOp = dyn_cast<scf::ForOp>(op);
+      if (!forOp) {
+        if (slice.contains(&op))
+          b.clone(op, mapping);
+        continue;
+      }
+      if (!slice.containsLoop(forOp))
+        continue;
+
+      const llvm::BitVector &iterArgs = slice.getIterArgs(forOp);
+      SmallVector<Value> initArgs;
+      for (unsigned idx : iterArgs.set_bits())
+        initArgs.push_back(
+            mapping.lookupOrDefault(forOp.getInitArgs()[idx]));
+
+      auto yield = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+      auto producerLoop = b.create<scf::ForOp>(
+          forOp.getLoc(), mapping.lookupOrDefault(forOp.getLowerBound()),
+          mapping.lookupOrDefault(forOp.getUpperBound()),
+          mapping.lookupOrDefault(forOp.getStep()), initArgs,
+          [&](OpBuilder &builder, Location bodyLoc, Value iv,
+              ValueRange args) {
+            mapping.map(forOp.getInductionVar(), iv);
+            for (auto [idx, arg] : llvm::zip(iterArgs.set_bits(), args))
+              mapping.map(forOp.getRegionIterArg(idx), arg);
+            for (Operation &bodyOp : forOp.getBody()->without_terminator())
+              if (slice.contains(&bodyOp))
+                builder.clone(bodyOp, mapping);
+            signalAndWait(builder, bodyLoc);
+
+            SmallVector<Value> yieldOperands;
+            for (unsigned idx : iterArgs.set_bits())
+              yieldOperands.push_back(
+                  mapping.lookupOrDefault(yield.getOperand(idx)));
+            builder.create<scf::YieldOp>(bodyLoc, yieldOperands);
+          });
+      for (auto [idx, res] :
+           llvm::zip(iterArgs.set_bits(), producerLoop.getResults()))
+        mapping.map(forOp.getResult(idx), res);
+
+      // Consumers arrive at the barrier when starting the iteration, and wait
+      // for the producers to have issued the prefetches of the iteration
+      // before starting the next one.
+      OpBuilder consumerBuilder = OpBuilder::atBlockBegin(forOp.getBody());
+      consumerBuilder.create<tt::TritonGEN::NamedBarrierSignalOp>(
+          forOp.getLoc(), barrierId, numSubgroups);
+      consumerBuilder.setInsertionPoint(yield);
+      consumerBuilder.create<tt::TritonGEN::NamedBarrierWaitOp>(forOp.getLoc(),
+                                                                barrierId);
+    }
+
+    // Consumers no longer prefetch, the computation of the prefetch addresses
+    // is left to the canonicalizer to remove.
+    for (ttgi::PrefetchOp prefetch : slice.getPrefetches())
+      prefetch->erase();
+  }
+};
+
+} // namespace
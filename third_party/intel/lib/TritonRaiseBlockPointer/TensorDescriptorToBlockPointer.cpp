@@ -0,0 +1,171 @@
+//===- TensorDescriptorToBlockPointer.cpp -------------------------------*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file rewrites the accesses through tensor descriptors created on the
+/// host into accesses through block pointers. The XPU driver passes each
+/// descriptor by value, as four 64-bit words: the base address, the width,
+/// height and pitch of the tensor in elements. The fields are read once at the
+/// entry of the kernel, so the accesses do not recompute them.
+//===----------------------------------------------------------------------===//
+
+#include "intel/include/TritonRaiseBlockPointer/Passes.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "triton-tensor-descriptor-to-block-pointer"
+
+using namespace mlir;
+
+namespace mlir::triton::intel {
+#define GEN_PASS_DEF_TRITONTENSORDESCRIPTORTOBLOCKPOINTER
+#include "intel/include/TritonRaiseBlockPointer/Passes.h.inc"
+} // namespace mlir::triton::intel
+
+namespace {
+
+/// Position of the fields of a tensor descriptor, in 64-bit words.
+enum class DescriptorField : unsigned { Base = 0, Width, Height, Pitch };
+
+/// Fields of a tensor descriptor.
+struct Descriptor {
+  Value base;
+  Value width;
+  Value height;
+  Value pitch;
+};
+
+class TritonTensorDescriptorToBlockPointer
+    : public triton::intel::impl::TritonTensorDescriptorToBlockPointerBase<
+          TritonTensorDescriptorToBlockPointer> {
+public:
+  void runOnOperation() final {
+    SmallVector<Operation *> accesses;
+    getOperation().walk([&](Operation *op) {
+      if (isa<triton::ExperimentalDescriptorLoadOp,
+              triton::ExperimentalDescriptorStoreOp>(op))
+        accesses.push_back(op);
+    });
+
+    for (Operation *op : accesses)
+      if (failed(rewriteAccess(op)))
+        return signalPassFailure();
+  }
+
+private:
+  /// Returns the fields of the descriptor \p desc accessed by \p user. The
+  /// fields are read at the entry of the kernel the first time.
+  FailureOr<Descriptor> getDescriptor(Value desc, Operation *user) {
+    auto it = descriptors.find(desc);
+    if (it != descriptors.end())
+      return it->second;
+
+    auto arg = dyn_cast<BlockArgument>(desc);
+    auto funcOp = arg ? dyn_cast<triton::FuncOp>(arg.getOwner()->getParentOp())
+                      : nullptr;
+    if (!funcOp || !arg.getOwner()->isEntryBlock() ||
+        !funcOp.getArgAttr(arg.getArgNumber(), "tt.nv_tma_desc")) {
+      user->emitError(
+          "expecting a tensor descriptor passed as a kernel argument");
+      return failure();
+    }
+
+    Block &entry = funcOp.getBody().front();
+    OpBuilder builder(&entry, entry.begin());
+    Location loc = funcOp.getLoc();
+    auto fieldPtrTy = triton::PointerType::get(
+        builder.getI64Type(),
+        cast<triton::PointerType>(desc.getType()).getAddressSpace());
+    Value fields = builder.create<triton::BitcastOp>(loc, fieldPtrTy, desc);
+    auto readField = [&](DescriptorField field) -> Value {
+      Value idx = builder.create<arith::ConstantIntOp>(
+          loc, static_cast<unsigned>(field), 32);
+      Value ptr =
+          builder.create<triton::AddPtrOp>(loc, fieldPtrTy, fields, idx);
+      return builder.create<triton::LoadOp>(loc, ptr,
+                                            triton::CacheModifier::NONE,
+                                            triton::EvictionPolicy::NORMAL,
+                                            /*isVolatile=*/false);
+    };
+
+    Descriptor descriptor{readField(DescriptorField::Base),
+                          readField(DescriptorField::Width),
+                          readField(DescriptorField::Height),
+                          readField(DescriptorField::Pitch)};
+    descriptors[desc] = descriptor;
+    return descriptor;
+  }
+
+  LogicalResult rewriteAccess(Operation *op) {
+    Value desc;
+    ValueRange indices;
+    RankedTensorType tensorTy;
+    if (auto loadOp = dyn_cast<triton::ExperimentalDescriptorLoadOp>(op)) {
+      desc = loadOp.getDescPtr();
+      indices = loadOp.getIndices();
+      tensorTy = loadOp.getType();
+    } else {
+      auto storeOp = cast<triton::ExperimentalDescriptorStoreOp>(op);
+      desc = storeOp.getDescPtr();
+      indices = storeOp.getIndices();
+      tensorTy = storeOp.getSrc().getType();
+    }
+
+    int64_t rank = tensorTy.getRank();
+    if ((rank != 1 && rank != 2) ||
+        static_cast<int64_t>(indices.size()) != rank)
+      return op->emitError("expecting a 1D or 2D tensor descriptor access");
+
+    FailureOr<Descriptor> descriptor = getDescriptor(desc, op);
+    if (failed(descriptor))
+      return failure();
+
+    OpBuilder builder(op);
+    Location loc = op->getLoc();
+    Value base = builder.create<triton::IntToPtrOp>(
+        loc, triton::PointerType::get(tensorTy.getElementType(), 1),
+        descriptor->base);
+    Value one = builder.create<arith::ConstantIntOp>(loc, 1, 64);
+    SmallVector<Value> shape, strides;
+    SmallVector<int32_t> order;
+    if (rank == 2) {
+      shape = {descriptor->height, descriptor->width};
+      strides = {descriptor->pitch, one};
+      order = {1, 0};
+    } else {
+      shape = {descriptor->width};
+      strides = {one};
+      order = {0};
+    }
+    Value ptr = builder.create<triton::MakeTensorPtrOp>(
+        loc, base, shape, strides, indices,
+        SmallVector<int32_t>(tensorTy.getShape()), order);
+    LLVM_DEBUG(llvm::dbgs() << "creating tt.make_tensor_ptr:\n" << ptr << "\n");
+
+    // Out of bounds elements are read as zeros, like with TMA.
+    auto boundaryCheck = llvm::to_vector(llvm::seq<int32_t>(0, rank));
+    if (auto loadOp = dyn_cast<triton::ExperimentalDescriptorLoadOp>(op)) {
+      auto newLoadOp = builder.create<triton::LoadOp>(
+          loc, ptr, boundaryCheck, triton::PaddingOption::PAD_ZERO,
+          loadOp.getCache(), loadOp.getEvict(), /*isVolatile=*/false);
+      loadOp.replaceAllUsesWith(newLoadOp.getResult());
+    } else {
+      auto storeOp = cast<triton::ExperimentalDescriptorStoreOp>(op);
+      builder.create<triton::StoreOp>(loc, ptr, storeOp.getSrc(), boundaryCheck,
+                                      triton::CacheModifier::NONE,
+                                      triton::EvictionPolicy::NORMAL);
+    }
+    op->erase();
+    return success();
+  }
+
+  llvm::DenseMap<Value, Descriptor> descriptors;
+};
+
+} // namespace
@@ -18,9 +18,13 @@
 // This pass does manage to raise tensor of pointers into block pointers for
 // simple cases (e.g. 03 matmul tutorial). However, this pass has several know
 // limitations:
-//   - Masks and modulos are not correctly handled by this pass. Issue #1784
-//   (https://github.com/intel/intel-xpu-backend-for-triton/issues/1784) has
-//   been created to address this limitation.
+//   - Masks are only handled when they are a conjunction of comparisons of the
+//   form `start + tl.arange(...) < bound` along the dimensions of the access,
+//   which are turned into boundary checks. Issue #1784
+//   (https://github.com/intel/intel-xpu-backend-for-triton/issues/1784) tracks
+//   the support of the other masks.
+//   - Modulos are turned into boundary checks, i.e. the elements past the
+//   modulo are padded instead of wrapping around.
 //   - The pattern matching method used in this pass makes it prone to fail
 //   raising memory accesses. For the moment, the most fragile part of the pass
 //   is probably the support for fixing the axis of the offsets
@@ -257,8 +261,16 @@ struct PtrState {
       }
       newStrides.push_back(getValueOrCreateCastToIndexLike(
           builder, loc, builder.getI64Type(), stride));
-      newShape.push_back(getValueOrCreateCastToIndexLike(
-          builder, loc, builder.getI64Type(), dim));
+
+      // The modulo of a non-block pointer dimension is scaled by its stride,
+      // like the offset.
+      Value newDim = getValueOrCreateCastToIndexLike(
+          builder, loc, builder.getI64Type(), dim);
+      if (!isBlockPtr() && !mlir::triton::gpu::intel::isConstant(stride, 0) &&
+          !mlir::triton::gpu::intel::isConstant(dim, 0))
+        newDim = builder.create<arith::DivUIOp>(loc, newDim,
+                                                newStrides.back());
+      newShape.push_back(newDim);
     }
 
     auto op = builder.create<triton::MakeTensorPtrOp>(
@@ -268,6 +280,26 @@ struct PtrState {
   }
 };
 
+// Data structure used to decode the integer operands of the comparisons of a
+// mask. Start is the value of the first element (index typed). Dim is the
+// dimension along which the values increase by one, or -1 if all the elements
+// are equal to start.
+struct RangeState {
+  Value start;
+  int32_t dim = -1;
+};
+
+// Data structure used to decode masks of the form
+// `(start_0 + arange_0 < end_0) & ... & (start_n + arange_n < end_n)`. Starts
+// and ends are index typed; a null end indicates that the mask does not
+// depend on the dimension.
+struct MaskState {
+  SmallVector<Value> starts;
+  SmallVector<Value> ends;
+
+  bool isEmpty() const { return starts.empty(); }
+};
+
 #ifndef NDEBUG
 template <typename T>
 static llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
@@ -982,6 +1014,192 @@ struct TritonRaiseBlockPointer
   LogicalResult visitAddPointerRemOperand(OpTy remOp, PtrState &state,
                                           Location loc, OpBuilder &builder);
 
+  LogicalResult visitMaskRange(Value operand, RangeState &state,
+                               const Location loc, OpBuilder &builder) {
+    if (isa<IntegerType, IndexType>(operand.getType())) {
+      state.start = getValueOrCreateCastToIndexLike(
+          builder, loc, builder.getIndexType(), operand);
+      return success();
+    }
+
+    Operation *definingOp = operand.getDefiningOp();
+    if (!definingOp)
+      return failure();
+
+    return TypeSwitch<Operation *, LogicalResult>(definingOp)
+        .Case([&](triton::MakeRangeOp rangeOp) {
+          state.start =
+              builder.create<arith::ConstantIndexOp>(loc, rangeOp.getStart());
+          state.dim = 0;
+          return success();
+        })
+        .Case([&](arith::ConstantOp constOp) {
+          auto attr = dyn_cast<SplatElementsAttr>(constOp.getValue());
+          if (!attr || !isa<IntegerType>(attr.getElementType()))
+            return failure();
+          state.start = builder.create<arith::ConstantIndexOp>(
+              loc, attr.getSplatValue<APInt>().getSExtValue());
+          return success();
+        })
+        .Case([&](arith::AddIOp addOp) {
+          RangeState lhsState, rhsState;
+          if (failed(visitMaskRange(addOp.getLhs(), lhsState, loc, builder)) ||
+              failed(visitMaskRange(addOp.getRhs(), rhsState, loc, builder)) ||
+              (lhsState.dim >= 0 && rhsState.dim >= 0))
+            return failure();
+          state.start = builder.create<arith::AddIOp>(loc, lhsState.start,
+                                                      rhsState.start);
+          state.dim = std::max(lhsState.dim, rhsState.dim);
+          return success();
+        })
+        .Case([&](triton::SplatOp splatOp) {
+          return visitMaskRange(splatOp.getSrc(), state, loc, builder);
+        })
+        .Case([&](triton::ExpandDimsOp expandDimsOp) {
+          if (failed(visitMaskRange(expandDimsOp.getSrc(), state, loc,
+                                    builder)))
+            return failure();
+          if (state.dim >= static_cast<int32_t>(expandDimsOp.getAxis()))
+            ++state.dim;
+          return success();
+        })
+        .Case([&](triton::BroadcastOp broadcastOp) {
+          auto srcType = cast<ShapedType>(broadcastOp.getSrc().getType());
+          auto dstType = cast<ShapedType>(broadcastOp.getType());
+          if (srcType.getRank() != dstType.getRank())
+            return failure();
+          return visitMaskRange(broadcastOp.getSrc(), state, loc, builder);
+        })
+        .Default([](Operation *) { return failure(); });
+  }
+
+  LogicalResult visitMask(Value mask, MaskState &state, const Location loc,
+                          OpBuilder &builder) {
+    assert(state.isEmpty() && "state is a return argument");
+
+    auto maskType = dyn_cast<RankedTensorType>(mask.getType());
+    Operation *definingOp = mask.getDefiningOp();
+    if (!maskType || !definingOp)
+      return failure();
+
+    int64_t rank = maskType.getRank();
+    state.starts.resize(rank);
+    state.ends.resize(rank);
+
+    return TypeSwitch<Operation *, LogicalResult>(definingOp)
+        .Case([&](arith::ConstantOp constOp) {
+          // An all-true mask does not depend on any dimension.
+          return success(matchPattern(constOp, m_One()));
+        })
+        .Case([&](arith::CmpIOp cmpOp) {
+          Value lhs = cmpOp.getLhs();
+          Value rhs = cmpOp.getRhs();
+          switch (cmpOp.getPredicate()) {
+          case arith::CmpIPredicate::slt:
+          case arith::CmpIPredicate::ult:
+            break;
+          case arith::CmpIPredicate::sgt:
+          case arith::CmpIPredicate::ugt:
+            std::swap(lhs, rhs);
+            break;
+          default:
+            return failure();
+          }
+
+          RangeState lhsState, rhsState;
+          if (failed(visitMaskRange(lhs, lhsState, loc, builder)) ||
+              failed(visitMaskRange(rhs, rhsState, loc, builder)) ||
+              lhsState.dim < 0 || rhsState.dim >= 0)
+            return failure();
+          state.starts[lhsState.dim] = lhsState.start;
+          state.ends[lhsState.dim] = rhsState.start;
+          return success();
+        })
+        .Case([&](arith::AndIOp andOp) {
+          MaskState lhsState, rhsState;
+          if (failed(visitMask(andOp.getLhs(), lhsState, loc, builder)) ||
+              failed(visitMask(andOp.getRhs(), rhsState, loc, builder)))
+            return failure();
+          for (int64_t i = 0; i < rank; ++i) {
+            if (lhsState.ends[i] && rhsState.ends[i])
+              return failure();
+            const MaskState &src = lhsState.ends[i] ? lhsState : rhsState;
+            state.starts[i] = src.starts[i];
+            state.ends[i] = src.ends[i];
+          }
+          return success();
+        })
+        .Case([&](triton::ExpandDimsOp expandDimsOp) {
+          MaskState srcState;
+          if (failed(visitMask(expandDimsOp.getSrc(), srcState, loc, builder)))
+            return failure();
+          unsigned axis = expandDimsOp.getAxis();
+          srcState.starts.insert(srcState.starts.begin() + axis, Value());
+          srcState.ends.insert(srcState.ends.begin() + axis, Value());
+          state = std::move(srcState);
+          return success();
+        })
+        .Case([&](triton::BroadcastOp broadcastOp) {
+          auto srcType = cast<RankedTensorType>(broadcastOp.getSrc().getType());
+          MaskState srcState;
+          if (srcType.getRank() != rank ||
+              failed(visitMask(broadcastOp.getSrc(), srcState, loc, builder)))
+            return failure();
+          // A mask depending on a broadcast dimension is not a boundary.
+          for (int64_t i = 0; i < rank; ++i)
+            if (srcState.ends[i] &&
+                srcType.getDimSize(i) != maskType.getDimSize(i))
+              return failure();
+          state = std::move(srcState);
+          return success();
+        })
+        .Default([](Operation *) { return failure(); });
+  }
+
+  // Returns a block pointer equivalent to \p ptr, defined by a
+  // tt.make_tensor_ptr operation, whose shape makes the elements masked off
+  // by \p mask out of bounds, and appends the dimensions to check to
+  // \p boundary. Returns a null value if the mask is not supported.
+  Value applyMask(Value ptr, Value mask, SmallVectorImpl<int> &boundary,
+                  const Location loc, OpBuilder &builder) {
+    auto makeTPtrOp = ptr.getDefiningOp<triton::MakeTensorPtrOp>();
+    MaskState state;
+    if (!makeTPtrOp || failed(visitMask(mask, state, loc, builder)))
+      return nullptr;
+
+    SmallVector<Value> newShape = llvm::to_vector(makeTPtrOp.getShape());
+    for (int axis = 0; axis < newShape.size(); ++axis) {
+      if (!state.ends[axis])
+        continue;
+      // The dimensions with a modulo are already checked against it.
+      if (!mlir::triton::gpu::intel::isConstant(newShape[axis], 0))
+        return nullptr;
+
+      // offset + i < offset + (end - start) <=> start + i < end
+      Value offset = getValueOrCreateCastToIndexLike(
+          builder, loc, builder.getIndexType(),
+          makeTPtrOp.getOffsets()[axis]);
+      Value bound = builder.create<arith::SubIOp>(loc, state.ends[axis],
+                                                  state.starts[axis]);
+      newShape[axis] = getValueOrCreateCastToIndexLike(
+          builder, loc, builder.getI64Type(),
+          builder.create<arith::AddIOp>(loc, offset, bound));
+      boundary.push_back(axis);
+    }
+    llvm::sort(boundary);
+
+    auto ptrType = cast<triton::PointerType>(ptr.getType());
+    ArrayRef<int64_t> sizes =
+        cast<ShapedType>(ptrType.getPointeeType()).getShape();
+    auto newPtr = builder.create<triton::MakeTensorPtrOp>(
+        loc, makeTPtrOp.getBase(), newShape, makeTPtrOp.getStrides(),
+        makeTPtrOp.getOffsets(), SmallVector<int32_t>(sizes),
+        makeTPtrOp.getOrder());
+    LLVM_DEBUG(llvm::dbgs() << "creating masked tt.make_tensor_ptr:\n"
+                            << newPtr << "\n";);
+    return newPtr.getResult();
+  }
+
   template <typename OpTy,
             std::enable_if_t<
                 llvm::is_one_of<OpTy, triton::LoadOp, triton::StoreOp>::value,
@@ -1007,14 +1225,6 @@ struct TritonRaiseBlockPointer
       return failure();
     }
 
-    // As masks are incompatible with block pointer load/store ops
-    // Masks must be handled before the operation can be rewritten.
-    // This will be done in a future PR (Issue #1784).
-    // In the meantime, operations with a mask are not rewrtitten.
-    if (op.getMask()) {
-      return success();
-    }
-
     SmallVector<int> boundary;
     if (auto iter = knownPtrs.find(ptr); iter != knownPtrs.end()) {
       auto state = iter->second;
@@ -1023,12 +1233,33 @@ struct TritonRaiseBlockPointer
           boundary.push_back(axis);
       }
     }
-    ArrayRef<int> newBoundaryCheck(boundary);
 
     OpBuilder builder(op);
+
+    // As masks are incompatible with block pointer load/store ops, the
+    // supported masks are turned into boundary checks. Operations with
+    // another mask are not rewritten (Issue #1784).
+    std::optional<triton::PaddingOption> padding;
+    if constexpr (isLoad)
+      padding = op.getPadding();
+    if (Value mask = op.getMask()) {
+      if constexpr (isLoad) {
+        // Block loads pad the out of bounds elements with zeros.
+        Value other = op.getOther();
+        if (other && !matchPattern(other, m_Zero()) &&
+            !matchPattern(other, m_AnyZeroFloat()))
+          return success();
+        padding = triton::PaddingOption::PAD_ZERO;
+      }
+      ptr = applyMask(ptr, mask, boundary, op.getLoc(), builder);
+      if (!ptr)
+        return success();
+    }
+    ArrayRef<int> newBoundaryCheck(boundary);
+
     if constexpr (isLoad) {
       auto loadOp = builder.create<triton::LoadOp>(
-          op.getLoc(), ptr, newBoundaryCheck, op.getPadding(), op.getCache(),
+          op.getLoc(), ptr, newBoundaryCheck, padding, op.getCache(),
           op.getEvict(), op.getIsVolatile());
 
       LLVM_DEBUG(llvm::dbgs() << "creating tt.load: " << loadOp << "\n";);
@@ -1036,7 +1267,7 @@ struct TritonRaiseBlockPointer
       op.replaceAllUsesWith(loadOp.getResult());
     } else {
       [[maybe_unused]] auto storeOp = builder.create<triton::StoreOp>(
-          op.getLoc(), ptr, op.getValue(), op.getBoundaryCheck(), op.getCache(),
+          op.getLoc(), ptr, op.getValue(), newBoundaryCheck, op.getCache(),
           op.getEvict());
 
       LLVM_DEBUG(llvm::dbgs() << "creating tt.store: " << storeOp << "\n";);
@@ -731,9 +731,10 @@ public:
         Value res = loop.getResult(use.getOperandNumber());
         chainedVals.insert(res);
         expandUseChain(res, chainedVals);
-        // expanddims, splat, store
-      } else if (isa<tt::ExpandDimsOp, tt::SplatOp, tt::StoreOp, scf::ForOp>(
-                     op)) {
+        // expanddims, splat, store, reduce (the layout of a reduction result
+        // is derived from the one of its source)
+      } else if (isa<tt::ExpandDimsOp, tt::SplatOp, tt::StoreOp, tt::ReduceOp,
+                     scf::ForOp>(op)) {
         continue;
         // other ops
       } else {
@@ -1,25 +1,33 @@
 #include "mlir/Pass/PassManager.h"
 #include "passes.h"
 
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 
+#include "intel/include/Analysis/LayoutConversions.h"
+#include "intel/include/Analysis/RegisterPressure.h"
 #include "intel/include/Dialect/TritonGEN/IR/TritonGENDialect.h"
 #include "intel/include/Dialect/TritonIntelGPU/IR/Dialect.h"
 #include "intel/include/Dialect/TritonIntelGPU/Transforms/Passes.h"
 #include "intel/include/Dialect/TritonIntelGPU/Transforms/Utility.h"
+#include "intel/include/Target/LLVMIR/DeadArgs.h"
 #include "intel/include/Target/LLVMIR/Dialect/TritonGEN/TritonGENToLLVMIRTranslation.h"
 #include "intel/include/Target/LLVMIR/PostProcess.h"
+#include "intel/include/Target/LLVMIR/SLPVectorizer.h"
 #include "intel/include/TritonAnnotateModule/Passes.h"
 #include "intel/include/TritonIntelGPUToLLVM/Passes.h"
+#include "intel/include/TritonRaiseBlockPointer/Passes.h"
 #include "intel/include/TritonToTritonGPUWarp/Passes.h"
 
 #include "triton/Target/SPIRV/SPIRVTranslation.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
 
+#include <optional>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
@@ -44,11 +52,31 @@ using ret = py::return_value_policy;
   m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1) {                  \
     pm.addPass(builder({val0, val1}));                                         \
   })
+#define ADD_PASS_WRAPPER_OPT_3(name, builder, ty0, ty1, ty2)                   \
+  m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2) {        \
+    pm.addPass(builder({val0, val1, val2}));                                   \
+  })
+#define ADD_PASS_WRAPPER_OPT_4(name, builder, ty0, ty1, ty2, ty3)              \
+  m.def(name,                                                                  \
+        [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2, ty3 val3) {    \
+          pm.addPass(builder({val0, val1, val2, val3}));                       \
+        })
 #define ADD_PASS_WRAPPER_OPT_5(name, builder, ty0, ty1, ty2, ty3, ty4)         \
   m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2,          \
                  ty3 val3, ty4 val4) {                                         \
     pm.addPass(builder({val0, val1, val2, val3, val4}));                       \
   })
+#define ADD_PASS_WRAPPER_OPT_6(name, builder, ty0, ty1, ty2, ty3, ty4, ty5)    \
+  m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2,          \
+                 ty3 val3, ty4 val4, ty5 val5) {                               \
+    pm.addPass(builder({val0, val1, val2, val3, val4, val5}));                 \
+  })
+#define ADD_PASS_WRAPPER_OPT_8(name, builder, ty0, ty1, ty2, ty3, ty4, ty5,    \
+                               ty6, ty7)                                       \
+  m.def(name, [](mlir::PassManager &pm, ty0 val0, ty1 val1, ty2 val2,          \
+                 ty3 val3, ty4 val4, ty5 val5, ty6 val6, ty7 val7) {           \
+    pm.addPass(builder({val0, val1, val2, val3, val4, val5, val6, val7}));     \
+  })
 
 static uint32_t findKernels(llvm::Module &M,
                             std::set<llvm::Function *> &functions) {
@@ -62,42 +90,90 @@ static uint32_t findKernels(llvm::Module &M,
   return numKernels;
 }
 
+// Translates the single kernel of \p module to SPIR-V, returning the SPIR-V
+// binary and the name of the kernel.
+static std::tuple<std::string, std::string>
+translateKernelToSPIRV(llvm::Module &module, bool useBackend) {
+  std::set<llvm::Function *> kernels;
+  const uint32_t numKernels = findKernels(module, kernels);
+  assert(numKernels == 1 && "Expecting a single SPIR kernel");
+  std::string name = (*kernels.begin())->getName().str();
+  return {triton::translateLLVMIRToSPIRV(module, useBackend), name};
+}
+
 void init_triton_intel_passes_ttir(py::module &&m) {
   ADD_PASS_WRAPPER_OPT_1("add_convert_to_ttgpuir_warp",
                          intel::createConvertTritonToTritonGPUWarp, unsigned);
+  ADD_PASS_WRAPPER_0("add_tensor_descriptor_to_block_pointer",
+                     intel::createTritonTensorDescriptorToBlockPointer);
 }
 
 void init_triton_intel_passes_ttgpuir(py::module &&m) {
   ADD_PASS_WRAPPER_0("add_to_llvmir",
                      gpu::intel::createConvertTritonIntelGPUToLLVM);
-  ADD_PASS_WRAPPER_0("add_accelerate_matmul",
-                     gpu::intel::createTritonIntelGPUAccelerateMatmul);
+  ADD_PASS_WRAPPER_OPT_2("add_accelerate_matmul",
+                         gpu::intel::createTritonIntelGPUAccelerateMatmul,
+                         unsigned, unsigned);
   ADD_PASS_WRAPPER_0("add_decompose_unsupported_conversions",
                      gpu::intel::createIntelDecomposeUnsupportedConversions);
-  ADD_PASS_WRAPPER_0("add_allocate_shared_memory",
-                     gpu::intel::createIntelAllocateSharedMemory);
-  ADD_PASS_WRAPPER_OPT_2("add_pipeline",
-                         gpu::intel::createTritonIntelGPUPipeline, int, bool);
-  ADD_PASS_WRAPPER_0("add_remove_layout_conversions",
-                     gpu::intel::createTritonIntelGPURemoveLayoutConversions);
+  ADD_PASS_WRAPPER_OPT_3("add_allocate_shared_memory",
+                         gpu::intel::createIntelAllocateSharedMemory, unsigned,
+                         unsigned, unsigned);
+  ADD_PASS_WRAPPER_OPT_4("add_pipeline",
+                         gpu::intel::createTritonIntelGPUPipeline, int, bool,
+                         bool, unsigned);
+  ADD_PASS_WRAPPER_OPT_1(
+      "add_remove_layout_conversions",
+      gpu::intel::createTritonIntelGPURemoveLayoutConversions, unsigned);
   ADD_PASS_WRAPPER_0("add_rewrite_tensor_pointer",
                      gpu::intel::createTritonIntelGPURewriteTensorPointer);
-  ADD_PASS_WRAPPER_OPT_2("add_prefetch_block",
+  ADD_PASS_WRAPPER_OPT_4("add_prefetch_block",
                          gpu::intel::createTritonIntelGPUPrefetchBlock, int,
-                         bool);
+                         bool, bool, unsigned);
   ADD_PASS_WRAPPER_0("add_distribute_to_warps",
                      gpu::intel::createTritonIntelGPUDistributeToWarps);
   ADD_PASS_WRAPPER_0("add_match_target_size",
                      gpu::intel::createTritonIntelGPUMatchTargetSize);
+  ADD_PASS_WRAPPER_0("add_coalesce_block_loads",
+                     gpu::intel::createTritonIntelGPUCoalesceBlockLoads);
+  ADD_PASS_WRAPPER_0("add_warp_specialize",
+                     gpu::intel::createTritonIntelGPUWarpSpecialize);
   ADD_PASS_WRAPPER_0("add_schedule_load",
                      gpu::intel::createTritonIntelGPUScheduleLoad);
-  ADD_PASS_WRAPPER_OPT_5("add_triton_annotate_module",
+  ADD_PASS_WRAPPER_OPT_3("add_schedule_loop",
+                         gpu::intel::createTritonIntelGPUScheduleLoop, unsigned,
+                         unsigned, unsigned);
+  ADD_PASS_WRAPPER_OPT_3("add_unroll_dot_loop",
+                         gpu::intel::createTritonIntelGPUUnrollDotLoop,
+                         unsigned, unsigned, unsigned);
+  ADD_PASS_WRAPPER_OPT_8("add_triton_annotate_module",
                          gpu::intel::createTritonAnnotateModule, unsigned, bool,
-                         bool, bool, unsigned);
+                         bool, bool, bool, unsigned, unsigned, bool);
   ADD_PASS_WRAPPER_0("add_reduce_data_duplication",
                      gpu::intel::createTritonIntelGPUReduceDataDuplication);
+  ADD_PASS_WRAPPER_OPT_2("add_rematerialize",
+                         gpu::intel::createTritonIntelGPURematerialize,
+                         unsigned, unsigned);
   ADD_PASS_WRAPPER_0("add_materialize_block_pointer",
                      gpu::intel::createTritonIntelGPUMaterializeBlockPointer);
+  ADD_PASS_WRAPPER_0("add_remove_redundant_masks",
+                     gpu::intel::createTritonIntelGPURemoveRedundantMasks);
+  ADD_PASS_WRAPPER_0("add_optimize_epilogue",
+                     gpu::intel::createTritonIntelGPUOptimizeEpilogue);
+  ADD_PASS_WRAPPER_0("add_peel_masked_tail",
+                     gpu::intel::createTritonIntelGPUPeelMaskedTail);
+  ADD_PASS_WRAPPER_0("add_decompose_f32_dot",
+                     gpu::intel::createTritonIntelGPUDecomposeF32Dot);
+  ADD_PASS_WRAPPER_0("add_optimize_accumulator_init",
+                     gpu::intel::createTritonIntelGPUOptimizeAccumulatorInit);
+  ADD_PASS_WRAPPER_0("add_coalesce", gpu::intel::createTritonIntelGPUCoalesce);
+  ADD_PASS_WRAPPER_0("add_optimize_reduction_locality",
+                     gpu::intel::createTritonIntelGPUOptimizeReductionLocality);
+  ADD_PASS_WRAPPER_OPT_3("add_swizzle_program_ids",
+                         gpu::intel::createTritonIntelGPUSwizzleProgramIds,
+                         unsigned, unsigned, unsigned);
+  ADD_PASS_WRAPPER_0("add_canonicalize_pointers",
+                     gpu::intel::createTritonIntelGPUCanonicalizePointers);
 }
 
 void init_triton_intel(py::module &&m) {
@@ -118,10 +194,14 @@ void init_triton_intel(py::module &&m) {
         return oss.str();
       });
 
+  // Runs the LLVM pipeline for `opt`: O3 for the full pipeline, or O1 for the
+  // fast-compile pipeline, which also skips the loop optimizations. Returns
+  // the `-time-passes` report if `LLVM_ENABLE_TIMING` is set.
   m.def("optimize_module", [](llvm::Module *mod,
                               const llvm::OptimizationLevel &opt) {
+    std::string timingReport;
     if (mlir::triton::tools::getBoolEnv("DISABLE_LLVM_OPT"))
-      return;
+      return timingReport;
     // Check to see if we are passing a list of flags to disable optimizations.
     auto flagList = mlir::triton::tools::getStrEnv("DISABLE_LLVM_OPT");
     using namespace llvm;
@@ -156,11 +236,19 @@ void init_triton_intel(py::module &&m) {
       standardInstr.registerCallbacks(passInstrCb, &mam);
       instrCbPtr = &passInstrCb;
     }
+    const bool enabledTiming =
+        mlir::triton::tools::getBoolEnv("LLVM_ENABLE_TIMING");
+    TimePassesHandler timePasses(enabledTiming);
+    if (enabledTiming) {
+      timePasses.registerCallbacks(passInstrCb);
+      instrCbPtr = &passInstrCb;
+    }
 
+    const bool fullPipeline = opt.getSpeedupLevel() > 1;
     PipelineTuningOptions tuningOptions;
-    tuningOptions.LoopUnrolling = true;
-    tuningOptions.LoopInterleaving = true;
-    tuningOptions.LoopVectorization = true;
+    tuningOptions.LoopUnrolling = fullPipeline;
+    tuningOptions.LoopInterleaving = fullPipeline;
+    tuningOptions.LoopVectorization = fullPipeline;
     // SLPVectorizer causes test_core.py::test_dot_mulbroadcasted to fail.
     // It vectorizes @llvm.fmuladd.f32 with @llvm.fmuladd.v32f32. We can
     // consider to reenable SLP vectorization when the failure is
@@ -202,7 +290,17 @@ void init_triton_intel(py::module &&m) {
           fpm.addPass(InstCombinePass());
         });
     mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
-    mpm.run(*mod, mam);
+    {
+      py::gil_scoped_release allow_threads;
+      mpm.run(*mod, mam);
+    }
+    if (enabledTiming) {
+      llvm::raw_string_ostream os(timingReport);
+      timePasses.setOutStream(os);
+      timePasses.print();
+      os.flush();
+    }
+    return timingReport;
   });
 
   // load dialects
@@ -215,6 +313,81 @@ void init_triton_intel(py::module &&m) {
     context.loadAllAvailableDialects();
   });
 
+  m.def("get_max_live_bytes_per_thread", [](mlir::ModuleOp &mod) {
+    return gpu::intel::estimateMaxLiveBytesPerThread(mod);
+  });
+
+  // List the layout conversions left in the module with their cost.
+  m.def("get_layout_conversions", [](mlir::ModuleOp &mod) {
+    py::list conversions;
+    mod.walk([&](gpu::ConvertLayoutOp op) {
+      gpu::intel::LayoutConversionCost cost =
+          gpu::intel::getLayoutConversionCost(op);
+      std::string loc, srcLayout, dstLayout;
+      llvm::raw_string_ostream locOS(loc), srcOS(srcLayout), dstOS(dstLayout);
+      if (auto fileLoc = op.getLoc()->findInstanceOf<mlir::FileLineColLoc>())
+        locOS << fileLoc.getFilename().getValue() << ":" << fileLoc.getLine()
+              << ":" << fileLoc.getColumn();
+      else
+        op.getLoc().print(locOS);
+      op.getSrc().getType().getEncoding().print(srcOS);
+      op.getType().getEncoding().print(dstOS);
+
+      py::dict conversion;
+      conversion["loc"] = loc;
+      conversion["shape"] = std::vector<int64_t>(op.getType().getShape());
+      conversion["src_layout"] = srcLayout;
+      conversion["dst_layout"] = dstLayout;
+      conversion["register_local"] = cost.registerLocal;
+      conversion["warp_local"] = cost.warpLocal;
+      conversion["slm_bytes"] = cost.slmBytes;
+      conversion["slm_traffic_bytes"] = cost.slmTrafficBytes;
+      conversion["barriers"] = cost.barriers;
+      conversions.append(conversion);
+    });
+    return conversions;
+  });
+
+  // Assign an id to each `tt.print` operation of the module, and list the
+  // formats the host decodes the records of the print buffer with.
+  m.def("assign_print_ids", [](mlir::ModuleOp &mod) {
+    mlir::Builder builder(mod.getContext());
+    py::list formats;
+    mod.walk([&](PrintOp op) {
+      op->setAttr(gpu::intel::printIdAttrName,
+                  builder.getI32IntegerAttr(formats.size()));
+      py::list operands;
+      for (auto [value, isSigned] :
+           llvm::zip_equal(op.getArgs(), op.getIsSigned())) {
+        mlir::Type type = value.getType();
+        mlir::Type elemTy = mlir::getElementTypeOrSelf(type);
+        py::dict operand;
+        if (auto tensorTy = dyn_cast<mlir::RankedTensorType>(type))
+          operand["shape"] = std::vector<int64_t>(tensorTy.getShape());
+        else
+          operand["shape"] = std::vector<int64_t>();
+        if (isa<PointerType>(elemTy)) {
+          operand["kind"] = "p";
+          operand["bits"] = 64;
+        } else {
+          operand["kind"] = isa<mlir::FloatType>(elemTy) ? "f"
+                            : isSigned                  ? "i"
+                                                        : "u";
+          operand["bits"] = elemTy.getIntOrFloatBitWidth();
+        }
+        operand["num_words"] = gpu::intel::getPrintRecordNumWords(type);
+        operands.append(operand);
+      }
+      py::dict format;
+      format["prefix"] = op.getPrefix().str();
+      format["hex"] = op.getHex();
+      format["operands"] = operands;
+      format["num_words"] = gpu::intel::getPrintRecordNumWords(mlir::Type());
+      formats.append(format);
+    });
+    return formats;
+  });
+
   m.def("set_spv_target_triple", [](llvm::Module *mod) {
     std::string triple = "spir64-unknown-unknown";
     std::string layout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:"
@@ -223,12 +396,58 @@ void init_triton_intel(py::module &&m) {
     mod->setDataLayout(layout);
   });
 
-  m.def("post_process_llir",
-        [](llvm::Module *mod) { intel::postProcessLLVMIR(*mod); });
+  // Returns the timing report of the post-processing steps if
+  // `LLVM_ENABLE_TIMING` is set, and the vectorization achieved by the SLP
+  // vectorizer.
+  m.def(
+      "post_process_llir",
+      [](llvm::Module *mod, bool fast) {
+        std::string timingReport;
+        llvm::raw_string_ostream os(timingReport);
+        intel::SLPVectorizerStats slpStats;
+        intel::postProcessLLVMIR(
+            *mod, fast,
+            mlir::triton::tools::getBoolEnv("LLVM_ENABLE_TIMING") ? &os
+                                                                  : nullptr,
+            &slpStats);
+        os.flush();
+        py::dict vectorization;
+        vectorization["trees"] = slpStats.numTrees;
+        vectorization["scalars"] = slpStats.numScalars;
+        return py::make_tuple(timingReport, vectorization);
+      },
+      py::arg("mod"), py::arg("fast") = false);
+
+  // Returns the positions of the kernel parameters removed because the
+  // kernel never uses them.
+  m.def("remove_dead_kernel_args", [](llvm::Module *mod,
+                                      unsigned numHiddenArgs) {
+    llvm::SmallVector<unsigned> deadArgs =
+        intel::removeDeadKernelArgs(*mod, numHiddenArgs);
+    return std::vector<unsigned>(deadArgs.begin(), deadArgs.end());
+  });
+
+  // Translate the optimized module of `make_llir` in memory, without
+  // printing and reparsing it. With `use_backend`, LLVM's SPIR-V backend is
+  // used instead of the SPIRV-LLVM-Translator when it supports the module.
+  m.def(
+      "translate_to_spirv",
+      [](llvm::Module *module,
+         bool useBackend) -> std::tuple<py::object, std::string> {
+        std::string name, spirvBitcode;
+        {
+          py::gil_scoped_release allow_threads;
+          std::tie(spirvBitcode, name) =
+              translateKernelToSPIRV(*module, useBackend);
+        }
+        return std::make_tuple(py::bytes(spirvBitcode), name);
+      },
+      py::arg("module"), py::arg("use_backend") = false, ret::take_ownership);
 
   m.def(
       "translate_to_spirv",
-      [](const std::string &llvmIR) -> std::tuple<py::object, std::string> {
+      [](const std::string &llvmIR,
+         bool useBackend) -> std::tuple<py::object, std::string> {
         std::string name;
         std::string spirvBitcode;
         {
@@ -245,14 +464,69 @@ void init_triton_intel(py::module &&m) {
                 "failed to parse IR: " + error.getMessage() +
                 "lineno: " + std::to_string(error.getLineNo()));
           }
-          // Get name of kernel in the module
-          std::set<llvm::Function *> kernels;
-          const uint32_t numKernels = findKernels(*module, kernels);
-          assert(numKernels == 1 && "Expecting a single SPIR kernel");
-          name = (*kernels.begin())->getName().str();
-          spirvBitcode = triton::translateLLVMIRToSPIRV(*module);
+          std::tie(spirvBitcode, name) =
+              translateKernelToSPIRV(*module, useBackend);
         }
         return std::make_tuple(py::bytes(spirvBitcode), name);
       },
+      py::arg("llvm_ir"), py::arg("use_backend") = false, ret::take_ownership);
+
+  // Link several single kernel LLVM IR modules into one SPIR-V module, so
+  // that the driver builds them with a single module creation. Each kernel is
+  // renamed to the corresponding name in `names`, as e.g. the autotuning
+  // variants of a function all share the same kernel name.
+  m.def(
+      "link_to_spirv",
+      [](const std::vector<std::string> &llvmIRs,
+         const std::vector<std::string> &names,
+         bool useBackend) -> py::object {
+        assert(llvmIRs.size() == names.size() &&
+               "Expecting a name for each kernel");
+        std::string spirvBitcode;
+        {
+          py::gil_scoped_release allow_threads;
+          llvm::LLVMContext context;
+          std::unique_ptr<llvm::Module> linked;
+          std::optional<llvm::Linker> linker;
+          for (auto [llvmIR, name] : llvm::zip(llvmIRs, names)) {
+            std::unique_ptr<llvm::MemoryBuffer> buffer =
+                llvm::MemoryBuffer::getMemBuffer(llvmIR.c_str());
+            llvm::SMDiagnostic error;
+            std::unique_ptr<llvm::Module> module =
+                llvm::parseIR(buffer->getMemBufferRef(), error, context);
+            if (!module) {
+              llvm::report_fatal_error(
+                  "failed to parse IR: " + error.getMessage() +
+                  "lineno: " + std::to_string(error.getLineNo()));
+            }
+            std::set<llvm::Function *> kernels;
+            [[maybe_unused]] const uint32_t numKernels =
+                findKernels(*module, kernels);
+            assert(numKernels == 1 && "Expecting a single SPIR kernel");
+            (*kernels.begin())->setName(name);
+            // Only the kernel is visible outside of its module: the device
+            // functions and globals of different kernels may share names.
+            for (llvm::GlobalValue &gv : module->global_values()) {
+              auto *function = dyn_cast<llvm::Function>(&gv);
+              if (gv.isDeclaration() || gv.getName().starts_with("llvm.") ||
+                  (function && kernels.count(function)))
+                continue;
+              gv.setLinkage(llvm::GlobalValue::InternalLinkage);
+            }
+            if (!linked) {
+              linked = std::move(module);
+              linker.emplace(*linked);
+              continue;
+            }
+            if (linker->linkInModule(std::move(module)))
+              llvm::report_fatal_error("failed to link kernel " + name);
+          }
+          if (!linked)
+            llvm::report_fatal_error("Expecting at least one kernel");
+          spirvBitcode = triton::translateLLVMIRToSPIRV(*linked, useBackend);
+        }
+        return py::bytes(spirvBitcode);
+      },
+      py::arg("llvm_irs"), py::arg("names"), py::arg("use_backend") = false,
       ret::take_ownership);
 }
@@ -94,6 +94,9 @@ class CUDAOptions:
     cluster_dims: tuple = (1, 1, 1)
     ptx_version: int = None
     enable_fp_fusion: bool = True
+    # persistent launches one program per SM, each looping over the tiles of
+    # the grid, instead of one program per tile.
+    persistent: bool = False
     supported_fp8_dtypes: Tuple[str] = ("fp8e5", "fp8e4b15")
     deprecated_fp8_dtypes: Tuple[str] = ()
     default_dot_input_precision: str = "tf32"
@@ -156,6 +159,7 @@ class CUDABackend(BaseBackend):
             metadata.cluster_dims[0],
             metadata.cluster_dims[1],
             metadata.cluster_dims[2],
+            int(metadata.persistent),
         )
 
     def get_codegen_implementation(self):
@@ -212,6 +216,8 @@ class CUDABackend(BaseBackend):
             passes.ttgpuir.add_f32_dot_tc(pm)
         # TODO(Qingyi): Move PlanCTAPass to the front of CoalescePass
         nvidia.passes.ttnvgpuir.add_plan_cta(pm, cluster_info)
+        if opt.persistent:
+            nvidia.passes.ttnvgpuir.add_persistent_kernel(pm)
         passes.ttgpuir.add_remove_layout_conversions(pm)
         passes.ttgpuir.add_optimize_thread_locality(pm)
         passes.ttgpuir.add_accelerate_matmul(pm)
@@ -235,6 +241,8 @@ class CUDABackend(BaseBackend):
         passes.common.add_canonicalizer(pm)
         pm.run(mod)
         metadata["cluster_dims"] = (cluster_info.clusterDimX, cluster_info.clusterDimY, cluster_info.clusterDimZ)
+        # The pass leaves the kernels it cannot make persistent unchanged.
+        metadata["persistent"] = mod.get_int_attr("triton_nvidia_gpu.persistent") == 1
         return mod
 
     @staticmethod
@@ -386,6 +386,136 @@ static PyObject *fill2DTMADescriptor(PyObject *self, PyObject *args) {
   return Py_None;
 }
 
+static void freeGraph(PyObject *p) {
+  CUgraph graph = (CUgraph)PyCapsule_GetPointer(p, "graph");
+  if (graph)
+    cuGraphDestroy(graph);
+}
+
+static void freeExecGraph(PyObject *p) {
+  CUgraphExec exec = (CUgraphExec)PyCapsule_GetPointer(p, "exec_graph");
+  if (exec)
+    cuGraphExecDestroy(exec);
+}
+
+static PyObject *graphBeginCapture(PyObject *self, PyObject *args) {
+  unsigned long long stream;
+  if (!PyArg_ParseTuple(args, "K", &stream)) {
+    return NULL;
+  }
+  CUDA_CHECK_AND_RETURN_NULL(cuStreamBeginCapture(
+      (CUstream)stream, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL));
+  Py_RETURN_NONE;
+}
+
+static PyObject *graphEndCapture(PyObject *self, PyObject *args) {
+  unsigned long long stream;
+  if (!PyArg_ParseTuple(args, "K", &stream)) {
+    return NULL;
+  }
+  CUgraph graph = NULL;
+  CUDA_CHECK_AND_RETURN_NULL(cuStreamEndCapture((CUstream)stream, &graph));
+  return PyCapsule_New((void *)graph, "graph", freeGraph);
+}
+
+static PyObject *graphInstantiate(PyObject *self, PyObject *args) {
+  PyObject *py_graph;
+  if (!PyArg_ParseTuple(args, "O", &py_graph)) {
+    return NULL;
+  }
+  CUgraph graph = (CUgraph)PyCapsule_GetPointer(py_graph, "graph");
+  if (!graph) {
+    return NULL;
+  }
+  CUgraphExec exec = NULL;
+  CUDA_CHECK_AND_RETURN_NULL(cuGraphInstantiateWithFlags(&exec, graph, 0));
+  return PyCapsule_New((void *)exec, "exec_graph", freeExecGraph);
+}
+
+// Returns the nodes of a graph in their order of creation, i.e. of launch for
+// a captured graph. The caller frees the returned array.
+static CUgraphNode *getGraphNodes(CUgraph graph, size_t *numNodes) {
+  *numNodes = 0;
+  if (!gpuAssert(cuGraphGetNodes(graph, NULL, numNodes), __FILE__, __LINE__))
+    return NULL;
+  CUgraphNode *nodes = malloc((*numNodes + 1) * sizeof(CUgraphNode));
+  if (!gpuAssert(cuGraphGetNodes(graph, nodes, numNodes), __FILE__,
+                 __LINE__)) {
+    free(nodes);
+    return NULL;
+  }
+  return nodes;
+}
+
+// Sets the kernel parameters of the executable graph instantiated from
+// `graph` to the ones of `new_graph`, a capture of the same launch sequence.
+// Fails without modifying the executable graph if the topologies differ.
+static PyObject *graphUpdate(PyObject *self, PyObject *args) {
+  PyObject *py_exec, *py_graph, *py_new_graph;
+  if (!PyArg_ParseTuple(args, "OOO", &py_exec, &py_graph, &py_new_graph)) {
+    return NULL;
+  }
+  CUgraphExec exec = (CUgraphExec)PyCapsule_GetPointer(py_exec, "exec_graph");
+  CUgraph graph = (CUgraph)PyCapsule_GetPointer(py_graph, "graph");
+  CUgraph newGraph = (CUgraph)PyCapsule_GetPointer(py_new_graph, "graph");
+  if (!exec || !graph || !newGraph) {
+    return NULL;
+  }
+
+  size_t numNodes, numNewNodes;
+  CUgraphNode *nodes = getGraphNodes(graph, &numNodes);
+  CUgraphNode *newNodes = nodes ? getGraphNodes(newGraph, &numNewNodes) : NULL;
+  PyObject *result = NULL;
+  if (!newNodes)
+    goto cleanup;
+
+  // Only sequences of kernel launches are updated in place.
+  bool sameTopology = numNodes == numNewNodes;
+  for (size_t i = 0; sameTopology && i < numNodes; ++i) {
+    CUgraphNodeType type, newType;
+    if (!gpuAssert(cuGraphNodeGetType(nodes[i], &type), __FILE__, __LINE__) ||
+        !gpuAssert(cuGraphNodeGetType(newNodes[i], &newType), __FILE__,
+                   __LINE__))
+      goto cleanup;
+    sameTopology = type == CU_GRAPH_NODE_TYPE_KERNEL &&
+                   newType == CU_GRAPH_NODE_TYPE_KERNEL;
+  }
+  if (!sameTopology) {
+    PyErr_SetString(PyExc_RuntimeError, "the captured launch sequence changed");
+    goto cleanup;
+  }
+
+  for (size_t i = 0; i < numNodes; ++i) {
+    CUDA_KERNEL_NODE_PARAMS params;
+    if (!gpuAssert(cuGraphKernelNodeGetParams(newNodes[i], &params), __FILE__,
+                   __LINE__) ||
+        !gpuAssert(cuGraphExecKernelNodeSetParams(exec, nodes[i], &params),
+                   __FILE__, __LINE__))
+      goto cleanup;
+  }
+  Py_INCREF(Py_None);
+  result = Py_None;
+
+cleanup:
+  free(nodes);
+  free(newNodes);
+  return result;
+}
+
+static PyObject *graphReplay(PyObject *self, PyObject *args) {
+  PyObject *py_exec;
+  unsigned long long stream;
+  if (!PyArg_ParseTuple(args, "OK", &py_exec, &stream)) {
+    return NULL;
+  }
+  CUgraphExec exec = (CUgraphExec)PyCapsule_GetPointer(py_exec, "exec_graph");
+  if (!exec) {
+    return NULL;
+  }
+  CUDA_CHECK_AND_RETURN_NULL(cuGraphLaunch(exec, (CUstream)stream));
+  Py_RETURN_NONE;
+}
+
 static PyMethodDef ModuleMethods[] = {
     {"load_binary", loadBinary, METH_VARARGS,
      "Load provided cubin into CUDA driver"},
@@ -401,6 +531,17 @@ static PyMethodDef ModuleMethods[] = {
      "that calls printf()."},
     {"fill_1d_tma_descriptor", fill1DTMADescriptor, METH_VARARGS, "doc"},
     {"fill_2d_tma_descriptor", fill2DTMADescriptor, METH_VARARGS, "doc"},
+    {"graph_begin_capture", graphBeginCapture, METH_VARARGS,
+     "Start capturing the launches on a stream into a CUDA graph"},
+    {"graph_end_capture", graphEndCapture, METH_VARARGS,
+     "Stop capturing the launches on a stream and return their graph"},
+    {"graph_instantiate", graphInstantiate, METH_VARARGS,
+     "Create an executable graph from a captured CUDA graph"},
+    {"graph_update", graphUpdate, METH_VARARGS,
+     "Update the kernel parameters of an executable graph from a capture of "
+     "the same launch sequence"},
+    {"graph_replay", graphReplay, METH_VARARGS,
+     "Launch an executable CUDA graph on a stream"},
 
     {NULL, NULL, 0, NULL} // sentinel
 };
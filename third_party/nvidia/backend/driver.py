@@ -1,3 +1,4 @@
+import contextlib
 import functools
 import os
 import hashlib
@@ -84,6 +85,11 @@ class CudaUtils(object):
         self.set_printf_fifo_size = mod.set_printf_fifo_size
         self.fill_1d_tma_descriptor = mod.fill_1d_tma_descriptor
         self.fill_2d_tma_descriptor = mod.fill_2d_tma_descriptor
+        self.graph_begin_capture = mod.graph_begin_capture
+        self.graph_end_capture = mod.graph_end_capture
+        self.graph_instantiate = mod.graph_instantiate
+        self.graph_update = mod.graph_update
+        self.graph_replay = mod.graph_replay
 
 
 # ------------------------
@@ -205,10 +211,20 @@ static cuLaunchKernelEx_t getLaunchKernelExHandle() {{
   return cuLaunchKernelExHandle;
 }}
 
-static void _launch(int gridX, int gridY, int gridZ, int num_warps, int num_ctas, int clusterDimX, int clusterDimY, int clusterDimZ, int shared_memory, CUstream stream, CUfunction function{', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
-  void *params[] = {{ {', '.join(f"&arg{i}" for i in params)} }};
+static void _launch(int gridX, int gridY, int gridZ, int num_warps, int num_ctas, int clusterDimX, int clusterDimY, int clusterDimZ, int shared_memory, int persistent, CUstream stream, CUfunction function{', ' + arg_decls if len(arg_decls) > 0 else ''}) {{
+  // persistent kernels take the grid of tiles after their arguments
+  void *params[] = {{ {''.join(f"&arg{i}, " for i in params)}&gridX, &gridY, &gridZ }};
   if (gridX*gridY*gridZ > 0) {{
-    if (num_ctas == 1) {{
+    if (persistent) {{
+      // one program per SM, striding over the tiles
+      CUdevice device;
+      int numSMs;
+      CUDA_CHECK(cuCtxGetDevice(&device));
+      CUDA_CHECK(cuDeviceGetAttribute(&numSMs, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, device));
+      long numTiles = (long)gridX * gridY * gridZ;
+      int numPrograms = numTiles < numSMs ? (int)numTiles : numSMs;
+      CUDA_CHECK(cuLaunchKernel(function, numPrograms, 1, 1, 32*num_warps, 1, 1, shared_memory, stream, params, 0));
+    }} else if (num_ctas == 1) {{
       CUDA_CHECK(cuLaunchKernel(function, gridX, gridY, gridZ, 32*num_warps, 1, 1, shared_memory, stream, params, 0));
     }} else {{
       CUlaunchAttribute launchAttr[2];
@@ -346,8 +362,8 @@ static PyObject* launch(PyObject* self, PyObject* args) {{
     return NULL;
   }}
 
-  int num_warps, num_ctas, shared_memory, clusterDimX, clusterDimY, clusterDimZ;
-  if (!PyArg_ParseTuple(kernel_metadata, \"iiiiii\", &num_warps, &num_ctas, &shared_memory, &clusterDimX, &clusterDimY, &clusterDimZ)) {{
+  int num_warps, num_ctas, shared_memory, clusterDimX, clusterDimY, clusterDimZ, persistent;
+  if (!PyArg_ParseTuple(kernel_metadata, \"iiiiiii\", &num_warps, &num_ctas, &shared_memory, &clusterDimX, &clusterDimY, &clusterDimZ, &persistent)) {{
     PyErr_SetString(PyExc_TypeError, "kernel_metadata must be a tuple");
     return NULL;
   }}
@@ -365,7 +381,7 @@ static PyObject* launch(PyObject* self, PyObject* args) {{
   {"".join([f"DevicePtrInfo ptr_info{i} = getPointer(_arg{i}, {i}); if (!ptr_info{i}.valid) return NULL;" if ty[0] == "*" else "" for i, ty in signature.items()])};
   {"".join([f"CUtensorMap* tma_ptr{i} = getTmaDesc(_arg{i}); if (!tma_ptr{i}) return NULL;" if ty == "nvTmaDesc" else "" for i, ty in signature.items()])};
   Py_BEGIN_ALLOW_THREADS;
-  _launch(gridX, gridY, gridZ, num_warps, num_ctas, clusterDimX, clusterDimY, clusterDimZ, shared_memory, (CUstream)_stream, (CUfunction)_function{', ' + ', '.join(internal_args_list) if len(internal_args_list) > 0 else ''});
+  _launch(gridX, gridY, gridZ, num_warps, num_ctas, clusterDimX, clusterDimY, clusterDimZ, shared_memory, persistent, (CUstream)_stream, (CUfunction)_function{', ' + ', '.join(internal_args_list) if len(internal_args_list) > 0 else ''});
   Py_END_ALLOW_THREADS;
   if (PyErr_Occurred()) {{
     return NULL;
@@ -426,6 +442,60 @@ class CudaLauncher(object):
         self.launch(*args, **kwargs)
 
 
+class CudaGraph(object):
+    """
+    Captures the kernels launched in its `capture()` context into a CUDA graph
+    and replays them with a single `cuGraphLaunch`.
+
+        graph = triton.runtime.driver.active.create_graph()
+        with graph.capture():
+            kernel[grid](x, y)
+        graph.replay()
+
+    Capturing the same sequence of launches again, e.g. with different scalar
+    or pointer arguments, sets the parameters of the kernel nodes of the
+    executable graph in place instead of instantiating a new one.
+    """
+
+    def __init__(self, utils):
+        self._utils = utils
+        self._graph = None
+        self._exec_graph = None
+
+    @contextlib.contextmanager
+    def capture(self):
+        import torch
+        # The legacy default stream cannot be captured, the launches are
+        # captured on a side stream ordered after the current one.
+        stream = torch.cuda.Stream()
+        stream.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(stream):
+            self._utils.graph_begin_capture(stream.cuda_stream)
+            try:
+                yield self
+            finally:
+                graph = self._utils.graph_end_capture(stream.cuda_stream)
+        torch.cuda.current_stream().wait_stream(stream)
+
+        if self._exec_graph is not None:
+            try:
+                # The executable graph keeps the nodes of the graph it was
+                # instantiated from, which are the ones to update.
+                self._utils.graph_update(self._exec_graph, self._graph, graph)
+                return
+            except RuntimeError:
+                # The launch sequence changed, the graph has to be instantiated again.
+                pass
+        self._graph = graph
+        self._exec_graph = self._utils.graph_instantiate(graph)
+
+    def replay(self):
+        import torch
+        if self._exec_graph is None:
+            raise RuntimeError("CudaGraph.replay() called before capture()")
+        self._utils.graph_replay(self._exec_graph, torch.cuda.current_stream().cuda_stream)
+
+
 class CudaDriver(GPUDriver):
 
     def __init__(self):
@@ -440,6 +510,9 @@ class CudaDriver(GPUDriver):
         warp_size = 32
         return GPUTarget("cuda", capability, warp_size)
 
+    def create_graph(self):
+        return CudaGraph(self.utils)
+
     @staticmethod
     def is_active():
         import torch
@@ -186,6 +186,11 @@ struct ConvertTritonGPUToLLVM
         id.replaceAllUsesWith(zero);
       });
     }
+
+    // Prefetch the TMA descriptors passed by value to the kernels, so that
+    // their first use does not wait for the descriptor to be fetched.
+    if (computeCapability >= 90)
+      mod.walk([](LLVM::LLVMFuncOp func) { prefetchTmaDescArgs(func); });
   }
 
 private:
@@ -208,6 +213,23 @@ private:
         static_cast<unsigned>(NVVM::NVVMMemorySpace::kSharedMemorySpace));
   }
 
+  static void prefetchTmaDescArgs(LLVM::LLVMFuncOp func) {
+    if (func.isExternal())
+      return;
+    Block &entry = func.getBody().front();
+    OpBuilder b(&entry, entry.begin());
+    for (unsigned i = 0; i < func.getNumArguments(); ++i) {
+      // The by-value descriptors are the `__grid_constant__` params.
+      if (!func.getArgAttr(i, "nvvm.grid_constant"))
+        continue;
+      triton::PTXBuilder ptxBuilder;
+      auto &prefetch = *ptxBuilder.create<>("prefetch.tensormap");
+      prefetch(ptxBuilder.newAddrOperand(func.getArgument(i), "l"));
+      ptxBuilder.launch(b, func.getLoc(),
+                        LLVM::LLVMVoidType::get(func.getContext()));
+    }
+  }
+
   static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
                               Type promotedType) {
     Type tensorPromotedType = cast<RankedTensorType>(operand.getType())
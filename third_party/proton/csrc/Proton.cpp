@@ -14,14 +14,19 @@ void initProton(pybind11::module &&m) {
   using ret = pybind11::return_value_policy;
   using namespace pybind11::literals;
 
-  m.def("start",
-        [](const std::string &path, const std::string &contextSourceName,
-           const std::string &dataName, const std::string &profilerName) {
-          auto sessionId = SessionManager::instance().addSession(
-              path, profilerName, contextSourceName, dataName);
-          SessionManager::instance().activateSession(sessionId);
-          return sessionId;
-        });
+  m.def(
+      "start",
+      [](const std::string &path, const std::string &contextSourceName,
+         const std::string &dataName, const std::string &profilerName,
+         uint64_t samplingInterval, uint64_t samplingPeriodNs) {
+        auto sessionId = SessionManager::instance().addSession(
+            path, profilerName, contextSourceName, dataName,
+            SamplingConfig{samplingInterval, samplingPeriodNs});
+        SessionManager::instance().activateSession(sessionId);
+        return sessionId;
+      },
+      "path"_a, "context_source_name"_a, "data_name"_a, "profiler_name"_a,
+      "sampling_interval"_a = 1, "sampling_period_ns"_a = 0);
 
   m.def("activate", [](size_t sessionId) {
     SessionManager::instance().activateSession(sessionId);
@@ -41,6 +46,12 @@ void initProton(pybind11::module &&m) {
     SessionManager::instance().finalizeAllSessions(outputFormatEnum);
   });
 
+  m.def("flush", [](size_t sessionId) {
+    SessionManager::instance().flushSession(sessionId);
+  });
+
+  m.def("flush_all", []() { SessionManager::instance().flushAllSessions(); });
+
   m.def("record_scope", []() { return Scope::getNewScopeId(); });
 
   m.def("enter_scope", [](size_t scopeId, const std::string &name) {
@@ -73,6 +84,19 @@ void initProton(pybind11::module &&m) {
                                                 /*aggregable=*/false);
         });
 
+  m.def(
+      "read_hatchet",
+      [](const std::string &path, size_t maxDepth, const std::string &include,
+         const std::vector<std::string> &exclude,
+         const std::string &thresholdMetric, double threshold) {
+        return readHatchet(path, HatchetReadOptions{maxDepth, include, exclude,
+                                                    thresholdMetric,
+                                                    threshold});
+      },
+      "path"_a, "max_depth"_a, "include"_a = "",
+      "exclude"_a = std::vector<std::string>{}, "threshold_metric"_a = "",
+      "threshold"_a = 0.0, pybind11::call_guard<pybind11::gil_scoped_release>());
+
   pybind11::bind_map<std::map<std::string, MetricValueType>>(m, "MetricMap");
 }
 
@@ -2,13 +2,41 @@
 #define PROTON_CONTEXT_PYTHON_H_
 
 #include "Context.h"
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
 
 namespace proton {
 
 /// Unwind the Python stack and early return a list of contexts.
+///
+/// The context of a frame is built once per (code object, line) and cached,
+/// so that unwinding a deep stack on every kernel launch only looks up the
+/// frames. At most `maxDepth` innermost frames are unwound, which defaults to
+/// `PROTON_PYTHON_MAX_DEPTH` if set, and to no limit otherwise.
 class PythonContextSource : public ContextSource {
 public:
+  PythonContextSource();
+  explicit PythonContextSource(size_t maxDepth) : maxDepth(maxDepth) {}
+  ~PythonContextSource() override;
+
   std::vector<Context> getContexts() override;
+
+private:
+  // A code object, which the cache keeps a reference to, and a line number.
+  using FrameKey = std::pair<const void *, int>;
+
+  struct FrameKeyHash {
+    size_t operator()(const FrameKey &key) const {
+      return std::hash<const void *>()(key.first) ^
+             (std::hash<int>()(key.second) << 1);
+    }
+  };
+
+  size_t maxDepth{std::numeric_limits<size_t>::max()};
+  // Only accessed with the GIL held.
+  std::unordered_map<FrameKey, Context, FrameKeyHash> frameContexts;
 };
 
 } // namespace proton
@@ -3,6 +3,7 @@
 
 #include "Context/Context.h"
 #include "Metric.h"
+#include <atomic>
 #include <map>
 #include <memory>
 #include <shared_mutex>
@@ -10,7 +11,7 @@
 
 namespace proton {
 
-enum class OutputFormat { Hatchet, Count };
+enum class OutputFormat { Hatchet, HatchetMsgPack, ChromeTrace, Count };
 
 class Data : public ThreadLocalOpInterface {
 public:
@@ -37,14 +38,28 @@ public:
   /// [MT] Thread-safe.
   void dump(OutputFormat outputFormat);
 
+  /// Append the metrics recorded since the last flush to the stream of the
+  /// data, and release them from memory.
+  /// The stream is a sequence of snapshots in the HatchetMsgPack format.
+  /// [MT] Thread-safe.
+  void flush();
+
+  /// Whether the data has been flushed to its stream.
+  bool isFlushed() const { return flushed; }
+
 protected:
   /// The actual implementation of the dump operation.
   /// [MT] Thread-safe.
   virtual void doDump(std::ostream &os, OutputFormat outputFormat) const = 0;
 
+  /// The actual implementation of the flush operation.
+  /// [MT] Thread-safe.
+  virtual void doFlush(std::ostream &os) = 0;
+
   mutable std::shared_mutex mutex;
   const std::string path{};
   ContextSource *contextSource{};
+  std::atomic<bool> flushed{false};
 };
 
 OutputFormat parseOutputFormat(const std::string &outputFormat);
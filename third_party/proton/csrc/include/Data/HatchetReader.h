@@ -0,0 +1,41 @@
+#ifndef PROTON_DATA_HATCHET_READER_H_
+#define PROTON_DATA_HATCHET_READER_H_
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace proton {
+
+/// The reduction of a hatchet profile applied while it is read.
+struct HatchetReadOptions {
+  /// The frames deeper than `maxDepth` (the root being at depth 0) are folded
+  /// into their ancestor at `maxDepth`.
+  size_t maxDepth = std::numeric_limits<size_t>::max();
+  /// Only the paths through a frame whose name matches `include` are kept,
+  /// if not empty.
+  std::string include;
+  /// The frames whose name matches any of `exclude` are dropped, with their
+  /// children.
+  std::vector<std::string> exclude;
+  /// The frames whose inclusive `thresholdMetric` (case insensitive, with or
+  /// without its unit) is below `threshold` are dropped, with their children,
+  /// if `thresholdMetric` is not empty.
+  std::string thresholdMetric;
+  double threshold = 0.0;
+};
+
+/// Reads the hatchet JSON profile at `path`, dumped by `TreeData`, and
+/// returns it reduced by `options` as a hatchet JSON string.
+///
+/// The profile is streamed: each frame is reduced once its children are
+/// read, so that reading it only takes the memory of the reduced tree and of
+/// the path of the frame being read, not of the whole profile. The numeric
+/// metrics of the folded frames are summed into their ancestor, the metrics
+/// stay exclusive.
+std::string readHatchet(const std::string &path,
+                        const HatchetReadOptions &options);
+
+} // namespace proton
+
+#endif // PROTON_DATA_HATCHET_READER_H_
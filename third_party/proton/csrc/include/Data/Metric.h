@@ -2,6 +2,7 @@
 #define PROTON_DATA_METRIC_H_
 
 #include "Utility/Traits.h"
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -115,6 +116,11 @@ public:
     Duration,
     DeviceId,
     DeviceType,
+    // The number of invocations that were timed, the duration of the others
+    // is estimated from them.
+    Samples,
+    // The host time spent by the profiler on the invocations.
+    Overhead,
     Count,
   };
 
@@ -129,6 +135,33 @@ public:
     this->values[Duration] = endTime - startTime;
     this->values[DeviceId] = deviceId;
     this->values[DeviceType] = deviceType;
+    this->values[Samples] = invocations;
+    this->values[Overhead] = static_cast<uint64_t>(0);
+  }
+
+  /// Returns the metric of invocations that were counted but not timed.
+  static std::shared_ptr<KernelMetric>
+  makeUntimed(uint64_t invocations, uint64_t deviceId, uint64_t deviceType) {
+    auto metric =
+        std::make_shared<KernelMetric>(0, 0, invocations, deviceId, deviceType);
+    metric->values[Samples] = static_cast<uint64_t>(0);
+    return metric;
+  }
+
+  bool isTimed() const { return std::get<uint64_t>(values[Samples]) > 0; }
+
+  void setOverhead(uint64_t overhead) { this->values[Overhead] = overhead; }
+
+  /// Returns the duration of all the invocations, estimated from the timed
+  /// ones.
+  uint64_t getEstimatedDuration() const {
+    auto duration = std::get<uint64_t>(values[Duration]);
+    auto invocations = std::get<uint64_t>(values[Invocations]);
+    auto samples = std::get<uint64_t>(values[Samples]);
+    if (samples == 0 || samples == invocations)
+      return duration;
+    return static_cast<uint64_t>(static_cast<double>(duration) * invocations /
+                                 samples);
   }
 
   virtual const std::string getName() const { return "KernelMetric"; }
@@ -141,10 +174,10 @@ public:
 
 private:
   const static inline bool AGGREGABLE[kernelMetricKind::Count] = {
-      false, false, true, true, false, false};
+      false, false, true, true, false, false, true, true};
   const static inline std::string VALUE_NAMES[kernelMetricKind::Count] = {
-      "StartTime (ns)", "EndTime (ns)", "Count",
-      "Time (ns)",      "DeviceId",     "DeviceType",
+      "StartTime (ns)", "EndTime (ns)", "Count",   "Time (ns)",
+      "DeviceId",       "DeviceType",   "Samples", "Overhead (ns)",
   };
 };
 
@@ -1,15 +1,30 @@
 #ifndef PROTON_DATA_TRACE_DATA_H_
 #define PROTON_DATA_TRACE_DATA_H_
 
+#include "Context/Context.h"
 #include "Data.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 namespace proton {
 
+/// Records every kernel launch as an event of a timeline, which is dumped in
+/// the Chrome trace event format and can be opened with chrome://tracing or
+/// Perfetto.
+/// The events are kept in a ring buffer of a fixed capacity, so that the
+/// memory used by a long running session is bounded. The oldest events are
+/// dropped once the buffer is full.
 class TraceData : public Data {
 public:
-  using Data::Data;
+  inline static const size_t DefaultCapacity = 1 << 18;
+
+  TraceData(const std::string &path, ContextSource *contextSource,
+            size_t capacity = DefaultCapacity);
   virtual ~TraceData() = default;
 
+  TraceData(const std::string &path) : TraceData(path, nullptr) {}
+
   size_t addScope(size_t scopeId, const std::string &name) override;
 
   void addMetric(size_t scopeId, std::shared_ptr<Metric> metric) override;
@@ -24,7 +39,39 @@ protected:
   void stopOp(const Scope &scope) override final;
 
 private:
+  void dumpChromeTrace(std::ostream &os) const;
   void doDump(std::ostream &os, OutputFormat outputFormat) const override;
+  void doFlush(std::ostream &os) override;
+
+  struct ScopeRecord {
+    std::vector<Context> contexts;
+    size_t parentScopeId = Scope::DummyScopeId;
+    std::map<std::string, MetricValueType> metrics;
+  };
+
+  struct TraceEvent {
+    std::string name;
+    std::string callPath;
+    std::map<std::string, MetricValueType> metrics;
+    uint64_t startTime;
+    uint64_t endTime;
+    uint64_t deviceId;
+    uint64_t deviceType;
+  };
+
+  // [MT] The caller must hold the data lock.
+  void addScopeRecord(size_t scopeId, ScopeRecord record);
+  // [MT] The caller must hold the data lock.
+  void addEvent(TraceEvent event);
+
+  const size_t capacity;
+  // ScopeId -> ScopeRecord, evicted in insertion order past the capacity.
+  std::unordered_map<size_t, ScopeRecord> scopeRecords;
+  std::deque<size_t> scopeOrder;
+  // Ring buffer of the events, nextEvent is the slot written next.
+  std::vector<TraceEvent> events;
+  size_t nextEvent{};
+  size_t numDroppedEvents{};
 };
 
 } // namespace proton
@@ -3,8 +3,12 @@
 
 #include "Context/Context.h"
 #include "Data.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 namespace proton {
 
@@ -31,13 +35,35 @@ protected:
 
 private:
   void init();
-  void dumpHatchet(std::ostream &os) const;
+  void dumpHatchet(std::ostream &os, OutputFormat outputFormat) const;
   void doDump(std::ostream &os, OutputFormat outputFormat) const override;
+  void doFlush(std::ostream &os) override;
+
+  // [MT] The caller must hold the data lock.
+  std::optional<size_t> getContextId(size_t scopeId) const;
+
+  // Metrics are recorded into a shard owned by the calling thread, so that
+  // recording a metric does not contend on the data lock. The shards are
+  // merged into the tree when the data is dumped.
+  struct MetricShard;
+  MetricShard &getMetricShard();
+  // [MT] The caller must hold the data lock exclusively.
+  void mergeMetricShards() const;
 
   class Tree;
   std::unique_ptr<Tree> tree;
   // ScopeId -> ContextId
   std::unordered_map<size_t, size_t> scopeIdToContextId;
+  // ScopeId -> ContextId, for the scopes added before the last flush.
+  // They are released at the next flush so that the map does not grow with
+  // the number of kernel launches.
+  std::unordered_map<size_t, size_t> flushedScopeIdToContextId;
+
+  // Identifies the data in the thread local shard caches.
+  const size_t dataId;
+  inline static std::atomic<size_t> nextDataId{0};
+  mutable std::mutex shardMutex;
+  std::vector<std::unique_ptr<MetricShard>> metricShards;
 };
 
 } // namespace proton
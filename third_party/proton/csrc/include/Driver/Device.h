@@ -6,7 +6,7 @@
 
 namespace proton {
 
-enum class DeviceType { HIP, CUDA, COUNT };
+enum class DeviceType { HIP, CUDA, XPU, COUNT };
 
 template <DeviceType T> struct DeviceTraits;
 
@@ -20,6 +20,11 @@ template <> struct DeviceTraits<DeviceType::HIP> {
   constexpr static const char *name = "HIP";
 };
 
+template <> struct DeviceTraits<DeviceType::XPU> {
+  constexpr static DeviceType type = DeviceType::XPU;
+  constexpr static const char *name = "XPU";
+};
+
 struct Device {
   DeviceType type;
   uint64_t id;
@@ -28,15 +33,16 @@ struct Device {
   uint64_t busWidth;
   uint64_t numSms;
   std::string arch;
+  uint64_t numEus; // Execution units of XPUs, 0 otherwise
 
   Device() = default;
 
   Device(DeviceType type, uint64_t id, uint64_t clockRate,
          uint64_t memoryClockRate, uint64_t busWidth, uint64_t numSms,
-         std::string arch)
+         std::string arch, uint64_t numEus = 0)
       : type(type), id(id), clockRate(clockRate),
         memoryClockRate(memoryClockRate), busWidth(busWidth), numSms(numSms),
-        arch(arch) {}
+        arch(arch), numEus(numEus) {}
 };
 
 Device getDevice(DeviceType type, uint64_t index);
@@ -0,0 +1,194 @@
+#ifndef PROTON_DRIVER_GPU_XPU_H_
+#define PROTON_DRIVER_GPU_XPU_H_
+
+#include "Driver/Device.h"
+#include "level_zero/ze_api.h"
+#include "level_zero/zet_api.h"
+
+#include <vector>
+
+namespace proton {
+
+namespace xpu {
+
+template <bool CheckSuccess> ze_result_t init(ze_init_flags_t flags);
+
+template <bool CheckSuccess>
+ze_result_t driverGet(uint32_t *count, ze_driver_handle_t *drivers);
+
+template <bool CheckSuccess>
+ze_result_t deviceGet(ze_driver_handle_t driver, uint32_t *count,
+                      ze_device_handle_t *devices);
+
+template <bool CheckSuccess>
+ze_result_t deviceGetProperties(ze_device_handle_t device,
+                                ze_device_properties_t *properties);
+
+template <bool CheckSuccess>
+ze_result_t
+deviceGetMemoryProperties(ze_device_handle_t device, uint32_t *count,
+                          ze_device_memory_properties_t *properties);
+
+template <bool CheckSuccess>
+ze_result_t deviceGetGlobalTimestamps(ze_device_handle_t device,
+                                      uint64_t *hostTimestamp,
+                                      uint64_t *deviceTimestamp);
+
+template <bool CheckSuccess>
+ze_result_t contextCreate(ze_driver_handle_t driver,
+                          const ze_context_desc_t *desc,
+                          ze_context_handle_t *context);
+
+template <bool CheckSuccess>
+ze_result_t contextDestroy(ze_context_handle_t context);
+
+template <bool CheckSuccess>
+ze_result_t eventPoolCreate(ze_context_handle_t context,
+                            const ze_event_pool_desc_t *desc,
+                            uint32_t numDevices, ze_device_handle_t *devices,
+                            ze_event_pool_handle_t *eventPool);
+
+template <bool CheckSuccess>
+ze_result_t eventPoolDestroy(ze_event_pool_handle_t eventPool);
+
+template <bool CheckSuccess>
+ze_result_t eventCreate(ze_event_pool_handle_t eventPool,
+                        const ze_event_desc_t *desc, ze_event_handle_t *event);
+
+template <bool CheckSuccess>
+ze_result_t eventDestroy(ze_event_handle_t event);
+
+template <bool CheckSuccess>
+ze_result_t eventHostSynchronize(ze_event_handle_t event, uint64_t timeout);
+
+template <bool CheckSuccess>
+ze_result_t eventHostReset(ze_event_handle_t event);
+
+template <bool CheckSuccess>
+ze_result_t eventQueryKernelTimestamp(ze_event_handle_t event,
+                                      ze_kernel_timestamp_result_t *result);
+
+template <bool CheckSuccess>
+ze_result_t commandListAppendBarrier(ze_command_list_handle_t commandList,
+                                     ze_event_handle_t signalEvent,
+                                     uint32_t numWaitEvents,
+                                     ze_event_handle_t *waitEvents);
+
+template <bool CheckSuccess>
+ze_result_t commandListGetContextHandle(ze_command_list_handle_t commandList,
+                                        ze_context_handle_t *context);
+
+template <bool CheckSuccess>
+ze_result_t commandListGetDeviceHandle(ze_command_list_handle_t commandList,
+                                       ze_device_handle_t *device);
+
+template <bool CheckSuccess>
+ze_result_t kernelGetName(ze_kernel_handle_t kernel, size_t *size, char *name);
+
+template <bool CheckSuccess>
+ze_result_t tracerExpCreate(ze_context_handle_t context,
+                            const zet_tracer_exp_desc_t *desc,
+                            zet_tracer_exp_handle_t *tracer);
+
+template <bool CheckSuccess>
+ze_result_t tracerExpDestroy(zet_tracer_exp_handle_t tracer);
+
+template <bool CheckSuccess>
+ze_result_t tracerExpSetPrologues(zet_tracer_exp_handle_t tracer,
+                                  zet_core_callbacks_t *callbacks);
+
+template <bool CheckSuccess>
+ze_result_t tracerExpSetEpilogues(zet_tracer_exp_handle_t tracer,
+                                  zet_core_callbacks_t *callbacks);
+
+template <bool CheckSuccess>
+ze_result_t tracerExpSetEnabled(zet_tracer_exp_handle_t tracer,
+                                ze_bool_t enable);
+
+template <bool CheckSuccess>
+ze_result_t metricGroupGet(ze_device_handle_t device, uint32_t *count,
+                           zet_metric_group_handle_t *metricGroups);
+
+template <bool CheckSuccess>
+ze_result_t
+metricGroupGetProperties(zet_metric_group_handle_t metricGroup,
+                         zet_metric_group_properties_t *properties);
+
+template <bool CheckSuccess>
+ze_result_t metricGet(zet_metric_group_handle_t metricGroup, uint32_t *count,
+                      zet_metric_handle_t *metrics);
+
+template <bool CheckSuccess>
+ze_result_t metricGetProperties(zet_metric_handle_t metric,
+                                zet_metric_properties_t *properties);
+
+template <bool CheckSuccess>
+ze_result_t metricGroupCalculateMetricValues(
+    zet_metric_group_handle_t metricGroup,
+    zet_metric_group_calculation_type_t type, size_t rawDataSize,
+    const uint8_t *rawData, uint32_t *metricValueCount,
+    zet_typed_value_t *metricValues);
+
+template <bool CheckSuccess>
+ze_result_t
+contextActivateMetricGroups(ze_context_handle_t context,
+                            ze_device_handle_t device, uint32_t count,
+                            zet_metric_group_handle_t *metricGroups);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryPoolCreate(ze_context_handle_t context,
+                                  ze_device_handle_t device,
+                                  zet_metric_group_handle_t metricGroup,
+                                  const zet_metric_query_pool_desc_t *desc,
+                                  zet_metric_query_pool_handle_t *queryPool);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryPoolDestroy(zet_metric_query_pool_handle_t queryPool);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryCreate(zet_metric_query_pool_handle_t queryPool,
+                              uint32_t index,
+                              zet_metric_query_handle_t *query);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryDestroy(zet_metric_query_handle_t query);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryReset(zet_metric_query_handle_t query);
+
+template <bool CheckSuccess>
+ze_result_t metricQueryGetData(zet_metric_query_handle_t query,
+                               size_t *rawDataSize, uint8_t *rawData);
+
+template <bool CheckSuccess>
+ze_result_t
+commandListAppendMetricQueryBegin(zet_command_list_handle_t commandList,
+                                  zet_metric_query_handle_t query);
+
+template <bool CheckSuccess>
+ze_result_t commandListAppendMetricQueryEnd(
+    zet_command_list_handle_t commandList, zet_metric_query_handle_t query,
+    ze_event_handle_t signalEvent, uint32_t numWaitEvents,
+    ze_event_handle_t *waitEvents);
+
+/// Enable the Level Zero tracing layer at runtime.
+/// Loaders older than 1.17 don't provide `zelEnableTracingLayer`, in which case
+/// `ZE_ENABLE_TRACING_LAYER=1` has to be set before the driver is initialized.
+/// Returns false if the tracing layer could not be enabled.
+bool enableTracingLayer();
+
+/// Return the device handles of all Level Zero GPU devices, in the order of
+/// the first GPU driver, which matches the SYCL device order.
+const std::vector<ze_device_handle_t> &getDevices();
+
+/// Map a device handle to its index in `getDevices()`.
+/// Returns 0 if the device is unknown.
+uint64_t getDeviceIndex(ze_device_handle_t device);
+
+Device getDevice(uint64_t index);
+
+} // namespace xpu
+
+} // namespace proton
+
+#endif // PROTON_DRIVER_GPU_XPU_H_
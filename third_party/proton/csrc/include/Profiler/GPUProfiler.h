@@ -25,11 +25,18 @@ public:
   GPUProfiler() = default;
   virtual ~GPUProfiler() = default;
 
+  // The correlation bookkeeping is updated on every kernel launch and read
+  // on every completed activity, so it is sharded to avoid contention between
+  // the launching threads and the buffer-completion callbacks.
+  static constexpr size_t numCorrelationShards = 32;
+
   using CorrIdToExternIdMap =
       ThreadSafeMap<uint64_t,
                     std::pair<size_t, size_t>, /*<extern_id, num_kernels>*/
-                    std::unordered_map<uint64_t, std::pair<size_t, size_t>>>;
-  using ApiExternIdSet = ThreadSafeSet<size_t, std::unordered_set<size_t>>;
+                    std::unordered_map<uint64_t, std::pair<size_t, size_t>>,
+                    numCorrelationShards>;
+  using ApiExternIdSet = ThreadSafeSet<size_t, std::unordered_set<size_t>,
+                                       numCorrelationShards>;
 
 protected:
   // OpInterface
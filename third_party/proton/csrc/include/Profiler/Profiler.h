@@ -15,6 +15,19 @@
 
 namespace proton {
 
+/// The kernel launches a profiler times. Each kernel is timed once every
+/// `launchInterval` launches, or on its first launch after `periodNs`
+/// nanoseconds since it was last timed, whichever comes first. The other
+/// launches are only counted, and their duration is estimated from the timed
+/// launches of the same kernel.
+struct SamplingConfig {
+  uint64_t launchInterval{1};
+  // 0 disables the time based sampling.
+  uint64_t periodNs{0};
+
+  bool isEnabled() const { return launchInterval != 1 || periodNs != 0; }
+};
+
 /// A profiler contains utilities provided by the profiler library to
 /// collect and analyze performance data.
 class Profiler {
@@ -73,6 +86,19 @@ public:
     return dataSet;
   }
 
+  /// Set the kernel launches to time.
+  /// Profilers that do not support sampling time every launch.
+  Profiler *setSampling(const SamplingConfig &config) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    sampling = config;
+    return this;
+  }
+
+  SamplingConfig getSampling() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return sampling;
+  }
+
 protected:
   virtual void doStart() = 0;
   virtual void doFlush() = 0;
@@ -80,6 +106,7 @@ protected:
 
   mutable std::shared_mutex mutex;
   std::set<Data *> dataSet;
+  SamplingConfig sampling;
   bool isInitialized{false};
 };
 
@@ -0,0 +1,19 @@
+#ifndef PROTON_PROFILER_XPU_PROFILER_H_
+#define PROTON_PROFILER_XPU_PROFILER_H_
+
+#include "GPUProfiler.h"
+
+namespace proton {
+
+class XpuProfiler : public GPUProfiler<XpuProfiler> {
+public:
+  XpuProfiler();
+  virtual ~XpuProfiler();
+
+private:
+  struct XpuProfilerPimpl;
+};
+
+} // namespace proton
+
+#endif // PROTON_PROFILER_XPU_PROFILER_H_
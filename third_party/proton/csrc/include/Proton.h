@@ -3,6 +3,7 @@
 
 #include "Context/Context.h"
 #include "Data/Data.h"
+#include "Data/HatchetReader.h"
 #include "Data/Metric.h"
 #include "Session/Session.h"
 
@@ -3,6 +3,7 @@
 
 #include "Context/Context.h"
 #include "Data/Metric.h"
+#include "Profiler/Profiler.h"
 #include "Utility/Singleton.h"
 #include <map>
 #include <memory>
@@ -13,7 +14,6 @@
 
 namespace proton {
 
-class Profiler;
 class Data;
 enum class OutputFormat;
 
@@ -28,14 +28,17 @@ public:
 
   void deactivate();
 
+  void flush();
+
   void finalize(OutputFormat outputFormat);
 
 private:
   Session(size_t id, const std::string &path, Profiler *profiler,
           std::unique_ptr<ContextSource> contextSource,
-          std::unique_ptr<Data> data)
+          std::unique_ptr<Data> data, const SamplingConfig &sampling)
       : id(id), path(path), profiler(profiler),
-        contextSource(std::move(contextSource)), data(std::move(data)) {}
+        contextSource(std::move(contextSource)), data(std::move(data)),
+        sampling(sampling) {}
 
   template <typename T> std::vector<T *> getInterfaces() {
     std::vector<T *> interfaces;
@@ -56,6 +59,7 @@ private:
   Profiler *profiler{};
   std::unique_ptr<ContextSource> contextSource{};
   std::unique_ptr<Data> data{};
+  SamplingConfig sampling{};
 
   friend class SessionManager;
 };
@@ -69,12 +73,17 @@ public:
 
   size_t addSession(const std::string &path, const std::string &profilerName,
                     const std::string &contextSourceName,
-                    const std::string &dataName);
+                    const std::string &dataName,
+                    const SamplingConfig &sampling = {});
 
   void finalizeSession(size_t sessionId, OutputFormat outputFormat);
 
   void finalizeAllSessions(OutputFormat outputFormat);
 
+  void flushSession(size_t sessionId);
+
+  void flushAllSessions();
+
   void activateSession(size_t sesssionId);
 
   void deactivateSession(size_t sessionId);
@@ -95,7 +104,8 @@ private:
   std::unique_ptr<Session> makeSession(size_t id, const std::string &path,
                                        const std::string &profilerName,
                                        const std::string &contextSourceName,
-                                       const std::string &dataName);
+                                       const std::string &dataName,
+                                       const SamplingConfig &sampling);
 
   void activateSessionImpl(size_t sesssionId);
 
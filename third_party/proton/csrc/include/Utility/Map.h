@@ -1,59 +1,86 @@
 #ifndef PROTON_UTILITY_MAP_H_
 #define PROTON_UTILITY_MAP_H_
 
+#include <array>
+#include <functional>
 #include <map>
+#include <mutex>
 #include <shared_mutex>
 
 namespace proton {
 
 /// A simple thread safe map with read/write lock.
+/// The keys are spread over `NumShards` independently locked shards, so that
+/// threads accessing different keys, e.g., the correlation ids of the
+/// launches of different streams, do not contend on a single lock.
 template <typename Key, typename Value,
-          typename Container = std::map<Key, Value>>
+          typename Container = std::map<Key, Value>, size_t NumShards = 1>
 class ThreadSafeMap {
 public:
   ThreadSafeMap() = default;
 
   Value &operator[](const Key &key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    return map[key];
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.map[key];
   }
 
   Value &operator[](Key &&key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    return map[std::move(key)];
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.map[std::move(key)];
   }
 
   Value &at(const Key &key) {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    return map.at(key);
+    auto &shard = getShard(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.map.at(key);
   }
 
   void insert(const Key &key, const Value &value) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    map[key] = value;
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.map[key] = value;
   }
 
   bool contain(const Key &key) {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    auto it = map.find(key);
-    if (it == map.end())
+    auto &shard = getShard(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end())
       return false;
     return true;
   }
 
   bool erase(const Key &key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    return map.erase(key) > 0;
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.map.erase(key) > 0;
   }
 
   void clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    map.clear();
+    for (auto &shard : shards) {
+      std::unique_lock<std::shared_mutex> lock(shard.mutex);
+      shard.map.clear();
+    }
   }
 
 private:
-  Container map;
-  std::shared_mutex mutex;
+  // Each shard lives on its own cache line to avoid false sharing between
+  // the locks.
+  struct alignas(64) Shard {
+    Container map;
+    std::shared_mutex mutex;
+  };
+
+  Shard &getShard(const Key &key) {
+    if constexpr (NumShards == 1)
+      return shards[0];
+    else
+      return shards[std::hash<Key>{}(key) % NumShards];
+  }
+
+  std::array<Shard, NumShards> shards;
 };
 
 } // namespace proton
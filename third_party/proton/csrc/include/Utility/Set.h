@@ -1,45 +1,67 @@
 #ifndef PROTON_UTILITY_SET_H_
 #define PROTON_UTILITY_SET_H_
 
+#include <array>
+#include <functional>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 
 namespace proton {
 
 /// A simple thread safe set with read/write lock.
-template <typename Key, typename Container = std::set<Key>>
+/// The keys are spread over `NumShards` independently locked shards, see
+/// ThreadSafeMap.
+template <typename Key, typename Container = std::set<Key>,
+          size_t NumShards = 1>
 class ThreadSafeSet {
 public:
   ThreadSafeSet() = default;
 
   void insert(const Key &key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    set.insert(key);
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.set.insert(key);
   }
 
   bool contain(const Key &key) {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    auto it = set.find(key);
-    if (it == set.end())
+    auto &shard = getShard(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.set.find(key);
+    if (it == shard.set.end())
       return false;
     return true;
   }
 
   bool erase(const Key &key) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    return set.erase(key) > 0;
+    auto &shard = getShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.set.erase(key) > 0;
   }
 
   void clear() {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    set.clear();
+    for (auto &shard : shards) {
+      std::unique_lock<std::shared_mutex> lock(shard.mutex);
+      shard.set.clear();
+    }
   }
 
 private:
-  Container set;
-  std::shared_mutex mutex;
+  struct alignas(64) Shard {
+    Container set;
+    std::shared_mutex mutex;
+  };
+
+  Shard &getShard(const Key &key) {
+    if constexpr (NumShards == 1)
+      return shards[0];
+    else
+      return shards[std::hash<Key>{}(key) % NumShards];
+  }
+
+  std::array<Shard, NumShards> shards;
 };
 
 } // namespace proton
 
-#endif // PROTON_UTILITY_MAP_H_
+#endif // PROTON_UTILITY_SET_H_
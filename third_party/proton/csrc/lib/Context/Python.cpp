@@ -1,6 +1,7 @@
 #include "Context/Python.h"
 #include "pybind11/pybind11.h"
 #include <algorithm>
+#include <cstdlib>
 #include <string>
 
 namespace proton {
@@ -69,8 +70,28 @@ std::string unpackPyobject(PyObject *pyObject) {
   return "";
 }
 
+size_t getMaxDepthFromEnv() {
+  const char *env = std::getenv("PROTON_PYTHON_MAX_DEPTH");
+  if (env == nullptr || *env == '\0')
+    return std::numeric_limits<size_t>::max();
+  return std::strtoull(env, nullptr, 10);
+}
+
 } // namespace
 
+PythonContextSource::PythonContextSource()
+    : PythonContextSource(getMaxDepthFromEnv()) {}
+
+PythonContextSource::~PythonContextSource() {
+  // The interpreter may already be finalized when the session is destroyed at
+  // exit, together with the code objects.
+  if (!Py_IsInitialized())
+    return;
+  pybind11::gil_scoped_acquire gil;
+  for (auto &[key, context] : frameContexts)
+    Py_DECREF((PyObject *)key.first);
+}
+
 std::vector<Context> PythonContextSource::getContexts() {
   pybind11::gil_scoped_acquire gil;
 
@@ -78,18 +99,26 @@ std::vector<Context> PythonContextSource::getContexts() {
   Py_XINCREF(frame);
 
   std::vector<Context> contexts;
-  while (frame != nullptr) {
+  while (frame != nullptr && contexts.size() < maxDepth) {
     PyCodeObject *f_code = getFrameCodeObject(frame);
-    size_t lineno = PyFrame_GetLineNumber(frame);
-    size_t firstLineNo = f_code->co_firstlineno;
-    std::string file = unpackPyobject(f_code->co_filename);
-    std::string function = unpackPyobject(f_code->co_name);
-    auto pythonFrame = file + ":" + function + "@" + std::to_string(lineno);
-    contexts.push_back(Context(pythonFrame));
+    int lineno = PyFrame_GetLineNumber(frame);
+    auto [it, inserted] =
+        frameContexts.try_emplace(FrameKey(f_code, lineno), Context());
+    if (inserted) {
+      // Keep the code object alive, so that its address is not reused by
+      // another code object.
+      Py_INCREF(f_code);
+      std::string file = unpackPyobject(f_code->co_filename);
+      std::string function = unpackPyobject(f_code->co_name);
+      it->second.name = file + ":" + function + "@" + std::to_string(lineno);
+    }
+    contexts.push_back(it->second);
+    Py_DECREF(f_code);
     auto newFrame = getFrameBack(frame);
     Py_DECREF(frame);
     frame = newFrame;
   }
+  Py_XDECREF(frame);
   std::reverse(contexts.begin(), contexts.end());
   return contexts;
 }
@@ -10,8 +10,7 @@
 namespace proton {
 
 void Data::dump(OutputFormat outputFormat) {
-  std::shared_lock<std::shared_mutex> lock(mutex);
-
+  // The data lock is taken by doDump
   std::unique_ptr<std::ostream> out;
   if (path.empty() || path == "-") {
     out.reset(new std::ostream(std::cout.rdbuf())); // Redirecting to cout
@@ -23,10 +22,29 @@ void Data::dump(OutputFormat outputFormat) {
   doDump(*out, outputFormat);
 }
 
+void Data::flush() {
+  std::unique_ptr<std::ostream> out;
+  if (path.empty() || path == "-") {
+    out.reset(new std::ostream(std::cout.rdbuf())); // Redirecting to cout
+  } else {
+    out.reset(new std::ofstream(
+        path + "." + outputFormatToString(OutputFormat::HatchetMsgPack),
+        std::ios::binary | std::ios::app)); // Appending to the stream file
+  }
+  doFlush(*out);
+  flushed = true;
+}
+
 OutputFormat parseOutputFormat(const std::string &outputFormat) {
   if (toLower(outputFormat) == "hatchet") {
     return OutputFormat::Hatchet;
   }
+  if (toLower(outputFormat) == "hatchet_msgpack") {
+    return OutputFormat::HatchetMsgPack;
+  }
+  if (toLower(outputFormat) == "chrome_trace") {
+    return OutputFormat::ChromeTrace;
+  }
   throw std::runtime_error("Unknown output format: " + outputFormat);
 }
 
@@ -34,6 +52,12 @@ const std::string outputFormatToString(OutputFormat outputFormat) {
   if (outputFormat == OutputFormat::Hatchet) {
     return "hatchet";
   }
+  if (outputFormat == OutputFormat::HatchetMsgPack) {
+    return "hatchet.msgpack";
+  }
+  if (outputFormat == OutputFormat::ChromeTrace) {
+    return "chrome_trace";
+  }
   throw std::runtime_error("Unknown output format: " +
                            std::to_string(static_cast<int>(outputFormat)));
 }
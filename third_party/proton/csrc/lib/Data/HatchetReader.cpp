@@ -0,0 +1,214 @@
+#include "Data/HatchetReader.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace proton {
+
+namespace {
+
+using Metrics = std::map<std::string, double>;
+
+// The reduction state of the frames read, stored in their JSON object until
+// the whole tree is read.
+constexpr const char *DeepKey = "__deep";
+constexpr const char *DeepUnmatchedKey = "__deep_unmatched";
+constexpr const char *MatchedKey = "__matched";
+constexpr const char *DescendantMatchedKey = "__descendant_matched";
+
+void addMetrics(Metrics &metrics, const Metrics &other) {
+  for (auto &[name, value] : other)
+    metrics[name] += value;
+}
+
+std::string toLower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+
+// Whether the metric `name` is `metricName`, case insensitive and without its
+// unit, e.g. "Time (ns)" is "time".
+bool isMetric(const std::string &name, const std::string &metricName) {
+  std::string nameNoUnit = name.substr(0, name.find('('));
+  nameNoUnit.erase(nameNoUnit.find_last_not_of(' ') + 1);
+  return toLower(name) == toLower(metricName) ||
+         toLower(nameNoUnit) == toLower(metricName);
+}
+
+Metrics getNumericMetrics(const json &node) {
+  Metrics metrics;
+  auto it = node.find("metrics");
+  if (it == node.end())
+    return metrics;
+  for (auto &[name, value] : it->items())
+    if (value.is_number())
+      metrics[name] = value.get<double>();
+  return metrics;
+}
+
+// The metrics of the frames folded into a frame being read. Those of the
+// frames known to be on a path through an included frame are in `deep`,
+// those which only are if an ancestor of the frame is included, which is not
+// known yet, are in `deepUnmatched`.
+struct FrameState {
+  Metrics deep;
+  Metrics deepUnmatched;
+  bool descendantMatched = false;
+};
+
+class HatchetReducer {
+public:
+  explicit HatchetReducer(const HatchetReadOptions &options)
+      : options(options) {
+    if (!options.include.empty())
+      includeRegex = std::regex(options.include);
+    for (auto &exclude : options.exclude)
+      excludeRegexes.emplace_back(exclude);
+  }
+
+  // The nodes of the tree are the objects at odd depths of the first element
+  // of the top level array: the root at depth 1, the children of a node at
+  // depth 2 in its "children" array, ...
+  bool operator()(int depth, json::parse_event_t event, json &parsed) {
+    bool isNode = (depth % 2 == 1) && topLevelIndex == 0;
+    if (event == json::parse_event_t::object_start && isNode) {
+      frames.emplace_back();
+    } else if (event == json::parse_event_t::object_end) {
+      if (depth == 1)
+        ++topLevelIndex;
+      if (isNode)
+        return reduceFrame(parsed);
+    }
+    return true;
+  }
+
+  // Applies the inclusion of the paths through the included frames, known
+  // once the whole tree is read, to the frame `node`. Returns whether it is
+  // kept.
+  bool finalize(json &node, bool ancestorMatched, bool isRoot) const {
+    bool matched = ancestorMatched || node.at(MatchedKey).get<bool>();
+    json children = json::array();
+    for (auto &child : node["children"])
+      if (finalize(child, matched, /*isRoot=*/false))
+        children.push_back(std::move(child));
+    node["children"] = std::move(children);
+
+    Metrics deep = node.at(DeepKey).get<Metrics>();
+    if (matched)
+      addMetrics(deep, node.at(DeepUnmatchedKey).get<Metrics>());
+    for (auto &[name, value] : deep) {
+      json &metric = node["metrics"][name];
+      metric = (metric.is_number() ? metric.get<double>() : 0.0) + value;
+    }
+    bool keep =
+        isRoot || matched || node.at(DescendantMatchedKey).get<bool>();
+    for (auto key : {DeepKey, DeepUnmatchedKey, MatchedKey,
+                     DescendantMatchedKey})
+      node.erase(key);
+    return keep;
+  }
+
+  // Drops the children of `node` whose inclusive threshold metric is below
+  // the threshold. Returns the inclusive metric of `node`.
+  double applyThreshold(json &node) const {
+    double inclusive = 0.0;
+    for (auto &[name, value] : getNumericMetrics(node))
+      if (isMetric(name, options.thresholdMetric))
+        inclusive = value;
+    json children = json::array();
+    for (auto &child : node["children"]) {
+      double childInclusive = applyThreshold(child);
+      inclusive += childInclusive;
+      if (childInclusive >= options.threshold)
+        children.push_back(std::move(child));
+    }
+    node["children"] = std::move(children);
+    return inclusive;
+  }
+
+private:
+  bool isExcluded(const std::string &name) const {
+    for (auto &regex : excludeRegexes)
+      if (std::regex_match(name, regex))
+        return true;
+    return false;
+  }
+
+  // Reduces the frame `node` whose children were read and reduced. Returns
+  // false if it is dropped from the JSON tree.
+  bool reduceFrame(json &node) {
+    FrameState state = std::move(frames.back());
+    frames.pop_back();
+    size_t depth = frames.size();
+    FrameState *parent = frames.empty() ? nullptr : &frames.back();
+
+    auto name = node.at("frame").at("name").get<std::string>();
+    if (parent && isExcluded(name))
+      return false;
+    bool matched =
+        options.include.empty() || std::regex_match(name, includeRegex);
+    if (parent)
+      parent->descendantMatched |= matched || state.descendantMatched;
+
+    if (depth <= options.maxDepth) {
+      node[DeepKey] = state.deep;
+      node[DeepUnmatchedKey] = state.deepUnmatched;
+      node[MatchedKey] = matched;
+      node[DescendantMatchedKey] = state.descendantMatched;
+      return true;
+    }
+
+    // Fold the frame into its parent. Its own metrics are on a path through
+    // an included frame if it, or one of its descendants, is included.
+    Metrics metrics = getNumericMetrics(node);
+    if (matched) {
+      addMetrics(parent->deep, metrics);
+      addMetrics(parent->deep, state.deepUnmatched);
+    } else {
+      addMetrics(state.descendantMatched ? parent->deep : parent->deepUnmatched,
+                 metrics);
+      addMetrics(parent->deepUnmatched, state.deepUnmatched);
+    }
+    addMetrics(parent->deep, state.deep);
+    return false;
+  }
+
+  const HatchetReadOptions &options;
+  std::regex includeRegex;
+  std::vector<std::regex> excludeRegexes;
+  // The frames being read, from the root.
+  std::vector<FrameState> frames;
+  size_t topLevelIndex = 0;
+};
+
+} // namespace
+
+std::string readHatchet(const std::string &path,
+                        const HatchetReadOptions &options) {
+  std::ifstream file(path);
+  if (!file)
+    throw std::runtime_error("Cannot open the profile " + path);
+  HatchetReducer reducer(options);
+  json database = json::parse(
+      file, [&](int depth, json::parse_event_t event, json &parsed) {
+        return reducer(depth, event, parsed);
+      });
+  if (!database.is_array() || database.empty())
+    throw std::runtime_error("Invalid hatchet profile " + path);
+
+  json &root = database[0];
+  reducer.finalize(root, /*ancestorMatched=*/false, /*isRoot=*/true);
+  if (!options.thresholdMetric.empty())
+    reducer.applyThreshold(root);
+  return database.dump();
+}
+
+} // namespace proton
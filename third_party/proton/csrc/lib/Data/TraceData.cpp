@@ -1,30 +1,188 @@
 #include "Data/TraceData.h"
+#include "Data/Metric.h"
+#include "Driver/Device.h"
 #include "Utility/Errors.h"
+#include "nlohmann/json.hpp"
 
+#include <mutex>
+#include <set>
 #include <stdexcept>
 
+using json = nlohmann::json;
+
 namespace proton {
 
-void TraceData::startOp(const Scope &scope) { throw NotImplemented(); }
+TraceData::TraceData(const std::string &path, ContextSource *contextSource,
+                     size_t capacity)
+    : Data(path, contextSource), capacity(capacity) {
+  if (capacity == 0)
+    throw std::runtime_error("TraceData capacity must be positive");
+}
+
+void TraceData::addScopeRecord(size_t scopeId, ScopeRecord record) {
+  if (!scopeRecords.insert_or_assign(scopeId, std::move(record)).second)
+    return;
+  scopeOrder.push_back(scopeId);
+  // The records of the scopes whose kernels never completed are released
+  // once there are more pending scopes than events
+  while (scopeOrder.size() > capacity) {
+    scopeRecords.erase(scopeOrder.front());
+    scopeOrder.pop_front();
+  }
+}
 
-void TraceData::stopOp(const Scope &scope) { throw NotImplemented(); }
+void TraceData::addEvent(TraceEvent event) {
+  if (events.size() < capacity) {
+    events.push_back(std::move(event));
+  } else {
+    events[nextEvent] = std::move(event);
+    numDroppedEvents++;
+  }
+  nextEvent = (nextEvent + 1) % capacity;
+}
 
-size_t TraceData::addScope(size_t scopeId, const std::string &name) {
-  throw NotImplemented();
+void TraceData::startOp(const Scope &scope) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  ScopeRecord record;
+  if (contextSource != nullptr)
+    record.contexts = contextSource->getContexts();
+  record.contexts.push_back(Context(scope.name));
+  addScopeRecord(scope.scopeId, std::move(record));
+}
+
+void TraceData::stopOp(const Scope &scope) {}
+
+size_t TraceData::addScope(size_t parentScopeId, const std::string &name) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  auto parentIt = scopeRecords.find(parentScopeId);
+  if (parentIt == scopeRecords.end()) {
+    ScopeRecord record;
+    if (contextSource != nullptr)
+      record.contexts = contextSource->getContexts();
+    // Record the parent context
+    addScopeRecord(parentScopeId, std::move(record));
+    return parentScopeId;
+  }
+  // Add a new context under it
+  ScopeRecord record;
+  record.contexts = parentIt->second.contexts;
+  record.contexts.push_back(Context(name));
+  record.parentScopeId = parentScopeId;
+  auto scopeId = Scope::getNewScopeId();
+  addScopeRecord(scopeId, std::move(record));
+  return scopeId;
 }
 
 void TraceData::addMetric(size_t scopeId, std::shared_ptr<Metric> metric) {
-  throw NotImplemented();
+  if (metric->getKind() != MetricKind::Kernel)
+    throw std::runtime_error("MetricKind not supported");
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  auto scopeIt = scopeRecords.find(scopeId);
+  if (scopeIt == scopeRecords.end())
+    return;
+  auto &record = scopeIt->second;
+  // The invocations that were not timed have no place on the timeline
+  auto kernelMetric = std::static_pointer_cast<KernelMetric>(metric);
+  if (!kernelMetric->isTimed()) {
+    if (record.parentScopeId != Scope::DummyScopeId)
+      scopeRecords.erase(scopeIt);
+    return;
+  }
+  TraceEvent event;
+  event.name = record.contexts.empty() ? "" : record.contexts.back().name;
+  for (size_t i = 0; i + 1 < record.contexts.size(); ++i) {
+    if (i > 0)
+      event.callPath += "/";
+    event.callPath += record.contexts[i].name;
+  }
+  // The metrics of the op launching the kernel are attached to its event
+  auto parentIt = scopeRecords.find(record.parentScopeId);
+  if (parentIt != scopeRecords.end())
+    event.metrics = parentIt->second.metrics;
+  for (auto &[name, value] : record.metrics)
+    event.metrics[name] = value;
+  event.startTime =
+      std::get<uint64_t>(metric->getValue(KernelMetric::StartTime));
+  event.endTime = std::get<uint64_t>(metric->getValue(KernelMetric::EndTime));
+  event.deviceId = std::get<uint64_t>(metric->getValue(KernelMetric::DeviceId));
+  event.deviceType =
+      std::get<uint64_t>(metric->getValue(KernelMetric::DeviceType));
+  addEvent(std::move(event));
+  // A kernel scope receives a single metric, the op scope may still launch
+  // more kernels
+  if (record.parentScopeId != Scope::DummyScopeId)
+    scopeRecords.erase(scopeIt);
 }
 
 void TraceData::addMetrics(
     size_t scopeId, const std::map<std::string, MetricValueType> &metrics,
     bool aggregable) {
-  throw NotImplemented();
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  // Metrics that are not attached to a launch have no place on the timeline
+  auto scopeIt = scopeRecords.find(scopeId);
+  if (scopeIt == scopeRecords.end())
+    return;
+  for (auto [metricName, metricValue] : metrics)
+    scopeIt->second.metrics[metricName] = metricValue;
+}
+
+void TraceData::dumpChromeTrace(std::ostream &os) const {
+  json traceEvents = json::array();
+  std::map<uint64_t, std::set<uint64_t>> deviceIds;
+  // Walk the ring buffer from the oldest event
+  auto start = events.size() < capacity ? 0 : nextEvent;
+  for (size_t i = 0; i < events.size(); ++i) {
+    auto &event = events[(start + i) % events.size()];
+    json args = json::object();
+    args["call_path"] = event.callPath;
+    for (auto &[name, value] : event.metrics)
+      std::visit([&](auto &&v) { args[name] = v; }, value);
+    // Timestamps are in microseconds
+    traceEvents.push_back(
+        {{"name", event.name},
+         {"cat", "kernel"},
+         {"ph", "X"},
+         {"ts", static_cast<double>(event.startTime) / 1000},
+         {"dur",
+          static_cast<double>(event.endTime - event.startTime) / 1000},
+         {"pid", event.deviceId},
+         {"tid", event.deviceType},
+         {"args", args}});
+    deviceIds[event.deviceType].insert(event.deviceId);
+  }
+  // Name the tracks after the devices
+  for (auto &[deviceType, ids] : deviceIds) {
+    auto deviceTypeName =
+        getDeviceTypeString(static_cast<DeviceType>(deviceType));
+    for (auto deviceId : ids) {
+      auto deviceName = deviceTypeName + " " + std::to_string(deviceId);
+      traceEvents.push_back({{"name", "process_name"},
+                             {"ph", "M"},
+                             {"pid", deviceId},
+                             {"args", {{"name", deviceName}}}});
+      traceEvents.push_back({{"name", "thread_name"},
+                             {"ph", "M"},
+                             {"pid", deviceId},
+                             {"tid", deviceType},
+                             {"args", {{"name", deviceTypeName}}}});
+    }
+  }
+  json output = {{"traceEvents", traceEvents},
+                 {"displayTimeUnit", "ns"},
+                 {"otherData", {{"dropped_events", numDroppedEvents}}}};
+  os << output.dump() << std::endl;
 }
 
 void TraceData::doDump(std::ostream &os, OutputFormat outputFormat) const {
-  throw NotImplemented();
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  if (outputFormat == OutputFormat::ChromeTrace) {
+    dumpChromeTrace(os);
+  } else {
+    throw std::runtime_error("Output format not supported by trace data: " +
+                             outputFormatToString(outputFormat));
+  }
 }
 
+void TraceData::doFlush(std::ostream &os) { throw NotImplemented(); }
+
 } // namespace proton
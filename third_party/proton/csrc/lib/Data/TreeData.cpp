@@ -99,8 +99,63 @@ private:
   std::map<size_t, TreeNode> treeNodeMap;
 };
 
+struct TreeData::MetricShard {
+  // Only contended while the shard is merged.
+  std::mutex mutex;
+  // ScopeId -> MetricKind -> Metric
+  std::unordered_map<size_t, std::map<MetricKind, std::shared_ptr<Metric>>>
+      metrics;
+};
+
 void TreeData::init() { tree = std::make_unique<Tree>(); }
 
+TreeData::MetricShard &TreeData::getMetricShard() {
+  // DataId -> MetricShard owned by the data
+  thread_local std::unordered_map<size_t, MetricShard *> shards;
+  auto &shard = shards[dataId];
+  if (shard == nullptr) {
+    std::lock_guard<std::mutex> lock(shardMutex);
+    metricShards.push_back(std::make_unique<MetricShard>());
+    shard = metricShards.back().get();
+  }
+  return *shard;
+}
+
+void TreeData::mergeMetricShards() const {
+  std::lock_guard<std::mutex> shardLock(shardMutex);
+  for (auto &shard : metricShards) {
+    std::unordered_map<size_t, std::map<MetricKind, std::shared_ptr<Metric>>>
+        metrics;
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      metrics.swap(shard->metrics);
+    }
+    for (auto &[scopeId, scopeMetrics] : metrics) {
+      auto contextId = getContextId(scopeId);
+      // The profile data is deactived, ignore the metrics
+      if (!contextId)
+        continue;
+      auto &node = tree->getNode(*contextId);
+      for (auto &[metricKind, metric] : scopeMetrics) {
+        if (node.metrics.find(metricKind) == node.metrics.end())
+          node.metrics.emplace(metricKind, metric);
+        else
+          node.metrics[metricKind]->updateMetric(*metric);
+      }
+    }
+  }
+}
+
+std::optional<size_t> TreeData::getContextId(size_t scopeId) const {
+  auto scopeIdIt = scopeIdToContextId.find(scopeId);
+  if (scopeIdIt != scopeIdToContextId.end())
+    return scopeIdIt->second;
+  scopeIdIt = flushedScopeIdToContextId.find(scopeId);
+  if (scopeIdIt != flushedScopeIdToContextId.end())
+    return scopeIdIt->second;
+  return std::nullopt;
+}
+
 void TreeData::startOp(const Scope &scope) {
   // enterOp and addMetric maybe called from different threads
   std::unique_lock<std::shared_mutex> lock(mutex);
@@ -116,9 +171,9 @@ void TreeData::stopOp(const Scope &scope) {}
 
 size_t TreeData::addScope(size_t parentScopeId, const std::string &name) {
   std::unique_lock<std::shared_mutex> lock(mutex);
-  auto scopeIdIt = scopeIdToContextId.find(parentScopeId);
+  auto parentContextId = getContextId(parentScopeId);
   auto scopeId = parentScopeId;
-  if (scopeIdIt == scopeIdToContextId.end()) {
+  if (!parentContextId) {
     std::vector<Context> contexts;
     if (contextSource != nullptr)
       contexts = contextSource->getContexts();
@@ -128,39 +183,37 @@ size_t TreeData::addScope(size_t parentScopeId, const std::string &name) {
     // Add a new context under it and update the context
     scopeId = Scope::getNewScopeId();
     scopeIdToContextId[scopeId] =
-        tree->addNode(Context(name), scopeIdIt->second);
+        tree->addNode(Context(name), *parentContextId);
   }
   return scopeId;
 }
 
 void TreeData::addMetric(size_t scopeId, std::shared_ptr<Metric> metric) {
-  std::unique_lock<std::shared_mutex> lock(mutex);
-  auto scopeIdIt = scopeIdToContextId.find(scopeId);
-  // The profile data is deactived, ignore the metric
-  if (scopeIdIt == scopeIdToContextId.end())
-    return;
-  auto contextId = scopeIdIt->second;
-  auto &node = tree->getNode(contextId);
-  if (node.metrics.find(metric->getKind()) == node.metrics.end())
-    node.metrics.emplace(metric->getKind(), metric);
+  // The metric is attributed to the context of the scope when the shards are
+  // merged
+  auto &shard = getMetricShard();
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto &metrics = shard.metrics[scopeId];
+  if (metrics.find(metric->getKind()) == metrics.end())
+    metrics.emplace(metric->getKind(), metric);
   else
-    node.metrics[metric->getKind()]->updateMetric(*metric);
+    metrics[metric->getKind()]->updateMetric(*metric);
 }
 
 void TreeData::addMetrics(size_t scopeId,
                           const std::map<std::string, MetricValueType> &metrics,
                           bool aggregable) {
   std::unique_lock<std::shared_mutex> lock(mutex);
-  auto scopeIdIt = scopeIdToContextId.find(scopeId);
+  auto scopeContextId = getContextId(scopeId);
   auto contextId = Tree::TreeNode::DummyId;
-  if (scopeIdIt == scopeIdToContextId.end()) {
+  if (!scopeContextId) {
     if (contextSource == nullptr)
       throw std::runtime_error("ContextSource is not set");
     // Attribute the metric to the last context
     std::vector<Context> contexts = contextSource->getContexts();
     contextId = tree->addNode(contexts);
   } else {
-    contextId = scopeIdIt->second;
+    contextId = *scopeContextId;
   }
   auto &node = tree->getNode(contextId);
   for (auto [metricName, metricValue] : metrics) {
@@ -173,7 +226,8 @@ void TreeData::addMetrics(size_t scopeId,
   }
 }
 
-void TreeData::dumpHatchet(std::ostream &os) const {
+void TreeData::dumpHatchet(std::ostream &os,
+                           OutputFormat outputFormat) const {
   std::map<size_t, json *> jsonNodes;
   json output = json::array();
   output.push_back(json::object());
@@ -190,10 +244,15 @@ void TreeData::dumpHatchet(std::ostream &os) const {
         for (auto [metricKind, metric] : treeNode.metrics) {
           if (metricKind == MetricKind::Kernel) {
             auto kernelMetric = std::dynamic_pointer_cast<KernelMetric>(metric);
-            auto duration = std::get<uint64_t>(
-                kernelMetric->getValue(KernelMetric::Duration));
+            // The duration of the invocations that were not timed is
+            // estimated from the timed ones
+            auto duration = kernelMetric->getEstimatedDuration();
             auto invocations = std::get<uint64_t>(
                 kernelMetric->getValue(KernelMetric::Invocations));
+            auto samples = std::get<uint64_t>(
+                kernelMetric->getValue(KernelMetric::Samples));
+            auto overhead = std::get<uint64_t>(
+                kernelMetric->getValue(KernelMetric::Overhead));
             auto deviceId = std::get<uint64_t>(
                 kernelMetric->getValue(KernelMetric::DeviceId));
             auto deviceType = std::get<uint64_t>(
@@ -216,6 +275,21 @@ void TreeData::dumpHatchet(std::ostream &os) const {
                 kernelMetric->getValueName(KernelMetric::Duration));
             valueNames.insert(
                 kernelMetric->getValueName(KernelMetric::Invocations));
+            // Only reported when the profiler samples or measures itself
+            if (samples != invocations) {
+              (*jsonNode)["metrics"]
+                         [kernelMetric->getValueName(KernelMetric::Samples)] =
+                             samples;
+              valueNames.insert(
+                  kernelMetric->getValueName(KernelMetric::Samples));
+            }
+            if (overhead > 0) {
+              (*jsonNode)["metrics"]
+                         [kernelMetric->getValueName(KernelMetric::Overhead)] =
+                             overhead;
+              valueNames.insert(
+                  kernelMetric->getValueName(KernelMetric::Overhead));
+            }
             deviceIds.insert({deviceType, {deviceId}});
           } else {
             throw std::runtime_error("MetricKind not supported");
@@ -263,22 +337,47 @@ void TreeData::dumpHatchet(std::ostream &os) const {
           {"bus_width", device.busWidth},
           {"arch", device.arch},
           {"num_sms", device.numSms}};
+      if (device.numEus)
+        deviceJson[deviceTypeName][std::to_string(deviceId)]["num_eus"] =
+            device.numEus;
     }
   }
-  os << std::endl << output.dump(4) << std::endl;
+  if (outputFormat == OutputFormat::HatchetMsgPack)
+    json::to_msgpack(output, os);
+  else
+    os << std::endl << output.dump(4) << std::endl;
 }
 
 void TreeData::doDump(std::ostream &os, OutputFormat outputFormat) const {
-  std::shared_lock<std::shared_mutex> lock(mutex);
-  if (outputFormat == OutputFormat::Hatchet) {
-    dumpHatchet(os);
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  mergeMetricShards();
+  if (outputFormat == OutputFormat::Hatchet ||
+      outputFormat == OutputFormat::HatchetMsgPack) {
+    dumpHatchet(os, outputFormat);
   } else {
     std::logic_error("OutputFormat not supported");
   }
 }
 
+void TreeData::doFlush(std::ostream &os) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  mergeMetricShards();
+  dumpHatchet(os, OutputFormat::HatchetMsgPack);
+  // The context nodes are kept so that the next snapshots share the same
+  // tree, only their metrics are released.
+  tree->template walk<Tree::WalkPolicy::PreOrder>(
+      [](Tree::TreeNode &treeNode) {
+        treeNode.metrics.clear();
+        treeNode.flexibleMetrics.clear();
+      });
+  // The metrics of the scopes added before the previous flush have been
+  // received by now, as the profiler is flushed before the data.
+  flushedScopeIdToContextId = std::move(scopeIdToContextId);
+  scopeIdToContextId.clear();
+}
+
 TreeData::TreeData(const std::string &path, ContextSource *contextSource)
-    : Data(path, contextSource) {
+    : Data(path, contextSource), dataId(nextDataId++) {
   init();
 }
 
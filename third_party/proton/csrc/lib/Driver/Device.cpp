@@ -1,6 +1,7 @@
 #include "Driver/Device.h"
 #include "Driver/GPU/CudaApi.h"
 #include "Driver/GPU/HipApi.h"
+#include "Driver/GPU/XpuApi.h"
 
 #include "Utility/Errors.h"
 
@@ -13,6 +14,9 @@ Device getDevice(DeviceType type, uint64_t index) {
   if (type == DeviceType::HIP) {
     return hip::getDevice(index);
   }
+  if (type == DeviceType::XPU) {
+    return xpu::getDevice(index);
+  }
   throw std::runtime_error("DeviceType not supported");
 }
 
@@ -21,6 +25,8 @@ const std::string getDeviceTypeString(DeviceType type) {
     return DeviceTraits<DeviceType::CUDA>::name;
   } else if (type == DeviceType::HIP) {
     return DeviceTraits<DeviceType::HIP>::name;
+  } else if (type == DeviceType::XPU) {
+    return DeviceTraits<DeviceType::XPU>::name;
   }
   throw std::runtime_error("DeviceType not supported");
 }
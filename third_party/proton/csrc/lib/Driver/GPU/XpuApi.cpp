@@ -0,0 +1,251 @@
+#include "Driver/GPU/XpuApi.h"
+#include "Driver/Dispatch.h"
+
+#include <mutex>
+#include <string>
+
+namespace proton {
+
+namespace xpu {
+
+struct ExternLibLevelZero : public ExternLibBase {
+  using RetType = ze_result_t;
+  static constexpr const char *name = "libze_loader.so.1";
+  static constexpr const char *defaultDir = "";
+  static constexpr RetType success = ZE_RESULT_SUCCESS;
+  static void *lib;
+};
+
+void *ExternLibLevelZero::lib = nullptr;
+
+DEFINE_DISPATCH(ExternLibLevelZero, init, zeInit, ze_init_flags_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, driverGet, zeDriverGet, uint32_t *,
+                ze_driver_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, deviceGet, zeDeviceGet, ze_driver_handle_t,
+                uint32_t *, ze_device_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, deviceGetProperties, zeDeviceGetProperties,
+                ze_device_handle_t, ze_device_properties_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, deviceGetMemoryProperties,
+                zeDeviceGetMemoryProperties, ze_device_handle_t, uint32_t *,
+                ze_device_memory_properties_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, deviceGetGlobalTimestamps,
+                zeDeviceGetGlobalTimestamps, ze_device_handle_t, uint64_t *,
+                uint64_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, contextCreate, zeContextCreate,
+                ze_driver_handle_t, const ze_context_desc_t *,
+                ze_context_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, contextDestroy, zeContextDestroy,
+                ze_context_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventPoolCreate, zeEventPoolCreate,
+                ze_context_handle_t, const ze_event_pool_desc_t *, uint32_t,
+                ze_device_handle_t *, ze_event_pool_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventPoolDestroy, zeEventPoolDestroy,
+                ze_event_pool_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventCreate, zeEventCreate,
+                ze_event_pool_handle_t, const ze_event_desc_t *,
+                ze_event_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventDestroy, zeEventDestroy,
+                ze_event_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventHostSynchronize,
+                zeEventHostSynchronize, ze_event_handle_t, uint64_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventHostReset, zeEventHostReset,
+                ze_event_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, eventQueryKernelTimestamp,
+                zeEventQueryKernelTimestamp, ze_event_handle_t,
+                ze_kernel_timestamp_result_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, commandListAppendBarrier,
+                zeCommandListAppendBarrier, ze_command_list_handle_t,
+                ze_event_handle_t, uint32_t, ze_event_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, commandListGetContextHandle,
+                zeCommandListGetContextHandle, ze_command_list_handle_t,
+                ze_context_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, commandListGetDeviceHandle,
+                zeCommandListGetDeviceHandle, ze_command_list_handle_t,
+                ze_device_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, kernelGetName, zeKernelGetName,
+                ze_kernel_handle_t, size_t *, char *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, tracerExpCreate, zetTracerExpCreate,
+                ze_context_handle_t, const zet_tracer_exp_desc_t *,
+                zet_tracer_exp_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, tracerExpDestroy, zetTracerExpDestroy,
+                zet_tracer_exp_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, tracerExpSetPrologues,
+                zetTracerExpSetPrologues, zet_tracer_exp_handle_t,
+                zet_core_callbacks_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, tracerExpSetEpilogues,
+                zetTracerExpSetEpilogues, zet_tracer_exp_handle_t,
+                zet_core_callbacks_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, tracerExpSetEnabled,
+                zetTracerExpSetEnabled, zet_tracer_exp_handle_t, ze_bool_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricGroupGet, zetMetricGroupGet,
+                ze_device_handle_t, uint32_t *, zet_metric_group_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricGroupGetProperties,
+                zetMetricGroupGetProperties, zet_metric_group_handle_t,
+                zet_metric_group_properties_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricGet, zetMetricGet,
+                zet_metric_group_handle_t, uint32_t *, zet_metric_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricGetProperties,
+                zetMetricGetProperties, zet_metric_handle_t,
+                zet_metric_properties_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricGroupCalculateMetricValues,
+                zetMetricGroupCalculateMetricValues, zet_metric_group_handle_t,
+                zet_metric_group_calculation_type_t, size_t, const uint8_t *,
+                uint32_t *, zet_typed_value_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, contextActivateMetricGroups,
+                zetContextActivateMetricGroups, ze_context_handle_t,
+                ze_device_handle_t, uint32_t, zet_metric_group_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryPoolCreate,
+                zetMetricQueryPoolCreate, ze_context_handle_t,
+                ze_device_handle_t, zet_metric_group_handle_t,
+                const zet_metric_query_pool_desc_t *,
+                zet_metric_query_pool_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryPoolDestroy,
+                zetMetricQueryPoolDestroy, zet_metric_query_pool_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryCreate, zetMetricQueryCreate,
+                zet_metric_query_pool_handle_t, uint32_t,
+                zet_metric_query_handle_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryDestroy, zetMetricQueryDestroy,
+                zet_metric_query_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryReset, zetMetricQueryReset,
+                zet_metric_query_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, metricQueryGetData, zetMetricQueryGetData,
+                zet_metric_query_handle_t, size_t *, uint8_t *)
+
+DEFINE_DISPATCH(ExternLibLevelZero, commandListAppendMetricQueryBegin,
+                zetCommandListAppendMetricQueryBegin,
+                zet_command_list_handle_t, zet_metric_query_handle_t)
+
+DEFINE_DISPATCH(ExternLibLevelZero, commandListAppendMetricQueryEnd,
+                zetCommandListAppendMetricQueryEnd, zet_command_list_handle_t,
+                zet_metric_query_handle_t, ze_event_handle_t, uint32_t,
+                ze_event_handle_t *)
+
+bool enableTracingLayer() {
+  typedef ze_result_t (*zelEnableTracingLayer_t)();
+  static zelEnableTracingLayer_t func = nullptr;
+  Dispatch<ExternLibLevelZero>::init(ExternLibLevelZero::name,
+                                     &ExternLibLevelZero::lib);
+  if (func == nullptr)
+    func = reinterpret_cast<zelEnableTracingLayer_t>(
+        dlsym(ExternLibLevelZero::lib, "zelEnableTracingLayer"));
+  if (func == nullptr)
+    return false;
+  return func() == ZE_RESULT_SUCCESS;
+}
+
+const std::vector<ze_device_handle_t> &getDevices() {
+  static std::vector<ze_device_handle_t> devices;
+  static std::once_flag devicesFlag;
+  std::call_once(devicesFlag, []() {
+    xpu::init<true>(ZE_INIT_FLAG_GPU_ONLY);
+    uint32_t driverCount = 0;
+    xpu::driverGet<true>(&driverCount, nullptr);
+    if (driverCount == 0)
+      return;
+    std::vector<ze_driver_handle_t> drivers(driverCount);
+    xpu::driverGet<true>(&driverCount, drivers.data());
+    uint32_t deviceCount = 0;
+    xpu::deviceGet<true>(drivers[0], &deviceCount, nullptr);
+    devices.resize(deviceCount);
+    xpu::deviceGet<true>(drivers[0], &deviceCount, devices.data());
+  });
+  return devices;
+}
+
+uint64_t getDeviceIndex(ze_device_handle_t device) {
+  const auto &devices = getDevices();
+  for (uint64_t i = 0; i < devices.size(); ++i) {
+    if (devices[i] == device)
+      return i;
+  }
+  return 0;
+}
+
+Device getDevice(uint64_t index) {
+  const auto &devices = getDevices();
+  if (index >= devices.size())
+    throw std::runtime_error("XPU device " + std::to_string(index) +
+                             " not found");
+  ze_device_handle_t device = devices[index];
+
+  ze_device_ip_version_ext_t ipVersion{};
+  ipVersion.stype = ZE_STRUCTURE_TYPE_DEVICE_IP_VERSION_EXT;
+  ze_device_properties_t properties{};
+  properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  properties.pNext = &ipVersion;
+  xpu::deviceGetProperties<true>(device, &properties);
+  // coreClockRate is reported in MHz
+  uint64_t clockRate = static_cast<uint64_t>(properties.coreClockRate) * 1000;
+  // Xe-cores play the role of SMs.
+  uint64_t numSms = static_cast<uint64_t>(properties.numSlices) *
+                    properties.numSubslicesPerSlice;
+  uint64_t numEus = numSms * properties.numEUsPerSubslice;
+
+  // The memory with the highest bandwidth, e.g. the HBM of each stack of a
+  // Data Center GPU Max.
+  uint32_t memoryCount = 0;
+  xpu::deviceGetMemoryProperties<true>(device, &memoryCount, nullptr);
+  std::vector<ze_device_memory_properties_t> memories(memoryCount);
+  for (auto &memory : memories)
+    memory.stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES;
+  xpu::deviceGetMemoryProperties<true>(device, &memoryCount, memories.data());
+  uint64_t memoryClockRate = 0;
+  uint64_t busWidth = 0;
+  for (const auto &memory : memories) {
+    if (static_cast<uint64_t>(memory.maxClockRate) * memory.maxBusWidth >
+        memoryClockRate * busWidth) {
+      // maxClockRate is the data rate in MHz, while the memory clock rate of
+      // the other devices is the clock of a double data rate memory in khz.
+      memoryClockRate = static_cast<uint64_t>(memory.maxClockRate) * 1000 / 2;
+      busWidth = memory.maxBusWidth;
+    }
+  }
+
+  // The architecture is the `<major>.<minor>` IP version of the device, e.g.
+  // 12.60 for PVC.
+  uint32_t version = ipVersion.ipVersion;
+  std::string arch = std::to_string(version >> 22) + "." +
+                     std::to_string((version >> 14) & 0xff);
+
+  return Device(DeviceType::XPU, index, clockRate, memoryClockRate, busWidth,
+                numSms, arch, numEus);
+}
+
+} // namespace xpu
+
+} // namespace proton
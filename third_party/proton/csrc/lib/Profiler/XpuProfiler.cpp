@@ -0,0 +1,778 @@
+#include "Profiler/XpuProfiler.h"
+#include "Context/Context.h"
+#include "Data/Metric.h"
+#include "Driver/Device.h"
+#include "Driver/GPU/XpuApi.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proton {
+
+template <>
+thread_local GPUProfiler<XpuProfiler>::ThreadState
+    GPUProfiler<XpuProfiler>::threadState(XpuProfiler::instance());
+
+template <>
+thread_local std::deque<size_t>
+    GPUProfiler<XpuProfiler>::Correlation::externIdQueue{};
+
+namespace {
+
+/// A kernel launch intercepted by the tracer.
+/// The launch signals a profiler-owned timestamp event which is read back when
+/// the kernel completes.
+struct KernelLaunch {
+  uint64_t correlationId{};
+  std::string kernelName{};
+  ze_context_handle_t context{};
+  ze_device_handle_t device{};
+  ze_event_handle_t event{};
+  // The event passed by the application, if any.
+  ze_event_handle_t signalEvent{};
+  // The hardware counter queries around the kernel, one per metric group.
+  std::vector<zet_metric_query_handle_t> queries{};
+  // Signaled when the queries have ended.
+  ze_event_handle_t queryEvent{};
+  // Whether the launch is timed, otherwise it is only counted.
+  bool timed{true};
+  // The host time spent by the profiler on the launch.
+  uint64_t overhead{};
+};
+
+uint64_t getHostTime() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Host-visible kernel timestamp events for a single Level Zero context.
+/// Events are never destroyed while profiling; they are reset and recycled.
+class TimestampEventPool {
+public:
+  explicit TimestampEventPool(ze_context_handle_t context) : context(context) {}
+
+  ~TimestampEventPool() {
+    // The application may have already destroyed the context at exit, so we
+    // don't check the return values here.
+    for (auto event : events)
+      xpu::eventDestroy<false>(event);
+    for (auto pool : pools)
+      xpu::eventPoolDestroy<false>(pool);
+  }
+
+  ze_event_handle_t acquire() {
+    if (freeEvents.empty())
+      grow();
+    auto event = freeEvents.back();
+    freeEvents.pop_back();
+    return event;
+  }
+
+  void release(ze_event_handle_t event) {
+    xpu::eventHostReset<false>(event);
+    freeEvents.push_back(event);
+  }
+
+private:
+  void grow() {
+    ze_event_pool_desc_t poolDesc{};
+    poolDesc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+    poolDesc.flags =
+        ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP | ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+    poolDesc.count = EventsPerPool;
+    ze_event_pool_handle_t pool;
+    xpu::eventPoolCreate<true>(context, &poolDesc, 0, nullptr, &pool);
+    pools.push_back(pool);
+    for (uint32_t i = 0; i < EventsPerPool; ++i) {
+      ze_event_desc_t eventDesc{};
+      eventDesc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+      eventDesc.index = i;
+      eventDesc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+      eventDesc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+      ze_event_handle_t event;
+      xpu::eventCreate<true>(pool, &eventDesc, &event);
+      events.push_back(event);
+      freeEvents.push_back(event);
+    }
+  }
+
+  static constexpr uint32_t EventsPerPool = 1024;
+
+  ze_context_handle_t context;
+  std::vector<ze_event_pool_handle_t> pools;
+  std::vector<ze_event_handle_t> events;
+  std::vector<ze_event_handle_t> freeEvents;
+};
+
+/// Converts device kernel timestamps to host nanoseconds.
+struct DeviceClock {
+  uint64_t timerResolution{}; // ns per tick
+  uint64_t timestampMask{};
+  uint64_t hostTimestamp{};   // ns
+  uint64_t deviceTimestamp{}; // ticks
+
+  DeviceClock() = default;
+
+  explicit DeviceClock(ze_device_handle_t device) {
+    ze_device_properties_t properties{};
+    properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+    xpu::deviceGetProperties<true>(device, &properties);
+    timerResolution = properties.timerResolution;
+    timestampMask = properties.kernelTimestampValidBits >= 64
+                        ? std::numeric_limits<uint64_t>::max()
+                        : (1ull << properties.kernelTimestampValidBits) - 1;
+    xpu::deviceGetGlobalTimestamps<true>(device, &hostTimestamp,
+                                         &deviceTimestamp);
+  }
+
+  uint64_t toHostTime(uint64_t ticks) const {
+    auto elapsed = (ticks - deviceTimestamp) & timestampMask;
+    return hostTimestamp + elapsed * timerResolution;
+  }
+
+  uint64_t toDuration(uint64_t startTicks, uint64_t endTicks) const {
+    return ((endTicks - startTicks) & timestampMask) * timerResolution;
+  }
+};
+
+std::string getKernelName(ze_kernel_handle_t kernel) {
+  size_t size = 0;
+  if (xpu::kernelGetName<false>(kernel, &size, nullptr) != ZE_RESULT_SUCCESS)
+    return {};
+  std::string name(size, '\0');
+  xpu::kernelGetName<false>(kernel, &size, name.data());
+  // size includes the terminating null character
+  name.resize(size > 0 ? size - 1 : 0);
+  return name;
+}
+
+/// A Level Zero metric group whose hardware counters are sampled around each
+/// kernel launch with a metric query.
+struct MetricGroup {
+  struct MetricInfo {
+    std::string name;
+    // Counts and durations are summed over the launches of a scope, while
+    // ratios and throughputs are reported for the last launch.
+    bool aggregable;
+  };
+
+  zet_metric_group_handle_t handle{};
+  std::vector<MetricInfo> metrics;
+};
+
+/// Find the event based metric group named `name` on the device.
+std::optional<MetricGroup> findMetricGroup(ze_device_handle_t device,
+                                           const std::string &name) {
+  uint32_t groupCount = 0;
+  xpu::metricGroupGet<true>(device, &groupCount, nullptr);
+  std::vector<zet_metric_group_handle_t> groups(groupCount);
+  xpu::metricGroupGet<true>(device, &groupCount, groups.data());
+  for (auto group : groups) {
+    zet_metric_group_properties_t groupProperties{};
+    groupProperties.stype = ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES;
+    xpu::metricGroupGetProperties<true>(group, &groupProperties);
+    if (name != groupProperties.name ||
+        !(groupProperties.samplingType &
+          ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_EVENT_BASED))
+      continue;
+    MetricGroup metricGroup;
+    metricGroup.handle = group;
+    uint32_t metricCount = groupProperties.metricCount;
+    std::vector<zet_metric_handle_t> metrics(metricCount);
+    xpu::metricGet<true>(group, &metricCount, metrics.data());
+    for (auto metric : metrics) {
+      zet_metric_properties_t properties{};
+      properties.stype = ZET_STRUCTURE_TYPE_METRIC_PROPERTIES;
+      xpu::metricGetProperties<true>(metric, &properties);
+      std::string metricName = properties.name;
+      if (properties.resultUnits[0] != '\0')
+        metricName += std::string(" (") + properties.resultUnits + ")";
+      bool aggregable = properties.metricType == ZET_METRIC_TYPE_DURATION ||
+                        properties.metricType == ZET_METRIC_TYPE_EVENT ||
+                        properties.metricType ==
+                            ZET_METRIC_TYPE_EVENT_WITH_RANGE;
+      metricGroup.metrics.push_back({metricName, aggregable});
+    }
+    return metricGroup;
+  }
+  return std::nullopt;
+}
+
+/// Metric queries of a metric group for a single Level Zero context and
+/// device. Like timestamp events, queries are reset and recycled.
+class MetricQueryPool {
+public:
+  MetricQueryPool(ze_context_handle_t context, ze_device_handle_t device,
+                  zet_metric_group_handle_t metricGroup)
+      : context(context), device(device), metricGroup(metricGroup) {}
+
+  ~MetricQueryPool() {
+    for (auto query : queries)
+      xpu::metricQueryDestroy<false>(query);
+    for (auto pool : pools)
+      xpu::metricQueryPoolDestroy<false>(pool);
+  }
+
+  zet_metric_query_handle_t acquire() {
+    if (freeQueries.empty())
+      grow();
+    auto query = freeQueries.back();
+    freeQueries.pop_back();
+    return query;
+  }
+
+  void release(zet_metric_query_handle_t query) {
+    xpu::metricQueryReset<false>(query);
+    freeQueries.push_back(query);
+  }
+
+private:
+  void grow() {
+    zet_metric_query_pool_desc_t poolDesc{};
+    poolDesc.stype = ZET_STRUCTURE_TYPE_METRIC_QUERY_POOL_DESC;
+    poolDesc.type = ZET_METRIC_QUERY_POOL_TYPE_PERFORMANCE;
+    poolDesc.count = QueriesPerPool;
+    zet_metric_query_pool_handle_t pool;
+    xpu::metricQueryPoolCreate<true>(context, device, metricGroup, &poolDesc,
+                                     &pool);
+    pools.push_back(pool);
+    for (uint32_t i = 0; i < QueriesPerPool; ++i) {
+      zet_metric_query_handle_t query;
+      xpu::metricQueryCreate<true>(pool, i, &query);
+      queries.push_back(query);
+      freeQueries.push_back(query);
+    }
+  }
+
+  static constexpr uint32_t QueriesPerPool = 256;
+
+  ze_context_handle_t context;
+  ze_device_handle_t device;
+  zet_metric_group_handle_t metricGroup;
+  std::vector<zet_metric_query_pool_handle_t> pools;
+  std::vector<zet_metric_query_handle_t> queries;
+  std::vector<zet_metric_query_handle_t> freeQueries;
+};
+
+MetricValueType toMetricValue(const zet_typed_value_t &value) {
+  switch (value.type) {
+  case ZET_VALUE_TYPE_UINT32:
+    return static_cast<uint64_t>(value.value.ui32);
+  case ZET_VALUE_TYPE_UINT64:
+    return static_cast<uint64_t>(value.value.ui64);
+  case ZET_VALUE_TYPE_FLOAT32:
+    return static_cast<double>(value.value.fp32);
+  case ZET_VALUE_TYPE_FLOAT64:
+    return value.value.fp64;
+  case ZET_VALUE_TYPE_BOOL8:
+    return static_cast<uint64_t>(value.value.b8);
+  default:
+    return static_cast<uint64_t>(0);
+  }
+}
+
+/// Parse the comma separated metric group names of `PROTON_XPU_METRICS`.
+std::vector<std::string> getMetricGroupNames() {
+  std::vector<std::string> names;
+  const char *env = std::getenv("PROTON_XPU_METRICS");
+  if (env == nullptr)
+    return names;
+  std::stringstream stream(env);
+  std::string name;
+  while (std::getline(stream, name, ','))
+    if (!name.empty())
+      names.push_back(name);
+  return names;
+}
+
+} // namespace
+
+struct XpuProfiler::XpuProfilerPimpl
+    : public GPUProfiler<XpuProfiler>::GPUProfilerPimplInterface {
+  XpuProfilerPimpl(XpuProfiler &profiler)
+      : GPUProfiler<XpuProfiler>::GPUProfilerPimplInterface(profiler) {}
+  virtual ~XpuProfilerPimpl() = default;
+
+  void doStart() override;
+  void doFlush() override;
+  void doStop() override;
+
+  template <typename ParamsT>
+  static void launchPrologue(ParamsT *params, ze_result_t result,
+                             void *globalUserData, void **instanceUserData);
+  template <typename ParamsT>
+  static void launchEpilogue(ParamsT *params, ze_result_t result,
+                             void *globalUserData, void **instanceUserData);
+
+  ze_event_handle_t acquireEvent(ze_context_handle_t context);
+  void releaseEvent(const KernelLaunch &launch);
+  const std::vector<MetricGroup> &getMetricGroups(ze_device_handle_t device);
+  /// Begin the hardware counter queries of the launch, if metrics are
+  /// collected on its device.
+  void beginMetricQueries(KernelLaunch &launch,
+                          ze_command_list_handle_t commandList);
+  /// Read the hardware counters of a completed launch.
+  /// Returns the aggregable metrics and the other metrics.
+  std::pair<std::map<std::string, MetricValueType>,
+            std::map<std::string, MetricValueType>>
+  readMetricQueries(const KernelLaunch &launch);
+  /// Whether the next launch of `kernelName` is timed.
+  bool sampleLaunch(const std::string &kernelName);
+  void submitLaunch(std::unique_ptr<KernelLaunch> launch);
+  /// Read back the timestamps of completed launches.
+  /// If `wait` is true, block until all submitted launches have completed.
+  void processLaunches(bool wait);
+  void processLaunch(const KernelLaunch &launch,
+                     const ze_kernel_timestamp_result_t &timestamp);
+  /// Attribute the metrics of a launch to its scope in every data.
+  void addLaunchMetrics(
+      const KernelLaunch &launch, std::shared_ptr<Metric> metric,
+      const std::map<std::string, MetricValueType> &aggregableMetrics = {},
+      const std::map<std::string, MetricValueType> &otherMetrics = {});
+  const DeviceClock &getDeviceClock(ze_device_handle_t device);
+
+  // Completed launches are read back from the application thread once this
+  // many launches are outstanding, so that events are recycled.
+  static constexpr size_t MaxPendingLaunches = 256;
+
+  std::atomic<uint64_t> nextCorrelationId{1};
+
+  ze_context_handle_t tracerContext{};
+  zet_tracer_exp_handle_t tracer{};
+
+  std::mutex mutex;
+  std::unordered_map<ze_context_handle_t, std::unique_ptr<TimestampEventPool>>
+      eventPools;
+  std::unordered_map<ze_device_handle_t, DeviceClock> deviceClocks;
+  std::deque<std::unique_ptr<KernelLaunch>> pendingLaunches;
+
+  struct KernelSamplingState {
+    // Launches since the last timed launch.
+    uint64_t launches{};
+    uint64_t lastTimedTime{};
+  };
+  std::mutex samplingMutex;
+  std::unordered_map<std::string, KernelSamplingState> samplingStates;
+
+  // The metric groups sampled on every launch, from `PROTON_XPU_METRICS`.
+  // Groups of different domains can be collected at the same time.
+  std::vector<std::string> metricGroupNames;
+  std::atomic<bool> collectMetrics{false};
+  std::unordered_map<ze_device_handle_t, std::vector<MetricGroup>>
+      metricGroups;
+  std::map<std::pair<ze_context_handle_t, ze_device_handle_t>,
+           std::vector<std::unique_ptr<MetricQueryPool>>>
+      metricQueryPools;
+};
+
+ze_event_handle_t
+XpuProfiler::XpuProfilerPimpl::acquireEvent(ze_context_handle_t context) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &pool = eventPools[context];
+  if (!pool)
+    pool = std::make_unique<TimestampEventPool>(context);
+  return pool->acquire();
+}
+
+void XpuProfiler::XpuProfilerPimpl::releaseEvent(const KernelLaunch &launch) {
+  std::lock_guard<std::mutex> lock(mutex);
+  eventPools[launch.context]->release(launch.event);
+  if (launch.queryEvent)
+    eventPools[launch.context]->release(launch.queryEvent);
+  if (launch.queries.empty())
+    return;
+  auto &queryPools = metricQueryPools[{launch.context, launch.device}];
+  for (size_t i = 0; i < launch.queries.size(); ++i)
+    queryPools[i]->release(launch.queries[i]);
+}
+
+const std::vector<MetricGroup> &
+XpuProfiler::XpuProfilerPimpl::getMetricGroups(ze_device_handle_t device) {
+  // The caller holds the lock
+  auto it = metricGroups.find(device);
+  if (it != metricGroups.end())
+    return it->second;
+  std::vector<MetricGroup> groups;
+  for (auto &name : metricGroupNames) {
+    if (auto group = findMetricGroup(device, name)) {
+      groups.push_back(std::move(*group));
+    } else {
+      std::cerr << "[PROTON] The event based metric group " << name
+                << " is not available on the XPU device. Please make sure "
+                   "ZET_ENABLE_METRICS=1 is set before the XPU runtime is "
+                   "initialized."
+                << std::endl;
+    }
+  }
+  return metricGroups.emplace(device, std::move(groups)).first->second;
+}
+
+void XpuProfiler::XpuProfilerPimpl::beginMetricQueries(
+    KernelLaunch &launch, ze_command_list_handle_t commandList) {
+  if (!collectMetrics)
+    return;
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto &groups = getMetricGroups(launch.device);
+  if (groups.empty())
+    return;
+  auto &queryPools = metricQueryPools[{launch.context, launch.device}];
+  if (queryPools.empty()) {
+    std::vector<zet_metric_group_handle_t> handles;
+    for (auto &group : groups)
+      handles.push_back(group.handle);
+    // The groups have to be activated before the command list executes
+    if (xpu::contextActivateMetricGroups<false>(
+            launch.context, launch.device, handles.size(), handles.data()) !=
+        ZE_RESULT_SUCCESS) {
+      std::cerr << "[PROTON] Failed to activate the XPU metric groups"
+                << std::endl;
+      collectMetrics = false;
+      return;
+    }
+    for (auto &group : groups)
+      queryPools.push_back(std::make_unique<MetricQueryPool>(
+          launch.context, launch.device, group.handle));
+  }
+  for (auto &queryPool : queryPools) {
+    auto query = queryPool->acquire();
+    launch.queries.push_back(query);
+    xpu::commandListAppendMetricQueryBegin<true>(commandList, query);
+  }
+  launch.queryEvent = eventPools[launch.context]->acquire();
+}
+
+std::pair<std::map<std::string, MetricValueType>,
+          std::map<std::string, MetricValueType>>
+XpuProfiler::XpuProfilerPimpl::readMetricQueries(const KernelLaunch &launch) {
+  std::map<std::string, MetricValueType> aggregableMetrics, otherMetrics;
+  if (launch.queries.empty())
+    return {aggregableMetrics, otherMetrics};
+  // The groups of a device are not modified until the profiler stops
+  const std::vector<MetricGroup> *groups = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    groups = &getMetricGroups(launch.device);
+  }
+  for (size_t i = 0; i < launch.queries.size(); ++i) {
+    const auto &group = (*groups)[i];
+    size_t rawDataSize = 0;
+    if (xpu::metricQueryGetData<false>(launch.queries[i], &rawDataSize,
+                                       nullptr) != ZE_RESULT_SUCCESS)
+      continue;
+    std::vector<uint8_t> rawData(rawDataSize);
+    xpu::metricQueryGetData<false>(launch.queries[i], &rawDataSize,
+                                   rawData.data());
+    uint32_t valueCount = 0;
+    xpu::metricGroupCalculateMetricValues<false>(
+        group.handle, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+        rawDataSize, rawData.data(), &valueCount, nullptr);
+    std::vector<zet_typed_value_t> values(valueCount);
+    if (xpu::metricGroupCalculateMetricValues<false>(
+            group.handle, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+            rawDataSize, rawData.data(), &valueCount, values.data()) !=
+        ZE_RESULT_SUCCESS)
+      continue;
+    // A query yields a single report of all the metrics of the group
+    for (size_t j = 0; j < group.metrics.size() && j < valueCount; ++j) {
+      auto &metric = group.metrics[j];
+      auto &metrics = metric.aggregable ? aggregableMetrics : otherMetrics;
+      metrics[metric.name] = toMetricValue(values[j]);
+    }
+  }
+  return {aggregableMetrics, otherMetrics};
+}
+
+bool XpuProfiler::XpuProfilerPimpl::sampleLaunch(
+    const std::string &kernelName) {
+  SamplingConfig sampling = profiler.getSampling();
+  if (!sampling.isEnabled())
+    return true;
+  auto now = getHostTime();
+  std::lock_guard<std::mutex> lock(samplingMutex);
+  auto [it, inserted] = samplingStates.try_emplace(kernelName);
+  auto &state = it->second;
+  // The first launch of a kernel is always timed
+  bool timed = inserted || ++state.launches >= sampling.launchInterval ||
+               (sampling.periodNs != 0 &&
+                now - state.lastTimedTime >= sampling.periodNs);
+  if (timed) {
+    state.launches = 0;
+    state.lastTimedTime = now;
+  }
+  return timed;
+}
+
+const DeviceClock &
+XpuProfiler::XpuProfilerPimpl::getDeviceClock(ze_device_handle_t device) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = deviceClocks.find(device);
+  if (it == deviceClocks.end())
+    it = deviceClocks.emplace(device, DeviceClock(device)).first;
+  return it->second;
+}
+
+template <typename ParamsT>
+void XpuProfiler::XpuProfilerPimpl::launchPrologue(ParamsT *params,
+                                                   ze_result_t result,
+                                                   void *globalUserData,
+                                                   void **instanceUserData) {
+  *instanceUserData = nullptr;
+  auto startTime = getHostTime();
+  auto &profiler = threadState.profiler;
+  auto *pImpl = dynamic_cast<XpuProfilerPimpl *>(profiler.pImpl.get());
+  auto commandList = *params->phCommandList;
+
+  auto launch = std::make_unique<KernelLaunch>();
+  if (xpu::commandListGetContextHandle<false>(commandList, &launch->context) !=
+          ZE_RESULT_SUCCESS ||
+      xpu::commandListGetDeviceHandle<false>(commandList, &launch->device) !=
+          ZE_RESULT_SUCCESS)
+    return;
+  // Make sure the clock is synchronized before the kernel starts.
+  pImpl->getDeviceClock(launch->device);
+  launch->correlationId = pImpl->nextCorrelationId++;
+  launch->kernelName = getKernelName(*params->phKernel);
+  launch->timed = pImpl->sampleLaunch(launch->kernelName);
+  if (launch->timed) {
+    launch->event = pImpl->acquireEvent(launch->context);
+    pImpl->beginMetricQueries(*launch, commandList);
+    // Redirect the launch to our timestamp event. The application's event,
+    // if any, is signaled by a barrier in the epilogue.
+    launch->signalEvent = *params->phSignalEvent;
+    *params->phSignalEvent = launch->event;
+  }
+
+  auto scopeId = Scope::getNewScopeId();
+  threadState.record(scopeId);
+  threadState.enterOp(scopeId);
+  profiler.correlation.correlate(launch->correlationId);
+  launch->overhead = getHostTime() - startTime;
+  *instanceUserData = launch.release();
+}
+
+template <typename ParamsT>
+void XpuProfiler::XpuProfilerPimpl::launchEpilogue(ParamsT *params,
+                                                   ze_result_t result,
+                                                   void *globalUserData,
+                                                   void **instanceUserData) {
+  std::unique_ptr<KernelLaunch> launch(
+      static_cast<KernelLaunch *>(*instanceUserData));
+  if (!launch)
+    return;
+  auto startTime = getHostTime();
+  auto &profiler = threadState.profiler;
+  auto *pImpl = dynamic_cast<XpuProfilerPimpl *>(profiler.pImpl.get());
+  threadState.exitOp();
+  if (!launch->timed) {
+    // The launch is only counted, there is nothing to wait for
+    if (result == ZE_RESULT_SUCCESS) {
+      launch->overhead += getHostTime() - startTime;
+      auto metric = KernelMetric::makeUntimed(
+          1, xpu::getDeviceIndex(launch->device),
+          static_cast<uint64_t>(DeviceType::XPU));
+      metric->setOverhead(launch->overhead);
+      pImpl->addLaunchMetrics(*launch, metric);
+    } else {
+      profiler.correlation.corrIdToExternId.erase(launch->correlationId);
+    }
+    return;
+  }
+  *params->phSignalEvent = launch->signalEvent;
+  if (result != ZE_RESULT_SUCCESS) {
+    profiler.correlation.corrIdToExternId.erase(launch->correlationId);
+    pImpl->releaseEvent(*launch);
+    return;
+  }
+  for (auto query : launch->queries) {
+    // Only the last query signals, the queries end in order
+    auto signalEvent =
+        query == launch->queries.back() ? launch->queryEvent : nullptr;
+    xpu::commandListAppendMetricQueryEnd<true>(*params->phCommandList, query,
+                                               signalEvent, 0, nullptr);
+  }
+  if (launch->signalEvent) {
+    xpu::commandListAppendBarrier<true>(*params->phCommandList,
+                                        launch->signalEvent, 1, &launch->event);
+  }
+  profiler.correlation.submit(launch->correlationId);
+  launch->overhead += getHostTime() - startTime;
+  pImpl->submitLaunch(std::move(launch));
+}
+
+void XpuProfiler::XpuProfilerPimpl::submitLaunch(
+    std::unique_ptr<KernelLaunch> launch) {
+  size_t numPending = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingLaunches.push_back(std::move(launch));
+    numPending = pendingLaunches.size();
+  }
+  if (numPending >= MaxPendingLaunches)
+    processLaunches(/*wait=*/false);
+}
+
+void XpuProfiler::XpuProfilerPimpl::processLaunch(
+    const KernelLaunch &launch, const ze_kernel_timestamp_result_t &timestamp) {
+  auto processStartTime = getHostTime();
+  const auto &clock = getDeviceClock(launch.device);
+  auto startTime = clock.toHostTime(timestamp.global.kernelStart);
+  auto endTime = startTime + clock.toDuration(timestamp.global.kernelStart,
+                                              timestamp.global.kernelEnd);
+  auto [aggregableMetrics, otherMetrics] = readMetricQueries(launch);
+  std::shared_ptr<KernelMetric> metric;
+  if (startTime < endTime) {
+    metric = std::make_shared<KernelMetric>(
+        startTime, endTime, 1, xpu::getDeviceIndex(launch.device),
+        static_cast<uint64_t>(DeviceType::XPU));
+    metric->setOverhead(launch.overhead + getHostTime() - processStartTime);
+  }
+  addLaunchMetrics(launch, metric, aggregableMetrics, otherMetrics);
+}
+
+void XpuProfiler::XpuProfilerPimpl::addLaunchMetrics(
+    const KernelLaunch &launch, std::shared_ptr<Metric> metric,
+    const std::map<std::string, MetricValueType> &aggregableMetrics,
+    const std::map<std::string, MetricValueType> &otherMetrics) {
+  auto &corrIdToExternId = profiler.correlation.corrIdToExternId;
+  auto &apiExternIds = profiler.correlation.apiExternIds;
+  auto correlationId = launch.correlationId;
+  if (/*Not a valid context*/ !corrIdToExternId.contain(correlationId))
+    return;
+  auto parentId = corrIdToExternId.at(correlationId).first;
+  for (auto *data : profiler.dataSet) {
+    auto scopeId = parentId;
+    if (apiExternIds.contain(scopeId)) {
+      // It's triggered by a SYCL/Level Zero op but not triton op
+      scopeId = data->addScope(parentId, launch.kernelName);
+    }
+    // The counters are attached to the scope before its kernel metric
+    if (!aggregableMetrics.empty())
+      data->addMetrics(scopeId, aggregableMetrics, /*aggregable=*/true);
+    if (!otherMetrics.empty())
+      data->addMetrics(scopeId, otherMetrics, /*aggregable=*/false);
+    if (metric)
+      data->addMetric(scopeId, metric);
+  }
+  apiExternIds.erase(parentId);
+  corrIdToExternId.erase(correlationId);
+}
+
+void XpuProfiler::XpuProfilerPimpl::processLaunches(bool wait) {
+  std::deque<std::unique_ptr<KernelLaunch>> completedLaunches;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto timeout = wait ? std::numeric_limits<uint64_t>::max() : 0;
+    auto it = pendingLaunches.begin();
+    while (it != pendingLaunches.end()) {
+      auto &launch = *it;
+      if (xpu::eventHostSynchronize<false>(launch->event, timeout) ==
+              ZE_RESULT_SUCCESS &&
+          (!launch->queryEvent ||
+           xpu::eventHostSynchronize<false>(launch->queryEvent, timeout) ==
+               ZE_RESULT_SUCCESS)) {
+        completedLaunches.push_back(std::move(*it));
+        it = pendingLaunches.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  uint64_t maxCorrelationId = 0;
+  for (auto &launch : completedLaunches) {
+    ze_kernel_timestamp_result_t timestamp{};
+    if (xpu::eventQueryKernelTimestamp<false>(launch->event, &timestamp) ==
+        ZE_RESULT_SUCCESS)
+      processLaunch(*launch, timestamp);
+    releaseEvent(*launch);
+    maxCorrelationId = std::max(maxCorrelationId, launch->correlationId);
+  }
+  profiler.correlation.complete(maxCorrelationId);
+}
+
+void XpuProfiler::XpuProfilerPimpl::doStart() {
+  if (!xpu::enableTracingLayer() && !std::getenv("ZE_ENABLE_TRACING_LAYER")) {
+    std::cerr << "[PROTON] The Level Zero tracing layer is not available. "
+                 "Please set ZE_ENABLE_TRACING_LAYER=1 before the XPU runtime "
+                 "is initialized."
+              << std::endl;
+  }
+  metricGroupNames = getMetricGroupNames();
+  collectMetrics = !metricGroupNames.empty();
+  xpu::init<true>(ZE_INIT_FLAG_GPU_ONLY);
+  uint32_t driverCount = 1;
+  ze_driver_handle_t driver;
+  xpu::driverGet<true>(&driverCount, &driver);
+  ze_context_desc_t contextDesc{};
+  contextDesc.stype = ZE_STRUCTURE_TYPE_CONTEXT_DESC;
+  xpu::contextCreate<true>(driver, &contextDesc, &tracerContext);
+
+  zet_tracer_exp_desc_t tracerDesc{};
+  tracerDesc.stype = ZET_STRUCTURE_TYPE_TRACER_EXP_DESC;
+  tracerDesc.pUserData = this;
+  xpu::tracerExpCreate<true>(tracerContext, &tracerDesc, &tracer);
+
+  zet_core_callbacks_t prologues{};
+  prologues.CommandList.pfnAppendLaunchKernelCb =
+      launchPrologue<ze_command_list_append_launch_kernel_params_t>;
+  prologues.CommandList.pfnAppendLaunchCooperativeKernelCb =
+      launchPrologue<ze_command_list_append_launch_cooperative_kernel_params_t>;
+  zet_core_callbacks_t epilogues{};
+  epilogues.CommandList.pfnAppendLaunchKernelCb =
+      launchEpilogue<ze_command_list_append_launch_kernel_params_t>;
+  epilogues.CommandList.pfnAppendLaunchCooperativeKernelCb =
+      launchEpilogue<ze_command_list_append_launch_cooperative_kernel_params_t>;
+  xpu::tracerExpSetPrologues<true>(tracer, &prologues);
+  xpu::tracerExpSetEpilogues<true>(tracer, &epilogues);
+  xpu::tracerExpSetEnabled<true>(tracer, true);
+}
+
+void XpuProfiler::XpuProfilerPimpl::doFlush() {
+  // Waiting on the timestamp events is equivalent to synchronizing the
+  // devices for all kernels launched while profiling.
+  processLaunches(/*wait=*/true);
+  profiler.correlation.flush(
+      /*maxRetries=*/100, /*sleepMs=*/10,
+      /*flush=*/[this]() { processLaunches(/*wait=*/false); });
+}
+
+void XpuProfiler::XpuProfilerPimpl::doStop() {
+  xpu::tracerExpSetEnabled<true>(tracer, false);
+  xpu::tracerExpDestroy<true>(tracer);
+  tracer = nullptr;
+  processLaunches(/*wait=*/true);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    metricQueryPools.clear();
+    metricGroups.clear();
+    eventPools.clear();
+    deviceClocks.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(samplingMutex);
+    samplingStates.clear();
+  }
+  xpu::contextDestroy<true>(tracerContext);
+  tracerContext = nullptr;
+}
+
+XpuProfiler::XpuProfiler() {
+  pImpl = std::make_unique<XpuProfilerPimpl>(*this);
+}
+
+XpuProfiler::~XpuProfiler() = default;
+
+} // namespace proton
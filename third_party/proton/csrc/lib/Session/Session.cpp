@@ -1,9 +1,11 @@
 #include "Session/Session.h"
 #include "Context/Python.h"
 #include "Context/Shadow.h"
+#include "Data/TraceData.h"
 #include "Data/TreeData.h"
 #include "Profiler/CuptiProfiler.h"
 #include "Profiler/RoctracerProfiler.h"
+#include "Profiler/XpuProfiler.h"
 #include "Utility/String.h"
 
 namespace proton {
@@ -16,6 +18,9 @@ Profiler *getProfiler(const std::string &profilerName) {
   if (proton::toLower(profilerName) == "roctracer") {
     return &RoctracerProfiler::instance();
   }
+  if (proton::toLower(profilerName) == "xpu") {
+    return &XpuProfiler::instance();
+  }
   throw std::runtime_error("Unknown profiler: " + profilerName);
 }
 
@@ -25,6 +30,9 @@ std::unique_ptr<Data> makeData(const std::string &dataName,
   if (toLower(dataName) == "tree") {
     return std::make_unique<TreeData>(path, contextSource);
   }
+  if (toLower(dataName) == "trace") {
+    return std::make_unique<TraceData>(path, contextSource);
+  }
   throw std::runtime_error("Unknown data: " + dataName);
 }
 
@@ -40,6 +48,9 @@ makeContextSource(const std::string &contextSourceName) {
 } // namespace
 
 void Session::activate() {
+  // The profiler is shared by the sessions, the last activated one decides
+  // which launches are timed
+  profiler->setSampling(sampling);
   profiler->start();
   profiler->flush();
   profiler->registerData(data.get());
@@ -50,19 +61,29 @@ void Session::deactivate() {
   profiler->unregisterData(data.get());
 }
 
+void Session::flush() {
+  profiler->flush();
+  data->flush();
+}
+
 void Session::finalize(OutputFormat outputFormat) {
   profiler->stop();
-  data->dump(outputFormat);
+  // Complete the stream if the data has been flushed before
+  if (data->isFlushed())
+    data->flush();
+  else
+    data->dump(outputFormat);
 }
 
 std::unique_ptr<Session> SessionManager::makeSession(
     size_t id, const std::string &path, const std::string &profilerName,
-    const std::string &contextSourceName, const std::string &dataName) {
+    const std::string &contextSourceName, const std::string &dataName,
+    const SamplingConfig &sampling) {
   auto profiler = getProfiler(profilerName);
   auto contextSource = makeContextSource(contextSourceName);
   auto data = makeData(dataName, path, contextSource.get());
   auto *session = new Session(id, path, profiler, std::move(contextSource),
-                              std::move(data));
+                              std::move(data), sampling);
   return std::unique_ptr<Session>(session);
 }
 
@@ -107,7 +128,8 @@ void SessionManager::removeSession(size_t sessionId) {
 size_t SessionManager::addSession(const std::string &path,
                                   const std::string &profilerName,
                                   const std::string &contextSourceName,
-                                  const std::string &dataName) {
+                                  const std::string &dataName,
+                                  const SamplingConfig &sampling) {
   std::unique_lock<std::shared_mutex> lock(mutex);
   if (hasSession(path)) {
     auto sessionId = getSessionId(path);
@@ -116,8 +138,8 @@ size_t SessionManager::addSession(const std::string &path,
   }
   auto sessionId = nextSessionId++;
   sessionPaths[path] = sessionId;
-  sessions[sessionId] =
-      makeSession(sessionId, path, profilerName, contextSourceName, dataName);
+  sessions[sessionId] = makeSession(sessionId, path, profilerName,
+                                    contextSourceName, dataName, sampling);
   return sessionId;
 }
 
@@ -145,6 +167,21 @@ void SessionManager::finalizeAllSessions(OutputFormat outputFormat) {
   }
 }
 
+void SessionManager::flushSession(size_t sessionId) {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  if (!hasSession(sessionId)) {
+    return;
+  }
+  sessions[sessionId]->flush();
+}
+
+void SessionManager::flushAllSessions() {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  for (auto &[sessionId, session] : sessions) {
+    session->flush();
+  }
+}
+
 void SessionManager::enterScope(const Scope &scope) {
   std::shared_lock<std::shared_mutex> lock(mutex);
   for (auto iter : scopeInterfaceCounts) {
@@ -1,9 +1,12 @@
 # flake8: noqa
 from .scope import scope, enter_scope, exit_scope
+from . import probes
+from .probes import Probes
 from .profile import (
     start,
     activate,
     deactivate,
+    flush,
     finalize,
     profile,
     DEFAULT_PROFILE_NAME,
@@ -0,0 +1,88 @@
+import triton
+import triton.language as tl
+
+from .flags import get_profiling_on
+from .scope import scope
+from typing import Optional
+
+
+@triton.jit
+def record(buffer, region: tl.constexpr, start, end):
+    """
+    Accumulates the cycles between the `start` and `end` timestamps into a region of a probe buffer.
+    It costs two atomic additions per program, and nothing when the buffer is None.
+
+    Usage:
+
+        ```python
+        @triton.jit
+        def kernel(..., probe_buffer):
+            start = tl.extra.intel.clock()
+            a = tl.load(a_ptrs)
+            proton.probes.record(probe_buffer, 0, start, tl.extra.intel.clock())
+        ```
+
+    Args:
+        buffer: The buffer of a `Probes` object, or None to disable the probes.
+        region (tl.constexpr): The index of the region in the names of the `Probes` object.
+        start: The timestamp taken at the beginning of the region.
+        end: The timestamp taken at the end of the region.
+    """
+    if buffer is not None:
+        tl.atomic_add(buffer + 2 * region, end - start)
+        tl.atomic_add(buffer + 2 * region + 1, 1)
+
+
+class Probes:
+    """
+    Device-side timestamp probes for regions of Triton kernels, e.g., load wait vs. dot vs. epilogue.
+    The kernels accumulate the cycles spent in each region into a buffer with `record()`,
+    and the totals are attached to the profile under a scope named after each region.
+
+    Usage:
+
+        ```python
+        probes = proton.Probes(["load", "dot", "epilogue"])
+        kernel[grid](..., probes.buffer)
+        probes.add_metrics()
+        ```
+
+    Args:
+        regions (list[str]): The names of the regions.
+        device (str, optional): The device of the buffer. Defaults to the current device.
+        enabled (bool, optional): Whether the probes are enabled. When disabled, the buffer is None,
+                                  so that `record()` compiles to nothing. Defaults to True.
+    """
+
+    def __init__(self, regions: list[str], device: Optional[str] = None, enabled: bool = True) -> None:
+        self.regions = regions
+        self.buffer = None
+        if enabled:
+            import torch
+            if device is None:
+                backend = triton.runtime.driver.active.get_current_target().backend
+                # HIP devices are exposed as CUDA devices by torch
+                device = "cuda" if backend == "hip" else backend
+            self.buffer = torch.zeros((len(regions), 2), dtype=torch.int64, device=device)
+
+    def collect(self) -> dict[str, dict[str, int]]:
+        """
+        Returns the total cycles and the number of samples of each region, and resets the buffer.
+        """
+        if self.buffer is None:
+            return {}
+        values = self.buffer.tolist()
+        self.buffer.zero_()
+        return {region: {"cycles": cycles, "samples": samples} for region, (cycles, samples) in zip(self.regions, values)}
+
+    def add_metrics(self) -> None:
+        """
+        Attaches the metrics of each region to a scope named after the region, under the current scope,
+        and resets the buffer.
+        """
+        if not get_profiling_on():
+            return
+        for region, metrics in self.collect().items():
+            if metrics["samples"] > 0:
+                with scope(region, metrics=metrics):
+                    pass
@@ -1,4 +1,5 @@
 import functools
+import threading
 import triton
 
 from triton._C.libproton import proton as libproton
@@ -8,6 +9,13 @@ from typing import Optional
 
 DEFAULT_PROFILE_NAME = "proton"
 
+# session -> event stopping its periodic flush
+_flush_events = {}
+# session -> data structure of the session
+_session_data = {}
+# data structure -> output format used when finalize() is not given one
+_DEFAULT_OUTPUT_FORMATS = {"tree": "hatchet", "trace": "chrome_trace"}
+
 
 def _select_backend() -> str:
     backend = triton.runtime.driver.active.get_current_target().backend
@@ -15,6 +23,8 @@ def _select_backend() -> str:
         return "cupti"
     elif backend == "hip":
         return "roctracer"
+    elif backend == "xpu":
+        return "xpu"
     else:
         raise ValueError("No backend is available for the current target.")
 
@@ -26,6 +36,9 @@ def start(
     data: Optional[str] = "tree",
     backend: Optional[str] = None,
     hook: Optional[str] = None,
+    flush_interval: Optional[float] = None,
+    sampling_interval: Optional[int] = None,
+    sampling_period: Optional[float] = None,
 ):
     """
     Start profiling with the given name and backend.
@@ -42,17 +55,32 @@ def start(
         name (str, optional): The name (with path) of the profiling session.
                               If not provided, the default name is "~/proton.hatchet".
         backend (str, optional): The backend to use for profiling.
-                                 Available options are [None, "cupti", "roctracer"].
+                                 Available options are [None, "cupti", "roctracer", "xpu"].
                                  Defaults to None, which automatically selects the backend matching the current active runtime.
         context (str, optional): The context to use for profiling.
                                  Available options are ["shadow", "python"].
                                  Defaults to "shadow".
         data (str, optional): The data structure to use for profiling.
-                              Available options are ["tree"].
+                              Available options are ["tree", "trace"].
+                              "tree" aggregates the metrics by calling context,
+                              while "trace" records a timeline of the kernel launches, which is dumped in the
+                              Chrome trace format (see finalize()).
                               Defaults to "tree".
         hook (str, optional): The hook to use for profiling.
                               Available options are [None, "triton"].
                               Defaults to None.
+        flush_interval (float, optional): The interval in seconds between periodic flushes of the session.
+                                          See flush() for the output.
+                                          Defaults to None, which disables periodic flushes.
+        sampling_interval (int, optional): Time each kernel once every `sampling_interval` launches, and only count
+                                           its other launches. The time of a kernel is then estimated from its timed
+                                           launches, and its number of timed launches is reported as "Samples".
+                                           Only supported by the "xpu" backend, the other backends time every launch.
+                                           Defaults to None, which times every launch unless `sampling_period` is set.
+        sampling_period (float, optional): Time the first launch of each kernel after `sampling_period` seconds since
+                                           it was last timed, or after `sampling_interval` launches, whichever comes
+                                           first.
+                                           Defaults to None, which disables the time based sampling.
     Returns:
         session (int): The session ID of the profiling session.
     """
@@ -69,7 +97,36 @@ def start(
     set_profiling_on()
     if hook and hook == "triton":
         register_triton_hook()
-    return libproton.start(name, context, data, backend)
+    if sampling_interval is not None and sampling_interval < 1:
+        raise ValueError("The sampling interval must be at least 1.")
+    if sampling_interval is None:
+        # Only sample by time if a period is given.
+        sampling_interval = 1 if sampling_period is None else 2**64 - 1
+    sampling_period_ns = 0 if sampling_period is None else max(int(sampling_period * 1e9), 1)
+    session = libproton.start(name, context, data, backend, sampling_interval, sampling_period_ns)
+    _session_data[session] = data.lower()
+    if flush_interval is not None and session not in _flush_events:
+        _start_periodic_flush(session, flush_interval)
+    return session
+
+
+def _start_periodic_flush(session: int, flush_interval: float) -> None:
+    event = threading.Event()
+    _flush_events[session] = event
+
+    def periodic_flush():
+        while not event.wait(flush_interval):
+            libproton.flush(session)
+
+    threading.Thread(target=periodic_flush, daemon=True).start()
+
+
+def _stop_periodic_flush(session: Optional[int] = None) -> None:
+    sessions = list(_flush_events.keys()) if session is None else [session]
+    for session in sessions:
+        event = _flush_events.pop(session, None)
+        if event is not None:
+            event.set()
 
 
 def activate(session: Optional[int] = 0) -> None:
@@ -104,7 +161,29 @@ def deactivate(session: Optional[int] = 0) -> None:
     libproton.deactivate(session)
 
 
-def finalize(session: Optional[int] = None, output_format: str = "hatchet") -> None:
+def flush(session: Optional[int] = None) -> None:
+    """
+    Flushes a profiling session without finalizing it.
+    Append the metrics recorded since the last flush to the stream file specified by the session name,
+    with the ".hatchet.msgpack" suffix, and release them from memory.
+    Once a session has been flushed, finalize() appends the remaining metrics to the stream as well.
+    The stream can be read with proton-viewer, which merges its snapshots.
+
+    Args:
+        session (int, optional): The session ID to flush. If None, all sessions are flushed. Defaults to None.
+
+    Returns:
+        None
+    """
+    if session is None:
+        libproton.flush_all()
+    else:
+        if is_command_line() and session != 0:
+            raise ValueError("Only one session can be flushed when running from the command line.")
+        libproton.flush(session)
+
+
+def finalize(session: Optional[int] = None, output_format: Optional[str] = None) -> None:
     """
     Finalizes a profiling session.
     Flush and write the profiling data to the file specified by the session name.
@@ -112,19 +191,30 @@ def finalize(session: Optional[int] = None, output_format: str = "hatchet") -> N
     Args:
         session (int, optional): The session ID to finalize. If None, all sessions are finalized. Defaults to None.
         output_format (str, optional): The output format for the profiling results.
-                                       Aavailable options are ["hatchet"].
+                                       Aavailable options are ["hatchet", "hatchet_msgpack"] for the "tree" data,
+                                       and ["chrome_trace"] for the "trace" data.
+                                       The "chrome_trace" output can be opened with chrome://tracing or Perfetto.
+                                       Defaults to None, which selects "hatchet" or "chrome_trace" based on the data.
 
     Returns:
         None
     """
+    _stop_periodic_flush(session)
     if session is None:
         set_profiling_off()
-        libproton.finalize_all(output_format)
+        if output_format is None:
+            # Finalize the sessions whose data has another default output format first
+            for session_id, data in list(_session_data.items()):
+                if _DEFAULT_OUTPUT_FORMATS.get(data, "hatchet") != "hatchet":
+                    libproton.finalize(session_id, _DEFAULT_OUTPUT_FORMATS[data])
+        libproton.finalize_all(output_format or "hatchet")
+        _session_data.clear()
         unregister_triton_hook()
     else:
         if is_command_line() and session != 0:
             raise ValueError("Only one session can be finalized when running from the command line.")
-        libproton.finalize(session, output_format)
+        data = _session_data.pop(session, "tree")
+        libproton.finalize(session, output_format or _DEFAULT_OUTPUT_FORMATS.get(data, "hatchet"))
 
 
 def _profiling(
@@ -30,11 +30,84 @@ def match_available_metrics(metrics, raw_metrics):
 
 def get_raw_metrics(file):
     database = json.load(file)
+    return get_raw_metrics_from_database(database)
+
+
+def get_raw_metrics_from_database(database):
     device_info = database.pop(1)
     gf = ht.GraphFrame.from_literal(database)
     return gf, gf.show_metric_columns(), device_info
 
 
+def merge_frames(frame, other):
+    for metric_name, value in other["metrics"].items():
+        if isinstance(value, (int, float)) and isinstance(frame["metrics"].get(metric_name), (int, float)):
+            frame["metrics"][metric_name] += value
+        else:
+            frame["metrics"][metric_name] = value
+    children = {child["frame"]["name"]: child for child in frame["children"]}
+    for other_child in other["children"]:
+        child = children.get(other_child["frame"]["name"])
+        if child is None:
+            frame["children"].append(other_child)
+            children[other_child["frame"]["name"]] = other_child
+        else:
+            merge_frames(child, other_child)
+
+
+def merge_databases(database, other):
+    merge_frames(database[0], other[0])
+    for device_type, devices in other[1].items():
+        database[1].setdefault(device_type, {}).update(devices)
+    return database
+
+
+def read_stream(file_name):
+    """
+    Read a stream of snapshots written by proton.flush() and merge them into a single database.
+    """
+    try:
+        import msgpack
+    except ImportError:
+        raise ImportError("Failed to import msgpack. `pip install msgpack` to read proton streams.")
+    database = None
+    with open(file_name, "rb") as f:
+        for snapshot in msgpack.Unpacker(f, raw=False):
+            database = snapshot if database is None else merge_databases(database, snapshot)
+    if database is None:
+        raise RuntimeError(f"No snapshot found in {file_name}")
+    return database
+
+
+def read_database(file_name):
+    if file_name.endswith(".msgpack"):
+        return read_stream(file_name)
+    with open(file_name, "r") as f:
+        return json.load(f)
+
+
+def read_reduced_database(file_name, depth, include=None, exclude=None, threshold_metric=None, threshold=None):
+    """
+    Read a JSON profile with the native reader of libproton, which streams it and only keeps the frames up to `depth`,
+    on the paths through the frames matching `include`, not matching `exclude`, and whose inclusive `threshold_metric`
+    is at least `threshold`. The metrics of the deeper frames are summed into their ancestor at `depth`, so that the
+    reduced database displays the same tree. Opening a profile then takes the memory and time of the displayed tree.
+    Returns None if the native reader is not available or the profile is a stream.
+    """
+    if file_name.endswith(".msgpack"):
+        return None
+    try:
+        from triton._C.libproton import proton as libproton
+    except ImportError:
+        return None
+    # filter out metadata computation
+    excludes = [f"{COMPUTE_METADATA_SCOPE_NAME}.*"]
+    if exclude:
+        excludes.append(exclude)
+    return json.loads(
+        libproton.read_hatchet(file_name, depth, include or "", excludes, threshold_metric or "", threshold or 0.0))
+
+
 def get_min_time_flops(df, device_info):
     min_time_flops = pd.DataFrame(0.0, index=df.index, columns=["min_time"])
     for device_type in device_info:
@@ -62,6 +135,10 @@ def get_min_time_flops(df, device_info):
                         max_flops = 383e12 / (width / 8)
                     elif arch == "gfx941" or arch == "gfx942":
                         max_flops = 2614.9e12 / (width / 8)
+                elif device_type == "XPU":
+                    # The XMX engines of a Xe-core issue 8192 int8 ops per clock on PVC and 4096 on DG2 and Xe2
+                    ops_per_clock = {"12.60": 8192, "12.55": 4096, "20.1": 4096, "20.4": 4096}.get(arch, 0)
+                    max_flops = (num_sms * clock_rate * 1e3 * ops_per_clock) / (width / 8)
                 else:
                     raise ValueError(f"Unsupported device type: {device_type}")
                 min_time_flops.loc[idx, "min_time"] += device_frames[f"flops{width}"].fillna(0) / max_flops
@@ -102,6 +179,11 @@ for width in TritonHook.flops_width:
     derivable_metrics.update({key: FactorDict(factor_name, factor_dict) for key in factor_dict.keys()})
 
 
+def is_derived_metric(metric):
+    return (metric == "util" or metric in derivable_metrics or metric in time_factor_dict.factor
+            or metric in avg_time_factor_dict.factor)
+
+
 def derive_metrics(gf, metrics, raw_metrics, device_info):
     derived_metrics = []
     original_metrics = []
@@ -181,16 +263,23 @@ WHERE p."name" =~ "{exclude}"
 
 
 def parse(metrics, filename, include, exclude, threshold, depth, format):
-    with open(filename, "r") as f:
-        gf, raw_metrics, device_info = get_raw_metrics(f)
-        gf = format_frames(gf, format)
-        assert len(raw_metrics) > 0, "No metrics found in the input file"
-        gf.update_inclusive_columns()
-        metrics = derive_metrics(gf, metrics, raw_metrics, device_info)
-        # TODO: generalize to support multiple metrics, not just the first one
-        gf = filter_frames(gf, include, exclude, threshold, metrics[0])
-        print(gf.tree(metric_column=metrics, expand_name=True, depth=depth, render_header=False))
-        emitWarnings(gf, metrics)
+    # The frames are matched with their full name, before formatting them, and the threshold only applies to a raw
+    # metric. The filters are applied again on the reduced database.
+    full = format == "full"
+    threshold_metric = metrics[0] if threshold and not is_derived_metric(metrics[0]) else None
+    database = read_reduced_database(filename, depth, include if full else None, exclude if full else None,
+                                     threshold_metric, threshold)
+    if database is None:
+        database = read_database(filename)
+    gf, raw_metrics, device_info = get_raw_metrics_from_database(database)
+    gf = format_frames(gf, format)
+    assert len(raw_metrics) > 0, "No metrics found in the input file"
+    gf.update_inclusive_columns()
+    metrics = derive_metrics(gf, metrics, raw_metrics, device_info)
+    # TODO: generalize to support multiple metrics, not just the first one
+    gf = filter_frames(gf, include, exclude, threshold, metrics[0])
+    print(gf.tree(metric_column=metrics, expand_name=True, depth=depth, render_header=False))
+    emitWarnings(gf, metrics)
 
 
 def emitWarnings(gf, metrics):
@@ -202,14 +291,13 @@ def emitWarnings(gf, metrics):
 
 
 def show_metrics(file_name):
-    with open(file_name, "r") as f:
-        _, raw_metrics, _ = get_raw_metrics(f)
-        print("Available metrics:")
-        if raw_metrics:
-            for raw_metric in raw_metrics:
-                raw_metric_no_unit = raw_metric.split("(")[0].strip().lower()
-                print(f"- {raw_metric_no_unit}")
-        return
+    _, raw_metrics, _ = get_raw_metrics_from_database(read_database(file_name))
+    print("Available metrics:")
+    if raw_metrics:
+        for raw_metric in raw_metrics:
+            raw_metric_no_unit = raw_metric.split("(")[0].strip().lower()
+            print(f"- {raw_metric_no_unit}")
+    return
 
 
 def main():
@@ -291,6 +379,7 @@ proton-viewer -e ".*test.*" path/to/file.json
 """)
 
     args, target_args = argparser.parse_known_args()
+    # Streams written by proton.flush() (*.hatchet.msgpack) are merged before being displayed
     assert len(target_args) == 1, "Must specify a file to read"
 
     file_name = target_args[0]
@@ -4,6 +4,7 @@ import triton.profiler as proton
 import tempfile
 import json
 import pytest
+import threading
 from typing import NamedTuple
 
 import triton.language as tl
@@ -13,6 +14,10 @@ def is_hip():
     return triton.runtime.driver.active.get_current_target().backend == "hip"
 
 
+def is_xpu():
+    return triton.runtime.driver.active.get_current_target().backend == "xpu"
+
+
 @pytest.mark.parametrize("context", ["shadow", "python"])
 def test_torch(context):
     with tempfile.NamedTemporaryFile(delete=True, suffix=".hatchet") as f:
@@ -37,6 +42,32 @@ def test_torch(context):
             assert "elementwise_kernel" in prev_frame[0]["frame"]["name"]
 
 
+def test_python_max_depth(monkeypatch):
+    monkeypatch.setenv("PROTON_PYTHON_MAX_DEPTH", "2")
+
+    def nested(depth):
+        if depth == 0:
+            torch.ones((2, 2), device="cuda")
+        else:
+            nested(depth - 1)
+
+    with tempfile.NamedTemporaryFile(delete=True, suffix=".hatchet") as f:
+        proton.start(f.name.split(".")[0], context="python")
+        # The same frames are launched from twice, and looked up in the cache the second time.
+        for _ in range(2):
+            nested(8)
+        proton.finalize()
+        data = json.load(f)
+        # Only the two innermost frames are attributed, above the kernel.
+        depth = 0
+        curr_frame = data[0]["children"]
+        while len(curr_frame) > 0:
+            assert len(curr_frame) == 1
+            depth += 1
+            curr_frame = curr_frame[0]["children"]
+        assert depth == 3
+
+
 def test_triton():
 
     @triton.jit
@@ -214,3 +245,134 @@ def test_deactivate():
         assert "DeviceId" not in data[0]["metrics"]
         assert len(data[0]["children"]) == 1
         assert "DeviceId" in data[0]["children"][0]["metrics"]
+
+
+def test_multithread():
+
+    @triton.jit
+    def foo(x, y):
+        tl.store(y, tl.load(x))
+
+    x = torch.tensor([2], device="cuda")
+    y = torch.zeros_like(x)
+    # Compile the kernel before profiling
+    foo[(1, )](x, y)
+    num_threads = 4
+    num_launches = 16
+
+    def launch():
+        for _ in range(num_launches):
+            foo[(1, )](x, y)
+
+    with tempfile.NamedTemporaryFile(delete=True, suffix=".hatchet") as f:
+        proton.start(f.name.split(".")[0])
+        threads = [threading.Thread(target=launch) for _ in range(num_threads)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        proton.finalize()
+        data = json.load(f)
+        # Metrics recorded from all the threads are merged
+        count = sum(child["metrics"]["Count"] for child in data[0]["children"] if child["frame"]["name"] == "foo")
+        assert count == num_threads * num_launches
+
+
+def test_flush():
+    msgpack = pytest.importorskip("msgpack")
+
+    @triton.jit
+    def foo(x, y):
+        tl.store(y, tl.load(x))
+
+    x = torch.tensor([2], device="cuda")
+    y = torch.zeros_like(x)
+    with tempfile.TemporaryDirectory() as temp_dir:
+        name = f"{temp_dir}/test_flush"
+        proton.start(name)
+        foo[(1, )](x, y)
+        proton.flush()
+        foo[(1, )](x, y)
+        proton.finalize()
+        # Each flush and the finalization append a snapshot to the stream
+        with open(f"{name}.hatchet.msgpack", "rb") as f:
+            snapshots = list(msgpack.Unpacker(f, raw=False))
+        assert len(snapshots) == 2
+        from triton.profiler.viewer import read_stream
+        database = read_stream(f"{name}.hatchet.msgpack")
+        count = sum(child["metrics"]["Count"] for child in database[0]["children"] if child["frame"]["name"] == "foo")
+        assert count == 2
+
+
+def test_trace():
+
+    @triton.jit
+    def foo(x, y):
+        tl.store(y, tl.load(x))
+
+    x = torch.tensor([2], device="cuda")
+    y = torch.zeros_like(x)
+    with tempfile.TemporaryDirectory() as temp_dir:
+        name = f"{temp_dir}/test_trace"
+        proton.start(name, data="trace")
+        with proton.scope("test0"):
+            foo[(1, )](x, y)
+        foo[(1, )](x, y)
+        proton.finalize()
+        with open(f"{name}.chrome_trace") as f:
+            data = json.load(f)
+        # Each launch is an event of the timeline
+        events = [event for event in data["traceEvents"] if event["ph"] == "X"]
+        assert len(events) == 2
+        assert all(event["name"] == "foo" for event in events)
+        assert events[0]["ts"] <= events[1]["ts"]
+        assert events[0]["args"]["call_path"] == "test0"
+        assert data["otherData"]["dropped_events"] == 0
+
+
+@pytest.mark.skipif(not is_xpu(), reason="Launches are only sampled by the xpu backend")
+def test_sampling():
+    x = torch.ones((2, 2), device="xpu")
+    with tempfile.NamedTemporaryFile(delete=True, suffix=".hatchet") as f:
+        proton.start(f.name.split(".")[0], sampling_interval=5)
+        with proton.scope("test"):
+            for _ in range(10):
+                x.add_(1)
+        proton.finalize()
+        data = json.load(f)
+        metrics = data[0]["children"][0]["children"][0]["metrics"]
+        assert metrics["Count"] == 10
+        assert metrics["Samples"] == 2
+        assert metrics["Time (ns)"] > 0
+        assert metrics["Overhead (ns)"] > 0
+
+
+@pytest.mark.skipif(not is_xpu(), reason="Device timestamps are read with tl.extra.intel.clock")
+def test_probes():
+
+    @triton.jit
+    def foo(x, y, probe_buffer, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        start = tl.extra.intel.clock()
+        value = tl.load(x + offs)
+        proton.probes.record(probe_buffer, 0, start, tl.extra.intel.clock())
+        start = tl.extra.intel.clock()
+        tl.store(y + offs, value + 1)
+        proton.probes.record(probe_buffer, 1, start, tl.extra.intel.clock())
+
+    x = torch.zeros((4, 256), device="xpu")
+    y = torch.zeros_like(x)
+    probes = proton.Probes(["load", "store"])
+    with tempfile.NamedTemporaryFile(delete=True, suffix=".hatchet") as f:
+        proton.start(f.name.split(".")[0])
+        with proton.scope("test0"):
+            foo[(4, )](x, y, probes.buffer, BLOCK=256)
+            probes.add_metrics()
+        proton.finalize()
+        data = json.load(f)
+        regions = {child["frame"]["name"]: child["metrics"] for child in data[0]["children"][0]["children"]}
+        for region in ["load", "store"]:
+            assert regions[region]["samples"] == 4
+            assert regions[region]["cycles"] > 0
+    # Disabled probes don't need a buffer
+    foo[(4, )](x, y, proton.Probes(["load", "store"], enabled=False).buffer, BLOCK=256)
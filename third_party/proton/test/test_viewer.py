@@ -1,11 +1,13 @@
 import pytest
 import subprocess
-from triton.profiler.viewer import get_min_time_flops, get_min_time_bytes, get_raw_metrics, format_frames, derive_metrics, filter_frames
+import json
+from triton.profiler.viewer import get_min_time_flops, get_min_time_bytes, get_raw_metrics, format_frames, derive_metrics, filter_frames, merge_databases, read_reduced_database
 import numpy as np
 
 file_path = __file__
 cuda_example_file = file_path.replace("test_viewer.py", "example_cuda.json")
 hip_example_file = file_path.replace("test_viewer.py", "example_hip.json")
+xpu_example_file = file_path.replace("test_viewer.py", "example_xpu.json")
 frame_example_file = file_path.replace("test_viewer.py", "example_frame.json")
 
 
@@ -67,6 +69,15 @@ def test_min_time_flops():
         np.testing.assert_allclose(ret[device0_idx].to_numpy(), [[0.000026]], atol=1e-5)
         # MI300
         np.testing.assert_allclose(ret[device1_idx].to_numpy(), [[0.000038]], atol=1e-5)
+    with open(xpu_example_file, "r") as f:
+        gf, _, device_info = get_raw_metrics(f)
+        ret = get_min_time_flops(gf.dataframe, device_info)
+        device0_idx = gf.dataframe["DeviceId"] == "0"
+        device1_idx = gf.dataframe["DeviceId"] == "1"
+        # PVC
+        np.testing.assert_allclose(ret[device0_idx].to_numpy(), [[0.0000060]], atol=1e-6)
+        # BMG
+        np.testing.assert_allclose(ret[device1_idx].to_numpy(), [[0.000457]], atol=1e-5)
 
 
 def test_min_time_bytes():
@@ -88,6 +99,15 @@ def test_min_time_bytes():
         np.testing.assert_allclose(ret[device0_idx].to_numpy(), [[6.10351e-06]], atol=1e-6)
         # MI300
         np.testing.assert_allclose(ret[device1_idx].to_numpy(), [[1.93378e-05]], atol=1e-6)
+    with open(xpu_example_file, "r") as f:
+        gf, _, device_info = get_raw_metrics(f)
+        ret = get_min_time_bytes(gf.dataframe, device_info)
+        device0_idx = gf.dataframe["DeviceId"] == "0"
+        device1_idx = gf.dataframe["DeviceId"] == "1"
+        # PVC
+        np.testing.assert_allclose(ret[device0_idx].to_numpy(), [[3.05176e-06]], atol=1e-6)
+        # BMG
+        np.testing.assert_allclose(ret[device1_idx].to_numpy(), [[2.19298e-04]], atol=1e-6)
 
 
 def derivation_metrics_test(metrics, expected_data, sample_file, rtol=1e-7, atol=1e-6):
@@ -140,3 +160,42 @@ def test_flops_derivation():
         },
         sample_file=cuda_example_file,
     )
+
+
+def test_merge_databases():
+    with open(cuda_example_file, "r") as f:
+        database = json.load(f)
+    with open(cuda_example_file, "r") as f:
+        other = json.load(f)
+    with open(cuda_example_file, "r") as f:
+        expected = json.load(f)
+    # Snapshots of the same tree are merged by summing their numeric metrics
+    merged = merge_databases(database, other)
+    assert len(merged[0]["children"]) == len(expected[0]["children"])
+    for child, expected_child in zip(merged[0]["children"], expected[0]["children"]):
+        assert child["frame"]["name"] == expected_child["frame"]["name"]
+        for metric_name, value in expected_child["metrics"].items():
+            if isinstance(value, (int, float)):
+                assert child["metrics"][metric_name] == 2 * value
+            else:
+                assert child["metrics"][metric_name] == value
+    assert merged[1] == expected[1]
+
+
+def test_read_reduced_database():
+    # The frames below the depth are folded into their ancestor
+    database = read_reduced_database(frame_example_file, 1)
+    assert database is not None
+    root = database[0]
+    assert [child["frame"]["name"] for child in root["children"]] == ["test0", "test1"]
+    test0 = root["children"][0]
+    assert test0["children"] == []
+    assert test0["metrics"]["Time (ns)"] == 204800
+    # Only the paths through the included frames are kept
+    root = read_reduced_database(frame_example_file, 100, include=".*test0.*")[0]
+    assert [child["frame"]["name"] for child in root["children"]] == ["test0"]
+    root = read_reduced_database(frame_example_file, 100, exclude=".*test0.*")[0]
+    assert [child["frame"]["name"] for child in root["children"]] == ["test1"]
+    # test1 has no time
+    root = read_reduced_database(frame_example_file, 100, threshold_metric="time", threshold=1)[0]
+    assert [child["frame"]["name"] for child in root["children"]] == ["test0"]
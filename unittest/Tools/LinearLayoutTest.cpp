@@ -788,6 +788,38 @@ TEST_F(LinearLayoutTest, FreeVariableMasks) {
             AR({{S("in1"), 0b100}, {S("in2"), 0b10}}));
 }
 
+TEST_F(LinearLayoutTest, HashMatchesEquality) {
+  LinearLayout l1({{S("in"), {{1}, {2}}}}, {S("out")});
+  LinearLayout l2 = LinearLayout::identity1D(4, S("in"), S("out"));
+  EXPECT_EQ(l1, l2);
+  EXPECT_EQ(hash_value(l1), hash_value(l2));
+}
+
+TEST_F(LinearLayoutTest, CacheReturnsComputedLayouts) {
+  LinearLayoutCache cache;
+  LinearLayout src({{S("in"), {{0, 1}, {0, 2}, {1, 0}, {2, 0}}}},
+                   {S("dim0"), S("dim1")});
+  LinearLayout dst({{S("in"), {{1, 0}, {2, 0}, {0, 1}, {0, 2}}}},
+                   {S("dim0"), S("dim1")});
+
+  EXPECT_EQ(cache.invertAndCompose(src, dst), src.invertAndCompose(dst));
+  EXPECT_EQ(cache.getNumMisses(), 1u);
+  EXPECT_EQ(cache.invertAndCompose(src, dst), src.invertAndCompose(dst));
+  EXPECT_EQ(cache.getNumHits(), 1u);
+
+  // The operations and the order of the operands are part of the key.
+  EXPECT_EQ(cache.invertAndCompose(dst, src), dst.invertAndCompose(src));
+  LinearLayout comp = src.invertAndCompose(dst);
+  EXPECT_EQ(cache.compose(comp, src), comp.compose(src));
+  EXPECT_EQ(cache.product(src, dst), src * dst);
+  EXPECT_EQ(cache.getNumMisses(), 4u);
+
+  cache.clear();
+  EXPECT_EQ(cache.compose(comp, src), comp.compose(src));
+  EXPECT_EQ(cache.getNumHits(), 0u);
+  EXPECT_EQ(cache.getNumMisses(), 1u);
+}
+
 } // anonymous namespace
 } // namespace mlir::triton
 
@@ -2,9 +2,17 @@
 #include <sycl/sycl.hpp>
 #include <torch/torch.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <ios>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -63,6 +71,156 @@ std::vector<char> read_spirv(const std::string &filename) {
   return bytes;
 }
 
+/** Launch Manifest **/
+
+// A kernel argument of a captured launch. Tensors are copied to a device
+// buffer passed by pointer, scalars are passed by value.
+struct KernelArg {
+  std::string name;
+  std::optional<torch::Tensor> tensor;
+  // Size and bits of a scalar argument, as passed by the Triton launcher.
+  size_t size = 0;
+  uint64_t value = 0;
+};
+
+// A captured kernel launch, see the README for the manifest format.
+struct LaunchManifest {
+  std::string kernel_name;
+  std::string spirv_path;
+  std::string build_flags;
+  uint32_t gridX = 1;
+  uint32_t gridY = 1;
+  uint32_t gridZ = 1;
+  int num_warps = 4;
+  int threads_per_warp = 32;
+  int shared_memory = 0;
+  std::vector<KernelArg> args;
+};
+
+static std::optional<c10::ScalarType> parse_dtype(const std::string &dtype) {
+  static const std::map<std::string, c10::ScalarType> dtypes = {
+      {"i1", c10::ScalarType::Bool},      {"i8", c10::ScalarType::Char},
+      {"i16", c10::ScalarType::Short},    {"i32", c10::ScalarType::Int},
+      {"i64", c10::ScalarType::Long},     {"u8", c10::ScalarType::Byte},
+      {"f16", c10::ScalarType::Half},     {"bf16", c10::ScalarType::BFloat16},
+      {"f32", c10::ScalarType::Float},    {"f64", c10::ScalarType::Double},
+  };
+  auto it = dtypes.find(dtype);
+  if (it == dtypes.end())
+    return std::nullopt;
+  return it->second;
+}
+
+template <typename T> static uint64_t to_bits(T value) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+// Parses `<name> <type> <operands...>` of an `arg` line.
+static KernelArg parse_arg(std::istringstream &ss,
+                           const std::filesystem::path &base_dir) {
+  KernelArg arg;
+  std::string type;
+  ss >> arg.name >> type;
+
+  if (type == "tensor") {
+    std::string file;
+    if (!(ss >> file))
+      return arg;
+    arg.tensor = load_tensor((base_dir / file).string()).contiguous();
+    return arg;
+  }
+  if (type == "zeros") {
+    std::string dtype;
+    int64_t numel = 0;
+    if (!(ss >> dtype >> numel))
+      return arg;
+    auto scalar_type = parse_dtype(dtype);
+    if (!scalar_type)
+      throw std::runtime_error("Unknown tensor type " + dtype);
+    arg.tensor = torch::zeros({numel}, at::TensorOptions{*scalar_type});
+    return arg;
+  }
+
+  std::string value;
+  ss >> value;
+  if (ss.fail())
+    return arg;
+  if (type == "i8" || type == "i16" || type == "i32" || type == "i64") {
+    // Only the low bytes of the value are passed to the kernel.
+    arg.size = std::stoul(type.substr(1)) / 8;
+    arg.value = to_bits<int64_t>(std::stoll(value));
+  } else if (type == "u8" || type == "u16" || type == "u32" ||
+             type == "u64") {
+    arg.size = std::stoul(type.substr(1)) / 8;
+    arg.value = std::stoull(value);
+  } else if (type == "f32") {
+    arg.size = sizeof(float);
+    arg.value = to_bits(std::stof(value));
+  } else if (type == "f64") {
+    arg.size = sizeof(double);
+    arg.value = to_bits(std::stod(value));
+  } else {
+    throw std::runtime_error("Unknown type " + type + " of argument " +
+                             arg.name);
+  }
+  return arg;
+}
+
+LaunchManifest parse_manifest(const std::string &filename) {
+  std::ifstream ins(filename);
+  if (!ins.is_open()) {
+    throw std::runtime_error("Failed to open file " + filename);
+  }
+  // Files are relative to the manifest.
+  const auto base_dir = std::filesystem::path(filename).parent_path();
+
+  LaunchManifest manifest;
+  std::string line;
+  for (size_t line_no = 1; std::getline(ins, line); ++line_no) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream ss(line);
+    std::string key;
+    if (!(ss >> key))
+      continue;
+
+    if (key == "kernel") {
+      ss >> manifest.kernel_name;
+    } else if (key == "spirv") {
+      std::string file;
+      ss >> file;
+      manifest.spirv_path = (base_dir / file).string();
+    } else if (key == "build_flags") {
+      std::getline(ss >> std::ws, manifest.build_flags);
+      ss.clear();
+    } else if (key == "grid") {
+      ss >> manifest.gridX >> manifest.gridY >> manifest.gridZ;
+    } else if (key == "num_warps") {
+      ss >> manifest.num_warps;
+    } else if (key == "threads_per_warp") {
+      ss >> manifest.threads_per_warp;
+    } else if (key == "shared_memory") {
+      ss >> manifest.shared_memory;
+    } else if (key == "arg") {
+      manifest.args.push_back(parse_arg(ss, base_dir));
+    } else {
+      throw std::runtime_error(filename + ":" + std::to_string(line_no) +
+                               ": unknown key " + key);
+    }
+    if (ss.fail()) {
+      throw std::runtime_error(filename + ":" + std::to_string(line_no) +
+                               ": malformed " + key + " entry");
+    }
+  }
+
+  if (manifest.kernel_name.empty() || manifest.spirv_path.empty()) {
+    throw std::runtime_error(filename +
+                             ": the kernel and spirv entries are required");
+  }
+  return manifest;
+}
+
 /** SYCL Globals **/
 
 SyclQueueMap g_sycl_queue_map;
@@ -88,7 +246,8 @@ static inline T checkSyclErrors(const std::tuple<T, ze_result_t> tuple) {
 std::tuple<sycl::kernel_bundle<sycl::bundle_state::executable>, sycl::kernel,
            int32_t, int32_t>
 loadBinary(const std::string &kernel_name, uint8_t *binary_ptr,
-           const size_t binary_size, const size_t deviceId) {
+           const size_t binary_size, const std::string &build_flags,
+           const size_t deviceId) {
   int32_t n_regs = 0;
   int32_t n_spills = 0;
 
@@ -104,9 +263,8 @@ loadBinary(const std::string &kernel_name, uint8_t *binary_ptr,
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(sycl_device);
   const auto l0_context =
       sycl::get_native<sycl::backend::ext_oneapi_level_zero>(ctx);
-  const char *build_flags = "";
   auto l0_module = checkSyclErrors(create_module(
-      l0_context, l0_device, binary_ptr, binary_size, build_flags));
+      l0_context, l0_device, binary_ptr, binary_size, build_flags.c_str()));
   auto l0_kernel = checkSyclErrors(create_function(l0_module, kernel_name));
 
   ze_kernel_properties_t props;
@@ -180,15 +338,19 @@ static void set_scalar_arg(sycl::handler &cgh, int index, size_t size,
   }
 }
 
-static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
-                               int num_warps, int threads_per_warp,
-                               int shared_memory, sycl::queue &stream,
-                               sycl::kernel &kernel_ptr, void *arg0, void *arg1,
-                               void *arg2, int32_t arg3) {
-  std::string kernel_name =
-      kernel_ptr.get_info<sycl::info::kernel::function_name>();
-  void *params[] = {&arg0, &arg1, &arg2, &arg3};
-  uint32_t num_params = sizeof(params) / sizeof(params[0]);
+// A kernel parameter, passed by value.
+struct KernelParam {
+  size_t size;
+  const void *value;
+};
+
+static sycl::event sycl_kernel_launch(uint32_t gridX, uint32_t gridY,
+                                      uint32_t gridZ, int num_warps,
+                                      int threads_per_warp, int shared_memory,
+                                      sycl::queue &stream,
+                                      sycl::kernel &kernel_ptr,
+                                      const std::vector<KernelParam> &params) {
+  uint32_t num_params = params.size();
   uint32_t expected_num_params =
       kernel_ptr.get_info<sycl::info::kernel::num_args>();
   size_t global_range_x = gridX * threads_per_warp * num_warps;
@@ -203,15 +365,17 @@ static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
   if (shared_memory) {
     expected_num_params -= 1;
   }
-  assert(num_params == expected_num_params &&
-         "number of kernel param not matched");
+  if (num_params != expected_num_params) {
+    throw std::runtime_error(
+        "The manifest has " + std::to_string(num_params) +
+        " arguments, the kernel expects " +
+        std::to_string(expected_num_params));
+  }
 
   // Submit the imported kernel.
   auto cgf = [&](sycl::handler &cgh) {
-    set_scalar_arg(cgh, 0, sizeof(void *), params[0]);
-    set_scalar_arg(cgh, 1, sizeof(void *), params[1]);
-    set_scalar_arg(cgh, 2, sizeof(void *), params[2]);
-    set_scalar_arg(cgh, 3, sizeof(int32_t), params[3]);
+    for (uint32_t i = 0; i < num_params; ++i)
+      set_scalar_arg(cgh, i, params[i].size, params[i].value);
     if (shared_memory) {
       using share_mem_t = sycl::local_accessor<int8_t, 1>;
       share_mem_t local_buffer = share_mem_t(shared_memory, cgh);
@@ -221,91 +385,226 @@ static void sycl_kernel_launch(uint32_t gridX, uint32_t gridY, uint32_t gridZ,
       cgh.parallel_for(parallel_work_size, kernel_ptr);
     }
   };
-  auto event = stream.submit(cgf);
-
-  stream.wait();
+  return stream.submit(cgf);
 }
 
-at::Tensor launchKernel(sycl::queue stream, sycl::kernel kernel,
-                        const torch::Tensor &a, const torch::Tensor &b) {
-  int gridX = 97;
-  int gridY = 1;
-  int gridZ = 1;
+/** Replay **/
 
-  int num_warps = 4;
-  int num_ctas = 1;
-  int shared_memory = 0;
-  int threads_per_warp = 32;
+struct ReplayOptions {
+  std::string manifest_path;
+  std::string output_dir = ".";
+  int iterations = 100;
+  int warmup = 10;
+  // Build flag variants to time, `default` is the build flags of the
+  // manifest.
+  std::vector<std::string> grf_modes = {"default"};
+};
 
-  int _arg3 = 98432;
+static const std::map<std::string, std::string> grf_mode_flags = {
+    {"small", "-cl-intel-128-GRF-per-thread"},
+    {"large", "-cl-intel-256-GRF-per-thread"},
+    {"auto", "-cl-intel-enable-auto-large-GRF-mode"},
+};
 
-  torch::Tensor output = torch::zeros(
-      {a.sizes()[0]}, c10::nullopt, at::TensorOptions{c10::ScalarType::Float});
-  std::cout << "Tensor output: " << output.sizes() << ", "
-            << output.scalar_type() << " (" << output.nbytes() << " bytes)"
-            << std::endl;
+// Returns the build flags of the manifest with the GRF mode flag replaced by
+// the one of \p grf_mode.
+static std::string get_build_flags(const LaunchManifest &manifest,
+                                   const std::string &grf_mode) {
+  if (grf_mode == "default")
+    return manifest.build_flags;
+
+  std::istringstream ss(manifest.build_flags);
+  std::string flags, flag;
+  while (ss >> flag) {
+    bool is_grf_flag =
+        std::any_of(grf_mode_flags.begin(), grf_mode_flags.end(),
+                    [&](const auto &mode) { return mode.second == flag; });
+    if (!is_grf_flag)
+      flags += flag + " ";
+  }
+  return flags + grf_mode_flags.at(grf_mode);
+}
 
-  auto tensor_ptr = [](const torch::Tensor &t) -> void * {
-    return reinterpret_cast<void *>(t.data_ptr());
+// Launches the kernel once to check its outputs, then times `iterations`
+// launches with the device timestamps of the profiling events.
+static std::vector<double>
+replay(const LaunchManifest &manifest, const ReplayOptions &options,
+       const std::string &grf_mode, sycl::queue &stream, sycl::kernel &kernel) {
+  // Each variant starts from the captured tensors, so that their outputs can
+  // be compared.
+  std::vector<KernelParam> params;
+  std::vector<void *> dev_ptrs(manifest.args.size(), nullptr);
+  for (size_t i = 0; i < manifest.args.size(); ++i) {
+    const KernelArg &arg = manifest.args[i];
+    if (!arg.tensor) {
+      params.push_back({arg.size, &arg.value});
+      continue;
+    }
+    const torch::Tensor &tensor = *arg.tensor;
+    dev_ptrs[i] =
+        sycl::malloc_device<char>(std::max<size_t>(tensor.nbytes(), 1), stream);
+    stream.memcpy(dev_ptrs[i], tensor.data_ptr(), tensor.nbytes());
+    params.push_back({sizeof(void *), &dev_ptrs[i]});
+  }
+  stream.wait();
+
+  auto launch = [&]() {
+    return sycl_kernel_launch(manifest.gridX, manifest.gridY, manifest.gridZ,
+                              manifest.num_warps, manifest.threads_per_warp,
+                              manifest.shared_memory, stream, kernel, params);
   };
 
-  auto a_dev = sycl::malloc_device<char>(a.nbytes(), stream);
-  auto b_dev = sycl::malloc_device<char>(b.nbytes(), stream);
-  auto output_dev = sycl::malloc_device<char>(output.nbytes(), stream);
-
-  stream.submit([&](sycl::handler &cgh) {
-    cgh.memcpy(a_dev, tensor_ptr(a), a.nbytes());
-  });
-  stream.submit([&](sycl::handler &cgh) {
-    cgh.memcpy(b_dev, tensor_ptr(b), b.nbytes());
-  });
-  stream.submit([&](sycl::handler &cgh) {
-    cgh.memcpy(output_dev, tensor_ptr(output), output.nbytes());
-  });
+  launch().wait();
+  for (size_t i = 0; i < manifest.args.size(); ++i) {
+    if (!dev_ptrs[i])
+      continue;
+    torch::Tensor output = torch::empty_like(*manifest.args[i].tensor);
+    stream.memcpy(output.data_ptr(), dev_ptrs[i], output.nbytes()).wait();
+    std::string suffix = grf_mode == "default" ? "" : "_" + grf_mode;
+    write_tensor((std::filesystem::path(options.output_dir) /
+                  ("cpp_outs_" + manifest.args[i].name + suffix + ".pt"))
+                     .string(),
+                 output);
+  }
+
+  for (int i = 0; i < options.warmup; ++i)
+    launch();
   stream.wait();
 
-  sycl_kernel_launch(gridX, gridY, gridZ, num_warps, threads_per_warp,
-                     shared_memory, stream, kernel, a_dev, b_dev, output_dev,
-                     _arg3);
+  std::vector<double> durations;
+  for (int i = 0; i < options.iterations; ++i) {
+    sycl::event event = launch();
+    event.wait();
+    auto start =
+        event.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end =
+        event.get_profiling_info<sycl::info::event_profiling::command_end>();
+    durations.push_back((end - start) / 1000.0);
+  }
 
-  // copy back
-  stream.submit([&](sycl::handler &cgh) {
-    cgh.memcpy(tensor_ptr(output), output_dev, output.nbytes());
-  });
-  stream.wait();
+  for (void *dev_ptr : dev_ptrs) {
+    if (dev_ptr)
+      sycl::free(dev_ptr, stream);
+  }
+  return durations;
+}
 
-  return output;
+static void report(std::vector<double> durations) {
+  if (durations.empty())
+    return;
+  std::sort(durations.begin(), durations.end());
+  auto percentile = [&](double p) {
+    size_t rank = std::ceil(p * durations.size());
+    return durations[std::max<size_t>(rank, 1) - 1];
+  };
+  double mean = 0;
+  for (double duration : durations)
+    mean += duration / durations.size();
+  std::cout << std::fixed << std::setprecision(2) << "  " << durations.size()
+            << " runs: min " << durations.front() << " us, median "
+            << percentile(0.5) << " us, p99 " << percentile(0.99)
+            << " us, mean " << mean << " us" << std::endl;
 }
 
-int main() {
+static void usage(const char *argv0) {
+  std::cerr << "Usage: " << argv0
+            << " [-n iterations] [--warmup N] [--grf-modes "
+               "default,small,large,auto] [-o output_dir] <manifest>"
+            << std::endl;
+}
+
+static std::optional<ReplayOptions> parse_options(int argc, char *argv[]) {
+  ReplayOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string opt = argv[i];
+    auto next = [&]() -> std::optional<std::string> {
+      if (i + 1 >= argc)
+        return std::nullopt;
+      return std::string(argv[++i]);
+    };
+    if (opt == "-n" || opt == "--iterations") {
+      auto value = next();
+      if (!value)
+        return std::nullopt;
+      options.iterations = std::stoi(*value);
+    } else if (opt == "--warmup") {
+      auto value = next();
+      if (!value)
+        return std::nullopt;
+      options.warmup = std::stoi(*value);
+    } else if (opt == "--grf-modes") {
+      auto value = next();
+      if (!value)
+        return std::nullopt;
+      options.grf_modes.clear();
+      std::istringstream ss(*value);
+      std::string mode;
+      while (std::getline(ss, mode, ',')) {
+        if (mode != "default" && !grf_mode_flags.count(mode)) {
+          std::cerr << "Unknown GRF mode " << mode << std::endl;
+          return std::nullopt;
+        }
+        options.grf_modes.push_back(mode);
+      }
+    } else if (opt == "-o" || opt == "--output-dir") {
+      auto value = next();
+      if (!value)
+        return std::nullopt;
+      options.output_dir = *value;
+    } else if (!opt.empty() && opt[0] != '-' &&
+               options.manifest_path.empty()) {
+      options.manifest_path = opt;
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (options.manifest_path.empty() || options.grf_modes.empty())
+    return std::nullopt;
+  return options;
+}
+
+int main(int argc, char *argv[]) {
+  auto options = parse_options(argc, argv);
+  if (!options) {
+    usage(argv[0]);
+    return 1;
+  }
+
   // initialize sycl runtime
-  sycl::queue q = sycl::queue(sycl::gpu_selector_v, exception_handler);
+  sycl::queue q =
+      sycl::queue(sycl::gpu_selector_v, exception_handler,
+                  sycl::property::queue::enable_profiling());
 
   std::cout << "Running on device: "
             << q.get_device().get_info<sycl::info::device::name>() << "\n";
   initContext(&q);
   initDevices(&q);
 
-  auto a = load_tensor("x.pt");
-  auto b = load_tensor("y.pt");
-  std::cout << "Tensor a: " << a.sizes() << ", " << a.scalar_type() << " ("
-            << a.nbytes() << " bytes)" << std::endl;
-  std::cout << "Tensor b: " << b.sizes() << ", " << b.scalar_type() << " ("
-            << b.nbytes() << " bytes)" << std::endl;
+  auto manifest = parse_manifest(options->manifest_path);
+  for (const KernelArg &arg : manifest.args) {
+    if (arg.tensor) {
+      std::cout << "Tensor " << arg.name << ": " << arg.tensor->sizes()
+                << ", " << arg.tensor->scalar_type() << " ("
+                << arg.tensor->nbytes() << " bytes)" << std::endl;
+    }
+  }
 
   // read spirv
-  auto spirv = read_spirv("add_kernel.spv");
+  auto spirv = read_spirv(manifest.spirv_path);
   std::cout << "Read " << spirv.size() << " byte kernel." << std::endl;
 
-  auto [kernel_bundle, kernel, n_regs, n_spills] =
-      loadBinary("add_kernel", reinterpret_cast<uint8_t *>(spirv.data()),
-                 spirv.size() / sizeof(uint32_t), 0);
+  for (const std::string &grf_mode : options->grf_modes) {
+    std::string build_flags = get_build_flags(manifest, grf_mode);
+    auto [kernel_bundle, kernel, n_regs, n_spills] = loadBinary(
+        manifest.kernel_name, reinterpret_cast<uint8_t *>(spirv.data()),
+        spirv.size() / sizeof(uint32_t), build_flags, 0);
 
-  // TODO: missing number of registers
-  std::cout << "Loaded kernel with " << n_regs << " registers and " << n_spills
-            << " register spills." << std::endl;
+    // TODO: missing number of registers
+    std::cout << "Loaded kernel " << manifest.kernel_name << " (" << grf_mode
+              << " GRF mode, build flags \"" << build_flags << "\") with "
+              << n_regs << " registers and " << n_spills
+              << " register spills." << std::endl;
 
-  auto output = launchKernel(q, kernel, a, b);
-  std::cout << "Kernel return output: " << output[0] << std::endl;
-  write_tensor("cpp_outs.pt", output);
+    report(replay(manifest, *options, grf_mode, q, kernel));
+  }
 }
@@ -0,0 +1,77 @@
+"""
+Captures a Triton XPU kernel launch for replay with `SPIRVRunner`.
+
+Writes the SPIR-V of the compiled kernel, its arguments and a launch manifest
+to a directory:
+
+    compiled = kernel[grid](x, y, output, n_elements, BLOCK_SIZE=1024)
+    capture(compiled, grid, (x, y, output, n_elements), "add_kernel")
+
+The arguments are the non-constexpr arguments of the launch, in order. The
+tensors are captured as passed to the kernel, so `capture` must be called
+before a launch that modifies them to replay it with identical inputs.
+"""
+
+import os
+
+import torch
+
+# Scalar types of the manifest, following the C types of the arguments of the
+# Triton launcher.
+_SCALAR_TYPES = {
+    "i1": "i32",
+    "i8": "i8",
+    "i16": "i16",
+    "i32": "i32",
+    "i64": "i64",
+    "u1": "u32",
+    "u8": "u8",
+    "u16": "u16",
+    "u32": "u32",
+    "u64": "u64",
+    "fp16": "f32",
+    "bf16": "f32",
+    "fp32": "f32",
+    "f32": "f32",
+    "fp64": "f64",
+}
+
+
+def capture(kernel, grid, args, out_dir):
+    src, metadata = kernel.src, kernel.metadata
+    params = [name for name in src.signature if name not in src.constants]
+    if len(params) != len(args):
+        raise ValueError(f"{kernel.name} has {len(params)} non-constexpr arguments, got {len(args)}")
+    grid = tuple(grid) + (1, ) * (3 - len(grid))
+
+    os.makedirs(out_dir, exist_ok=True)
+    with open(os.path.join(out_dir, f"{kernel.name}.spv"), "wb") as f:
+        f.write(kernel.asm["spv"])
+
+    lines = [
+        f"kernel {kernel.name}",
+        f"spirv {kernel.name}.spv",
+        f"build_flags {getattr(metadata, 'build_flags', '')}",
+        f"grid {grid[0]} {grid[1]} {grid[2]}",
+        f"num_warps {metadata.num_warps}",
+        f"threads_per_warp {metadata.threads_per_warp}",
+        f"shared_memory {metadata.shared}",
+    ]
+    for name, arg in zip(params, args):
+        ty = src.signature[name]
+        if ty[0] == "*":
+            if arg is None:
+                lines.append(f"arg {name} u64 0")
+                continue
+            torch.save(arg.detach().cpu().contiguous(), os.path.join(out_dir, f"{name}.pt"))
+            lines.append(f"arg {name} tensor {name}.pt")
+        elif ty in _SCALAR_TYPES:
+            value = float(arg) if ty[0] in "fb" else int(arg)
+            lines.append(f"arg {name} {_SCALAR_TYPES[ty]} {value!r}")
+        else:
+            raise ValueError(f"Argument {name} of type {ty} cannot be captured")
+
+    manifest_path = os.path.join(out_dir, f"{kernel.name}.manifest")
+    with open(manifest_path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    return manifest_path